@@ -0,0 +1,36 @@
+// tinySTL benchmarks: timing helpers shared by the bench/ programs.
+#pragma once
+
+#include <chrono>
+#include <cstdio>
+#include <cstddef>
+
+namespace bench
+{
+
+// keep the optimizer from dropping a computed value.
+template <class _Tp>
+inline void do_not_optimize(const _Tp& value) {
+  asm volatile("" : : "r,m"(value) : "memory");
+}
+
+// run fn() `rounds` times and return the best wall time in nanoseconds.
+template <class Fn>
+inline double best_of(int rounds, Fn&& fn) {
+  double best = 0;
+  for (int i = 0; i < rounds; i++) {
+    auto start = std::chrono::steady_clock::now();
+    fn();
+    auto stop = std::chrono::steady_clock::now();
+    double ns = std::chrono::duration<double, std::nano>(stop - start).count();
+    if (i == 0 || ns < best) best = ns;
+  }
+  return best;
+}
+
+inline void report(const char* name, size_t n, double ns) {
+  printf("%-40s n=%-10zu %12.2f ms %10.2f ns/elem\n",
+         name, n, ns / 1e6, n ? ns / n : 0.0);
+}
+
+}
@@ -0,0 +1,89 @@
+// btree_map vs. map (_Rb_tree): insert, lookup, range scan and memory.
+#include <random>
+#include <vector>
+
+#include "btree_map.h"
+#include "map.h"
+#include "bench.h"
+
+using namespace tinySTL;
+
+// malloc backend that counts the bytes the container holds.
+struct counting_alloc {
+  static size_t bytes;
+
+  static void* allocate(size_t __n) {
+    bytes += __n;
+    return malloc_alloc::allocate(__n);
+  }
+
+  static void deallocate(void* __p, size_t __n) {
+    bytes -= __n;
+    malloc_alloc::deallocate(__p, __n);
+  }
+};
+
+size_t counting_alloc::bytes = 0;
+
+typedef simple_alloc<pair<int, int>, counting_alloc> counted;
+
+template <class _Map>
+static void run(const char* name, const std::vector<int>& keys) {
+  char label[64];
+  size_t n = keys.size();
+  size_t before = counting_alloc::bytes;
+  _Map m;
+
+  double ns = bench::best_of(1, [&] {
+    for (int k : keys) m.insert(pair<int, int>(k, k));
+  });
+  snprintf(label, sizeof(label), "%s insert", name);
+  bench::report(label, n, ns);
+  printf("%-40s %.1f bytes/elem\n", name, (double)(counting_alloc::bytes - before) / m.size());
+
+  ns = bench::best_of(3, [&] {
+    long sum = 0;
+    for (int k : keys) sum += m.find(k)->second;
+    bench::do_not_optimize(sum);
+  });
+  snprintf(label, sizeof(label), "%s lookup", name);
+  bench::report(label, n, ns);
+
+  ns = bench::best_of(3, [&] {
+    long sum = 0;
+    for (auto it = m.begin(); it != m.end(); ++it) sum += it->second;
+    bench::do_not_optimize(sum);
+  });
+  snprintf(label, sizeof(label), "%s scan", name);
+  bench::report(label, n, ns);
+
+  // short range queries, the common use of an ordered map.
+  ns = bench::best_of(3, [&] {
+    long sum = 0;
+    for (size_t i = 0; i < n; i += 16) {
+      auto it = m.lower_bound(keys[i]);
+      for (int j = 0; j < 16 && it != m.end(); ++j, ++it) sum += it->second;
+    }
+    bench::do_not_optimize(sum);
+  });
+  snprintf(label, sizeof(label), "%s range(16)", name);
+  bench::report(label, n, ns);
+
+  ns = bench::best_of(1, [&] {
+    for (int k : keys) m.erase(k);
+  });
+  snprintf(label, sizeof(label), "%s erase", name);
+  bench::report(label, n, ns);
+}
+
+int main() {
+  for (size_t n = 1000; n <= 1000000; n *= 10) {
+    std::mt19937 rng(42);
+    std::vector<int> keys(n);
+    for (auto& k : keys) k = (int)rng();
+    run<btree_map<int, int, less<int>, counted>>("btree_map<int, int>", keys);
+    run<map<int, int, less<int>, counted>>("map<int, int>", keys);
+    printf("\n");
+  }
+  return 0;
+}
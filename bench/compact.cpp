@@ -0,0 +1,63 @@
+// scanning a map, list and unordered_map whose nodes were scattered by
+// churn, before and after compact().
+#include <random>
+#include <vector>
+
+#include "map.h"
+#include "list.h"
+#include "unordered_map.h"
+#include "bench.h"
+
+using namespace tinySTL;
+
+template <class _Container>
+double scan(const _Container& c) {
+  return bench::best_of(5, [&] {
+    long sum = 0;
+    for (auto& v : c) sum += v.second;
+    bench::do_not_optimize(sum);
+  });
+}
+
+int main() {
+  const size_t n = 1000000;
+  std::mt19937 rng(1);
+
+  // insert and erase at random for a while, so the order of the nodes in
+  // memory has nothing to do with their order in the container.
+  map<int, int> m;
+  list<pair<int, int>> l;
+  unordered_map<int, int> um;
+  for (size_t i = 0; i < n; ++i) {
+    int k = rng();
+    m.insert(pair<int, int>(k, 1));
+    um.insert(pair<int, int>(k, 1));
+    if (rng() % 2) l.push_back(pair<int, int>(k, 1));
+    else l.push_front(pair<int, int>(k, 1));
+  }
+  for (size_t i = 0; i < n; ++i) {
+    int k = rng();
+    m.erase(m.begin());
+    m.insert(pair<int, int>(k, 1));
+    um.erase(um.begin());
+    um.insert(pair<int, int>(k, 1));
+    l.pop_front();
+    l.push_back(pair<int, int>(k, 1));
+  }
+
+  bench::report("map scan, scattered", m.size(), scan(m));
+  double ns = bench::best_of(1, [&] { m.compact(); });
+  bench::report("map compact", m.size(), ns);
+  bench::report("map scan, compacted", m.size(), scan(m));
+
+  bench::report("list scan, scattered", l.size(), scan(l));
+  ns = bench::best_of(1, [&] { l.compact(); });
+  bench::report("list compact", l.size(), ns);
+  bench::report("list scan, compacted", l.size(), scan(l));
+
+  bench::report("unordered_map scan, scattered", um.size(), scan(um));
+  ns = bench::best_of(1, [&] { um.compact(); });
+  bench::report("unordered_map compact", um.size(), ns);
+  bench::report("unordered_map scan, compacted", um.size(), scan(um));
+  return 0;
+}
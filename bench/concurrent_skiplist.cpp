@@ -0,0 +1,123 @@
+// concurrent_skiplist_map vs. a mutex around map: throughput of a read
+// mostly mix (80% find, 10% insert, 10% erase) and of short range scans
+// from 1 to N threads.
+#include <mutex>
+#include <thread>
+#include <vector>
+#include <cstdio>
+
+#include "concurrent_skiplist_map.h"
+#include "map.h"
+#include "bench.h"
+
+using namespace tinySTL;
+
+namespace {
+
+const int key_range = 1 << 18;
+const int ops_per_thread = 400000;
+
+unsigned next_rand(unsigned& seed) {
+  seed = seed * 1103515245 + 12345;
+  return seed >> 8;
+}
+
+struct locked_map {
+  std::mutex mutex;
+  map<int, int> m;
+
+  bool find(int k) {
+    std::lock_guard<std::mutex> guard(mutex);
+    return m.find(k) != m.end();
+  }
+
+  void insert(int k) {
+    std::lock_guard<std::mutex> guard(mutex);
+    m.insert(pair<int, int>(k, k));
+  }
+
+  void erase(int k) {
+    std::lock_guard<std::mutex> guard(mutex);
+    m.erase(k);
+  }
+
+  long scan(int k, int len) {
+    std::lock_guard<std::mutex> guard(mutex);
+    long sum = 0;
+    for (auto it = m.lower_bound(k); it != m.end() && len-- > 0; ++it) sum += it->second;
+    return sum;
+  }
+};
+
+struct skiplist_map {
+  concurrent_skiplist_map<int, int> m;
+
+  bool find(int k) { return m.find(k) != m.end(); }
+
+  void insert(int k) { m.insert(pair<const int, int>(k, k)); }
+
+  void erase(int k) { m.erase(k); }
+
+  long scan(int k, int len) {
+    long sum = 0;
+    for (auto it = m.lower_bound(k); it != m.end() && len-- > 0; ++it) sum += it->second;
+    return sum;
+  }
+};
+
+template <class Table>
+void mixed(Table& t, unsigned seed) {
+  long hits = 0;
+  for (int i = 0; i < ops_per_thread; ++i) {
+    unsigned r = next_rand(seed);
+    int k = next_rand(seed) % key_range;
+    if (r % 10 == 0) t.insert(k);
+    else if (r % 10 == 1) t.erase(k);
+    else hits += t.find(k);
+  }
+  bench::do_not_optimize(hits);
+}
+
+template <class Table>
+void scans(Table& t, unsigned seed) {
+  long sum = 0;
+  for (int i = 0; i < ops_per_thread / 16; ++i) {
+    int k = next_rand(seed) % key_range;
+    if (i % 8 == 0) t.insert(k);
+    else sum += t.scan(k, 16);
+  }
+  bench::do_not_optimize(sum);
+}
+
+template <class Table, class Fn>
+double run(int threads, Fn fn) {
+  Table t;
+  for (int k = 0; k < key_range; k += 2) t.insert(k);
+  return bench::best_of(1, [&] {
+    std::vector<std::thread> pool;
+    for (int i = 0; i < threads; ++i)
+      pool.emplace_back([&t, &fn, i] { fn(t, i + 1); });
+    for (auto& th : pool) th.join();
+  });
+}
+
+}
+
+int main() {
+  unsigned hw = std::thread::hardware_concurrency();
+  int max_threads = hw > 1 ? (int)hw : 4;
+  printf("hardware threads: %u\n", hw);
+  for (int threads = 1; threads <= max_threads; threads *= 2) {
+    char name[64];
+    size_t ops = (size_t)threads * ops_per_thread;
+    snprintf(name, sizeof name, "mutex map mixed, %d threads", threads);
+    bench::report(name, ops, run<locked_map>(threads, mixed<locked_map>));
+    snprintf(name, sizeof name, "skiplist map mixed, %d threads", threads);
+    bench::report(name, ops, run<skiplist_map>(threads, mixed<skiplist_map>));
+    snprintf(name, sizeof name, "mutex map scan 16, %d threads", threads);
+    bench::report(name, ops / 16, run<locked_map>(threads, scans<locked_map>));
+    snprintf(name, sizeof name, "skiplist map scan 16, %d threads", threads);
+    bench::report(name, ops / 16, run<skiplist_map>(threads, scans<skiplist_map>));
+  }
+  return 0;
+}
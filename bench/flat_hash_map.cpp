@@ -0,0 +1,65 @@
+// flat_hash_map vs. unordered_map: lookups that hit, lookups that miss,
+// inserts into a table that grows, and erases, on random int keys.
+#include <random>
+#include <string>
+#include <vector>
+
+#include "flat_hash_map.h"
+#include "unordered_map.h"
+#include "bench.h"
+
+using namespace tinySTL;
+
+template <class _Map>
+void run(const char* name, const std::vector<int>& keys, const std::vector<int>& misses) {
+  const size_t n = keys.size();
+  std::string label(name);
+  _Map m;
+  double ns = bench::best_of(3, [&] {
+    _Map t;
+    for (size_t i = 0; i < n; ++i) t.emplace(keys[i], (int)i);
+    bench::do_not_optimize(t.size());
+  });
+  bench::report((label + " insert").c_str(), n, ns);
+  for (size_t i = 0; i < n; ++i) m.emplace(keys[i], (int)i);
+
+  ns = bench::best_of(3, [&] {
+    long sum = 0;
+    for (int k : keys) sum += m.find(k)->second;
+    bench::do_not_optimize(sum);
+  });
+  bench::report((label + " find hit").c_str(), n, ns);
+
+  ns = bench::best_of(3, [&] {
+    size_t found = 0;
+    for (int k : misses) found += m.find(k) != m.end();
+    bench::do_not_optimize(found);
+  });
+  bench::report((label + " find miss").c_str(), n, ns);
+
+  // a fresh copy for every round, made outside the timing.
+  std::vector<_Map> copies(3, m);
+  size_t round = 0;
+  ns = bench::best_of(3, [&] {
+    _Map& t = copies[round++];
+    size_t erased = 0;
+    for (int k : keys) erased += t.erase(k);
+    bench::do_not_optimize(erased);
+  });
+  bench::report((label + " erase").c_str(), n, ns);
+}
+
+int main() {
+  for (size_t n : {1000u, 100000u, 2000000u}) {
+    std::mt19937 rng(1);
+    std::vector<int> keys, misses;
+    // even keys are in the table, odd ones never are.
+    for (size_t i = 0; i < n; ++i) {
+      keys.push_back((int)(rng() & ~1u));
+      misses.push_back((int)(rng() | 1u));
+    }
+    run<flat_hash_map<int, int>>("flat_hash_map", keys, misses);
+    run<unordered_map<int, int>>("unordered_map", keys, misses);
+  }
+  return 0;
+}
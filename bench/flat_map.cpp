@@ -0,0 +1,58 @@
+// flat_map vs. map (_Rb_tree): bulk build, lookup and scan of a read-mostly table.
+#include <random>
+#include <vector>
+
+#include "flat_map.h"
+#include "map.h"
+#include "bench.h"
+
+using namespace tinySTL;
+
+int main() {
+  const size_t n = 1000000;
+  std::mt19937 rng(1);
+  std::vector<pair<int, int>> input(n);
+  for (size_t i = 0; i < n; ++i) input[i] = pair<int, int>(rng(), (int)i);
+
+  map<int, int> m;
+  flat_map<int, int> fm;
+  double ns = bench::best_of(1, [&] { m.insert(input.begin(), input.end()); });
+  bench::report("map insert(first, last)", n, ns);
+  ns = bench::best_of(1, [&] { fm.insert(input.begin(), input.end()); });
+  bench::report("flat_map insert(first, last)", n, ns);
+
+  // a second batch merged into the table.
+  std::vector<pair<int, int>> more(n / 10);
+  for (auto& p : more) p = pair<int, int>(rng(), 0);
+  ns = bench::best_of(1, [&] { m.insert(more.begin(), more.end()); });
+  bench::report("map insert 10% more", more.size(), ns);
+  ns = bench::best_of(1, [&] { fm.insert(more.begin(), more.end()); });
+  bench::report("flat_map insert 10% more", more.size(), ns);
+
+  ns = bench::best_of(3, [&] {
+    long sum = 0;
+    for (auto& p : input) sum += m.find(p.first)->second;
+    bench::do_not_optimize(sum);
+  });
+  bench::report("map lookup", n, ns);
+  ns = bench::best_of(3, [&] {
+    long sum = 0;
+    for (auto& p : input) sum += fm.find(p.first)->second;
+    bench::do_not_optimize(sum);
+  });
+  bench::report("flat_map lookup", n, ns);
+
+  ns = bench::best_of(3, [&] {
+    long sum = 0;
+    for (auto it = m.begin(); it != m.end(); ++it) sum += it->second;
+    bench::do_not_optimize(sum);
+  });
+  bench::report("map scan", m.size(), ns);
+  ns = bench::best_of(3, [&] {
+    long sum = 0;
+    for (int v : fm.values()) sum += v;
+    bench::do_not_optimize(sum);
+  });
+  bench::report("flat_map scan", fm.size(), ns);
+  return 0;
+}
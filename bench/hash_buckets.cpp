@@ -0,0 +1,50 @@
+// unordered_map bucket policies: prime bucket counts and a modulo against
+// power of two bucket counts and a mixed, masked hash.
+#include <random>
+#include <string>
+#include <vector>
+
+#include "unordered_map.h"
+#include "bench.h"
+
+using namespace tinySTL;
+
+template <class _Map>
+void run(const char* name, const std::vector<int>& keys) {
+  const size_t n = keys.size();
+  std::string label(name);
+  double ns = bench::best_of(3, [&] {
+    _Map t;
+    for (size_t i = 0; i < n; ++i) t.emplace(keys[i], (int)i);
+    bench::do_not_optimize(t.size());
+  });
+  bench::report((label + " insert").c_str(), n, ns);
+
+  _Map m;
+  for (size_t i = 0; i < n; ++i) m.emplace(keys[i], (int)i);
+  ns = bench::best_of(3, [&] {
+    long sum = 0;
+    for (int k : keys) sum += m.find(k)->second;
+    bench::do_not_optimize(sum);
+  });
+  bench::report((label + " find").c_str(), n, ns);
+
+  ns = bench::best_of(3, [&] {
+    long sum = 0;
+    for (auto& p : m) sum += p.second;
+    bench::do_not_optimize(sum);
+  });
+  bench::report((label + " iterate").c_str(), n, ns);
+}
+
+int main() {
+  typedef allocator<pair<int, int>> alloc;
+  for (size_t n : {1000u, 100000u, 1000000u}) {
+    std::mt19937 rng(1);
+    std::vector<int> keys;
+    for (size_t i = 0; i < n; ++i) keys.push_back((int)rng());
+    run<unordered_map<int, int, hash<int>, equal_to<int>, alloc, prime_buckets>>("prime_buckets", keys);
+    run<unordered_map<int, int, hash<int>, equal_to<int>, alloc, pow2_buckets>>("pow2_buckets", keys);
+  }
+  return 0;
+}
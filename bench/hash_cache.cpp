@@ -0,0 +1,85 @@
+// unordered_map with string keys, with and without the hash cached in
+// each node: inserts into a table that grows, a rehash, a walk with ++,
+// lookups that hit and miss, and erasing everything by iterator.
+#include <random>
+#include <algorithm>
+#include <string>
+#include <vector>
+
+#include "unordered_map.h"
+#include "bench.h"
+
+using namespace tinySTL;
+
+// hash<std::string> declared fast, so that its nodes keep no hash.
+struct uncached_hash : hash<std::string> {};
+
+namespace tinySTL {
+template <> struct is_fast_hash<uncached_hash> : true_type {};
+}
+
+template <class _Map>
+void run(const char* name, const std::vector<std::string>& keys,
+         const std::vector<std::string>& misses) {
+  const size_t n = keys.size();
+  std::string label(name);
+  double ns = bench::best_of(3, [&] {
+    _Map t;
+    for (size_t i = 0; i < n; ++i) t.emplace(keys[i], (int)i);
+    bench::do_not_optimize(t.size());
+  });
+  bench::report((label + " insert").c_str(), n, ns);
+
+  _Map m;
+  for (size_t i = 0; i < n; ++i) m.emplace(keys[i], (int)i);
+  size_t buckets = m.bucket_count();
+  ns = bench::best_of(3, [&] {
+    m.rehash(buckets * 4);
+    m.rehash(buckets);
+  });
+  bench::report((label + " rehash x4 and back").c_str(), n, ns);
+
+  ns = bench::best_of(3, [&] {
+    long sum = 0;
+    for (auto it = m.begin(); it != m.end(); ++it) sum += it->second;
+    bench::do_not_optimize(sum);
+  });
+  bench::report((label + " iterate").c_str(), n, ns);
+
+  ns = bench::best_of(3, [&] {
+    long sum = 0;
+    for (auto& k : keys) sum += m.find(k)->second;
+    bench::do_not_optimize(sum);
+  });
+  bench::report((label + " find hit").c_str(), n, ns);
+
+  ns = bench::best_of(3, [&] {
+    size_t found = 0;
+    for (auto& k : misses) found += m.find(k) != m.end();
+    bench::do_not_optimize(found);
+  });
+  bench::report((label + " find miss").c_str(), n, ns);
+
+  std::vector<_Map> copies(3, m);
+  size_t round = 0;
+  ns = bench::best_of(3, [&] {
+    _Map& t = copies[round++];
+    for (auto it = t.begin(); it != t.end(); ) it = t.erase(it);
+    bench::do_not_optimize(t.size());
+  });
+  bench::report((label + " erase by iterator").c_str(), n, ns);
+}
+
+int main() {
+  for (size_t n : {1000u, 100000u, 1000000u}) {
+    std::vector<std::string> keys, misses;
+    for (size_t i = 0; i < n; ++i) {
+      keys.push_back("https://example.com/catalog/item/" + std::to_string(i * 7) + "/index.html");
+      misses.push_back("https://example.com/catalog/item/" + std::to_string(i * 7 + 1) + "/index.html");
+    }
+    std::shuffle(keys.begin(), keys.end(), std::mt19937(1));
+    run<unordered_map<std::string, int>>("cached", keys, misses);
+    run<unordered_map<std::string, int, uncached_hash>>("uncached", keys, misses);
+  }
+  return 0;
+}
@@ -0,0 +1,67 @@
+// list::sort: splice merge sort vs. gather/introsort/relink across sizes.
+#include <random>
+#include <vector>
+
+#include "list.h"
+#include "bench.h"
+
+using namespace tinySTL;
+
+// exposes both sort paths of list.
+struct bench_list : list<int> {
+  void merge_sort() { _M_merge_sort(less()); }
+  void gather_sort() { _M_gather_sort(less()); }
+};
+
+// fill the list with fresh random values, the nodes themselves stay where
+// the previous sort left them, i.e. scattered relative to list order.
+static void refill(bench_list& li, std::mt19937& rng) {
+  for (auto& x : li) x = (int)rng();
+}
+
+// short lists: one sort takes well under a microsecond, so time a batch
+// of lists at once. Gather wins from n=2 on, so list::sort has no
+// length threshold.
+static void short_lists(std::mt19937& rng) {
+  const size_t batch = 4096;
+  for (size_t n = 2; n <= 32; n += n < 16 ? 1 : 4) {
+    std::vector<bench_list> lists(batch);
+    for (auto& li : lists) {
+      for (size_t i = 0; i < n; i++) li.push_back((int)rng());
+      li.merge_sort();
+    }
+    double merge_ns = 0, gather_ns = 0;
+    for (int r = 0; r < 20; r++) {
+      for (auto& li : lists) refill(li, rng);
+      double ns = bench::best_of(1, [&] { for (auto& li : lists) li.merge_sort(); });
+      if (r == 0 || ns < merge_ns) merge_ns = ns;
+      for (auto& li : lists) refill(li, rng);
+      ns = bench::best_of(1, [&] { for (auto& li : lists) li.gather_sort(); });
+      if (r == 0 || ns < gather_ns) gather_ns = ns;
+    }
+    bench::report("list::sort merge (splice), per list", n, merge_ns / batch);
+    bench::report("list::sort gather (introsort), per list", n, gather_ns / batch);
+  }
+}
+
+int main() {
+  std::mt19937 rng(42);
+  short_lists(rng);
+  for (size_t n = 64; n <= (size_t(1) << 22); n *= 4) {
+    bench_list li;
+    for (size_t i = 0; i < n; i++) li.push_back((int)rng());
+    li.merge_sort();
+    int rounds = n < 100000 ? 20 : 3;
+
+    double merge_ns = 0, gather_ns = 0;
+    for (int r = 0; r < rounds; r++) {
+      refill(li, rng);
+      merge_ns += bench::best_of(1, [&] { li.merge_sort(); });
+      refill(li, rng);
+      gather_ns += bench::best_of(1, [&] { li.gather_sort(); });
+    }
+    bench::report("list::sort merge (splice)", n, merge_ns / rounds);
+    bench::report("list::sort gather (introsort)", n, gather_ns / rounds);
+  }
+  return 0;
+}
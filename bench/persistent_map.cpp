@@ -0,0 +1,70 @@
+// persistent_map vs. map: a writer taking a snapshot for readers every
+// 64 updates, where map has to deep copy; plus plain updates and lookups.
+#include <random>
+#include <vector>
+
+#include "persistent_map.h"
+#include "map.h"
+#include "bench.h"
+
+using namespace tinySTL;
+
+int main() {
+  const size_t n = 100000;
+  const size_t updates = 20000;
+  std::mt19937 rng(1);
+  std::vector<int> keys(n), writes(updates);
+  for (auto& k : keys) k = rng();
+  for (auto& k : writes) k = keys[rng() % n];
+
+  map<int, int> m;
+  persistent_map<int, int> pm;
+  for (int k : keys) {
+    m.insert(pair<int, int>(k, 0));
+    pm.insert(pair<const int, int>(k, 0));
+  }
+
+  double ns = bench::best_of(1, [&] {
+    for (size_t i = 0; i < updates; ++i) {
+      m[writes[i]] = (int)i;
+      if (i % 64 == 0) {
+        map<int, int> snapshot = m;
+        bench::do_not_optimize(snapshot.size());
+      }
+    }
+  });
+  bench::report("map update + copy every 64", updates, ns);
+  ns = bench::best_of(1, [&] {
+    for (size_t i = 0; i < updates; ++i) {
+      pm.insert_or_assign(writes[i], (int)i);
+      if (i % 64 == 0) {
+        persistent_map<int, int> snapshot = pm;
+        bench::do_not_optimize(snapshot.size());
+      }
+    }
+  });
+  bench::report("persistent_map update + snapshot", updates, ns);
+
+  ns = bench::best_of(3, [&] {
+    for (size_t i = 0; i < updates; ++i) m[writes[i]] = (int)i;
+  });
+  bench::report("map update", updates, ns);
+  ns = bench::best_of(3, [&] {
+    for (size_t i = 0; i < updates; ++i) pm.insert_or_assign(writes[i], (int)i);
+  });
+  bench::report("persistent_map update", updates, ns);
+
+  ns = bench::best_of(3, [&] {
+    long sum = 0;
+    for (int k : keys) sum += m.find(k)->second;
+    bench::do_not_optimize(sum);
+  });
+  bench::report("map lookup", n, ns);
+  ns = bench::best_of(3, [&] {
+    long sum = 0;
+    for (int k : keys) sum += pm.find(k)->second;
+    bench::do_not_optimize(sum);
+  });
+  bench::report("persistent_map lookup", n, ns);
+  return 0;
+}
@@ -0,0 +1,98 @@
+// radix_map vs. map and unordered_map on string keys: build, lookup, and
+// prefix scans, which the hash table cannot do without a full pass.
+#include <random>
+#include <algorithm>
+#include <string>
+#include <vector>
+
+#include "radix_map.h"
+#include "map.h"
+#include "unordered_map.h"
+#include "bench.h"
+
+using namespace tinySTL;
+
+int main() {
+  const size_t n = 1000000;
+  std::mt19937 rng(1);
+  // URL-like keys: a few shared directories, then a random name.
+  const char* dirs[] = {"/usr/lib/", "/usr/share/doc/", "/home/user/src/", "/var/log/"};
+  std::vector<std::string> keys(n);
+  for (auto& k : keys) {
+    k = dirs[rng() % 4];
+    for (int i = 0, len = 6 + rng() % 10; i < len; ++i) k += (char)('a' + rng() % 26);
+  }
+  // a directory and the first two letters of a name: a few hundred keys each.
+  std::vector<std::string> prefixes(10000);
+  for (auto& p : prefixes) {
+    const std::string& k = keys[rng() % n];
+    p = k.substr(0, k.rfind('/') + 3);
+  }
+
+  radix_map<int> r;
+  map<std::string, int> m;
+  unordered_map<std::string, int> um;
+  double ns = bench::best_of(1, [&] { for (size_t i = 0; i < n; ++i) r.emplace(keys[i], (int)i); });
+  bench::report("radix_map insert", n, ns);
+  ns = bench::best_of(1, [&] { for (size_t i = 0; i < n; ++i) m.emplace(keys[i], (int)i); });
+  bench::report("map insert", n, ns);
+  ns = bench::best_of(1, [&] { for (size_t i = 0; i < n; ++i) um.emplace(keys[i], (int)i); });
+  bench::report("unordered_map insert", n, ns);
+
+  std::shuffle(keys.begin(), keys.end(), rng);
+  ns = bench::best_of(3, [&] {
+    long sum = 0;
+    for (auto& k : keys) sum += r.find(k)->second;
+    bench::do_not_optimize(sum);
+  });
+  bench::report("radix_map lookup", n, ns);
+  ns = bench::best_of(3, [&] {
+    long sum = 0;
+    for (auto& k : keys) sum += m.find(k)->second;
+    bench::do_not_optimize(sum);
+  });
+  bench::report("map lookup", n, ns);
+  ns = bench::best_of(3, [&] {
+    long sum = 0;
+    for (auto& k : keys) sum += um.find(k)->second;
+    bench::do_not_optimize(sum);
+  });
+  bench::report("unordered_map lookup", n, ns);
+
+  ns = bench::best_of(3, [&] {
+    long sum = 0;
+    for (auto& p : prefixes)
+      for (auto [i, e] = r.prefix_range(p); i != e; ++i) sum += i->second;
+    bench::do_not_optimize(sum);
+  });
+  bench::report("radix_map prefix_range", prefixes.size(), ns);
+  ns = bench::best_of(3, [&] {
+    long sum = 0;
+    for (auto& p : prefixes)
+      for (auto i = m.lower_bound(p); i != m.end() && i->first.starts_with(p); ++i) sum += i->second;
+    bench::do_not_optimize(sum);
+  });
+  bench::report("map lower_bound + scan", prefixes.size(), ns);
+  ns = bench::best_of(1, [&] {
+    long sum = 0;
+    for (size_t j = 0; j < 10; ++j)
+      for (auto& p : um)
+        if (p.first.starts_with(prefixes[j])) sum += p.second;
+    bench::do_not_optimize(sum);
+  });
+  bench::report("unordered_map full pass (10 only)", 10, ns);
+
+  ns = bench::best_of(3, [&] {
+    long sum = 0;
+    for (auto& p : r) sum += p.second;
+    bench::do_not_optimize(sum);
+  });
+  bench::report("radix_map scan", r.size(), ns);
+  ns = bench::best_of(3, [&] {
+    long sum = 0;
+    for (auto& p : m) sum += p.second;
+    bench::do_not_optimize(sum);
+  });
+  bench::report("map scan", m.size(), ns);
+  return 0;
+}
@@ -0,0 +1,55 @@
+// map range scans and unordered_map walks: iterators vs. for_each_in_range
+// and for_each, on tables too big for the cache, nodes scattered in memory.
+#include <random>
+
+#include "map.h"
+#include "unordered_map.h"
+#include "bench.h"
+
+using namespace tinySTL;
+
+int main() {
+  const size_t n = 4000000;
+  std::mt19937 rng(1);
+  map<int, int> m;
+  unordered_map<int, int> um;
+  for (size_t i = 0; i < n; ++i) {
+    int k = (int)rng();
+    m.emplace(k, (int)i);
+    um.emplace(k, (int)i);
+  }
+
+  // a quarter of the key space, then the whole of it.
+  for (int lo : {0, -2147483647 - 1}) {
+    const int hi = lo == 0 ? 1 << 29 : 2147483647;
+    size_t count = 0;
+    double ns = bench::best_of(3, [&] {
+      long sum = 0;
+      count = 0;
+      for (auto it = m.lower_bound(lo), e = m.lower_bound(hi); it != e; ++it, ++count)
+        sum += it->second;
+      bench::do_not_optimize(sum);
+    });
+    bench::report("map lower_bound..lower_bound", count, ns);
+    ns = bench::best_of(3, [&] {
+      long sum = 0;
+      m.for_each_in_range(lo, hi, [&](const pair<const int, int>& p) { sum += p.second; });
+      bench::do_not_optimize(sum);
+    });
+    bench::report("map for_each_in_range", count, ns);
+  }
+
+  double ns = bench::best_of(3, [&] {
+    long sum = 0;
+    for (auto& p : um) sum += p.second;
+    bench::do_not_optimize(sum);
+  });
+  bench::report("unordered_map iterators", n, ns);
+  ns = bench::best_of(3, [&] {
+    long sum = 0;
+    um.for_each([&](const pair<const int, int>& p) { sum += p.second; });
+    bench::do_not_optimize(sum);
+  });
+  bench::report("unordered_map for_each", n, ns);
+  return 0;
+}
@@ -0,0 +1,86 @@
+// set bulk operations: merge/intersect/subtract of a delta into a large
+// set and range erase, against node-by-node merging and set_union into a
+// new set. merge only goes join-based for sizes within a factor of 16.
+#include <random>
+#include <vector>
+
+#include "set.h"
+#include "algorithm.h"
+#include "iterator.h"
+#include "bench.h"
+
+using namespace tinySTL;
+
+// the same order as less<int> under another type, which sends merge()
+// down the node-by-node path.
+struct other_less {
+  bool operator()(int a, int b) const { return a < b; }
+};
+
+static std::vector<int> random_keys(size_t n, int parity, std::mt19937& rng) {
+  std::vector<int> v(n);
+  for (auto& x : v) x = (int)(rng() & 0x3ffffffe) | parity;
+  return v;
+}
+
+static void run(size_t n, size_t m) {
+  char label[64];
+  std::mt19937 rng(42);
+  std::vector<int> base = random_keys(n, 0, rng);
+  std::vector<int> delta = random_keys(m, 1, rng);
+
+  set<int> big(base.begin(), base.end());
+  set<int> d(delta.begin(), delta.end());
+  double ns = bench::best_of(1, [&] { big.merge(d); });
+  snprintf(label, sizeof(label), "merge m=%zu", m);
+  bench::report(label, m, ns);
+
+  set<int> big2(base.begin(), base.end());
+  set<int, other_less> d2(delta.begin(), delta.end());
+  ns = bench::best_of(1, [&] { big2.merge(d2); });
+  snprintf(label, sizeof(label), "merge, node by node m=%zu", m);
+  bench::report(label, m, ns);
+
+  set<int> big3(base.begin(), base.end());
+  set<int> d3(delta.begin(), delta.end());
+  ns = bench::best_of(1, [&] {
+    set<int> out;
+    tinySTL::set_union(big3.begin(), big3.end(), d3.begin(), d3.end(),
+                       tinySTL::inserter(out, out.end()));
+    bench::do_not_optimize(out.size());
+  });
+  snprintf(label, sizeof(label), "set_union m=%zu", m);
+  bench::report(label, m, ns);
+
+  // the delta's keys are odd, intersect with a set that shares half.
+  set<int> probe(delta.begin(), delta.begin() + m / 2);
+  ns = bench::best_of(1, [&] { big.intersect(tinySTL::move(probe)); });
+  snprintf(label, sizeof(label), "intersect m=%zu", m);
+  bench::report(label, m, ns);
+
+  set<int> big4(base.begin(), base.end());
+  set<int> gone(base.begin(), base.begin() + m);
+  ns = bench::best_of(1, [&] { big4.subtract(tinySTL::move(gone)); });
+  snprintf(label, sizeof(label), "subtract m=%zu", m);
+  bench::report(label, m, ns);
+}
+
+int main() {
+  const size_t n = 1000000;
+  for (size_t m = 10; m <= n; m *= 10)
+    run(n, m);
+
+  char label[64];
+  std::mt19937 rng(7);
+  std::vector<int> base = random_keys(n, 0, rng);
+  for (size_t k = 1000; k <= 100000; k *= 10) {
+    set<int> s(base.begin(), base.end());
+    auto first = s.lower_bound(1 << 28);
+    auto last = first;
+    tinySTL::advance(last, k);
+    double ns = bench::best_of(1, [&] { s.erase(first, last); });
+    snprintf(label, sizeof(label), "erase(first, last) k=%zu", k);
+    bench::report(label, k, ns);
+  }
+  return 0;
+}
@@ -0,0 +1,135 @@
+// string hashing: __tiny_hash_bytes against the byte at a time hash it
+// replaced. Throughput by key length, the quality of the hash on a few
+// key sets, and string lookups in unordered_map with either hash.
+#include <cmath>
+#include <random>
+#include <string>
+#include <vector>
+#include <unordered_set>
+
+#include "unordered_map.h"
+#include "bench.h"
+
+using namespace tinySTL;
+
+// the hash of std::string before __tiny_hash_bytes, for reference.
+size_t old_hash(const char* s, size_t n) {
+  uint64_t h = 0;
+  for (size_t i = 0; i < n; i++) {
+    if (i & 1) h ^= ~((h << 11) ^ s[i] ^ (h >> 5));
+    else h ^= ((h << 7) ^ s[i] ^ (h >> 3));
+  }
+  return size_t(h & 0x7FFFFFFF);
+}
+
+struct old_string_hash {
+  size_t operator()(const std::string& s) const { return old_hash(s.data(), s.size()); }
+};
+
+template <class _Hash>
+void throughput(const char* name, size_t len, _Hash h) {
+  std::string buf(len + 64, 'x');
+  std::mt19937 rng(1);
+  for (char& c : buf) c = (char)rng();
+  const size_t reps = 200000000 / (len + 16) + 1;
+  double ns = bench::best_of(3, [&] {
+    size_t acc = 0;
+    for (size_t i = 0; i < reps; ++i) acc += h(buf.data() + (i & 63), len);
+    bench::do_not_optimize(acc);
+  });
+  printf("%-24s len=%-6zu %8.2f ns/key %8.2f GB/s\n", name, len, ns / reps, len * reps / ns);
+}
+
+// 64 and 32 bit collisions, and the fullest of 2^20 buckets by low bits.
+template <class _Hash>
+void quality(const char* name, const std::vector<std::string>& keys, _Hash h) {
+  std::unordered_set<uint64_t> full, low32;
+  std::vector<unsigned> buckets(1 << 20);
+  for (auto& k : keys) {
+    uint64_t v = h(k.data(), k.size());
+    full.insert(v);
+    low32.insert(v & 0xFFFFFFFF);
+    ++buckets[v & ((1 << 20) - 1)];
+  }
+  unsigned fullest = 0;
+  for (unsigned b : buckets) fullest = b > fullest ? b : fullest;
+  printf("%-24s keys=%-8zu collisions64=%-8zu collisions32=%-8zu fullest bucket=%u (mean %.2f)\n",
+         name, keys.size(), keys.size() - full.size(), keys.size() - low32.size(), fullest,
+         keys.size() / double(1 << 20));
+}
+
+// flip every input bit of random keys: the mean share of output bits that
+// change, ideally 0.5, and the output bit whose flip rate is furthest from it.
+template <class _Hash>
+void avalanche(const char* name, size_t len, _Hash h) {
+  std::mt19937 rng(2);
+  std::vector<double> flips(64);
+  size_t trials = 0;
+  std::string k(len, 0);
+  for (size_t t = 0; t < 2000 / (len / 16 + 1) + 20; ++t) {
+    for (char& c : k) c = (char)rng();
+    uint64_t base = h(k.data(), len);
+    for (size_t bit = 0; bit < len * 8; ++bit) {
+      k[bit / 8] ^= (char)(1 << (bit % 8));
+      uint64_t d = base ^ h(k.data(), len);
+      k[bit / 8] ^= (char)(1 << (bit % 8));
+      for (int o = 0; o < 64; ++o) flips[o] += (d >> o) & 1;
+      ++trials;
+    }
+  }
+  double mean = 0, worst = 0;
+  for (double f : flips) {
+    mean += f / trials / 64;
+    worst = std::fmax(worst, std::fabs(f / trials - 0.5));
+  }
+  printf("%-24s len=%-6zu mean flip=%.4f worst bit bias=%.4f\n", name, len, mean, worst);
+}
+
+template <class _Map>
+void lookups(const char* name, const std::vector<std::string>& keys) {
+  _Map m;
+  for (size_t i = 0; i < keys.size(); ++i) m.emplace(keys[i], (int)i);
+  double ns = bench::best_of(3, [&] {
+    long sum = 0;
+    for (auto& k : keys) sum += m.find(k)->second;
+    bench::do_not_optimize(sum);
+  });
+  bench::report(name, keys.size(), ns);
+}
+
+int main() {
+  auto fresh = [](const char* s, size_t n) { return __tiny_hash_bytes(s, n); };
+  auto long_scalar = [](const char* s, size_t n) {
+    return (size_t)__tiny_hash_long<false>((const unsigned char*)s, n, 0);
+  };
+  for (size_t len : {4, 8, 16, 32, 64, 128, 256, 512, 1023, 1024, 4096, 65536}) {
+    throughput("old", len, old_hash);
+    throughput("__tiny_hash_bytes", len, fresh);
+    if (len >= 1024) throughput("  long path, scalar", len, long_scalar);
+  }
+
+  std::vector<std::string> counters, urls, binary;
+  std::mt19937_64 rng(3);
+  for (int i = 0; i < 1000000; ++i) {
+    counters.push_back("key" + std::to_string(i));
+    urls.push_back("https://example.com/catalog/item/" + std::to_string(i * 7) + "/index.html");
+    uint64_t r = rng();
+    binary.push_back(std::string((const char*)&r, 8));
+  }
+  quality("old, key<i>", counters, old_hash);
+  quality("new, key<i>", counters, fresh);
+  quality("old, urls", urls, old_hash);
+  quality("new, urls", urls, fresh);
+  quality("old, random 8 bytes", binary, old_hash);
+  quality("new, random 8 bytes", binary, fresh);
+  for (size_t len : {8, 16, 40, 600, 2000}) {
+    avalanche("old", len, old_hash);
+    avalanche("new", len, fresh);
+  }
+
+  lookups<unordered_map<std::string, int, old_string_hash>>("unordered_map find, old, urls", urls);
+  lookups<unordered_map<std::string, int>>("unordered_map find, new, urls", urls);
+  lookups<unordered_map<std::string, int, old_string_hash>>("unordered_map find, old, key<i>", counters);
+  lookups<unordered_map<std::string, int>>("unordered_map find, new, key<i>", counters);
+  return 0;
+}
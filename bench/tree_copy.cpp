@@ -0,0 +1,51 @@
+// copying a map built by random inserts, and walking the original against
+// the copy. Built a second time as bench_tree_copy_parallel with parallel
+// copy turned on.
+#include <map>
+#include <random>
+#include <vector>
+
+#include "map.h"
+#include "bench.h"
+
+using namespace tinySTL;
+
+int main() {
+  const size_t n = 1000000;
+  std::mt19937 rng(1);
+  std::vector<int> keys(n);
+  for (auto& k : keys) k = rng();
+
+  map<int, int> m;
+  std::map<int, int> sm;
+  for (int k : keys) {
+    m.insert(pair<int, int>(k, k));
+    sm.emplace(k, k);
+  }
+
+  double ns = bench::best_of(3, [&] {
+    map<int, int> c = m;
+    bench::do_not_optimize(c.size());
+  });
+  bench::report("map copy", m.size(), ns);
+  ns = bench::best_of(3, [&] {
+    std::map<int, int> c = sm;
+    bench::do_not_optimize(c.size());
+  });
+  bench::report("std::map copy", sm.size(), ns);
+
+  map<int, int> c = m;
+  ns = bench::best_of(5, [&] {
+    long sum = 0;
+    for (auto& p : m) sum += p.second;
+    bench::do_not_optimize(sum);
+  });
+  bench::report("map walk, original", m.size(), ns);
+  ns = bench::best_of(5, [&] {
+    long sum = 0;
+    for (auto& p : c) sum += p.second;
+    bench::do_not_optimize(sum);
+  });
+  bench::report("map walk, copy", c.size(), ns);
+  return 0;
+}
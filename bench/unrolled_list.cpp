@@ -0,0 +1,86 @@
+// unrolled_list vs. list, deque and vector: scans and mixed insert/scan.
+#include <random>
+
+#include "unrolled_list.h"
+#include "list.h"
+#include "deque.h"
+#include "vector.h"
+#include "bench.h"
+
+using namespace tinySTL;
+
+template <class _Container>
+static long scan(const _Container& c) {
+  long sum = 0;
+  for (auto it = c.begin(); it != c.end(); ++it) sum += *it;
+  return sum;
+}
+
+// walk to a random position and insert there, `ops` times. The walk is
+// the scan a linked container pays to find the position.
+template <class _Container>
+static void insert_walk(_Container& c, size_t ops, std::mt19937& rng) {
+  for (size_t i = 0; i < ops; i++) {
+    auto it = c.begin();
+    tinySTL::advance(it, rng() % (c.size() + 1));
+    c.insert(it, (int)i);
+  }
+}
+
+template <class _Container>
+static void erase_walk(_Container& c, size_t ops, std::mt19937& rng) {
+  for (size_t i = 0; i < ops && !c.empty(); i++) {
+    auto it = c.begin();
+    tinySTL::advance(it, rng() % c.size());
+    c.erase(it);
+  }
+}
+
+// an editing cursor: insert, then step a few elements forward, `ops` times.
+template <class _Container>
+static void insert_cursor(_Container& c, size_t ops, std::mt19937& rng) {
+  auto it = c.begin();
+  tinySTL::advance(it, c.size() / 2);
+  for (size_t i = 0; i < ops; i++) {
+    it = c.insert(it, (int)i);
+    for (unsigned step = rng() % 4; step > 0 && it != c.end(); --step)
+      ++it;
+  }
+}
+
+template <class _Container>
+static void run(const char* name, size_t n, size_t ops) {
+  char label[64];
+  std::mt19937 rng(42);
+  _Container c;
+  for (size_t i = 0; i < n; i++) c.push_back((int)rng());
+
+  double ns = bench::best_of(5, [&] { bench::do_not_optimize(scan(c)); });
+  snprintf(label, sizeof(label), "%s scan", name);
+  bench::report(label, n, ns);
+
+  // the rest report per operation.
+  ns = bench::best_of(1, [&] { insert_walk(c, ops, rng); });
+  snprintf(label, sizeof(label), "%s walk+insert", name);
+  bench::report(label, ops, ns);
+
+  ns = bench::best_of(1, [&] { erase_walk(c, ops, rng); });
+  snprintf(label, sizeof(label), "%s walk+erase", name);
+  bench::report(label, ops, ns);
+
+  ns = bench::best_of(1, [&] { insert_cursor(c, ops * 10, rng); });
+  snprintf(label, sizeof(label), "%s cursor insert", name);
+  bench::report(label, ops * 10, ns);
+}
+
+int main() {
+  for (size_t n = 1000; n <= 1000000; n *= 10) {
+    size_t ops = n < 100000 ? 2000 : 200;
+    run<unrolled_list<int>>("unrolled_list<int>", n, ops);
+    run<list<int>>("list<int>", n, ops);
+    run<deque<int>>("deque<int>", n, ops);
+    run<vector<int>>("vector<int>", n, ops);
+    printf("\n");
+  }
+  return 0;
+}
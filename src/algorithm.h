@@ -29,7 +29,8 @@ adjacent_find(_ForwardIterator __first, _ForwardIterator __last)
 
 template <class _InputIterator, class _Tp>
 typename tinySTL::iterator_traits<_InputIterator>::difference_type
-count(_InputIterator __first, _InputIterator __last, const _Tp& __value) {
+__count(_InputIterator __first, _InputIterator __last, const _Tp& __value, 
+        false_type) {
   typename tinySTL::iterator_traits<_InputIterator>::difference_type __r(0);
   for (; __first != __last; ++__first)
     if (*__first == __value)
@@ -37,6 +38,30 @@ count(_InputIterator __first, _InputIterator __last, const _Tp& __value) {
   return __r;
 }
 
+// segmented version, count each contiguous block on its local iterators.
+template <class _InputIterator, class _Tp>
+typename tinySTL::iterator_traits<_InputIterator>::difference_type
+__count(_InputIterator __first, _InputIterator __last, const _Tp& __value, 
+        true_type) {
+  typedef __segmented_iterator_traits<_InputIterator> _Traits;
+  auto __sfirst = _Traits::__segment(__first);
+  auto __slast = _Traits::__segment(__last);
+  if (__sfirst == __slast)
+    return tinySTL::__count(_Traits::__local(__first), _Traits::__local(__last), __value, false_type());
+  typename tinySTL::iterator_traits<_InputIterator>::difference_type __r =
+    tinySTL::__count(_Traits::__local(__first), _Traits::__end(__sfirst), __value, false_type());
+  for (++__sfirst; __sfirst != __slast; ++__sfirst)
+    __r += tinySTL::__count(_Traits::__begin(__sfirst), _Traits::__end(__sfirst), __value, false_type());
+  return __r + tinySTL::__count(_Traits::__begin(__slast), _Traits::__local(__last), __value, false_type());
+}
+
+template <class _InputIterator, class _Tp>
+typename tinySTL::iterator_traits<_InputIterator>::difference_type
+count(_InputIterator __first, _InputIterator __last, const _Tp& __value) {
+  return tinySTL::__count(__first, __last, __value, 
+                          __is_segmented_iterator<_InputIterator>());
+}
+
 template <class _InputIterator, class _Predicate>
 typename tinySTL::iterator_traits<_InputIterator>::difference_type
 count_if(_InputIterator __first, _InputIterator __last, _Predicate __pred) {
@@ -126,7 +151,7 @@ equal_range(_ForwardIterator __first, _ForwardIterator __last, const _Tp& __valu
 }
 
 template <class _InputIterator, class _Tp> _InputIterator
-find(_InputIterator __first, _InputIterator __last, const _Tp& __value) 
+__find(_InputIterator __first, _InputIterator __last, const _Tp& __value, false_type) 
 {
   for (; __first != __last; ++__first)
     if (*__first == __value)
@@ -134,6 +159,38 @@ find(_InputIterator __first, _InputIterator __last, const _Tp& __value)
   return __first;
 }
 
+// segmented version, search each contiguous block on its local iterators.
+template <class _InputIterator, class _Tp> _InputIterator
+__find(_InputIterator __first, _InputIterator __last, const _Tp& __value, true_type) 
+{
+  typedef __segmented_iterator_traits<_InputIterator> _Traits;
+  auto __sfirst = _Traits::__segment(__first);
+  auto __slast = _Traits::__segment(__last);
+  if (__sfirst == __slast) {
+    auto __r = tinySTL::__find(_Traits::__local(__first), _Traits::__local(__last), __value, false_type());
+    return __r == _Traits::__local(__last) ? __last : _Traits::__compose(__sfirst, __r);
+  }
+  auto __end = _Traits::__end(__sfirst);
+  auto __r = tinySTL::__find(_Traits::__local(__first), __end, __value, false_type());
+  if (__r != __end)
+    return _Traits::__compose(__sfirst, __r);
+  for (++__sfirst; __sfirst != __slast; ++__sfirst) {
+    __end = _Traits::__end(__sfirst);
+    __r = tinySTL::__find(_Traits::__begin(__sfirst), __end, __value, false_type());
+    if (__r != __end)
+      return _Traits::__compose(__sfirst, __r);
+  }
+  __r = tinySTL::__find(_Traits::__begin(__slast), _Traits::__local(__last), __value, false_type());
+  return __r == _Traits::__local(__last) ? __last : _Traits::__compose(__slast, __r);
+}
+
+template <class _InputIterator, class _Tp> _InputIterator
+find(_InputIterator __first, _InputIterator __last, const _Tp& __value) 
+{
+  return tinySTL::__find(__first, __last, __value, 
+                         __is_segmented_iterator<_InputIterator>());
+}
+
 template <class _InputIterator, class _Predicate> _InputIterator
 find_if(_InputIterator __first, _InputIterator __last, _Predicate __pred) 
 {
@@ -547,13 +604,43 @@ unique_copy(_InputIterator __first, _InputIterator __last, _OutputIterator __res
 }
 
 template <class _InputIterator, class _Function> _Function 
-for_each(_InputIterator __first, _InputIterator __last, _Function __f) 
+__for_each(_InputIterator __first, _InputIterator __last, _Function __f, false_type) 
 {
   for (; __first != __last; ++__first)
     __f(*__first);
   return __f;
 }
 
+// segmented version, visit each contiguous block on its local iterators.
+template <class _InputIterator, class _Function> _Function 
+__for_each(_InputIterator __first, _InputIterator __last, _Function __f, true_type) 
+{
+  typedef __segmented_iterator_traits<_InputIterator> _Traits;
+  typedef typename _Traits::__local_iterator _Local;
+  auto __sfirst = _Traits::__segment(__first);
+  auto __slast = _Traits::__segment(__last);
+  if (__sfirst == __slast) {
+    tinySTL::__for_each<_Local, _Function&>(_Traits::__local(__first), 
+      _Traits::__local(__last), __f, false_type());
+    return __f;
+  }
+  tinySTL::__for_each<_Local, _Function&>(_Traits::__local(__first), 
+    _Traits::__end(__sfirst), __f, false_type());
+  for (++__sfirst; __sfirst != __slast; ++__sfirst)
+    tinySTL::__for_each<_Local, _Function&>(_Traits::__begin(__sfirst), 
+      _Traits::__end(__sfirst), __f, false_type());
+  tinySTL::__for_each<_Local, _Function&>(_Traits::__begin(__slast), 
+    _Traits::__local(__last), __f, false_type());
+  return __f;
+}
+
+template <class _InputIterator, class _Function> _Function 
+for_each(_InputIterator __first, _InputIterator __last, _Function __f) 
+{
+  return tinySTL::__for_each(__first, __last, tinySTL::move(__f), 
+                             __is_segmented_iterator<_InputIterator>());
+}
+
 template <class _ForwardIterator, class _Generator> void
 generate(_ForwardIterator __first, _ForwardIterator __last, _Generator __gen)
 {
@@ -0,0 +1,488 @@
+// tinySTL: btree_map, btree_multimap.
+#pragma once
+
+#include "tiny_btree.h"
+#include "tiny_pair.h"
+#include "tiny_alloc.h"
+#include "tiny_errors.h"
+#include "tiny_concepts.h"
+#include "tiny_iterator.h"
+#include "tiny_function.h"
+#include "tiny_uninitialized.h"
+
+namespace tinySTL
+{
+
+template<class, class, class, class> class btree_multimap;
+
+/**
+ * @brief  map on a B-tree, see _Btree.
+ * @attention insert and erase invalidate every iterator.
+ */
+template<class _Key, class _Val, class _Compare = less<_Key>, class _Alloc = tinySTL::allocator<tinySTL::pair<_Key, _Val>>>
+class btree_map {
+
+template<class, class, class, class> friend class btree_map;
+template<class, class, class, class> friend class btree_multimap;
+
+ public:
+  typedef _Key     key_type;
+  typedef tinySTL::pair<const _Key, _Val> value_type;
+  typedef _Compare key_compare;
+  typedef _Alloc   allocator_type;
+
+  class value_compare 
+  : public binary_function<value_type, value_type, bool> 
+  {
+    friend class btree_map;
+   protected:
+    key_compare comp;
+    value_compare(key_compare __c) : comp(__c) {}
+   public:
+    bool operator()
+    (const value_type& __x, const value_type& __y) const 
+    { return comp(__x.first, __y.first); }
+  };
+
+ protected:
+  typedef tinySTL::_Btree<key_type, value_type, _Select1st<value_type>, key_compare, _Alloc>
+            _Rep_type;
+  _Rep_type _M_t;
+ 
+ public:
+  typedef typename _Rep_type::pointer pointer;
+  typedef typename _Rep_type::const_pointer const_pointer;
+  typedef typename _Rep_type::reference reference;
+  typedef typename _Rep_type::const_reference const_reference;
+  typedef typename _Rep_type::iterator iterator;
+  typedef typename _Rep_type::const_iterator const_iterator;
+  typedef typename _Rep_type::reverse_iterator reverse_iterator;
+  typedef typename _Rep_type::const_reverse_iterator const_reverse_iterator;
+  typedef typename _Rep_type::size_type size_type;
+  typedef typename _Rep_type::difference_type difference_type;
+
+ public:
+  btree_map() : _M_t() {}
+
+  btree_map(const btree_map&) = default;
+
+  btree_map(btree_map&&) = default;
+
+  btree_map(std::initializer_list<value_type> __l) : _M_t() 
+  { insert(__l); }
+
+  template <InputIterator Iterator>
+  btree_map(Iterator __first, Iterator __last) : _M_t() 
+  { insert(__first, __last); }
+
+  ~btree_map() {}
+
+  btree_map& operator=(const btree_map&) = default;
+
+  btree_map& operator=(btree_map&&) = default;
+
+  btree_map& operator=(std::initializer_list<value_type> __l) 
+  {
+    clear();
+    insert(__l);
+    return *this;
+  }
+
+  key_compare key_comp() const { return _M_t.key_comp(); }
+
+  value_compare value_comp() const { return _M_t.key_comp(); }
+
+ public:
+  allocator_type get_allocator() const { return allocator_type{}; }
+
+  iterator begin() { return _M_t.begin(); }
+
+  const_iterator begin() const { return _M_t.begin(); }
+ 
+  const_iterator cbegin() const { return _M_t.begin(); }
+
+  iterator end() { return _M_t.end(); }
+
+  const_iterator end() const { return _M_t.end(); }
+
+  const_iterator cend() const { return _M_t.end(); }
+
+  reverse_iterator rbegin() { return _M_t.rbegin(); }
+
+  const_reverse_iterator rbegin() const { return _M_t.rbegin(); }
+
+  const_reverse_iterator crbegin() const { return _M_t.rbegin(); }
+
+  reverse_iterator rend() { return _M_t.rend(); }
+
+  const_reverse_iterator rend() const { return _M_t.rend(); }
+
+  const_reverse_iterator crend() const { return _M_t.rend(); }
+
+  bool empty() const { return _M_t.size() == 0; }
+
+  size_type size() const { return _M_t.size(); }
+
+  size_type max_size() const { return _M_t.max_size(); }
+
+  void swap(btree_map& __x) { tinySTL::swap(*this, __x); }
+
+  _Val& operator[](const key_type& __k) {
+    iterator __i = lower_bound(__k);
+    if (__i == end() || key_comp()(__k, (*__i).first)) {
+      __i = insert(__i, value_type(__k, _Val()));
+    }
+    return (*__i).second;
+  }
+
+  const _Val& operator[](const key_type& __k) const {
+    const_iterator __i = lower_bound(__k);
+    if (__i == end() || key_comp()(__k, (*__i).first)) {
+      __tiny_throw_range_error("btree_map::operator[] const: key not found");
+    }
+    return (*__i).second;
+  }
+
+  _Val& at(const key_type& __k) 
+  {
+    return this->operator[](__k);
+  }
+
+  const _Val& at(const key_type& __k) const 
+  {
+    const_iterator __i = find(__k);
+    if (__i == end()) {
+      __tiny_throw_range_error("btree_map::at() const: key not found");
+    }
+    return (*__i).second;
+  }
+
+  template<typename... _Args> tinySTL::pair<iterator, bool>
+  emplace(_Args&&... __args) { return _M_t._M_emplace_unique(tinySTL::forward<_Args>(__args)...); }
+
+  template<typename... _Args> iterator
+  emplace_hint(const_iterator __hint, _Args &&...__args) 
+  { return _M_t._M_emplace_hint_unique(__hint.base(), tinySTL::forward<_Args>(__args)...); }
+
+  tinySTL::pair<iterator, bool>
+  insert(const value_type& __x) { return _M_t._M_insert_unique(__x); }
+
+  tinySTL::pair<iterator, bool>
+  insert(value_type&& __x) { return _M_t._M_insert_unique(tinySTL::move(__x)); }
+
+  iterator insert(const_iterator __hint, const value_type& __x) 
+  { return _M_t._M_insert_unique(__hint.base(), __x); }
+
+  iterator insert(const_iterator __hint, value_type&& __x) 
+  { return _M_t._M_insert_unique(__hint.base(), tinySTL::move(__x)); }
+
+  template<typename _InputIterator> void
+  insert(_InputIterator __first, _InputIterator __last) 
+  {
+    iterator it = end();
+    for (; __first != __last; ++__first) {
+      it = insert(it, *__first);
+    }
+  }
+
+  void insert(std::initializer_list<value_type> __l) {
+    insert(__l.begin(), __l.end());
+  }
+
+  size_type erase(const key_type& __k) 
+  { return _M_t.erase(__k); }
+
+  iterator erase(const_iterator __position) 
+  { return _M_t.erase(__position.base()); }
+
+  iterator erase(const_iterator __first, const_iterator __last) 
+  { return _M_t.erase(__first.base(), __last.base()); }
+
+  void clear() { _M_t.clear(); }
+
+  size_type count(const key_type& __x) const { return _M_t.count_unique(__x); }
+
+  bool contains(const key_type& __x) const { return find(__x) != end(); }
+
+  iterator find(const key_type& __x) { return _M_t.find(__x); }
+
+  const_iterator find(const key_type& __x) const { return _M_t.find(__x); }
+
+  iterator lower_bound(const key_type& __x) { return _M_t.lower_bound(__x); }
+
+  const_iterator lower_bound(const key_type& __x) const { return _M_t.lower_bound(__x); }
+
+  iterator upper_bound(const key_type& __x) { return _M_t.upper_bound(__x); }
+  
+  const_iterator upper_bound(const key_type& __x) const { return _M_t.upper_bound(__x); }
+
+  tinySTL::pair<iterator, iterator>
+  equal_range(const key_type& __x) 
+  { return _M_t.equal_range(__x); }
+
+  tinySTL::pair<const_iterator, const_iterator>
+  equal_range(const key_type& __x) const 
+  { return _M_t.equal_range(__x); }
+
+
+  template <class _Compare2>
+  void merge(btree_map<_Key, _Val, _Compare2, _Alloc>& __source) 
+  { return merge(tinySTL::move(__source)); }
+
+  template <class _Compare2>
+  void merge(btree_map<_Key, _Val, _Compare2, _Alloc>&& __source) 
+  { _M_t._M_merge_unique(tinySTL::move(__source._M_t)); }
+
+  template <class _Compare2>
+  void merge(btree_multimap<_Key, _Val, _Compare2, _Alloc>& __source) 
+  { return merge(tinySTL::move(__source)); }
+
+  template <class _Compare2>
+  void merge(btree_multimap<_Key, _Val, _Compare2, _Alloc>&& __source)
+  { _M_t._M_merge_unique(tinySTL::move(__source._M_t)); }
+
+  friend bool operator==(const btree_map& __x, const btree_map& __y) 
+  {
+    if (&__x != &__y) {
+      return __x.size() == __y.size()
+        && tinySTL::equal(__x.begin(), __x.end(), __y.begin());
+    } else {
+      return true;
+    }
+  }
+
+  friend bool operator<(const btree_map& __x, const btree_map& __y) 
+  {
+    return lexicographical_compare(
+      __x.begin(), __x.end(),
+      __y.begin(), __y.end(),
+      [comp = __x.value_comp()](const value_type& __a, const value_type& __b) {
+        return comp(__a, __b) || (!comp(__b, __a) && __a.second < __b.second); 
+      }
+    );
+  }
+
+  friend std::ostream& operator<<(std::ostream& os, const btree_map& s) 
+  { return os << s._M_t; }
+
+};
+
+template<class _Key, class _Val, class _Compare = less<_Key>, class _Alloc = tinySTL::allocator<tinySTL::pair<_Key, _Val>>>
+class btree_multimap {
+ 
+template<class, class, class, class> friend class btree_map;
+template<class, class, class, class> friend class btree_multimap;
+
+ public:
+  typedef _Key     key_type;
+  typedef tinySTL::pair<const _Key, _Val> value_type;
+  typedef _Compare key_compare;
+  typedef _Alloc   allocator_type;
+
+  class value_compare 
+  : public binary_function<value_type, value_type, bool> 
+  {
+    friend class btree_multimap;
+   protected:
+    key_compare comp;
+    value_compare(key_compare __c) : comp(__c) {}
+   public:
+    bool operator()
+    (const value_type& __x, const value_type& __y) const 
+    { return comp(__x.first, __y.first); }
+  };
+
+ protected:
+  typedef tinySTL::_Btree<key_type, value_type, _Select1st<value_type>, key_compare, _Alloc>
+            _Rep_type;
+  _Rep_type _M_t;
+ 
+ public:
+  typedef typename _Rep_type::pointer pointer;
+  typedef typename _Rep_type::const_pointer const_pointer;
+  typedef typename _Rep_type::reference reference;
+  typedef typename _Rep_type::const_reference const_reference;
+  typedef typename _Rep_type::iterator iterator;
+  typedef typename _Rep_type::const_iterator const_iterator;
+  typedef typename _Rep_type::reverse_iterator reverse_iterator;
+  typedef typename _Rep_type::const_reverse_iterator const_reverse_iterator;
+  typedef typename _Rep_type::size_type size_type;
+  typedef typename _Rep_type::difference_type difference_type;
+
+ public:
+  btree_multimap() : _M_t() {}
+
+  btree_multimap(const btree_multimap&) = default;
+
+  btree_multimap(btree_multimap&&) = default;
+
+  btree_multimap(std::initializer_list<value_type> __l) : _M_t() 
+  { insert(__l); }
+
+  template <InputIterator Iterator>
+  btree_multimap(Iterator __first, Iterator __last) : _M_t() 
+  { insert(__first, __last); }
+
+  ~btree_multimap() {}
+
+  btree_multimap& operator=(const btree_multimap&) = default;
+
+  btree_multimap& operator=(btree_multimap&&) = default;
+
+  btree_multimap& operator=(std::initializer_list<value_type> __l) 
+  {
+    clear();
+    insert(__l);
+    return *this;
+  }
+
+  key_compare key_comp() const { return _M_t.key_comp(); }
+
+  value_compare value_comp() const { return _M_t.key_comp(); }
+
+ public:
+  allocator_type get_allocator() const { return allocator_type{}; }
+
+  iterator begin() { return _M_t.begin(); }
+
+  const_iterator begin() const { return _M_t.begin(); }
+ 
+  const_iterator cbegin() const { return _M_t.begin(); }
+
+  iterator end() { return _M_t.end(); }
+
+  const_iterator end() const { return _M_t.end(); }
+
+  const_iterator cend() const { return _M_t.end(); }
+
+  reverse_iterator rbegin() { return _M_t.rbegin(); }
+
+  const_reverse_iterator rbegin() const { return _M_t.rbegin(); }
+
+  const_reverse_iterator crbegin() const { return _M_t.rbegin(); }
+
+  reverse_iterator rend() { return _M_t.rend(); }
+
+  const_reverse_iterator rend() const { return _M_t.rend(); }
+
+  const_reverse_iterator crend() const { return _M_t.rend(); }
+
+  bool empty() const { return _M_t.size() == 0; }
+
+  size_type size() const { return _M_t.size(); }
+
+  size_type max_size() const { return _M_t.max_size(); }
+
+  void swap(btree_multimap& __x) { tinySTL::swap(*this, __x); }
+
+  template<typename... _Args> iterator
+  emplace(_Args&&... __args) { return _M_t._M_emplace_equal(tinySTL::forward<_Args>(__args)...); }
+
+  template<typename... _Args> iterator
+  emplace_hint(const_iterator __hint, _Args &&...__args) 
+  { return _M_t._M_emplace_hint_equal(__hint.base(), tinySTL::forward<_Args>(__args)...); }
+
+  iterator
+  insert(const value_type& __x) { return _M_t._M_insert_equal(__x); }
+
+  iterator
+  insert(value_type&& __x) { return _M_t._M_insert_equal(tinySTL::move(__x)); }
+
+  iterator insert(const_iterator __hint, const value_type& __x) 
+  { return _M_t._M_insert_equal(__hint.base(), __x); }
+
+  iterator insert(const_iterator __hint, value_type&& __x) 
+  { return _M_t._M_insert_equal(__hint.base(), tinySTL::move(__x)); }
+
+  template<typename _InputIterator> void
+  insert(_InputIterator __first, _InputIterator __last) 
+  {
+    iterator it = end();
+    for (; __first != __last; ++__first) {
+      it = insert(it, *__first);
+    }
+  }
+
+  void insert(std::initializer_list<value_type> __l) {
+    insert(__l.begin(), __l.end());
+  }
+
+  size_type erase(const key_type& __k) 
+  { return _M_t.erase(__k); }
+
+  iterator erase(const_iterator __position) 
+  { return _M_t.erase(__position.base()); }
+
+  iterator erase(const_iterator __first, const_iterator __last) 
+  { return _M_t.erase(__first.base(), __last.base()); }
+
+  void clear() { _M_t.clear(); }
+
+  size_type count(const key_type& __x) const { return _M_t.count_multi(__x); }
+
+  bool contains(const key_type& __x) const { return find(__x) != end(); }
+
+  iterator find(const key_type& __x) { return _M_t.find(__x); }
+
+  const_iterator find(const key_type& __x) const { return _M_t.find(__x); }
+
+  iterator lower_bound(const key_type& __x) { return _M_t.lower_bound(__x); }
+
+  const_iterator lower_bound(const key_type& __x) const { return _M_t.lower_bound(__x); }
+
+  iterator upper_bound(const key_type& __x) { return _M_t.upper_bound(__x); }
+  
+  const_iterator upper_bound(const key_type& __x) const { return _M_t.upper_bound(__x); }
+
+  tinySTL::pair<iterator, iterator>
+  equal_range(const key_type& __x) 
+  { return _M_t.equal_range(__x); }
+
+  tinySTL::pair<const_iterator, const_iterator>
+  equal_range(const key_type& __x) const 
+  { return _M_t.equal_range(__x); }
+
+
+  template <class _Compare2>
+  void merge(btree_map<_Key, _Val, _Compare2, _Alloc>& __source) 
+  { return merge(tinySTL::move(__source)); }
+
+  template <class _Compare2>
+  void merge(btree_map<_Key, _Val, _Compare2, _Alloc>&& __source) 
+  { _M_t._M_merge_equal(tinySTL::move(__source._M_t)); }
+
+  template <class _Compare2>
+  void merge(btree_multimap<_Key, _Val, _Compare2, _Alloc>& __source) 
+  { return merge(tinySTL::move(__source)); }
+
+  template <class _Compare2>
+  void merge(btree_multimap<_Key, _Val, _Compare2, _Alloc>&& __source) 
+  { _M_t._M_merge_equal(tinySTL::move(__source._M_t)); }
+
+  friend bool operator==(const btree_multimap& __x, const btree_multimap& __y) 
+  {
+    if (&__x != &__y) {
+      return __x.size() == __y.size()
+        && tinySTL::equal(__x.begin(), __x.end(), __y.begin());
+    } else {
+      return true;
+    }
+  }
+
+  friend bool operator<(const btree_multimap& __x, const btree_multimap& __y) 
+  {
+    return lexicographical_compare(
+      __x.begin(), __x.end(),
+      __y.begin(), __y.end(),
+      [comp = __x.value_comp()](const value_type& __a, const value_type& __b) {
+        return comp(__a, __b) || (!comp(__b, __a) && __a.second < __b.second); 
+      }
+    );
+  }
+
+  friend std::ostream& operator<<(std::ostream& os, const btree_multimap& s) 
+  { return os << s._M_t; }
+
+};
+
+}
\ No newline at end of file
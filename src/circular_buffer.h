@@ -0,0 +1,504 @@
+// tinySTL: circular_buffer.
+#pragma once
+
+#include <initializer_list>
+
+#include "tiny_pair.h"
+#include "tiny_alloc.h"
+#include "tiny_errors.h"
+#include "tiny_concepts.h"
+#include "tiny_iterator.h"
+#include "tiny_algobase.h"
+#include "tiny_construct.h"
+#include "tiny_uninitialized.h"
+
+namespace tinySTL
+{
+
+/**
+ * @brief  A fixed capacity ring buffer kept in a single allocation.
+ *  The capacity is always rounded up to a power of two, so a logical index
+ *  is mapped to its slot by a mask instead of a division. Elements are
+ *  pushed at both ends with one of two policies:
+ *    push_back / push_front overwrite the element at the opposite end
+ *    when the buffer is full, try_push_back / try_push_front reject the
+ *    new element and return false.
+ *  The content is always stored in at most two contiguous spans, see
+ *  array_one() and array_two().
+ */
+template <class _Tp, class _Alloc = tinySTL::allocator<_Tp>>
+class circular_buffer {
+
+ protected:
+  class _Circular_buffer_iterator {
+    template <class, class> friend class circular_buffer;
+
+   public:
+    using iterator_category = tinySTL::random_access_iterator_tag;
+    using value_type = _Tp;
+    using difference_type = ptrdiff_t;
+    using pointer = _Tp*;
+    using reference = _Tp&;
+
+   protected:
+    // _M_pos is the unwrapped position, its slot is (_M_pos & _M_mask).
+    pointer _M_buf;
+    size_t  _M_mask;
+    size_t  _M_pos;
+
+    constexpr _Circular_buffer_iterator(pointer __buf, size_t __mask, size_t __pos)
+    : _M_buf(__buf), _M_mask(__mask), _M_pos(__pos) {}
+
+    // one lap of the ring, the segment of the unwrapped position.
+    struct _Lap {
+      pointer _M_buf;
+      size_t  _M_mask;
+      size_t  _M_base;
+
+      _Lap& operator++() { _M_base += _M_mask + 1; return *this; }
+      friend bool operator==(const _Lap& __x, const _Lap& __y) { return __x._M_base == __y._M_base; }
+      friend bool operator!=(const _Lap& __x, const _Lap& __y) { return __x._M_base != __y._M_base; }
+    };
+
+   public:
+    // segmented iterator protocol, see __segmented_iterator_traits.
+    struct _Segmented_traits {
+      typedef _Lap    __segment_iterator;
+      typedef pointer __local_iterator;
+
+      static __segment_iterator __segment(const _Circular_buffer_iterator& __it)
+        { return _Lap{__it._M_buf, __it._M_mask, __it._M_pos & ~__it._M_mask}; }
+
+      static __local_iterator __local(const _Circular_buffer_iterator& __it)
+        { return __it._M_buf + (__it._M_pos & __it._M_mask); }
+
+      static __local_iterator __begin(const __segment_iterator& __s)
+        { return __s._M_buf; }
+
+      static __local_iterator __end(const __segment_iterator& __s)
+        { return __s._M_buf + (__s._M_mask + 1); }
+
+      static _Circular_buffer_iterator
+      __compose(const __segment_iterator& __s, __local_iterator __l)
+        { return _Circular_buffer_iterator(__s._M_buf, __s._M_mask, __s._M_base + (__l - __s._M_buf)); }
+    };
+
+    constexpr _Circular_buffer_iterator() : _M_buf(), _M_mask(), _M_pos() {}
+    constexpr reference operator*() const { return _M_buf[_M_pos & _M_mask]; }
+    constexpr pointer  operator->() const { return _M_buf + (_M_pos & _M_mask); }
+    constexpr _Circular_buffer_iterator& operator++() { ++_M_pos; return *this; }
+    constexpr _Circular_buffer_iterator& operator--() { --_M_pos; return *this; }
+    constexpr _Circular_buffer_iterator  operator++(int) { _Circular_buffer_iterator __tmp = *this; ++(*this); return __tmp; }
+    constexpr _Circular_buffer_iterator  operator--(int) { _Circular_buffer_iterator __tmp = *this; --(*this); return __tmp; }
+    constexpr _Circular_buffer_iterator& operator+=(difference_type __n) { _M_pos += __n; return *this; }
+    constexpr _Circular_buffer_iterator& operator-=(difference_type __n) { _M_pos -= __n; return *this; }
+    constexpr _Circular_buffer_iterator  operator+ (difference_type __n) const { _Circular_buffer_iterator __tmp = *this; __tmp += __n; return __tmp; }
+    constexpr _Circular_buffer_iterator  operator- (difference_type __n) const { _Circular_buffer_iterator __tmp = *this; __tmp -= __n; return __tmp; }
+    constexpr reference operator[](difference_type __n) const { return *(*this + __n); }
+    constexpr difference_type operator-(const _Circular_buffer_iterator& __right) const { return difference_type(_M_pos - __right._M_pos); }
+    friend constexpr _Circular_buffer_iterator operator+(difference_type __n, const _Circular_buffer_iterator& __x) { return __x + __n; }
+    friend constexpr bool operator==(const _Circular_buffer_iterator& __x, const _Circular_buffer_iterator& __y) { return __x._M_pos == __y._M_pos; }
+    friend constexpr bool operator!=(const _Circular_buffer_iterator& __x, const _Circular_buffer_iterator& __y) { return __x._M_pos != __y._M_pos; }
+    friend constexpr bool operator< (const _Circular_buffer_iterator& __x, const _Circular_buffer_iterator& __y) { return __x._M_pos <  __y._M_pos; }
+    friend constexpr bool operator> (const _Circular_buffer_iterator& __x, const _Circular_buffer_iterator& __y) { return __x._M_pos >  __y._M_pos; }
+    friend constexpr bool operator<=(const _Circular_buffer_iterator& __x, const _Circular_buffer_iterator& __y) { return __x._M_pos <= __y._M_pos; }
+    friend constexpr bool operator>=(const _Circular_buffer_iterator& __x, const _Circular_buffer_iterator& __y) { return __x._M_pos >= __y._M_pos; }
+  };
+
+ public:
+  typedef _Tp value_type;
+  typedef value_type* pointer;
+  typedef const value_type* const_pointer;
+  typedef _Circular_buffer_iterator iterator;
+  typedef tinySTL::const_iterator<iterator> const_iterator;
+  typedef value_type& reference;
+  typedef const value_type& const_reference;
+  typedef size_t size_type;
+  typedef ptrdiff_t difference_type;
+  typedef _Alloc allocator_type;
+  typedef tinySTL::reverse_iterator<const_iterator> const_reverse_iterator;
+  typedef tinySTL::reverse_iterator<iterator> reverse_iterator;
+  typedef tinySTL::pair<pointer, size_type> array_range;
+  typedef tinySTL::pair<const_pointer, size_type> const_array_range;
+
+ protected:
+  struct _Circular_buffer_impl : public _Alloc
+  {
+    _Tp* _M_start;
+    size_type _M_mask;
+    size_type _M_head;
+    size_type _M_size;
+
+    _Circular_buffer_impl()
+      : _M_start(0), _M_mask(0), _M_head(0), _M_size(0) {}
+  };
+
+  _Circular_buffer_impl _M_impl;
+
+ public:
+  circular_buffer() {}
+
+  /**
+   * @brief  create an empty buffer.
+   * @param  __capacity  the requested capacity, rounded up to a power of two.
+   */
+  explicit circular_buffer(size_type __capacity)
+  { _M_initialize(__capacity); }
+
+  /**
+   * @brief  create a buffer from [__first, __last), when the range is longer
+   *  than the capacity only the newest elements are kept.
+   */
+  template <InputIterator Iterator>
+  circular_buffer(size_type __capacity, Iterator __first, Iterator __last)
+  {
+    _M_initialize(__capacity);
+    try {
+      for (; __first != __last; ++__first)
+        push_back(*__first);
+    } catch (...) {
+      _M_destroy_and_deallocate();
+      throw;
+    }
+  }
+
+  circular_buffer(std::initializer_list<_Tp> __l)
+  : circular_buffer(__l.size(), __l.begin(), __l.end()) {}
+
+  circular_buffer(const circular_buffer& __x)
+  {
+    _M_initialize(__x.capacity());
+    const_array_range __one = __x.array_one();
+    const_array_range __two = __x.array_two();
+    pointer __cur = _M_impl._M_start;
+    try {
+      __cur = tinySTL::uninitialized_copy(__one.first, __one.first + __one.second, __cur);
+      __cur = tinySTL::uninitialized_copy(__two.first, __two.first + __two.second, __cur);
+    } catch (...) {
+      tinySTL::destroy(_M_impl._M_start, __cur);
+      _M_deallocate(_M_impl._M_start, capacity());
+      throw;
+    }
+    _M_impl._M_size = __x.size();
+  }
+
+  circular_buffer(circular_buffer&& __x)
+  { swap(__x); }
+
+  ~circular_buffer()
+  { _M_destroy_and_deallocate(); }
+
+  circular_buffer& operator=(const circular_buffer& __x)
+  {
+    if (this != &__x) {
+      circular_buffer __tmp(__x);
+      swap(__tmp);
+    }
+    return *this;
+  }
+
+  circular_buffer& operator=(circular_buffer&& __x)
+  {
+    if (this != &__x) {
+      circular_buffer __tmp(tinySTL::move(__x));
+      swap(__tmp);
+    }
+    return *this;
+  }
+
+  allocator_type get_allocator() const
+  { return allocator_type(_M_impl); }
+
+  iterator begin()
+  { return iterator(_M_impl._M_start, _M_impl._M_mask, _M_impl._M_head); }
+
+  const_iterator begin() const
+  { return const_cast<circular_buffer*>(this)->begin(); }
+
+  iterator end()
+  { return iterator(_M_impl._M_start, _M_impl._M_mask, _M_impl._M_head + _M_impl._M_size); }
+
+  const_iterator end() const
+  { return const_cast<circular_buffer*>(this)->end(); }
+
+  const_iterator cbegin() const { return begin(); }
+
+  const_iterator cend() const { return end(); }
+
+  reverse_iterator rbegin() { return reverse_iterator(end()); }
+
+  const_reverse_iterator rbegin() const { return const_reverse_iterator(end()); }
+
+  reverse_iterator rend() { return reverse_iterator(begin()); }
+
+  const_reverse_iterator rend() const { return const_reverse_iterator(begin()); }
+
+  const_reverse_iterator crbegin() const { return rbegin(); }
+
+  const_reverse_iterator crend() const { return rend(); }
+
+  bool empty() const { return _M_impl._M_size == 0; }
+
+  bool full() const { return _M_impl._M_size == capacity(); }
+
+  size_type size() const { return _M_impl._M_size; }
+
+  size_type capacity() const
+  { return _M_impl._M_start ? _M_impl._M_mask + 1 : 0; }
+
+  size_type reserve() const { return capacity() - size(); }
+
+  size_type max_size() const
+  { return (size_type(-1) >> 1) / sizeof(_Tp); }
+
+  reference operator[](size_type __n)
+  { return _M_impl._M_start[_M_slot(__n)]; }
+
+  const_reference operator[](size_type __n) const
+  { return _M_impl._M_start[_M_slot(__n)]; }
+
+  reference at(size_type __n)
+  { _M_range_check(__n); return (*this)[__n]; }
+
+  const_reference at(size_type __n) const
+  { _M_range_check(__n); return (*this)[__n]; }
+
+  reference front()
+  { _M_range_check(0); return (*this)[0]; }
+
+  const_reference front() const
+  { _M_range_check(0); return (*this)[0]; }
+
+  reference back()
+  { _M_range_check(0); return (*this)[size() - 1]; }
+
+  const_reference back() const
+  { _M_range_check(0); return (*this)[size() - 1]; }
+
+  /**
+   * @brief  the first contiguous span of the content, from the front element
+   *  up to the end of the storage or the back element.
+   */
+  array_range array_one()
+  {
+    size_type __n = capacity() - _M_impl._M_head;
+    return array_range(_M_impl._M_start + _M_impl._M_head,
+                       __n < size() ? __n : size());
+  }
+
+  const_array_range array_one() const
+  {
+    array_range __r = const_cast<circular_buffer*>(this)->array_one();
+    return const_array_range(__r.first, __r.second);
+  }
+
+  /**
+   * @brief  the second contiguous span of the content, starting at the
+   *  beginning of the storage. Empty unless the content wraps around.
+   */
+  array_range array_two()
+  {
+    size_type __n = capacity() - _M_impl._M_head;
+    return array_range(_M_impl._M_start, __n < size() ? size() - __n : 0);
+  }
+
+  const_array_range array_two() const
+  {
+    array_range __r = const_cast<circular_buffer*>(this)->array_two();
+    return const_array_range(__r.first, __r.second);
+  }
+
+  /**
+   * @brief  append an element, when the buffer is full the front element
+   *  is overwritten.
+   */
+  void push_back(const _Tp& __x) { emplace_back(__x); }
+
+  void push_back(_Tp&& __x) { emplace_back(tinySTL::move(__x)); }
+
+  /**
+   * @brief  prepend an element, when the buffer is full the back element
+   *  is overwritten.
+   */
+  void push_front(const _Tp& __x) { emplace_front(__x); }
+
+  void push_front(_Tp&& __x) { emplace_front(tinySTL::move(__x)); }
+
+  template <typename... _Args>
+  void emplace_back(_Args&& ...__args)
+  {
+    if (capacity() == 0)
+      return;
+    if (full()) {
+      _M_impl._M_start[_M_impl._M_head] = _Tp(tinySTL::forward<_Args>(__args)...);
+      _M_impl._M_head = (_M_impl._M_head + 1) & _M_impl._M_mask;
+    } else {
+      tinySTL::construct(_M_impl._M_start + _M_slot(size()),
+                         tinySTL::forward<_Args>(__args)...);
+      ++_M_impl._M_size;
+    }
+  }
+
+  template <typename... _Args>
+  void emplace_front(_Args&& ...__args)
+  {
+    if (capacity() == 0)
+      return;
+    size_type __slot = (_M_impl._M_head - 1) & _M_impl._M_mask;
+    if (full()) {
+      _M_impl._M_start[__slot] = _Tp(tinySTL::forward<_Args>(__args)...);
+    } else {
+      tinySTL::construct(_M_impl._M_start + __slot,
+                         tinySTL::forward<_Args>(__args)...);
+      ++_M_impl._M_size;
+    }
+    _M_impl._M_head = __slot;
+  }
+
+  /**
+   * @brief  append an element unless the buffer is full.
+   * @return false if the element was rejected.
+   */
+  bool try_push_back(const _Tp& __x) { return try_emplace_back(__x); }
+
+  bool try_push_back(_Tp&& __x) { return try_emplace_back(tinySTL::move(__x)); }
+
+  /**
+   * @brief  prepend an element unless the buffer is full.
+   * @return false if the element was rejected.
+   */
+  bool try_push_front(const _Tp& __x) { return try_emplace_front(__x); }
+
+  bool try_push_front(_Tp&& __x) { return try_emplace_front(tinySTL::move(__x)); }
+
+  template <typename... _Args>
+  bool try_emplace_back(_Args&& ...__args)
+  {
+    if (full())
+      return false;
+    emplace_back(tinySTL::forward<_Args>(__args)...);
+    return true;
+  }
+
+  template <typename... _Args>
+  bool try_emplace_front(_Args&& ...__args)
+  {
+    if (full())
+      return false;
+    emplace_front(tinySTL::forward<_Args>(__args)...);
+    return true;
+  }
+
+  void pop_front()
+  {
+    if (!empty()) {
+      tinySTL::destroy(_M_impl._M_start + _M_impl._M_head);
+      _M_impl._M_head = (_M_impl._M_head + 1) & _M_impl._M_mask;
+      --_M_impl._M_size;
+    }
+  }
+
+  void pop_back()
+  {
+    if (!empty()) {
+      --_M_impl._M_size;
+      tinySTL::destroy(_M_impl._M_start + _M_slot(size()));
+    }
+  }
+
+  void clear()
+  {
+    _M_destroy_elements();
+    _M_impl._M_head = 0;
+    _M_impl._M_size = 0;
+  }
+
+  /**
+   * @brief  change the capacity (rounded up to a power of two), the content
+   *  is linearized into the new storage. When the new capacity is smaller
+   *  than size() only the newest elements are kept.
+   */
+  void set_capacity(size_type __capacity)
+  {
+    circular_buffer __tmp(__capacity);
+    size_type __n = size() < __tmp.capacity() ? size() : __tmp.capacity();
+    __tmp._M_impl._M_size = tinySTL::uninitialized_move(end() - __n, end(),
+      __tmp._M_impl._M_start) - __tmp._M_impl._M_start;
+    swap(__tmp);
+  }
+
+  void swap(circular_buffer& __x)
+  {
+    tinySTL::swap(_M_impl._M_start, __x._M_impl._M_start);
+    tinySTL::swap(_M_impl._M_mask, __x._M_impl._M_mask);
+    tinySTL::swap(_M_impl._M_head, __x._M_impl._M_head);
+    tinySTL::swap(_M_impl._M_size, __x._M_impl._M_size);
+  }
+
+ protected:
+  static size_type _S_round_capacity(size_type __n)
+  {
+    size_type __cap = 1;
+    while (__cap < __n)
+      __cap <<= 1;
+    return __cap;
+  }
+
+  size_type _M_slot(size_type __n) const
+  { return (_M_impl._M_head + __n) & _M_impl._M_mask; }
+
+  void _M_range_check(size_type __n) const
+  {
+    if (__n >= size())
+      __tiny_throw_range_error("circular_buffer");
+  }
+
+  void _M_initialize(size_type __capacity)
+  {
+    if (__capacity > max_size())
+      __tiny_throw_length_error("circular_buffer");
+    if (__capacity == 0)
+      return;
+    size_type __cap = _S_round_capacity(__capacity);
+    _M_impl._M_start = _M_impl.allocate(__cap);
+    _M_impl._M_mask = __cap - 1;
+  }
+
+  void _M_deallocate(pointer __p, size_type __n)
+  {
+    if (__p)
+      _M_impl.deallocate(__p, __n);
+  }
+
+  void _M_destroy_elements()
+  {
+    array_range __one = array_one();
+    array_range __two = array_two();
+    tinySTL::destroy(__one.first, __one.first + __one.second);
+    tinySTL::destroy(__two.first, __two.first + __two.second);
+  }
+
+  void _M_destroy_and_deallocate()
+  {
+    _M_destroy_elements();
+    _M_deallocate(_M_impl._M_start, capacity());
+    _M_impl._M_start = 0;
+    _M_impl._M_mask = _M_impl._M_head = _M_impl._M_size = 0;
+  }
+};
+
+template <class _Tp, class _Alloc> inline void
+swap(circular_buffer<_Tp, _Alloc>& __x, circular_buffer<_Tp, _Alloc>& __y)
+  { __x.swap(__y); }
+
+template <class _Tp, class _Alloc> inline bool
+operator==(const circular_buffer<_Tp, _Alloc>& __x, const circular_buffer<_Tp, _Alloc>& __y)
+  { return __x.size() == __y.size()
+    && equal(__x.begin(), __x.end(), __y.begin());
+  }
+
+template <class _Tp, class _Alloc> inline bool
+operator!=(const circular_buffer<_Tp, _Alloc>& __x, const circular_buffer<_Tp, _Alloc>& __y)
+  { return !(__x == __y); }
+
+}
@@ -0,0 +1,166 @@
+// tinySTL: concurrent_skiplist_map.
+#pragma once
+
+#include <initializer_list>
+
+#include "tiny_pair.h"
+#include "tiny_errors.h"
+#include "tiny_concepts.h"
+#include "tiny_skiplist.h"
+#include "tiny_algobase.h"
+#include "tiny_function.h"
+
+namespace tinySTL
+{
+
+/**
+ * @brief  ordered map on a lock-free skip list. insert, emplace, erase,
+ *  find, lower_bound, upper_bound and iteration may be called from many
+ *  threads at once without a lock; readers never wait and erased
+ *  elements stay readable until every iterator that could see them is
+ *  gone.
+ * @attention  the map itself only guards its structure: writing to a
+ *  mapped value another thread reads is up to the caller. Iterators are
+ *  per thread and see a live view, not a snapshot. Construction,
+ *  destruction and swap are not concurrent.
+ */
+template <class _Key, class _Val, class _Compare = less<_Key>>
+class concurrent_skiplist_map
+{
+ public:
+  typedef _Key     key_type;
+  typedef _Val     mapped_type;
+  typedef tinySTL::pair<const _Key, _Val> value_type;
+  typedef _Compare key_compare;
+
+ protected:
+  typedef _Skiplist<key_type, value_type, _Select1st<value_type>, key_compare> _Rep_type;
+  _Rep_type _M_t;
+
+ public:
+  typedef value_type& reference;
+  typedef const value_type& const_reference;
+  typedef typename _Rep_type::iterator iterator;
+  typedef typename _Rep_type::const_iterator const_iterator;
+  typedef typename _Rep_type::size_type size_type;
+  typedef typename _Rep_type::difference_type difference_type;
+
+ public:
+  concurrent_skiplist_map() : _M_t() {}
+
+  explicit concurrent_skiplist_map(const _Compare& __comp) : _M_t(__comp) {}
+
+  concurrent_skiplist_map(std::initializer_list<value_type> __l) : _M_t()
+  { insert(__l.begin(), __l.end()); }
+
+  template <InputIterator _Iterator>
+  concurrent_skiplist_map(_Iterator __first, _Iterator __last) : _M_t()
+  { insert(__first, __last); }
+
+  concurrent_skiplist_map(const concurrent_skiplist_map&) = delete;
+
+  concurrent_skiplist_map& operator=(const concurrent_skiplist_map&) = delete;
+
+  key_compare key_comp() const { return _M_t.key_comp(); }
+
+  iterator begin() { return _M_t.begin(); }
+
+  const_iterator begin() const { return _M_t.begin(); }
+
+  const_iterator cbegin() const { return _M_t.begin(); }
+
+  iterator end() { return _M_t.end(); }
+
+  const_iterator end() const { return _M_t.end(); }
+
+  const_iterator cend() const { return _M_t.end(); }
+
+  bool empty() const { return begin() == end(); }
+
+  // may be stale while other threads insert or erase.
+  size_type size() const { return _M_t.size(); }
+
+  size_type max_size() const { return _M_t.max_size(); }
+
+  _Val& at(const key_type& __k)
+  {
+    iterator __i = find(__k);
+    if (__i == end())
+      __tiny_throw_range_error("concurrent_skiplist_map::at: key not found");
+    return __i->second;
+  }
+
+  const _Val& at(const key_type& __k) const
+  {
+    const_iterator __i = find(__k);
+    if (__i == end())
+      __tiny_throw_range_error("concurrent_skiplist_map::at: key not found");
+    return __i->second;
+  }
+
+  pair<iterator, bool> insert(const value_type& __x)
+  { return _M_t._M_emplace_unique(__x); }
+
+  pair<iterator, bool> insert(value_type&& __x)
+  { return _M_t._M_emplace_unique(tinySTL::move(__x)); }
+
+  template <InputIterator _Iterator>
+  void insert(_Iterator __first, _Iterator __last)
+  {
+    for (; __first != __last; ++__first)
+      _M_t._M_emplace_unique(*__first);
+  }
+
+  void insert(std::initializer_list<value_type> __l)
+  { insert(__l.begin(), __l.end()); }
+
+  template <class... _Args>
+  pair<iterator, bool> emplace(_Args&&... __args)
+  { return _M_t._M_emplace_unique(tinySTL::forward<_Args>(__args)...); }
+
+  size_type erase(const key_type& __k) { return _M_t._M_erase_unique(__k); }
+
+  // erase the element __pos points to, unless another thread already did.
+  void erase(const_iterator __pos) { _M_t._M_erase(__pos); }
+
+  void clear() { _M_t.clear(); }
+
+  iterator find(const key_type& __k) { return _M_t.find(__k); }
+
+  const_iterator find(const key_type& __k) const { return _M_t.find(__k); }
+
+  bool contains(const key_type& __k) const { return find(__k) != end(); }
+
+  size_type count(const key_type& __k) const { return contains(__k) ? 1 : 0; }
+
+  iterator lower_bound(const key_type& __k) { return _M_t.lower_bound(__k); }
+
+  const_iterator lower_bound(const key_type& __k) const { return _M_t.lower_bound(__k); }
+
+  iterator upper_bound(const key_type& __k) { return _M_t.upper_bound(__k); }
+
+  const_iterator upper_bound(const key_type& __k) const { return _M_t.upper_bound(__k); }
+
+  template <class _Kt> requires __is_transparent<_Compare>
+  iterator find(const _Kt& __k) { return _M_t.find(__k); }
+
+  template <class _Kt> requires __is_transparent<_Compare>
+  const_iterator find(const _Kt& __k) const { return _M_t.find(__k); }
+
+  template <class _Kt> requires __is_transparent<_Compare>
+  iterator lower_bound(const _Kt& __k) { return _M_t.lower_bound(__k); }
+
+  template <class _Kt> requires __is_transparent<_Compare>
+  const_iterator lower_bound(const _Kt& __k) const { return _M_t.lower_bound(__k); }
+
+  template <class _Kt> requires __is_transparent<_Compare>
+  iterator upper_bound(const _Kt& __k) { return _M_t.upper_bound(__k); }
+
+  template <class _Kt> requires __is_transparent<_Compare>
+  const_iterator upper_bound(const _Kt& __k) const { return _M_t.upper_bound(__k); }
+
+  friend std::ostream& operator<<(std::ostream& os, const concurrent_skiplist_map& s)
+  { return os << tinySTL::to_string(s); }
+};
+
+}
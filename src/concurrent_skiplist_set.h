@@ -0,0 +1,124 @@
+// tinySTL: concurrent_skiplist_set.
+#pragma once
+
+#include <initializer_list>
+
+#include "tiny_pair.h"
+#include "tiny_concepts.h"
+#include "tiny_skiplist.h"
+#include "tiny_algobase.h"
+#include "tiny_function.h"
+
+namespace tinySTL
+{
+
+/**
+ * @brief  ordered set on a lock-free skip list, see
+ *  concurrent_skiplist_map.
+ * @attention  iterators are per thread and see a live view, not a
+ *  snapshot. Construction and destruction are not concurrent.
+ */
+template <class _Key, class _Compare = less<_Key>>
+class concurrent_skiplist_set
+{
+ public:
+  typedef _Key     key_type;
+  typedef _Key     value_type;
+  typedef _Compare key_compare;
+
+ protected:
+  typedef _Skiplist<key_type, value_type, _Identity<value_type>, key_compare> _Rep_type;
+  _Rep_type _M_t;
+
+ public:
+  typedef const value_type& reference;
+  typedef const value_type& const_reference;
+  typedef typename _Rep_type::const_iterator iterator;
+  typedef typename _Rep_type::const_iterator const_iterator;
+  typedef typename _Rep_type::size_type size_type;
+  typedef typename _Rep_type::difference_type difference_type;
+
+ public:
+  concurrent_skiplist_set() : _M_t() {}
+
+  explicit concurrent_skiplist_set(const _Compare& __comp) : _M_t(__comp) {}
+
+  concurrent_skiplist_set(std::initializer_list<value_type> __l) : _M_t()
+  { insert(__l.begin(), __l.end()); }
+
+  template <InputIterator _Iterator>
+  concurrent_skiplist_set(_Iterator __first, _Iterator __last) : _M_t()
+  { insert(__first, __last); }
+
+  concurrent_skiplist_set(const concurrent_skiplist_set&) = delete;
+
+  concurrent_skiplist_set& operator=(const concurrent_skiplist_set&) = delete;
+
+  key_compare key_comp() const { return _M_t.key_comp(); }
+
+  iterator begin() const { return _M_t.begin(); }
+
+  iterator cbegin() const { return _M_t.begin(); }
+
+  iterator end() const { return _M_t.end(); }
+
+  iterator cend() const { return _M_t.end(); }
+
+  bool empty() const { return begin() == end(); }
+
+  // may be stale while other threads insert or erase.
+  size_type size() const { return _M_t.size(); }
+
+  size_type max_size() const { return _M_t.max_size(); }
+
+  pair<iterator, bool> insert(const value_type& __x)
+  { return _M_t._M_emplace_unique(__x); }
+
+  pair<iterator, bool> insert(value_type&& __x)
+  { return _M_t._M_emplace_unique(tinySTL::move(__x)); }
+
+  template <InputIterator _Iterator>
+  void insert(_Iterator __first, _Iterator __last)
+  {
+    for (; __first != __last; ++__first)
+      _M_t._M_emplace_unique(*__first);
+  }
+
+  void insert(std::initializer_list<value_type> __l)
+  { insert(__l.begin(), __l.end()); }
+
+  template <class... _Args>
+  pair<iterator, bool> emplace(_Args&&... __args)
+  { return _M_t._M_emplace_unique(tinySTL::forward<_Args>(__args)...); }
+
+  size_type erase(const key_type& __k) { return _M_t._M_erase_unique(__k); }
+
+  // erase the element __pos points to, unless another thread already did.
+  void erase(const_iterator __pos) { _M_t._M_erase(__pos); }
+
+  void clear() { _M_t.clear(); }
+
+  iterator find(const key_type& __k) const { return _M_t.find(__k); }
+
+  bool contains(const key_type& __k) const { return find(__k) != end(); }
+
+  size_type count(const key_type& __k) const { return contains(__k) ? 1 : 0; }
+
+  iterator lower_bound(const key_type& __k) const { return _M_t.lower_bound(__k); }
+
+  iterator upper_bound(const key_type& __k) const { return _M_t.upper_bound(__k); }
+
+  template <class _Kt> requires __is_transparent<_Compare>
+  iterator find(const _Kt& __k) const { return _M_t.find(__k); }
+
+  template <class _Kt> requires __is_transparent<_Compare>
+  iterator lower_bound(const _Kt& __k) const { return _M_t.lower_bound(__k); }
+
+  template <class _Kt> requires __is_transparent<_Compare>
+  iterator upper_bound(const _Kt& __k) const { return _M_t.upper_bound(__k); }
+
+  friend std::ostream& operator<<(std::ostream& os, const concurrent_skiplist_set& s)
+  { return os << tinySTL::to_string(s); }
+};
+
+}
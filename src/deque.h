@@ -54,6 +54,34 @@ class _Deque_base {
       _M_node(__y) {}
 
    public:
+    // segmented iterator protocol, see __segmented_iterator_traits.
+    struct _Segmented_traits {
+      typedef _Map_pointer __segment_iterator;
+      typedef pointer      __local_iterator;
+
+      static constexpr __segment_iterator __segment(const _Deque_iterator& __it)
+        { return __it._M_node; }
+
+      static constexpr __local_iterator __local(const _Deque_iterator& __it)
+        { return __it._M_cur; }
+
+      static constexpr __local_iterator __begin(__segment_iterator __s)
+        { return *__s; }
+
+      static constexpr __local_iterator __end(__segment_iterator __s)
+        { return *__s + _S_buffer_size(); }
+
+      static constexpr _Deque_iterator
+      __compose(__segment_iterator __s, __local_iterator __l)
+      {
+        if (__l == __end(__s)) {
+          ++__s;
+          __l = *__s;
+        }
+        return _Deque_iterator(__l, __s);
+      }
+    };
+
     constexpr _Deque_iterator()
     : _M_cur(), _M_first(), _M_last(), _M_node() {}
 
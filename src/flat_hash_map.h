@@ -0,0 +1,274 @@
+// tinySTL: flat_hash_map.
+#pragma once
+
+#include <initializer_list>
+
+#include "tiny_swiss.h"
+#include "tiny_pair.h"
+#include "tiny_alloc.h"
+#include "tiny_errors.h"
+#include "tiny_concepts.h"
+#include "tiny_algobase.h"
+#include "tiny_function.h"
+#include "tiny_hash_fun.h"
+
+namespace tinySTL
+{
+
+/**
+ * @brief  unordered map on an open addressing table: the elements sit in
+ *  one array, with a byte of hash per slot to probe 16 slots at a time.
+ *  A lookup usually costs one miss on the control bytes and one on the
+ *  element, against two or more for the chained unordered_map, and there
+ *  is no node or link per element.
+ * @attention  an insert that grows the table moves every element and
+ *  invalidates all iterators, references and pointers to elements.
+ *  Iteration order is unspecified and changes on growth.
+ */
+template <class _Key, class _Val, class _Hash = tinySTL::hash<_Key>,
+          class _Pred = tinySTL::equal_to<_Key>,
+          class _Alloc = tinySTL::allocator<tinySTL::pair<const _Key, _Val>>>
+class flat_hash_map
+{
+ public:
+  typedef _Key    key_type;
+  typedef _Val    mapped_type;
+  typedef tinySTL::pair<const _Key, _Val> value_type;
+  typedef _Hash   hasher;
+  typedef _Pred   key_equal;
+  typedef _Alloc  allocator_type;
+
+ protected:
+  typedef _Swiss_table<key_type, value_type, _Hash, _Select1st<value_type>, _Pred, _Alloc> _Ht;
+  _Ht _M_ht;
+
+ public:
+  typedef typename _Ht::pointer pointer;
+  typedef typename _Ht::const_pointer const_pointer;
+  typedef typename _Ht::reference reference;
+  typedef typename _Ht::const_reference const_reference;
+  typedef typename _Ht::iterator iterator;
+  typedef typename _Ht::const_iterator const_iterator;
+  typedef typename _Ht::size_type size_type;
+  typedef typename _Ht::difference_type difference_type;
+
+ public:
+  flat_hash_map() : _M_ht(0, hasher(), key_equal()) {}
+
+  explicit flat_hash_map(size_type __n, const hasher& __hf = hasher(),
+                         const key_equal& __eql = key_equal())
+  : _M_ht(__n, __hf, __eql) {}
+
+  flat_hash_map(std::initializer_list<value_type> __l)
+  : _M_ht(__l.size(), hasher(), key_equal())
+  { insert(__l); }
+
+  template <InputIterator _Iterator>
+  flat_hash_map(_Iterator __first, _Iterator __last)
+  : _M_ht(0, hasher(), key_equal())
+  { insert(__first, __last); }
+
+  flat_hash_map(const flat_hash_map&) = default;
+
+  flat_hash_map(flat_hash_map&&) = default;
+
+  flat_hash_map& operator=(const flat_hash_map&) = default;
+
+  flat_hash_map& operator=(flat_hash_map&&) = default;
+
+  flat_hash_map& operator=(std::initializer_list<value_type> __l)
+  {
+    clear();
+    insert(__l);
+    return *this;
+  }
+
+  allocator_type get_allocator() const { return allocator_type{}; }
+
+  hasher hash_function() const { return _M_ht.hash_func(); }
+
+  key_equal key_eq() const { return _M_ht.key_eq(); }
+
+  iterator begin() { return _M_ht.begin(); }
+
+  const_iterator begin() const { return _M_ht.begin(); }
+
+  const_iterator cbegin() const { return _M_ht.begin(); }
+
+  iterator end() { return _M_ht.end(); }
+
+  const_iterator end() const { return _M_ht.end(); }
+
+  const_iterator cend() const { return _M_ht.end(); }
+
+  bool empty() const { return _M_ht.empty(); }
+
+  size_type size() const { return _M_ht.size(); }
+
+  size_type max_size() const { return _M_ht.max_size(); }
+
+  // the number of slots.
+  size_type bucket_count() const { return _M_ht.bucket_count(); }
+
+  float load_factor() const { return bucket_count() ? size() / (float)bucket_count() : 0.0f; }
+
+  // fixed: the table grows when 7/8 of its slots are taken.
+  float max_load_factor() const { return 0.875f; }
+
+  void rehash(size_type __n) { _M_ht.rehash(__n); }
+
+  void reserve(size_type __n) { _M_ht.reserve(__n); }
+
+  void clear() { _M_ht.clear(); }
+
+  void swap(flat_hash_map& __x) noexcept { _M_ht.swap(__x._M_ht); }
+
+  pair<iterator, bool> insert(const value_type& __x)
+  { return _M_ht._M_insert_unique(__x); }
+
+  pair<iterator, bool> insert(value_type&& __x)
+  { return _M_ht._M_insert_unique(tinySTL::move(__x)); }
+
+  iterator insert(const_iterator, const value_type& __x)
+  { return insert(__x).first; }
+
+  iterator insert(const_iterator, value_type&& __x)
+  { return insert(tinySTL::move(__x)).first; }
+
+  template <InputIterator _Iterator>
+  void insert(_Iterator __first, _Iterator __last)
+  {
+    for (; __first != __last; ++__first)
+      insert(*__first);
+  }
+
+  void insert(std::initializer_list<value_type> __l)
+  { insert(__l.begin(), __l.end()); }
+
+  template <class... _Args>
+  pair<iterator, bool> emplace(_Args&&... __args)
+  { return _M_ht._M_emplace_unique(tinySTL::forward<_Args>(__args)...); }
+
+  template <class... _Args>
+  iterator emplace_hint(const_iterator, _Args&&... __args)
+  { return emplace(tinySTL::forward<_Args>(__args)...).first; }
+
+  /**
+   * @brief  insert __k with a value built from __args, unless __k is
+   *  present, in which case nothing is built. The key is hashed once.
+   */
+  template <class... _Args>
+  pair<iterator, bool> try_emplace(const key_type& __k, _Args&&... __args)
+  {
+    size_t __h = _M_ht._M_hash_of(__k);
+    size_type __i = _M_ht._M_find_index(__k, __h);
+    if (__i != _M_ht._M_capacity)
+      return pair<iterator, bool>(_M_ht._M_iter(__i), false);
+    return pair<iterator, bool>(
+        _M_ht._M_emplace_at(__h, std::piecewise_construct, std::forward_as_tuple(__k),
+                            std::forward_as_tuple(tinySTL::forward<_Args>(__args)...)),
+        true);
+  }
+
+  template <class... _Args>
+  pair<iterator, bool> try_emplace(key_type&& __k, _Args&&... __args)
+  {
+    size_t __h = _M_ht._M_hash_of(__k);
+    size_type __i = _M_ht._M_find_index(__k, __h);
+    if (__i != _M_ht._M_capacity)
+      return pair<iterator, bool>(_M_ht._M_iter(__i), false);
+    return pair<iterator, bool>(
+        _M_ht._M_emplace_at(__h, std::piecewise_construct,
+                            std::forward_as_tuple(tinySTL::move(__k)),
+                            std::forward_as_tuple(tinySTL::forward<_Args>(__args)...)),
+        true);
+  }
+
+  template <class _Obj>
+  pair<iterator, bool> insert_or_assign(const key_type& __k, _Obj&& __obj)
+  {
+    pair<iterator, bool> __r = try_emplace(__k, tinySTL::forward<_Obj>(__obj));
+    if (!__r.second)
+      __r.first->second = tinySTL::forward<_Obj>(__obj);
+    return __r;
+  }
+
+  size_type erase(const key_type& __k) { return _M_ht.erase(__k); }
+
+  iterator erase(const_iterator __position) { return _M_ht.erase(__position.base()); }
+
+  iterator erase(iterator __position) { return _M_ht.erase(__position); }
+
+  iterator erase(const_iterator __first, const_iterator __last)
+  {
+    iterator __it = __first.base();
+    while (__it != __last.base())
+      __it = _M_ht.erase(__it);
+    return __it;
+  }
+
+  iterator find(const key_type& __k) { return _M_ht.find(__k); }
+
+  const_iterator find(const key_type& __k) const { return _M_ht.find(__k); }
+
+  bool contains(const key_type& __k) const { return find(__k) != end(); }
+
+  size_type count(const key_type& __k) const { return contains(__k) ? 1 : 0; }
+
+  pair<iterator, iterator> equal_range(const key_type& __k)
+  {
+    iterator __i = find(__k), __j = __i;
+    if (__j != end())
+      ++__j;
+    return pair<iterator, iterator>(__i, __j);
+  }
+
+  pair<const_iterator, const_iterator> equal_range(const key_type& __k) const
+  {
+    const_iterator __i = find(__k), __j = __i;
+    if (__j != end())
+      ++__j;
+    return pair<const_iterator, const_iterator>(__i, __j);
+  }
+
+  _Val& operator[](const key_type& __k) { return try_emplace(__k).first->second; }
+
+  _Val& operator[](key_type&& __k) { return try_emplace(tinySTL::move(__k)).first->second; }
+
+  _Val& at(const key_type& __k)
+  {
+    iterator __i = find(__k);
+    if (__i == end())
+      __tiny_throw_range_error("flat_hash_map::at: key not found");
+    return __i->second;
+  }
+
+  const _Val& at(const key_type& __k) const
+  {
+    const_iterator __i = find(__k);
+    if (__i == end())
+      __tiny_throw_range_error("flat_hash_map::at: key not found");
+    return __i->second;
+  }
+
+  // the same keys mapped to equal values, in whatever order.
+  friend bool operator==(const flat_hash_map& __x, const flat_hash_map& __y)
+  {
+    if (__x.size() != __y.size())
+      return false;
+    for (const value_type& __p : __x) {
+      const_iterator __i = __y.find(__p.first);
+      if (__i == __y.end() || !(__i->second == __p.second))
+        return false;
+    }
+    return true;
+  }
+
+  friend bool operator!=(const flat_hash_map& __x, const flat_hash_map& __y)
+  { return !(__x == __y); }
+
+  friend std::ostream& operator<<(std::ostream& os, const flat_hash_map& m)
+  { return os << tinySTL::to_string(m); }
+};
+
+}
@@ -0,0 +1,197 @@
+// tinySTL: flat_hash_set.
+#pragma once
+
+#include <initializer_list>
+
+#include "tiny_swiss.h"
+#include "tiny_pair.h"
+#include "tiny_alloc.h"
+#include "tiny_concepts.h"
+#include "tiny_algobase.h"
+#include "tiny_function.h"
+#include "tiny_hash_fun.h"
+
+namespace tinySTL
+{
+
+/**
+ * @brief  unordered set on an open addressing table, see flat_hash_map.
+ * @attention  an insert that grows the table moves every element and
+ *  invalidates all iterators, references and pointers to elements.
+ */
+template <class _Key, class _Hash = tinySTL::hash<_Key>,
+          class _Pred = tinySTL::equal_to<_Key>,
+          class _Alloc = tinySTL::allocator<_Key>>
+class flat_hash_set
+{
+ public:
+  typedef _Key    key_type;
+  typedef _Key    value_type;
+  typedef _Hash   hasher;
+  typedef _Pred   key_equal;
+  typedef _Alloc  allocator_type;
+
+ protected:
+  typedef _Swiss_table<key_type, value_type, _Hash, _Identity<_Key>, _Pred, _Alloc> _Ht;
+  _Ht _M_ht;
+
+ public:
+  typedef typename _Ht::const_pointer pointer;
+  typedef typename _Ht::const_pointer const_pointer;
+  typedef typename _Ht::const_reference reference;
+  typedef typename _Ht::const_reference const_reference;
+  typedef typename _Ht::const_iterator iterator;
+  typedef typename _Ht::const_iterator const_iterator;
+  typedef typename _Ht::size_type size_type;
+  typedef typename _Ht::difference_type difference_type;
+
+ public:
+  flat_hash_set() : _M_ht(0, hasher(), key_equal()) {}
+
+  explicit flat_hash_set(size_type __n, const hasher& __hf = hasher(),
+                         const key_equal& __eql = key_equal())
+  : _M_ht(__n, __hf, __eql) {}
+
+  flat_hash_set(std::initializer_list<value_type> __l)
+  : _M_ht(__l.size(), hasher(), key_equal())
+  { insert(__l); }
+
+  template <InputIterator _Iterator>
+  flat_hash_set(_Iterator __first, _Iterator __last)
+  : _M_ht(0, hasher(), key_equal())
+  { insert(__first, __last); }
+
+  flat_hash_set(const flat_hash_set&) = default;
+
+  flat_hash_set(flat_hash_set&&) = default;
+
+  flat_hash_set& operator=(const flat_hash_set&) = default;
+
+  flat_hash_set& operator=(flat_hash_set&&) = default;
+
+  flat_hash_set& operator=(std::initializer_list<value_type> __l)
+  {
+    clear();
+    insert(__l);
+    return *this;
+  }
+
+  allocator_type get_allocator() const { return allocator_type{}; }
+
+  hasher hash_function() const { return _M_ht.hash_func(); }
+
+  key_equal key_eq() const { return _M_ht.key_eq(); }
+
+  iterator begin() const { return _M_ht.begin(); }
+
+  const_iterator cbegin() const { return _M_ht.begin(); }
+
+  iterator end() const { return _M_ht.end(); }
+
+  const_iterator cend() const { return _M_ht.end(); }
+
+  bool empty() const { return _M_ht.empty(); }
+
+  size_type size() const { return _M_ht.size(); }
+
+  size_type max_size() const { return _M_ht.max_size(); }
+
+  // the number of slots.
+  size_type bucket_count() const { return _M_ht.bucket_count(); }
+
+  float load_factor() const { return bucket_count() ? size() / (float)bucket_count() : 0.0f; }
+
+  // fixed: the table grows when 7/8 of its slots are taken.
+  float max_load_factor() const { return 0.875f; }
+
+  void rehash(size_type __n) { _M_ht.rehash(__n); }
+
+  void reserve(size_type __n) { _M_ht.reserve(__n); }
+
+  void clear() { _M_ht.clear(); }
+
+  void swap(flat_hash_set& __x) noexcept { _M_ht.swap(__x._M_ht); }
+
+  pair<iterator, bool> insert(const value_type& __x)
+  {
+    auto __r = _M_ht._M_insert_unique(__x);
+    return pair<iterator, bool>(__r.first, __r.second);
+  }
+
+  pair<iterator, bool> insert(value_type&& __x)
+  {
+    auto __r = _M_ht._M_insert_unique(tinySTL::move(__x));
+    return pair<iterator, bool>(__r.first, __r.second);
+  }
+
+  iterator insert(const_iterator, const value_type& __x)
+  { return insert(__x).first; }
+
+  iterator insert(const_iterator, value_type&& __x)
+  { return insert(tinySTL::move(__x)).first; }
+
+  template <InputIterator _Iterator>
+  void insert(_Iterator __first, _Iterator __last)
+  {
+    for (; __first != __last; ++__first)
+      insert(*__first);
+  }
+
+  void insert(std::initializer_list<value_type> __l)
+  { insert(__l.begin(), __l.end()); }
+
+  template <class... _Args>
+  pair<iterator, bool> emplace(_Args&&... __args)
+  {
+    auto __r = _M_ht._M_emplace_unique(tinySTL::forward<_Args>(__args)...);
+    return pair<iterator, bool>(__r.first, __r.second);
+  }
+
+  template <class... _Args>
+  iterator emplace_hint(const_iterator, _Args&&... __args)
+  { return emplace(tinySTL::forward<_Args>(__args)...).first; }
+
+  size_type erase(const key_type& __k) { return _M_ht.erase(__k); }
+
+  iterator erase(const_iterator __position) { return _M_ht.erase(__position.base()); }
+
+  iterator erase(const_iterator __first, const_iterator __last)
+  {
+    auto __it = __first.base();
+    while (__it != __last.base())
+      __it = _M_ht.erase(__it);
+    return __it;
+  }
+
+  const_iterator find(const key_type& __k) const { return _M_ht.find(__k); }
+
+  bool contains(const key_type& __k) const { return find(__k) != end(); }
+
+  size_type count(const key_type& __k) const { return contains(__k) ? 1 : 0; }
+
+  pair<const_iterator, const_iterator> equal_range(const key_type& __k) const
+  {
+    const_iterator __i = find(__k), __j = __i;
+    if (__j != end())
+      ++__j;
+    return pair<const_iterator, const_iterator>(__i, __j);
+  }
+
+  friend bool operator==(const flat_hash_set& __x, const flat_hash_set& __y)
+  {
+    if (__x.size() != __y.size())
+      return false;
+    for (const value_type& __v : __x)
+      if (!__y.contains(__v))
+        return false;
+    return true;
+  }
+
+  friend bool operator!=(const flat_hash_set& __x, const flat_hash_set& __y)
+  { return !(__x == __y); }
+
+  friend std::ostream& operator<<(std::ostream& os, const flat_hash_set& s)
+  { return os << tinySTL::to_string(s); }
+};
+
+}
@@ -0,0 +1,881 @@
+// tinySTL: flat_map, flat_multimap.
+#pragma once
+
+#include <initializer_list>
+
+#include "vector.h"
+#include "algorithm.h"
+#include "tiny_flat.h"
+#include "tiny_pair.h"
+#include "tiny_errors.h"
+#include "tiny_concepts.h"
+#include "tiny_iterator.h"
+#include "tiny_function.h"
+
+namespace tinySTL
+{
+
+/**
+ * @brief  iterator over the parallel key and value vectors of a flat map.
+ *  It dereferences to a pair of references, operator-> hands out a
+ *  pointer to a temporary one.
+ */
+template <class _KeyIter, class _ValIter>
+class _Flat_map_iterator
+{
+  template <class, class> friend class _Flat_map_iterator;
+
+  typedef typename iterator_traits<_KeyIter>::value_type _Key;
+  typedef typename iterator_traits<_ValIter>::value_type _Val;
+
+ public:
+  typedef random_access_iterator_tag iterator_category;
+  typedef tinySTL::pair<_Key, _Val> value_type;
+  typedef ptrdiff_t difference_type;
+  typedef tinySTL::pair<const _Key&, typename iterator_traits<_ValIter>::reference> reference;
+
+  struct pointer
+  {
+    reference _M_ref;
+    reference* operator->() { return &_M_ref; }
+  };
+
+  typedef _Flat_map_iterator _Self;
+
+ protected:
+  _KeyIter _M_key;
+  _ValIter _M_val;
+
+ public:
+  _Flat_map_iterator() {}
+
+  _Flat_map_iterator(_KeyIter __k, _ValIter __v) : _M_key(__k), _M_val(__v) {}
+
+  // iterator to const_iterator.
+  template <class _ValIter2>
+  _Flat_map_iterator(const _Flat_map_iterator<_KeyIter, _ValIter2>& __x)
+  : _M_key(__x._M_key), _M_val(__x._M_val) {}
+
+  _KeyIter key_iterator() const { return _M_key; }
+
+  _ValIter value_iterator() const { return _M_val; }
+
+  reference operator*() const { return reference(*_M_key, *_M_val); }
+
+  pointer operator->() const { return pointer{**this}; }
+
+  reference operator[](difference_type __n) const { return *(*this + __n); }
+
+  _Self& operator++() { ++_M_key; ++_M_val; return *this; }
+
+  _Self& operator--() { --_M_key; --_M_val; return *this; }
+
+  _Self operator++(int) { _Self __tmp = *this; ++*this; return __tmp; }
+
+  _Self operator--(int) { _Self __tmp = *this; --*this; return __tmp; }
+
+  _Self& operator+=(difference_type __n) { _M_key += __n; _M_val += __n; return *this; }
+
+  _Self& operator-=(difference_type __n) { _M_key -= __n; _M_val -= __n; return *this; }
+
+  _Self operator+(difference_type __n) const { _Self __tmp = *this; return __tmp += __n; }
+
+  _Self operator-(difference_type __n) const { _Self __tmp = *this; return __tmp -= __n; }
+
+  friend _Self operator+(difference_type __n, const _Self& __x) { return __x + __n; }
+};
+
+// iterator and const_iterator compare and subtract with each other.
+template <class _KeyIter, class _ValIter1, class _ValIter2>
+inline ptrdiff_t operator-(const _Flat_map_iterator<_KeyIter, _ValIter1>& __x,
+                           const _Flat_map_iterator<_KeyIter, _ValIter2>& __y)
+{ return __x.key_iterator() - __y.key_iterator(); }
+
+template <class _KeyIter, class _ValIter1, class _ValIter2>
+inline bool operator==(const _Flat_map_iterator<_KeyIter, _ValIter1>& __x,
+                       const _Flat_map_iterator<_KeyIter, _ValIter2>& __y)
+{ return __x.key_iterator() == __y.key_iterator(); }
+
+template <class _KeyIter, class _ValIter1, class _ValIter2>
+inline bool operator!=(const _Flat_map_iterator<_KeyIter, _ValIter1>& __x,
+                       const _Flat_map_iterator<_KeyIter, _ValIter2>& __y)
+{ return !(__x == __y); }
+
+template <class _KeyIter, class _ValIter1, class _ValIter2>
+inline bool operator<(const _Flat_map_iterator<_KeyIter, _ValIter1>& __x,
+                      const _Flat_map_iterator<_KeyIter, _ValIter2>& __y)
+{ return __x.key_iterator() < __y.key_iterator(); }
+
+template <class _KeyIter, class _ValIter1, class _ValIter2>
+inline bool operator>(const _Flat_map_iterator<_KeyIter, _ValIter1>& __x,
+                      const _Flat_map_iterator<_KeyIter, _ValIter2>& __y)
+{ return __y < __x; }
+
+template <class _KeyIter, class _ValIter1, class _ValIter2>
+inline bool operator<=(const _Flat_map_iterator<_KeyIter, _ValIter1>& __x,
+                       const _Flat_map_iterator<_KeyIter, _ValIter2>& __y)
+{ return !(__y < __x); }
+
+template <class _KeyIter, class _ValIter1, class _ValIter2>
+inline bool operator>=(const _Flat_map_iterator<_KeyIter, _ValIter1>& __x,
+                       const _Flat_map_iterator<_KeyIter, _ValIter2>& __y)
+{ return !(__x < __y); }
+
+/**
+ * @brief  a map kept as two sorted parallel vectors, one of keys and one
+ *  of values. Lookups binary-search contiguous keys, iteration is a
+ *  linear scan, and no node is allocated per element.
+ * @attention  iterators dereference to pair<const key_type&, mapped_type&>,
+ *  not to a stored pair. Inserting or erasing a single element moves the
+ *  tail, O(n). Fill it with insert(first, last), which sorts the new
+ *  elements and merges them in one pass.
+ */
+template<class _Key, class _Val, class _Compare = less<_Key>,
+         class _KeyContainer = tinySTL::vector<_Key>,
+         class _MappedContainer = tinySTL::vector<_Val>>
+class flat_map {
+
+ public:
+  typedef _Key key_type;
+  typedef _Val mapped_type;
+  typedef tinySTL::pair<_Key, _Val> value_type;
+  typedef _Compare key_compare;
+  typedef _KeyContainer key_container_type;
+  typedef _MappedContainer mapped_container_type;
+  typedef tinySTL::pair<const _Key&, _Val&> reference;
+  typedef tinySTL::pair<const _Key&, const _Val&> const_reference;
+  typedef _Flat_map_iterator<typename _KeyContainer::const_iterator,
+                             typename _MappedContainer::iterator> iterator;
+  typedef _Flat_map_iterator<typename _KeyContainer::const_iterator,
+                             typename _MappedContainer::const_iterator> const_iterator;
+  typedef tinySTL::reverse_iterator<iterator> reverse_iterator;
+  typedef tinySTL::reverse_iterator<const_iterator> const_reverse_iterator;
+  typedef size_t size_type;
+  typedef ptrdiff_t difference_type;
+
+  class value_compare
+  {
+    friend class flat_map;
+   protected:
+    _Compare _M_comp;
+    value_compare(const _Compare& __c) : _M_comp(__c) {}
+   public:
+    template <class _Pair1, class _Pair2>
+    bool operator()(const _Pair1& __x, const _Pair2& __y) const
+    { return _M_comp(__x.first, __y.first); }
+  };
+
+  struct containers
+  {
+    key_container_type keys;
+    mapped_container_type values;
+  };
+
+ protected:
+  _KeyContainer _M_keys;
+  _MappedContainer _M_values;
+  _Compare _M_compare;
+
+ public:
+  flat_map() : _M_keys(), _M_values(), _M_compare() {}
+
+  explicit flat_map(const _Compare& __comp) : _M_keys(), _M_values(), _M_compare(__comp) {}
+
+  flat_map(key_container_type __keys, mapped_container_type __values,
+           const _Compare& __comp = _Compare())
+  : _M_keys(tinySTL::move(__keys)), _M_values(tinySTL::move(__values)), _M_compare(__comp)
+  { _M_sort_and_merge(0); }
+
+  flat_map(sorted_unique_t, key_container_type __keys, mapped_container_type __values,
+           const _Compare& __comp = _Compare())
+  : _M_keys(tinySTL::move(__keys)), _M_values(tinySTL::move(__values)), _M_compare(__comp) {}
+
+  template <InputIterator Iterator>
+  flat_map(Iterator __first, Iterator __last, const _Compare& __comp = _Compare())
+  : _M_keys(), _M_values(), _M_compare(__comp)
+  { insert(__first, __last); }
+
+  flat_map(std::initializer_list<value_type> __l, const _Compare& __comp = _Compare())
+  : _M_keys(), _M_values(), _M_compare(__comp)
+  { insert(__l); }
+
+  flat_map(const flat_map&) = default;
+
+  flat_map(flat_map&&) = default;
+
+  ~flat_map() {}
+
+  flat_map& operator=(const flat_map&) = default;
+
+  flat_map& operator=(flat_map&&) = default;
+
+  flat_map& operator=(std::initializer_list<value_type> __l)
+  {
+    clear();
+    insert(__l);
+    return *this;
+  }
+
+  key_compare key_comp() const { return _M_compare; }
+
+  value_compare value_comp() const { return value_compare(_M_compare); }
+
+  const key_container_type& keys() const { return _M_keys; }
+
+  const mapped_container_type& values() const { return _M_values; }
+
+ public:
+  iterator begin() { return iterator(_M_keys.cbegin(), _M_values.begin()); }
+
+  const_iterator begin() const { return const_iterator(_M_keys.cbegin(), _M_values.begin()); }
+
+  const_iterator cbegin() const { return begin(); }
+
+  iterator end() { return iterator(_M_keys.cend(), _M_values.end()); }
+
+  const_iterator end() const { return const_iterator(_M_keys.cend(), _M_values.end()); }
+
+  const_iterator cend() const { return end(); }
+
+  reverse_iterator rbegin() { return reverse_iterator(end()); }
+
+  const_reverse_iterator rbegin() const { return const_reverse_iterator(end()); }
+
+  const_reverse_iterator crbegin() const { return const_reverse_iterator(end()); }
+
+  reverse_iterator rend() { return reverse_iterator(begin()); }
+
+  const_reverse_iterator rend() const { return const_reverse_iterator(begin()); }
+
+  const_reverse_iterator crend() const { return const_reverse_iterator(begin()); }
+
+  bool empty() const { return _M_keys.empty(); }
+
+  size_type size() const { return _M_keys.size(); }
+
+  size_type max_size() const { return _M_keys.max_size(); }
+
+  _Val& operator[](const key_type& __k) { return try_emplace(__k).first->second; }
+
+  _Val& operator[](key_type&& __k) { return try_emplace(tinySTL::move(__k)).first->second; }
+
+  _Val& at(const key_type& __k)
+  {
+    size_type __i = _M_find(__k);
+    if (__i == size())
+      __tiny_throw_range_error("flat_map::at(): key not found");
+    return _M_values[__i];
+  }
+
+  const _Val& at(const key_type& __k) const
+  {
+    size_type __i = _M_find(__k);
+    if (__i == size())
+      __tiny_throw_range_error("flat_map::at() const: key not found");
+    return _M_values[__i];
+  }
+
+  void swap(flat_map& __x) { tinySTL::swap(*this, __x); }
+
+  /**
+   * @brief  insert __k with a value built from __args, unless __k is
+   *  present. No value is built then.
+   */
+  template <class... _Args> tinySTL::pair<iterator, bool>
+  try_emplace(const key_type& __k, _Args&&... __args)
+  { return _M_try_emplace(_M_lower_index(__k), __k, tinySTL::forward<_Args>(__args)...); }
+
+  template <class... _Args> tinySTL::pair<iterator, bool>
+  try_emplace(key_type&& __k, _Args&&... __args)
+  { return _M_try_emplace(_M_lower_index(__k), tinySTL::move(__k), tinySTL::forward<_Args>(__args)...); }
+
+  template <class _Obj> tinySTL::pair<iterator, bool>
+  insert_or_assign(const key_type& __k, _Obj&& __obj)
+  {
+    tinySTL::pair<iterator, bool> __r = try_emplace(__k, tinySTL::forward<_Obj>(__obj));
+    if (!__r.second)
+      __r.first->second = tinySTL::forward<_Obj>(__obj);
+    return __r;
+  }
+
+  template<typename... _Args> tinySTL::pair<iterator, bool>
+  emplace(_Args&&... __args)
+  {
+    value_type __v(tinySTL::forward<_Args>(__args)...);
+    return try_emplace(tinySTL::move(__v.first), tinySTL::move(__v.second));
+  }
+
+  template<typename... _Args> iterator
+  emplace_hint(const_iterator, _Args&&... __args)
+  { return emplace(tinySTL::forward<_Args>(__args)...).first; }
+
+  tinySTL::pair<iterator, bool>
+  insert(const value_type& __x) { return try_emplace(__x.first, __x.second); }
+
+  tinySTL::pair<iterator, bool>
+  insert(value_type&& __x) { return try_emplace(tinySTL::move(__x.first), tinySTL::move(__x.second)); }
+
+  iterator insert(const_iterator, const value_type& __x) { return insert(__x).first; }
+
+  iterator insert(const_iterator, value_type&& __x) { return insert(tinySTL::move(__x)).first; }
+
+  /**
+   * @brief  append [first, last), sort the new elements and merge them
+   *  with the old ones in one pass, O(n + m log m). A key already present
+   *  keeps its value.
+   */
+  template <InputIterator _InputIterator>
+  void insert(_InputIterator __first, _InputIterator __last)
+  {
+    size_type __n = size();
+    _M_append(__first, __last);
+    _M_sort_and_merge(__n);
+  }
+
+  template <InputIterator _InputIterator>
+  void insert(sorted_unique_t, _InputIterator __first, _InputIterator __last)
+  {
+    size_type __n = size();
+    _M_append(__first, __last);
+    _M_merge_tail(__n);
+  }
+
+  void insert(std::initializer_list<value_type> __l)
+  { insert(__l.begin(), __l.end()); }
+
+  /**
+   * @brief  move both vectors out, the map is left empty.
+   */
+  containers extract() &&
+  {
+    containers __c{tinySTL::move(_M_keys), tinySTL::move(_M_values)};
+    clear();
+    return __c;
+  }
+
+  /**
+   * @brief  take the parallel vectors as the contents, the keys must be
+   *  sorted and unique.
+   */
+  void replace(key_container_type&& __keys, mapped_container_type&& __values)
+  {
+    _M_keys = tinySTL::move(__keys);
+    _M_values = tinySTL::move(__values);
+  }
+
+  size_type erase(const key_type& __k)
+  {
+    size_type __i = _M_find(__k);
+    if (__i == size())
+      return 0;
+    erase(begin() + __i);
+    return 1;
+  }
+
+  iterator erase(const_iterator __position)
+  { return erase(__position, __position + 1); }
+
+  iterator erase(const_iterator __first, const_iterator __last)
+  {
+    size_type __i = __first - cbegin(), __j = __last - cbegin();
+    _M_keys.erase(_M_keys.begin() + __i, _M_keys.begin() + __j);
+    _M_values.erase(_M_values.begin() + __i, _M_values.begin() + __j);
+    return begin() + __i;
+  }
+
+  void clear()
+  {
+    _M_keys.clear();
+    _M_values.clear();
+  }
+
+  size_type count(const key_type& __x) const { return _M_find(__x) != size(); }
+
+  bool contains(const key_type& __x) const { return _M_find(__x) != size(); }
+
+  iterator find(const key_type& __x) { return begin() + _M_find(__x); }
+
+  const_iterator find(const key_type& __x) const { return begin() + _M_find(__x); }
+
+  iterator lower_bound(const key_type& __x) { return begin() + _M_lower_index(__x); }
+
+  const_iterator lower_bound(const key_type& __x) const { return begin() + _M_lower_index(__x); }
+
+  iterator upper_bound(const key_type& __x) { return begin() + _M_upper_index(__x); }
+
+  const_iterator upper_bound(const key_type& __x) const { return begin() + _M_upper_index(__x); }
+
+  tinySTL::pair<iterator, iterator>
+  equal_range(const key_type& __x)
+  {
+    size_type __i = _M_find(__x);
+    if (__i == size())
+      return {lower_bound(__x), lower_bound(__x)};
+    return {begin() + __i, begin() + __i + 1};
+  }
+
+  tinySTL::pair<const_iterator, const_iterator>
+  equal_range(const key_type& __x) const
+  {
+    size_type __i = _M_find(__x);
+    if (__i == size())
+      return {lower_bound(__x), lower_bound(__x)};
+    return {begin() + __i, begin() + __i + 1};
+  }
+
+  friend bool operator==(const flat_map& __x, const flat_map& __y)
+  {
+    return __x._M_keys.size() == __y._M_keys.size()
+      && tinySTL::equal(__x._M_keys.begin(), __x._M_keys.end(), __y._M_keys.begin())
+      && tinySTL::equal(__x._M_values.begin(), __x._M_values.end(), __y._M_values.begin());
+  }
+
+  friend bool operator<(const flat_map& __x, const flat_map& __y)
+  {
+    return lexicographical_compare(
+      __x.begin(), __x.end(),
+      __y.begin(), __y.end(),
+      [comp = __x.value_comp()](const const_reference& __a, const const_reference& __b) {
+        return comp(__a, __b) || (!comp(__b, __a) && __a.second < __b.second);
+      }
+    );
+  }
+
+  friend std::ostream& operator<<(std::ostream& os, const flat_map& m)
+  { return os << tinySTL::to_string(m); }
+
+ protected:
+  size_type _M_lower_index(const key_type& __k) const
+  { return tinySTL::lower_bound(_M_keys.begin(), _M_keys.end(), __k, _M_compare) - _M_keys.begin(); }
+
+  size_type _M_upper_index(const key_type& __k) const
+  { return tinySTL::upper_bound(_M_keys.begin(), _M_keys.end(), __k, _M_compare) - _M_keys.begin(); }
+
+  // index of __k, size() when absent.
+  size_type _M_find(const key_type& __k) const
+  {
+    size_type __i = _M_lower_index(__k);
+    return __i == size() || _M_compare(__k, _M_keys[__i]) ? size() : __i;
+  }
+
+  template <class _KeyArg, class... _Args> tinySTL::pair<iterator, bool>
+  _M_try_emplace(size_type __i, _KeyArg&& __k, _Args&&... __args)
+  {
+    if (__i != size() && !_M_compare(__k, _M_keys[__i]))
+      return {begin() + __i, false};
+    _M_keys.insert(_M_keys.begin() + __i, tinySTL::forward<_KeyArg>(__k));
+    try {
+      _M_values.emplace(_M_values.begin() + __i, tinySTL::forward<_Args>(__args)...);
+    } catch (...) {
+      _M_keys.erase(_M_keys.begin() + __i);
+      throw;
+    }
+    return {begin() + __i, true};
+  }
+
+  template <class _InputIterator>
+  void _M_append(_InputIterator __first, _InputIterator __last)
+  {
+    for (; __first != __last; ++__first) {
+      auto&& __x = *__first;
+      _M_keys.push_back(__x.first);
+      _M_values.push_back(__x.second);
+    }
+  }
+
+  // [0, __n) is sorted and unique, [__n, size()) was just appended.
+  void _M_sort_and_merge(size_type __n)
+  {
+    if (__flat_tail_in_order(_M_keys, __n, _M_compare, true))
+      return;
+    // sort the new elements through their indices, so that keys and
+    // values move once; the first of equal keys wins.
+    size_type __e = size();
+    tinySTL::vector<size_type> __idx;
+    __idx.reserve(__e - __n);
+    for (size_type __i = __n; __i < __e; ++__i)
+      __idx.push_back(__i);
+    tinySTL::sort(__idx.begin(), __idx.end(), [this](size_type __a, size_type __b) {
+      return _M_compare(_M_keys[__a], _M_keys[__b])
+          || (!_M_compare(_M_keys[__b], _M_keys[__a]) && __a < __b);
+    });
+    _M_merge(__n, __idx);
+  }
+
+  void _M_merge_tail(size_type __n)
+  {
+    if (__flat_tail_in_order(_M_keys, __n, _M_compare, true))
+      return;
+    tinySTL::vector<size_type> __idx;
+    __idx.reserve(size() - __n);
+    for (size_type __i = __n; __i < size(); ++__i)
+      __idx.push_back(__i);
+    _M_merge(__n, __idx);
+  }
+
+  // merge [0, __n) with the new elements in the order of __idx, dropping
+  // all but the first of equal keys.
+  void _M_merge(size_type __n, const tinySTL::vector<size_type>& __idx)
+  {
+    _KeyContainer __keys;
+    _MappedContainer __values;
+    __keys.reserve(size());
+    __values.reserve(size());
+    size_type __i = 0, __j = 0, __m = __idx.size();
+    while (__i < __n || __j < __m) {
+      size_type __x = __j == __m || (__i < __n && !_M_compare(_M_keys[__idx[__j]], _M_keys[__i]))
+                    ? __i++ : __idx[__j++];
+      if (!__keys.empty() && !_M_compare(__keys[__keys.size() - 1], _M_keys[__x]))
+        continue;
+      __keys.push_back(tinySTL::move(_M_keys[__x]));
+      __values.push_back(tinySTL::move(_M_values[__x]));
+    }
+    _M_keys = tinySTL::move(__keys);
+    _M_values = tinySTL::move(__values);
+  }
+};
+
+/**
+ * @brief  a multimap kept as two sorted parallel vectors, see flat_map.
+ *  Equal keys keep their insertion order, also through insert(first, last).
+ */
+template<class _Key, class _Val, class _Compare = less<_Key>,
+         class _KeyContainer = tinySTL::vector<_Key>,
+         class _MappedContainer = tinySTL::vector<_Val>>
+class flat_multimap {
+
+ public:
+  typedef _Key key_type;
+  typedef _Val mapped_type;
+  typedef tinySTL::pair<_Key, _Val> value_type;
+  typedef _Compare key_compare;
+  typedef _KeyContainer key_container_type;
+  typedef _MappedContainer mapped_container_type;
+  typedef tinySTL::pair<const _Key&, _Val&> reference;
+  typedef tinySTL::pair<const _Key&, const _Val&> const_reference;
+  typedef _Flat_map_iterator<typename _KeyContainer::const_iterator,
+                             typename _MappedContainer::iterator> iterator;
+  typedef _Flat_map_iterator<typename _KeyContainer::const_iterator,
+                             typename _MappedContainer::const_iterator> const_iterator;
+  typedef tinySTL::reverse_iterator<iterator> reverse_iterator;
+  typedef tinySTL::reverse_iterator<const_iterator> const_reverse_iterator;
+  typedef size_t size_type;
+  typedef ptrdiff_t difference_type;
+
+  class value_compare
+  {
+    friend class flat_multimap;
+   protected:
+    _Compare _M_comp;
+    value_compare(const _Compare& __c) : _M_comp(__c) {}
+   public:
+    template <class _Pair1, class _Pair2>
+    bool operator()(const _Pair1& __x, const _Pair2& __y) const
+    { return _M_comp(__x.first, __y.first); }
+  };
+
+  struct containers
+  {
+    key_container_type keys;
+    mapped_container_type values;
+  };
+
+ protected:
+  _KeyContainer _M_keys;
+  _MappedContainer _M_values;
+  _Compare _M_compare;
+
+ public:
+  flat_multimap() : _M_keys(), _M_values(), _M_compare() {}
+
+  explicit flat_multimap(const _Compare& __comp) : _M_keys(), _M_values(), _M_compare(__comp) {}
+
+  flat_multimap(key_container_type __keys, mapped_container_type __values,
+                const _Compare& __comp = _Compare())
+  : _M_keys(tinySTL::move(__keys)), _M_values(tinySTL::move(__values)), _M_compare(__comp)
+  { _M_sort_and_merge(0); }
+
+  flat_multimap(sorted_equivalent_t, key_container_type __keys, mapped_container_type __values,
+                const _Compare& __comp = _Compare())
+  : _M_keys(tinySTL::move(__keys)), _M_values(tinySTL::move(__values)), _M_compare(__comp) {}
+
+  template <InputIterator Iterator>
+  flat_multimap(Iterator __first, Iterator __last, const _Compare& __comp = _Compare())
+  : _M_keys(), _M_values(), _M_compare(__comp)
+  { insert(__first, __last); }
+
+  flat_multimap(std::initializer_list<value_type> __l, const _Compare& __comp = _Compare())
+  : _M_keys(), _M_values(), _M_compare(__comp)
+  { insert(__l); }
+
+  flat_multimap(const flat_multimap&) = default;
+
+  flat_multimap(flat_multimap&&) = default;
+
+  ~flat_multimap() {}
+
+  flat_multimap& operator=(const flat_multimap&) = default;
+
+  flat_multimap& operator=(flat_multimap&&) = default;
+
+  flat_multimap& operator=(std::initializer_list<value_type> __l)
+  {
+    clear();
+    insert(__l);
+    return *this;
+  }
+
+  key_compare key_comp() const { return _M_compare; }
+
+  value_compare value_comp() const { return value_compare(_M_compare); }
+
+  const key_container_type& keys() const { return _M_keys; }
+
+  const mapped_container_type& values() const { return _M_values; }
+
+ public:
+  iterator begin() { return iterator(_M_keys.cbegin(), _M_values.begin()); }
+
+  const_iterator begin() const { return const_iterator(_M_keys.cbegin(), _M_values.begin()); }
+
+  const_iterator cbegin() const { return begin(); }
+
+  iterator end() { return iterator(_M_keys.cend(), _M_values.end()); }
+
+  const_iterator end() const { return const_iterator(_M_keys.cend(), _M_values.end()); }
+
+  const_iterator cend() const { return end(); }
+
+  reverse_iterator rbegin() { return reverse_iterator(end()); }
+
+  const_reverse_iterator rbegin() const { return const_reverse_iterator(end()); }
+
+  const_reverse_iterator crbegin() const { return const_reverse_iterator(end()); }
+
+  reverse_iterator rend() { return reverse_iterator(begin()); }
+
+  const_reverse_iterator rend() const { return const_reverse_iterator(begin()); }
+
+  const_reverse_iterator crend() const { return const_reverse_iterator(begin()); }
+
+  bool empty() const { return _M_keys.empty(); }
+
+  size_type size() const { return _M_keys.size(); }
+
+  size_type max_size() const { return _M_keys.max_size(); }
+
+  void swap(flat_multimap& __x) { tinySTL::swap(*this, __x); }
+
+  template<typename... _Args> iterator
+  emplace(_Args&&... __args)
+  {
+    value_type __v(tinySTL::forward<_Args>(__args)...);
+    return _M_insert_at(_M_upper_index(__v.first), tinySTL::move(__v.first), tinySTL::move(__v.second));
+  }
+
+  template<typename... _Args> iterator
+  emplace_hint(const_iterator, _Args&&... __args)
+  { return emplace(tinySTL::forward<_Args>(__args)...); }
+
+  iterator insert(const value_type& __x)
+  { return _M_insert_at(_M_upper_index(__x.first), __x.first, __x.second); }
+
+  iterator insert(value_type&& __x)
+  { return _M_insert_at(_M_upper_index(__x.first), tinySTL::move(__x.first), tinySTL::move(__x.second)); }
+
+  iterator insert(const_iterator, const value_type& __x) { return insert(__x); }
+
+  iterator insert(const_iterator, value_type&& __x) { return insert(tinySTL::move(__x)); }
+
+  /**
+   * @brief  append [first, last), sort the new elements and merge them
+   *  with the old ones in one pass, O(n + m log m).
+   */
+  template <InputIterator _InputIterator>
+  void insert(_InputIterator __first, _InputIterator __last)
+  {
+    size_type __n = size();
+    _M_append(__first, __last);
+    _M_sort_and_merge(__n);
+  }
+
+  template <InputIterator _InputIterator>
+  void insert(sorted_equivalent_t, _InputIterator __first, _InputIterator __last)
+  {
+    size_type __n = size();
+    _M_append(__first, __last);
+    _M_merge_tail(__n);
+  }
+
+  void insert(std::initializer_list<value_type> __l)
+  { insert(__l.begin(), __l.end()); }
+
+  containers extract() &&
+  {
+    containers __c{tinySTL::move(_M_keys), tinySTL::move(_M_values)};
+    clear();
+    return __c;
+  }
+
+  void replace(key_container_type&& __keys, mapped_container_type&& __values)
+  {
+    _M_keys = tinySTL::move(__keys);
+    _M_values = tinySTL::move(__values);
+  }
+
+  size_type erase(const key_type& __k)
+  {
+    size_type __i = _M_lower_index(__k), __j = _M_upper_index(__k);
+    erase(begin() + __i, begin() + __j);
+    return __j - __i;
+  }
+
+  iterator erase(const_iterator __position)
+  { return erase(__position, __position + 1); }
+
+  iterator erase(const_iterator __first, const_iterator __last)
+  {
+    size_type __i = __first - cbegin(), __j = __last - cbegin();
+    _M_keys.erase(_M_keys.begin() + __i, _M_keys.begin() + __j);
+    _M_values.erase(_M_values.begin() + __i, _M_values.begin() + __j);
+    return begin() + __i;
+  }
+
+  void clear()
+  {
+    _M_keys.clear();
+    _M_values.clear();
+  }
+
+  size_type count(const key_type& __x) const { return _M_upper_index(__x) - _M_lower_index(__x); }
+
+  bool contains(const key_type& __x) const { return find(__x) != end(); }
+
+  iterator find(const key_type& __x)
+  {
+    size_type __i = _M_lower_index(__x);
+    return __i == size() || _M_compare(__x, _M_keys[__i]) ? end() : begin() + __i;
+  }
+
+  const_iterator find(const key_type& __x) const
+  {
+    size_type __i = _M_lower_index(__x);
+    return __i == size() || _M_compare(__x, _M_keys[__i]) ? end() : begin() + __i;
+  }
+
+  iterator lower_bound(const key_type& __x) { return begin() + _M_lower_index(__x); }
+
+  const_iterator lower_bound(const key_type& __x) const { return begin() + _M_lower_index(__x); }
+
+  iterator upper_bound(const key_type& __x) { return begin() + _M_upper_index(__x); }
+
+  const_iterator upper_bound(const key_type& __x) const { return begin() + _M_upper_index(__x); }
+
+  tinySTL::pair<iterator, iterator>
+  equal_range(const key_type& __x)
+  { return {lower_bound(__x), upper_bound(__x)}; }
+
+  tinySTL::pair<const_iterator, const_iterator>
+  equal_range(const key_type& __x) const
+  { return {lower_bound(__x), upper_bound(__x)}; }
+
+  friend bool operator==(const flat_multimap& __x, const flat_multimap& __y)
+  {
+    return __x._M_keys.size() == __y._M_keys.size()
+      && tinySTL::equal(__x._M_keys.begin(), __x._M_keys.end(), __y._M_keys.begin())
+      && tinySTL::equal(__x._M_values.begin(), __x._M_values.end(), __y._M_values.begin());
+  }
+
+  friend bool operator<(const flat_multimap& __x, const flat_multimap& __y)
+  {
+    return lexicographical_compare(
+      __x.begin(), __x.end(),
+      __y.begin(), __y.end(),
+      [comp = __x.value_comp()](const const_reference& __a, const const_reference& __b) {
+        return comp(__a, __b) || (!comp(__b, __a) && __a.second < __b.second);
+      }
+    );
+  }
+
+  friend std::ostream& operator<<(std::ostream& os, const flat_multimap& m)
+  { return os << tinySTL::to_string(m); }
+
+ protected:
+  size_type _M_lower_index(const key_type& __k) const
+  { return tinySTL::lower_bound(_M_keys.begin(), _M_keys.end(), __k, _M_compare) - _M_keys.begin(); }
+
+  size_type _M_upper_index(const key_type& __k) const
+  { return tinySTL::upper_bound(_M_keys.begin(), _M_keys.end(), __k, _M_compare) - _M_keys.begin(); }
+
+  template <class _KeyArg, class _ValArg>
+  iterator _M_insert_at(size_type __i, _KeyArg&& __k, _ValArg&& __v)
+  {
+    _M_keys.insert(_M_keys.begin() + __i, tinySTL::forward<_KeyArg>(__k));
+    try {
+      _M_values.insert(_M_values.begin() + __i, tinySTL::forward<_ValArg>(__v));
+    } catch (...) {
+      _M_keys.erase(_M_keys.begin() + __i);
+      throw;
+    }
+    return begin() + __i;
+  }
+
+  template <class _InputIterator>
+  void _M_append(_InputIterator __first, _InputIterator __last)
+  {
+    for (; __first != __last; ++__first) {
+      auto&& __x = *__first;
+      _M_keys.push_back(__x.first);
+      _M_values.push_back(__x.second);
+    }
+  }
+
+  // [0, __n) is sorted, [__n, size()) was just appended.
+  void _M_sort_and_merge(size_type __n)
+  {
+    if (__flat_tail_in_order(_M_keys, __n, _M_compare, false))
+      return;
+    size_type __e = size();
+    tinySTL::vector<size_type> __idx;
+    __idx.reserve(__e - __n);
+    for (size_type __i = __n; __i < __e; ++__i)
+      __idx.push_back(__i);
+    tinySTL::sort(__idx.begin(), __idx.end(), [this](size_type __a, size_type __b) {
+      return _M_compare(_M_keys[__a], _M_keys[__b])
+          || (!_M_compare(_M_keys[__b], _M_keys[__a]) && __a < __b);
+    });
+    _M_merge(__n, __idx);
+  }
+
+  void _M_merge_tail(size_type __n)
+  {
+    if (__flat_tail_in_order(_M_keys, __n, _M_compare, false))
+      return;
+    tinySTL::vector<size_type> __idx;
+    __idx.reserve(size() - __n);
+    for (size_type __i = __n; __i < size(); ++__i)
+      __idx.push_back(__i);
+    _M_merge(__n, __idx);
+  }
+
+  // merge [0, __n) with the new elements in the order of __idx, old
+  // elements go first among equal keys.
+  void _M_merge(size_type __n, const tinySTL::vector<size_type>& __idx)
+  {
+    _KeyContainer __keys;
+    _MappedContainer __values;
+    __keys.reserve(size());
+    __values.reserve(size());
+    size_type __i = 0, __j = 0, __m = __idx.size();
+    while (__i < __n || __j < __m) {
+      size_type __x = __j == __m || (__i < __n && !_M_compare(_M_keys[__idx[__j]], _M_keys[__i]))
+                    ? __i++ : __idx[__j++];
+      __keys.push_back(tinySTL::move(_M_keys[__x]));
+      __values.push_back(tinySTL::move(_M_values[__x]));
+    }
+    _M_keys = tinySTL::move(__keys);
+    _M_values = tinySTL::move(__values);
+  }
+};
+
+}
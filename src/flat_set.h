@@ -0,0 +1,560 @@
+// tinySTL: flat_set, flat_multiset.
+#pragma once
+
+#include <initializer_list>
+
+#include "vector.h"
+#include "algorithm.h"
+#include "tiny_flat.h"
+#include "tiny_pair.h"
+#include "tiny_concepts.h"
+#include "tiny_iterator.h"
+#include "tiny_function.h"
+
+namespace tinySTL
+{
+
+/**
+ * @brief  a set kept as a sorted vector. There is no node per value,
+ *  lookups binary-search contiguous keys and iteration is a linear scan.
+ * @attention  inserting or erasing a single value moves the tail, O(n).
+ *  Fill it with insert(first, last), which sorts the new values and
+ *  merges them in one pass.
+ */
+template<class _Key, class _Compare = less<_Key>, class _Container = tinySTL::vector<_Key>>
+class flat_set {
+
+ public:
+  typedef _Key       key_type;
+  typedef _Key       value_type;
+  typedef _Compare   key_compare;
+  typedef _Compare   value_compare;
+  typedef _Container container_type;
+  typedef const value_type& reference;
+  typedef const value_type& const_reference;
+  typedef typename _Container::const_iterator iterator;
+  typedef typename _Container::const_iterator const_iterator;
+  typedef tinySTL::reverse_iterator<const_iterator> reverse_iterator;
+  typedef tinySTL::reverse_iterator<const_iterator> const_reverse_iterator;
+  typedef typename _Container::size_type size_type;
+  typedef typename _Container::difference_type difference_type;
+
+ protected:
+  _Container _M_c;
+  _Compare _M_compare;
+
+ public:
+  flat_set() : _M_c(), _M_compare() {}
+
+  explicit flat_set(const _Compare& __comp) : _M_c(), _M_compare(__comp) {}
+
+  explicit flat_set(container_type __c, const _Compare& __comp = _Compare())
+  : _M_c(tinySTL::move(__c)), _M_compare(__comp)
+  { _M_sort_and_merge(0); }
+
+  flat_set(sorted_unique_t, container_type __c, const _Compare& __comp = _Compare())
+  : _M_c(tinySTL::move(__c)), _M_compare(__comp) {}
+
+  template <InputIterator Iterator>
+  flat_set(Iterator __first, Iterator __last, const _Compare& __comp = _Compare())
+  : _M_c(), _M_compare(__comp)
+  { insert(__first, __last); }
+
+  flat_set(std::initializer_list<value_type> __l, const _Compare& __comp = _Compare())
+  : _M_c(), _M_compare(__comp)
+  { insert(__l); }
+
+  flat_set(const flat_set&) = default;
+
+  flat_set(flat_set&&) = default;
+
+  ~flat_set() {}
+
+  flat_set& operator=(const flat_set&) = default;
+
+  flat_set& operator=(flat_set&&) = default;
+
+  flat_set& operator=(std::initializer_list<value_type> __l)
+  {
+    clear();
+    insert(__l);
+    return *this;
+  }
+
+  key_compare key_comp() const { return _M_compare; }
+
+  value_compare value_comp() const { return _M_compare; }
+
+ public:
+  iterator begin() const { return _M_c.begin(); }
+
+  iterator cbegin() const { return _M_c.begin(); }
+
+  iterator end() const { return _M_c.end(); }
+
+  iterator cend() const { return _M_c.end(); }
+
+  reverse_iterator rbegin() const { return reverse_iterator(end()); }
+
+  reverse_iterator crbegin() const { return reverse_iterator(end()); }
+
+  reverse_iterator rend() const { return reverse_iterator(begin()); }
+
+  reverse_iterator crend() const { return reverse_iterator(begin()); }
+
+  bool empty() const { return _M_c.empty(); }
+
+  size_type size() const { return _M_c.size(); }
+
+  size_type max_size() const { return _M_c.max_size(); }
+
+  void swap(flat_set& __x) { tinySTL::swap(*this, __x); }
+
+  template<typename... _Args> tinySTL::pair<iterator, bool>
+  emplace(_Args&&... __args) { return _M_insert_unique(value_type(tinySTL::forward<_Args>(__args)...)); }
+
+  template<typename... _Args> iterator
+  emplace_hint(const_iterator __hint, _Args&&... __args)
+  { return _M_insert_unique(__hint, value_type(tinySTL::forward<_Args>(__args)...)); }
+
+  tinySTL::pair<iterator, bool>
+  insert(const value_type& __x) { return _M_insert_unique(__x); }
+
+  tinySTL::pair<iterator, bool>
+  insert(value_type&& __x) { return _M_insert_unique(tinySTL::move(__x)); }
+
+  iterator insert(const_iterator __hint, const value_type& __x)
+  { return _M_insert_unique(__hint, __x); }
+
+  iterator insert(const_iterator __hint, value_type&& __x)
+  { return _M_insert_unique(__hint, tinySTL::move(__x)); }
+
+  /**
+   * @brief  append [first, last), sort the new values and merge them with
+   *  the old ones in one pass, O(n + m log m). A key already present is
+   *  not inserted again.
+   */
+  template <InputIterator _InputIterator>
+  void insert(_InputIterator __first, _InputIterator __last)
+  {
+    size_type __n = size();
+    for (; __first != __last; ++__first)
+      _M_c.push_back(*__first);
+    _M_sort_and_merge(__n);
+  }
+
+  /**
+   * @brief  insert the sorted values [first, last), only the merge is left.
+   */
+  template <InputIterator _InputIterator>
+  void insert(sorted_unique_t, _InputIterator __first, _InputIterator __last)
+  {
+    size_type __n = size();
+    for (; __first != __last; ++__first)
+      _M_c.push_back(*__first);
+    _M_merge_tail(__n);
+  }
+
+  void insert(std::initializer_list<value_type> __l)
+  { insert(__l.begin(), __l.end()); }
+
+  /**
+   * @brief  move the sorted vector out, the set is left empty.
+   */
+  container_type extract() &&
+  {
+    container_type __c = tinySTL::move(_M_c);
+    _M_c.clear();
+    return __c;
+  }
+
+  /**
+   * @brief  take __c as the contents, it must be sorted and unique.
+   */
+  void replace(container_type&& __c) { _M_c = tinySTL::move(__c); }
+
+  size_type erase(const key_type& __k)
+  {
+    tinySTL::pair<iterator, iterator> __p = equal_range(__k);
+    size_type __n = __p.second - __p.first;
+    erase(__p.first, __p.second);
+    return __n;
+  }
+
+  iterator erase(const_iterator __position)
+  { return _M_c.erase(__position); }
+
+  iterator erase(const_iterator __first, const_iterator __last)
+  { return _M_c.erase(__first, __last); }
+
+  void clear() { _M_c.clear(); }
+
+  size_type count(const key_type& __x) const { return contains(__x) ? 1 : 0; }
+
+  bool contains(const key_type& __x) const { return find(__x) != end(); }
+
+  iterator find(const key_type& __x) const
+  {
+    iterator __i = lower_bound(__x);
+    return __i == end() || _M_compare(__x, *__i) ? end() : __i;
+  }
+
+  iterator lower_bound(const key_type& __x) const
+  { return tinySTL::lower_bound(begin(), end(), __x, _M_compare); }
+
+  iterator upper_bound(const key_type& __x) const
+  { return tinySTL::upper_bound(begin(), end(), __x, _M_compare); }
+
+  tinySTL::pair<iterator, iterator>
+  equal_range(const key_type& __x) const
+  {
+    iterator __i = lower_bound(__x);
+    if (__i == end() || _M_compare(__x, *__i))
+      return {__i, __i};
+    return {__i, __i + 1};
+  }
+
+  friend bool operator==(const flat_set& __x, const flat_set& __y)
+  {
+    return __x.size() == __y.size()
+      && tinySTL::equal(__x.begin(), __x.end(), __y.begin());
+  }
+
+  friend bool operator<(const flat_set& __x, const flat_set& __y)
+  {
+    return lexicographical_compare(
+      __x.begin(), __x.end(),
+      __y.begin(), __y.end(),
+      __x.key_comp()
+    );
+  }
+
+  friend std::ostream& operator<<(std::ostream& os, const flat_set& s)
+  { return os << tinySTL::to_string(s._M_c); }
+
+ protected:
+  template <class _Arg>
+  tinySTL::pair<iterator, bool> _M_insert_unique(_Arg&& __x)
+  {
+    iterator __i = lower_bound(__x);
+    if (__i != end() && !_M_compare(__x, *__i))
+      return {__i, false};
+    return {_M_c.insert(__i, tinySTL::forward<_Arg>(__x)), true};
+  }
+
+  // a hint right before the place of __x saves the binary search.
+  template <class _Arg>
+  iterator _M_insert_unique(const_iterator __hint, _Arg&& __x)
+  {
+    if ((__hint == begin() || _M_compare(*(__hint - 1), __x))
+     && (__hint == end() || _M_compare(__x, *__hint)))
+      return _M_c.insert(__hint, tinySTL::forward<_Arg>(__x));
+    return _M_insert_unique(tinySTL::forward<_Arg>(__x)).first;
+  }
+
+  // [0, __n) is sorted and unique, [__n, size()) was just appended.
+  void _M_sort_and_merge(size_type __n)
+  {
+    if (__flat_tail_in_order(_M_c, __n, _M_compare, true))
+      return;
+    tinySTL::sort(_M_c.begin() + __n, _M_c.end(), _M_compare);
+    _M_merge_tail(__n);
+  }
+
+  // merge the sorted runs [0, __n) and [__n, size()), keeping the first
+  // of equal values.
+  void _M_merge_tail(size_type __n)
+  {
+    size_type __e = size();
+    if (__n == __e)
+      return;
+    if (__n == 0 || _M_compare(_M_c[__n - 1], _M_c[__n])) {
+      // the new values all follow the old ones, drop equal neighbours.
+      size_type __w = __n == 0 ? 1 : __n;
+      for (size_type __r = __w; __r < __e; ++__r) {
+        if (_M_compare(_M_c[__w - 1], _M_c[__r])) {
+          if (__w != __r)
+            _M_c[__w] = tinySTL::move(_M_c[__r]);
+          ++__w;
+        }
+      }
+      _M_c.erase(_M_c.begin() + __w, _M_c.end());
+      return;
+    }
+    _Container __out;
+    __out.reserve(__e);
+    size_type __i = 0, __j = __n;
+    while (__i < __n || __j < __e) {
+      value_type& __x = __j == __e || (__i < __n && !_M_compare(_M_c[__j], _M_c[__i]))
+                      ? _M_c[__i++] : _M_c[__j++];
+      if (__out.empty() || _M_compare(__out[__out.size() - 1], __x))
+        __out.push_back(tinySTL::move(__x));
+    }
+    _M_c = tinySTL::move(__out);
+  }
+};
+
+/**
+ * @brief  a multiset kept as a sorted vector, see flat_set. Equal values
+ *  keep their insertion order, also through insert(first, last).
+ */
+template<class _Key, class _Compare = less<_Key>, class _Container = tinySTL::vector<_Key>>
+class flat_multiset {
+
+ public:
+  typedef _Key       key_type;
+  typedef _Key       value_type;
+  typedef _Compare   key_compare;
+  typedef _Compare   value_compare;
+  typedef _Container container_type;
+  typedef const value_type& reference;
+  typedef const value_type& const_reference;
+  typedef typename _Container::const_iterator iterator;
+  typedef typename _Container::const_iterator const_iterator;
+  typedef tinySTL::reverse_iterator<const_iterator> reverse_iterator;
+  typedef tinySTL::reverse_iterator<const_iterator> const_reverse_iterator;
+  typedef typename _Container::size_type size_type;
+  typedef typename _Container::difference_type difference_type;
+
+ protected:
+  _Container _M_c;
+  _Compare _M_compare;
+
+ public:
+  flat_multiset() : _M_c(), _M_compare() {}
+
+  explicit flat_multiset(const _Compare& __comp) : _M_c(), _M_compare(__comp) {}
+
+  explicit flat_multiset(container_type __c, const _Compare& __comp = _Compare())
+  : _M_c(tinySTL::move(__c)), _M_compare(__comp)
+  { _M_sort_and_merge(0); }
+
+  flat_multiset(sorted_equivalent_t, container_type __c, const _Compare& __comp = _Compare())
+  : _M_c(tinySTL::move(__c)), _M_compare(__comp) {}
+
+  template <InputIterator Iterator>
+  flat_multiset(Iterator __first, Iterator __last, const _Compare& __comp = _Compare())
+  : _M_c(), _M_compare(__comp)
+  { insert(__first, __last); }
+
+  flat_multiset(std::initializer_list<value_type> __l, const _Compare& __comp = _Compare())
+  : _M_c(), _M_compare(__comp)
+  { insert(__l); }
+
+  flat_multiset(const flat_multiset&) = default;
+
+  flat_multiset(flat_multiset&&) = default;
+
+  ~flat_multiset() {}
+
+  flat_multiset& operator=(const flat_multiset&) = default;
+
+  flat_multiset& operator=(flat_multiset&&) = default;
+
+  flat_multiset& operator=(std::initializer_list<value_type> __l)
+  {
+    clear();
+    insert(__l);
+    return *this;
+  }
+
+  key_compare key_comp() const { return _M_compare; }
+
+  value_compare value_comp() const { return _M_compare; }
+
+ public:
+  iterator begin() const { return _M_c.begin(); }
+
+  iterator cbegin() const { return _M_c.begin(); }
+
+  iterator end() const { return _M_c.end(); }
+
+  iterator cend() const { return _M_c.end(); }
+
+  reverse_iterator rbegin() const { return reverse_iterator(end()); }
+
+  reverse_iterator crbegin() const { return reverse_iterator(end()); }
+
+  reverse_iterator rend() const { return reverse_iterator(begin()); }
+
+  reverse_iterator crend() const { return reverse_iterator(begin()); }
+
+  bool empty() const { return _M_c.empty(); }
+
+  size_type size() const { return _M_c.size(); }
+
+  size_type max_size() const { return _M_c.max_size(); }
+
+  void swap(flat_multiset& __x) { tinySTL::swap(*this, __x); }
+
+  template<typename... _Args> iterator
+  emplace(_Args&&... __args) { return _M_insert_equal(value_type(tinySTL::forward<_Args>(__args)...)); }
+
+  template<typename... _Args> iterator
+  emplace_hint(const_iterator __hint, _Args&&... __args)
+  { return _M_insert_equal(__hint, value_type(tinySTL::forward<_Args>(__args)...)); }
+
+  iterator insert(const value_type& __x) { return _M_insert_equal(__x); }
+
+  iterator insert(value_type&& __x) { return _M_insert_equal(tinySTL::move(__x)); }
+
+  iterator insert(const_iterator __hint, const value_type& __x)
+  { return _M_insert_equal(__hint, __x); }
+
+  iterator insert(const_iterator __hint, value_type&& __x)
+  { return _M_insert_equal(__hint, tinySTL::move(__x)); }
+
+  /**
+   * @brief  append [first, last), sort the new values and merge them with
+   *  the old ones in one pass, O(n + m log m).
+   */
+  template <InputIterator _InputIterator>
+  void insert(_InputIterator __first, _InputIterator __last)
+  {
+    size_type __n = size();
+    for (; __first != __last; ++__first)
+      _M_c.push_back(*__first);
+    _M_sort_and_merge(__n);
+  }
+
+  template <InputIterator _InputIterator>
+  void insert(sorted_equivalent_t, _InputIterator __first, _InputIterator __last)
+  {
+    size_type __n = size();
+    for (; __first != __last; ++__first)
+      _M_c.push_back(*__first);
+    _M_merge_tail(__n);
+  }
+
+  void insert(std::initializer_list<value_type> __l)
+  { insert(__l.begin(), __l.end()); }
+
+  container_type extract() &&
+  {
+    container_type __c = tinySTL::move(_M_c);
+    _M_c.clear();
+    return __c;
+  }
+
+  void replace(container_type&& __c) { _M_c = tinySTL::move(__c); }
+
+  size_type erase(const key_type& __k)
+  {
+    tinySTL::pair<iterator, iterator> __p = equal_range(__k);
+    size_type __n = __p.second - __p.first;
+    erase(__p.first, __p.second);
+    return __n;
+  }
+
+  iterator erase(const_iterator __position)
+  { return _M_c.erase(__position); }
+
+  iterator erase(const_iterator __first, const_iterator __last)
+  { return _M_c.erase(__first, __last); }
+
+  void clear() { _M_c.clear(); }
+
+  size_type count(const key_type& __x) const
+  {
+    tinySTL::pair<iterator, iterator> __p = equal_range(__x);
+    return __p.second - __p.first;
+  }
+
+  bool contains(const key_type& __x) const { return find(__x) != end(); }
+
+  iterator find(const key_type& __x) const
+  {
+    iterator __i = lower_bound(__x);
+    return __i == end() || _M_compare(__x, *__i) ? end() : __i;
+  }
+
+  iterator lower_bound(const key_type& __x) const
+  { return tinySTL::lower_bound(begin(), end(), __x, _M_compare); }
+
+  iterator upper_bound(const key_type& __x) const
+  { return tinySTL::upper_bound(begin(), end(), __x, _M_compare); }
+
+  tinySTL::pair<iterator, iterator>
+  equal_range(const key_type& __x) const
+  { return {lower_bound(__x), upper_bound(__x)}; }
+
+  friend bool operator==(const flat_multiset& __x, const flat_multiset& __y)
+  {
+    return __x.size() == __y.size()
+      && tinySTL::equal(__x.begin(), __x.end(), __y.begin());
+  }
+
+  friend bool operator<(const flat_multiset& __x, const flat_multiset& __y)
+  {
+    return lexicographical_compare(
+      __x.begin(), __x.end(),
+      __y.begin(), __y.end(),
+      __x.key_comp()
+    );
+  }
+
+  friend std::ostream& operator<<(std::ostream& os, const flat_multiset& s)
+  { return os << tinySTL::to_string(s._M_c); }
+
+ protected:
+  template <class _Arg>
+  iterator _M_insert_equal(_Arg&& __x)
+  { return _M_c.insert(upper_bound(__x), tinySTL::forward<_Arg>(__x)); }
+
+  template <class _Arg>
+  iterator _M_insert_equal(const_iterator __hint, _Arg&& __x)
+  {
+    if ((__hint == begin() || !_M_compare(__x, *(__hint - 1)))
+     && (__hint == end() || !_M_compare(*__hint, __x)))
+      return _M_c.insert(__hint, tinySTL::forward<_Arg>(__x));
+    return _M_insert_equal(tinySTL::forward<_Arg>(__x));
+  }
+
+  // [0, __n) is sorted, [__n, size()) was just appended.
+  void _M_sort_and_merge(size_type __n)
+  {
+    if (__flat_tail_in_order(_M_c, __n, _M_compare, false))
+      return;
+    // sort the new values through their indices, equal ones keep their
+    // input order.
+    size_type __e = size();
+    tinySTL::vector<size_type> __idx;
+    __idx.reserve(__e - __n);
+    for (size_type __i = __n; __i < __e; ++__i)
+      __idx.push_back(__i);
+    tinySTL::sort(__idx.begin(), __idx.end(), [this](size_type __a, size_type __b) {
+      return _M_compare(_M_c[__a], _M_c[__b])
+          || (!_M_compare(_M_c[__b], _M_c[__a]) && __a < __b);
+    });
+    _M_merge(__n, __idx);
+  }
+
+  void _M_merge_tail(size_type __n)
+  {
+    if (__flat_tail_in_order(_M_c, __n, _M_compare, false))
+      return;
+    tinySTL::vector<size_type> __idx;
+    __idx.reserve(size() - __n);
+    for (size_type __i = __n; __i < size(); ++__i)
+      __idx.push_back(__i);
+    _M_merge(__n, __idx);
+  }
+
+  // merge [0, __n) with the new values in the order of __idx, old values
+  // go first among equal ones.
+  void _M_merge(size_type __n, const tinySTL::vector<size_type>& __idx)
+  {
+    _Container __out;
+    __out.reserve(size());
+    size_type __i = 0, __j = 0, __m = __idx.size();
+    while (__i < __n || __j < __m) {
+      if (__j == __m || (__i < __n && !_M_compare(_M_c[__idx[__j]], _M_c[__i])))
+        __out.push_back(tinySTL::move(_M_c[__i++]));
+      else
+        __out.push_back(tinySTL::move(_M_c[__idx[__j++]]));
+    }
+    _M_c = tinySTL::move(__out);
+  }
+};
+
+}
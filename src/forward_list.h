@@ -25,6 +25,23 @@ struct _Slist_node_base {
     _M_next = __keep;
     return __end;
   }
+
+  // reverse the null terminated list headed by this node.
+  void _M_reverse() noexcept
+  {
+    _Slist_node_base* __node = _M_next;
+    if (__node == 0) return;
+    _Slist_node_base* __result = __node;
+    __node = __node->_M_next;
+    __result->_M_next = 0;
+    while (__node) {
+      _Slist_node_base* __next = __node->_M_next;
+      __node->_M_next = __result;
+      __result = __node;
+      __node = __next;
+    }
+    _M_next = __result;
+  }
 };
 
 struct _SList_node_header : public _Slist_node_base
@@ -76,6 +93,58 @@ struct _Slist_node : public _Slist_node_base
     }
 };
 
+// link level algorithms shared by forward_list and intrusive_forward_list.
+// A node compare functor orders two nodes by the values they hold.
+
+/**
+ * @brief merge the ordered list headed by @p __head2 into the ordered
+ *  list headed by @p __head1 .
+ */
+template <class _NodeCompare>
+void __slist_merge(_Slist_node_base* __head1, _Slist_node_base* __head2,
+                   _NodeCompare __comp)
+{
+  _Slist_node_base* __pre1 = __head1;
+  while (__pre1->_M_next && __head2->_M_next) {
+    if (__comp(__head2->_M_next, __pre1->_M_next))
+      __pre1->_M_transfer_after(__head2, __head2->_M_next);
+    __pre1 = __pre1->_M_next;
+  }
+  if (__head2->_M_next) {
+    __pre1->_M_next = __head2->_M_next;
+    __head2->_M_next = 0;
+  }
+}
+
+/**
+ * @brief the classic splice merge sort, @p _List needs default
+ *  construction, empty, before_begin, splice_after, merge and swap.
+ */
+template <class _List, class _Comp>
+void __slist_merge_sort(_List& __list, _Comp __comp)
+{
+  _List __carry;
+  _List __counter[64];
+  int __fill = 0;
+  while (!__list.empty()) {
+    __carry.splice_after(__carry.before_begin(),
+                         __list, __list.before_begin());
+    int __i = 0;
+    while (__i < __fill && !__counter[__i].empty()) {
+      __counter[__i].merge(__carry, __comp);
+      __carry.swap(__counter[__i]);
+      ++__i;
+    }
+    __carry.swap(__counter[__i]);
+    if (__i == __fill)
+      ++__fill;
+  }
+
+  for (int __i = 1; __i < __fill; ++__i)
+    __counter[__i].merge(__counter[__i - 1], __comp);
+  __list.swap(__counter[__fill - 1]);
+}
+
 template <class _Tp, class _Alloc = tinySTL::allocator<_Tp>>
 class forward_list
 {
@@ -172,6 +241,18 @@ class forward_list
   };
 
  protected:
+  template <class _Comp>
+  struct _Node_compare 
+  {
+    _Comp _M_comp;
+
+    bool operator()(const _Slist_node_base* __a, const _Slist_node_base* __b)
+      { 
+        return _M_comp(*((_Node*)__a)->_M_storage.ptr(), 
+                       *((_Node*)__b)->_M_storage.ptr()); 
+      }
+  };
+
   _Node* _M_get_node()
     { return _M_impl.allocate(1); }
 
@@ -486,22 +567,8 @@ class forward_list
   template <class _Comp>
   void merge(forward_list& __list, _Comp __comp)
   {
-    iterator __first1 = begin(), __last1 = end();
-    iterator __first2 = __list.begin(), __last2 = __list.end();
-    iterator __pre1 = before_begin(), __pre2 = __list.before_begin();
-
-    while (__first1 != __last1 && __first2 != __last2) {
-      if (__comp(*__first2, *__first1)) {
-        iterator __old = __first2;
-        _M_splice_after(__pre1, __pre2, ++__first2);
-        __pre1 = __old;
-      } else {
-        ++__pre1;
-        ++__first1;
-      }
-    }
-    if (__first2 != __last2)
-      _M_splice_after(__pre1, __pre2, __last2);
+    tinySTL::__slist_merge(&_M_impl._M_header, &__list._M_impl._M_header,
+      _Node_compare<_Comp>{__comp});
   }
 
   size_type remove(const _Tp& __value) {
@@ -567,20 +634,7 @@ class forward_list
   }
 
   void reverse()
-  {
-    if (this->empty()) return;
-    _Slist_node_base* __node = _M_impl._M_header._M_next;
-    _Slist_node_base* __result = __node;
-    __node = __node->_M_next;
-    __result->_M_next = 0;
-    while (__node) {
-      _Slist_node_base* __next = __node->_M_next;
-      __node->_M_next = __result;
-      __result = __node;
-      __node = __next;
-    }
-    _M_impl._M_header._M_next = __result;
-  }
+    { _M_impl._M_header._M_reverse(); }
 
   void sort() { sort(less()); }
 
@@ -590,27 +644,7 @@ class forward_list
     if (_M_impl._M_header._M_next == 0 
      || _M_impl._M_header._M_next->_M_next == 0)
       return;
-    
-    forward_list __carry;
-    forward_list __counter[64];
-    int __fill = 0;
-    while (!empty()) {
-      __carry.splice_after(__carry.before_begin(),
-                           *this, this->before_begin());
-      int __i = 0;
-      while (__i < __fill && !__counter[__i].empty()) {
-        __counter[__i].merge(__carry, __comp);
-        __carry.swap(__counter[__i]);
-        ++__i;
-      }
-      __carry.swap(__counter[__i]);
-      if (__i == __fill)
-        ++__fill;
-    }
-
-    for (int __i = 1; __i < __fill; ++__i)
-      __counter[__i].merge(__counter[__i - 1], __comp);
-    this->swap(__counter[__fill - 1]);
+    tinySTL::__slist_merge_sort(*this, __comp);
   }
 
   size_type unique() { return unique(equal()); }
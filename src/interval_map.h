@@ -0,0 +1,260 @@
+// tinySTL: interval_map.
+#pragma once
+
+#include <initializer_list>
+
+#include "tiny_tree.h"
+#include "tiny_pair.h"
+#include "tiny_alloc.h"
+#include "tiny_errors.h"
+#include "tiny_concepts.h"
+#include "tiny_function.h"
+
+namespace tinySTL
+{
+
+// intervals ordered by low end, then by high end.
+template <class _Key, class _Compare>
+struct _Interval_less
+{
+  bool operator()(const pair<_Key, _Key>& __a, const pair<_Key, _Key>& __b) const
+  {
+    _Compare __comp;
+    return __comp(__a.first, __b.first)
+        || (!__comp(__b.first, __a.first) && __comp(__a.second, __b.second));
+  }
+};
+
+// augmentation policy: the element of a subtree whose interval ends last.
+template <class _Val, class _Compare>
+struct _Interval_max_end
+{
+  typedef const _Val* value_type;
+
+  value_type operator()(const _Val& __x) const { return &__x; }
+
+  value_type operator()(value_type __a, value_type __b) const
+  { return _Compare()(__a->first.second, __b->first.second) ? __b : __a; }
+};
+
+/**
+ * @brief  multimap from closed intervals [first, second] to values, with
+ *  overlap queries. Every node keeps the element of its subtree that ends
+ *  last, so finding an interval that overlaps a range is O(log n), and
+ *  visiting all k of them O(k log n) at worst.
+ * @attention  an interval whose high end is less than its low end throws
+ *  range_error.
+ */
+template <class _Key, class _Val, class _Compare = less<_Key>,
+          class _Alloc = tinySTL::allocator<tinySTL::pair<tinySTL::pair<_Key, _Key>, _Val>>>
+class interval_map
+{
+ public:
+  typedef tinySTL::pair<_Key, _Key> key_type;
+  typedef _Key     bound_type;
+  typedef _Val     mapped_type;
+  typedef tinySTL::pair<const key_type, _Val> value_type;
+  typedef _Interval_less<_Key, _Compare> key_compare;
+  typedef _Alloc   allocator_type;
+
+ protected:
+  typedef _Rb_tree<key_type, value_type, _Select1st<value_type>, key_compare, _Alloc,
+                   false, _Interval_max_end<value_type, _Compare>> _Rep_type;
+  typedef typename _Rep_type::_Const_Base_ptr _Const_Base_ptr;
+  typedef typename _Rep_type::_Const_Link_type _Const_Link_type;
+  _Rep_type _M_t;
+
+ public:
+  typedef typename _Rep_type::reference reference;
+  typedef typename _Rep_type::const_reference const_reference;
+  typedef typename _Rep_type::iterator iterator;
+  typedef typename _Rep_type::const_iterator const_iterator;
+  typedef typename _Rep_type::reverse_iterator reverse_iterator;
+  typedef typename _Rep_type::const_reverse_iterator const_reverse_iterator;
+  typedef typename _Rep_type::size_type size_type;
+  typedef typename _Rep_type::difference_type difference_type;
+
+ public:
+  interval_map() : _M_t() {}
+
+  interval_map(std::initializer_list<value_type> __l) : _M_t()
+  { insert(__l.begin(), __l.end()); }
+
+  template <InputIterator _Iterator>
+  interval_map(_Iterator __first, _Iterator __last) : _M_t()
+  { insert(__first, __last); }
+
+  key_compare key_comp() const { return key_compare(); }
+
+  iterator begin() { return _M_t.begin(); }
+
+  const_iterator begin() const { return _M_t.begin(); }
+
+  const_iterator cbegin() const { return _M_t.begin(); }
+
+  iterator end() { return _M_t.end(); }
+
+  const_iterator end() const { return _M_t.end(); }
+
+  const_iterator cend() const { return _M_t.end(); }
+
+  reverse_iterator rbegin() { return _M_t.rbegin(); }
+
+  const_reverse_iterator rbegin() const { return _M_t.rbegin(); }
+
+  reverse_iterator rend() { return _M_t.rend(); }
+
+  const_reverse_iterator rend() const { return _M_t.rend(); }
+
+  bool empty() const { return _M_t.size() == 0; }
+
+  size_type size() const { return _M_t.size(); }
+
+  size_type max_size() const { return _M_t.max_size(); }
+
+  void swap(interval_map& __x) { tinySTL::swap(_M_t, __x._M_t); }
+
+  iterator insert(const value_type& __x)
+  {
+    _M_check(__x.first);
+    return _M_t._M_insert_equal(__x);
+  }
+
+  iterator insert(value_type&& __x)
+  {
+    _M_check(__x.first);
+    return _M_t._M_insert_equal(tinySTL::move(__x));
+  }
+
+  template <InputIterator _Iterator>
+  void insert(_Iterator __first, _Iterator __last)
+  {
+    for (; __first != __last; ++__first)
+      insert(*__first);
+  }
+
+  void insert(std::initializer_list<value_type> __l)
+  { insert(__l.begin(), __l.end()); }
+
+  template <class... _Args>
+  iterator emplace(const _Key& __lo, const _Key& __hi, _Args&&... __args)
+  {
+    _M_check(key_type(__lo, __hi));
+    return _M_t._M_emplace_equal(std::piecewise_construct, std::forward_as_tuple(__lo, __hi),
+                                 std::forward_as_tuple(tinySTL::forward<_Args>(__args)...));
+  }
+
+  // every element of exactly the interval __k.
+  size_type erase(const key_type& __k) { return _M_t.erase(__k); }
+
+  iterator erase(const_iterator __position) { return _M_t.erase(__position.base()); }
+
+  void clear() { _M_t.clear(); }
+
+  // lay the nodes out in key order and rebuild the overlap data.
+  void compact() { _M_t.compact(); }
+
+  // an element of exactly the interval __k.
+  iterator find(const key_type& __k) { return _M_t.find(__k); }
+
+  const_iterator find(const key_type& __k) const { return _M_t.find(__k); }
+
+  size_type count(const key_type& __k) const { return _M_t.count_multi(__k); }
+
+  /**
+   * @brief  the first element, in key order, whose interval overlaps
+   *  [__lo, __hi], end() when none does. O(log n).
+   */
+  iterator find_overlap(const _Key& __lo, const _Key& __hi)
+  { return iterator(const_cast<_Rb_tree_node_base*>(_M_first_overlap(__lo, __hi))); }
+
+  const_iterator find_overlap(const _Key& __lo, const _Key& __hi) const
+  { return iterator(const_cast<_Rb_tree_node_base*>(_M_first_overlap(__lo, __hi))); }
+
+  // the first element whose interval holds __p.
+  iterator find_overlap(const _Key& __p) { return find_overlap(__p, __p); }
+
+  const_iterator find_overlap(const _Key& __p) const { return find_overlap(__p, __p); }
+
+  /**
+   * @brief  call __f on every element whose interval overlaps [__lo, __hi],
+   *  in key order. Subtrees ending before __lo are skipped whole.
+   */
+  template <class _Function>
+  void for_each_overlap(const _Key& __lo, const _Key& __hi, _Function __f)
+  { _M_visit(_M_top(), __lo, __hi, [&__f](_Const_Base_ptr __x) { __f(*_S_value(__x)); }); }
+
+  template <class _Function>
+  void for_each_overlap(const _Key& __lo, const _Key& __hi, _Function __f) const
+  {
+    _M_visit(_M_top(), __lo, __hi,
+             [&__f](_Const_Base_ptr __x) { __f(static_cast<const value_type&>(*_S_value(__x))); });
+  }
+
+  // the number of elements whose interval overlaps [__lo, __hi].
+  size_type count_overlaps(const _Key& __lo, const _Key& __hi) const
+  {
+    size_type __n = 0;
+    _M_visit(_M_top(), __lo, __hi, [&__n](_Const_Base_ptr) { ++__n; });
+    return __n;
+  }
+
+  friend std::ostream& operator<<(std::ostream& os, const interval_map& m)
+  { return os << tinySTL::to_string(m); }
+
+ protected:
+  static void _M_check(const key_type& __k)
+  {
+    if (_Compare()(__k.second, __k.first))
+      __tiny_throw_range_error("interval_map: high end before low end");
+  }
+
+  static value_type* _S_value(_Const_Base_ptr __x)
+  { return const_cast<value_type*>(static_cast<_Const_Link_type>(__x)->_M_valptr()); }
+
+  static const _Key& _S_high(_Const_Base_ptr __x) { return _Rep_type::_S_aug(__x)->first.second; }
+
+  _Const_Base_ptr _M_top() const { return _M_t._M_header ? _M_t._M_root() : nullptr; }
+
+  static bool _S_overlaps(_Const_Base_ptr __x, const _Key& __lo, const _Key& __hi)
+  {
+    const key_type& __k = _S_value(__x)->first;
+    return !_Compare()(__k.second, __lo) && !_Compare()(__hi, __k.first);
+  }
+
+  _Const_Base_ptr _M_first_overlap(const _Key& __lo, const _Key& __hi) const
+  {
+    _Compare __comp;
+    _Const_Base_ptr __x = _M_top();
+    while (__x != nullptr) {
+      // something on the left ends at or after __lo and starts no later
+      // than __x: the first overlap is there if there is one at all.
+      if (__x->_M_left != nullptr && !__comp(_S_high(__x->_M_left), __lo)) {
+        __x = __x->_M_left;
+        continue;
+      }
+      if (_S_overlaps(__x, __lo, __hi))
+        return __x;
+      if (__comp(__hi, _S_value(__x)->first.first))
+        break;
+      __x = __x->_M_right;
+    }
+    return _M_t._M_header;
+  }
+
+  template <class _Visit>
+  static void _M_visit(_Const_Base_ptr __x, const _Key& __lo, const _Key& __hi, _Visit&& __visit)
+  {
+    _Compare __comp;
+    while (__x != nullptr && !__comp(_S_high(__x), __lo)) {
+      _M_visit(__x->_M_left, __lo, __hi, __visit);
+      if (__comp(__hi, _S_value(__x)->first.first))
+        return;
+      if (!__comp(_S_value(__x)->first.second, __lo))
+        __visit(__x);
+      __x = __x->_M_right;
+    }
+  }
+};
+
+}
@@ -0,0 +1,391 @@
+// tinySTL: intrusive_forward_list.
+#pragma once
+
+#include "forward_list.h"
+#include "tiny_function.h"
+#include "tiny_intrusive.h"
+
+namespace tinySTL
+{
+
+/**
+ * @brief  member hook of intrusive_forward_list. Copying a value never
+ *  copies its link.
+ */
+struct slist_hook : public _Slist_node_base
+{
+  slist_hook() {}
+
+  slist_hook(const slist_hook&) {}
+
+  slist_hook& operator=(const slist_hook&) { return *this; }
+};
+
+/**
+ * @brief  a singly linked list of values that carry their own link in
+ *  the member @p _Hook . The list never allocates, copies or destroys
+ *  values, a value must outlive its membership in the list.
+ */
+template <class _Tp, slist_hook _Tp::* _Hook>
+class intrusive_forward_list
+{
+ protected:
+  typedef _Intrusive_member_traits<_Tp, slist_hook, _Hook> _Traits;
+
+  class _Intrusive_slist_iterator
+  {
+   friend class intrusive_forward_list;
+   public:
+    using iterator_category = tinySTL::forward_iterator_tag;
+    using value_type = _Tp;
+    using difference_type = ptrdiff_t;
+    using pointer = _Tp*;
+    using reference = _Tp&;
+
+   protected:
+    _Slist_node_base* _M_node;
+
+   public:
+    constexpr _Intrusive_slist_iterator() : _M_node(0) {}
+
+   protected:
+    constexpr _Intrusive_slist_iterator(const _Slist_node_base* __ptr)
+      : _M_node((_Slist_node_base*)__ptr) { }
+
+   public:
+    constexpr reference operator*() const
+      { return *_Traits::_S_to_value((slist_hook*)_M_node); }
+
+    constexpr pointer operator->() const
+      { return _Traits::_S_to_value((slist_hook*)_M_node); }
+
+    constexpr _Intrusive_slist_iterator& operator++()
+      {
+        _M_node = _M_node->_M_next;
+        return *this;
+      }
+
+    constexpr _Intrusive_slist_iterator operator++(int)
+      {
+        _Intrusive_slist_iterator old(this->_M_node);
+        ++(*this);
+        return old;
+      }
+
+    friend constexpr bool operator==(
+      const _Intrusive_slist_iterator& __x,
+      const _Intrusive_slist_iterator& __y)
+      {
+        return __x._M_node == __y._M_node;
+      }
+  };
+
+ public:
+  typedef _Tp value_type;
+  typedef value_type* pointer;
+  typedef const value_type* const_pointer;
+  typedef _Intrusive_slist_iterator iterator;
+  typedef tinySTL::const_iterator<iterator> const_iterator;
+  typedef value_type& reference;
+  typedef const value_type& const_reference;
+  typedef size_t size_type;
+  typedef ptrdiff_t difference_type;
+
+ protected:
+  _SList_node_header _M_header;
+
+  template <class _Comp>
+  struct _Node_compare
+  {
+    _Comp _M_comp;
+
+    bool operator()(const _Slist_node_base* __a, const _Slist_node_base* __b)
+      {
+        return _M_comp(*_Traits::_S_to_value((const slist_hook*)__a),
+                       *_Traits::_S_to_value((const slist_hook*)__b));
+      }
+  };
+
+ public:
+  intrusive_forward_list() {}
+
+  /**
+   * @brief link every value of [ @p __first, @p __last ) in order.
+   */
+  template <InputIterator Iterator>
+  intrusive_forward_list(Iterator __first, Iterator __last)
+    { insert_after(before_begin(), __first, __last); }
+
+  intrusive_forward_list(const intrusive_forward_list&) = delete;
+
+  intrusive_forward_list(intrusive_forward_list&& __x)
+    : _M_header(tinySTL::move(__x._M_header)) {}
+
+  ~intrusive_forward_list() { clear(); }
+
+  intrusive_forward_list& operator=(const intrusive_forward_list&) = delete;
+
+  intrusive_forward_list& operator=(intrusive_forward_list&& __x)
+    {
+      if (this != &__x) {
+        clear();
+        _M_header = tinySTL::move(__x._M_header);
+      }
+      return *this;
+    }
+
+  iterator begin()
+    { return iterator(_M_header._M_next); }
+
+  const_iterator begin() const
+    { return const_iterator(_M_header._M_next); }
+
+  const_iterator cbegin() const
+    { return const_iterator(_M_header._M_next); }
+
+  iterator before_begin()
+    { return iterator((_Slist_node_base*)(&_M_header)); }
+
+  const_iterator before_begin() const
+    { return const_iterator((_Slist_node_base*)(&_M_header)); }
+
+  const_iterator cbefore_begin() const
+    { return const_iterator((_Slist_node_base*)(&_M_header)); }
+
+  iterator end()
+    { return iterator(); }
+
+  const_iterator end() const
+    { return const_iterator(); }
+
+  const_iterator cend() const
+    { return const_iterator(); }
+
+  /**
+   * @brief the iterator of a value linked into this list, O(1).
+   */
+  iterator iterator_to(reference __x)
+    { return iterator(_Traits::_S_to_node(__x)); }
+
+  const_iterator iterator_to(const_reference __x) const
+    { return const_iterator(_Traits::_S_to_node(__x)); }
+
+  bool empty() const
+    { return _M_header._M_next == 0; }
+
+  size_type max_size() const { return size_type(-1); }
+
+  reference front()
+    { return *begin(); }
+
+  const_reference front() const
+    { return *begin(); }
+
+  /**
+   * @brief link @p __x after @p __pos .
+   */
+  iterator insert_after(const_iterator __pos, reference __x)
+    {
+      _Slist_node_base* __position = __pos.base()._M_node;
+      _Slist_node_base* __node = _Traits::_S_to_node(__x);
+      __node->_M_next = __position->_M_next;
+      __position->_M_next = __node;
+      return iterator(__node);
+    }
+
+  template <InputIterator Iterator>
+  iterator insert_after(const_iterator __pos, Iterator __first,
+                        Iterator __last)
+    {
+      iterator __cur = __pos.base();
+      for (; __first != __last; ++__first)
+        __cur = insert_after(__cur, *__first);
+      return __cur;
+    }
+
+  /**
+   * @brief unlink the value after @p __pos , the value itself is untouched.
+   */
+  iterator erase_after(const_iterator __pos)
+    {
+      iterator __position = __pos.base();
+      _Slist_node_base* __target = __position._M_node->_M_next;
+      __position._M_node->_M_next = __target->_M_next;
+      __target->_M_next = 0;
+      return ++__position;
+    }
+
+  iterator erase_after(const_iterator __pos, const_iterator __last)
+    {
+      while (__pos.base()._M_node->_M_next
+          != __last.base()._M_node)
+        erase_after(__pos);
+      return __last.base();
+    }
+
+  void push_front(reference __x)
+    { insert_after(before_begin(), __x); }
+
+  void pop_front()
+    { erase_after(before_begin()); }
+
+  void clear()
+    {
+      _Slist_node_base* __cur = _M_header._M_next;
+      while (__cur != 0) {
+        _Slist_node_base* __next = __cur->_M_next;
+        __cur->_M_next = 0;
+        __cur = __next;
+      }
+      _M_header._M_next = 0;
+    }
+
+  void swap(intrusive_forward_list& __x)
+    { tinySTL::swap(_M_header, __x._M_header); }
+
+  /**
+   * @brief splice @p __list after @p __pos , @p __list will be empty
+   *  after splice.
+   *
+   * @attention @p __list should not be *this.
+   */
+  void splice_after(const_iterator __pos, intrusive_forward_list& __list)
+    {
+      if (__list.empty()) return;
+      _M_splice_after(__pos.base(), __list.before_begin(), __list.end());
+    }
+
+  void splice_after(const_iterator __pos, intrusive_forward_list&& __list)
+    { splice_after(__pos, __list); }
+
+  /**
+   * @brief move value after @p __i from @p __list to current list after @p __pos .
+   *
+   * @attention if @p __list is *this, @p __i +1 should not be @p __pos .
+   */
+  void splice_after(const_iterator __pos, intrusive_forward_list& __list,
+                    const_iterator __i)
+    {
+      _Slist_node_base* __before_splice = __pos.base()._M_node;
+      _Slist_node_base* __before_first  = __i.base()._M_node;
+      _Slist_node_base* __before_last   = __before_first->_M_next;
+      if (__before_splice == __before_first
+       || __before_splice == __before_last) return;
+      __before_splice->_M_transfer_after(__before_first, __before_last);
+    }
+
+  void splice_after(const_iterator __pos, intrusive_forward_list&& __list,
+                    const_iterator __i)
+    { splice_after(__pos, __list, __i); }
+
+  /**
+   * @brief move [ @p __before +1, @p __last ) from @p __list to current list after @p __pos .
+   *
+   * @attention if @p __list is *this, @p __pos should not in ( @p __before , @p __last ) .
+   */
+  void splice_after(const_iterator __pos, intrusive_forward_list& __list,
+                    const_iterator __before, const_iterator __last)
+    { _M_splice_after(__pos.base(), __before.base(), __last.base()); }
+
+  void splice_after(const_iterator __pos, intrusive_forward_list&& __list,
+                    const_iterator __before, const_iterator __last)
+    { splice_after(__pos, __list, __before, __last); }
+
+  template <class _Pred>
+  size_type remove_if(_Pred __pred)
+    {
+      size_type __cnt = 0;
+      _Slist_node_base* __cur = (_Slist_node_base*)(&_M_header);
+      while (__cur->_M_next) {
+        if (__pred(*_Traits::_S_to_value((slist_hook*)__cur->_M_next))) {
+          erase_after(iterator(__cur));
+          ++__cnt;
+        } else {
+          __cur = __cur->_M_next;
+        }
+      }
+      return __cnt;
+    }
+
+  size_type remove(const_reference __value)
+    {
+      return remove_if([&__value](const_reference __x) {
+        return __x == __value;
+      });
+    }
+
+  size_type unique() { return unique(tinySTL::__equal_to{}); }
+
+  template <class _BinPred>
+  size_type unique(_BinPred __binary_pred)
+    {
+      size_type __cnt = 0;
+      if (empty()) return 0;
+      for (iterator pre = begin(), p = ++begin(); p != end();)
+        if (__binary_pred(*pre, *p)) {
+          p = erase_after(pre);
+          ++__cnt;
+        } else
+          pre = p++;
+      return __cnt;
+    }
+
+  /**
+   * @brief merge this list with another ordered list @p __list .
+   */
+  template <class _Comp>
+  void merge(intrusive_forward_list& __list, _Comp __comp)
+    {
+      tinySTL::__slist_merge(&_M_header, &__list._M_header,
+        _Node_compare<_Comp>{__comp});
+    }
+
+  template <class _Comp>
+  void merge(intrusive_forward_list&& __list, _Comp __comp)
+    { merge(__list, __comp); }
+
+  void merge(intrusive_forward_list& __list)
+    { merge(__list, tinySTL::__less{}); }
+
+  void merge(intrusive_forward_list&& __list)
+    { merge(__list, tinySTL::__less{}); }
+
+  void reverse()
+    { _M_header._M_reverse(); }
+
+  void sort() { sort(tinySTL::__less{}); }
+
+  template <class _Comp>
+  void sort(_Comp __comp)
+    {
+      if (_M_header._M_next == 0 || _M_header._M_next->_M_next == 0)
+        return;
+      tinySTL::__slist_merge_sort(*this, __comp);
+    }
+
+ protected:
+  void _M_splice_after(iterator __pos, iterator __before,
+                       iterator __last)
+    {
+      _Slist_node_base* __before_splice = __pos._M_node;
+      _Slist_node_base* __before_first  = __before._M_node;
+      _Slist_node_base* __before_last   = __before_first;
+      _Slist_node_base* __last_ptr      = __last._M_node;
+
+      while (__before_last && __before_last->_M_next != __last_ptr)
+        __before_last = __before_last->_M_next;
+
+      if (__before_last == 0)
+        __tiny_throw_range_error("intrusive_forward_list");
+
+      if (__before_last != __before_first)
+        __before_splice->_M_transfer_after(__before_first, __before_last);
+    }
+};
+
+template <class _Tp, slist_hook _Tp::* _Hook> inline void
+swap(intrusive_forward_list<_Tp, _Hook>& __x,
+     intrusive_forward_list<_Tp, _Hook>& __y)
+  { __x.swap(__y); }
+
+}
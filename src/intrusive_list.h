@@ -0,0 +1,436 @@
+// tinySTL: intrusive_list.
+#pragma once
+
+#include "list.h"
+#include "tiny_function.h"
+#include "tiny_intrusive.h"
+
+namespace tinySTL
+{
+
+/**
+ * @brief  member hook of intrusive_list. A value holds one hook for each
+ *  intrusive_list it may belong to at the same time. Copying a value
+ *  never copies its links.
+ */
+struct list_hook : public _List_node_base
+{
+  list_hook() {}
+
+  list_hook(const list_hook&) {}
+
+  list_hook& operator=(const list_hook&) { return *this; }
+
+  bool is_linked() const { return _M_next != 0; }
+};
+
+/**
+ * @brief  a doubly linked list of values that carry their own links.
+ *  The list never allocates, copies or destroys values: push and insert
+ *  link the hook @p _Hook of an existing value, erase and clear unlink it.
+ *  A value must outlive its membership in the list.
+ *
+ * @code
+ *  struct conn { list_hook lru; list_hook peers; int fd; };
+ *  intrusive_list<conn, &conn::lru> lru_list;
+ *  intrusive_list<conn, &conn::peers> peer_list;
+ * @endcode
+ */
+template <class _Tp, list_hook _Tp::* _Hook>
+class intrusive_list
+{
+ protected:
+  typedef _Intrusive_member_traits<_Tp, list_hook, _Hook> _Traits;
+
+  class _Intrusive_list_iterator
+  {
+   friend class intrusive_list;
+   public:
+    using iterator_category = tinySTL::bidirectional_iterator_tag;
+    using value_type = _Tp;
+    using difference_type = ptrdiff_t;
+    using pointer = _Tp*;
+    using reference = _Tp&;
+
+   protected:
+    _List_node_base* _M_node;
+
+   public:
+    constexpr _Intrusive_list_iterator() : _M_node(0) {}
+
+   protected:
+    constexpr _Intrusive_list_iterator(const _List_node_base* __ptr)
+      : _M_node((_List_node_base*)__ptr) { }
+
+   public:
+    constexpr reference operator*() const
+      { return *_Traits::_S_to_value((list_hook*)_M_node); }
+
+    constexpr pointer operator->() const
+      { return _Traits::_S_to_value((list_hook*)_M_node); }
+
+    constexpr _Intrusive_list_iterator& operator++()
+      {
+        _M_node = _M_node->_M_next;
+        return *this;
+      }
+
+    constexpr _Intrusive_list_iterator operator++(int)
+      {
+        _Intrusive_list_iterator old(this->_M_node);
+        ++(*this);
+        return old;
+      }
+
+    constexpr _Intrusive_list_iterator& operator--()
+      {
+        _M_node = _M_node->_M_prev;
+        return *this;
+      }
+
+    constexpr _Intrusive_list_iterator operator--(int)
+      {
+        _Intrusive_list_iterator old(this->_M_node);
+        --(*this);
+        return old;
+      }
+
+    friend constexpr bool operator==(
+      const _Intrusive_list_iterator& __x,
+      const _Intrusive_list_iterator& __y)
+      {
+        return __x._M_node == __y._M_node;
+      }
+  };
+
+ public:
+  typedef _Tp value_type;
+  typedef value_type* pointer;
+  typedef const value_type* const_pointer;
+  typedef _Intrusive_list_iterator iterator;
+  typedef tinySTL::const_iterator<iterator> const_iterator;
+  typedef value_type& reference;
+  typedef const value_type& const_reference;
+  typedef size_t size_type;
+  typedef ptrdiff_t difference_type;
+  typedef tinySTL::reverse_iterator<const_iterator> const_reverse_iterator;
+  typedef tinySTL::reverse_iterator<iterator> reverse_iterator;
+
+ protected:
+  _List_node_header _M_header;
+
+  template <class _StrictWeakOrdering>
+  struct _Node_compare
+  {
+    _StrictWeakOrdering _M_comp;
+
+    bool operator()(const _List_node_base* __a, const _List_node_base* __b)
+      {
+        return _M_comp(*_Traits::_S_to_value((const list_hook*)__a),
+                       *_Traits::_S_to_value((const list_hook*)__b));
+      }
+  };
+
+  void _M_range_check(size_type __n) const {
+    if (__n >= this->size())
+      __tiny_throw_range_error("intrusive_list");
+  }
+
+ public:
+  intrusive_list() {}
+
+  /**
+   * @brief link every value of [ @p __first, @p __last ) at the back.
+   */
+  template <InputIterator Iterator>
+  intrusive_list(Iterator __first, Iterator __last)
+    { insert(end(), __first, __last); }
+
+  intrusive_list(const intrusive_list&) = delete;
+
+  intrusive_list(intrusive_list&& __x)
+    : _M_header(tinySTL::move(__x._M_header)) {}
+
+  ~intrusive_list() { clear(); }
+
+  intrusive_list& operator=(const intrusive_list&) = delete;
+
+  intrusive_list& operator=(intrusive_list&& __x)
+    {
+      if (this != &__x) {
+        clear();
+        _M_header = tinySTL::move(__x._M_header);
+      }
+      return *this;
+    }
+
+  iterator begin()
+    { return iterator(_M_header._M_next); }
+
+  const_iterator begin() const
+    { return const_iterator(_M_header._M_next); }
+
+  const_iterator cbegin() const
+    { return const_iterator(_M_header._M_next); }
+
+  iterator end()
+    { return iterator(&_M_header); }
+
+  const_iterator end() const
+    { return const_iterator(&_M_header); }
+
+  const_iterator cend() const
+    { return const_iterator(&_M_header); }
+
+  reverse_iterator rbegin()
+    { return reverse_iterator(end()); }
+
+  const_reverse_iterator rbegin() const
+    { return const_reverse_iterator(end()); }
+
+  reverse_iterator rend()
+    { return reverse_iterator(begin()); }
+
+  const_reverse_iterator rend() const
+    { return const_reverse_iterator(begin()); }
+
+  /**
+   * @brief the iterator of a value linked into this list, O(1).
+   */
+  iterator iterator_to(reference __x)
+    { return iterator(_Traits::_S_to_node(__x)); }
+
+  const_iterator iterator_to(const_reference __x) const
+    { return const_iterator(_Traits::_S_to_node(__x)); }
+
+  bool empty() const { return _M_header._M_size == 0; }
+
+  size_type size() const { return _M_header._M_size; }
+
+  size_type max_size() const { return size_type(-1); }
+
+  reference front()
+    { _M_range_check(0); return *begin(); }
+
+  const_reference front() const
+    { _M_range_check(0); return *begin(); }
+
+  reference back()
+    { _M_range_check(0); return *(--end()); }
+
+  const_reference back() const
+    { _M_range_check(0); return *(--end()); }
+
+  void push_front(reference __x) { insert(begin(), __x); }
+
+  void push_back(reference __x) { insert(end(), __x); }
+
+  void pop_front()
+    {
+      if (!empty())
+        erase(begin());
+    }
+
+  void pop_back()
+    {
+      if (!empty())
+        erase(--end());
+    }
+
+  /**
+   * @brief link @p __x before @p __pos , @p __x must not be linked by
+   *  this hook already.
+   */
+  iterator insert(const_iterator __pos, reference __x)
+    {
+      _List_node_base* __position = __pos.base()._M_node;
+      _List_node_base* __node = _Traits::_S_to_node(__x);
+      __node->_M_next = __position;
+      __node->_M_prev = __position->_M_prev;
+      __position->_M_prev->_M_next = __node;
+      __position->_M_prev = __node;
+      ++_M_header._M_size;
+      return iterator(__node);
+    }
+
+  template <InputIterator Iterator>
+  iterator insert(const_iterator __pos, Iterator __first, Iterator __last)
+    {
+      iterator __ret = __pos.base();
+      bool __is_first = true;
+      for (; __first != __last; ++__first) {
+        iterator __it = insert(__pos, *__first);
+        if (__is_first) {
+          __ret = __it;
+          __is_first = false;
+        }
+      }
+      return __ret;
+    }
+
+  /**
+   * @brief unlink the value at @p __pos , the value itself is untouched.
+   */
+  iterator erase(const_iterator __pos)
+    {
+      _List_node_base* __node = __pos.base()._M_node;
+      _List_node_base* __next = __node->_M_next;
+      __node->_M_prev->_M_next = __next;
+      __next->_M_prev = __node->_M_prev;
+      __node->_M_prev = __node->_M_next = 0;
+      --_M_header._M_size;
+      return iterator(__next);
+    }
+
+  iterator erase(const_iterator __first, const_iterator __last)
+    {
+      while (__first != __last)
+        __first = erase(__first);
+      return __last.base();
+    }
+
+  void clear()
+    {
+      _List_node_base* __head = &_M_header;
+      _List_node_base* __cur = __head->_M_next;
+      while (__cur != __head) {
+        _List_node_base* __next = __cur->_M_next;
+        __cur->_M_prev = __cur->_M_next = 0;
+        __cur = __next;
+      }
+      _M_header._M_prev = _M_header._M_next = __head;
+      _M_header._M_size = 0;
+    }
+
+  void swap(intrusive_list& __x)
+    { tinySTL::swap(_M_header, __x._M_header); }
+
+  /**
+   * @brief move another list @p __x before @p __position .
+   *  list @p __x will be empty after splice.
+   *
+   * @attention list @p __x should not be *this.
+   */
+  void splice(const_iterator __position, intrusive_list& __x)
+    {
+      if (!__x.empty()) {
+        __position.base()._M_node->_M_transfer(
+          __x._M_header._M_next, &__x._M_header);
+        _M_header._M_size += __x.size();
+        __x._M_header._M_size = 0;
+      }
+    }
+
+  void splice(const_iterator __position, intrusive_list&& __x)
+    { splice(__position, __x); }
+
+  /**
+   * @brief move node at @p __i from list @p __x to current list before @p __position .
+   *
+   * @attention if list @p __x is *this, @p __i should not same as @p __position .
+   */
+  void splice(const_iterator __position, intrusive_list& __x, const_iterator __i)
+    {
+      const_iterator __j = __i;
+      ++__j;
+      if (__position == __i || __position == __j) return;
+      __position.base()._M_node->_M_transfer(__i.base()._M_node, __j.base()._M_node);
+      _M_header._M_size += 1;
+      __x._M_header._M_size -= 1;
+    }
+
+  void splice(const_iterator __position, intrusive_list&& __x, const_iterator __i)
+    { splice(__position, __x, __i); }
+
+  /**
+   * @brief move [ @p __first, @p __last ) from list @p __x to current list before @p __position .
+   *
+   * @attention if list @p __x is *this, @p __position should not in [ @p __first, @p __last ) .
+   */
+  void splice(const_iterator __position, intrusive_list& __x,
+              const_iterator __first, const_iterator __last)
+    {
+      size_type __n = tinySTL::distance(__first, __last);
+      __position.base()._M_node->_M_transfer(
+        __first.base()._M_node, __last.base()._M_node);
+      _M_header._M_size += __n;
+      __x._M_header._M_size -= __n;
+    }
+
+  void splice(const_iterator __position, intrusive_list&& __x,
+              const_iterator __first, const_iterator __last)
+    { splice(__position, __x, __first, __last); }
+
+  template <class _Pred>
+  size_type remove_if(_Pred __pred)
+    {
+      size_type __old_len = size();
+      for (iterator __it = begin(); __it != end();)
+        __pred(*__it) ? (__it = erase(__it)) : ++__it;
+      return __old_len - size();
+    }
+
+  size_type remove(const_reference __value)
+    {
+      return remove_if([&__value](const_reference __x) {
+        return __x == __value;
+      });
+    }
+
+  template <class _BinaryPredicate>
+  size_type unique(_BinaryPredicate __pred)
+    {
+      size_type __old_len = size();
+      if (empty()) return 0;
+      for (iterator pre = begin(), p = ++begin(); p != end();)
+        __pred(*pre, *p) ? (p = erase(p)) : (pre = p, ++p);
+      return __old_len - size();
+    }
+
+  size_type unique() { return unique(tinySTL::__equal_to{}); }
+
+  /**
+   * @brief merge this list with another list, these two lists
+   * should be ordered before use this function.
+   */
+  template <class _StrictWeakOrdering>
+  void merge(intrusive_list& __x, _StrictWeakOrdering __comp)
+    {
+      tinySTL::__list_merge(&_M_header, &__x._M_header,
+        _Node_compare<_StrictWeakOrdering>{__comp});
+      _M_header._M_size += __x._M_header._M_size;
+      __x._M_header._M_size = 0;
+    }
+
+  template <class _StrictWeakOrdering>
+  void merge(intrusive_list&& __x, _StrictWeakOrdering __comp)
+    { merge(__x, __comp); }
+
+  void merge(intrusive_list& __x) { merge(__x, tinySTL::__less{}); }
+
+  void merge(intrusive_list&& __x) { merge(__x, tinySTL::__less{}); }
+
+  void reverse() { _M_header._M_reverse(); }
+
+  void sort() { sort(tinySTL::__less{}); }
+
+  /**
+   * @brief sort the list by __comp, the sort is stable.
+   * @attention same strategy as list::sort, the merge sort fallback
+   * never allocates.
+   */
+  template <class _StrictWeakOrdering>
+  void sort(_StrictWeakOrdering __comp)
+    {
+      if (size() < 2) return;
+      if (!tinySTL::__list_gather_sort(&_M_header, size(),
+                                       _Node_compare<_StrictWeakOrdering>{__comp}))
+        tinySTL::__list_merge_sort(*this, __comp);
+    }
+};
+
+template <class _Tp, list_hook _Tp::* _Hook> inline void
+swap(intrusive_list<_Tp, _Hook>& __x, intrusive_list<_Tp, _Hook>& __y)
+  { __x.swap(__y); }
+
+}
@@ -1,11 +1,14 @@
 // tinySTL: list.
 #pragma once
 
+#include <stdlib.h>
+
 #include "tiny_alloc.h"
 #include "tiny_errors.h"
 #include "tiny_iterator.h"
 #include "tiny_algobase.h"
 #include "tiny_construct.h"
+#include "algorithm.h"
 
 namespace tinySTL
 {
@@ -13,6 +16,38 @@ namespace tinySTL
 struct _List_node_base {
   _List_node_base* _M_prev = 0;
   _List_node_base* _M_next = 0;
+
+  // move [__first, __last) before this node.
+  void _M_transfer(_List_node_base* __first, 
+                   _List_node_base* __last) noexcept
+  {
+    if (this != __last) {
+      // Remove [first, last) from its old position.
+      __last->_M_prev->_M_next  = this;
+      __first->_M_prev->_M_next = __last;
+      this->_M_prev->_M_next    = __first;
+
+      // Splice [first, last) into its new position.
+      _List_node_base* __tmp = this->_M_prev;
+      this->_M_prev          = __last->_M_prev;
+      __last->_M_prev        = __first->_M_prev; 
+      __first->_M_prev       = __tmp;
+    }
+  }
+
+  // reverse the circular list headed by this node.
+  void _M_reverse() noexcept
+  {
+    _List_node_base* __cur = this;
+    while (true) 
+    { 
+      _List_node_base* __next = __cur->_M_next;
+      __cur->_M_next = __cur->_M_prev;
+      __cur->_M_prev = __next;
+      if (__next == this) break;
+      __cur = __next;
+    }
+  }
 };
 
 struct _List_node_header : public _List_node_base
@@ -86,6 +121,137 @@ struct _List_node : public _List_node_base
     }
 };
 
+// link level algorithms shared by list and intrusive_list. A node compare
+// functor orders two nodes by the values they hold.
+
+/**
+ * @brief merge the ordered list headed by @p __head2 into the ordered
+ *  list headed by @p __head1 , the sizes are left to the caller.
+ */
+template <class _NodeCompare>
+void __list_merge(_List_node_base* __head1, _List_node_base* __head2, 
+                  _NodeCompare __comp)
+{
+  _List_node_base* __first1 = __head1->_M_next;
+  _List_node_base* __first2 = __head2->_M_next;
+  while (__first1 != __head1 && __first2 != __head2) 
+  { 
+    if (__comp(__first2, __first1)) 
+    { 
+      _List_node_base* __next = __first2->_M_next;
+      __first1->_M_transfer(__first2, __next);
+      __first2 = __next;
+    } 
+    else
+      __first1 = __first1->_M_next;
+  }
+  if (__first2 != __head2)
+    __head1->_M_transfer(__first2, __head2);
+}
+
+// a gathered node and its position in the list, the position breaks
+// ties so that the array sort is stable.
+struct _List_sort_entry 
+{
+  _List_node_base* _M_node;
+  size_t _M_index;
+};
+
+template <class _NodeCompare>
+struct _List_sort_entry_compare 
+{
+  _NodeCompare _M_comp;
+
+  bool operator()(const _List_sort_entry& __a, const _List_sort_entry& __b)
+    {
+      if (_M_comp(__a._M_node, __b._M_node)) return true;
+      if (_M_comp(__b._M_node, __a._M_node)) return false;
+      return __a._M_index < __b._M_index;
+    }
+};
+
+/**
+ * @brief gather the @p __n nodes of the list headed by @p __head into an
+ *  array, introsort it and relink.
+ * @return false if the array can't be allocated, the list is untouched.
+ */
+template <class _NodeCompare>
+bool __list_gather_sort(_List_node_base* __head, size_t __n, 
+                        _NodeCompare __comp)
+{
+  _List_sort_entry* __buf = (_List_sort_entry*)malloc(__n * sizeof(_List_sort_entry));
+  if (__buf == 0) return false;
+
+  _List_node_base* __cur = __head->_M_next;
+  for (size_t __i = 0; __i < __n; ++__i, __cur = __cur->_M_next) {
+    __buf[__i]._M_node = __cur;
+    __buf[__i]._M_index = __i;
+  }
+
+  // the links are untouched until the array is sorted, so the list
+  // is still valid if __comp throws.
+  try {
+    tinySTL::sort(__buf, __buf + __n, 
+      _List_sort_entry_compare<_NodeCompare>{__comp});
+  } catch (...) {
+    free(__buf);
+    throw;
+  }
+
+  _List_node_base* __pre = __head;
+  for (size_t __i = 0; __i < __n; ++__i) {
+    __cur = __buf[__i]._M_node;
+    __pre->_M_next = __cur;
+    __cur->_M_prev = __pre;
+    __pre = __cur;
+  }
+  __pre->_M_next = __head;
+  __head->_M_prev = __pre;
+  free(__buf);
+  return true;
+}
+
+/**
+ * @brief the classic splice merge sort, @p _List needs default
+ *  construction, empty, begin, end, splice, merge and swap.
+ */
+template <class _List, class _StrictWeakOrdering>
+void __list_merge_sort(_List& __list, _StrictWeakOrdering __comp)
+{ 
+  _List __carry;
+  _List __tmp[64];
+  _List* __fill = __tmp;
+  _List* __counter;
+  try { 
+    do { 
+      // move front element to __carry.
+      __carry.splice(__carry.begin(), __list, __list.begin());
+
+      for(__counter = __tmp;
+          __counter != __fill && !__counter->empty(); 
+          ++__counter) 
+        { 
+          __counter->merge(__carry, __comp);
+          __carry.swap(*__counter);
+        }
+      
+      __carry.swap(*__counter);
+      if (__counter == __fill)
+        ++__fill;
+    } while ( !__list.empty() );
+
+    for (__counter = __tmp + 1; __counter != __fill; ++__counter)
+      __counter->merge(*(__counter - 1), __comp);
+    
+    __list.swap(*(__fill - 1));
+  } catch(...) { 
+    __list.splice(__list.end(), __carry);
+    for (int __i = 0; __i < sizeof(__tmp)/sizeof(__tmp[0]); ++__i)
+      __list.splice(__list.end(), __tmp[__i]);
+    throw;
+  }
+}
+
 template <class _Tp, class _Alloc = tinySTL::allocator<_Tp>>
 class list
 {
@@ -457,6 +623,39 @@ class list
       _M_impl._M_header._M_size = 0;
     }
 
+  /**
+   * @brief move every element into a node of a contiguous run, in list
+   * order, so that walking the list walks memory in order.
+   * @attention invalidates every iterator and reference. An element is
+   * moved if that cannot throw and copied otherwise; if a copy throws, the
+   * list still holds what it held.
+   */
+  void compact()
+    {
+      _Node_run<_Node_alloc_type> __run(_M_impl, size());
+      _List_node_base* __head = &_M_impl._M_header;
+      try {
+        for (_List_node_base* __x = __head->_M_next; __x != __head; ) {
+          _Node* __y = __run._M_take();
+          try {
+            tinySTL::construct(__y, tinySTL::move_if_noexcept(*((_Node*)__x)->_M_storage.ptr()));
+          } catch (...) {
+            _M_put_node(__y);
+            throw;
+          }
+          __y->_M_prev = __x->_M_prev;
+          __y->_M_next = __x->_M_next;
+          __x->_M_prev->_M_next = __y;
+          __x->_M_next->_M_prev = __y;
+          _M_destroy_node((_Node*)__x);
+          __x = __y->_M_next;
+        }
+      } catch (...) {
+        __run._M_release();
+        throw;
+      }
+    }
+
   void resize(size_type __new_size, const _Tp& __x)
     {
       iterator __i = begin();
@@ -659,20 +858,8 @@ class list
   template <class _StrictWeakOrdering>
   void merge(list& __x, _StrictWeakOrdering __comp) 
     { 
-      iterator __first1 = begin(), __last1 = end();    
-      iterator __first2 = __x.begin(), __last2 = __x.end();
-      while (__first1 != __last1 && __first2 != __last2) 
-      { 
-        if (__comp(*__first2, *__first1)) 
-        { 
-          iterator __old = __first2;
-          _M_transfer(__first1, __old, ++__first2);
-        } 
-        else
-          ++__first1;
-      }
-      if (__first2 != __last2)
-        _M_transfer(__last1, __first2, __last2);
+      tinySTL::__list_merge(&_M_impl._M_header, &__x._M_impl._M_header, 
+        _Node_compare<_StrictWeakOrdering>{__comp});
       _M_impl._M_header._M_size += __x._M_impl._M_header._M_size;
       __x._M_impl._M_header._M_size = 0;
     }
@@ -691,59 +878,27 @@ class list
    * @brief reverse list. 
    */
   void reverse()
-    { 
-      _List_node_base* __head = (_List_node_base*)(&_M_impl._M_header);
-      _List_node_base* __cur = __head;
-      while (true) 
-      { 
-        _List_node_base* __next = __cur->_M_next;
-        __cur->_M_next = __cur->_M_prev;
-        __cur->_M_prev = __next;
-        if (__next == __head) break;
-        __cur = __next;
-      }
-    }
+    { _M_impl._M_header._M_reverse(); }
 
   void sort() { sort(less()); }
 
+  /**
+   * @brief sort the list by __comp, the sort is stable.
+   * @param __comp sort method
+   * @attention the nodes are gathered into a temporary array which is
+   * sorted and then relinked once. That beats the splice merge sort at
+   * every length, even 2, the merge sort sets up 64 temporary lists (see
+   * bench/list_sort.cpp). It is kept for when the array can't be
+   * allocated.
+   */
   template <class _StrictWeakOrdering>
   void sort(_StrictWeakOrdering __comp)
   { 
     // Do nothing if the list has length 0 or 1.
     if (size() < 2) return;
 
-    list __carry;
-    list __tmp[64];
-    list* __fill = __tmp;
-    list* __counter;
-    try { 
-      do { 
-        // move front element to __carry.
-        __carry.splice(__carry.begin(), *this, begin());
-
-        for(__counter = __tmp;
-            __counter != __fill && !__counter->empty(); 
-            ++__counter) 
-          { 
-            __counter->merge(__carry, __comp);
-            __carry.swap(*__counter);
-          }
-        
-        __carry.swap(*__counter);
-        if (__counter == __fill)
-          ++__fill;
-      } while ( !empty() );
-
-      for (__counter = __tmp + 1; __counter != __fill; ++__counter)
-        __counter->merge(*(__counter - 1), __comp);
-      
-      swap(*(__fill - 1));
-    } catch(...) { 
-      this->splice(this->end(), __carry);
-      for (int __i = 0; __i < sizeof(__tmp)/sizeof(__tmp[0]); ++__i)
-        this->splice(this->end(), __tmp[__i]);
-      throw;
-    }
+    if (!_M_gather_sort(__comp))
+      _M_merge_sort(__comp);
   }
 
   template <class... _Args>
@@ -772,22 +927,32 @@ class list
   }
 
  protected:
-  void _M_transfer(iterator __position, iterator __first, iterator __last)
+  template <class _StrictWeakOrdering>
+  struct _Node_compare 
   {
-    if (__position != __last) {
-      // Remove [first, last) from its old position.
-      __last._M_node->_M_prev->_M_next     = __position._M_node;
-      __first._M_node->_M_prev->_M_next    = __last._M_node;
-      __position._M_node->_M_prev->_M_next = __first._M_node;
+    _StrictWeakOrdering _M_comp;
 
-      // Splice [first, last) into its new position.
-      _List_node_base* __tmp      = __position._M_node->_M_prev;
-      __position._M_node->_M_prev = __last._M_node->_M_prev;
-      __last._M_node->_M_prev     = __first._M_node->_M_prev; 
-      __first._M_node->_M_prev    = __tmp;
-    }
+    bool operator()(const _List_node_base* __a, const _List_node_base* __b)
+      { 
+        return _M_comp(*((_Node*)__a)->_M_storage.ptr(), 
+                       *((_Node*)__b)->_M_storage.ptr()); 
+      }
+  };
+
+  template <class _StrictWeakOrdering>
+  bool _M_gather_sort(_StrictWeakOrdering __comp)
+  {
+    return tinySTL::__list_gather_sort(&_M_impl._M_header, size(), 
+      _Node_compare<_StrictWeakOrdering>{__comp});
   }
 
+  template <class _StrictWeakOrdering>
+  void _M_merge_sort(_StrictWeakOrdering __comp)
+    { tinySTL::__list_merge_sort(*this, __comp); }
+
+  void _M_transfer(iterator __position, iterator __first, iterator __last)
+    { __position._M_node->_M_transfer(__first._M_node, __last._M_node); }
+
   template <InputIterator Iterator>
   void _M_iter_construct(Iterator __first, Iterator __last) 
   {
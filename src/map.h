@@ -12,13 +12,13 @@
 namespace tinySTL
 {
 
-template<class, class, class, class> class multimap;
+template<class, class, class, class, bool, class> class multimap;
 
-template<class _Key, class _Val, class _Compare = less<_Key>, class _Alloc = tinySTL::allocator<tinySTL::pair<_Key, _Val>>>
+template<class _Key, class _Val, class _Compare = less<_Key>, class _Alloc = tinySTL::allocator<tinySTL::pair<_Key, _Val>>, bool _Ranked = false, class _Augment = void>
 class map {
 
-template<class, class, class, class> friend class map;
-template<class, class, class, class> friend class multimap;
+template<class, class, class, class, bool, class> friend class map;
+template<class, class, class, class, bool, class> friend class multimap;
 
  public:
   typedef _Key     key_type;
@@ -40,21 +40,26 @@ template<class, class, class, class> friend class multimap;
   };
 
  protected:
-  typedef tinySTL::_Rb_tree<key_type, value_type, _Select1st<value_type>, key_compare, _Alloc>
+  typedef tinySTL::_Rb_tree<key_type, value_type, _Select1st<value_type>, key_compare, _Alloc, _Ranked, _Augment>
             _Rep_type;
   _Rep_type _M_t;
+  static constexpr bool _Augmented = !is_same_v<_Augment, void>;
  
  public:
-  typedef typename _Rep_type::pointer pointer;
+  // the mapped values of an augmented map feed its folds, so its
+  // iterators are read-only: write through insert_or_assign or update.
+  typedef conditional_t<_Augmented, typename _Rep_type::const_pointer, typename _Rep_type::pointer> pointer;
   typedef typename _Rep_type::const_pointer const_pointer;
-  typedef typename _Rep_type::reference reference;
+  typedef conditional_t<_Augmented, typename _Rep_type::const_reference, typename _Rep_type::reference> reference;
   typedef typename _Rep_type::const_reference const_reference;
-  typedef typename _Rep_type::iterator iterator;
+  typedef conditional_t<_Augmented, typename _Rep_type::const_iterator, typename _Rep_type::iterator> iterator;
   typedef typename _Rep_type::const_iterator const_iterator;
-  typedef typename _Rep_type::reverse_iterator reverse_iterator;
+  typedef tinySTL::reverse_iterator<iterator> reverse_iterator;
   typedef typename _Rep_type::const_reverse_iterator const_reverse_iterator;
   typedef typename _Rep_type::size_type size_type;
   typedef typename _Rep_type::difference_type difference_type;
+  typedef _Map_node_handle<key_type, _Val, typename _Rep_type::_Node, typename _Rep_type::_Node_allocator> node_type;
+  typedef _Node_insert_return<iterator, node_type> insert_return_type;
 
  public:
   map() : _M_t() {}
@@ -102,13 +107,13 @@ template<class, class, class, class> friend class multimap;
 
   const_iterator cend() const { return _M_t.end(); }
 
-  reverse_iterator rbegin() { return _M_t.rbegin(); }
+  reverse_iterator rbegin() { return reverse_iterator(end()); }
 
   const_reverse_iterator rbegin() const { return _M_t.rbegin(); }
 
   const_reverse_iterator crbegin() const { return _M_t.rbegin(); }
 
-  reverse_iterator rend() { return _M_t.rend(); }
+  reverse_iterator rend() { return reverse_iterator(begin()); }
 
   const_reverse_iterator rend() const { return _M_t.rend(); }
 
@@ -122,15 +127,14 @@ template<class, class, class, class> friend class multimap;
 
   void swap(map& __x) { tinySTL::swap(*this, __x); }
 
-  _Val& operator[](const key_type& __k) {
-    iterator __i = lower_bound(__k);
-    if (__i == end() || key_comp()(__k, (*__i).first)) {
-      __i = insert(__i, value_type(__k, _Val()));
-    }
-    return (*__i).second;
-  }
+  // not for augmented maps, their folds would miss the assignment.
+  _Val& operator[](const key_type& __k) requires (!_Augmented)
+  { return try_emplace(__k).first->second; }
+
+  _Val& operator[](key_type&& __k) requires (!_Augmented)
+  { return try_emplace(tinySTL::move(__k)).first->second; }
 
-  const _Val& operator[](const key_type& __k) const {
+  const _Val& operator[](const key_type& __k) const requires (!_Augmented) {
     const_iterator __i = lower_bound(__k);
     if (__i == end() || key_comp()(__k, (*__i).first)) {
       __tiny_throw_range_error("map::operator[] const: key not found");
@@ -138,18 +142,111 @@ template<class, class, class, class> friend class multimap;
     return (*__i).second;
   }
 
-  _Val& at(const key_type& __k) 
+  _Val& at(const key_type& __k) requires (!_Augmented)
   {
     return this->operator[](__k);
   }
 
   const _Val& at(const key_type& __k) const 
   {
-    try {
-      return this->operator[](__k);
-    } catch (...) {
+    const_iterator __i = find(__k);
+    if (__i == end()) {
       __tiny_throw_range_error("map::at() const: key not found");
     }
+    return (*__i).second;
+  }
+
+  /**
+   * @brief  insert __k with a value built from __args, unless __k is
+   *  present. Only then is a node created; __k and __args are left
+   *  untouched otherwise.
+   */
+  template <class... _Args> tinySTL::pair<iterator, bool>
+  try_emplace(const key_type& __k, _Args&&... __args)
+  {
+    return _M_t._M_emplace_unique_key(__k, std::piecewise_construct, std::forward_as_tuple(__k),
+                                      std::forward_as_tuple(tinySTL::forward<_Args>(__args)...));
+  }
+
+  template <class... _Args> tinySTL::pair<iterator, bool>
+  try_emplace(key_type&& __k, _Args&&... __args)
+  {
+    return _M_t._M_emplace_unique_key(__k, std::piecewise_construct, std::forward_as_tuple(tinySTL::move(__k)),
+                                      std::forward_as_tuple(tinySTL::forward<_Args>(__args)...));
+  }
+
+  template <class... _Args> iterator
+  try_emplace(const_iterator __hint, const key_type& __k, _Args&&... __args)
+  {
+    return _M_t._M_emplace_hint_unique_key(__hint.base(), __k, std::piecewise_construct, std::forward_as_tuple(__k),
+                                           std::forward_as_tuple(tinySTL::forward<_Args>(__args)...)).first;
+  }
+
+  template <class... _Args> iterator
+  try_emplace(const_iterator __hint, key_type&& __k, _Args&&... __args)
+  {
+    return _M_t._M_emplace_hint_unique_key(__hint.base(), __k, std::piecewise_construct,
+                                           std::forward_as_tuple(tinySTL::move(__k)),
+                                           std::forward_as_tuple(tinySTL::forward<_Args>(__args)...)).first;
+  }
+
+  /**
+   * @brief  assign __obj to the value of __k, inserting __k if absent.
+   */
+  template <class _Obj> tinySTL::pair<iterator, bool>
+  insert_or_assign(const key_type& __k, _Obj&& __obj)
+  {
+    tinySTL::pair<iterator, bool> __r = try_emplace(__k, tinySTL::forward<_Obj>(__obj));
+    if (!__r.second)
+      _M_assign(__r.first, tinySTL::forward<_Obj>(__obj));
+    return __r;
+  }
+
+  template <class _Obj> tinySTL::pair<iterator, bool>
+  insert_or_assign(key_type&& __k, _Obj&& __obj)
+  {
+    tinySTL::pair<iterator, bool> __r = try_emplace(tinySTL::move(__k), tinySTL::forward<_Obj>(__obj));
+    if (!__r.second)
+      _M_assign(__r.first, tinySTL::forward<_Obj>(__obj));
+    return __r;
+  }
+
+  template <class _Obj> iterator
+  insert_or_assign(const_iterator __hint, const key_type& __k, _Obj&& __obj)
+  {
+    tinySTL::pair<iterator, bool> __r =
+      _M_t._M_emplace_hint_unique_key(__hint.base(), __k, std::piecewise_construct, std::forward_as_tuple(__k),
+                                      std::forward_as_tuple(tinySTL::forward<_Obj>(__obj)));
+    if (!__r.second)
+      _M_assign(__r.first, tinySTL::forward<_Obj>(__obj));
+    return __r.first;
+  }
+
+  template <class _Obj> iterator
+  insert_or_assign(const_iterator __hint, key_type&& __k, _Obj&& __obj)
+  {
+    tinySTL::pair<iterator, bool> __r =
+      _M_t._M_emplace_hint_unique_key(__hint.base(), __k, std::piecewise_construct,
+                                      std::forward_as_tuple(tinySTL::move(__k)),
+                                      std::forward_as_tuple(tinySTL::forward<_Obj>(__obj)));
+    if (!__r.second)
+      _M_assign(__r.first, tinySTL::forward<_Obj>(__obj));
+    return __r.first;
+  }
+
+  /**
+   * @brief  call __f on the value of __k, then refresh the folds above
+   *  it. Returns false, without calling __f, when __k is absent.
+   */
+  template <class _Function>
+  bool update(const key_type& __k, _Function __f)
+  {
+    typename _Rep_type::iterator __i = _M_t.find(__k);
+    if (__i == _M_t.end())
+      return false;
+    __f(__i->second);
+    _M_t._M_refresh(__i._M_node);
+    return true;
   }
 
   template<typename... _Args> tinySTL::pair<iterator, bool>
@@ -173,17 +270,31 @@ template<class, class, class, class> friend class multimap;
 
   template<typename _InputIterator> void
   insert(_InputIterator __first, _InputIterator __last) 
-  {
-    iterator it = end();
-    for (; __first != __last; ++__first) {
-      it = insert(it, *__first);
-    }
-  }
+  { _M_t._M_insert_range_unique(__first, __last); }
 
   void insert(std::initializer_list<value_type> __l) {
     insert(__l.begin(), __l.end());
   }
 
+  /**
+   * @brief  unlink the element at __position and hand its node out.
+   */
+  node_type extract(const_iterator __position)
+  { return _M_t.template _M_extract<node_type>(__position.base()); }
+
+  // an empty handle if __k is absent.
+  node_type extract(const key_type& __k)
+  { return _M_t.template _M_extract_key<node_type>(__k); }
+
+  insert_return_type insert(node_type&& __nh)
+  {
+    tinySTL::pair<iterator, bool> __r = _M_t._M_reinsert_node_unique(__nh);
+    return {__r.first, __r.second, tinySTL::move(__nh)};
+  }
+
+  iterator insert(const_iterator __hint, node_type&& __nh)
+  { return _M_t._M_reinsert_node_hint_unique(__hint.base(), __nh); }
+
   size_type erase(const key_type& __k) 
   { return _M_t.erase(__k); }
 
@@ -195,6 +306,25 @@ template<class, class, class, class> friend class multimap;
 
   void clear() { _M_t.clear(); }
 
+  // lay the nodes out in key order, one after another; see _Rb_tree::compact.
+  void compact() { _M_t.compact(); }
+
+  // call __f on every element with a key in [__lo, __hi), in key order,
+  // the same half-open range as fold; see _Rb_tree::for_each_in_range.
+  template <class _Function>
+  _Function for_each_in_range(const key_type& __lo, const key_type& __hi, _Function __f) requires (!_Augmented)
+  {
+    _M_t.for_each_in_range(__lo, __hi, __f);
+    return __f;
+  }
+
+  template <class _Function>
+  _Function for_each_in_range(const key_type& __lo, const key_type& __hi, _Function __f) const
+  {
+    _M_t.for_each_in_range(__lo, __hi, __f);
+    return __f;
+  }
+
   size_type count(const key_type& __x) const { return _M_t.count_unique(__x); }
 
   bool contains(const key_type& __x) const { return find(__x) != end(); }
@@ -219,22 +349,113 @@ template<class, class, class, class> friend class multimap;
   equal_range(const key_type& __x) const 
   { return _M_t.equal_range(__x); }
 
+  // heterogeneous lookup, only with a transparent comparator such as less<>.
+  template <class _Kt> requires __is_transparent<_Compare>
+  size_type count(const _Kt& __x) const { return _M_t.count_unique(__x); }
+
+  template <class _Kt> requires __is_transparent<_Compare>
+  bool contains(const _Kt& __x) const { return find(__x) != end(); }
+
+  template <class _Kt> requires __is_transparent<_Compare>
+  iterator find(const _Kt& __x) { return _M_t.find(__x); }
+
+  template <class _Kt> requires __is_transparent<_Compare>
+  const_iterator find(const _Kt& __x) const { return _M_t.find(__x); }
+
+  template <class _Kt> requires __is_transparent<_Compare>
+  iterator lower_bound(const _Kt& __x) { return _M_t.lower_bound(__x); }
+
+  template <class _Kt> requires __is_transparent<_Compare>
+  const_iterator lower_bound(const _Kt& __x) const { return _M_t.lower_bound(__x); }
+
+  template <class _Kt> requires __is_transparent<_Compare>
+  iterator upper_bound(const _Kt& __x) { return _M_t.upper_bound(__x); }
+
+  template <class _Kt> requires __is_transparent<_Compare>
+  const_iterator upper_bound(const _Kt& __x) const { return _M_t.upper_bound(__x); }
+
+  template <class _Kt> requires __is_transparent<_Compare>
+  tinySTL::pair<iterator, iterator>
+  equal_range(const _Kt& __x)
+  { return _M_t.equal_range(__x); }
+
+  template <class _Kt> requires __is_transparent<_Compare>
+  tinySTL::pair<const_iterator, const_iterator>
+  equal_range(const _Kt& __x) const
+  { return _M_t.equal_range(__x); }
+
+  /**
+   * @brief the value at index __k in key order, end() when __k >= size().
+   * @attention ranked containers only, O(log n).
+   */
+  iterator nth(size_type __k) requires _Ranked { return _M_t.nth(__k); }
+
+  const_iterator nth(size_type __k) const requires _Ranked { return _M_t.nth(__k); }
+
+  /**
+   * @brief the number of values whose keys are less than __x, O(log n).
+   * @attention ranked containers only.
+   */
+  size_type rank(const key_type& __x) const requires _Ranked { return _M_t.rank(__x); }
+
+  /**
+   * @brief the _Augment fold of the values whose keys are in [__lo, __hi),
+   *  a value-initialized one when there are none. The range is half-open
+   *  like that of for_each_in_range.
+   * @attention augmented containers only, O(log n).
+   */
+  auto fold(const key_type& __lo, const key_type& __hi) const requires (!is_same_v<_Augment, void>)
+  { return _M_t._M_fold(__lo, __hi); }
+
+  // the fold of every value, O(1).
+  auto fold() const requires (!is_same_v<_Augment, void>) { return _M_t._M_fold(); }
+
+  /**
+   * @brief move the values whose keys are not less than __x into the
+   *  returned map, O(log n) plus counting the smaller half.
+   * @attention O(log n) for ranked containers.
+   */
+  map split(const key_type& __x)
+  {
+    map __r;
+    __r._M_t = _M_t._M_split_off(__x);
+    return __r;
+  }
+
+  /**
+   * @brief append __x, whose keys must all be greater than ours, O(log n).
+   *  __x is left empty, a key out of order throws range_error.
+   */
+  void join(map&& __x) { _M_t._M_join(tinySTL::move(__x._M_t), true); }
+
+  /**
+   * @brief keep the elements whose keys __x also holds, __x is left empty.
+   *  O(m log(n/m + 1)) for sizes m <= n.
+   */
+  void intersect(map&& __x) { _M_t._M_intersect_unique(tinySTL::move(__x._M_t)); }
+
+  /**
+   * @brief erase the keys __x holds, __x is left empty.
+   *  O(m log(n/m + 1)) for sizes m <= n.
+   */
+  void subtract(map&& __x) { _M_t._M_subtract_unique(tinySTL::move(__x._M_t)); }
+
   void disp(std::ostream& os) { return _M_t.disp(os); }
 
   template <class _Compare2>
-  void merge(map<_Key, _Val, _Compare2, _Alloc>& __source) 
+  void merge(map<_Key, _Val, _Compare2, _Alloc, _Ranked, _Augment>& __source) 
   { return merge(tinySTL::move(__source)); }
 
   template <class _Compare2>
-  void merge(map<_Key, _Val, _Compare2, _Alloc>&& __source) 
-  { _M_t._M_merge_unique(tinySTL::move(__source._M_t)); }
+  void merge(map<_Key, _Val, _Compare2, _Alloc, _Ranked, _Augment>&& __source) 
+  { _M_t._M_union_unique(tinySTL::move(__source._M_t)); }
 
   template <class _Compare2>
-  void merge(multimap<_Key, _Val, _Compare2, _Alloc>& __source) 
+  void merge(multimap<_Key, _Val, _Compare2, _Alloc, _Ranked, _Augment>& __source) 
   { return merge(tinySTL::move(__source)); }
 
   template <class _Compare2>
-  void merge(multimap<_Key, _Val, _Compare2, _Alloc>&& __source)
+  void merge(multimap<_Key, _Val, _Compare2, _Alloc, _Ranked, _Augment>&& __source)
   { _M_t._M_merge_unique(tinySTL::move(__source._M_t)); }
 
   friend bool operator==(const map& __x, const map& __y) 
@@ -261,13 +482,27 @@ template<class, class, class, class> friend class multimap;
   friend std::ostream& operator<<(std::ostream& os, const map& s) 
   { return os << s._M_t; }
 
+ private:
+  // assign __obj to the value at __i, whichever iterator type __i is.
+  template <class _Obj>
+  void _M_assign(iterator __i, _Obj&& __obj)
+  {
+    typename _Rep_type::iterator __j;
+    if constexpr (_Augmented)
+      __j = __i.base();
+    else
+      __j = __i;
+    __j->second = tinySTL::forward<_Obj>(__obj);
+    _M_t._M_refresh(__j._M_node);
+  }
+
 };
 
-template<class _Key, class _Val, class _Compare = less<_Key>, class _Alloc = tinySTL::allocator<tinySTL::pair<_Key, _Val>>>
+template<class _Key, class _Val, class _Compare = less<_Key>, class _Alloc = tinySTL::allocator<tinySTL::pair<_Key, _Val>>, bool _Ranked = false, class _Augment = void>
 class multimap {
  
-template<class, class, class, class> friend class map;
-template<class, class, class, class> friend class multimap;
+template<class, class, class, class, bool, class> friend class map;
+template<class, class, class, class, bool, class> friend class multimap;
 
  public:
   typedef _Key     key_type;
@@ -289,7 +524,7 @@ template<class, class, class, class> friend class multimap;
   };
 
  protected:
-  typedef tinySTL::_Rb_tree<key_type, value_type, _Select1st<value_type>, key_compare, _Alloc>
+  typedef tinySTL::_Rb_tree<key_type, value_type, _Select1st<value_type>, key_compare, _Alloc, _Ranked, _Augment>
             _Rep_type;
   _Rep_type _M_t;
  
@@ -304,6 +539,7 @@ template<class, class, class, class> friend class multimap;
   typedef typename _Rep_type::const_reverse_iterator const_reverse_iterator;
   typedef typename _Rep_type::size_type size_type;
   typedef typename _Rep_type::difference_type difference_type;
+  typedef _Map_node_handle<key_type, _Val, typename _Rep_type::_Node, typename _Rep_type::_Node_allocator> node_type;
 
  public:
   multimap() : _M_t() {}
@@ -392,17 +628,28 @@ template<class, class, class, class> friend class multimap;
 
   template<typename _InputIterator> void
   insert(_InputIterator __first, _InputIterator __last) 
-  {
-    iterator it = end();
-    for (; __first != __last; ++__first) {
-      it = insert(it, *__first);
-    }
-  }
+  { _M_t._M_insert_range_equal(__first, __last); }
 
   void insert(std::initializer_list<value_type> __l) {
     insert(__l.begin(), __l.end());
   }
 
+  /**
+   * @brief  unlink the element at __position and hand its node out.
+   */
+  node_type extract(const_iterator __position)
+  { return _M_t.template _M_extract<node_type>(__position.base()); }
+
+  // an empty handle if __k is absent; with several, the first one.
+  node_type extract(const key_type& __k)
+  { return _M_t.template _M_extract_key<node_type>(__k); }
+
+  iterator insert(node_type&& __nh)
+  { return _M_t._M_reinsert_node_equal(__nh); }
+
+  iterator insert(const_iterator __hint, node_type&& __nh)
+  { return _M_t._M_reinsert_node_hint_equal(__hint.base(), __nh); }
+
   size_type erase(const key_type& __k) 
   { return _M_t.erase(__k); }
 
@@ -414,6 +661,25 @@ template<class, class, class, class> friend class multimap;
 
   void clear() { _M_t.clear(); }
 
+  // lay the nodes out in key order, one after another; see _Rb_tree::compact.
+  void compact() { _M_t.compact(); }
+
+  // call __f on every element with a key in [__lo, __hi), in key order,
+  // the same half-open range as fold; see _Rb_tree::for_each_in_range.
+  template <class _Function>
+  _Function for_each_in_range(const key_type& __lo, const key_type& __hi, _Function __f)
+  {
+    _M_t.for_each_in_range(__lo, __hi, __f);
+    return __f;
+  }
+
+  template <class _Function>
+  _Function for_each_in_range(const key_type& __lo, const key_type& __hi, _Function __f) const
+  {
+    _M_t.for_each_in_range(__lo, __hi, __f);
+    return __f;
+  }
+
   size_type count(const key_type& __x) const { return _M_t.count_multi(__x); }
 
   bool contains(const key_type& __x) const { return find(__x) != end(); }
@@ -438,22 +704,101 @@ template<class, class, class, class> friend class multimap;
   equal_range(const key_type& __x) const 
   { return _M_t.equal_range(__x); }
 
+  template <class _Kt> requires __is_transparent<_Compare>
+  size_type count(const _Kt& __x) const { return _M_t.count_multi(__x); }
+
+  template <class _Kt> requires __is_transparent<_Compare>
+  bool contains(const _Kt& __x) const { return find(__x) != end(); }
+
+  template <class _Kt> requires __is_transparent<_Compare>
+  iterator find(const _Kt& __x) { return _M_t.find(__x); }
+
+  template <class _Kt> requires __is_transparent<_Compare>
+  const_iterator find(const _Kt& __x) const { return _M_t.find(__x); }
+
+  template <class _Kt> requires __is_transparent<_Compare>
+  iterator lower_bound(const _Kt& __x) { return _M_t.lower_bound(__x); }
+
+  template <class _Kt> requires __is_transparent<_Compare>
+  const_iterator lower_bound(const _Kt& __x) const { return _M_t.lower_bound(__x); }
+
+  template <class _Kt> requires __is_transparent<_Compare>
+  iterator upper_bound(const _Kt& __x) { return _M_t.upper_bound(__x); }
+
+  template <class _Kt> requires __is_transparent<_Compare>
+  const_iterator upper_bound(const _Kt& __x) const { return _M_t.upper_bound(__x); }
+
+  template <class _Kt> requires __is_transparent<_Compare>
+  tinySTL::pair<iterator, iterator>
+  equal_range(const _Kt& __x)
+  { return _M_t.equal_range(__x); }
+
+  template <class _Kt> requires __is_transparent<_Compare>
+  tinySTL::pair<const_iterator, const_iterator>
+  equal_range(const _Kt& __x) const
+  { return _M_t.equal_range(__x); }
+
+  /**
+   * @brief the value at index __k in key order, end() when __k >= size().
+   * @attention ranked containers only, O(log n).
+   */
+  iterator nth(size_type __k) requires _Ranked { return _M_t.nth(__k); }
+
+  const_iterator nth(size_type __k) const requires _Ranked { return _M_t.nth(__k); }
+
+  /**
+   * @brief the number of values whose keys are less than __x, O(log n).
+   * @attention ranked containers only.
+   */
+  size_type rank(const key_type& __x) const requires _Ranked { return _M_t.rank(__x); }
+
+  /**
+   * @brief the _Augment fold of the values whose keys are in [__lo, __hi),
+   *  a value-initialized one when there are none. The range is half-open
+   *  like that of for_each_in_range.
+   * @attention augmented containers only, O(log n). The policy must only
+   *  read keys, multimap has no way to refresh it after a write.
+   */
+  auto fold(const key_type& __lo, const key_type& __hi) const requires (!is_same_v<_Augment, void>)
+  { return _M_t._M_fold(__lo, __hi); }
+
+  // the fold of every value, O(1).
+  auto fold() const requires (!is_same_v<_Augment, void>) { return _M_t._M_fold(); }
+
+  /**
+   * @brief move the values whose keys are not less than __x into the
+   *  returned multimap, O(log n) plus counting the smaller half.
+   * @attention O(log n) for ranked containers.
+   */
+  multimap split(const key_type& __x)
+  {
+    multimap __r;
+    __r._M_t = _M_t._M_split_off(__x);
+    return __r;
+  }
+
+  /**
+   * @brief append __x, whose keys must all follow ours, O(log n).
+   *  __x is left empty, a key out of order throws range_error.
+   */
+  void join(multimap&& __x) { _M_t._M_join(tinySTL::move(__x._M_t), false); }
+
   void disp(std::ostream& os) { return _M_t.disp(os); }
 
   template <class _Compare2>
-  void merge(map<_Key, _Val, _Compare2, _Alloc>& __source) 
+  void merge(map<_Key, _Val, _Compare2, _Alloc, _Ranked, _Augment>& __source) 
   { return merge(tinySTL::move(__source)); }
 
   template <class _Compare2>
-  void merge(map<_Key, _Val, _Compare2, _Alloc>&& __source) 
+  void merge(map<_Key, _Val, _Compare2, _Alloc, _Ranked, _Augment>&& __source) 
   { _M_t._M_merge_equal(tinySTL::move(__source._M_t)); }
 
   template <class _Compare2>
-  void merge(multimap<_Key, _Val, _Compare2, _Alloc>& __source) 
+  void merge(multimap<_Key, _Val, _Compare2, _Alloc, _Ranked, _Augment>& __source) 
   { return merge(tinySTL::move(__source)); }
 
   template <class _Compare2>
-  void merge(multimap<_Key, _Val, _Compare2, _Alloc>&& __source) 
+  void merge(multimap<_Key, _Val, _Compare2, _Alloc, _Ranked, _Augment>&& __source) 
   { _M_t._M_merge_equal(tinySTL::move(__source._M_t)); }
 
   friend bool operator==(const multimap& __x, const multimap& __y) 
@@ -482,4 +827,26 @@ template<class, class, class, class> friend class multimap;
 
 };
 
-}
\ No newline at end of file
+/**
+ * @brief  maps with order statistics: nth(), rank() and distance()
+ *  between iterators in O(log n), for one size_t more per node.
+ */
+template<class _Key, class _Val, class _Compare = less<_Key>, class _Alloc = tinySTL::allocator<tinySTL::pair<_Key, _Val>>>
+using ranked_map = map<_Key, _Val, _Compare, _Alloc, true>;
+
+template<class _Key, class _Val, class _Compare = less<_Key>, class _Alloc = tinySTL::allocator<tinySTL::pair<_Key, _Val>>>
+using ranked_multimap = multimap<_Key, _Val, _Compare, _Alloc, true>;
+
+/**
+ * @brief  maps keeping an _Augment fold, such as mapped_sum, in every
+ *  node: fold() over a key range in O(log n).
+ */
+template<class _Key, class _Val, class _Augment, class _Compare = less<_Key>,
+         class _Alloc = tinySTL::allocator<tinySTL::pair<_Key, _Val>>>
+using augmented_map = map<_Key, _Val, _Compare, _Alloc, false, _Augment>;
+
+template<class _Key, class _Val, class _Augment, class _Compare = less<_Key>,
+         class _Alloc = tinySTL::allocator<tinySTL::pair<_Key, _Val>>>
+using augmented_multimap = multimap<_Key, _Val, _Compare, _Alloc, false, _Augment>;
+
+}
@@ -0,0 +1,189 @@
+// tinySTL: persistent_map.
+#pragma once
+
+#include <initializer_list>
+
+#include "tiny_pair.h"
+#include "tiny_alloc.h"
+#include "tiny_errors.h"
+#include "tiny_concepts.h"
+#include "tiny_algobase.h"
+#include "tiny_function.h"
+#include "tiny_persistent_tree.h"
+
+namespace tinySTL
+{
+
+/**
+ * @brief  ordered map whose copies are O(1) snapshots. Copies share
+ *  their nodes, and an update copies only the O(log n) nodes it changes,
+ *  so a snapshot keeps seeing the map as it was while the original moves
+ *  on. A node is freed when the last snapshot holding it goes away.
+ * @attention  elements are read only: change a value with
+ *  insert_or_assign. A snapshot may be handed to another thread and read
+ *  there while the original is updated, but one map is not to be updated
+ *  while another thread reads that same map.
+ */
+template <class _Key, class _Val, class _Compare = less<_Key>,
+          class _Alloc = tinySTL::allocator<tinySTL::pair<_Key, _Val>>>
+class persistent_map
+{
+ public:
+  typedef _Key     key_type;
+  typedef _Val     mapped_type;
+  typedef tinySTL::pair<const _Key, _Val> value_type;
+  typedef _Compare key_compare;
+  typedef _Alloc   allocator_type;
+
+ protected:
+  typedef _Persistent_tree<key_type, value_type, _Select1st<value_type>, key_compare, _Alloc> _Rep_type;
+  _Rep_type _M_t;
+
+ public:
+  typedef const value_type& reference;
+  typedef const value_type& const_reference;
+  typedef typename _Rep_type::iterator iterator;
+  typedef typename _Rep_type::const_iterator const_iterator;
+  typedef typename _Rep_type::reverse_iterator reverse_iterator;
+  typedef typename _Rep_type::const_reverse_iterator const_reverse_iterator;
+  typedef typename _Rep_type::size_type size_type;
+  typedef typename _Rep_type::difference_type difference_type;
+
+ public:
+  persistent_map() : _M_t() {}
+
+  explicit persistent_map(const _Compare& __comp) : _M_t(__comp) {}
+
+  persistent_map(std::initializer_list<value_type> __l) : _M_t()
+  { insert(__l.begin(), __l.end()); }
+
+  template <InputIterator _Iterator>
+  persistent_map(_Iterator __first, _Iterator __last) : _M_t()
+  { insert(__first, __last); }
+
+  // O(1), the copy shares every node.
+  persistent_map(const persistent_map&) = default;
+
+  persistent_map(persistent_map&&) = default;
+
+  persistent_map& operator=(const persistent_map&) = default;
+
+  persistent_map& operator=(persistent_map&&) = default;
+
+  // the map as it is now, O(1).
+  persistent_map snapshot() const { return *this; }
+
+  key_compare key_comp() const { return _M_t.key_comp(); }
+
+  allocator_type get_allocator() const { return allocator_type{}; }
+
+  const_iterator begin() const { return _M_t.begin(); }
+
+  const_iterator cbegin() const { return _M_t.begin(); }
+
+  const_iterator end() const { return _M_t.end(); }
+
+  const_iterator cend() const { return _M_t.end(); }
+
+  const_reverse_iterator rbegin() const { return const_reverse_iterator(end()); }
+
+  const_reverse_iterator crbegin() const { return const_reverse_iterator(end()); }
+
+  const_reverse_iterator rend() const { return const_reverse_iterator(begin()); }
+
+  const_reverse_iterator crend() const { return const_reverse_iterator(begin()); }
+
+  bool empty() const { return _M_t.size() == 0; }
+
+  size_type size() const { return _M_t.size(); }
+
+  size_type max_size() const { return _M_t.max_size(); }
+
+  void swap(persistent_map& __x) noexcept { _M_t.swap(__x._M_t); }
+
+  const _Val& at(const key_type& __k) const
+  {
+    const_iterator __i = find(__k);
+    if (__i == end())
+      __tiny_throw_range_error("persistent_map::at: key not found");
+    return __i->second;
+  }
+
+  const _Val& operator[](const key_type& __k) const { return at(__k); }
+
+  pair<iterator, bool> insert(const value_type& __x)
+  { return _M_t._M_emplace_unique(__x); }
+
+  pair<iterator, bool> insert(value_type&& __x)
+  { return _M_t._M_emplace_unique(tinySTL::move(__x)); }
+
+  template <InputIterator _Iterator>
+  void insert(_Iterator __first, _Iterator __last)
+  {
+    for (; __first != __last; ++__first)
+      _M_t._M_emplace_unique(*__first);
+  }
+
+  void insert(std::initializer_list<value_type> __l)
+  { insert(__l.begin(), __l.end()); }
+
+  template <class... _Args>
+  pair<iterator, bool> emplace(_Args&&... __args)
+  { return _M_t._M_emplace_unique(tinySTL::forward<_Args>(__args)...); }
+
+  /**
+   * @brief  insert __k with a value built from __args, unless __k is
+   *  present, in which case nothing is copied.
+   */
+  template <class... _Args>
+  pair<iterator, bool> try_emplace(const key_type& __k, _Args&&... __args)
+  {
+    const_iterator __i = find(__k);
+    if (__i != end())
+      return pair<iterator, bool>(__i, false);
+    return _M_t._M_emplace_unique(std::piecewise_construct, std::forward_as_tuple(__k),
+                                  std::forward_as_tuple(tinySTL::forward<_Args>(__args)...));
+  }
+
+  /**
+   * @brief  set the value of __k to __obj, inserting __k if absent.
+   *  Snapshots taken before keep the old value.
+   */
+  template <class _Obj>
+  pair<iterator, bool> insert_or_assign(const key_type& __k, _Obj&& __obj)
+  { return _M_t._M_emplace_or_replace(__k, tinySTL::forward<_Obj>(__obj)); }
+
+  size_type erase(const key_type& __k) { return _M_t._M_erase_unique(__k); }
+
+  void clear() { _M_t.clear(); }
+
+  const_iterator find(const key_type& __k) const { return _M_t.find(__k); }
+
+  bool contains(const key_type& __k) const { return find(__k) != end(); }
+
+  size_type count(const key_type& __k) const { return contains(__k) ? 1 : 0; }
+
+  const_iterator lower_bound(const key_type& __k) const { return _M_t.lower_bound(__k); }
+
+  const_iterator upper_bound(const key_type& __k) const { return _M_t.upper_bound(__k); }
+
+  template <class _Kt> requires __is_transparent<_Compare>
+  const_iterator find(const _Kt& __k) const { return _M_t.find(__k); }
+
+  template <class _Kt> requires __is_transparent<_Compare>
+  bool contains(const _Kt& __k) const { return find(__k) != end(); }
+
+  template <class _Kt> requires __is_transparent<_Compare>
+  const_iterator lower_bound(const _Kt& __k) const { return _M_t.lower_bound(__k); }
+
+  template <class _Kt> requires __is_transparent<_Compare>
+  const_iterator upper_bound(const _Kt& __k) const { return _M_t.upper_bound(__k); }
+
+  template <class _Kt> requires __is_transparent<_Compare>
+  size_type erase(const _Kt& __k) { return _M_t._M_erase_unique(__k); }
+
+  friend std::ostream& operator<<(std::ostream& os, const persistent_map& m)
+  { return os << tinySTL::to_string(m); }
+};
+
+}
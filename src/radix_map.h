@@ -0,0 +1,188 @@
+// tinySTL: radix_map.
+#pragma once
+
+#include <string>
+#include <string_view>
+#include <initializer_list>
+
+#include "tiny_art.h"
+#include "tiny_pair.h"
+#include "tiny_alloc.h"
+#include "tiny_errors.h"
+#include "tiny_concepts.h"
+#include "tiny_algobase.h"
+#include "tiny_function.h"
+
+namespace tinySTL
+{
+
+/**
+ * @brief  map from strings to values on an adaptive radix tree. A lookup
+ *  costs one step per key byte, never a string comparison until the end,
+ *  iteration is in key order, and prefix_range gives every key starting
+ *  with a prefix without looking at the others.
+ * @attention  keys compare like std::string. Lookups take anything a
+ *  std::string_view is made from. Insert and erase invalidate iterators
+ *  to erased elements only.
+ */
+template <class _Val, class _Alloc = tinySTL::allocator<tinySTL::pair<const std::string, _Val>>>
+class radix_map
+{
+ public:
+  typedef std::string key_type;
+  typedef _Val     mapped_type;
+  typedef tinySTL::pair<const std::string, _Val> value_type;
+  typedef _Alloc   allocator_type;
+
+ protected:
+  typedef _Art_tree<value_type, _Select1st<value_type>, _Alloc> _Rep_type;
+  _Rep_type _M_t;
+
+ public:
+  typedef typename _Rep_type::reference reference;
+  typedef typename _Rep_type::const_reference const_reference;
+  typedef typename _Rep_type::iterator iterator;
+  typedef typename _Rep_type::const_iterator const_iterator;
+  typedef typename _Rep_type::reverse_iterator reverse_iterator;
+  typedef typename _Rep_type::const_reverse_iterator const_reverse_iterator;
+  typedef typename _Rep_type::size_type size_type;
+  typedef typename _Rep_type::difference_type difference_type;
+
+ public:
+  radix_map() : _M_t() {}
+
+  radix_map(std::initializer_list<value_type> __l) : _M_t()
+  { insert(__l.begin(), __l.end()); }
+
+  template <InputIterator _Iterator>
+  radix_map(_Iterator __first, _Iterator __last) : _M_t()
+  { insert(__first, __last); }
+
+  allocator_type get_allocator() const { return allocator_type{}; }
+
+  iterator begin() { return _M_t.begin(); }
+
+  const_iterator begin() const { return _M_t.begin(); }
+
+  const_iterator cbegin() const { return _M_t.begin(); }
+
+  iterator end() { return _M_t.end(); }
+
+  const_iterator end() const { return _M_t.end(); }
+
+  const_iterator cend() const { return _M_t.end(); }
+
+  reverse_iterator rbegin() { return _M_t.rbegin(); }
+
+  const_reverse_iterator rbegin() const { return _M_t.rbegin(); }
+
+  const_reverse_iterator crbegin() const { return _M_t.rbegin(); }
+
+  reverse_iterator rend() { return _M_t.rend(); }
+
+  const_reverse_iterator rend() const { return _M_t.rend(); }
+
+  const_reverse_iterator crend() const { return _M_t.rend(); }
+
+  bool empty() const { return _M_t.size() == 0; }
+
+  size_type size() const { return _M_t.size(); }
+
+  size_type max_size() const { return _M_t.max_size(); }
+
+  void swap(radix_map& __x) noexcept { _M_t.swap(__x._M_t); }
+
+  _Val& operator[](std::string_view __k) { return try_emplace(__k).first->second; }
+
+  _Val& at(std::string_view __k)
+  {
+    iterator __i = find(__k);
+    if (__i == end())
+      __tiny_throw_range_error("radix_map::at: key not found");
+    return __i->second;
+  }
+
+  const _Val& at(std::string_view __k) const
+  {
+    const_iterator __i = find(__k);
+    if (__i == end())
+      __tiny_throw_range_error("radix_map::at: key not found");
+    return __i->second;
+  }
+
+  pair<iterator, bool> insert(const value_type& __x)
+  { return _M_t._M_emplace_unique(__x); }
+
+  pair<iterator, bool> insert(value_type&& __x)
+  { return _M_t._M_emplace_unique(tinySTL::move(__x)); }
+
+  template <InputIterator _Iterator>
+  void insert(_Iterator __first, _Iterator __last)
+  {
+    for (; __first != __last; ++__first)
+      _M_t._M_emplace_unique(*__first);
+  }
+
+  void insert(std::initializer_list<value_type> __l)
+  { insert(__l.begin(), __l.end()); }
+
+  template <class... _Args>
+  pair<iterator, bool> emplace(_Args&&... __args)
+  { return _M_t._M_emplace_unique(tinySTL::forward<_Args>(__args)...); }
+
+  /**
+   * @brief  insert __k with a value built from __args, unless __k is
+   *  present, in which case nothing is built.
+   */
+  template <class... _Args>
+  pair<iterator, bool> try_emplace(std::string_view __k, _Args&&... __args)
+  {
+    iterator __i = find(__k);
+    if (__i != end())
+      return pair<iterator, bool>(__i, false);
+    return _M_t._M_emplace_unique(std::piecewise_construct, std::forward_as_tuple(__k),
+                                  std::forward_as_tuple(tinySTL::forward<_Args>(__args)...));
+  }
+
+  template <class _Obj>
+  pair<iterator, bool> insert_or_assign(std::string_view __k, _Obj&& __obj)
+  {
+    pair<iterator, bool> __r = try_emplace(__k, tinySTL::forward<_Obj>(__obj));
+    if (!__r.second)
+      __r.first->second = tinySTL::forward<_Obj>(__obj);
+    return __r;
+  }
+
+  size_type erase(std::string_view __k) { return _M_t.erase(__k); }
+
+  iterator erase(const_iterator __position) { return _M_t.erase(__position.base()); }
+
+  iterator erase(iterator __position) { return _M_t.erase(__position); }
+
+  void clear() { _M_t.clear(); }
+
+  iterator find(std::string_view __k) { return _M_t.find(__k); }
+
+  const_iterator find(std::string_view __k) const { return _M_t.find(__k); }
+
+  bool contains(std::string_view __k) const { return _M_t._M_find(__k) != nullptr; }
+
+  size_type count(std::string_view __k) const { return contains(__k) ? 1 : 0; }
+
+  /**
+   * @brief  the elements whose keys start with __p, in key order. O(|__p|)
+   *  to find, whatever the size of the map; the empty prefix is the map.
+   */
+  pair<iterator, iterator> prefix_range(std::string_view __p) { return _M_t.prefix_range(__p); }
+
+  pair<const_iterator, const_iterator> prefix_range(std::string_view __p) const
+  {
+    pair<iterator, iterator> __r = const_cast<_Rep_type&>(_M_t).prefix_range(__p);
+    return pair<const_iterator, const_iterator>(__r.first, __r.second);
+  }
+
+  friend std::ostream& operator<<(std::ostream& os, const radix_map& m)
+  { return os << tinySTL::to_string(m); }
+};
+
+}
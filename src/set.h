@@ -12,13 +12,13 @@
 namespace tinySTL
 {
 
-template<class, class, class> class multiset;
+template<class, class, class, bool, class> class multiset;
 
-template<class _Key, class _Compare = less<_Key>, class _Alloc = tinySTL::allocator<_Key>>
+template<class _Key, class _Compare = less<_Key>, class _Alloc = tinySTL::allocator<_Key>, bool _Ranked = false, class _Augment = void>
 class set {
  
-template<class, class, class> friend class set;
-template<class, class, class> friend class multiset;
+template<class, class, class, bool, class> friend class set;
+template<class, class, class, bool, class> friend class multiset;
 
  public:
   typedef _Key     key_type;
@@ -28,7 +28,7 @@ template<class, class, class> friend class multiset;
   typedef _Alloc   allocator_type;
 
  protected:
-  typedef tinySTL::_Rb_tree<key_type, value_type, _Identity<value_type>, key_compare, _Alloc>
+  typedef tinySTL::_Rb_tree<key_type, value_type, _Identity<value_type>, key_compare, _Alloc, _Ranked, _Augment>
             _Rep_type;
   _Rep_type _M_t;
  
@@ -43,6 +43,8 @@ template<class, class, class> friend class multiset;
   typedef typename _Rep_type::const_reverse_iterator const_reverse_iterator;
   typedef typename _Rep_type::size_type size_type;
   typedef typename _Rep_type::difference_type difference_type;
+  typedef _Set_node_handle<value_type, typename _Rep_type::_Node, typename _Rep_type::_Node_allocator> node_type;
+  typedef _Node_insert_return<iterator, node_type> insert_return_type;
 
  public:
   set() : _M_t() {}
@@ -131,16 +133,30 @@ template<class, class, class> friend class multiset;
 
   template<typename _InputIterator> void
   insert(_InputIterator __first, _InputIterator __last) 
-  {
-    iterator it = end();
-    for (; __first != __last; ++__first) {
-      it = insert(it, *__first);
-    }
-  }
+  { _M_t._M_insert_range_unique(__first, __last); }
 
   void insert(std::initializer_list<value_type> __l) 
   { insert(__l.begin(), __l.end()); }
 
+  /**
+   * @brief  unlink the element at __position and hand its node out.
+   */
+  node_type extract(const_iterator __position)
+  { return _M_t.template _M_extract<node_type>(__position.base()); }
+
+  // an empty handle if __k is absent.
+  node_type extract(const key_type& __k)
+  { return _M_t.template _M_extract_key<node_type>(__k); }
+
+  insert_return_type insert(node_type&& __nh)
+  {
+    tinySTL::pair<iterator, bool> __r = _M_t._M_reinsert_node_unique(__nh);
+    return {__r.first, __r.second, tinySTL::move(__nh)};
+  }
+
+  iterator insert(const_iterator __hint, node_type&& __nh)
+  { return _M_t._M_reinsert_node_hint_unique(__hint.base(), __nh); }
+
   size_type erase(const key_type& __k) 
   { return _M_t.erase(__k); }
 
@@ -152,6 +168,18 @@ template<class, class, class> friend class multiset;
 
   void clear() { _M_t.clear(); }
 
+  // lay the nodes out in key order, one after another; see _Rb_tree::compact.
+  void compact() { _M_t.compact(); }
+
+  // call __f on every element in [__lo, __hi), in order, the same
+  // half-open range as fold; see _Rb_tree::for_each_in_range.
+  template <class _Function>
+  _Function for_each_in_range(const key_type& __lo, const key_type& __hi, _Function __f) const
+  {
+    _M_t.for_each_in_range(__lo, __hi, __f);
+    return __f;
+  }
+
   size_type count(const key_type& __x) const { return _M_t.count_unique(__x); }
 
   bool contains(const key_type& __x) const { return find(__x) != end(); }
@@ -176,22 +204,111 @@ template<class, class, class> friend class multiset;
   equal_range(const key_type& __x) const 
   { return _M_t.equal_range(__x); }
 
+  // heterogeneous lookup, only with a transparent comparator such as less<>.
+  template <class _Kt> requires __is_transparent<_Compare>
+  size_type count(const _Kt& __x) const { return _M_t.count_unique(__x); }
+
+  template <class _Kt> requires __is_transparent<_Compare>
+  bool contains(const _Kt& __x) const { return find(__x) != end(); }
+
+  template <class _Kt> requires __is_transparent<_Compare>
+  iterator find(const _Kt& __x) { return _M_t.find(__x); }
+
+  template <class _Kt> requires __is_transparent<_Compare>
+  const_iterator find(const _Kt& __x) const { return _M_t.find(__x); }
+
+  template <class _Kt> requires __is_transparent<_Compare>
+  iterator lower_bound(const _Kt& __x) { return _M_t.lower_bound(__x); }
+
+  template <class _Kt> requires __is_transparent<_Compare>
+  const_iterator lower_bound(const _Kt& __x) const { return _M_t.lower_bound(__x); }
+
+  template <class _Kt> requires __is_transparent<_Compare>
+  iterator upper_bound(const _Kt& __x) { return _M_t.upper_bound(__x); }
+
+  template <class _Kt> requires __is_transparent<_Compare>
+  const_iterator upper_bound(const _Kt& __x) const { return _M_t.upper_bound(__x); }
+
+  template <class _Kt> requires __is_transparent<_Compare>
+  tinySTL::pair<iterator, iterator>
+  equal_range(const _Kt& __x)
+  { return _M_t.equal_range(__x); }
+
+  template <class _Kt> requires __is_transparent<_Compare>
+  tinySTL::pair<const_iterator, const_iterator>
+  equal_range(const _Kt& __x) const
+  { return _M_t.equal_range(__x); }
+
+  /**
+   * @brief the value at index __k in key order, end() when __k >= size().
+   * @attention ranked containers only, O(log n).
+   */
+  iterator nth(size_type __k) const requires _Ranked { return _M_t.nth(__k); }
+
+  /**
+   * @brief the number of values whose keys are less than __x, O(log n).
+   * @attention ranked containers only.
+   */
+  size_type rank(const key_type& __x) const requires _Ranked { return _M_t.rank(__x); }
+
+  /**
+   * @brief the _Augment fold of the values whose keys are in [__lo, __hi),
+   *  a value-initialized one when there are none. The range is half-open
+   *  like that of for_each_in_range.
+   * @attention augmented containers only, O(log n).
+   */
+  auto fold(const key_type& __lo, const key_type& __hi) const requires (!is_same_v<_Augment, void>)
+  { return _M_t._M_fold(__lo, __hi); }
+
+  // the fold of every value, O(1).
+  auto fold() const requires (!is_same_v<_Augment, void>) { return _M_t._M_fold(); }
+
+  /**
+   * @brief move the values whose keys are not less than __x into the
+   *  returned set, O(log n) plus counting the smaller half.
+   * @attention O(log n) for ranked containers.
+   */
+  set split(const key_type& __x)
+  {
+    set __r;
+    __r._M_t = _M_t._M_split_off(__x);
+    return __r;
+  }
+
+  /**
+   * @brief append __x, whose keys must all be greater than ours, O(log n).
+   *  __x is left empty, a key out of order throws range_error.
+   */
+  void join(set&& __x) { _M_t._M_join(tinySTL::move(__x._M_t), true); }
+
+  /**
+   * @brief keep the values whose keys __x also holds, __x is left empty.
+   *  O(m log(n/m + 1)) for sizes m <= n.
+   */
+  void intersect(set&& __x) { _M_t._M_intersect_unique(tinySTL::move(__x._M_t)); }
+
+  /**
+   * @brief erase the keys __x holds, __x is left empty.
+   *  O(m log(n/m + 1)) for sizes m <= n.
+   */
+  void subtract(set&& __x) { _M_t._M_subtract_unique(tinySTL::move(__x._M_t)); }
+
   void disp(std::ostream& os) { return _M_t.disp(os); }
 
   template <class _Compare2>
-  void merge(set<_Key, _Compare2, _Alloc>& __source) 
+  void merge(set<_Key, _Compare2, _Alloc, _Ranked, _Augment>& __source) 
   { return merge(tinySTL::move(__source)); }
 
   template <class _Compare2>
-  void merge(set<_Key, _Compare2, _Alloc>&& __source) 
-  { _M_t._M_merge_unique(tinySTL::move(__source._M_t)); }
+  void merge(set<_Key, _Compare2, _Alloc, _Ranked, _Augment>&& __source) 
+  { _M_t._M_union_unique(tinySTL::move(__source._M_t)); }
 
   template <class _Compare2>
-  void merge(multiset<_Key, _Compare2, _Alloc>& __source) 
+  void merge(multiset<_Key, _Compare2, _Alloc, _Ranked, _Augment>& __source) 
   { return merge(tinySTL::move(__source)); }
 
   template <class _Compare2>
-  void merge(multiset<_Key, _Compare2, _Alloc>&& __source)
+  void merge(multiset<_Key, _Compare2, _Alloc, _Ranked, _Augment>&& __source)
   { _M_t._M_merge_unique(tinySTL::move(__source._M_t)); }
 
   friend bool operator==(const set& __x, const set& __y) 
@@ -218,11 +335,11 @@ template<class, class, class> friend class multiset;
 
 };
 
-template<class _Key, class _Compare = less<_Key>, class _Alloc = tinySTL::allocator<_Key>>
+template<class _Key, class _Compare = less<_Key>, class _Alloc = tinySTL::allocator<_Key>, bool _Ranked = false, class _Augment = void>
 class multiset {
  
-template<class, class, class> friend class set;
-template<class, class, class> friend class multiset;
+template<class, class, class, bool, class> friend class set;
+template<class, class, class, bool, class> friend class multiset;
 
  public:
   typedef _Key     key_type;
@@ -232,7 +349,7 @@ template<class, class, class> friend class multiset;
   typedef _Alloc   allocator_type;
 
  protected:
-  typedef tinySTL::_Rb_tree<key_type, value_type, _Identity<value_type>, key_compare, _Alloc>
+  typedef tinySTL::_Rb_tree<key_type, value_type, _Identity<value_type>, key_compare, _Alloc, _Ranked, _Augment>
             _Rep_type;
   _Rep_type _M_t;
  
@@ -247,6 +364,7 @@ template<class, class, class> friend class multiset;
   typedef typename _Rep_type::const_reverse_iterator const_reverse_iterator;
   typedef typename _Rep_type::size_type size_type;
   typedef typename _Rep_type::difference_type difference_type;
+  typedef _Set_node_handle<value_type, typename _Rep_type::_Node, typename _Rep_type::_Node_allocator> node_type;
 
  public:
   multiset() : _M_t() {}
@@ -335,17 +453,28 @@ template<class, class, class> friend class multiset;
 
   template<typename _InputIterator> void
   insert(_InputIterator __first, _InputIterator __last) 
-  {
-    iterator it = end();
-    for (; __first != __last; ++__first) {
-      it = insert(it, *__first);
-    }
-  }
+  { _M_t._M_insert_range_equal(__first, __last); }
 
   void insert(std::initializer_list<value_type> __l) {
     insert(__l.begin(), __l.end());
   }
 
+  /**
+   * @brief  unlink the element at __position and hand its node out.
+   */
+  node_type extract(const_iterator __position)
+  { return _M_t.template _M_extract<node_type>(__position.base()); }
+
+  // an empty handle if __k is absent; with several, the first one.
+  node_type extract(const key_type& __k)
+  { return _M_t.template _M_extract_key<node_type>(__k); }
+
+  iterator insert(node_type&& __nh)
+  { return _M_t._M_reinsert_node_equal(__nh); }
+
+  iterator insert(const_iterator __hint, node_type&& __nh)
+  { return _M_t._M_reinsert_node_hint_equal(__hint.base(), __nh); }
+
   size_type erase(const key_type& __k) 
   { return _M_t.erase(__k); }
 
@@ -357,6 +486,18 @@ template<class, class, class> friend class multiset;
 
   void clear() { _M_t.clear(); }
 
+  // lay the nodes out in key order, one after another; see _Rb_tree::compact.
+  void compact() { _M_t.compact(); }
+
+  // call __f on every element in [__lo, __hi), in order, the same
+  // half-open range as fold; see _Rb_tree::for_each_in_range.
+  template <class _Function>
+  _Function for_each_in_range(const key_type& __lo, const key_type& __hi, _Function __f) const
+  {
+    _M_t.for_each_in_range(__lo, __hi, __f);
+    return __f;
+  }
+
   size_type count(const key_type& __x) const { return _M_t.count_multi(__x); }
 
   bool contains(const key_type& __x) const { return find(__x) != end(); }
@@ -381,22 +522,98 @@ template<class, class, class> friend class multiset;
   equal_range(const key_type& __x) const 
   { return _M_t.equal_range(__x); }
 
+  template <class _Kt> requires __is_transparent<_Compare>
+  size_type count(const _Kt& __x) const { return _M_t.count_multi(__x); }
+
+  template <class _Kt> requires __is_transparent<_Compare>
+  bool contains(const _Kt& __x) const { return find(__x) != end(); }
+
+  template <class _Kt> requires __is_transparent<_Compare>
+  iterator find(const _Kt& __x) { return _M_t.find(__x); }
+
+  template <class _Kt> requires __is_transparent<_Compare>
+  const_iterator find(const _Kt& __x) const { return _M_t.find(__x); }
+
+  template <class _Kt> requires __is_transparent<_Compare>
+  iterator lower_bound(const _Kt& __x) { return _M_t.lower_bound(__x); }
+
+  template <class _Kt> requires __is_transparent<_Compare>
+  const_iterator lower_bound(const _Kt& __x) const { return _M_t.lower_bound(__x); }
+
+  template <class _Kt> requires __is_transparent<_Compare>
+  iterator upper_bound(const _Kt& __x) { return _M_t.upper_bound(__x); }
+
+  template <class _Kt> requires __is_transparent<_Compare>
+  const_iterator upper_bound(const _Kt& __x) const { return _M_t.upper_bound(__x); }
+
+  template <class _Kt> requires __is_transparent<_Compare>
+  tinySTL::pair<iterator, iterator>
+  equal_range(const _Kt& __x)
+  { return _M_t.equal_range(__x); }
+
+  template <class _Kt> requires __is_transparent<_Compare>
+  tinySTL::pair<const_iterator, const_iterator>
+  equal_range(const _Kt& __x) const
+  { return _M_t.equal_range(__x); }
+
+  /**
+   * @brief the value at index __k in key order, end() when __k >= size().
+   * @attention ranked containers only, O(log n).
+   */
+  iterator nth(size_type __k) const requires _Ranked { return _M_t.nth(__k); }
+
+  /**
+   * @brief the number of values whose keys are less than __x, O(log n).
+   * @attention ranked containers only.
+   */
+  size_type rank(const key_type& __x) const requires _Ranked { return _M_t.rank(__x); }
+
+  /**
+   * @brief the _Augment fold of the values whose keys are in [__lo, __hi),
+   *  a value-initialized one when there are none. The range is half-open
+   *  like that of for_each_in_range.
+   * @attention augmented containers only, O(log n).
+   */
+  auto fold(const key_type& __lo, const key_type& __hi) const requires (!is_same_v<_Augment, void>)
+  { return _M_t._M_fold(__lo, __hi); }
+
+  // the fold of every value, O(1).
+  auto fold() const requires (!is_same_v<_Augment, void>) { return _M_t._M_fold(); }
+
+  /**
+   * @brief move the values whose keys are not less than __x into the
+   *  returned multiset, O(log n) plus counting the smaller half.
+   * @attention O(log n) for ranked containers.
+   */
+  multiset split(const key_type& __x)
+  {
+    multiset __r;
+    __r._M_t = _M_t._M_split_off(__x);
+    return __r;
+  }
+
+  /**
+   * @brief append __x, whose keys must all follow ours, O(log n).
+   *  __x is left empty, a key out of order throws range_error.
+   */
+  void join(multiset&& __x) { _M_t._M_join(tinySTL::move(__x._M_t), false); }
+
   void disp(std::ostream& os) { return _M_t.disp(os); }
 
   template <class _Compare2>
-  void merge(set<_Key, _Compare2, _Alloc>& __source) 
+  void merge(set<_Key, _Compare2, _Alloc, _Ranked, _Augment>& __source) 
   { return merge(tinySTL::move(__source)); }
 
   template <class _Compare2>
-  void merge(set<_Key, _Compare2, _Alloc>&& __source) 
+  void merge(set<_Key, _Compare2, _Alloc, _Ranked, _Augment>&& __source) 
   { _M_t._M_merge_equal(tinySTL::move(__source._M_t)); }
 
   template <class _Compare2>
-  void merge(multiset<_Key, _Compare2, _Alloc>& __source) 
+  void merge(multiset<_Key, _Compare2, _Alloc, _Ranked, _Augment>& __source) 
   { return merge(tinySTL::move(__source)); }
 
   template <class _Compare2>
-  void merge(multiset<_Key, _Compare2, _Alloc>&& __source) 
+  void merge(multiset<_Key, _Compare2, _Alloc, _Ranked, _Augment>&& __source) 
   { _M_t._M_merge_equal(tinySTL::move(__source._M_t)); }
 
   friend bool operator==(const multiset& __x, const multiset& __y) 
@@ -423,4 +640,24 @@ template<class, class, class> friend class multiset;
 
 };
 
-}
\ No newline at end of file
+/**
+ * @brief  sets with order statistics: nth(), rank() and distance()
+ *  between iterators in O(log n), for one size_t more per node.
+ */
+template<class _Key, class _Compare = less<_Key>, class _Alloc = tinySTL::allocator<_Key>>
+using ranked_set = set<_Key, _Compare, _Alloc, true>;
+
+template<class _Key, class _Compare = less<_Key>, class _Alloc = tinySTL::allocator<_Key>>
+using ranked_multiset = multiset<_Key, _Compare, _Alloc, true>;
+
+/**
+ * @brief  sets keeping an _Augment fold, such as range_sum, in every node:
+ *  fold() over a key range in O(log n).
+ */
+template<class _Key, class _Augment, class _Compare = less<_Key>, class _Alloc = tinySTL::allocator<_Key>>
+using augmented_set = set<_Key, _Compare, _Alloc, false, _Augment>;
+
+template<class _Key, class _Augment, class _Compare = less<_Key>, class _Alloc = tinySTL::allocator<_Key>>
+using augmented_multiset = multiset<_Key, _Compare, _Alloc, false, _Augment>;
+
+}
@@ -42,12 +42,6 @@ inline void swap(_Tp& __a, _Tp& __b) {
 // fill.
 ////////////////////////////////////////////////////////////////////////////
 
-template <Iterable _ForwardIter, class _Tp>
-void fill(_ForwardIter __first, _ForwardIter __last, const _Tp& __value) {
-  for ( ; __first != __last; ++__first)
-    *__first = __value;
-}
-
 inline void fill(unsigned char* __first, unsigned char* __last,
                  const unsigned char& __c) {
   unsigned char __tmp = __c;
@@ -65,6 +59,40 @@ inline void fill(char* __first, char* __last, const char& __c) {
   memset(__first, static_cast<unsigned char>(__tmp), __last - __first);
 }
 
+template <class _ForwardIter, class _Tp>
+void __fill(_ForwardIter __first, _ForwardIter __last, const _Tp& __value,
+            false_type) {
+  for ( ; __first != __last; ++__first)
+    *__first = __value;
+}
+
+template <class _ForwardIter, class _Tp>
+void __fill(_ForwardIter __first, _ForwardIter __last, const _Tp& __value,
+            true_type);
+
+template <Iterable _ForwardIter, class _Tp>
+void fill(_ForwardIter __first, _ForwardIter __last, const _Tp& __value) {
+  tinySTL::__fill(__first, __last, __value,
+                  __is_segmented_iterator<_ForwardIter>());
+}
+
+// segmented version, fill one contiguous block at a time.
+template <class _ForwardIter, class _Tp>
+void __fill(_ForwardIter __first, _ForwardIter __last, const _Tp& __value,
+            true_type) {
+  typedef __segmented_iterator_traits<_ForwardIter> _Traits;
+  auto __sfirst = _Traits::__segment(__first);
+  auto __slast = _Traits::__segment(__last);
+  if (__sfirst == __slast) {
+    tinySTL::fill(_Traits::__local(__first), _Traits::__local(__last), __value);
+    return;
+  }
+  tinySTL::fill(_Traits::__local(__first), _Traits::__end(__sfirst), __value);
+  for (++__sfirst; __sfirst != __slast; ++__sfirst)
+    tinySTL::fill(_Traits::__begin(__sfirst), _Traits::__end(__sfirst), __value);
+  tinySTL::fill(_Traits::__begin(__slast), _Traits::__local(__last), __value);
+}
+
 ////////////////////////////////////////////////////////////////////////////
 // fill_n.
 ////////////////////////////////////////////////////////////////////////////
@@ -158,8 +186,8 @@ struct __copy_dispatch<const _Tp*, _Tp*, true_type>
 };
 
 template <class _InputIter, class _OutputIter>
-inline _OutputIter copy(_InputIter __first, _InputIter __last,
-                        _OutputIter __result) {
+inline _OutputIter __copy_aux(_InputIter __first, _InputIter __last,
+                              _OutputIter __result) {
   typedef typename iterator_traits<_OutputIter>::value_type _Tp;
   typedef typename type_traits<_Tp>::has_trivial_copy_operator
                    _Trivial;
@@ -167,6 +195,81 @@ inline _OutputIter copy(_InputIter __first, _InputIter __last,
     ::copy(__first, __last, __result);
 }
 
+template <class _InputIter, class _OutputIter>
+inline _OutputIter __copy_segmented(_InputIter __first, _InputIter __last,
+                                    _OutputIter __result,
+                                    false_type, false_type) {
+  return tinySTL::__copy_aux(__first, __last, __result);
+}
+
+template <class _InputIter, class _OutputIter, class _BoolType>
+_OutputIter __copy_segmented(_InputIter __first, _InputIter __last,
+                             _OutputIter __result, true_type, _BoolType);
+
+template <class _InputIter, class _OutputIter>
+_OutputIter __copy_segmented(_InputIter __first, _InputIter __last,
+                             _OutputIter __result, false_type, true_type);
+
+template <class _InputIter, class _OutputIter>
+inline _OutputIter copy(_InputIter __first, _InputIter __last,
+                        _OutputIter __result) {
+  return tinySTL::__copy_segmented(__first, __last, __result,
+                                   __is_segmented_iterator<_InputIter>(),
+                                   __is_segmented_iterator<_OutputIter>());
+}
+
+// segmented source, copy each block of the source on its local iterators.
+template <class _InputIter, class _OutputIter, class _BoolType>
+_OutputIter __copy_segmented(_InputIter __first, _InputIter __last,
+                             _OutputIter __result, true_type, _BoolType) {
+  typedef __segmented_iterator_traits<_InputIter> _Traits;
+  auto __sfirst = _Traits::__segment(__first);
+  auto __slast = _Traits::__segment(__last);
+  if (__sfirst == __slast)
+    return tinySTL::copy(_Traits::__local(__first), _Traits::__local(__last), __result);
+  __result = tinySTL::copy(_Traits::__local(__first), _Traits::__end(__sfirst), __result);
+  for (++__sfirst; __sfirst != __slast; ++__sfirst)
+    __result = tinySTL::copy(_Traits::__begin(__sfirst), _Traits::__end(__sfirst), __result);
+  return tinySTL::copy(_Traits::__begin(__slast), _Traits::__local(__last), __result);
+}
+
+template <class _InputIter, class _OutputIter>
+inline _OutputIter __copy_to_segments(_InputIter __first, _InputIter __last,
+                                      _OutputIter __result, input_iterator_tag) {
+  return tinySTL::__copy_aux(__first, __last, __result);
+}
+
+template <class _RandomAccessIter, class _OutputIter>
+_OutputIter __copy_to_segments(_RandomAccessIter __first, _RandomAccessIter __last,
+                               _OutputIter __result, random_access_iterator_tag) {
+  typedef __segmented_iterator_traits<_OutputIter> _Traits;
+  auto __n = __last - __first;
+  if (__n <= 0)
+    return __result;
+  auto __seg = _Traits::__segment(__result);
+  auto __local = _Traits::__local(__result);
+  for (;;) {
+    auto __len = _Traits::__end(__seg) - __local;
+    if (__n < __len)
+      __len = __n;
+    __local = tinySTL::copy(__first, __first + __len, __local);
+    __first += __len;
+    __n -= __len;
+    if (__n == 0)
+      return _Traits::__compose(__seg, __local);
+    ++__seg;
+    __local = _Traits::__begin(__seg);
+  }
+}
+
+// segmented destination, fill each block of the destination in one call.
+template <class _InputIter, class _OutputIter>
+_OutputIter __copy_segmented(_InputIter __first, _InputIter __last,
+                             _OutputIter __result, false_type, true_type) {
+  return tinySTL::__copy_to_segments(__first, __last, __result,
+                                     iterator_category(__first));
+}
+
 
 ////////////////////////////////////////////////////////////////////////////
 // move.
@@ -214,8 +317,8 @@ struct __move_dispatch<_Tp*, _Tp*, true_type>
 };
 
 template <class _ForwardIter1, class _ForwardIter2>
-inline _ForwardIter2 move(_ForwardIter1 __first, _ForwardIter1 __last,
-                          _ForwardIter2 __result) {
+inline _ForwardIter2 __move_aux(_ForwardIter1 __first, _ForwardIter1 __last,
+                                _ForwardIter2 __result) {
   typedef typename iterator_traits<_ForwardIter2>::value_type _Tp;
   typedef typename type_traits<_Tp>::has_trivial_move_operator
                    _Trivial;
@@ -223,6 +326,79 @@ inline _ForwardIter2 move(_ForwardIter1 __first, _ForwardIter1 __last,
     ::move(__first, __last, __result);
 }
 
+template <class _ForwardIter1, class _ForwardIter2>
+inline _ForwardIter2 __move_segmented(_ForwardIter1 __first, _ForwardIter1 __last,
+                                      _ForwardIter2 __result,
+                                      false_type, false_type) {
+  return tinySTL::__move_aux(__first, __last, __result);
+}
+
+template <class _ForwardIter1, class _ForwardIter2, class _BoolType>
+_ForwardIter2 __move_segmented(_ForwardIter1 __first, _ForwardIter1 __last,
+                               _ForwardIter2 __result, true_type, _BoolType);
+
+template <class _ForwardIter1, class _ForwardIter2>
+_ForwardIter2 __move_segmented(_ForwardIter1 __first, _ForwardIter1 __last,
+                               _ForwardIter2 __result, false_type, true_type);
+
+template <class _ForwardIter1, class _ForwardIter2>
+inline _ForwardIter2 move(_ForwardIter1 __first, _ForwardIter1 __last,
+                          _ForwardIter2 __result) {
+  return tinySTL::__move_segmented(__first, __last, __result,
+                                   __is_segmented_iterator<_ForwardIter1>(),
+                                   __is_segmented_iterator<_ForwardIter2>());
+}
+
+template <class _ForwardIter1, class _ForwardIter2, class _BoolType>
+_ForwardIter2 __move_segmented(_ForwardIter1 __first, _ForwardIter1 __last,
+                               _ForwardIter2 __result, true_type, _BoolType) {
+  typedef __segmented_iterator_traits<_ForwardIter1> _Traits;
+  auto __sfirst = _Traits::__segment(__first);
+  auto __slast = _Traits::__segment(__last);
+  if (__sfirst == __slast)
+    return tinySTL::move(_Traits::__local(__first), _Traits::__local(__last), __result);
+  __result = tinySTL::move(_Traits::__local(__first), _Traits::__end(__sfirst), __result);
+  for (++__sfirst; __sfirst != __slast; ++__sfirst)
+    __result = tinySTL::move(_Traits::__begin(__sfirst), _Traits::__end(__sfirst), __result);
+  return tinySTL::move(_Traits::__begin(__slast), _Traits::__local(__last), __result);
+}
+
+template <class _ForwardIter1, class _ForwardIter2>
+inline _ForwardIter2 __move_to_segments(_ForwardIter1 __first, _ForwardIter1 __last,
+                                        _ForwardIter2 __result, input_iterator_tag) {
+  return tinySTL::__move_aux(__first, __last, __result);
+}
+
+template <class _RandomAccessIter, class _ForwardIter>
+_ForwardIter __move_to_segments(_RandomAccessIter __first, _RandomAccessIter __last,
+                                _ForwardIter __result, random_access_iterator_tag) {
+  typedef __segmented_iterator_traits<_ForwardIter> _Traits;
+  auto __n = __last - __first;
+  if (__n <= 0)
+    return __result;
+  auto __seg = _Traits::__segment(__result);
+  auto __local = _Traits::__local(__result);
+  for (;;) {
+    auto __len = _Traits::__end(__seg) - __local;
+    if (__n < __len)
+      __len = __n;
+    __local = tinySTL::move(__first, __first + __len, __local);
+    __first += __len;
+    __n -= __len;
+    if (__n == 0)
+      return _Traits::__compose(__seg, __local);
+    ++__seg;
+    __local = _Traits::__begin(__seg);
+  }
+}
+
+template <class _ForwardIter1, class _ForwardIter2>
+_ForwardIter2 __move_segmented(_ForwardIter1 __first, _ForwardIter1 __last,
+                               _ForwardIter2 __result, false_type, true_type) {
+  return tinySTL::__move_to_segments(__first, __last, __result,
+                                     iterator_category(__first));
+}
+
 
 ////////////////////////////////////////////////////////////////////////////
 // copy_n.
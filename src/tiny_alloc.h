@@ -3,9 +3,11 @@
 #pragma once
 #include <cstddef>
 #include <mutex>
+#include <atomic>
 #include <string.h>
 #include <inttypes.h>
 #include <stdexcept>
+#include <utility>
 
 // defination of throw bad alloc.
 #ifndef __THROW_BAD_ALLOC
@@ -88,6 +90,15 @@ class simple_alloc {
     return (_Tp*) _Alloc::allocate(sizeof (_Tp)); 
   }
 
+  // up to __n objects in one contiguous run, each freed on its own with
+  // deallocate(p, 1); __n is set to the number given.
+  pointer allocate_run(size_type& __n)
+    requires (sizeof (_Tp) % sizeof (void*) == 0)
+          && requires (size_t& __k) { _Alloc::allocate_run(sizeof (_Tp), __k); }
+  {
+    return (_Tp*) _Alloc::allocate_run(sizeof (_Tp), __n);
+  }
+
   void deallocate(pointer __p, size_type __n) { 
     if (0 != __n) _Alloc::deallocate(__p, __n * sizeof (_Tp)); 
   }
@@ -295,6 +306,35 @@ class __default_alloc_template {
     return __ret;
   };
 
+  /**
+   * @brief  up to __nobjs objects of __n bytes laid out one after another,
+   *  __nobjs is set to the number given. Each is freed on its own with
+   *  deallocate(p, __n). What is left of the current chunk is used first,
+   *  then the run gets a block of its own rather than a chunk twice its
+   *  size. Over _MAX_BYTES a run is a single object.
+   */
+  static void* allocate_run(size_t __n, size_t& __nobjs) {
+    if (__n > (size_t) _MAX_BYTES || __nobjs <= 1) {
+      __nobjs = 1;
+      return allocate(__n);
+    }
+    std::lock_guard<std::mutex> guard(_S_mutex);
+    size_t __size = _S_round_up(__n);
+    size_t __bytes_left = _S_end_free - _S_start_free;
+    if (__bytes_left < __size) {
+      size_t __bytes = __size * __nobjs;
+      char* __result = (char*)malloc_alloc::allocate(__bytes);
+      _S_add_malloc_ptr(__result);
+      _S_heap_size += __bytes;
+      return __result;
+    }
+    if (__nobjs > __bytes_left / __size)
+      __nobjs = __bytes_left / __size;
+    char* __result = _S_start_free;
+    _S_start_free += __size * __nobjs;
+    return __result;
+  }
+
   static void deallocate(void* __p, size_t __n) {
     if (__n > (size_t) _MAX_BYTES)
       malloc_alloc::deallocate(__p, __n);
@@ -335,6 +375,64 @@ typedef __default_alloc_template<0> alloc;
 template <class _Tp>
 using allocator = simple_alloc<_Tp, alloc>;
 
+// ask for the cache line at __p ahead of a read, for walks over nodes
+// whose next addresses are known a few steps before they are needed.
+inline void __tiny_prefetch(const void* __p) noexcept
+{
+#if defined(__GNUC__) || defined(__clang__)
+  __builtin_prefetch(__p);
+#else
+  (void)__p;
+#endif
+}
+
+/**
+ * @brief  the next __n nodes a container builds, carved from as few
+ *  contiguous runs as its allocator hands out, so nodes built one after
+ *  another lie one after another. Allocators without allocate_run give
+ *  them one at a time. Every node is freed on its own as usual; those
+ *  never taken go back with _M_release().
+ */
+template <class _Alloc>
+class _Node_run
+{
+  typedef decltype(std::declval<_Alloc&>().allocate(size_t(1))) pointer;
+
+  _Alloc& _M_alloc;
+  pointer _M_cur;
+  size_t _M_avail;
+  size_t _M_need;
+
+ public:
+  _Node_run(_Alloc& __a, size_t __n) noexcept
+  : _M_alloc(__a), _M_cur(0), _M_avail(0), _M_need(__n)
+  { }
+
+  _Node_run(const _Node_run&) = delete;
+
+  pointer _M_take()
+  {
+    if (_M_avail == 0) {
+      if constexpr (requires (size_t& __k) { _M_alloc.allocate_run(__k); }) {
+        _M_avail = _M_need;
+        _M_cur = _M_alloc.allocate_run(_M_avail);
+      } else {
+        _M_avail = 1;
+        _M_cur = _M_alloc.allocate(1);
+      }
+    }
+    --_M_avail;
+    --_M_need;
+    return _M_cur++;
+  }
+
+  void _M_release() noexcept
+  {
+    for (; _M_avail != 0; --_M_avail)
+      _M_alloc.deallocate(_M_cur++, 1);
+  }
+};
+
 template <typename _Tp, typename _Up>
 struct _Alloc_rebind {};
 
@@ -0,0 +1,1018 @@
+// tinySTL: adaptive radix tree, the base of radix_map.
+#pragma once
+
+#include <cstdint>
+#include <cstring>
+#include <string_view>
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+#include "tiny_pair.h"
+#include "tiny_alloc.h"
+#include "tiny_errors.h"
+#include "tiny_iterator.h"
+#include "tiny_algobase.h"
+#include "tiny_construct.h"
+
+namespace tinySTL
+{
+
+enum class _Art_type : unsigned char
+{ _S_leaf, _S_node4, _S_node16, _S_node48, _S_node256 };
+
+// what leaves and inner nodes share: which one it is.
+struct _Art_node
+{
+  _Art_type _M_type;
+};
+
+// the leaves in key order, on a circular list through the tree's header.
+struct _Art_links
+{
+  _Art_links* _M_prev;
+  _Art_links* _M_next;
+};
+
+template <class _Val>
+struct _Art_leaf : public _Art_node, public _Art_links
+{
+  aligned_membuf<_Val> _M_storage;
+
+  _Val* _M_valptr() noexcept { return _M_storage.ptr(); }
+
+  const _Val* _M_valptr() const noexcept { return _M_storage.ptr(); }
+};
+
+/**
+ * @brief  the part every inner node has. The key bytes between the
+ *  parent's byte and this node form a compressed path of _M_prefix_len
+ *  bytes; the first _S_prefix of them are kept here, the rest are read
+ *  off any leaf below. _M_value is the leaf whose key ends right after
+ *  the path, it sorts before everything in the children.
+ */
+struct _Art_inner : public _Art_node
+{
+  static constexpr size_t _S_prefix = 8;
+
+  uint16_t _M_count;
+  uint32_t _M_prefix_len;
+  unsigned char _M_prefix[_S_prefix];
+  _Art_node* _M_value;
+};
+
+// up to 4 children, keys sorted.
+struct _Art_node4 : public _Art_inner
+{
+  static constexpr _Art_type _S_type = _Art_type::_S_node4;
+  static constexpr size_t _S_capacity = 4;
+  unsigned char _M_keys[4];
+  _Art_node* _M_child[4];
+};
+
+// up to 16 children, keys sorted and searched 16 at a time.
+struct _Art_node16 : public _Art_inner
+{
+  static constexpr _Art_type _S_type = _Art_type::_S_node16;
+  static constexpr size_t _S_capacity = 16;
+  unsigned char _M_keys[16];
+  _Art_node* _M_child[16];
+};
+
+// up to 48 children, found through a byte-indexed table of slot + 1.
+struct _Art_node48 : public _Art_inner
+{
+  static constexpr _Art_type _S_type = _Art_type::_S_node48;
+  static constexpr size_t _S_capacity = 48;
+  unsigned char _M_index[256];
+  _Art_node* _M_child[48];
+};
+
+// a child for every byte.
+struct _Art_node256 : public _Art_inner
+{
+  static constexpr _Art_type _S_type = _Art_type::_S_node256;
+  static constexpr size_t _S_capacity = 256;
+  _Art_node* _M_child[256];
+};
+
+/**
+ * @brief  iterator of _Art_tree, a walk along the leaf list. end() is
+ *  the tree's header.
+ */
+template <class _Val>
+struct _Art_iterator
+{
+  typedef _Val value_type;
+  typedef value_type& reference;
+  typedef value_type* pointer;
+
+  typedef bidirectional_iterator_tag iterator_category;
+  typedef ptrdiff_t       difference_type;
+
+  typedef _Art_iterator<_Val> _Self;
+
+  _Art_links* _M_node;
+
+  _Art_iterator() noexcept : _M_node(0) { }
+
+  explicit _Art_iterator(const _Art_links* __x) noexcept
+  : _M_node(const_cast<_Art_links*>(__x)) { }
+
+  reference operator*() const noexcept
+  { return *static_cast<_Art_leaf<_Val>*>(_M_node)->_M_valptr(); }
+
+  pointer operator->() const noexcept
+  { return static_cast<_Art_leaf<_Val>*>(_M_node)->_M_valptr(); }
+
+  _Self& operator++() noexcept
+  {
+    _M_node = _M_node->_M_next;
+    return *this;
+  }
+
+  _Self operator++(int) noexcept
+  {
+    _Self __tmp = *this;
+    _M_node = _M_node->_M_next;
+    return __tmp;
+  }
+
+  _Self& operator--() noexcept
+  {
+    _M_node = _M_node->_M_prev;
+    return *this;
+  }
+
+  _Self operator--(int) noexcept
+  {
+    _Self __tmp = *this;
+    _M_node = _M_node->_M_prev;
+    return __tmp;
+  }
+
+  friend bool operator==(const _Self& __x, const _Self& __y) noexcept
+  { return __x._M_node == __y._M_node; }
+
+  friend bool operator!=(const _Self& __x, const _Self& __y) noexcept
+  { return __x._M_node != __y._M_node; }
+};
+
+/**
+ * @brief  an adaptive radix tree over byte-string keys. A lookup reads
+ *  the key one byte per level, never comparing whole keys until the one
+ *  leaf it lands on. Inner nodes come in four sizes and grow or shrink
+ *  with their number of children, and chains of single-child nodes are
+ *  compressed into a path stored in the node below them. The leaves are
+ *  also kept on a list in key order, which is what iterators walk.
+ * @attention  _KeyOfValue gives something std::string_view is made from.
+ *  Keys compare byte by byte as unsigned char, like std::string.
+ *  Insert and erase never move a leaf, so they only invalidate iterators
+ *  to erased elements.
+ */
+template <class _Val, class _KeyOfValue, class _Alloc = tinySTL::allocator<_Val>>
+class _Art_tree
+{
+
+template <class, class> friend class radix_map;
+
+ protected:
+  typedef _Art_leaf<_Val> _Leaf;
+  typedef typename _Alloc_rebind<_Alloc, _Leaf>::type _Leaf_allocator;
+
+ protected:
+  typedef std::string_view key_type;
+  typedef _Val value_type;
+  typedef value_type* pointer;
+  typedef const value_type* const_pointer;
+  typedef value_type& reference;
+  typedef const value_type& const_reference;
+  typedef size_t size_type;
+  typedef ptrdiff_t difference_type;
+  typedef _Alloc allocator_type;
+  typedef _Art_iterator<_Val> iterator;
+  typedef tinySTL::const_iterator<iterator> const_iterator;
+  typedef tinySTL::reverse_iterator<const_iterator> const_reverse_iterator;
+  typedef tinySTL::reverse_iterator<iterator> reverse_iterator;
+
+ protected:
+  _Art_node* _M_root;
+  _Art_links _M_head;
+  size_type _M_count;
+  _Leaf_allocator _M_leaf_allocator;
+
+  static std::string_view _S_key(const _Art_node* __x) noexcept
+  { return std::string_view(_KeyOfValue()(*static_cast<const _Leaf*>(__x)->_M_valptr())); }
+
+  static _Leaf* _S_leaf(_Art_node* __x) noexcept { return static_cast<_Leaf*>(__x); }
+
+  static _Leaf* _S_leaf(_Art_links* __x) noexcept { return static_cast<_Leaf*>(__x); }
+
+  static _Art_inner* _S_inner(_Art_node* __x) noexcept { return static_cast<_Art_inner*>(__x); }
+
+  static bool _S_is_leaf(const _Art_node* __x) noexcept
+  { return __x->_M_type == _Art_type::_S_leaf; }
+
+  static void _S_link_before(_Art_links* __pos, _Art_links* __x) noexcept
+  {
+    __x->_M_next = __pos;
+    __x->_M_prev = __pos->_M_prev;
+    __pos->_M_prev->_M_next = __x;
+    __pos->_M_prev = __x;
+  }
+
+  static void _S_unlink(_Art_links* __x) noexcept
+  {
+    __x->_M_prev->_M_next = __x->_M_next;
+    __x->_M_next->_M_prev = __x->_M_prev;
+  }
+
+  // leaves.
+
+  template <class... _Args>
+  _Leaf* _M_create_leaf(_Args&&... __args)
+  {
+    _Leaf* __z = _M_leaf_allocator.allocate(1);
+    __z->_M_type = _Art_type::_S_leaf;
+    try {
+      tinySTL::construct(__z->_M_valptr(), tinySTL::forward<_Args>(__args)...);
+    } catch (...) {
+      _M_leaf_allocator.deallocate(__z, 1);
+      throw;
+    }
+    return __z;
+  }
+
+  void _M_drop_leaf(_Leaf* __z) noexcept
+  {
+    tinySTL::destroy(__z->_M_valptr());
+    _M_leaf_allocator.deallocate(__z, 1);
+  }
+
+  // inner nodes.
+
+  template <class _Node>
+  _Node* _M_create_node()
+  {
+    typename _Alloc_rebind<_Alloc, _Node>::type __a;
+    _Node* __n = __a.allocate(1);
+    tinySTL::construct(__n);
+    __n->_M_type = _Node::_S_type;
+    return __n;
+  }
+
+  template <class _Node>
+  void _M_free(_Node* __n) noexcept
+  {
+    typename _Alloc_rebind<_Alloc, _Node>::type __a;
+    __a.deallocate(__n, 1);
+  }
+
+  void _M_free_node(_Art_inner* __n) noexcept
+  {
+    switch (__n->_M_type) {
+      case _Art_type::_S_node4:  _M_free(static_cast<_Art_node4*>(__n)); break;
+      case _Art_type::_S_node16: _M_free(static_cast<_Art_node16*>(__n)); break;
+      case _Art_type::_S_node48: _M_free(static_cast<_Art_node48*>(__n)); break;
+      default:                   _M_free(static_cast<_Art_node256*>(__n)); break;
+    }
+  }
+
+  // the slot of the child of __n at byte __c, null if there is none.
+  static _Art_node** _S_find_child(_Art_inner* __n, unsigned char __c) noexcept
+  {
+    switch (__n->_M_type) {
+      case _Art_type::_S_node4: {
+        _Art_node4* __p = static_cast<_Art_node4*>(__n);
+        for (unsigned __i = 0; __i < __p->_M_count; ++__i)
+          if (__p->_M_keys[__i] == __c)
+            return &__p->_M_child[__i];
+        return nullptr;
+      }
+      case _Art_type::_S_node16: {
+        _Art_node16* __p = static_cast<_Art_node16*>(__n);
+#if defined(__SSE2__)
+        __m128i __eq = _mm_cmpeq_epi8(_mm_set1_epi8((char)__c),
+                                      _mm_loadu_si128((const __m128i*)__p->_M_keys));
+        unsigned __bits = (unsigned)_mm_movemask_epi8(__eq) & ((1u << __p->_M_count) - 1);
+        return __bits ? &__p->_M_child[__builtin_ctz(__bits)] : nullptr;
+#else
+        for (unsigned __i = 0; __i < __p->_M_count; ++__i)
+          if (__p->_M_keys[__i] == __c)
+            return &__p->_M_child[__i];
+        return nullptr;
+#endif
+      }
+      case _Art_type::_S_node48: {
+        _Art_node48* __p = static_cast<_Art_node48*>(__n);
+        return __p->_M_index[__c] ? &__p->_M_child[__p->_M_index[__c] - 1] : nullptr;
+      }
+      default: {
+        _Art_node256* __p = static_cast<_Art_node256*>(__n);
+        return __p->_M_child[__c] ? &__p->_M_child[__c] : nullptr;
+      }
+    }
+  }
+
+  /**
+   * @brief  the first child of __n at a byte above __c, null if there is
+   *  none; -1 asks for the first child. Its byte goes to *__byte.
+   */
+  static _Art_node* _S_child_after(const _Art_inner* __n, int __c, unsigned char* __byte = nullptr) noexcept
+  {
+    auto __sorted = [&](const unsigned char* __keys, _Art_node* const* __child) -> _Art_node* {
+      for (unsigned __i = 0; __i < __n->_M_count; ++__i) {
+        if (__keys[__i] > __c) {
+          if (__byte) *__byte = __keys[__i];
+          return __child[__i];
+        }
+      }
+      return nullptr;
+    };
+    switch (__n->_M_type) {
+      case _Art_type::_S_node4: {
+        const _Art_node4* __p = static_cast<const _Art_node4*>(__n);
+        return __sorted(__p->_M_keys, __p->_M_child);
+      }
+      case _Art_type::_S_node16: {
+        const _Art_node16* __p = static_cast<const _Art_node16*>(__n);
+        return __sorted(__p->_M_keys, __p->_M_child);
+      }
+      case _Art_type::_S_node48: {
+        const _Art_node48* __p = static_cast<const _Art_node48*>(__n);
+        for (int __b = __c + 1; __b < 256; ++__b) {
+          if (__p->_M_index[__b]) {
+            if (__byte) *__byte = (unsigned char)__b;
+            return __p->_M_child[__p->_M_index[__b] - 1];
+          }
+        }
+        return nullptr;
+      }
+      default: {
+        const _Art_node256* __p = static_cast<const _Art_node256*>(__n);
+        for (int __b = __c + 1; __b < 256; ++__b) {
+          if (__p->_M_child[__b]) {
+            if (__byte) *__byte = (unsigned char)__b;
+            return __p->_M_child[__b];
+          }
+        }
+        return nullptr;
+      }
+    }
+  }
+
+  static _Art_node* _S_last_child(const _Art_inner* __n) noexcept
+  {
+    switch (__n->_M_type) {
+      case _Art_type::_S_node4:
+        return static_cast<const _Art_node4*>(__n)->_M_child[__n->_M_count - 1];
+      case _Art_type::_S_node16:
+        return static_cast<const _Art_node16*>(__n)->_M_child[__n->_M_count - 1];
+      case _Art_type::_S_node48: {
+        const _Art_node48* __p = static_cast<const _Art_node48*>(__n);
+        for (int __b = 255; ; --__b)
+          if (__p->_M_index[__b])
+            return __p->_M_child[__p->_M_index[__b] - 1];
+      }
+      default: {
+        const _Art_node256* __p = static_cast<const _Art_node256*>(__n);
+        for (int __b = 255; ; --__b)
+          if (__p->_M_child[__b])
+            return __p->_M_child[__b];
+      }
+    }
+  }
+
+  // the first and the last leaf under __x.
+  static _Leaf* _S_minimum(_Art_node* __x) noexcept
+  {
+    while (!_S_is_leaf(__x)) {
+      _Art_inner* __n = _S_inner(__x);
+      if (__n->_M_value != nullptr)
+        return _S_leaf(__n->_M_value);
+      __x = _S_child_after(__n, -1);
+    }
+    return _S_leaf(__x);
+  }
+
+  static _Leaf* _S_maximum(_Art_node* __x) noexcept
+  {
+    while (!_S_is_leaf(__x)) {
+      _Art_inner* __n = _S_inner(__x);
+      __x = __n->_M_count ? _S_last_child(__n) : __n->_M_value;
+    }
+    return _S_leaf(__x);
+  }
+
+  // add a child to __n, which has room for it.
+  static void _S_add_child(_Art_inner* __n, unsigned char __c, _Art_node* __child) noexcept
+  {
+    auto __sorted = [&](unsigned char* __keys, _Art_node** __children) {
+      unsigned __i = __n->_M_count;
+      for (; __i > 0 && __keys[__i - 1] > __c; --__i) {
+        __keys[__i] = __keys[__i - 1];
+        __children[__i] = __children[__i - 1];
+      }
+      __keys[__i] = __c;
+      __children[__i] = __child;
+    };
+    switch (__n->_M_type) {
+      case _Art_type::_S_node4: {
+        _Art_node4* __p = static_cast<_Art_node4*>(__n);
+        __sorted(__p->_M_keys, __p->_M_child);
+        break;
+      }
+      case _Art_type::_S_node16: {
+        _Art_node16* __p = static_cast<_Art_node16*>(__n);
+        __sorted(__p->_M_keys, __p->_M_child);
+        break;
+      }
+      case _Art_type::_S_node48: {
+        _Art_node48* __p = static_cast<_Art_node48*>(__n);
+        unsigned __slot = 0;
+        while (__p->_M_child[__slot] != nullptr)
+          ++__slot;
+        __p->_M_child[__slot] = __child;
+        __p->_M_index[__c] = (unsigned char)(__slot + 1);
+        break;
+      }
+      default:
+        static_cast<_Art_node256*>(__n)->_M_child[__c] = __child;
+    }
+    ++__n->_M_count;
+  }
+
+  static void _S_remove_child(_Art_inner* __n, unsigned char __c) noexcept
+  {
+    auto __sorted = [&](unsigned char* __keys, _Art_node** __children) {
+      unsigned __i = 0;
+      while (__keys[__i] != __c)
+        ++__i;
+      for (; __i + 1 < __n->_M_count; ++__i) {
+        __keys[__i] = __keys[__i + 1];
+        __children[__i] = __children[__i + 1];
+      }
+    };
+    switch (__n->_M_type) {
+      case _Art_type::_S_node4: {
+        _Art_node4* __p = static_cast<_Art_node4*>(__n);
+        __sorted(__p->_M_keys, __p->_M_child);
+        break;
+      }
+      case _Art_type::_S_node16: {
+        _Art_node16* __p = static_cast<_Art_node16*>(__n);
+        __sorted(__p->_M_keys, __p->_M_child);
+        break;
+      }
+      case _Art_type::_S_node48: {
+        _Art_node48* __p = static_cast<_Art_node48*>(__n);
+        __p->_M_child[__p->_M_index[__c] - 1] = nullptr;
+        __p->_M_index[__c] = 0;
+        break;
+      }
+      default:
+        static_cast<_Art_node256*>(__n)->_M_child[__c] = nullptr;
+    }
+    --__n->_M_count;
+  }
+
+  // __ref's node again as a _Node, which holds all its children.
+  template <class _Node>
+  void _M_resize(_Art_node*& __ref)
+  {
+    _Art_inner* __old = _S_inner(__ref);
+    _Node* __n = _M_create_node<_Node>();
+    __n->_M_prefix_len = __old->_M_prefix_len;
+    memcpy(__n->_M_prefix, __old->_M_prefix, _Art_inner::_S_prefix);
+    __n->_M_value = __old->_M_value;
+    unsigned char __b = 0;
+    for (_Art_node* __x = _S_child_after(__old, -1, &__b); __x != nullptr;
+         __x = _S_child_after(__old, __b, &__b))
+      _S_add_child(__n, __b, __x);
+    __ref = __n;
+    _M_free_node(__old);
+  }
+
+  // add a child to the node at __ref, moving it to a bigger node if full.
+  void _M_add_child(_Art_node*& __ref, unsigned char __c, _Art_node* __child)
+  {
+    _Art_inner* __n = _S_inner(__ref);
+    switch (__n->_M_type) {
+      case _Art_type::_S_node4:
+        if (__n->_M_count == _Art_node4::_S_capacity)
+          _M_resize<_Art_node16>(__ref);
+        break;
+      case _Art_type::_S_node16:
+        if (__n->_M_count == _Art_node16::_S_capacity)
+          _M_resize<_Art_node48>(__ref);
+        break;
+      case _Art_type::_S_node48:
+        if (__n->_M_count == _Art_node48::_S_capacity)
+          _M_resize<_Art_node256>(__ref);
+        break;
+      default:
+        break;
+    }
+    _S_add_child(_S_inner(__ref), __c, __child);
+  }
+
+  /**
+   * @brief  after a removal from the node at __ref: a node left with its
+   *  own leaf only becomes that leaf, one left with a single child and no
+   *  leaf merges its path into the child, and a sparse node moves to a
+   *  smaller size if memory for it can be had.
+   */
+  void _M_shrink(_Art_node*& __ref) noexcept
+  {
+    _Art_inner* __n = _S_inner(__ref);
+    if (__n->_M_count == 0) {
+      __ref = __n->_M_value;
+      _M_free_node(__n);
+      return;
+    }
+    if (__n->_M_count == 1 && __n->_M_value == nullptr) {
+      unsigned char __c = 0;
+      _Art_node* __child = _S_child_after(__n, -1, &__c);
+      if (!_S_is_leaf(__child)) {
+        _Art_inner* __m = _S_inner(__child);
+        unsigned char __path[_Art_inner::_S_prefix];
+        size_t __len = __n->_M_prefix_len + 1 + __m->_M_prefix_len;
+        for (size_t __i = 0; __i < _Art_inner::_S_prefix && __i < __len; ++__i) {
+          if (__i < __n->_M_prefix_len)
+            __path[__i] = __n->_M_prefix[__i];
+          else if (__i == __n->_M_prefix_len)
+            __path[__i] = __c;
+          else
+            __path[__i] = __m->_M_prefix[__i - __n->_M_prefix_len - 1];
+        }
+        __m->_M_prefix_len = (uint32_t)__len;
+        memcpy(__m->_M_prefix, __path, _Art_inner::_S_prefix);
+      }
+      __ref = __child;
+      _M_free_node(__n);
+      return;
+    }
+    try {
+      if (__n->_M_type == _Art_type::_S_node16 && __n->_M_count <= 3)
+        _M_resize<_Art_node4>(__ref);
+      else if (__n->_M_type == _Art_type::_S_node48 && __n->_M_count <= 12)
+        _M_resize<_Art_node16>(__ref);
+      else if (__n->_M_type == _Art_type::_S_node256 && __n->_M_count <= 40)
+        _M_resize<_Art_node48>(__ref);
+    } catch (...) {
+      // no memory for the smaller node, the bigger one does as well.
+    }
+  }
+
+  // byte __i of the path of __n, which starts at byte __depth of the keys.
+  static unsigned char _S_path_at(_Art_inner* __n, size_t __depth, size_t __i) noexcept
+  {
+    if (__i < _Art_inner::_S_prefix)
+      return __n->_M_prefix[__i];
+    return (unsigned char)_S_key(_S_minimum(__n))[__depth + __i];
+  }
+
+  // how many bytes of the path of __n match __k from byte __depth on.
+  static size_t _S_path_match(_Art_inner* __n, std::string_view __k, size_t __depth) noexcept
+  {
+    size_t __max = tinySTL::min<size_t>(__n->_M_prefix_len, __k.size() - __depth);
+    size_t __i = 0;
+    for (; __i < __max && __i < _Art_inner::_S_prefix; ++__i)
+      if (__n->_M_prefix[__i] != (unsigned char)__k[__depth + __i])
+        return __i;
+    if (__i < __max) {
+      std::string_view __path = _S_key(_S_minimum(__n));
+      for (; __i < __max; ++__i)
+        if (__path[__depth + __i] != __k[__depth + __i])
+          return __i;
+    }
+    return __i;
+  }
+
+  static void _S_set_path(_Art_inner* __n, const char* __bytes, size_t __len) noexcept
+  {
+    __n->_M_prefix_len = (uint32_t)__len;
+    memcpy(__n->_M_prefix, __bytes, tinySTL::min(__len, _Art_inner::_S_prefix));
+  }
+
+  // a leaf under a fresh node4 whose path ends at byte __depth of its key.
+  static void _S_hang(_Art_inner* __n, _Art_node* __leaf, std::string_view __k, size_t __depth) noexcept
+  {
+    if (__k.size() == __depth)
+      __n->_M_value = __leaf;
+    else
+      _S_add_child(__n, (unsigned char)__k[__depth], __leaf);
+  }
+
+ public:
+  _Art_tree() noexcept
+  : _M_root(nullptr), _M_count(0), _M_leaf_allocator()
+  { _M_head._M_prev = _M_head._M_next = &_M_head; }
+
+  _Art_tree(const _Art_tree& __x)
+  : _Art_tree()
+  {
+    // delegated, so a throw here still runs the destructor.
+    for (const _Art_links* __p = __x._M_head._M_next; __p != &__x._M_head; __p = __p->_M_next)
+      _M_emplace_unique(*static_cast<const _Leaf*>(__p)->_M_valptr());
+  }
+
+  _Art_tree(_Art_tree&& __x) noexcept
+  : _Art_tree()
+  { swap(__x); }
+
+  ~_Art_tree() { clear(); }
+
+  _Art_tree& operator=(const _Art_tree& __x)
+  {
+    if (this != &__x) {
+      _Art_tree __tmp(__x);
+      swap(__tmp);
+    }
+    return *this;
+  }
+
+  _Art_tree& operator=(_Art_tree&& __x) noexcept
+  {
+    if (this != &__x) {
+      clear();
+      swap(__x);
+    }
+    return *this;
+  }
+
+  void swap(_Art_tree& __x) noexcept
+  {
+    tinySTL::swap(_M_root, __x._M_root);
+    tinySTL::swap(_M_count, __x._M_count);
+    tinySTL::swap(_M_head, __x._M_head);
+    // the lists point at the header they belong to.
+    for (_Art_tree* __t : {this, &__x}) {
+      if (__t->_M_count == 0) {
+        __t->_M_head._M_prev = __t->_M_head._M_next = &__t->_M_head;
+      } else {
+        __t->_M_head._M_next->_M_prev = &__t->_M_head;
+        __t->_M_head._M_prev->_M_next = &__t->_M_head;
+      }
+    }
+  }
+
+  iterator begin() noexcept { return iterator(_M_head._M_next); }
+
+  const_iterator begin() const noexcept { return iterator(_M_head._M_next); }
+
+  iterator end() noexcept { return iterator(&_M_head); }
+
+  const_iterator end() const noexcept { return iterator(&_M_head); }
+
+  reverse_iterator rbegin() noexcept { return reverse_iterator(end()); }
+
+  const_reverse_iterator rbegin() const noexcept { return const_reverse_iterator(end()); }
+
+  reverse_iterator rend() noexcept { return reverse_iterator(begin()); }
+
+  const_reverse_iterator rend() const noexcept { return const_reverse_iterator(begin()); }
+
+  size_type size() const noexcept { return _M_count; }
+
+  size_type max_size() const noexcept { return size_type(-1) / sizeof(_Leaf); }
+
+  // the inner nodes, then the leaves through the list, without recursion:
+  // the leaves are on the list, so each node's _M_value can link the
+  // nodes still to free.
+  void clear() noexcept
+  {
+    _Art_node* __stack = (_M_root && !_S_is_leaf(_M_root)) ? _M_root : nullptr;
+    if (__stack)
+      _S_inner(__stack)->_M_value = nullptr;
+    while (__stack != nullptr) {
+      _Art_inner* __n = _S_inner(__stack);
+      __stack = __n->_M_value;
+      unsigned char __b = 0;
+      for (_Art_node* __x = _S_child_after(__n, -1, &__b); __x != nullptr;
+           __x = _S_child_after(__n, __b, &__b)) {
+        if (!_S_is_leaf(__x)) {
+          _S_inner(__x)->_M_value = __stack;
+          __stack = __x;
+        }
+      }
+      _M_free_node(__n);
+    }
+    for (_Art_links* __p = _M_head._M_next; __p != &_M_head; ) {
+      _Art_links* __next = __p->_M_next;
+      _M_drop_leaf(_S_leaf(__p));
+      __p = __next;
+    }
+    _M_root = nullptr;
+    _M_count = 0;
+    _M_head._M_prev = _M_head._M_next = &_M_head;
+  }
+
+  _Leaf* _M_find(std::string_view __k) const noexcept
+  {
+    _Art_node* __x = _M_root;
+    size_t __depth = 0;
+    while (__x != nullptr) {
+      if (_S_is_leaf(__x))
+        return _S_key(__x) == __k ? _S_leaf(__x) : nullptr;
+      _Art_inner* __n = _S_inner(__x);
+      if (__n->_M_prefix_len != 0) {
+        // only the kept bytes, the whole key is checked at the leaf.
+        if (__k.size() - __depth < __n->_M_prefix_len
+         || memcmp(__n->_M_prefix, __k.data() + __depth,
+                   tinySTL::min<size_t>(__n->_M_prefix_len, _Art_inner::_S_prefix)) != 0)
+          return nullptr;
+        __depth += __n->_M_prefix_len;
+      }
+      if (__depth == __k.size())
+        return __n->_M_value && _S_key(__n->_M_value) == __k ? _S_leaf(__n->_M_value) : nullptr;
+      _Art_node** __child = _S_find_child(__n, (unsigned char)__k[__depth]);
+      if (__child == nullptr)
+        return nullptr;
+      __x = *__child;
+      ++__depth;
+    }
+    return nullptr;
+  }
+
+  iterator find(std::string_view __k) noexcept
+  {
+    _Leaf* __z = _M_find(__k);
+    return __z ? iterator(__z) : end();
+  }
+
+  const_iterator find(std::string_view __k) const noexcept
+  {
+    _Leaf* __z = _M_find(__k);
+    return __z ? const_iterator(iterator(__z)) : end();
+  }
+
+  /**
+   * @brief  link the new leaf __z in, unless its key is already present,
+   *  in which case the leaf holding the key is returned and __z is left
+   *  alone. If memory for a node runs out, nothing changes.
+   */
+  _Leaf* _M_insert_leaf(_Leaf* __z)
+  {
+    std::string_view __k = _S_key(__z);
+    if (_M_root == nullptr) {
+      _M_root = __z;
+      _S_link_before(&_M_head, __z);
+      ++_M_count;
+      return __z;
+    }
+    _Art_node** __ref = &_M_root;
+    size_t __depth = 0;
+    for (;;) {
+      if (_S_is_leaf(*__ref)) {
+        // two keys where there was one: a node4 on their common bytes.
+        _Leaf* __l = _S_leaf(*__ref);
+        std::string_view __lk = _S_key(__l);
+        if (__lk == __k)
+          return __l;
+        size_t __p = __depth;
+        while (__p < __lk.size() && __p < __k.size() && __lk[__p] == __k[__p])
+          ++__p;
+        _Art_node4* __n = _M_create_node<_Art_node4>();
+        _S_set_path(__n, __k.data() + __depth, __p - __depth);
+        _S_hang(__n, __l, __lk, __p);
+        _S_hang(__n, __z, __k, __p);
+        *__ref = __n;
+        _S_link_before(__k < __lk ? __l : __l->_M_next, __z);
+        break;
+      }
+      _Art_inner* __n = _S_inner(*__ref);
+      if (__n->_M_prefix_len != 0) {
+        size_t __p = _S_path_match(__n, __k, __depth);
+        if (__p < __n->_M_prefix_len) {
+          // __k leaves the path after __p bytes: a node4 there, with __n
+          // below it on the rest of the path.
+          _Art_node4* __m = _M_create_node<_Art_node4>();
+          unsigned char __c = _S_path_at(__n, __depth, __p);
+          _Leaf* __first = _S_minimum(__n);
+          _Leaf* __last = _S_maximum(__n);
+          unsigned char __rest[_Art_inner::_S_prefix];
+          size_t __len = __n->_M_prefix_len - __p - 1;
+          for (size_t __i = 0; __i < _Art_inner::_S_prefix && __i < __len; ++__i)
+            __rest[__i] = _S_path_at(__n, __depth, __p + 1 + __i);
+          _S_set_path(__m, __k.data() + __depth, __p);
+          _S_set_path(__n, (const char*)__rest, __len);
+          _S_add_child(__m, __c, __n);
+          _S_hang(__m, __z, __k, __depth + __p);
+          *__ref = __m;
+          bool __before = __k.size() == __depth + __p || (unsigned char)__k[__depth + __p] < __c;
+          _S_link_before(__before ? __first : __last->_M_next, __z);
+          break;
+        }
+        __depth += __n->_M_prefix_len;
+      }
+      if (__depth == __k.size()) {
+        if (__n->_M_value != nullptr)
+          return _S_leaf(__n->_M_value);
+        _Leaf* __first = _S_minimum(__n);
+        __n->_M_value = __z;
+        _S_link_before(__first, __z);
+        break;
+      }
+      unsigned char __c = __k[__depth];
+      _Art_node** __child = _S_find_child(__n, __c);
+      if (__child != nullptr) {
+        __ref = __child;
+        ++__depth;
+        continue;
+      }
+      _Art_node* __next = _S_child_after(__n, __c);
+      _Art_links* __pos = __next ? _S_minimum(__next) : _S_maximum(__n)->_M_next;
+      _M_add_child(*__ref, __c, __z);
+      _S_link_before(__pos, __z);
+      break;
+    }
+    ++_M_count;
+    return __z;
+  }
+
+  template <class... _Args>
+  pair<iterator, bool> _M_emplace_unique(_Args&&... __args)
+  {
+    _Leaf* __z = _M_create_leaf(tinySTL::forward<_Args>(__args)...);
+    _Leaf* __y;
+    try {
+      __y = _M_insert_leaf(__z);
+    } catch (...) {
+      _M_drop_leaf(__z);
+      throw;
+    }
+    if (__y != __z)
+      _M_drop_leaf(__z);
+    return pair<iterator, bool>(iterator(__y), __y == __z);
+  }
+
+  // unlink the leaf holding __k and return it, null if there is none.
+  _Leaf* _M_unlink(std::string_view __k) noexcept
+  {
+    _Art_node** __ref = &_M_root;
+    _Art_node** __parent = nullptr;
+    size_t __depth = 0;
+    unsigned char __c = 0;
+    for (;;) {
+      if (*__ref == nullptr)
+        return nullptr;
+      if (_S_is_leaf(*__ref))
+        break;
+      _Art_inner* __n = _S_inner(*__ref);
+      if (__n->_M_prefix_len != 0) {
+        if (__k.size() - __depth < __n->_M_prefix_len
+         || memcmp(__n->_M_prefix, __k.data() + __depth,
+                   tinySTL::min<size_t>(__n->_M_prefix_len, _Art_inner::_S_prefix)) != 0)
+          return nullptr;
+        __depth += __n->_M_prefix_len;
+      }
+      if (__depth == __k.size()) {
+        _Art_node* __v = __n->_M_value;
+        if (__v == nullptr || _S_key(__v) != __k)
+          return nullptr;
+        __n->_M_value = nullptr;
+        _M_shrink(*__ref);
+        _S_unlink(_S_leaf(__v));
+        --_M_count;
+        return _S_leaf(__v);
+      }
+      __c = __k[__depth];
+      _Art_node** __child = _S_find_child(__n, __c);
+      if (__child == nullptr)
+        return nullptr;
+      __parent = __ref;
+      __ref = __child;
+      ++__depth;
+    }
+    _Leaf* __z = _S_leaf(*__ref);
+    if (_S_key(__z) != __k)
+      return nullptr;
+    if (__parent == nullptr) {
+      _M_root = nullptr;
+    } else {
+      _S_remove_child(_S_inner(*__parent), __c);
+      _M_shrink(*__parent);
+    }
+    _S_unlink(__z);
+    --_M_count;
+    return __z;
+  }
+
+  size_type erase(std::string_view __k) noexcept
+  {
+    _Leaf* __z = _M_unlink(__k);
+    if (__z == nullptr)
+      return 0;
+    _M_drop_leaf(__z);
+    return 1;
+  }
+
+  iterator erase(iterator __pos) noexcept
+  {
+    iterator __next(__pos._M_node->_M_next);
+    erase(_S_key(_S_leaf(__pos._M_node)));
+    return __next;
+  }
+
+  /**
+   * @brief  the elements whose keys start with __p, as a range in key
+   *  order. The walk stops at the node whose path covers __p; everything
+   *  under it matches, so the range is from its first leaf to its last.
+   */
+  pair<iterator, iterator> prefix_range(std::string_view __p) noexcept
+  {
+    _Art_node* __x = _M_root;
+    size_t __depth = 0;
+    while (__x != nullptr) {
+      if (_S_is_leaf(__x)) {
+        if (_S_key(__x).substr(0, __p.size()) != __p)
+          break;
+        return pair<iterator, iterator>(iterator(_S_leaf(__x)), iterator(_S_leaf(__x)->_M_next));
+      }
+      _Art_inner* __n = _S_inner(__x);
+      if (__n->_M_prefix_len != 0) {
+        size_t __m = _S_path_match(__n, __p, __depth);
+        if (__m < __n->_M_prefix_len && __depth + __m != __p.size())
+          break;
+        __depth += __m;
+      }
+      if (__depth == __p.size())
+        return pair<iterator, iterator>(iterator(_S_minimum(__n)), iterator(_S_maximum(__n)->_M_next));
+      _Art_node** __child = _S_find_child(__n, (unsigned char)__p[__depth]);
+      if (__child == nullptr)
+        break;
+      __x = *__child;
+      ++__depth;
+    }
+    return pair<iterator, iterator>(end(), end());
+  }
+
+  /**
+   * @brief  check the tree: node sizes and child counts, paths that agree
+   *  with the keys below them, and a leaf list in strictly increasing key
+   *  order holding every leaf of the tree.
+   */
+  bool _M_verify() const
+  {
+    size_type __n = 0;
+    for (const _Art_links* __p = _M_head._M_next; __p != &_M_head; __p = __p->_M_next, ++__n) {
+      if (__p->_M_next->_M_prev != __p)
+        return false;
+      if (__p->_M_next != &_M_head && !(_S_key(_S_leaf(const_cast<_Art_links*>(__p)))
+                                        < _S_key(_S_leaf(__p->_M_next))))
+        return false;
+      if (_M_find(_S_key(_S_leaf(const_cast<_Art_links*>(__p)))) != __p)
+        return false;
+    }
+    if (__n != _M_count || (_M_root == nullptr) != (_M_count == 0))
+      return false;
+    size_type __leaves = 0;
+    if (_M_root != nullptr && !_S_verify(_M_root, 0, __leaves))
+      return false;
+    return __leaves == _M_count;
+  }
+
+  static bool _S_verify(_Art_node* __x, size_t __depth, size_type& __leaves)
+  {
+    if (_S_is_leaf(__x)) {
+      ++__leaves;
+      return _S_key(__x).size() >= __depth;
+    }
+    _Art_inner* __n = _S_inner(__x);
+    std::string_view __k = _S_key(_S_minimum(__n));
+    if (__k.size() < __depth + __n->_M_prefix_len)
+      return false;
+    for (size_t __i = 0; __i < __n->_M_prefix_len && __i < _Art_inner::_S_prefix; ++__i)
+      if (__n->_M_prefix[__i] != (unsigned char)__k[__depth + __i])
+        return false;
+    __depth += __n->_M_prefix_len;
+    if (__n->_M_value != nullptr) {
+      if (_S_key(__n->_M_value).size() != __depth)
+        return false;
+      ++__leaves;
+    }
+    unsigned __count = 0, __min = 0;
+    switch (__n->_M_type) {
+      case _Art_type::_S_node16:  __min = 4; break;
+      case _Art_type::_S_node48:  __min = 13; break;
+      case _Art_type::_S_node256: __min = 41; break;
+      default: break;
+    }
+    if (__n->_M_count < __min || (__n->_M_count < 2 && __n->_M_value == nullptr)
+     || __n->_M_count == 0)
+      return false;
+    unsigned char __b = 0;
+    for (_Art_node* __c = _S_child_after(__n, -1, &__b); __c != nullptr;
+         __c = _S_child_after(__n, __b, &__b), ++__count) {
+      std::string_view __ck = _S_key(_S_minimum(__c));
+      if (__ck.size() <= __depth || (unsigned char)__ck[__depth] != __b)
+        return false;
+      if (!_S_verify(__c, __depth + 1, __leaves))
+        return false;
+    }
+    return __count == __n->_M_count;
+  }
+};
+
+}
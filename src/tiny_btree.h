@@ -0,0 +1,1070 @@
+// tinySTL: _Btree, the B-tree under btree_set and btree_map.
+#pragma once
+
+#include "tiny_pair.h"
+#include "tiny_alloc.h"
+#include "tiny_errors.h"
+#include "tiny_algobase.h"
+#include "tiny_iterator.h"
+#include "tiny_construct.h"
+
+namespace tinySTL
+{
+
+// bytes of values held by one node: a few cache lines, so a lookup
+// touches one node per level and a tree of 50M keys is 4 or 5 levels
+// deep instead of the ~26 of _Rb_tree. See bench/btree.cpp.
+constexpr size_t _S_btree_node_bytes = 256;
+
+constexpr inline size_t
+__btree_node_slots(size_t __size)
+{
+  // the header of a node is a parent pointer plus 8 bytes of bookkeeping.
+  size_t __n = (_S_btree_node_bytes - 2 * sizeof(void*)) / __size;
+  return __n < 3 ? 3 : (__n > 255 ? 255 : __n);
+}
+
+/**
+ * @brief  moves values between the slots of btree nodes. The key of a
+ *  map value is const, it is moved through a mutable view instead of
+ *  being copied on every shift.
+ */
+template <class _Val>
+struct _Btree_slot
+{
+  typedef _Val _Mutable;
+};
+
+template <class _Key, class _Tp>
+struct _Btree_slot<tinySTL::pair<const _Key, _Tp>>
+{
+  typedef tinySTL::pair<_Key, _Tp> _Mutable;
+};
+
+// construct *__dst from *__src and destroy *__src. Never throws, _Btree
+// only holds values whose move constructor is noexcept.
+template <class _Val>
+inline void __btree_relocate(_Val* __dst, _Val* __src)
+{
+  typedef typename _Btree_slot<_Val>::_Mutable _Mutable;
+  tinySTL::construct((_Mutable*)__dst, tinySTL::move(*(_Mutable*)__src));
+  tinySTL::destroy(__src);
+}
+
+template <class _Val, size_t _Slots>
+struct _Btree_internal_node;
+
+/**
+ * @brief  a leaf of the btree, internal nodes extend it with children.
+ *  Values sit in both kinds of node, a node holds up to _Slots values.
+ */
+template <class _Val, size_t _Slots>
+struct _Btree_node
+{
+  typedef _Val value_type;
+  typedef _Btree_internal_node<_Val, _Slots> _Internal;
+
+  _Btree_node*   _M_parent;
+  unsigned short _M_position;   // index of this node among its parent's children.
+  unsigned short _M_count;
+  bool           _M_leaf;
+  aligned_membuf<_Val> _M_slots[_Slots];
+
+  _Val* _M_value(size_t __i) noexcept { return _M_slots[__i].ptr(); }
+
+  const _Val* _M_value(size_t __i) const noexcept { return _M_slots[__i].ptr(); }
+
+  _Btree_node*& _M_child(size_t __i) noexcept
+  { return static_cast<_Internal*>(this)->_M_children[__i]; }
+
+  _Btree_node* _M_child(size_t __i) const noexcept
+  { return static_cast<const _Internal*>(this)->_M_children[__i]; }
+
+  void _M_set_child(size_t __i, _Btree_node* __c) noexcept
+  {
+    _M_child(__i) = __c;
+    __c->_M_parent = this;
+    __c->_M_position = (unsigned short)__i;
+  }
+
+  // shift values [__i, count) one slot up, the slot __i is left raw.
+  void _M_open_gap(size_t __i)
+  {
+    for (size_t __j = _M_count; __j > __i; --__j)
+      __btree_relocate(_M_value(__j), _M_value(__j - 1));
+  }
+
+  // the value in slot __i is already gone, shift [__i + 1, count) down.
+  void _M_close_gap(size_t __i)
+  {
+    for (size_t __j = __i + 1; __j < _M_count; ++__j)
+      __btree_relocate(_M_value(__j - 1), _M_value(__j));
+    --_M_count;
+  }
+};
+
+template <class _Val, size_t _Slots>
+struct _Btree_internal_node : public _Btree_node<_Val, _Slots>
+{
+  _Btree_node<_Val, _Slots>* _M_children[_Slots + 1];
+};
+
+/**
+ * @brief  iterator of _Btree, a node and a value position in it.
+ *  end() is the position one past the last value of the rightmost leaf.
+ */
+template <class _Node>
+struct _Btree_iterator
+{
+  typedef typename _Node::value_type value_type;
+  typedef value_type& reference;
+  typedef value_type* pointer;
+
+  typedef bidirectional_iterator_tag iterator_category;
+  typedef ptrdiff_t       difference_type;
+
+  typedef _Btree_iterator<_Node> _Self;
+
+  _Node* _M_node;
+  int    _M_position;
+
+  _Btree_iterator() noexcept
+  : _M_node(0), _M_position(0) { }
+
+  _Btree_iterator(_Node* __n, int __pos) noexcept
+  : _M_node(__n), _M_position(__pos) { }
+
+  reference
+  operator*() const noexcept
+  { return *_M_node->_M_value(_M_position); }
+
+  pointer
+  operator->() const noexcept
+  { return _M_node->_M_value(_M_position); }
+
+  _Self& operator++() noexcept
+  {
+    if (_M_node->_M_leaf && ++_M_position < _M_node->_M_count)
+      return *this;
+    _M_increment_slow();
+    return *this;
+  }
+
+  _Self operator++(int) noexcept
+  {
+    _Self __tmp = *this;
+    ++*this;
+    return __tmp;
+  }
+
+  _Self& operator--() noexcept
+  {
+    if (_M_node->_M_leaf && --_M_position >= 0)
+      return *this;
+    _M_decrement_slow();
+    return *this;
+  }
+
+  _Self operator--(int) noexcept
+  {
+    _Self __tmp = *this;
+    --*this;
+    return __tmp;
+  }
+
+  friend bool
+  operator==(const _Self& __x, const _Self& __y) noexcept
+  { return __x._M_node == __y._M_node && __x._M_position == __y._M_position; }
+
+  friend bool
+  operator!=(const _Self& __x, const _Self& __y) noexcept
+  { return !(__x == __y); }
+
+  void _M_increment_slow() noexcept
+  {
+    if (_M_node->_M_leaf) {
+      // past the last value of a leaf, climb to the first ancestor that
+      // has a value right of us. There is none for the last value.
+      _Self __save = *this;
+      while (_M_position == _M_node->_M_count && _M_node->_M_parent) {
+        _M_position = _M_node->_M_position;
+        _M_node = _M_node->_M_parent;
+      }
+      if (_M_position == _M_node->_M_count)
+        *this = __save;
+    } else {
+      _M_node = _M_node->_M_child(_M_position + 1);
+      while (!_M_node->_M_leaf)
+        _M_node = _M_node->_M_child(0);
+      _M_position = 0;
+    }
+  }
+
+  void _M_decrement_slow() noexcept
+  {
+    if (_M_node->_M_leaf) {
+      _Self __save = *this;
+      while (_M_position < 0 && _M_node->_M_parent) {
+        _M_position = _M_node->_M_position - 1;
+        _M_node = _M_node->_M_parent;
+      }
+      if (_M_position < 0)
+        *this = __save;
+    } else {
+      _M_node = _M_node->_M_child(_M_position);
+      while (!_M_node->_M_leaf)
+        _M_node = _M_node->_M_child(_M_node->_M_count);
+      _M_position = _M_node->_M_count - 1;
+    }
+  }
+};
+
+/**
+ * @brief  a B-tree with the interface of _Rb_tree. Every node holds
+ *  many values in one allocation, so a lookup does one binary search per
+ *  level over a few cache lines instead of one pointer chase per key.
+ *
+ * @attention unlike _Rb_tree, insert and erase move values between
+ *  nodes and invalidate every iterator into the tree. A move that throws
+ *  halfway through a shift could not be undone, so the values must be
+ *  nothrow move constructible.
+ */
+template<typename _Key, typename _Val, typename _KeyOfValue,
+     typename _Compare, typename _Alloc = tinySTL::allocator<_Val> >
+class _Btree
+{
+
+template<class, class, class> friend class btree_set;
+template<class, class, class> friend class btree_multiset;
+template<class, class, class, class> friend class btree_map;
+template<class, class, class, class> friend class btree_multimap;
+template<class, class, class, class, class> friend class _Btree;
+
+ protected:
+  static constexpr size_t _S_slots = __btree_node_slots(sizeof(_Val));
+  static constexpr size_t _S_min_values = _S_slots / 2;
+
+  static_assert(__is_nothrow_constructible(typename _Btree_slot<_Val>::_Mutable,
+                                           typename _Btree_slot<_Val>::_Mutable&&),
+                "_Btree: the value type must be nothrow move constructible");
+
+  typedef _Btree_node<_Val, _S_slots> _Node;
+  typedef _Btree_internal_node<_Val, _S_slots> _Internal_node;
+  typedef typename _Alloc_rebind<_Alloc, _Node>::type _Leaf_allocator;
+  typedef typename _Alloc_rebind<_Alloc, _Internal_node>::type _Internal_allocator;
+
+ protected:
+  typedef _Key key_type;
+  typedef _Val value_type;
+  typedef value_type* pointer;
+  typedef const value_type* const_pointer;
+  typedef value_type& reference;
+  typedef const value_type& const_reference;
+  typedef size_t size_type;
+  typedef ptrdiff_t difference_type;
+  typedef _Alloc allocator_type;
+  typedef _Btree_iterator<_Node> iterator;
+  typedef tinySTL::const_iterator<iterator> const_iterator;
+  typedef tinySTL::reverse_iterator<const_iterator> const_reverse_iterator;
+  typedef tinySTL::reverse_iterator<iterator> reverse_iterator;
+
+ protected:
+  _Node* _M_root;
+  size_t _M_node_count;
+  _Leaf_allocator _M_leaf_allocator;
+  _Internal_allocator _M_internal_allocator;
+  _Compare _M_compare;
+
+  static const _Key& _S_key(const _Node* __n, size_t __i)
+  { return _KeyOfValue()(*__n->_M_value(__i)); }
+
+  _Node* _M_new_leaf()
+  {
+    _Node* __n = _M_leaf_allocator.allocate(1);
+    __n->_M_parent = 0;
+    __n->_M_position = 0;
+    __n->_M_count = 0;
+    __n->_M_leaf = true;
+    return __n;
+  }
+
+  _Node* _M_new_internal()
+  {
+    _Node* __n = _M_internal_allocator.allocate(1);
+    __n->_M_parent = 0;
+    __n->_M_position = 0;
+    __n->_M_count = 0;
+    __n->_M_leaf = false;
+    return __n;
+  }
+
+  // free a node whose values are already destroyed or moved out.
+  void _M_delete_node(_Node* __n) noexcept
+  {
+    if (__n->_M_leaf)
+      _M_leaf_allocator.deallocate(__n, 1);
+    else
+      _M_internal_allocator.deallocate((_Internal_node*)__n, 1);
+  }
+
+  void _M_erase_subtree(_Node* __n) noexcept
+  {
+    if (!__n->_M_leaf) {
+      for (size_t __i = 0; __i <= __n->_M_count; ++__i)
+        _M_erase_subtree(__n->_M_child(__i));
+    }
+    for (size_t __i = 0; __i < __n->_M_count; ++__i)
+      tinySTL::destroy(__n->_M_value(__i));
+    _M_delete_node(__n);
+  }
+
+  _Node* _M_copy_subtree(const _Node* __x)
+  {
+    _Node* __n = __x->_M_leaf ? _M_new_leaf() : _M_new_internal();
+    size_t __v = 0, __c = 0;
+    try {
+      for (; __v < __x->_M_count; ++__v)
+        tinySTL::construct(__n->_M_value(__v), *__x->_M_value(__v));
+      __n->_M_count = __x->_M_count;
+      if (!__x->_M_leaf) {
+        for (; __c <= __x->_M_count; ++__c)
+          __n->_M_set_child(__c, _M_copy_subtree(__x->_M_child(__c)));
+      }
+    } catch (...) {
+      for (size_t __i = 0; __i < __c; ++__i)
+        _M_erase_subtree(__n->_M_child(__i));
+      for (size_t __i = 0; __i < __v; ++__i)
+        tinySTL::destroy(__n->_M_value(__i));
+      _M_delete_node(__n);
+      throw;
+    }
+    return __n;
+  }
+
+  _Node* _M_leftmost() const noexcept
+  {
+    _Node* __n = _M_root;
+    while (!__n->_M_leaf)
+      __n = __n->_M_child(0);
+    return __n;
+  }
+
+  _Node* _M_rightmost() const noexcept
+  {
+    _Node* __n = _M_root;
+    while (!__n->_M_leaf)
+      __n = __n->_M_child(__n->_M_count);
+    return __n;
+  }
+
+ public:
+  _Btree()
+  : _M_root(0), _M_node_count(0),
+    _M_leaf_allocator(), _M_internal_allocator(), _M_compare()
+  { }
+
+  _Btree(const _Compare& __comp,
+     const allocator_type& __a = allocator_type())
+  : _M_root(0), _M_node_count(0),
+    _M_leaf_allocator(__a), _M_internal_allocator(__a), _M_compare(__comp)
+  { }
+
+  _Btree(const _Btree& __x)
+  : _M_root(0), _M_node_count(0),
+    _M_leaf_allocator(__x._M_leaf_allocator),
+    _M_internal_allocator(__x._M_internal_allocator),
+    _M_compare(__x._M_compare)
+  {
+    if (__x._M_root != nullptr) {
+      _M_root = _M_copy_subtree(__x._M_root);
+      _M_node_count = __x._M_node_count;
+    }
+  }
+
+  _Btree(_Btree&& __x)
+  : _M_root(__x._M_root), _M_node_count(__x._M_node_count),
+    _M_leaf_allocator(tinySTL::move(__x._M_leaf_allocator)),
+    _M_internal_allocator(tinySTL::move(__x._M_internal_allocator)),
+    _M_compare(tinySTL::move(__x._M_compare))
+  {
+    __x._M_root = 0;
+    __x._M_node_count = 0;
+  }
+
+  ~_Btree() { clear(); }
+
+  _Btree& operator=(const _Btree& __x)
+  {
+    if (this != &__x) {
+      clear();
+      _M_compare = __x._M_compare;
+      if (__x._M_root != nullptr) {
+        _M_root = _M_copy_subtree(__x._M_root);
+        _M_node_count = __x._M_node_count;
+      }
+    }
+    return *this;
+  }
+
+  _Btree& operator=(_Btree&& __x)
+  {
+    if (this != &__x) {
+      clear();
+      _M_compare = tinySTL::move(__x._M_compare);
+      _M_root = __x._M_root;
+      _M_node_count = __x._M_node_count;
+      __x._M_root = 0;
+      __x._M_node_count = 0;
+    }
+    return *this;
+  }
+
+ protected:
+  _Compare key_comp() const
+  { return _M_compare; }
+
+  iterator begin() noexcept
+  { return _M_root ? iterator(_M_leftmost(), 0) : iterator(); }
+
+  const_iterator begin() const noexcept
+  { return const_cast<_Btree*>(this)->begin(); }
+
+  const_iterator cbegin() const noexcept
+  { return begin(); }
+
+  iterator end() noexcept
+  {
+    if (_M_root == nullptr)
+      return iterator();
+    _Node* __n = _M_rightmost();
+    return iterator(__n, __n->_M_count);
+  }
+
+  const_iterator end() const noexcept
+  { return const_cast<_Btree*>(this)->end(); }
+
+  const_iterator cend() const noexcept
+  { return end(); }
+
+  reverse_iterator rbegin() noexcept
+  { return reverse_iterator(end()); }
+
+  const_reverse_iterator rbegin() const noexcept
+  { return const_reverse_iterator(end()); }
+
+  const_reverse_iterator crbegin() const noexcept
+  { return const_reverse_iterator(end()); }
+
+  reverse_iterator rend() noexcept
+  { return reverse_iterator(begin()); }
+
+  const_reverse_iterator rend() const noexcept
+  { return const_reverse_iterator(begin()); }
+
+  const_reverse_iterator crend() const noexcept
+  { return const_reverse_iterator(begin()); }
+
+  bool empty() const noexcept
+  { return _M_node_count == 0; }
+
+  size_type size() const noexcept
+  { return _M_node_count; }
+
+  size_type max_size() const noexcept
+  { return size_type(-1); }
+
+  /**
+   * @brief levels of the tree, 0 when empty.
+   */
+  size_type height() const noexcept
+  {
+    size_type __h = 0;
+    for (_Node* __n = _M_root; __n; __n = __n->_M_leaf ? 0 : __n->_M_child(0))
+      ++__h;
+    return __h;
+  }
+
+  void swap(_Btree& __t)
+  {
+    tinySTL::swap(_M_root, __t._M_root);
+    tinySTL::swap(_M_node_count, __t._M_node_count);
+    tinySTL::swap(_M_leaf_allocator, __t._M_leaf_allocator);
+    tinySTL::swap(_M_internal_allocator, __t._M_internal_allocator);
+    tinySTL::swap(_M_compare, __t._M_compare);
+  }
+
+  void clear()
+  {
+    if (_M_root != nullptr)
+      _M_erase_subtree(_M_root);
+    _M_root = 0;
+    _M_node_count = 0;
+  }
+
+  // first slot of __n whose key is not less than __k.
+  size_t _M_node_lower_bound(const _Node* __n, const key_type& __k) const
+  {
+    size_t __lo = 0, __hi = __n->_M_count;
+    while (__lo < __hi) {
+      size_t __mid = (__lo + __hi) / 2;
+      if (_M_compare(_S_key(__n, __mid), __k))
+        __lo = __mid + 1;
+      else
+        __hi = __mid;
+    }
+    return __lo;
+  }
+
+  // first slot of __n whose key is greater than __k.
+  size_t _M_node_upper_bound(const _Node* __n, const key_type& __k) const
+  {
+    size_t __lo = 0, __hi = __n->_M_count;
+    while (__lo < __hi) {
+      size_t __mid = (__lo + __hi) / 2;
+      if (!_M_compare(__k, _S_key(__n, __mid)))
+        __lo = __mid + 1;
+      else
+        __hi = __mid;
+    }
+    return __lo;
+  }
+
+  // descend to the leaf position where __k would be inserted before
+  // every equal key (_Upper false) or after them (_Upper true).
+  template <bool _Upper>
+  iterator _M_locate(const key_type& __k) const
+  {
+    _Node* __n = _M_root;
+    for (;;) {
+      size_t __pos = _Upper ? _M_node_upper_bound(__n, __k)
+                            : _M_node_lower_bound(__n, __k);
+      if (__n->_M_leaf)
+        return iterator(__n, (int)__pos);
+      __n = __n->_M_child(__pos);
+    }
+  }
+
+  // the value at a leaf position, climbing when the position is one past
+  // the last value of the leaf. A null node means end().
+  static iterator _S_internal_last(iterator __it) noexcept
+  {
+    while (__it._M_node && __it._M_position == __it._M_node->_M_count) {
+      __it._M_position = __it._M_node->_M_position;
+      __it._M_node = __it._M_node->_M_parent;
+    }
+    return __it;
+  }
+
+  /**
+   * @brief split the full node __n so that an insert at __insert_pos
+   *  fits, the median value moves up into the parent. Inserts at either
+   *  end leave the old node full, so sorted input packs the nodes.
+   */
+  void _M_split(_Node* __n, size_t __insert_pos)
+  {
+    _Node* __parent = __n->_M_parent;
+    if (__parent == nullptr) {
+      __parent = _M_new_internal();
+      __parent->_M_set_child(0, __n);
+      _M_root = __parent;
+    } else if (__parent->_M_count == _S_slots) {
+      _M_split(__parent, __n->_M_position);
+      __parent = __n->_M_parent;
+    }
+
+    size_t __to_move;
+    if (__insert_pos == 0)
+      __to_move = __n->_M_count - 1;
+    else if (__insert_pos == _S_slots)
+      __to_move = 0;
+    else
+      __to_move = __n->_M_count / 2;
+
+    _Node* __sib = __n->_M_leaf ? _M_new_leaf() : _M_new_internal();
+    size_t __first = __n->_M_count - __to_move;
+    for (size_t __i = 0; __i < __to_move; ++__i)
+      __btree_relocate(__sib->_M_value(__i), __n->_M_value(__first + __i));
+    __sib->_M_count = (unsigned short)__to_move;
+    if (!__n->_M_leaf) {
+      for (size_t __i = 0; __i <= __to_move; ++__i)
+        __sib->_M_set_child(__i, __n->_M_child(__first + __i));
+    }
+
+    // the median goes up, between __n and __sib.
+    size_t __pos = __n->_M_position;
+    __parent->_M_open_gap(__pos);
+    __btree_relocate(__parent->_M_value(__pos), __n->_M_value(__first - 1));
+    for (size_t __j = __parent->_M_count; __j > __pos; --__j)
+      __parent->_M_set_child(__j + 1, __parent->_M_child(__j));
+    __parent->_M_set_child(__pos + 1, __sib);
+    ++__parent->_M_count;
+    __n->_M_count = (unsigned short)(__first - 1);
+  }
+
+  // insert a value before __pos, which is any position of the tree.
+  template <class... _Args>
+  iterator _M_emplace_at(iterator __pos, _Args&&... __args)
+  {
+    // build the value first, the arguments may refer to a value that
+    // the split below moves.
+    _Val __tmp(tinySTL::forward<_Args>(__args)...);
+    if (_M_root == nullptr) {
+      _M_root = _M_new_leaf();
+      __pos = iterator(_M_root, 0);
+    } else if (!__pos._M_node->_M_leaf) {
+      // the slot right after the last value of the left subtree.
+      --__pos;
+      ++__pos._M_position;
+    }
+
+    _Node* __n = __pos._M_node;
+    if (__n->_M_count == _S_slots) {
+      _M_split(__n, __pos._M_position);
+      if ((size_t)__pos._M_position > __n->_M_count) {
+        __pos._M_position -= __n->_M_count + 1;
+        __pos._M_node = __n->_M_parent->_M_child(__n->_M_position + 1);
+        __n = __pos._M_node;
+      }
+    }
+    __n->_M_open_gap(__pos._M_position);
+    typedef typename _Btree_slot<_Val>::_Mutable _Mutable;
+    tinySTL::construct((_Mutable*)__n->_M_value(__pos._M_position),
+                       tinySTL::move(*(_Mutable*)&__tmp));
+    ++__n->_M_count;
+    ++_M_node_count;
+    return __pos;
+  }
+
+  template <class _Arg>
+  tinySTL::pair<iterator, bool>
+  _M_insert_unique(_Arg&& __x)
+  {
+    if (_M_root != nullptr) {
+      iterator __pos = _M_locate<false>(_KeyOfValue()(__x));
+      iterator __last = _S_internal_last(__pos);
+      if (__last._M_node
+       && !_M_compare(_KeyOfValue()(__x), _S_key(__last._M_node, __last._M_position)))
+        return {__last, false};
+      return {_M_emplace_at(__pos, tinySTL::forward<_Arg>(__x)), true};
+    }
+    return {_M_emplace_at(iterator(), tinySTL::forward<_Arg>(__x)), true};
+  }
+
+  template <class _Arg> iterator
+  _M_insert_equal(_Arg&& __x)
+  {
+    if (_M_root == nullptr)
+      return _M_emplace_at(iterator(), tinySTL::forward<_Arg>(__x));
+    return _M_emplace_at(_M_locate<true>(_KeyOfValue()(__x)),
+                         tinySTL::forward<_Arg>(__x));
+  }
+
+  template <class _Arg> iterator
+  _M_insert_unique(iterator __position, _Arg&& __x)
+  {
+    if (_M_root != nullptr) {
+      const key_type& __k = _KeyOfValue()(__x);
+      iterator __end = end();
+      if (__position == __end || _M_compare(__k, _S_key(__position._M_node, __position._M_position))) {
+        iterator __before = __position;
+        if (__position == begin()
+         || (--__before, _M_compare(_S_key(__before._M_node, __before._M_position), __k)))
+          return _M_emplace_at(__position, tinySTL::forward<_Arg>(__x));
+      }
+    }
+    return _M_insert_unique(tinySTL::forward<_Arg>(__x)).first;
+  }
+
+  template <class _Arg> iterator
+  _M_insert_equal(iterator __position, _Arg&& __x)
+  {
+    if (_M_root != nullptr) {
+      const key_type& __k = _KeyOfValue()(__x);
+      iterator __end = end();
+      if (__position == __end || !_M_compare(_S_key(__position._M_node, __position._M_position), __k)) {
+        iterator __before = __position;
+        if (__position == begin()
+         || (--__before, !_M_compare(__k, _S_key(__before._M_node, __before._M_position))))
+          return _M_emplace_at(__position, tinySTL::forward<_Arg>(__x));
+      }
+    }
+    return _M_insert_equal(tinySTL::forward<_Arg>(__x));
+  }
+
+  template <class... _Args>
+  tinySTL::pair<iterator, bool>
+  _M_emplace_unique(_Args&&... __args)
+  {
+    return _M_insert_unique(value_type(tinySTL::forward<_Args>(__args)...));
+  }
+
+  template <class... _Args> iterator
+  _M_emplace_equal(_Args&&... __args)
+  {
+    return _M_insert_equal(value_type(tinySTL::forward<_Args>(__args)...));
+  }
+
+  template <class... _Args> iterator
+  _M_emplace_hint_unique(iterator __position, _Args&&... __args)
+  {
+    return _M_insert_unique(__position, value_type(tinySTL::forward<_Args>(__args)...));
+  }
+
+  template <class... _Args> iterator
+  _M_emplace_hint_equal(iterator __position, _Args&&... __args)
+  {
+    return _M_insert_equal(__position, value_type(tinySTL::forward<_Args>(__args)...));
+  }
+
+  iterator
+  erase(iterator __pos)
+  {
+    if (empty() || __pos == end()) {
+      __tiny_throw_range_error("erase");
+    }
+    // a value of an internal node is replaced by its predecessor, which
+    // always sits last in a leaf, and the leaf slot is removed instead.
+    bool __internal = !__pos._M_node->_M_leaf;
+    tinySTL::destroy(__pos._M_node->_M_value(__pos._M_position));
+    if (__internal) {
+      iterator __pred = __pos;
+      --__pred;
+      __btree_relocate(__pos._M_node->_M_value(__pos._M_position),
+                       __pred._M_node->_M_value(__pred._M_position));
+      __pos = __pred;
+    }
+    __pos._M_node->_M_close_gap(__pos._M_position);
+    --_M_node_count;
+
+    iterator __res = _M_rebalance_after_erase(__pos);
+    if (__internal)
+      ++__res;
+    return __res;
+  }
+
+  size_type
+  erase(const key_type& __k)
+  {
+    tinySTL::pair<iterator,iterator> __p = equal_range(__k);
+    size_type __n = tinySTL::distance(__p.first, __p.second);
+    erase(__p.first, __n);
+    return __n;
+  }
+
+  iterator
+  erase(iterator __first, iterator __last)
+  {
+    if (__first == begin() && __last == end()) {
+      clear();
+      return end();
+    }
+    return erase(__first, tinySTL::distance(__first, __last));
+  }
+
+  // erase __n values from __first, the iterators of a range do not
+  // survive the rebalancing in between.
+  iterator
+  erase(iterator __first, size_type __n)
+  {
+    for (; __n > 0; --__n)
+      __first = erase(__first);
+    return __first;
+  }
+
+  // __it is the leaf slot that just lost a value. Merge or refill the
+  // leaf and its ancestors, and return the position of the value after
+  // the erased one.
+  iterator _M_rebalance_after_erase(iterator __it)
+  {
+    iterator __res = __it;
+    bool __first = true;
+    for (;;) {
+      if (__it._M_node == _M_root) {
+        _M_try_shrink();
+        if (empty())
+          return end();
+        break;
+      }
+      if (__it._M_node->_M_count >= _S_min_values)
+        break;
+      bool __merged = _M_try_merge_or_rebalance(__it);
+      if (__first) {
+        __res = __it;
+        __first = false;
+      }
+      if (!__merged)
+        break;
+      __it._M_position = __it._M_node->_M_position;
+      __it._M_node = __it._M_node->_M_parent;
+    }
+    if (__res._M_position == __res._M_node->_M_count) {
+      __res._M_position = __res._M_node->_M_count - 1;
+      ++__res;
+    }
+    return __res;
+  }
+
+  void _M_try_shrink()
+  {
+    if (_M_root->_M_count > 0)
+      return;
+    _Node* __old = _M_root;
+    if (__old->_M_leaf) {
+      _M_root = 0;
+    } else {
+      _M_root = __old->_M_child(0);
+      _M_root->_M_parent = 0;
+      _M_root->_M_position = 0;
+    }
+    _M_delete_node(__old);
+  }
+
+  // returns true when __it's node was merged into a sibling, __it
+  // follows the value it pointed to.
+  bool _M_try_merge_or_rebalance(iterator& __it)
+  {
+    _Node* __n = __it._M_node;
+    _Node* __parent = __n->_M_parent;
+    if (__n->_M_position > 0) {
+      _Node* __left = __parent->_M_child(__n->_M_position - 1);
+      if (1u + __left->_M_count + __n->_M_count <= _S_slots) {
+        __it._M_position += 1 + __left->_M_count;
+        _M_merge_nodes(__left, __n);
+        __it._M_node = __left;
+        return true;
+      }
+    }
+    if (__n->_M_position < __parent->_M_count) {
+      _Node* __right = __parent->_M_child(__n->_M_position + 1);
+      if (1u + __n->_M_count + __right->_M_count <= _S_slots) {
+        _M_merge_nodes(__n, __right);
+        return true;
+      }
+      // refill from the right when that does not move __it's value.
+      if (__right->_M_count > _S_min_values
+       && (__n->_M_count == 0 || __it._M_position > 0)) {
+        size_t __to_move = (__right->_M_count - __n->_M_count) / 2;
+        if (__to_move > __right->_M_count - 1u)
+          __to_move = __right->_M_count - 1u;
+        _M_rebalance_right_to_left(__to_move, __n, __right);
+        return false;
+      }
+    }
+    if (__n->_M_position > 0) {
+      _Node* __left = __parent->_M_child(__n->_M_position - 1);
+      if (__left->_M_count > _S_min_values
+       && (__n->_M_count == 0 || __it._M_position < __n->_M_count)) {
+        size_t __to_move = (__left->_M_count - __n->_M_count) / 2;
+        if (__to_move > __left->_M_count - 1u)
+          __to_move = __left->_M_count - 1u;
+        _M_rebalance_left_to_right(__to_move, __left, __n);
+        __it._M_position += __to_move;
+        return false;
+      }
+    }
+    return false;
+  }
+
+  // pull the separator down and append __right to __left, __right is freed.
+  void _M_merge_nodes(_Node* __left, _Node* __right)
+  {
+    _Node* __parent = __left->_M_parent;
+    size_t __pos = __left->_M_position;
+    size_t __base = __left->_M_count;
+    __btree_relocate(__left->_M_value(__base), __parent->_M_value(__pos));
+    for (size_t __i = 0; __i < __right->_M_count; ++__i)
+      __btree_relocate(__left->_M_value(__base + 1 + __i), __right->_M_value(__i));
+    if (!__left->_M_leaf) {
+      for (size_t __i = 0; __i <= __right->_M_count; ++__i)
+        __left->_M_set_child(__base + 1 + __i, __right->_M_child(__i));
+    }
+    __left->_M_count = (unsigned short)(__base + 1 + __right->_M_count);
+
+    for (size_t __j = __pos + 2; __j <= __parent->_M_count; ++__j)
+      __parent->_M_set_child(__j - 1, __parent->_M_child(__j));
+    __parent->_M_close_gap(__pos);
+    _M_delete_node(__right);
+  }
+
+  void _M_rebalance_right_to_left(size_t __to_move, _Node* __left, _Node* __right)
+  {
+    _Node* __parent = __left->_M_parent;
+    size_t __pos = __left->_M_position;
+    size_t __base = __left->_M_count;
+    __btree_relocate(__left->_M_value(__base), __parent->_M_value(__pos));
+    for (size_t __i = 1; __i < __to_move; ++__i)
+      __btree_relocate(__left->_M_value(__base + __i), __right->_M_value(__i - 1));
+    __btree_relocate(__parent->_M_value(__pos), __right->_M_value(__to_move - 1));
+    for (size_t __i = __to_move; __i < __right->_M_count; ++__i)
+      __btree_relocate(__right->_M_value(__i - __to_move), __right->_M_value(__i));
+    if (!__left->_M_leaf) {
+      for (size_t __i = 0; __i < __to_move; ++__i)
+        __left->_M_set_child(__base + 1 + __i, __right->_M_child(__i));
+      for (size_t __i = __to_move; __i <= __right->_M_count; ++__i)
+        __right->_M_set_child(__i - __to_move, __right->_M_child(__i));
+    }
+    __left->_M_count += (unsigned short)__to_move;
+    __right->_M_count -= (unsigned short)__to_move;
+  }
+
+  void _M_rebalance_left_to_right(size_t __to_move, _Node* __left, _Node* __right)
+  {
+    _Node* __parent = __left->_M_parent;
+    size_t __pos = __left->_M_position;
+    size_t __lcount = __left->_M_count;
+    for (size_t __i = __right->_M_count; __i > 0; --__i)
+      __btree_relocate(__right->_M_value(__i - 1 + __to_move), __right->_M_value(__i - 1));
+    __btree_relocate(__right->_M_value(__to_move - 1), __parent->_M_value(__pos));
+    for (size_t __i = 0; __i + 1 < __to_move; ++__i)
+      __btree_relocate(__right->_M_value(__i), __left->_M_value(__lcount - __to_move + 1 + __i));
+    __btree_relocate(__parent->_M_value(__pos), __left->_M_value(__lcount - __to_move));
+    if (!__left->_M_leaf) {
+      for (size_t __i = __right->_M_count + 1; __i > 0; --__i)
+        __right->_M_set_child(__i - 1 + __to_move, __right->_M_child(__i - 1));
+      for (size_t __i = 0; __i < __to_move; ++__i)
+        __right->_M_set_child(__i, __left->_M_child(__lcount - __to_move + 1 + __i));
+    }
+    __left->_M_count -= (unsigned short)__to_move;
+    __right->_M_count += (unsigned short)__to_move;
+  }
+
+  friend std::ostream& operator<<(std::ostream& os, const _Btree& tree) {
+    os << '{';
+    auto __from = tree.begin(), __to = tree.end();
+    if (__from != __to) {
+      os << *__from;
+      ++__from;
+      while (__from != __to) {
+        os << ", " << *__from;
+        ++__from;
+      }
+    }
+    return os << '}';
+  }
+
+  template <class _Compare2>
+  void _M_merge_unique(_Btree<_Key, _Val, _KeyOfValue, _Compare2, _Alloc>&& __tree)
+  {
+    // values are moved one by one, a btree has no node to hand over.
+    for (auto __it = __tree.begin(); __it != __tree.end();) {
+      if (_M_insert_unique(tinySTL::move(*__it)).second)
+        __it = __tree.erase(__it);
+      else
+        ++__it;
+    }
+  }
+
+  template <class _Compare2>
+  void _M_merge_equal(_Btree<_Key, _Val, _KeyOfValue, _Compare2, _Alloc>&& __tree)
+  {
+    for (auto __it = __tree.begin(); __it != __tree.end(); ++__it)
+      _M_insert_equal(tinySTL::move(*__it));
+    __tree.clear();
+  }
+
+  iterator
+  find(const key_type& __k)
+  {
+    iterator j = lower_bound(__k);
+    return (j == end() || _M_compare(__k, _S_key(j._M_node, j._M_position))) ? end() : j;
+  }
+
+  const_iterator
+  find(const key_type& __k) const
+  { return const_cast<_Btree*>(this)->find(__k); }
+
+  size_type
+  count_unique(const key_type& __k) const
+  {
+    for (_Node* __n = _M_root; __n;) {
+      size_t __pos = _M_node_lower_bound(__n, __k);
+      if (__pos < __n->_M_count && !_M_compare(__k, _S_key(__n, __pos)))
+        return 1;
+      __n = __n->_M_leaf ? 0 : __n->_M_child(__pos);
+    }
+    return 0;
+  }
+
+  size_type
+  count_multi(const key_type& __k) const
+  {
+    auto __p = equal_range(__k);
+    return tinySTL::distance(__p.first, __p.second);
+  }
+
+  iterator
+  lower_bound(const key_type& __k)
+  {
+    if (_M_root == nullptr)
+      return end();
+    iterator __it = _S_internal_last(_M_locate<false>(__k));
+    return __it._M_node ? __it : end();
+  }
+
+  const_iterator
+  lower_bound(const key_type& __k) const
+  { return const_cast<_Btree*>(this)->lower_bound(__k); }
+
+  iterator
+  upper_bound(const key_type& __k)
+  {
+    if (_M_root == nullptr)
+      return end();
+    iterator __it = _S_internal_last(_M_locate<true>(__k));
+    return __it._M_node ? __it : end();
+  }
+
+  const_iterator
+  upper_bound(const key_type& __k) const
+  { return const_cast<_Btree*>(this)->upper_bound(__k); }
+
+  tinySTL::pair<iterator, iterator>
+  equal_range(const key_type& __k)
+  { return {lower_bound(__k), upper_bound(__k)}; }
+
+  tinySTL::pair<const_iterator, const_iterator>
+  equal_range(const key_type& __k) const
+  { return {lower_bound(__k), upper_bound(__k)}; }
+
+  // check the B-tree invariants, for tests.
+ public:
+  bool _M_verify() const
+  {
+    if (_M_root == nullptr)
+      return _M_node_count == 0;
+    size_t __count = 0;
+    int __depth = -1;
+    return _M_root->_M_parent == nullptr
+        && _M_verify_node(_M_root, 0, __depth, __count)
+        && __count == _M_node_count;
+  }
+
+  bool _M_verify_node(const _Node* __n, int __level, int& __depth, size_t& __count) const
+  {
+    if (__n != _M_root && __n->_M_count == 0)
+      return false;
+    for (size_t __i = 1; __i < __n->_M_count; ++__i)
+      if (_M_compare(_S_key(__n, __i), _S_key(__n, __i - 1)))
+        return false;
+    __count += __n->_M_count;
+    if (__n->_M_leaf) {
+      if (__depth < 0) __depth = __level;
+      return __depth == __level;
+    }
+    for (size_t __i = 0; __i <= __n->_M_count; ++__i) {
+      const _Node* __c = __n->_M_child(__i);
+      if (__c->_M_parent != __n || __c->_M_position != __i)
+        return false;
+      if (__i > 0 && _M_compare(_S_key(__c, 0), _S_key(__n, __i - 1)))
+        return false;
+      if (__i < __n->_M_count
+       && _M_compare(_S_key(__n, __i), _S_key(__c, __c->_M_count - 1)))
+        return false;
+      if (!_M_verify_node(__c, __level + 1, __depth, __count))
+        return false;
+    }
+    return true;
+  }
+};
+
+}
@@ -0,0 +1,213 @@
+// tinySTL: epoch based reclamation for the lock-free containers.
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+
+namespace tinySTL
+{
+
+/**
+ * @brief  an object unlinked from a lock-free structure, waiting until no
+ *  thread can still be reading it. The structure's nodes derive from it
+ *  and set _M_deleter to their own free function.
+ */
+struct _Epoch_retired
+{
+  _Epoch_retired* _M_retired_next;
+  void (*_M_deleter)(_Epoch_retired*);
+};
+
+/**
+ * @brief  the process wide epoch domain. A thread reads a lock-free
+ *  structure inside an _Epoch_guard, which publishes the global epoch it
+ *  saw. Retired objects are kept per thread, in one list per epoch, and
+ *  freed two epochs later: the epoch only moves on once every thread
+ *  inside a guard has seen the current one, so by then none can still
+ *  hold a pointer to them.
+ * @attention  a guard belongs to the thread that made it.
+ */
+class _Epoch_domain
+{
+  friend class _Epoch_guard;
+
+  // one per thread, reused once the thread is gone.
+  struct _Record
+  {
+    std::atomic<uint64_t> _M_state;  // epoch << 1 | inside a guard
+    std::atomic<bool> _M_in_use;
+    _Record* _M_next;
+    // touched by the owning thread only.
+    unsigned _M_depth;
+    unsigned _M_retired;
+    _Epoch_retired* _M_limbo[3];
+    uint64_t _M_limbo_epoch[3];
+  };
+
+  // the calling thread's record, given back when the thread exits.
+  struct _Thread_slot
+  {
+    _Record* _M_rec;
+
+    _Thread_slot() : _M_rec(_Epoch_domain::_S_instance()._M_acquire()) {}
+
+    ~_Thread_slot()
+    {
+      _M_rec->_M_state.store(0, std::memory_order_release);
+      _M_rec->_M_in_use.store(false, std::memory_order_release);
+    }
+  };
+
+  enum { _S_advance_every = 64 };
+
+  std::atomic<uint64_t> _M_epoch;
+  std::atomic<_Record*> _M_records;
+
+  _Epoch_domain() : _M_epoch(0), _M_records(nullptr) {}
+
+  ~_Epoch_domain()
+  {
+    _Record* __r = _M_records.load();
+    while (__r != nullptr) {
+      for (int __i = 0; __i < 3; ++__i)
+        _S_free_list(__r->_M_limbo[__i]);
+      _Record* __next = __r->_M_next;
+      delete __r;
+      __r = __next;
+    }
+  }
+
+  _Record* _M_acquire()
+  {
+    for (_Record* __r = _M_records.load(); __r != nullptr; __r = __r->_M_next) {
+      bool __free = false;
+      if (!__r->_M_in_use.load() && __r->_M_in_use.compare_exchange_strong(__free, true))
+        return __r;
+    }
+    _Record* __r = new _Record;
+    __r->_M_state.store(0, std::memory_order_relaxed);
+    __r->_M_in_use.store(true, std::memory_order_relaxed);
+    __r->_M_depth = 0;
+    __r->_M_retired = 0;
+    for (int __i = 0; __i < 3; ++__i) {
+      __r->_M_limbo[__i] = nullptr;
+      __r->_M_limbo_epoch[__i] = 0;
+    }
+    _Record* __head = _M_records.load();
+    do {
+      __r->_M_next = __head;
+    } while (!_M_records.compare_exchange_weak(__head, __r));
+    return __r;
+  }
+
+  static void _S_free_list(_Epoch_retired* __p)
+  {
+    while (__p != nullptr) {
+      _Epoch_retired* __next = __p->_M_retired_next;
+      __p->_M_deleter(__p);
+      __p = __next;
+    }
+  }
+
+  // free the lists at least two epochs older than __e.
+  static void _S_collect(_Record* __r, uint64_t __e)
+  {
+    for (int __i = 0; __i < 3; ++__i) {
+      if (__r->_M_limbo[__i] != nullptr && __r->_M_limbo_epoch[__i] + 2 <= __e) {
+        _Epoch_retired* __p = __r->_M_limbo[__i];
+        __r->_M_limbo[__i] = nullptr;
+        _S_free_list(__p);
+      }
+    }
+  }
+
+  // move the global epoch on when every thread in a guard has seen it.
+  void _M_try_advance()
+  {
+    uint64_t __e = _M_epoch.load();
+    for (_Record* __r = _M_records.load(); __r != nullptr; __r = __r->_M_next) {
+      uint64_t __s = __r->_M_state.load();
+      if ((__s & 1) && (__s >> 1) != __e)
+        return;
+    }
+    _M_epoch.compare_exchange_strong(__e, __e + 1);
+  }
+
+  static _Epoch_domain& _S_instance()
+  {
+    static _Epoch_domain __d;
+    return __d;
+  }
+
+  static _Record* _S_thread_record()
+  {
+    static thread_local _Thread_slot __slot;
+    return __slot._M_rec;
+  }
+
+  void _M_enter(_Record* __r)
+  {
+    if (__r->_M_depth++ != 0)
+      return;
+    uint64_t __e = _M_epoch.load(std::memory_order_acquire);
+    // a read-modify-write, so a thread seeing it also sees what this
+    // thread read in its earlier guards.
+    __r->_M_state.exchange(__e << 1 | 1);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    _S_collect(__r, __e);
+  }
+
+  void _M_exit(_Record* __r)
+  {
+    if (--__r->_M_depth == 0)
+      __r->_M_state.store(__r->_M_state.load(std::memory_order_relaxed) & ~uint64_t(1),
+                          std::memory_order_release);
+  }
+
+  // __p is unreachable for threads entering from now on. It is filed
+  // under the global epoch, which may be one ahead of this thread's: a
+  // thread that entered before the unlink is at most there.
+  void _M_retire(_Record* __r, _Epoch_retired* __p)
+  {
+    uint64_t __e = _M_epoch.load();
+    int __i = __e % 3;
+    if (__r->_M_limbo_epoch[__i] != __e) {
+      // the list there is three epochs old.
+      _Epoch_retired* __old = __r->_M_limbo[__i];
+      __r->_M_limbo[__i] = nullptr;
+      __r->_M_limbo_epoch[__i] = __e;
+      _S_free_list(__old);
+    }
+    __p->_M_retired_next = __r->_M_limbo[__i];
+    __r->_M_limbo[__i] = __p;
+    if (++__r->_M_retired % _S_advance_every == 0)
+      _M_try_advance();
+  }
+};
+
+/**
+ * @brief  keeps the objects a thread may be looking at alive. Guards nest
+ *  and copies of one enter again.
+ */
+class _Epoch_guard
+{
+ public:
+  _Epoch_guard() : _M_rec(_Epoch_domain::_S_thread_record())
+  { _Epoch_domain::_S_instance()._M_enter(_M_rec); }
+
+  _Epoch_guard(const _Epoch_guard& __x) : _M_rec(__x._M_rec)
+  { _Epoch_domain::_S_instance()._M_enter(_M_rec); }
+
+  _Epoch_guard& operator=(const _Epoch_guard&) { return *this; }
+
+  ~_Epoch_guard() { _Epoch_domain::_S_instance()._M_exit(_M_rec); }
+
+  // hand __p to the domain, to be freed once no guard can reach it.
+  void _M_retire(_Epoch_retired* __p) const
+  { _Epoch_domain::_S_instance()._M_retire(_M_rec, __p); }
+
+ private:
+  _Epoch_domain::_Record* _M_rec;
+};
+
+}
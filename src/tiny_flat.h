@@ -0,0 +1,36 @@
+// tinySTL: helpers shared by the flat (sorted vector) containers.
+#pragma once
+
+#include <cstddef>
+
+namespace tinySTL
+{
+
+/**
+ * @brief  tags telling a flat container that its input is already sorted,
+ *  and free of equal keys for sorted_unique, so it is taken as is.
+ */
+struct sorted_unique_t { explicit sorted_unique_t() = default; };
+inline constexpr sorted_unique_t sorted_unique{};
+
+struct sorted_equivalent_t { explicit sorted_equivalent_t() = default; };
+inline constexpr sorted_equivalent_t sorted_equivalent{};
+
+/**
+ * @brief  whether the keys [__n, size) appended to the sorted keys [0, __n)
+ *  already follow them in order, so that a bulk insert has nothing to
+ *  sort or merge. With __unique equal neighbours do not count as ordered.
+ */
+template <class _KeyContainer, class _Compare>
+bool __flat_tail_in_order(const _KeyContainer& __keys, size_t __n,
+                          const _Compare& __comp, bool __unique)
+{
+  for (size_t __i = __n == 0 ? 1 : __n; __i < __keys.size(); ++__i) {
+    if (__unique ? !__comp(__keys[__i - 1], __keys[__i])
+                 : __comp(__keys[__i], __keys[__i - 1]))
+      return false;
+  }
+  return true;
+}
+
+}
@@ -67,26 +67,64 @@ struct _Select1st
   { return __x.first; }
 };
 
-template <class _Tp>
+template<typename _Pair>
+struct _Select2nd
+: public unary_function<_Pair, typename _Pair::second_type>
+{
+  typename _Pair::second_type&
+  operator()(_Pair& __x) const
+  { return __x.second; }
+
+  const typename _Pair::second_type&
+  operator()(const _Pair& __x) const
+  { return __x.second; }
+};
+
+template <class _Tp = void>
 struct less : binary_function<_Tp, _Tp, bool>
 {
   bool operator()(const _Tp& __x, const _Tp& __y) const
   { return __x < __y; }
 };
 
+/**
+ * @brief  less<> compares any two types with <. It is transparent: the
+ *  ordered containers then accept lookup keys of other types, e.g. a
+ *  const char* into a set<std::string, less<>>, without building a key.
+ */
+template <>
+struct less<void>
+{
+  typedef void is_transparent;
+
+  template <class _T1, class _T2> bool
+  operator()(const _T1& __x, const _T2& __y) const
+  { return __x < __y; }
+};
+
 struct __less {
   template <class _T1, class _T2> bool 
   operator()(const _T1& __x, const _T2& __y) const 
   { return __x < __y; }
 };
 
-template <class _Tp>
+template <class _Tp = void>
 struct greater : binary_function<_Tp, _Tp, bool>
 {
   bool operator()(const _Tp& __x, const _Tp& __y) const
   { return __x > __y; }
 };
 
+template <>
+struct greater<void>
+{
+  typedef void is_transparent;
+
+  template <class _T1, class _T2> bool
+  operator()(const _T1& __x, const _T2& __y) const
+  { return __x > __y; }
+};
+
 struct __greater {
   template <class _T1, class _T2> bool 
   operator()(const _T1& __x, const _T2& __y) const 
@@ -132,4 +170,8 @@ struct __equal_to {
   { return __x == __y; }
 };
 
-}
\ No newline at end of file
+// whether _Compare accepts lookup keys of other types than key_type.
+template <class _Compare>
+concept __is_transparent = requires { typename _Compare::is_transparent; };
+
+}
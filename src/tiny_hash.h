@@ -1,45 +1,65 @@
 #pragma once
 
+#include <cmath>
+
 #include "vector.h"
 #include "algorithm.h"
 #include "tiny_alloc.h"
 #include "tiny_iterator.h"
 #include "tiny_hash_fun.h"
+#include "tiny_node_handle.h"
 
 namespace tinySTL 
 {
 
-template <class _Tp>
+template <class _Tp, bool _CacheHash = false>
 struct _Hashtable_node
 {
   _Hashtable_node* _M_next;
   aligned_membuf<_Tp> _M_storage;
 };
 
+// a node that also keeps the hash of its element, for tables whose hash
+// is slow (see is_fast_hash): growing the table, ++ on an iterator and
+// erasing find the bucket from it, and a lookup compares it before keys.
+template <class _Tp>
+struct _Hashtable_node<_Tp, true>
+{
+  _Hashtable_node* _M_next;
+  size_t _M_hash;
+  aligned_membuf<_Tp> _M_storage;
+};
+
+template <class _Hash>
+inline constexpr bool __tiny_cache_hash = !is_fast_hash<_Hash>::value;
+
+struct prime_buckets;
+
 template <class _Key, class _Val, class _Hash, class _ExtractKey, 
-          class _EqualKey, class _Alloc = tinySTL::allocator<_Val>>
+          class _EqualKey, class _Alloc = tinySTL::allocator<_Val>,
+          class _Buckets = prime_buckets>
 class hashtable;
 
 template <class _Key, class _Val, class _Hash, class _ExtractKey, 
-          class _EqualKey, class _Alloc>
+          class _EqualKey, class _Alloc, class _Buckets>
 struct _Hashtable_iterator;
 
 template <class _Key, class _Val, class _Hash, class _ExtractKey, 
-          class _EqualKey, class _Alloc>
+          class _EqualKey, class _Alloc, class _Buckets>
 struct _Hashtable_const_iterator;
 
 template <class _Key, class _Val, class _Hash, class _ExtractKey, 
-          class _EqualKey, class _Alloc>
+          class _EqualKey, class _Alloc, class _Buckets>
 struct _Hashtable_iterator 
 {
-  typedef _Hashtable_node<_Val> _Node;
-  typedef hashtable<_Key, _Val, _Hash, _ExtractKey, _EqualKey, _Alloc> 
+  typedef _Hashtable_node<_Val, __tiny_cache_hash<_Hash>> _Node;
+  typedef hashtable<_Key, _Val, _Hash, _ExtractKey, _EqualKey, _Alloc, _Buckets> 
           _Hashtable;
   typedef _Hashtable_iterator
-          <_Key, _Val, _Hash, _ExtractKey, _EqualKey, _Alloc>
+          <_Key, _Val, _Hash, _ExtractKey, _EqualKey, _Alloc, _Buckets>
           iterator;
   typedef _Hashtable_const_iterator
-          <_Key, _Val, _Hash, _ExtractKey, _EqualKey, _Alloc>
+          <_Key, _Val, _Hash, _ExtractKey, _EqualKey, _Alloc, _Buckets>
           const_iterator;
 
   typedef forward_iterator_tag iterator_category;
@@ -66,7 +86,7 @@ struct _Hashtable_iterator
     const _Node* __old = _M_cur;
     _M_cur = _M_cur->_M_next;
     if (!_M_cur) {
-      size_type __bucket = _M_ht->_M_bkt_num(*__old->_M_storage.ptr());
+      size_type __bucket = _M_ht->_M_bkt_num_node(__old);
       while (!_M_cur && ++__bucket < _M_ht->_M_buckets.size())
         _M_cur = _M_ht->_M_buckets[__bucket];
     }
@@ -88,17 +108,17 @@ struct _Hashtable_iterator
 };
 
 template <class _Key, class _Val, class _Hash, class _ExtractKey, 
-          class _EqualKey, class _Alloc>
+          class _EqualKey, class _Alloc, class _Buckets>
 struct _Hashtable_const_iterator 
 {
-  typedef _Hashtable_node<_Val> _Node;
-  typedef hashtable<_Key, _Val, _Hash, _ExtractKey, _EqualKey, _Alloc> 
+  typedef _Hashtable_node<_Val, __tiny_cache_hash<_Hash>> _Node;
+  typedef hashtable<_Key, _Val, _Hash, _ExtractKey, _EqualKey, _Alloc, _Buckets> 
           _Hashtable;
   typedef _Hashtable_iterator
-          <_Key, _Val, _Hash, _ExtractKey, _EqualKey, _Alloc>
+          <_Key, _Val, _Hash, _ExtractKey, _EqualKey, _Alloc, _Buckets>
           iterator;
   typedef _Hashtable_const_iterator
-          <_Key, _Val, _Hash, _ExtractKey, _EqualKey, _Alloc>
+          <_Key, _Val, _Hash, _ExtractKey, _EqualKey, _Alloc, _Buckets>
           const_iterator;
 
   typedef forward_iterator_tag iterator_category;
@@ -132,7 +152,7 @@ struct _Hashtable_const_iterator
     const _Node* __old = _M_cur;
     _M_cur = _M_cur->_M_next;
     if (!_M_cur) {
-      size_type __bucket = _M_ht->_M_bkt_num(*__old->_M_storage.ptr());
+      size_type __bucket = _M_ht->_M_bkt_num_node(__old);
       while (!_M_cur && ++__bucket < _M_ht->_M_buckets.size())
         _M_cur = _M_ht->_M_buckets[__bucket];
     }
@@ -167,7 +187,6 @@ static const unsigned long __tiny_prime_list[__tiny_num_primes] =
   1610612741ul, 3221225473ul, 4294967291ul
 };
 
-#include <algorithm>
 inline unsigned long __tiny_next_prime(unsigned long __n)
 {
   const unsigned long* __first = __tiny_prime_list;
@@ -176,17 +195,65 @@ inline unsigned long __tiny_next_prime(unsigned long __n)
   return pos == __last ? *(__last - 1) : *pos;
 }
 
+/**
+ * @brief  bucket policy of hashtable: a prime number of buckets from
+ *  __tiny_prime_list, the hash taken modulo it. Weak hashes such as the
+ *  identity on integers spread well, at the cost of a division by a
+ *  runtime value on every lookup, insert and rehash.
+ *
+ *  A bucket policy has three static calls: the bucket count to use for
+ *  a request of at least __n, the largest bucket count, and the bucket
+ *  of a hash value in a table of __n buckets.
+ */
+struct prime_buckets
+{
+  static size_t next_size(size_t __n) { return __tiny_next_prime(__n); }
+
+  static size_t max_size() { return __tiny_prime_list[(int)__tiny_num_primes - 1]; }
+
+  static size_t index(size_t __h, size_t __n) { return __h % __n; }
+};
+
+/**
+ * @brief  bucket policy of hashtable: a power of two number of buckets,
+ *  the hash mixed by __tiny_hash_mix and masked, a multiply in place of
+ *  the division. The mix is what makes the mask safe: the identity hash
+ *  of integers that share their low bits would otherwise all land in
+ *  one bucket.
+ */
+struct pow2_buckets
+{
+  static constexpr size_t _S_min_size = 8;
+
+  static size_t next_size(size_t __n)
+  {
+    size_t __size = _S_min_size;
+    while (__size < __n && __size < max_size())
+      __size <<= 1;
+    return __size;
+  }
+
+  static size_t max_size() { return size_t(1) << (sizeof(size_t) * 8 - 1); }
 
-template <class _Key, class _Val, class _Hash, class _ExtractKey, class _EqualKey, class _Alloc>
+  static size_t index(size_t __h, size_t __n) { return __tiny_hash_mix(__h) & (__n - 1); }
+};
+
+/**
+ * @brief  hash table with separate chaining, under the unordered
+ *  containers.
+ * @param  _Buckets  bucket policy: prime_buckets, or pow2_buckets to trade
+ *  the division on every access for a multiply.
+ */
+template <class _Key, class _Val, class _Hash, class _ExtractKey, class _EqualKey, class _Alloc, class _Buckets>
 class hashtable {
 
-template<class, class, class, class> friend class unordered_set;
-template<class, class, class, class> friend class unordered_multiset;
-template<class, class, class, class, class> friend class unordered_map;
-template<class, class, class, class, class> friend class unordered_multimap;
-template<class, class, class, class, class, class> friend class hashtable;
-template<class, class, class, class, class, class> friend class _Hashtable_iterator;
-template<class, class, class, class, class, class> friend class _Hashtable_const_iterator;
+template<class, class, class, class, class> friend class unordered_set;
+template<class, class, class, class, class> friend class unordered_multiset;
+template<class, class, class, class, class, class> friend class unordered_map;
+template<class, class, class, class, class, class> friend class unordered_multimap;
+template<class, class, class, class, class, class, class> friend class hashtable;
+template<class, class, class, class, class, class, class> friend class _Hashtable_iterator;
+template<class, class, class, class, class, class, class> friend class _Hashtable_const_iterator;
 
 protected:
   typedef _Key key_type;
@@ -205,7 +272,8 @@ protected:
   key_equal key_eq() const { return _M_equals; }
 
 private:
-  typedef _Hashtable_node<value_type> _Node;
+  static constexpr bool _S_cache_hash = __tiny_cache_hash<_Hash>;
+  typedef _Hashtable_node<value_type, _S_cache_hash> _Node;
   typedef typename _Alloc_rebind<_Alloc, _Node>::type _Node_allocator;
 
 protected:
@@ -214,15 +282,15 @@ protected:
   _Node* _M_get_node() { return _M_alloc.allocate(1); }
   void _M_put_node(_Node* __p) { _M_alloc.deallocate(__p, 1); }
 
-  typedef _Hashtable_iterator<_Key, _Val, _Hash, _ExtractKey, _EqualKey, _Alloc>
+  typedef _Hashtable_iterator<_Key, _Val, _Hash, _ExtractKey, _EqualKey, _Alloc, _Buckets>
           iterator;
-  typedef _Hashtable_const_iterator<_Key, _Val, _Hash, _ExtractKey, _EqualKey, _Alloc>
+  typedef _Hashtable_const_iterator<_Key, _Val, _Hash, _ExtractKey, _EqualKey, _Alloc, _Buckets>
           const_iterator;
 
   friend struct
-  _Hashtable_iterator<_Val, _Key, _Hash, _ExtractKey, _EqualKey, _Alloc>;
+  _Hashtable_iterator<_Val, _Key, _Hash, _ExtractKey, _EqualKey, _Alloc, _Buckets>;
   friend struct
-  _Hashtable_const_iterator<_Val, _Key, _Hash, _ExtractKey, _EqualKey, _Alloc>;
+  _Hashtable_const_iterator<_Val, _Key, _Hash, _ExtractKey, _EqualKey, _Alloc, _Buckets>;
 
 private:
   typedef typename _Alloc_rebind<_Alloc, _Node*>::type _Bkt_allocator;
@@ -364,7 +432,7 @@ protected:
   size_type bucket_count() const { return _M_buckets.size(); }
 
   size_type max_bucket_count() const
-  { return __tiny_prime_list[(int)__tiny_num_primes - 1]; } 
+  { return _Buckets::max_size(); }
 
   size_type elems_in_bucket(size_type __bucket) const 
   {
@@ -399,14 +467,16 @@ protected:
   template <class _Arg> pair<iterator, bool> 
   _M_insert_unique_noresize(_Arg&& __obj) 
   {
-    const size_type __n = _M_bkt_num(__obj);
+    const size_t __code = _M_hash(_M_get_key(__obj));
+    const size_type __n = _Buckets::index(__code, _M_buckets.size());
     _Node* __first = _M_buckets[__n];
 
     for (_Node* __cur = __first; __cur; __cur = __cur->_M_next) 
-      if (_M_equals(_M_get_key(*__cur->_M_storage.ptr()), _M_get_key(__obj)))
+      if (_M_node_equals(__cur, _M_get_key(__obj), __code))
         return pair<iterator, bool>(iterator(__cur, this), false);
 
     _Node* __tmp = _M_new_node(tinySTL::forward<_Arg>(__obj));
+    _M_store_hash(__tmp, __code);
     __tmp->_M_next = __first;
     _M_buckets[__n] = __tmp;
     ++_M_num_elements;
@@ -416,12 +486,14 @@ protected:
   template <class _Arg> iterator 
   _M_insert_equal_noresize(_Arg&& __obj) 
   {
-    const size_type __n = _M_bkt_num(__obj);
+    const size_t __code = _M_hash(_M_get_key(__obj));
+    const size_type __n = _Buckets::index(__code, _M_buckets.size());
     _Node* __first = _M_buckets[__n];
 
     for (_Node* __cur = __first; __cur; __cur = __cur->_M_next) 
-      if (_M_equals(_M_get_key(*__cur->_M_storage.ptr()), _M_get_key(__obj))) {
+      if (_M_node_equals(__cur, _M_get_key(__obj), __code)) {
         _Node* __tmp = _M_new_node(tinySTL::forward<_Arg>(__obj));
+        _M_store_hash(__tmp, __code);
         __tmp->_M_next = __cur->_M_next;
         __cur->_M_next = __tmp;
         ++_M_num_elements;
@@ -429,6 +501,7 @@ protected:
       }
 
     _Node* __tmp = _M_new_node(tinySTL::forward<_Arg>(__obj));
+    _M_store_hash(__tmp, __code);
     __tmp->_M_next = __first;
     _M_buckets[__n] = __tmp;
     ++_M_num_elements;
@@ -440,7 +513,9 @@ protected:
   {
     if (__hint != 0 && _M_equals(_M_get_key(*__hint->_M_storage.ptr()), _M_get_key(__obj))) {
       _Node* __tmp = _M_new_node(tinySTL::forward<_Arg>(__obj));
-      const size_type __n = _M_bkt_num(*__hint->_M_storage.ptr());
+      if constexpr (_S_cache_hash)
+        __tmp->_M_hash = __hint->_M_hash;
+      const size_type __n = _M_bkt_num_node(__hint);
       _Node* __first = _M_buckets[__n];
       if (__hint == __first) {
         _M_buckets[__n] = __tmp;
@@ -477,14 +552,17 @@ protected:
   _M_insert_node_unique(_Node* __node) 
   {
     _M_ensure(_M_num_elements + 1);
+    // hashed again, the node may come from a table with another hasher.
     value_type* valptr = __node->_M_storage.ptr();
-    const size_type __n = _M_bkt_num(*valptr);
+    const size_t __code = _M_hash(_M_get_key(*valptr));
+    const size_type __n = _Buckets::index(__code, _M_buckets.size());
     _Node* __first = _M_buckets[__n];
 
     for (_Node* __cur = __first; __cur; __cur = __cur->_M_next) 
-      if (_M_equals(_M_get_key(*__cur->_M_storage.ptr()), _M_get_key(*valptr)))
+      if (_M_node_equals(__cur, _M_get_key(*valptr), __code))
         return pair<iterator, bool>(iterator(__cur, this), false);
     _Node* __tmp = __node;
+    _M_store_hash(__tmp, __code);
     __tmp->_M_next = __first;
     _M_buckets[__n] = __tmp;
     ++_M_num_elements;
@@ -495,12 +573,14 @@ protected:
   {
     _M_ensure(_M_num_elements + 1);
     value_type* valptr = __node->_M_storage.ptr();
-    const size_type __n = _M_bkt_num(*valptr);
+    const size_t __code = _M_hash(_M_get_key(*valptr));
+    const size_type __n = _Buckets::index(__code, _M_buckets.size());
     _Node* __first = _M_buckets[__n];
 
     for (_Node* __cur = __first; __cur; __cur = __cur->_M_next) 
-      if (_M_equals(_M_get_key(*__cur->_M_storage.ptr()), _M_get_key(*valptr))) {
+      if (_M_node_equals(__cur, _M_get_key(*valptr), __code)) {
         _Node* __tmp = __node;
+        _M_store_hash(__tmp, __code);
         __tmp->_M_next = __cur->_M_next;
         __cur->_M_next = __tmp;
         ++_M_num_elements;
@@ -508,6 +588,7 @@ protected:
       }
 
     _Node* __tmp = __node;
+    _M_store_hash(__tmp, __code);
     __tmp->_M_next = __first;
     _M_buckets[__n] = __tmp;
     ++_M_num_elements;
@@ -541,10 +622,11 @@ protected:
 
   iterator find(const key_type& __key) 
   {
-    size_type __n = _M_bkt_num_key(__key);
+    const size_t __code = _M_hash(__key);
+    size_type __n = _Buckets::index(__code, _M_buckets.size());
     _Node* __first;
     for ( __first = _M_buckets[__n];
-          __first && !_M_equals(_M_get_key(*__first->_M_storage.ptr()), __key);
+          __first && !_M_node_equals(__first, __key, __code);
           __first = __first->_M_next)
       {}
     return iterator(__first, this);
@@ -552,10 +634,11 @@ protected:
 
   const_iterator find(const key_type& __key) const 
   {
-    size_type __n = _M_bkt_num_key(__key);
+    const size_t __code = _M_hash(__key);
+    size_type __n = _Buckets::index(__code, _M_buckets.size());
     const _Node* __first;
     for ( __first = _M_buckets[__n];
-          __first && !_M_equals(_M_get_key(*__first->_M_storage.ptr()), __key);
+          __first && !_M_node_equals(__first, __key, __code);
           __first = __first->_M_next)
       {}
     return const_iterator(__first, this);
@@ -563,9 +646,10 @@ protected:
 
   size_type count_unique(const key_type& __key) const 
   {
-    const size_type __n = _M_bkt_num_key(__key);
+    const size_t __code = _M_hash(__key);
+    const size_type __n = _Buckets::index(__code, _M_buckets.size());
     for (const _Node* __cur = _M_buckets[__n]; __cur; __cur = __cur->_M_next)
-      if (_M_equals(_M_get_key(*__cur->_M_storage.ptr()), __key)) {
+      if (_M_node_equals(__cur, __key, __code)) {
         return 1;
       } 
     return 0;
@@ -573,11 +657,12 @@ protected:
 
   size_type count_equal(const key_type& __key) const 
   {
-    const size_type __n = _M_bkt_num_key(__key);
+    const size_t __code = _M_hash(__key);
+    const size_type __n = _Buckets::index(__code, _M_buckets.size());
     size_type __result = 0;
     bool __match = false;
     for (const _Node* __cur = _M_buckets[__n]; __cur; __cur = __cur->_M_next)
-      if (_M_equals(_M_get_key(*__cur->_M_storage.ptr()), __key)) {
+      if (_M_node_equals(__cur, __key, __code)) {
         ++__result;
         __match = true;
       } else if (__match) {
@@ -590,12 +675,13 @@ protected:
   equal_range(const key_type& __key) 
   {
     typedef pair<iterator, iterator> _Pii;
-    const size_type __n = _M_bkt_num_key(__key);
+    const size_t __code = _M_hash(__key);
+    const size_type __n = _Buckets::index(__code, _M_buckets.size());
 
     for (_Node* __first = _M_buckets[__n]; __first; __first = __first->_M_next)
-      if (_M_equals(_M_get_key(*__first->_M_storage.ptr()), __key)) {
+      if (_M_node_equals(__first, __key, __code)) {
         for (_Node* __cur = __first->_M_next; __cur; __cur = __cur->_M_next)
-          if (!_M_equals(_M_get_key(*__cur->_M_storage.ptr()), __key))
+          if (!_M_node_equals(__cur, __key, __code))
             return _Pii(iterator(__first, this), iterator(__cur, this));
         for (size_type __m = __n + 1; __m < _M_buckets.size(); ++__m)
           if (_M_buckets[__m])
@@ -610,16 +696,17 @@ protected:
   equal_range(const key_type& __key) const 
   {
     typedef pair<const_iterator, const_iterator> _Pii;
-    const size_type __n = _M_bkt_num_key(__key);
+    const size_t __code = _M_hash(__key);
+    const size_type __n = _Buckets::index(__code, _M_buckets.size());
 
     for (const _Node* __first = _M_buckets[__n] ;
         __first; 
         __first = __first->_M_next) {
-      if (_M_equals(_M_get_key(*__first->_M_storage.ptr()), __key)) {
+      if (_M_node_equals(__first, __key, __code)) {
         for (const _Node* __cur = __first->_M_next;
             __cur;
             __cur = __cur->_M_next)
-          if (!_M_equals(_M_get_key(*__cur->_M_storage.ptr()), __key))
+          if (!_M_node_equals(__cur, __key, __code))
             return _Pii(const_iterator(__first, this),
                         const_iterator(__cur, this));
         for (size_type __m = __n + 1; __m < _M_buckets.size(); ++__m)
@@ -634,7 +721,8 @@ protected:
 
   size_type erase(const key_type& __key) 
   {
-    const size_type __n = _M_bkt_num_key(__key);
+    const size_t __code = _M_hash(__key);
+    const size_type __n = _Buckets::index(__code, _M_buckets.size());
     _Node* __first = _M_buckets[__n];
     size_type __erased = 0;
 
@@ -642,7 +730,7 @@ protected:
       _Node* __cur = __first;
       _Node* __next = __cur->_M_next;
       while (__next) {
-        if (_M_equals(_M_get_key(*__next->_M_storage.ptr()), __key)) {
+        if (_M_node_equals(__next, __key, __code)) {
           __cur->_M_next = __next->_M_next;
           _M_delete_node(__next);
           __next = __cur->_M_next;
@@ -654,7 +742,7 @@ protected:
           __next = __cur->_M_next;
         }
       }
-      if (_M_equals(_M_get_key(*__first->_M_storage.ptr()), __key)) {
+      if (_M_node_equals(__first, __key, __code)) {
         _M_buckets[__n] = __first->_M_next;
         _M_delete_node(__first);
         ++__erased;
@@ -668,40 +756,76 @@ protected:
   {
     _Node* __p = __it._M_cur;
     if (__p) {
-      const size_type __n = _M_bkt_num(*__p->_M_storage.ptr());
-      _Node* __cur = _M_buckets[__n];
-      iterator __it = iterator(__cur, this);
-      ++__it;
-      if (__cur == __p) {
-        _M_buckets[__n] = __cur->_M_next;
-        _M_delete_node(__cur);
-        --_M_num_elements;
-      } else {
-        _Node* __next = __cur->_M_next;
-        while (__next) {
-          if (__next == __p) {
-            __cur->_M_next = __next->_M_next;
-            _M_delete_node(__next);
-            --_M_num_elements;
-            break;
-          } else {
-            __cur = __next;
-            __next = __cur->_M_next;
-          }
-        }
-      }
-      return __it;
+      iterator __next = iterator(__p, this);
+      ++__next;
+      _M_delete_node(_M_unlink(__p));
+      return __next;
     }
     __tiny_throw_range_error("unordered_set: erase");
     return end();
   }
 
+  // take __p out of its bucket, the node is left to the caller.
+  _Node* _M_unlink(_Node* __p)
+  {
+    const size_type __n = _M_bkt_num_node(__p);
+    _Node* __cur = _M_buckets[__n];
+    if (__cur == __p) {
+      _M_buckets[__n] = __cur->_M_next;
+    } else {
+      while (__cur->_M_next != __p)
+        __cur = __cur->_M_next;
+      __cur->_M_next = __p->_M_next;
+    }
+    __p->_M_next = nullptr;
+    --_M_num_elements;
+    return __p;
+  }
+
+  // node handles, see tiny_node_handle.h.
+  template <class _NodeHandle>
+  _NodeHandle _M_extract(iterator __it)
+  {
+    if (__it._M_cur == nullptr)
+      __tiny_throw_range_error("unordered_set: extract");
+    return _NodeHandle(_M_unlink(__it._M_cur), _M_alloc);
+  }
+
+  template <class _NodeHandle>
+  _NodeHandle _M_extract_key(const key_type& __key)
+  {
+    iterator __it = find(__key);
+    if (__it == end())
+      return _NodeHandle();
+    return _M_extract<_NodeHandle>(__it);
+  }
+
+  // the node stays in __nh if its key is taken.
+  template <class _NodeHandle>
+  tinySTL::pair<iterator, bool> _M_reinsert_node_unique(_NodeHandle& __nh)
+  {
+    if (__nh.empty())
+      return {end(), false};
+    tinySTL::pair<iterator, bool> __r = _M_insert_node_unique(__nh._M_ptr);
+    if (__r.second)
+      __nh._M_release();
+    return __r;
+  }
+
+  template <class _NodeHandle>
+  iterator _M_reinsert_node_equal(_NodeHandle& __nh)
+  {
+    if (__nh.empty())
+      return end();
+    return _M_insert_node_equal(__nh._M_release());
+  }
+
   iterator erase(iterator __first, iterator __last) 
   {
     size_type __f_bucket = __first._M_cur ? 
-      _M_bkt_num(*(__first._M_cur->_M_storage.ptr())) : _M_buckets.size();
+      _M_bkt_num_node(__first._M_cur) : _M_buckets.size();
     size_type __l_bucket = __last._M_cur ? 
-      _M_bkt_num(*(__last._M_cur->_M_storage.ptr())) : _M_buckets.size();
+      _M_bkt_num_node(__last._M_cur) : _M_buckets.size();
 
     if (__first._M_cur == __last._M_cur)
       return __last;
@@ -745,9 +869,78 @@ protected:
     _M_num_elements = 0;
   }
 
+  /**
+   * @brief  move every element into a node of a contiguous run, bucket
+   *  by bucket, so that walking the table walks memory in order.
+   * @attention  invalidates every iterator. An element is moved if that
+   *  cannot throw and copied otherwise; if a copy throws, the table still
+   *  holds what it held.
+   */
+  void compact()
+  {
+    _Node_run<_Node_allocator> __run(_M_alloc, _M_num_elements);
+    try {
+      for (size_type __i = 0; __i < _M_buckets.size(); ++__i) {
+        for (_Node** __link = &_M_buckets[__i]; *__link != 0; __link = &(*__link)->_M_next) {
+          _Node* __x = *__link;
+          _Node* __y = __run._M_take();
+          try {
+            tinySTL::construct(__y->_M_storage.ptr(),
+                               tinySTL::move_if_noexcept(*__x->_M_storage.ptr()));
+          } catch (...) {
+            _M_put_node(__y);
+            throw;
+          }
+          if constexpr (_S_cache_hash)
+            __y->_M_hash = __x->_M_hash;
+          __y->_M_next = __x->_M_next;
+          *__link = __y;
+          _M_delete_node(__x);
+        }
+      }
+    } catch (...) {
+      __run._M_release();
+      throw;
+    }
+  }
+
+  /**
+   * @brief  call __f on every element, bucket by bucket. The heads of
+   *  the buckets a few slots ahead are prefetched, so the misses on them
+   *  overlap rather than come one after another as they do for ++ on an
+   *  iterator; within a chain the next node is prefetched before __f
+   *  runs on the current one.
+   * @attention  __f must not insert or erase.
+   */
+  template <class _Function>
+  void for_each(_Function& __f)
+  { _M_scan([&__f](_Node* __x) { __f(*__x->_M_storage.ptr()); }); }
+
+  template <class _Function>
+  void for_each(_Function& __f) const
+  { _M_scan([&__f](_Node* __x) { __f(static_cast<const _Val&>(*__x->_M_storage.ptr())); }); }
+
 private:
+  static constexpr size_type _S_prefetch_ahead = 16;
+
+  template <class _Visit>
+  void _M_scan(_Visit __visit) const
+  {
+    const size_type __n = _M_buckets.size();
+    for (size_type __i = 0; __i < __n; ++__i) {
+      if (__i + _S_prefetch_ahead < __n)
+        tinySTL::__tiny_prefetch(_M_buckets[__i + _S_prefetch_ahead]);
+      for (_Node* __cur = _M_buckets[__i]; __cur != 0; ) {
+        _Node* __next = __cur->_M_next;
+        tinySTL::__tiny_prefetch(__next);
+        __visit(__cur);
+        __cur = __next;
+      }
+    }
+  }
+
   size_type _M_next_size(size_type __n) const
-    { return __tiny_next_prime(__n); }
+    { return _Buckets::next_size(__n); }
 
   void _M_initialize_buckets(size_type __n) 
   {
@@ -766,13 +959,13 @@ private:
       for (size_type __i = 0; __i < __ht._M_buckets.size(); ++__i) {
         const _Node* __cur = __ht._M_buckets[__i];
         if (__cur) {
-          _Node* __copy = _M_new_node(*__cur->_M_storage.ptr());
+          _Node* __copy = _M_clone_node(__cur);
           _M_buckets[__i] = __copy;
 
           for (_Node* __next = __cur->_M_next;
                __next != nullptr;
                __cur = __next, __next = __cur->_M_next) {
-            __copy->_M_next = _M_new_node(*__next->_M_storage.ptr());
+            __copy->_M_next = _M_clone_node(__next);
             __copy = __copy->_M_next;
           }
         }
@@ -797,12 +990,36 @@ private:
     }
   }
 
+  _Node* _M_clone_node(const _Node* __p)
+  {
+    _Node* __n = _M_new_node(*__p->_M_storage.ptr());
+    if constexpr (_S_cache_hash)
+      __n->_M_hash = __p->_M_hash;
+    return __n;
+  }
+
   void _M_delete_node(_Node* __n)
   {
     tinySTL::destroy(__n->_M_storage.ptr());
     _M_put_node(__n);
   }
 
+  void _M_store_hash(_Node* __p, size_t __code)
+  {
+    if constexpr (_S_cache_hash)
+      __p->_M_hash = __code;
+  }
+
+  // whether __p holds __key, whose hash is __code. A cached hash is
+  // compared first, so keys are compared only on a likely match.
+  bool _M_node_equals(const _Node* __p, const key_type& __key, size_t __code) const
+  {
+    if constexpr (_S_cache_hash)
+      if (__p->_M_hash != __code)
+        return false;
+    return _M_equals(_M_get_key(*__p->_M_storage.ptr()), __key);
+  }
+
   size_type _M_bkt_num_key(const key_type& __key) const
   {
     return _M_bkt_num_key(__key, _M_buckets.size());
@@ -815,7 +1032,7 @@ private:
 
   size_type _M_bkt_num_key(const key_type& __key, size_t __n) const
   {
-    return _M_hash(__key) % __n;
+    return _Buckets::index(_M_hash(__key), __n);
   }
 
   size_type _M_bkt_num(const value_type& __obj, size_t __n) const
@@ -823,6 +1040,20 @@ private:
     return _M_bkt_num_key(_M_get_key(__obj), __n);
   }
 
+  size_type _M_bkt_num_node(const _Node* __p) const
+  {
+    return _M_bkt_num_node(__p, _M_buckets.size());
+  }
+
+  // the bucket of the element of __p, from its cached hash if it has one.
+  size_type _M_bkt_num_node(const _Node* __p, size_t __n) const
+  {
+    if constexpr (_S_cache_hash)
+      return _Buckets::index(__p->_M_hash, __n);
+    else
+      return _M_bkt_num(*__p->_M_storage.ptr(), __n);
+  }
+
   void _M_erase_bucket(const size_type __n, _Node* __first, _Node* __last)
   {
     _Node* __cur = _M_buckets[__n];
@@ -869,7 +1100,7 @@ private:
         for (size_type __bucket = 0; __bucket < __old_n; ++__bucket) {
           _Node* __first = _M_buckets[__bucket];
           while (__first) {
-            size_type __new_bucket = _M_bkt_num(*__first->_M_storage.ptr(), __n);
+            size_type __new_bucket = _M_bkt_num_node(__first, __n);
             _M_buckets[__bucket] = __first->_M_next;
             __first->_M_next = __tmp[__new_bucket];
             __tmp[__new_bucket] = __first;
@@ -899,7 +1130,7 @@ private:
   {
     const size_type __old_n = _M_buckets.size();
     if (__num_elements_hint > __old_n * _M_factor) {
-      const size_type __n = _M_next_size(ceil(__num_elements_hint/_M_factor));
+      const size_type __n = _M_next_size(std::ceil(__num_elements_hint/_M_factor));
       if (__n > __old_n) {
         decltype(_M_buckets) __tmp(__n, (_Node*)(0),
                                    _M_buckets.get_allocator());
@@ -907,7 +1138,7 @@ private:
           for (size_type __bucket = 0; __bucket < __old_n; ++__bucket) {
             _Node* __first = _M_buckets[__bucket];
             while (__first) {
-              size_type __new_bucket = _M_bkt_num(*__first->_M_storage.ptr(), __n);
+              size_type __new_bucket = _M_bkt_num_node(__first, __n);
               _M_buckets[__bucket] = __first->_M_next;
               __first->_M_next = __tmp[__new_bucket];
               __tmp[__new_bucket] = __first;
@@ -937,12 +1168,12 @@ private:
   }
 
   template <class _EqualKey2>
-  void _M_merge_unique(hashtable<_Key, _Val, _Hash, _ExtractKey, _EqualKey2, _Alloc>&& __table) 
+  void _M_merge_unique(hashtable<_Key, _Val, _Hash, _ExtractKey, _EqualKey2, _Alloc, _Buckets>&& __table) 
   {
     if (__table.empty()) {
       return;
     }
-    hashtable<_Key, _Val, _Hash, _ExtractKey, _EqualKey2, _Alloc> __tmp(0, hasher(), _EqualKey2(), allocator_type());
+    hashtable<_Key, _Val, _Hash, _ExtractKey, _EqualKey2, _Alloc, _Buckets> __tmp(0, hasher(), _EqualKey2(), allocator_type());
 
     size_type __num_buckets_x = __table.bucket_count();
     size_type __num_elements_x = __table.size();
@@ -963,7 +1194,7 @@ private:
   }
 
   template <class _EqualKey2>
-  void _M_merge_equal(hashtable<_Key, _Val, _Hash, _ExtractKey, _EqualKey2, _Alloc>&& __table) 
+  void _M_merge_equal(hashtable<_Key, _Val, _Hash, _ExtractKey, _EqualKey2, _Alloc, _Buckets>&& __table) 
   {
     if (__table.empty()) {
       return;
@@ -1,36 +1,286 @@
 #pragma once
 #include <cstddef>
+#include <cstdint>
+#include <cstring>
 #include <string>
+#include <string_view>
+
+#include "tiny_traits.h"
+
+// keys of __tiny_hash_long_min bytes and more are hashed with AVX2 on
+// processors that have it, found at run time. Set to 0 to hash every key
+// the same way everywhere.
+#ifndef __TINY_HASH_AVX2
+#if (defined(__x86_64__) || defined(__i386__)) && (defined(__GNUC__) || defined(__clang__))
+#define __TINY_HASH_AVX2 1
+#else
+#define __TINY_HASH_AVX2 0
+#endif
+#endif
+
+#if __TINY_HASH_AVX2
+#include <immintrin.h>
+#endif
 
 namespace tinySTL 
 {
 
 template <class _Tp> struct hash {};
 
-inline size_t __stl_hash_string(const char* __s)
+// the 128 bit product of __a and __b, its halves xored.
+inline uint64_t __tiny_mum(uint64_t __a, uint64_t __b) noexcept
+{
+#if defined(__SIZEOF_INT128__)
+  __uint128_t __m = (__uint128_t)__a * __b;
+  return (uint64_t)(__m >> 64) ^ (uint64_t)__m;
+#else
+  uint64_t __ha = __a >> 32, __hb = __b >> 32, __la = (uint32_t)__a, __lb = (uint32_t)__b;
+  uint64_t __rh = __ha * __hb, __rm0 = __ha * __lb, __rm1 = __hb * __la, __rl = __la * __lb;
+  uint64_t __t = __rl + (__rm0 << 32);
+  uint64_t __c = __t < __rl;
+  uint64_t __lo = __t + (__rm1 << 32);
+  __c += __lo < __t;
+  uint64_t __hi = __rh + (__rm0 >> 32) + (__rm1 >> 32) + __c;
+  return __hi ^ __lo;
+#endif
+}
+
+/**
+ * @brief  spread the bits of a hash code over the whole word. The
+ *  hashes here are the identity on integers, which is fine for a prime
+ *  bucket count but leaves a table indexed by low bits, or tagged by a
+ *  few of them, at the mercy of the key pattern.
+ */
+inline size_t __tiny_hash_mix(size_t __h) noexcept
+{ return (size_t)__tiny_mum(__h, 0x9E3779B97F4A7C15ull); }
+
+inline uint64_t __tiny_read64(const unsigned char* __p) noexcept
+{
+  uint64_t __v;
+  memcpy(&__v, __p, 8);
+  return __v;
+}
+
+inline uint64_t __tiny_read32(const unsigned char* __p) noexcept
+{
+  uint32_t __v;
+  memcpy(&__v, __p, 4);
+  return __v;
+}
+
+// the keys of the long path: 16 stripes of 8 take keys from 0 to 23, the
+// scramble the last 8. Any odd-looking constants do; these are splitmix64.
+struct _Tiny_hash_secret
+{
+  uint64_t _M_key[24];
+
+  constexpr _Tiny_hash_secret() : _M_key()
+  {
+    uint64_t __x = 0;
+    for (uint64_t& __k : _M_key) {
+      uint64_t __z = (__x += 0x9E3779B97F4A7C15ull);
+      __z = (__z ^ (__z >> 30)) * 0xBF58476D1CE4E5B9ull;
+      __z = (__z ^ (__z >> 27)) * 0x94D049BB133111EBull;
+      __k = __z ^ (__z >> 31);
+    }
+  }
+};
+
+inline constexpr _Tiny_hash_secret __tiny_hash_secret{};
+
+inline constexpr size_t __tiny_hash_stripe = 64;
+inline constexpr size_t __tiny_hash_block = 16 * __tiny_hash_stripe;
+inline constexpr size_t __tiny_hash_long_min = 1024;
+
+/**
+ * @brief  fold __n stripes of 64 bytes into 8 accumulators, stripe s with
+ *  the keys from __key + s: each lane adds the product of the two halves
+ *  of its word xor the key, and its neighbour adds the word itself, so no
+ *  input is lost when a half is zero.
+ * @attention  the definition of the long path; __tiny_hash_stripes_avx2
+ *  computes the same sums, four lanes at a time.
+ */
+inline void __tiny_hash_stripes_scalar(uint64_t* __acc, const unsigned char* __p, size_t __n,
+                                       const uint64_t* __key) noexcept
+{
+  for (size_t __s = 0; __s < __n; ++__s, __p += __tiny_hash_stripe)
+    for (size_t __i = 0; __i < 8; ++__i) {
+      uint64_t __d = __tiny_read64(__p + 8 * __i);
+      uint64_t __k = __d ^ __key[__s + __i];
+      __acc[__i ^ 1] += __d;
+      __acc[__i] += (__k & 0xFFFFFFFF) * (__k >> 32);
+    }
+}
+
+// after every block, so the high bits of the sums reach the low ones.
+inline void __tiny_hash_scramble_scalar(uint64_t* __acc) noexcept
 {
-  uint64_t __hash = 0;
-  for (int i = 0; *__s; i++) {
-    if (i & 1) {
-      __hash ^= ~((__hash << 11) ^ (*__s++) ^ (__hash >> 5));
+  for (size_t __i = 0; __i < 8; ++__i) {
+    uint64_t __a = __acc[__i] ^ (__acc[__i] >> 47);
+    __acc[__i] = (__a ^ __tiny_hash_secret._M_key[16 + __i]) * 0x9E3779B1u;
+  }
+}
+
+#if __TINY_HASH_AVX2
+__attribute__((target("avx2")))
+inline void __tiny_hash_stripes_avx2(uint64_t* __acc, const unsigned char* __p, size_t __n,
+                                     const uint64_t* __key) noexcept
+{
+  __m256i __a[2];
+  for (int __j = 0; __j < 2; ++__j)
+    __a[__j] = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(__acc) + __j);
+  for (size_t __s = 0; __s < __n; ++__s, __p += __tiny_hash_stripe)
+    for (int __j = 0; __j < 2; ++__j) {
+      __m256i __d = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(__p) + __j);
+      __m256i __k = _mm256_xor_si256(__d, _mm256_loadu_si256(
+          reinterpret_cast<const __m256i*>(__key + __s) + __j));
+      __m256i __prod = _mm256_mul_epu32(__k, _mm256_srli_epi64(__k, 32));
+      __m256i __swap = _mm256_shuffle_epi32(__d, _MM_SHUFFLE(1, 0, 3, 2));
+      __a[__j] = _mm256_add_epi64(__a[__j], _mm256_add_epi64(__prod, __swap));
+    }
+  for (int __j = 0; __j < 2; ++__j)
+    _mm256_storeu_si256(reinterpret_cast<__m256i*>(__acc) + __j, __a[__j]);
+}
+
+__attribute__((target("avx2")))
+inline void __tiny_hash_scramble_avx2(uint64_t* __acc) noexcept
+{
+  const __m256i __prime = _mm256_set1_epi32((int)0x9E3779B1u);
+  for (int __j = 0; __j < 2; ++__j) {
+    __m256i __a = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(__acc) + __j);
+    __a = _mm256_xor_si256(__a, _mm256_srli_epi64(__a, 47));
+    __a = _mm256_xor_si256(__a, _mm256_loadu_si256(
+        reinterpret_cast<const __m256i*>(__tiny_hash_secret._M_key + 16) + __j));
+    __m256i __lo = _mm256_mul_epu32(__a, __prime);
+    __m256i __hi = _mm256_mul_epu32(_mm256_srli_epi64(__a, 32), __prime);
+    _mm256_storeu_si256(reinterpret_cast<__m256i*>(__acc) + __j,
+                        _mm256_add_epi64(__lo, _mm256_slli_epi64(__hi, 32)));
+  }
+}
+
+inline bool __tiny_cpu_has_avx2() noexcept
+{
+  static const bool __has = __builtin_cpu_supports("avx2");
+  return __has;
+}
+#endif
+
+/**
+ * @brief  hash of a key of at least 64 bytes, 64 at a time in 8 lanes of
+ *  32x32 bit products, in the manner of XXH3.
+ * @param  _Simd  sum with AVX2, which the processor must have; the hash
+ *  is the same either way.
+ */
+template <bool _Simd>
+inline uint64_t __tiny_hash_long(const unsigned char* __p, size_t __len, uint64_t __seed) noexcept
+{
+  const uint64_t* __key = __tiny_hash_secret._M_key;
+  uint64_t __acc[8];
+  for (size_t __i = 0; __i < 8; ++__i)
+    __acc[__i] = __key[__i] ^ __seed;
+  auto __stripes = [&](const unsigned char* __q, size_t __n, const uint64_t* __k) {
+#if __TINY_HASH_AVX2
+    if constexpr (_Simd)
+      return __tiny_hash_stripes_avx2(__acc, __q, __n, __k);
+#endif
+    __tiny_hash_stripes_scalar(__acc, __q, __n, __k);
+  };
+  auto __scramble = [&] {
+#if __TINY_HASH_AVX2
+    if constexpr (_Simd)
+      return __tiny_hash_scramble_avx2(__acc);
+#endif
+    __tiny_hash_scramble_scalar(__acc);
+  };
+  const size_t __blocks = (__len - 1) / __tiny_hash_block;
+  for (size_t __b = 0; __b < __blocks; ++__b, __p += __tiny_hash_block) {
+    __stripes(__p, 16, __key);
+    __scramble();
+  }
+  const size_t __rest = __len - __blocks * __tiny_hash_block;
+  __stripes(__p, (__rest - 1) / __tiny_hash_stripe, __key);
+  // the last 64 bytes, overlapping what came before.
+  __stripes(__p + __rest - __tiny_hash_stripe, 1, __key + 7);
+
+  uint64_t __h = __len * 0x9E3779B185EBCA87ull;
+  for (size_t __i = 0; __i < 8; __i += 2)
+    __h += __tiny_mum(__acc[__i] ^ __key[__i + 1], __acc[__i + 1] ^ __key[__i + 2]);
+  __h ^= __h >> 37;
+  __h *= 0x165667919E3779F9ull;
+  return __h ^ (__h >> 32);
+}
+
+/**
+ * @brief  64 bit hash of __len bytes, in the manner of wyhash: keys up to
+ *  16 bytes take two reads that cover them, overlapping, longer ones go
+ *  16 bytes a step in 64x64 bit products, three chains at once past 48.
+ *  The length is part of the hash.
+ * @attention  with AVX2, keys of __tiny_hash_long_min bytes and more go
+ *  through __tiny_hash_long instead, which is faster there and only
+ *  there. The hash of a long key is the same within a process, not from
+ *  one machine to another.
+ */
+inline size_t __tiny_hash_bytes(const void* __ptr, size_t __len, uint64_t __seed = 0) noexcept
+{
+  static constexpr uint64_t __s0 = 0xa0761d6478bd642full, __s1 = 0xe7037ed1a0b428dbull,
+                            __s2 = 0x8ebc6af09c88c6e3ull, __s3 = 0x589965cc75374cc3ull;
+  const unsigned char* __p = static_cast<const unsigned char*>(__ptr);
+#if __TINY_HASH_AVX2
+  if (__len >= __tiny_hash_long_min && __tiny_cpu_has_avx2())
+    return (size_t)__tiny_hash_long<true>(__p, __len, __seed);
+#endif
+  __seed ^= __tiny_mum(__seed ^ __s0, __s1);
+  uint64_t __a, __b;
+  if (__len <= 16) {
+    if (__len >= 4) {
+      const size_t __off = (__len >> 3) << 2;
+      __a = (__tiny_read32(__p) << 32) | __tiny_read32(__p + __off);
+      __b = (__tiny_read32(__p + __len - 4) << 32) | __tiny_read32(__p + __len - 4 - __off);
+    } else if (__len > 0) {
+      __a = ((uint64_t)__p[0] << 16) | ((uint64_t)__p[__len >> 1] << 8) | __p[__len - 1];
+      __b = 0;
     } else {
-      __hash ^= ((__hash << 7) ^ (*__s++) ^ (__hash >> 3));
+      __a = __b = 0;
+    }
+  } else {
+    size_t __i = __len;
+    if (__i > 48) {
+      uint64_t __see1 = __seed, __see2 = __seed;
+      do {
+        __seed = __tiny_mum(__tiny_read64(__p) ^ __s1, __tiny_read64(__p + 8) ^ __seed);
+        __see1 = __tiny_mum(__tiny_read64(__p + 16) ^ __s2, __tiny_read64(__p + 24) ^ __see1);
+        __see2 = __tiny_mum(__tiny_read64(__p + 32) ^ __s3, __tiny_read64(__p + 40) ^ __see2);
+        __p += 48;
+        __i -= 48;
+      } while (__i > 48);
+      __seed ^= __see1 ^ __see2;
+    }
+    while (__i > 16) {
+      __seed = __tiny_mum(__tiny_read64(__p) ^ __s1, __tiny_read64(__p + 8) ^ __seed);
+      __p += 16;
+      __i -= 16;
     }
+    __a = __tiny_read64(__p + __i - 16);
+    __b = __tiny_read64(__p + __i - 8);
   }
-  return size_t(__hash & 0x7FFFFFFF);
+  return (size_t)__tiny_mum(__s1 ^ __len, __tiny_mum(__a ^ __s1, __b ^ __seed));
 }
 
 template <> struct hash<char*>
 {
-  size_t operator()(const char* __s) const { return __stl_hash_string(__s); }
+  size_t operator()(const char* __s) const { return __tiny_hash_bytes(__s, strlen(__s)); }
 };
 template <> struct hash<const char*>
 {
-  size_t operator()(const char* __s) const { return __stl_hash_string(__s); }
+  size_t operator()(const char* __s) const { return __tiny_hash_bytes(__s, strlen(__s)); }
 };
 template <> struct hash<std::string>
 {
-  size_t operator()(const std::string& __s) const { return __stl_hash_string(__s.c_str()); }
+  size_t operator()(const std::string& __s) const { return __tiny_hash_bytes(__s.data(), __s.size()); }
+};
+template <> struct hash<std::string_view>
+{
+  size_t operator()(std::string_view __s) const { return __tiny_hash_bytes(__s.data(), __s.size()); }
 };
 template <> struct hash<char> {
   size_t operator()(char __x) const { return __x; }
@@ -76,4 +326,16 @@ template <> struct hash<double> {
   }
 };
 
+/**
+ * @brief  whether _Hash costs about as much as a load from memory. A
+ *  hashtable keeps the hash of each element in its node when it does
+ *  not, and then never hashes an element again once it is in.
+ * @attention  specialize to false_type for a costly hash of your own.
+ */
+template <class _Hash> struct is_fast_hash : true_type {};
+template <> struct is_fast_hash<hash<char*>> : false_type {};
+template <> struct is_fast_hash<hash<const char*>> : false_type {};
+template <> struct is_fast_hash<hash<std::string>> : false_type {};
+template <> struct is_fast_hash<hash<std::string_view>> : false_type {};
+
 }
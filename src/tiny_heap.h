@@ -59,7 +59,7 @@ bool __shift_down(_RandomAccessIterator __first,
     if (__bestChild + 1 < __len 
      && __comp(*(__first + __bestChild), *(__first + __bestChild + 1)))
       ++__bestChild;
-    if (*(__first + __bestChild) < __tmp) break;
+    if (__comp(*(__first + __bestChild), __tmp)) break;
     *(__first + __holeIndex) = tinySTL::move(*(__first + __bestChild));
     __holeIndex = __bestChild;
     __bestChild = __holeIndex * 2 + 1;
@@ -0,0 +1,42 @@
+// tinySTL: helpers shared by the intrusive containers.
+#pragma once
+
+#include <cstddef>
+
+#include "tiny_alloc.h"
+
+namespace tinySTL
+{
+
+/**
+ * @brief  byte offset of the member @p __member inside a @p _Tp object.
+ *  Only the address is computed, no _Tp is ever constructed.
+ */
+template <class _Tp, class _Member>
+inline ptrdiff_t __tiny_member_offset(_Member _Tp::* __member) noexcept
+{
+  aligned_membuf<_Tp> __buf;
+  const _Tp* __p = __buf.ptr();
+  return reinterpret_cast<const char*>(&(__p->*__member))
+       - reinterpret_cast<const char*>(__p);
+}
+
+/**
+ * @brief  maps a value to the hook member that links it into an
+ *  intrusive container, and a hook back to its value.
+ */
+template <class _Tp, class _Hook, _Hook _Tp::* _PtrToHook>
+struct _Intrusive_member_traits
+{
+  static _Hook* _S_to_node(const _Tp& __v) noexcept
+    { return const_cast<_Hook*>(&(__v.*_PtrToHook)); }
+
+  static _Tp* _S_to_value(const _Hook* __n) noexcept
+    {
+      return reinterpret_cast<_Tp*>(
+        const_cast<char*>(reinterpret_cast<const char*>(__n))
+        - __tiny_member_offset(_PtrToHook));
+    }
+};
+
+}
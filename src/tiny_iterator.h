@@ -5,6 +5,16 @@
 namespace tinySTL
 {
 
+// what __it's operator-> gives, which need not be &*__it for proxy
+// iterators.
+template <class _Iterator>
+inline auto __arrow(const _Iterator& __it) {
+  if constexpr (is_pointer_v<_Iterator>)
+    return __it;
+  else
+    return __it.operator->();
+}
+
 template <class _Iterator, class _IteratorTag>
 class __const_iterator 
 {
@@ -211,7 +221,11 @@ public:
     return *--__tmp;
   }
 
-  pointer operator->() const { return &(operator*()); }
+  pointer operator->() const {
+    _Iterator __tmp = current;
+    --__tmp;
+    return __arrow(__tmp);
+  }
 
   _Self& operator++() {
     --current;
@@ -357,7 +371,11 @@ public:
     return *--__tmp;
   }
 
-  pointer operator->() const { return &(operator*()); }
+  pointer operator->() const {
+    _Iterator __tmp = current;
+    --__tmp;
+    return __arrow(__tmp);
+  }
 
   _Self& operator++() {
     --current;
@@ -534,7 +552,11 @@ public:
     return *--__tmp;
   }
 
-  pointer operator->() const { return &(operator*()); }
+  pointer operator->() const {
+    _Iterator __tmp = current;
+    --__tmp;
+    return __arrow(__tmp);
+  }
 
   _Self& operator++() {
     --current;
@@ -605,6 +627,34 @@ public:
 };
 
 
+// a const view of a segmented iterator is segmented as well.
+template <class _Iterator, class _IteratorTag>
+requires requires { typename _Iterator::_Segmented_traits; }
+struct __segmented_iterator_traits<__const_iterator<_Iterator, _IteratorTag>>
+{
+  typedef true_type __is_segmented_iterator;
+  typedef __segmented_iterator_traits<_Iterator> _Base;
+  typedef __const_iterator<_Iterator, _IteratorTag> _Self;
+  typedef typename _Base::__segment_iterator __segment_iterator;
+  typedef const typename iterator_traits<_Iterator>::value_type* __local_iterator;
+
+  static __segment_iterator __segment(const _Self& __it)
+    { return _Base::__segment(__it.base()); }
+
+  static __local_iterator __local(const _Self& __it)
+    { return _Base::__local(__it.base()); }
+
+  static __local_iterator __begin(__segment_iterator __s)
+    { return _Base::__begin(__s); }
+
+  static __local_iterator __end(__segment_iterator __s)
+    { return _Base::__end(__s); }
+
+  static _Self __compose(__segment_iterator __s, __local_iterator __l)
+    { return _Self(_Base::__compose(__s, const_cast<typename _Base::__local_iterator>(__l))); }
+};
+
+
 template <class _Iterator>
 using const_iterator = __const_iterator<
   _Iterator, typename iterator_traits<_Iterator>::iterator_category>;
@@ -128,6 +128,33 @@ value_type(const _Iter&)
 }
 
 
+////////////////////////////////////////////////////////////////////////////
+// segmented iterator.
+////////////////////////////////////////////////////////////////////////////
+
+/**
+ * @brief  An iterator over a sequence of contiguous blocks (e.g. deque)
+ *  is segmented. Such an iterator exposes a nested _Segmented_traits with
+ *  @c __segment_iterator, @c __local_iterator and the static functions
+ *  @c __segment, @c __local, @c __begin, @c __end and @c __compose, so
+ *  that algorithms can walk it one block at a time on raw local iterators.
+ */
+template <class _Iter>
+struct __segmented_iterator_traits {
+  typedef false_type __is_segmented_iterator;
+};
+
+template <class _Iter>
+requires requires { typename _Iter::_Segmented_traits; }
+struct __segmented_iterator_traits<_Iter> : _Iter::_Segmented_traits {
+  typedef true_type __is_segmented_iterator;
+};
+
+template <class _Iter>
+using __is_segmented_iterator =
+  typename __segmented_iterator_traits<_Iter>::__is_segmented_iterator;
+
+
 ////////////////////////////////////////////////////////////////////////////
 // distance.
 ////////////////////////////////////////////////////////////////////////////
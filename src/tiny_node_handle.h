@@ -0,0 +1,159 @@
+// tinySTL: node handles of the node based associative containers.
+#pragma once
+
+#include "tiny_pair.h"
+#include "tiny_construct.h"
+
+namespace tinySTL
+{
+
+template <class, class, class, class, class, bool, class> class _Rb_tree;
+template <class, class, class, class, class, class, class> class hashtable;
+
+/**
+ * @brief  owns a node taken out of a container by extract(). It goes
+ *  back into a container of the same kind with insert(node_type&&),
+ *  without freeing, allocating or copying the value; a handle that is
+ *  never inserted frees its node.
+ */
+template <class _Val, class _Node, class _NodeAlloc>
+class _Node_handle_base
+{
+  template <class, class, class, class, class, bool, class> friend class _Rb_tree;
+  template <class, class, class, class, class, class, class> friend class hashtable;
+
+ public:
+  typedef _NodeAlloc allocator_type;
+
+  _Node_handle_base(const _Node_handle_base&) = delete;
+
+  _Node_handle_base& operator=(const _Node_handle_base&) = delete;
+
+  bool empty() const noexcept { return _M_ptr == nullptr; }
+
+  explicit operator bool() const noexcept { return _M_ptr != nullptr; }
+
+  allocator_type get_allocator() const { return _M_alloc; }
+
+ protected:
+  _Node* _M_ptr;
+  _NodeAlloc _M_alloc;
+
+  _Node_handle_base() noexcept : _M_ptr(nullptr), _M_alloc() {}
+
+  _Node_handle_base(_Node* __p, const _NodeAlloc& __a) noexcept : _M_ptr(__p), _M_alloc(__a) {}
+
+  _Node_handle_base(_Node_handle_base&& __x) noexcept
+  : _M_ptr(__x._M_ptr), _M_alloc(__x._M_alloc)
+  { __x._M_ptr = nullptr; }
+
+  _Node_handle_base& operator=(_Node_handle_base&& __x) noexcept
+  {
+    if (this != &__x) {
+      _M_reset();
+      _M_ptr = __x._M_ptr;
+      _M_alloc = __x._M_alloc;
+      __x._M_ptr = nullptr;
+    }
+    return *this;
+  }
+
+  ~_Node_handle_base() { _M_reset(); }
+
+  _Val& _M_value() const noexcept { return *_M_ptr->_M_storage.ptr(); }
+
+  // give the node up to a container.
+  _Node* _M_release() noexcept
+  {
+    _Node* __p = _M_ptr;
+    _M_ptr = nullptr;
+    return __p;
+  }
+
+  void _M_reset() noexcept
+  {
+    if (_M_ptr != nullptr) {
+      tinySTL::destroy(_M_ptr->_M_storage.ptr());
+      _M_alloc.deallocate(_M_ptr, 1);
+      _M_ptr = nullptr;
+    }
+  }
+
+  void _M_swap(_Node_handle_base& __x) noexcept
+  {
+    _Node* __p = _M_ptr;
+    _M_ptr = __x._M_ptr;
+    __x._M_ptr = __p;
+    _NodeAlloc __a = _M_alloc;
+    _M_alloc = __x._M_alloc;
+    __x._M_alloc = __a;
+  }
+};
+
+// node_type of set, multiset, unordered_set and unordered_multiset.
+template <class _Val, class _Node, class _NodeAlloc>
+class _Set_node_handle : public _Node_handle_base<_Val, _Node, _NodeAlloc>
+{
+  typedef _Node_handle_base<_Val, _Node, _NodeAlloc> _Base;
+
+  template <class, class, class, class, class, bool, class> friend class _Rb_tree;
+  template <class, class, class, class, class, class, class> friend class hashtable;
+
+ public:
+  typedef _Val value_type;
+
+  _Set_node_handle() noexcept {}
+
+  _Set_node_handle(_Set_node_handle&&) noexcept = default;
+
+  _Set_node_handle& operator=(_Set_node_handle&&) noexcept = default;
+
+  value_type& value() const noexcept { return this->_M_value(); }
+
+  void swap(_Set_node_handle& __x) noexcept { this->_M_swap(__x); }
+
+ protected:
+  _Set_node_handle(_Node* __p, const _NodeAlloc& __a) noexcept : _Base(__p, __a) {}
+};
+
+// node_type of map, multimap, unordered_map and unordered_multimap. The
+// key can be changed before the node is inserted again.
+template <class _Key, class _Mapped, class _Node, class _NodeAlloc>
+class _Map_node_handle : public _Node_handle_base<tinySTL::pair<const _Key, _Mapped>, _Node, _NodeAlloc>
+{
+  typedef _Node_handle_base<tinySTL::pair<const _Key, _Mapped>, _Node, _NodeAlloc> _Base;
+
+  template <class, class, class, class, class, bool, class> friend class _Rb_tree;
+  template <class, class, class, class, class, class, class> friend class hashtable;
+
+ public:
+  typedef _Key key_type;
+  typedef _Mapped mapped_type;
+
+  _Map_node_handle() noexcept {}
+
+  _Map_node_handle(_Map_node_handle&&) noexcept = default;
+
+  _Map_node_handle& operator=(_Map_node_handle&&) noexcept = default;
+
+  key_type& key() const noexcept { return const_cast<key_type&>(this->_M_value().first); }
+
+  mapped_type& mapped() const noexcept { return this->_M_value().second; }
+
+  void swap(_Map_node_handle& __x) noexcept { this->_M_swap(__x); }
+
+ protected:
+  _Map_node_handle(_Node* __p, const _NodeAlloc& __a) noexcept : _Base(__p, __a) {}
+};
+
+// what insert(node_type&&) of a unique container returns; node keeps the
+// handle when the key was taken.
+template <class _Iterator, class _NodeHandle>
+struct _Node_insert_return
+{
+  _Iterator position;
+  bool inserted;
+  _NodeHandle node;
+};
+
+}
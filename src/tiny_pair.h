@@ -22,6 +22,20 @@ struct pair {
 
   pair(const _T1& __a, const _T2& __b) : first(__a), second(__b) {}
 
+  // explicit unless both members convert implicitly, as for std::pair.
+  template <class _U1, class _U2>
+    requires is_constructible_v<_T1, _U1&&> && is_constructible_v<_T2, _U2&&>
+  explicit(!(is_convertible_v<_U1&&, _T1> && is_convertible_v<_U2&&, _T2>))
+  pair(_U1&& __a, _U2&& __b) : first(tinySTL::forward<_U1>(__a)), second(tinySTL::forward<_U2>(__b)) {}
+
+  /**
+   * @brief  build first and second in place from the two argument tuples,
+   *  for members that can be neither copied nor moved.
+   */
+  template <class... _Args1, class... _Args2>
+  pair(std::piecewise_construct_t, std::tuple<_Args1...> __a, std::tuple<_Args2...> __b)
+  : pair(__a, __b, std::index_sequence_for<_Args1...>(), std::index_sequence_for<_Args2...>()) {}
+
   template <class _U1, class _U2>
   pair(const pair<_U1, _U2>& __p) : first(__p.first), second(__p.second) {}
 
@@ -49,6 +63,14 @@ struct pair {
     return *this;
   }
 
+private:
+  template <class... _Args1, class... _Args2, size_t... _I1, size_t... _I2>
+  pair(std::tuple<_Args1...>& __a, std::tuple<_Args2...>& __b,
+       std::index_sequence<_I1...>, std::index_sequence<_I2...>)
+  : first(tinySTL::forward<_Args1>(std::get<_I1>(__a))...),
+    second(tinySTL::forward<_Args2>(std::get<_I2>(__b))...) {}
+
+public:
   friend std::ostream& operator<<(std::ostream& os, const pair& __pair) 
   {
     return os << '{' << __pair.first << ", " << __pair.second << '}';
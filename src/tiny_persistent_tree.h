@@ -0,0 +1,691 @@
+// tinySTL: persistent red-black tree under persistent_map.
+#pragma once
+
+#include <atomic>
+
+#include "tiny_pair.h"
+#include "tiny_alloc.h"
+#include "tiny_errors.h"
+#include "tiny_iterator.h"
+#include "tiny_construct.h"
+
+namespace tinySTL
+{
+
+/**
+ * @brief  node of a persistent tree. It has no parent link, as one node
+ *  is shared by every version of the tree holding it, and is freed with
+ *  the last version that does.
+ */
+template <class _Val>
+struct _Persistent_tree_node
+{
+  _Persistent_tree_node* _M_left;
+  _Persistent_tree_node* _M_right;
+  std::atomic<size_t> _M_refs;
+  bool _M_red;
+  aligned_membuf<_Val> _M_storage;
+
+  _Val* _M_valptr() { return _M_storage.ptr(); }
+
+  const _Val* _M_valptr() const { return _M_storage.ptr(); }
+};
+
+/**
+ * @brief  bidirectional iterator of a persistent tree. Without parent
+ *  links it keeps the path from the root to its node.
+ * @attention  it stays valid while the version it came from is alive.
+ */
+template <class _Val>
+struct _Persistent_tree_iterator
+{
+  typedef bidirectional_iterator_tag iterator_category;
+  typedef _Val value_type;
+  typedef const _Val& reference;
+  typedef const _Val* pointer;
+  typedef ptrdiff_t difference_type;
+
+  typedef _Persistent_tree_iterator _Self;
+  typedef const _Persistent_tree_node<_Val>* _Link_type;
+
+  // a red-black tree of 2^31 elements is at most 62 high.
+  enum { _S_max_depth = 64 };
+
+  _Link_type _M_root;
+  int _M_depth;
+  _Link_type _M_path[_S_max_depth];
+
+  _Persistent_tree_iterator() : _M_root(nullptr), _M_depth(0) {}
+
+  explicit _Persistent_tree_iterator(_Link_type __root) : _M_root(__root), _M_depth(0) {}
+
+  _Persistent_tree_iterator(const _Self& __x) : _M_root(__x._M_root), _M_depth(__x._M_depth)
+  {
+    for (int __i = 0; __i < _M_depth; ++__i)
+      _M_path[__i] = __x._M_path[__i];
+  }
+
+  _Self& operator=(const _Self& __x)
+  {
+    _M_root = __x._M_root;
+    _M_depth = __x._M_depth;
+    for (int __i = 0; __i < _M_depth; ++__i)
+      _M_path[__i] = __x._M_path[__i];
+    return *this;
+  }
+
+  _Link_type _M_node() const { return _M_depth ? _M_path[_M_depth - 1] : nullptr; }
+
+  void _M_push(_Link_type __x) { _M_path[_M_depth++] = __x; }
+
+  void _M_push_leftmost(_Link_type __x)
+  {
+    for (; __x != nullptr; __x = __x->_M_left)
+      _M_push(__x);
+  }
+
+  void _M_push_rightmost(_Link_type __x)
+  {
+    for (; __x != nullptr; __x = __x->_M_right)
+      _M_push(__x);
+  }
+
+  reference operator*() const { return *_M_node()->_M_valptr(); }
+
+  pointer operator->() const { return _M_node()->_M_valptr(); }
+
+  _Self& operator++()
+  {
+    _Link_type __x = _M_node();
+    if (__x->_M_right != nullptr) {
+      _M_push_leftmost(__x->_M_right);
+    } else {
+      _Link_type __child;
+      do {
+        __child = _M_path[--_M_depth];
+      } while (_M_depth != 0 && _M_path[_M_depth - 1]->_M_right == __child);
+    }
+    return *this;
+  }
+
+  // from end() to the last element.
+  _Self& operator--()
+  {
+    _Link_type __x = _M_node();
+    if (__x == nullptr) {
+      _M_push_rightmost(_M_root);
+    } else if (__x->_M_left != nullptr) {
+      _M_push_rightmost(__x->_M_left);
+    } else {
+      _Link_type __child;
+      do {
+        __child = _M_path[--_M_depth];
+      } while (_M_depth != 0 && _M_path[_M_depth - 1]->_M_left == __child);
+    }
+    return *this;
+  }
+
+  _Self operator++(int)
+  {
+    _Self __tmp = *this;
+    ++*this;
+    return __tmp;
+  }
+
+  _Self operator--(int)
+  {
+    _Self __tmp = *this;
+    --*this;
+    return __tmp;
+  }
+
+  friend bool operator==(const _Self& __x, const _Self& __y) { return __x._M_node() == __y._M_node(); }
+
+  friend bool operator!=(const _Self& __x, const _Self& __y) { return __x._M_node() != __y._M_node(); }
+};
+
+/**
+ * @brief  red-black tree with path copying. Nodes are reference counted
+ *  and never change once two versions share them, so copying a tree is
+ *  O(1) and an update copies only the nodes on the path it rebuilds,
+ *  O(log n). Insert follows Okasaki and erase Kahrs, written over owned
+ *  references: a node made earlier in the same update is still private
+ *  and is reused instead of copied. An update builds the new version
+ *  beside the old one, so a throwing copy leaves the tree as it was.
+ * @attention  versions may be read and released from different threads;
+ *  one version is not to be changed while another thread reads it.
+ */
+template <class _Key, class _Val, class _KeyOfValue, class _Compare, class _Alloc>
+class _Persistent_tree
+{
+ public:
+  typedef _Key key_type;
+  typedef _Val value_type;
+  typedef _Compare key_compare;
+  typedef size_t size_type;
+  typedef ptrdiff_t difference_type;
+  typedef _Alloc allocator_type;
+  typedef _Persistent_tree_iterator<_Val> iterator;
+  typedef _Persistent_tree_iterator<_Val> const_iterator;
+  typedef tinySTL::reverse_iterator<const_iterator> reverse_iterator;
+  typedef tinySTL::reverse_iterator<const_iterator> const_reverse_iterator;
+
+ protected:
+  typedef _Persistent_tree_node<_Val> _Node;
+  typedef _Node* _Link_type;
+  typedef const _Node* _Const_Link_type;
+  typedef typename _Alloc_rebind<_Alloc, _Node>::type _Node_allocator;
+
+  // an owned reference to a node.
+  class _Ref
+  {
+   public:
+    _Ref() noexcept : _M_ptr(nullptr) {}
+
+    explicit _Ref(_Link_type __p) noexcept : _M_ptr(__p) {}
+
+    _Ref(_Ref&& __x) noexcept : _M_ptr(__x._M_ptr) { __x._M_ptr = nullptr; }
+
+    _Ref& operator=(_Ref&& __x) noexcept
+    {
+      _Link_type __p = __x._M_ptr;
+      __x._M_ptr = nullptr;
+      _S_release(_M_ptr);
+      _M_ptr = __p;
+      return *this;
+    }
+
+    ~_Ref() { _S_release(_M_ptr); }
+
+    _Link_type get() const noexcept { return _M_ptr; }
+
+    _Link_type operator->() const noexcept { return _M_ptr; }
+
+    explicit operator bool() const noexcept { return _M_ptr != nullptr; }
+
+    _Link_type release() noexcept
+    {
+      _Link_type __p = _M_ptr;
+      _M_ptr = nullptr;
+      return __p;
+    }
+
+    // only this reference can reach the node, so it may change.
+    bool unique() const noexcept
+    { return _M_ptr->_M_refs.load(std::memory_order_acquire) == 1; }
+
+   private:
+    _Link_type _M_ptr;
+  };
+
+  _Link_type _M_root;
+  size_type _M_node_count;
+  _Compare _M_key_compare;
+
+ public:
+  _Persistent_tree() : _M_root(nullptr), _M_node_count(0), _M_key_compare() {}
+
+  explicit _Persistent_tree(const _Compare& __comp)
+  : _M_root(nullptr), _M_node_count(0), _M_key_compare(__comp) {}
+
+  _Persistent_tree(const _Persistent_tree& __x)
+  : _M_root(_S_share(__x._M_root).release()), _M_node_count(__x._M_node_count),
+    _M_key_compare(__x._M_key_compare) {}
+
+  _Persistent_tree(_Persistent_tree&& __x) noexcept
+  : _M_root(__x._M_root), _M_node_count(__x._M_node_count), _M_key_compare(__x._M_key_compare)
+  {
+    __x._M_root = nullptr;
+    __x._M_node_count = 0;
+  }
+
+  _Persistent_tree& operator=(const _Persistent_tree& __x)
+  {
+    _Link_type __root = _S_share(__x._M_root).release();
+    _S_release(_M_root);
+    _M_root = __root;
+    _M_node_count = __x._M_node_count;
+    _M_key_compare = __x._M_key_compare;
+    return *this;
+  }
+
+  _Persistent_tree& operator=(_Persistent_tree&& __x) noexcept
+  {
+    if (this != &__x) {
+      _S_release(_M_root);
+      _M_root = __x._M_root;
+      _M_node_count = __x._M_node_count;
+      _M_key_compare = __x._M_key_compare;
+      __x._M_root = nullptr;
+      __x._M_node_count = 0;
+    }
+    return *this;
+  }
+
+  ~_Persistent_tree() { _S_release(_M_root); }
+
+  key_compare key_comp() const { return _M_key_compare; }
+
+  const_iterator begin() const
+  {
+    const_iterator __it(_M_root);
+    __it._M_push_leftmost(_M_root);
+    return __it;
+  }
+
+  const_iterator end() const { return const_iterator(_M_root); }
+
+  size_type size() const { return _M_node_count; }
+
+  size_type max_size() const { return (size_type(1) << 31) - 1; }
+
+  void swap(_Persistent_tree& __x) noexcept
+  {
+    tinySTL::swap(_M_root, __x._M_root);
+    tinySTL::swap(_M_node_count, __x._M_node_count);
+    tinySTL::swap(_M_key_compare, __x._M_key_compare);
+  }
+
+  void clear()
+  {
+    _S_release(_M_root);
+    _M_root = nullptr;
+    _M_node_count = 0;
+  }
+
+  template <class _Kt>
+  const_iterator lower_bound(const _Kt& __k) const
+  { return _M_bound(__k, [this](const _Key& __x, const _Kt& __y) { return _M_key_compare(__x, __y); }); }
+
+  template <class _Kt>
+  const_iterator upper_bound(const _Kt& __k) const
+  { return _M_bound(__k, [this](const _Key& __x, const _Kt& __y) { return !_M_key_compare(__y, __x); }); }
+
+  template <class _Kt>
+  const_iterator find(const _Kt& __k) const
+  {
+    const_iterator __it = lower_bound(__k);
+    if (__it._M_depth == 0 || _M_key_compare(__k, _S_key(__it._M_node())))
+      return end();
+    return __it;
+  }
+
+  // insert when the key is new.
+  template <class... _Args>
+  pair<const_iterator, bool> _M_emplace_unique(_Args&&... __args)
+  {
+    _Ref __z(_S_create_node(tinySTL::forward<_Args>(__args)...));
+    const_iterator __it = find(_S_key(__z.get()));
+    if (__it != end())
+      return pair<const_iterator, bool>(__it, false);
+    _M_check_length();
+    _Link_type __x = __z.get();
+    _Ref __root = _M_ins(_M_root, __z);
+    _M_commit(_S_blacken(tinySTL::move(__root)));
+    ++_M_node_count;
+    return pair<const_iterator, bool>(find(_S_key(__x)), true);
+  }
+
+  // insert, or replace the element of an equal key.
+  template <class... _Args>
+  pair<const_iterator, bool> _M_emplace_or_replace(_Args&&... __args)
+  {
+    _Ref __z(_S_create_node(tinySTL::forward<_Args>(__args)...));
+    const _Key& __k = _S_key(__z.get());
+    bool __found = find(__k) != end();
+    _Link_type __x = __z.get();
+    if (__found) {
+      _M_commit(_M_replace(_M_root, __z));
+    } else {
+      _M_check_length();
+      _Ref __root = _M_ins(_M_root, __z);
+      _M_commit(_S_blacken(tinySTL::move(__root)));
+      ++_M_node_count;
+    }
+    return pair<const_iterator, bool>(find(_S_key(__x)), !__found);
+  }
+
+  template <class _Kt>
+  size_type _M_erase_unique(const _Kt& __k)
+  {
+    if (find(__k) == end())
+      return 0;
+    _Ref __root = _M_del(_M_root, __k);
+    if (__root && __root->_M_red)
+      __root = _S_blacken(tinySTL::move(__root));
+    _M_commit(tinySTL::move(__root));
+    --_M_node_count;
+    return 1;
+  }
+
+  // red-black rules and order hold, and the size is right.
+  bool _M_verify() const
+  {
+    if (_M_root != nullptr && _M_root->_M_red)
+      return false;
+    size_type __count = 0;
+    return _M_black_height(_M_root, __count) >= 0 && __count == _M_node_count;
+  }
+
+ protected:
+  static const _Key& _S_key(_Const_Link_type __x) { return _KeyOfValue()(*__x->_M_valptr()); }
+
+  template <class _Kt, class _Less>
+  const_iterator _M_bound(const _Kt& __k, _Less __less) const
+  {
+    const_iterator __it(_M_root);
+    int __keep = 0;
+    for (_Const_Link_type __x = _M_root; __x != nullptr; ) {
+      __it._M_push(__x);
+      if (__less(_S_key(__x), __k)) {
+        __x = __x->_M_right;
+      } else {
+        __keep = __it._M_depth;
+        __x = __x->_M_left;
+      }
+    }
+    __it._M_depth = __keep;
+    return __it;
+  }
+
+  void _M_check_length() const
+  {
+    if (_M_node_count == max_size())
+      __tiny_throw_length_error("persistent tree: too many elements");
+  }
+
+  void _M_commit(_Ref&& __root) noexcept
+  {
+    _S_release(_M_root);
+    _M_root = __root.release();
+  }
+
+  static _Ref _S_share(_Link_type __x) noexcept
+  {
+    if (__x != nullptr)
+      __x->_M_refs.fetch_add(1, std::memory_order_relaxed);
+    return _Ref(__x);
+  }
+
+  static void _S_release(_Link_type __x) noexcept
+  {
+    while (__x != nullptr && __x->_M_refs.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+      _S_release(__x->_M_left);
+      _Link_type __right = __x->_M_right;
+      tinySTL::destroy(__x->_M_valptr());
+      _Node_allocator().deallocate(__x, 1);
+      __x = __right;
+    }
+  }
+
+  template <class... _Args>
+  static _Link_type _S_create_node(_Args&&... __args)
+  {
+    _Link_type __x = _Node_allocator().allocate(1);
+    try {
+      tinySTL::construct(__x->_M_valptr(), tinySTL::forward<_Args>(__args)...);
+    } catch (...) {
+      _Node_allocator().deallocate(__x, 1);
+      throw;
+    }
+    __x->_M_left = nullptr;
+    __x->_M_right = nullptr;
+    ::new (&__x->_M_refs) std::atomic<size_t>(1);
+    __x->_M_red = true;
+    return __x;
+  }
+
+  /**
+   * @brief  a node with the value of __src and the given color and
+   *  children. __src is reused when nothing else holds it, and copied
+   *  otherwise.
+   */
+  static _Ref _S_rebuild(_Ref&& __src, bool __red, _Ref&& __l, _Ref&& __r)
+  {
+    _Link_type __x;
+    if (__src.unique()) {
+      __x = __src.release();
+      _Link_type __old_l = __x->_M_left;
+      _Link_type __old_r = __x->_M_right;
+      __x->_M_left = __l.release();
+      __x->_M_right = __r.release();
+      _S_release(__old_l);
+      _S_release(__old_r);
+    } else {
+      __x = _S_create_node(*__src->_M_valptr());
+      __x->_M_left = __l.release();
+      __x->_M_right = __r.release();
+    }
+    __x->_M_red = __red;
+    return _Ref(__x);
+  }
+
+  // the same node in another color.
+  static _Ref _S_recolor(_Ref&& __x, bool __red)
+  {
+    _Ref __l = _S_share(__x->_M_left);
+    _Ref __r = _S_share(__x->_M_right);
+    return _S_rebuild(tinySTL::move(__x), __red, tinySTL::move(__l), tinySTL::move(__r));
+  }
+
+  static _Ref _S_blacken(_Ref&& __x) { return _S_recolor(tinySTL::move(__x), false); }
+
+  static bool _S_is_red(_Const_Link_type __x) { return __x != nullptr && __x->_M_red; }
+
+  static bool _S_is_black(_Const_Link_type __x) { return __x != nullptr && !__x->_M_red; }
+
+  // a black node of __src over __l and __r, rotating away a red child
+  // with a red child, or red over two black nodes when both are red.
+  static _Ref _M_balance(_Ref&& __l, _Ref&& __src, _Ref&& __r)
+  {
+    if (_S_is_red(__l.get()) && _S_is_red(__r.get())) {
+      _Ref __bl = _S_blacken(tinySTL::move(__l));
+      _Ref __br = _S_blacken(tinySTL::move(__r));
+      return _S_rebuild(tinySTL::move(__src), true, tinySTL::move(__bl), tinySTL::move(__br));
+    }
+    if (_S_is_red(__l.get())) {
+      if (_S_is_red(__l->_M_left)) {
+        _Ref __ll = _S_share(__l->_M_left);
+        _Ref __c = _S_share(__l->_M_right);
+        _Ref __a = _S_share(__ll->_M_left);
+        _Ref __b = _S_share(__ll->_M_right);
+        _Ref __left = _S_rebuild(tinySTL::move(__ll), false, tinySTL::move(__a), tinySTL::move(__b));
+        _Ref __right = _S_rebuild(tinySTL::move(__src), false, tinySTL::move(__c), tinySTL::move(__r));
+        return _S_rebuild(tinySTL::move(__l), true, tinySTL::move(__left), tinySTL::move(__right));
+      }
+      if (_S_is_red(__l->_M_right)) {
+        _Ref __lr = _S_share(__l->_M_right);
+        _Ref __a = _S_share(__l->_M_left);
+        _Ref __b = _S_share(__lr->_M_left);
+        _Ref __c = _S_share(__lr->_M_right);
+        _Ref __left = _S_rebuild(tinySTL::move(__l), false, tinySTL::move(__a), tinySTL::move(__b));
+        _Ref __right = _S_rebuild(tinySTL::move(__src), false, tinySTL::move(__c), tinySTL::move(__r));
+        return _S_rebuild(tinySTL::move(__lr), true, tinySTL::move(__left), tinySTL::move(__right));
+      }
+    }
+    if (_S_is_red(__r.get())) {
+      if (_S_is_red(__r->_M_right)) {
+        _Ref __rr = _S_share(__r->_M_right);
+        _Ref __b = _S_share(__r->_M_left);
+        _Ref __c = _S_share(__rr->_M_left);
+        _Ref __d = _S_share(__rr->_M_right);
+        _Ref __left = _S_rebuild(tinySTL::move(__src), false, tinySTL::move(__l), tinySTL::move(__b));
+        _Ref __right = _S_rebuild(tinySTL::move(__rr), false, tinySTL::move(__c), tinySTL::move(__d));
+        return _S_rebuild(tinySTL::move(__r), true, tinySTL::move(__left), tinySTL::move(__right));
+      }
+      if (_S_is_red(__r->_M_left)) {
+        _Ref __rl = _S_share(__r->_M_left);
+        _Ref __b = _S_share(__rl->_M_left);
+        _Ref __c = _S_share(__rl->_M_right);
+        _Ref __d = _S_share(__r->_M_right);
+        _Ref __left = _S_rebuild(tinySTL::move(__src), false, tinySTL::move(__l), tinySTL::move(__b));
+        _Ref __right = _S_rebuild(tinySTL::move(__r), false, tinySTL::move(__c), tinySTL::move(__d));
+        return _S_rebuild(tinySTL::move(__rl), true, tinySTL::move(__left), tinySTL::move(__right));
+      }
+    }
+    return _S_rebuild(tinySTL::move(__src), false, tinySTL::move(__l), tinySTL::move(__r));
+  }
+
+  // __t with __z, whose key it does not hold, inserted.
+  _Ref _M_ins(_Link_type __t, _Ref& __z)
+  {
+    if (__t == nullptr)
+      return tinySTL::move(__z);
+    _Ref __l, __r;
+    if (_M_key_compare(_S_key(__z.get()), _S_key(__t))) {
+      __l = _M_ins(__t->_M_left, __z);
+      __r = _S_share(__t->_M_right);
+    } else {
+      __l = _S_share(__t->_M_left);
+      __r = _M_ins(__t->_M_right, __z);
+    }
+    if (__t->_M_red)
+      return _S_rebuild(_S_share(__t), true, tinySTL::move(__l), tinySTL::move(__r));
+    return _M_balance(tinySTL::move(__l), _S_share(__t), tinySTL::move(__r));
+  }
+
+  // __t with the node of __z's key swapped for __z.
+  _Ref _M_replace(_Link_type __t, _Ref& __z)
+  {
+    _Ref __l, __r, __src;
+    if (_M_key_compare(_S_key(__z.get()), _S_key(__t))) {
+      __l = _M_replace(__t->_M_left, __z);
+      __r = _S_share(__t->_M_right);
+      __src = _S_share(__t);
+    } else if (_M_key_compare(_S_key(__t), _S_key(__z.get()))) {
+      __l = _S_share(__t->_M_left);
+      __r = _M_replace(__t->_M_right, __z);
+      __src = _S_share(__t);
+    } else {
+      __l = _S_share(__t->_M_left);
+      __r = _S_share(__t->_M_right);
+      __src = tinySTL::move(__z);
+    }
+    return _S_rebuild(tinySTL::move(__src), __t->_M_red, tinySTL::move(__l), tinySTL::move(__r));
+  }
+
+  // __x must be black; the same node, red.
+  static _Ref _S_sub1(_Ref&& __x) { return _S_recolor(tinySTL::move(__x), true); }
+
+  // __l lost one black level under __src.
+  static _Ref _M_balleft(_Ref&& __l, _Ref&& __src, _Ref&& __r)
+  {
+    if (_S_is_red(__l.get())) {
+      _Ref __bl = _S_blacken(tinySTL::move(__l));
+      return _S_rebuild(tinySTL::move(__src), true, tinySTL::move(__bl), tinySTL::move(__r));
+    }
+    if (_S_is_black(__r.get())) {
+      _Ref __rr = _S_recolor(tinySTL::move(__r), true);
+      return _M_balance(tinySTL::move(__l), tinySTL::move(__src), tinySTL::move(__rr));
+    }
+    // __r red over a black left child.
+    _Ref __rl = _S_share(__r->_M_left);
+    _Ref __a = _S_share(__rl->_M_left);
+    _Ref __b = _S_share(__rl->_M_right);
+    _Ref __c = _S_sub1(_S_share(__r->_M_right));
+    _Ref __left = _S_rebuild(tinySTL::move(__src), false, tinySTL::move(__l), tinySTL::move(__a));
+    _Ref __right = _M_balance(tinySTL::move(__b), tinySTL::move(__r), tinySTL::move(__c));
+    return _S_rebuild(tinySTL::move(__rl), true, tinySTL::move(__left), tinySTL::move(__right));
+  }
+
+  // __r lost one black level under __src.
+  static _Ref _M_balright(_Ref&& __l, _Ref&& __src, _Ref&& __r)
+  {
+    if (_S_is_red(__r.get())) {
+      _Ref __br = _S_blacken(tinySTL::move(__r));
+      return _S_rebuild(tinySTL::move(__src), true, tinySTL::move(__l), tinySTL::move(__br));
+    }
+    if (_S_is_black(__l.get())) {
+      _Ref __rl = _S_recolor(tinySTL::move(__l), true);
+      return _M_balance(tinySTL::move(__rl), tinySTL::move(__src), tinySTL::move(__r));
+    }
+    // __l red over a black right child.
+    _Ref __lr = _S_share(__l->_M_right);
+    _Ref __a = _S_sub1(_S_share(__l->_M_left));
+    _Ref __b = _S_share(__lr->_M_left);
+    _Ref __c = _S_share(__lr->_M_right);
+    _Ref __left = _M_balance(tinySTL::move(__a), tinySTL::move(__l), tinySTL::move(__b));
+    _Ref __right = _S_rebuild(tinySTL::move(__src), false, tinySTL::move(__c), tinySTL::move(__r));
+    return _S_rebuild(tinySTL::move(__lr), true, tinySTL::move(__left), tinySTL::move(__right));
+  }
+
+  // the two subtrees of an erased node, joined.
+  static _Ref _M_app(_Ref&& __a, _Ref&& __b)
+  {
+    if (!__a)
+      return tinySTL::move(__b);
+    if (!__b)
+      return tinySTL::move(__a);
+    if (__a->_M_red == __b->_M_red) {
+      bool __red = __a->_M_red;
+      _Ref __bc = _M_app(_S_share(__a->_M_right), _S_share(__b->_M_left));
+      if (_S_is_red(__bc.get())) {
+        _Ref __bcl = _S_share(__bc->_M_left);
+        _Ref __bcr = _S_share(__bc->_M_right);
+        _Ref __al = _S_share(__a->_M_left);
+        _Ref __br = _S_share(__b->_M_right);
+        _Ref __left = _S_rebuild(tinySTL::move(__a), __red, tinySTL::move(__al), tinySTL::move(__bcl));
+        _Ref __right = _S_rebuild(tinySTL::move(__b), __red, tinySTL::move(__bcr), tinySTL::move(__br));
+        return _S_rebuild(tinySTL::move(__bc), true, tinySTL::move(__left), tinySTL::move(__right));
+      }
+      _Ref __br = _S_share(__b->_M_right);
+      _Ref __right = _S_rebuild(tinySTL::move(__b), __red, tinySTL::move(__bc), tinySTL::move(__br));
+      _Ref __al = _S_share(__a->_M_left);
+      if (__red)
+        return _S_rebuild(tinySTL::move(__a), true, tinySTL::move(__al), tinySTL::move(__right));
+      return _M_balleft(tinySTL::move(__al), tinySTL::move(__a), tinySTL::move(__right));
+    }
+    if (__b->_M_red) {
+      _Ref __br = _S_share(__b->_M_right);
+      _Ref __left = _M_app(tinySTL::move(__a), _S_share(__b->_M_left));
+      return _S_rebuild(tinySTL::move(__b), true, tinySTL::move(__left), tinySTL::move(__br));
+    }
+    _Ref __al = _S_share(__a->_M_left);
+    _Ref __right = _M_app(_S_share(__a->_M_right), tinySTL::move(__b));
+    return _S_rebuild(tinySTL::move(__a), true, tinySTL::move(__al), tinySTL::move(__right));
+  }
+
+  // __t without the node of __k, which it holds.
+  template <class _Kt>
+  _Ref _M_del(_Link_type __t, const _Kt& __k)
+  {
+    if (_M_key_compare(__k, _S_key(__t))) {
+      bool __black = _S_is_black(__t->_M_left);
+      _Ref __l = _M_del(__t->_M_left, __k);
+      _Ref __r = _S_share(__t->_M_right);
+      if (__black)
+        return _M_balleft(tinySTL::move(__l), _S_share(__t), tinySTL::move(__r));
+      return _S_rebuild(_S_share(__t), true, tinySTL::move(__l), tinySTL::move(__r));
+    }
+    if (_M_key_compare(_S_key(__t), __k)) {
+      bool __black = _S_is_black(__t->_M_right);
+      _Ref __l = _S_share(__t->_M_left);
+      _Ref __r = _M_del(__t->_M_right, __k);
+      if (__black)
+        return _M_balright(tinySTL::move(__l), _S_share(__t), tinySTL::move(__r));
+      return _S_rebuild(_S_share(__t), true, tinySTL::move(__l), tinySTL::move(__r));
+    }
+    return _M_app(_S_share(__t->_M_left), _S_share(__t->_M_right));
+  }
+
+  // black height of __x, -1 when a rule is broken below it.
+  int _M_black_height(_Const_Link_type __x, size_type& __count) const
+  {
+    if (__x == nullptr)
+      return 0;
+    ++__count;
+    if (__x->_M_red && (_S_is_red(__x->_M_left) || _S_is_red(__x->_M_right)))
+      return -1;
+    if (__x->_M_left != nullptr && !_M_key_compare(_S_key(__x->_M_left), _S_key(__x)))
+      return -1;
+    if (__x->_M_right != nullptr && !_M_key_compare(_S_key(__x), _S_key(__x->_M_right)))
+      return -1;
+    int __lh = _M_black_height(__x->_M_left, __count);
+    int __rh = _M_black_height(__x->_M_right, __count);
+    if (__lh < 0 || __lh != __rh)
+      return -1;
+    return __lh + (__x->_M_red ? 0 : 1);
+  }
+};
+
+}
@@ -0,0 +1,424 @@
+// tinySTL: lock-free skip list under concurrent_skiplist_map/set.
+#pragma once
+
+#include <new>
+#include <atomic>
+#include <cstdint>
+
+#include "tiny_pair.h"
+#include "tiny_alloc.h"
+#include "tiny_epoch.h"
+#include "tiny_iterator.h"
+#include "tiny_construct.h"
+
+namespace tinySTL
+{
+
+/**
+ * @brief  skip list node. Its tower of next links follows it in the same
+ *  allocation; the low bit of a link says the node is being removed at
+ *  that level.
+ */
+template <class _Val>
+struct _Skiplist_node : public _Epoch_retired
+{
+  typedef std::atomic<uintptr_t> _Link;
+
+  aligned_membuf<_Val> _M_storage;
+  // one for the inserting thread, one for the list; whoever lets go last
+  // retires the node.
+  std::atomic<int> _M_refs;
+  int _M_level;
+
+  _Val* _M_valptr() { return _M_storage.ptr(); }
+
+  _Link* _M_next() { return reinterpret_cast<_Link*>(this + 1); }
+
+  static _Skiplist_node* _S_ptr(uintptr_t __l)
+  { return reinterpret_cast<_Skiplist_node*>(__l & ~uintptr_t(1)); }
+
+  static bool _S_marked(uintptr_t __l) { return __l & 1; }
+
+  // the next node not being removed, or null.
+  static _Skiplist_node* _S_next_live(_Skiplist_node* __x)
+  {
+    _Skiplist_node* __n = _S_ptr(__x->_M_next()[0].load(std::memory_order_acquire));
+    while (__n != nullptr) {
+      uintptr_t __l = __n->_M_next()[0].load(std::memory_order_acquire);
+      if (!_S_marked(__l))
+        break;
+      __n = _S_ptr(__l);
+    }
+    return __n;
+  }
+};
+
+/**
+ * @brief  forward iterator of the skip list. It keeps the node it points
+ *  to readable, even after the node is erased, by holding an epoch guard.
+ * @attention  an iterator must stay on the thread that made it, and one
+ *  kept alive holds back the freeing of erased nodes.
+ */
+template <class _Val, class _Ref, class _Ptr>
+struct _Skiplist_iterator
+{
+  typedef forward_iterator_tag iterator_category;
+  typedef _Val value_type;
+  typedef _Ref reference;
+  typedef _Ptr pointer;
+  typedef ptrdiff_t difference_type;
+
+  typedef _Skiplist_iterator<_Val, _Val&, _Val*> iterator;
+  typedef _Skiplist_iterator _Self;
+  typedef _Skiplist_node<_Val>* _Link_type;
+
+  _Link_type _M_node;
+  _Epoch_guard _M_guard;
+
+  _Skiplist_iterator() : _M_node(nullptr) {}
+
+  explicit _Skiplist_iterator(_Link_type __x) : _M_node(__x) {}
+
+  _Skiplist_iterator(const iterator& __x) : _M_node(__x._M_node), _M_guard(__x._M_guard) {}
+
+  reference operator*() const { return *_M_node->_M_valptr(); }
+
+  pointer operator->() const { return _M_node->_M_valptr(); }
+
+  _Self& operator++()
+  {
+    _M_node = _Skiplist_node<_Val>::_S_next_live(_M_node);
+    return *this;
+  }
+
+  _Self operator++(int)
+  {
+    _Self __tmp = *this;
+    ++*this;
+    return __tmp;
+  }
+
+  friend bool operator==(const _Self& __x, const _Self& __y) { return __x._M_node == __y._M_node; }
+
+  friend bool operator!=(const _Self& __x, const _Self& __y) { return __x._M_node != __y._M_node; }
+};
+
+/**
+ * @brief  lock-free ordered set of unique keys (Fraser, Herlihy and
+ *  Shavit). A node is in the set while its level 0 link is unmarked;
+ *  erase marks the tower top down and then level 0, and any search
+ *  passing a marked node unlinks it. Erased nodes are freed through the
+ *  epoch domain, so readers never lock and never see freed memory.
+ *  find, insert, erase, lower_bound and iteration may run on any number
+ *  of threads at once; construction and destruction may not.
+ */
+template <class _Key, class _Val, class _KeyOfValue, class _Compare>
+class _Skiplist
+{
+ public:
+  typedef _Key key_type;
+  typedef _Val value_type;
+  typedef _Compare key_compare;
+  typedef size_t size_type;
+  typedef ptrdiff_t difference_type;
+  typedef _Skiplist_iterator<_Val, _Val&, _Val*> iterator;
+  typedef _Skiplist_iterator<_Val, const _Val&, const _Val*> const_iterator;
+
+ protected:
+  typedef _Skiplist_node<_Val> _Node;
+  typedef _Node* _Link_type;
+  typedef typename _Node::_Link _Link;
+
+  // towers of 20 levels, one node in four goes up a level.
+  enum { _S_max_level = 20 };
+
+  // nodes go to malloc: a retired node may be freed from any thread, and
+  // after the pool of the default allocator is gone at exit.
+  typedef malloc_alloc _Node_alloc;
+
+  _Compare _M_key_compare;
+  _Link_type _M_head;
+  std::atomic<size_type> _M_node_count;
+
+ public:
+  _Skiplist() : _M_key_compare(), _M_head(_S_allocate(_S_max_level)), _M_node_count(0) {}
+
+  explicit _Skiplist(const _Compare& __comp)
+  : _M_key_compare(__comp), _M_head(_S_allocate(_S_max_level)), _M_node_count(0) {}
+
+  _Skiplist(const _Skiplist&) = delete;
+
+  _Skiplist& operator=(const _Skiplist&) = delete;
+
+  ~_Skiplist()
+  {
+    _Link_type __x = _Node::_S_ptr(_M_head->_M_next()[0].load());
+    while (__x != nullptr) {
+      uintptr_t __l = __x->_M_next()[0].load();
+      // a marked node left linked belongs to the epoch domain.
+      if (!_Node::_S_marked(__l))
+        _S_deleter(__x);
+      __x = _Node::_S_ptr(__l);
+    }
+    _S_free(_M_head);
+  }
+
+  key_compare key_comp() const { return _M_key_compare; }
+
+  iterator begin() const
+  {
+    _Epoch_guard __g;
+    return iterator(_Node::_S_next_live(_M_head));
+  }
+
+  iterator end() const { return iterator(); }
+
+  // exact when no other thread changes the list.
+  size_type size() const { return _M_node_count.load(std::memory_order_relaxed); }
+
+  size_type max_size() const { return size_type(-1) / sizeof(_Node); }
+
+  template <class... _Args>
+  pair<iterator, bool> _M_emplace_unique(_Args&&... __args)
+  {
+    _Epoch_guard __g;
+    int __level = _S_random_level();
+    _Link_type __z = _S_create_node(__level, tinySTL::forward<_Args>(__args)...);
+    const _Key& __k = _S_key(__z);
+    _Link_type __preds[_S_max_level];
+    _Link_type __succs[_S_max_level];
+    for (;;) {
+      if (_M_find(__k, __preds, __succs)) {
+        _S_drop_node(__z);
+        return pair<iterator, bool>(iterator(__succs[0]), false);
+      }
+      for (int __i = 0; __i < __level; ++__i)
+        __z->_M_next()[__i].store(_S_link(__succs[__i]), std::memory_order_relaxed);
+      uintptr_t __exp = _S_link(__succs[0]);
+      if (__preds[0]->_M_next()[0].compare_exchange_strong(__exp, _S_link(__z)))
+        break;
+    }
+    _M_node_count.fetch_add(1, std::memory_order_relaxed);
+    iterator __ret(__z);
+    _M_build_tower(__z, __k, __preds, __succs);
+    // erased while the tower went up: unlink the levels linked late.
+    if (_Node::_S_marked(__z->_M_next()[0].load()))
+      _M_find(__k, __preds, __succs);
+    _S_release(__g, __z);
+    return pair<iterator, bool>(__ret, true);
+  }
+
+  size_type _M_erase_unique(const _Key& __k)
+  {
+    _Epoch_guard __g;
+    _Link_type __preds[_S_max_level];
+    _Link_type __succs[_S_max_level];
+    if (!_M_find(__k, __preds, __succs))
+      return 0;
+    return _M_erase_node(__g, __succs[0]) ? 1 : 0;
+  }
+
+  // erase the node of __pos, false when another thread got to it first.
+  bool _M_erase(const_iterator __pos)
+  { return _M_erase_node(__pos._M_guard, __pos._M_node); }
+
+  // erase everything reachable, one node at a time.
+  void clear()
+  {
+    _Epoch_guard __g;
+    for (_Link_type __x = _Node::_S_next_live(_M_head); __x != nullptr;
+         __x = _Node::_S_next_live(__x))
+      _M_erase_node(__g, __x);
+  }
+
+  template <class _Kt>
+  iterator find(const _Kt& __k) const
+  {
+    _Epoch_guard __g;
+    _Link_type __x = _M_search<false>(__k);
+    if (__x == nullptr || _M_key_compare(__k, _S_key(__x)))
+      return end();
+    return iterator(__x);
+  }
+
+  template <class _Kt>
+  iterator lower_bound(const _Kt& __k) const
+  {
+    _Epoch_guard __g;
+    return iterator(_M_search<false>(__k));
+  }
+
+  template <class _Kt>
+  iterator upper_bound(const _Kt& __k) const
+  {
+    _Epoch_guard __g;
+    return iterator(_M_search<true>(__k));
+  }
+
+ protected:
+  static const _Key& _S_key(_Link_type __x) { return _KeyOfValue()(*__x->_M_valptr()); }
+
+  static uintptr_t _S_link(_Link_type __x) { return reinterpret_cast<uintptr_t>(__x); }
+
+  static _Link_type _S_allocate(int __level)
+  {
+    void* __p = _Node_alloc::allocate(sizeof(_Node) + __level * sizeof(_Link));
+    _Link_type __x = ::new (__p) _Node;
+    __x->_M_deleter = &_S_deleter;
+    __x->_M_refs.store(2, std::memory_order_relaxed);
+    __x->_M_level = __level;
+    for (int __i = 0; __i < __level; ++__i)
+      ::new (__x->_M_next() + __i) _Link(0);
+    return __x;
+  }
+
+  static void _S_free(_Link_type __x)
+  { _Node_alloc::deallocate(__x, sizeof(_Node) + __x->_M_level * sizeof(_Link)); }
+
+  static void _S_deleter(_Epoch_retired* __p)
+  {
+    _Link_type __x = static_cast<_Link_type>(__p);
+    tinySTL::destroy(__x->_M_valptr());
+    _S_free(__x);
+  }
+
+  template <class... _Args>
+  static _Link_type _S_create_node(int __level, _Args&&... __args)
+  {
+    _Link_type __x = _S_allocate(__level);
+    try {
+      tinySTL::construct(__x->_M_valptr(), tinySTL::forward<_Args>(__args)...);
+    } catch (...) {
+      _S_free(__x);
+      throw;
+    }
+    return __x;
+  }
+
+  // a node no other thread has seen.
+  static void _S_drop_node(_Link_type __x) { _S_deleter(__x); }
+
+  static void _S_release(const _Epoch_guard& __g, _Link_type __x)
+  {
+    if (__x->_M_refs.fetch_sub(1) == 1)
+      __g._M_retire(__x);
+  }
+
+  // 1 + the number of trailing zero bit pairs of a per thread xorshift.
+  static int _S_random_level()
+  {
+    static thread_local uint64_t __seed = reinterpret_cast<uintptr_t>(&__seed) | 1;
+    __seed ^= __seed << 13;
+    __seed ^= __seed >> 7;
+    __seed ^= __seed << 17;
+    int __level = 1;
+    for (uint64_t __r = __seed; (__r & 3) == 0 && __level < _S_max_level; __r >>= 2)
+      ++__level;
+    return __level;
+  }
+
+  /**
+   * @brief  fill __preds and __succs with the neighbours of __k on every
+   *  level, unlinking the marked nodes met on the way.
+   * @return  whether __succs[0] holds __k.
+   */
+  bool _M_find(const _Key& __k, _Link_type* __preds, _Link_type* __succs)
+  {
+    for (;;) {
+      bool __retry = false;
+      _Link_type __pred = _M_head;
+      for (int __i = _S_max_level - 1; __i >= 0 && !__retry; --__i) {
+        _Link_type __curr = _Node::_S_ptr(__pred->_M_next()[__i].load());
+        while (__curr != nullptr) {
+          uintptr_t __next = __curr->_M_next()[__i].load();
+          if (_Node::_S_marked(__next)) {
+            uintptr_t __exp = _S_link(__curr);
+            if (!__pred->_M_next()[__i].compare_exchange_strong(__exp, __next & ~uintptr_t(1))) {
+              __retry = true;
+              break;
+            }
+            __curr = _Node::_S_ptr(__next);
+          } else if (_M_key_compare(_S_key(__curr), __k)) {
+            __pred = __curr;
+            __curr = _Node::_S_ptr(__next);
+          } else {
+            break;
+          }
+        }
+        __preds[__i] = __pred;
+        __succs[__i] = __curr;
+      }
+      if (!__retry)
+        return __succs[0] != nullptr && !_M_key_compare(__k, _S_key(__succs[0]));
+    }
+  }
+
+  // first node not marked at level 0 that is not less than __k, or
+  // greater than __k when _Upper. Only reads.
+  template <bool _Upper, class _Kt>
+  _Link_type _M_search(const _Kt& __k) const
+  {
+    _Link_type __pred = _M_head;
+    _Link_type __curr = nullptr;
+    for (int __i = _S_max_level - 1; __i >= 0; --__i) {
+      __curr = _Node::_S_ptr(__pred->_M_next()[__i].load(std::memory_order_acquire));
+      while (__curr != nullptr) {
+        uintptr_t __next = __curr->_M_next()[__i].load(std::memory_order_acquire);
+        if (_Node::_S_marked(__next)) {
+          __curr = _Node::_S_ptr(__next);
+        } else if (_Upper ? !_M_key_compare(__k, _S_key(__curr))
+                          : _M_key_compare(_S_key(__curr), __k)) {
+          __pred = __curr;
+          __curr = _Node::_S_ptr(__next);
+        } else {
+          break;
+        }
+      }
+    }
+    return __curr;
+  }
+
+  // link __z on levels 1 and up, giving up once it is being erased.
+  void _M_build_tower(_Link_type __z, const _Key& __k, _Link_type* __preds, _Link_type* __succs)
+  {
+    for (int __i = 1; __i < __z->_M_level; ++__i) {
+      for (;;) {
+        uintptr_t __next = __z->_M_next()[__i].load();
+        if (_Node::_S_marked(__next))
+          return;
+        if (_Node::_S_ptr(__next) != __succs[__i]
+            && !__z->_M_next()[__i].compare_exchange_strong(__next, _S_link(__succs[__i])))
+          continue;
+        uintptr_t __exp = _S_link(__succs[__i]);
+        if (__preds[__i]->_M_next()[__i].compare_exchange_strong(__exp, _S_link(__z)))
+          break;
+        _M_find(__k, __preds, __succs);
+        if (__succs[0] != __z)
+          return;
+      }
+    }
+  }
+
+  // mark __z top down, level 0 last; the thread marking level 0 erased it.
+  bool _M_erase_node(const _Epoch_guard& __g, _Link_type __z)
+  {
+    for (int __i = __z->_M_level - 1; __i >= 1; --__i) {
+      uintptr_t __next = __z->_M_next()[__i].load();
+      while (!_Node::_S_marked(__next)
+             && !__z->_M_next()[__i].compare_exchange_weak(__next, __next | 1)) {}
+    }
+    uintptr_t __next = __z->_M_next()[0].load();
+    do {
+      if (_Node::_S_marked(__next))
+        return false;
+    } while (!__z->_M_next()[0].compare_exchange_weak(__next, __next | 1));
+    _M_node_count.fetch_sub(1, std::memory_order_relaxed);
+    _Link_type __preds[_S_max_level];
+    _Link_type __succs[_S_max_level];
+    _M_find(_S_key(__z), __preds, __succs);
+    _S_release(__g, __z);
+    return true;
+  }
+};
+
+}
@@ -0,0 +1,598 @@
+// tinySTL: open addressing hash table with control bytes, the base of
+// flat_hash_map and flat_hash_set.
+#pragma once
+
+#include <cstdint>
+#include <cstring>
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+#include "tiny_pair.h"
+#include "tiny_alloc.h"
+#include "tiny_algobase.h"
+#include "tiny_traits.h"
+#include "tiny_errors.h"
+#include "tiny_iterator.h"
+#include "tiny_construct.h"
+#include "tiny_hash_fun.h"
+
+namespace tinySTL
+{
+
+// a control byte: 0 to 127 is a full slot, tagged with 7 bits of the
+// hash of its element; the other states have the high bit set.
+struct _Swiss_ctrl
+{
+  static constexpr signed char _S_empty = -128;
+  static constexpr signed char _S_deleted = -2;
+  // after the last slot, so a walk over the table stops there.
+  static constexpr signed char _S_sentinel = -1;
+};
+
+inline unsigned __swiss_ctz(unsigned __m) noexcept
+{
+#if defined(__GNUC__) || defined(__clang__)
+  return __builtin_ctz(__m);
+#else
+  unsigned __n = 0;
+  for (; !(__m & 1); __m >>= 1)
+    ++__n;
+  return __n;
+#endif
+}
+
+// the leading zeros of a 16 bit mask.
+inline unsigned __swiss_clz16(unsigned __m) noexcept
+{
+#if defined(__GNUC__) || defined(__clang__)
+  return __builtin_clz(__m) - 16;
+#else
+  unsigned __n = 0;
+  for (unsigned __b = 0x8000; !(__m & __b); __b >>= 1)
+    ++__n;
+  return __n;
+#endif
+}
+
+/**
+ * @brief  16 control bytes, compared all at once. Each match is a 16 bit
+ *  mask with bit i set when byte i matches.
+ */
+struct _Swiss_group
+{
+  static constexpr size_t _S_width = 16;
+
+#if defined(__SSE2__)
+  __m128i _M_ctrl;
+
+  explicit _Swiss_group(const signed char* __p) noexcept
+  : _M_ctrl(_mm_loadu_si128(reinterpret_cast<const __m128i*>(__p))) { }
+
+  unsigned _M_match(signed char __h2) const noexcept
+  { return (unsigned)_mm_movemask_epi8(_mm_cmpeq_epi8(_mm_set1_epi8(__h2), _M_ctrl)); }
+
+  unsigned _M_match_empty() const noexcept
+  { return _M_match(_Swiss_ctrl::_S_empty); }
+
+  unsigned _M_match_empty_or_deleted() const noexcept
+  {
+    return (unsigned)_mm_movemask_epi8(
+        _mm_cmpgt_epi8(_mm_set1_epi8(_Swiss_ctrl::_S_sentinel), _M_ctrl));
+  }
+#else
+  const signed char* _M_ctrl;
+
+  explicit _Swiss_group(const signed char* __p) noexcept : _M_ctrl(__p) { }
+
+  unsigned _M_match(signed char __h2) const noexcept
+  {
+    unsigned __m = 0;
+    for (unsigned __i = 0; __i < _S_width; ++__i)
+      __m |= unsigned(_M_ctrl[__i] == __h2) << __i;
+    return __m;
+  }
+
+  unsigned _M_match_empty() const noexcept
+  { return _M_match(_Swiss_ctrl::_S_empty); }
+
+  unsigned _M_match_empty_or_deleted() const noexcept
+  {
+    unsigned __m = 0;
+    for (unsigned __i = 0; __i < _S_width; ++__i)
+      __m |= unsigned(_M_ctrl[__i] < _Swiss_ctrl::_S_sentinel) << __i;
+    return __m;
+  }
+#endif
+};
+
+// the control bytes of a table with no slots: a walk stops at once and
+// a lookup sees an empty byte at once.
+alignas(16) inline constexpr signed char __swiss_empty_group[16] = {
+  _Swiss_ctrl::_S_sentinel, _Swiss_ctrl::_S_empty, _Swiss_ctrl::_S_empty, _Swiss_ctrl::_S_empty,
+  _Swiss_ctrl::_S_empty, _Swiss_ctrl::_S_empty, _Swiss_ctrl::_S_empty, _Swiss_ctrl::_S_empty,
+  _Swiss_ctrl::_S_empty, _Swiss_ctrl::_S_empty, _Swiss_ctrl::_S_empty, _Swiss_ctrl::_S_empty,
+  _Swiss_ctrl::_S_empty, _Swiss_ctrl::_S_empty, _Swiss_ctrl::_S_empty, _Swiss_ctrl::_S_empty
+};
+
+template <class _Val>
+struct _Swiss_iterator
+{
+  typedef _Val value_type;
+  typedef value_type& reference;
+  typedef value_type* pointer;
+
+  typedef forward_iterator_tag iterator_category;
+  typedef ptrdiff_t       difference_type;
+
+  typedef _Swiss_iterator<_Val> _Self;
+
+  signed char* _M_ctrl;
+  aligned_membuf<_Val>* _M_slot;
+
+  _Swiss_iterator() noexcept : _M_ctrl(0), _M_slot(0) { }
+
+  _Swiss_iterator(signed char* __c, aligned_membuf<_Val>* __s) noexcept
+  : _M_ctrl(__c), _M_slot(__s) { }
+
+  reference operator*() const noexcept { return *_M_slot->ptr(); }
+
+  pointer operator->() const noexcept { return _M_slot->ptr(); }
+
+  _Self& operator++() noexcept
+  {
+    ++_M_ctrl;
+    ++_M_slot;
+    _M_skip();
+    return *this;
+  }
+
+  _Self operator++(int) noexcept
+  {
+    _Self __tmp = *this;
+    ++*this;
+    return __tmp;
+  }
+
+  // on to the next full slot or the sentinel, a group at a time.
+  void _M_skip() noexcept
+  {
+    while (*_M_ctrl < _Swiss_ctrl::_S_sentinel) {
+      unsigned __n = __swiss_ctz(~_Swiss_group(_M_ctrl)._M_match_empty_or_deleted());
+      _M_ctrl += __n;
+      _M_slot += __n;
+    }
+  }
+
+  friend bool operator==(const _Self& __x, const _Self& __y) noexcept
+  { return __x._M_ctrl == __y._M_ctrl; }
+
+  friend bool operator!=(const _Self& __x, const _Self& __y) noexcept
+  { return __x._M_ctrl != __y._M_ctrl; }
+};
+
+/**
+ * @brief  hash table with open addressing in the style of a swiss table.
+ *  Elements live in one array of slots, no nodes, and every slot has a
+ *  control byte holding 7 bits of its element's hash. A lookup compares
+ *  the tag against 16 control bytes at once and only looks at the
+ *  elements whose tag matches, so a miss rarely touches an element and a
+ *  hit usually touches one. Erased slots become tombstones unless no
+ *  probe can have passed them; they are reused by inserts and dropped
+ *  when the table is rebuilt.
+ * @attention  there are 2^k - 1 slots, at most 7/8 of them in use.
+ *  Inserting may rebuild the table and invalidates every iterator then;
+ *  erasing invalidates iterators to the erased element only. The hash is
+ *  mixed before use, so identity hashes on integers are fine.
+ */
+template <class _Key, class _Val, class _Hash, class _ExtractKey, class _EqualKey, class _Alloc>
+class _Swiss_table
+{
+
+template <class, class, class, class, class> friend class flat_hash_map;
+template <class, class, class, class> friend class flat_hash_set;
+
+ protected:
+  typedef aligned_membuf<_Val> _Slot;
+  typedef typename _Alloc_rebind<_Alloc, _Slot>::type _Slot_allocator;
+  typedef typename _Alloc_rebind<_Alloc, signed char>::type _Ctrl_allocator;
+
+ protected:
+  typedef _Key key_type;
+  typedef _Val value_type;
+  typedef _Hash hasher;
+  typedef _EqualKey key_equal;
+  typedef size_t size_type;
+  typedef ptrdiff_t difference_type;
+  typedef value_type* pointer;
+  typedef const value_type* const_pointer;
+  typedef value_type& reference;
+  typedef const value_type& const_reference;
+  typedef _Alloc allocator_type;
+  typedef _Swiss_iterator<_Val> iterator;
+  typedef tinySTL::const_iterator<iterator> const_iterator;
+
+  static constexpr size_type _S_width = _Swiss_group::_S_width;
+  static constexpr size_type _S_min_capacity = _S_width - 1;
+
+ protected:
+  signed char* _M_ctrl;
+  _Slot* _M_slots;
+  size_type _M_capacity;
+  size_type _M_size;
+  size_type _M_growth_left;
+  _Hash _M_hash;
+  _EqualKey _M_equals;
+  _ExtractKey _M_get_key;
+
+  // the most elements __cap slots take before the table grows.
+  static size_type _S_growth(size_type __cap) noexcept { return __cap - __cap / 8; }
+
+  // the fewest slots that take __n elements.
+  static size_type _S_capacity_for(size_type __n) noexcept
+  {
+    size_type __cap = _S_min_capacity;
+    while (_S_growth(__cap) < __n)
+      __cap = __cap * 2 + 1;
+    return __cap;
+  }
+
+  template <class _Kt>
+  size_t _M_hash_of(const _Kt& __k) const { return __tiny_hash_mix(_M_hash(__k)); }
+
+  static size_type _S_h1(size_t __h) noexcept { return __h >> 7; }
+
+  static signed char _S_h2(size_t __h) noexcept { return (signed char)(__h & 0x7F); }
+
+  /**
+   * @brief  set the control byte of slot __i, and its copy past the
+   *  sentinel when __i is among the first 15, so a group read near the
+   *  end of the table sees the start of it.
+   */
+  static void _S_set_ctrl(signed char* __ctrl, size_type __cap, size_type __i, signed char __c) noexcept
+  {
+    __ctrl[__i] = __c;
+    __ctrl[((__i - (_S_width - 1)) & __cap) + ((_S_width - 1) & __cap)] = __c;
+  }
+
+  // the first slot free for __h, empty or a tombstone, on its probe path.
+  static size_type _S_find_first_non_full(const signed char* __ctrl, size_type __cap, size_t __h) noexcept
+  {
+    size_type __pos = _S_h1(__h) & __cap;
+    for (size_type __step = _S_width; ; __step += _S_width) {
+      unsigned __m = _Swiss_group(__ctrl + __pos)._M_match_empty_or_deleted();
+      if (__m)
+        return (__pos + __swiss_ctz(__m)) & __cap;
+      __pos = (__pos + __step) & __cap;
+    }
+  }
+
+  // the slot of the element __k, _M_capacity if there is none.
+  template <class _Kt>
+  size_type _M_find_index(const _Kt& __k, size_t __h) const
+  {
+    const signed char __h2 = _S_h2(__h);
+    size_type __pos = _S_h1(__h) & _M_capacity;
+    for (size_type __step = _S_width; ; __step += _S_width) {
+      _Swiss_group __g(_M_ctrl + __pos);
+      for (unsigned __m = __g._M_match(__h2); __m != 0; __m &= __m - 1) {
+        size_type __i = (__pos + __swiss_ctz(__m)) & _M_capacity;
+        if (_M_equals(_M_get_key(*_M_slots[__i].ptr()), __k))
+          return __i;
+      }
+      if (__g._M_match_empty())
+        return _M_capacity;
+      __pos = (__pos + __step) & _M_capacity;
+    }
+  }
+
+  iterator _M_iter(size_type __i) const noexcept { return iterator(_M_ctrl + __i, _M_slots + __i); }
+
+  size_type _M_index(const iterator& __it) const noexcept { return __it._M_ctrl - _M_ctrl; }
+
+  void _M_reset_empty() noexcept
+  {
+    _M_ctrl = const_cast<signed char*>(__swiss_empty_group);
+    _M_slots = nullptr;
+    _M_capacity = _M_size = _M_growth_left = 0;
+  }
+
+  void _M_deallocate(signed char* __ctrl, _Slot* __slots, size_type __cap) noexcept
+  {
+    if (__cap != 0) {
+      _Ctrl_allocator().deallocate(__ctrl, __cap + _S_width);
+      _Slot_allocator().deallocate(__slots, __cap);
+    }
+  }
+
+  // move every element into __cap fresh slots; nothing changes on a throw.
+  void _M_resize(size_type __cap)
+  {
+    signed char* __ctrl = _Ctrl_allocator().allocate(__cap + _S_width);
+    _Slot* __slots;
+    try {
+      __slots = _Slot_allocator().allocate(__cap);
+    } catch (...) {
+      _Ctrl_allocator().deallocate(__ctrl, __cap + _S_width);
+      throw;
+    }
+    memset(__ctrl, (unsigned char)_Swiss_ctrl::_S_empty, __cap + _S_width);
+    __ctrl[__cap] = _Swiss_ctrl::_S_sentinel;
+    iterator __it = begin();
+    try {
+      for (; __it != end(); ++__it) {
+        size_t __h = _M_hash_of(_M_get_key(*__it));
+        size_type __i = _S_find_first_non_full(__ctrl, __cap, __h);
+        tinySTL::construct(__slots[__i].ptr(), tinySTL::move_if_noexcept(*__it));
+        _S_set_ctrl(__ctrl, __cap, __i, _S_h2(__h));
+      }
+    } catch (...) {
+      for (size_type __i = 0; __i < __cap; ++__i)
+        if (__ctrl[__i] >= 0)
+          tinySTL::destroy(__slots[__i].ptr());
+      _M_deallocate(__ctrl, __slots, __cap);
+      throw;
+    }
+    for (__it = begin(); __it != end(); ++__it)
+      tinySTL::destroy(__it.operator->());
+    _M_deallocate(_M_ctrl, _M_slots, _M_capacity);
+    _M_ctrl = __ctrl;
+    _M_slots = __slots;
+    _M_capacity = __cap;
+    _M_growth_left = _S_growth(__cap) - _M_size;
+  }
+
+  /**
+   * @brief  the slot for a new element of hash __h. With no room left the
+   *  table is rebuilt first: at the same size when tombstones take up much
+   *  of it, twice the size otherwise.
+   */
+  size_type _M_prepare_insert(size_t __h)
+  {
+    size_type __i = _S_find_first_non_full(_M_ctrl, _M_capacity, __h);
+    if (_M_growth_left == 0 && _M_ctrl[__i] != _Swiss_ctrl::_S_deleted) {
+      if (_M_capacity != 0 && _M_size <= _S_growth(_M_capacity) / 2)
+        _M_resize(_M_capacity);
+      else
+        _M_resize(_M_capacity == 0 ? _S_min_capacity : _M_capacity * 2 + 1);
+      __i = _S_find_first_non_full(_M_ctrl, _M_capacity, __h);
+    }
+    return __i;
+  }
+
+ public:
+  _Swiss_table(size_type __n, const _Hash& __hf, const _EqualKey& __eql)
+  : _M_hash(__hf), _M_equals(__eql), _M_get_key()
+  {
+    _M_reset_empty();
+    if (__n != 0)
+      _M_resize(_S_capacity_for(__n));
+  }
+
+  _Swiss_table(const _Swiss_table& __x)
+  : _Swiss_table(__x._M_size, __x._M_hash, __x._M_equals)
+  {
+    // delegated, so a throw here still runs the destructor.
+    for (const_iterator __it = __x.begin(); __it != __x.end(); ++__it) {
+      size_t __h = _M_hash_of(_M_get_key(*__it));
+      size_type __i = _S_find_first_non_full(_M_ctrl, _M_capacity, __h);
+      tinySTL::construct(_M_slots[__i].ptr(), *__it);
+      _S_set_ctrl(_M_ctrl, _M_capacity, __i, _S_h2(__h));
+      ++_M_size;
+      --_M_growth_left;
+    }
+  }
+
+  _Swiss_table(_Swiss_table&& __x) noexcept
+  : _M_hash(__x._M_hash), _M_equals(__x._M_equals), _M_get_key()
+  {
+    _M_reset_empty();
+    swap(__x);
+  }
+
+  ~_Swiss_table()
+  {
+    clear();
+    _M_deallocate(_M_ctrl, _M_slots, _M_capacity);
+  }
+
+  _Swiss_table& operator=(const _Swiss_table& __x)
+  {
+    if (this != &__x) {
+      _Swiss_table __tmp(__x);
+      swap(__tmp);
+    }
+    return *this;
+  }
+
+  _Swiss_table& operator=(_Swiss_table&& __x) noexcept
+  {
+    if (this != &__x) {
+      _Swiss_table __tmp(tinySTL::move(__x));
+      swap(__tmp);
+    }
+    return *this;
+  }
+
+  void swap(_Swiss_table& __x) noexcept
+  {
+    tinySTL::swap(_M_ctrl, __x._M_ctrl);
+    tinySTL::swap(_M_slots, __x._M_slots);
+    tinySTL::swap(_M_capacity, __x._M_capacity);
+    tinySTL::swap(_M_size, __x._M_size);
+    tinySTL::swap(_M_growth_left, __x._M_growth_left);
+    tinySTL::swap(_M_hash, __x._M_hash);
+    tinySTL::swap(_M_equals, __x._M_equals);
+  }
+
+  iterator begin() noexcept
+  {
+    iterator __it(_M_ctrl, _M_slots);
+    __it._M_skip();
+    return __it;
+  }
+
+  const_iterator begin() const noexcept { return const_cast<_Swiss_table*>(this)->begin(); }
+
+  iterator end() noexcept { return _M_iter(_M_capacity); }
+
+  const_iterator end() const noexcept { return _M_iter(_M_capacity); }
+
+  size_type size() const noexcept { return _M_size; }
+
+  bool empty() const noexcept { return _M_size == 0; }
+
+  size_type max_size() const noexcept { return size_type(-1) / sizeof(_Slot); }
+
+  size_type bucket_count() const noexcept { return _M_capacity; }
+
+  hasher hash_func() const { return _M_hash; }
+
+  key_equal key_eq() const { return _M_equals; }
+
+  // destroy every element, keeping the slots.
+  void clear() noexcept
+  {
+    if (_M_capacity == 0)
+      return;
+    for (iterator __it = begin(); __it != end(); ++__it)
+      tinySTL::destroy(__it.operator->());
+    memset(_M_ctrl, (unsigned char)_Swiss_ctrl::_S_empty, _M_capacity + _S_width);
+    _M_ctrl[_M_capacity] = _Swiss_ctrl::_S_sentinel;
+    _M_size = 0;
+    _M_growth_left = _S_growth(_M_capacity);
+  }
+
+  template <class _Kt>
+  iterator find(const _Kt& __k) { return _M_iter(_M_find_index(__k, _M_hash_of(__k))); }
+
+  template <class _Kt>
+  const_iterator find(const _Kt& __k) const { return _M_iter(_M_find_index(__k, _M_hash_of(__k))); }
+
+  // build an element in a free slot for hash __h; its key is not there.
+  template <class... _Args>
+  iterator _M_emplace_at(size_t __h, _Args&&... __args)
+  {
+    size_type __i = _M_prepare_insert(__h);
+    tinySTL::construct(_M_slots[__i].ptr(), tinySTL::forward<_Args>(__args)...);
+    _M_growth_left -= _M_ctrl[__i] == _Swiss_ctrl::_S_empty;
+    _S_set_ctrl(_M_ctrl, _M_capacity, __i, _S_h2(__h));
+    ++_M_size;
+    return _M_iter(__i);
+  }
+
+  template <class _Arg>
+  pair<iterator, bool> _M_insert_unique(_Arg&& __v)
+  {
+    size_t __h = _M_hash_of(_M_get_key(__v));
+    size_type __i = _M_find_index(_M_get_key(__v), __h);
+    if (__i != _M_capacity)
+      return pair<iterator, bool>(_M_iter(__i), false);
+    return pair<iterator, bool>(_M_emplace_at(__h, tinySTL::forward<_Arg>(__v)), true);
+  }
+
+  // the element is built aside first, its key is needed to find a slot.
+  template <class... _Args>
+  pair<iterator, bool> _M_emplace_unique(_Args&&... __args)
+  {
+    aligned_membuf<_Val> __tmp;
+    tinySTL::construct(__tmp.ptr(), tinySTL::forward<_Args>(__args)...);
+    try {
+      pair<iterator, bool> __r = _M_insert_unique(tinySTL::move(*__tmp.ptr()));
+      tinySTL::destroy(__tmp.ptr());
+      return __r;
+    } catch (...) {
+      tinySTL::destroy(__tmp.ptr());
+      throw;
+    }
+  }
+
+  /**
+   * @brief  destroy the element at __pos. Its slot becomes empty again if
+   *  the run of non-empty slots around it is shorter than a group, as no
+   *  probe can then have gone past it; a tombstone otherwise.
+   */
+  void _M_erase(iterator __pos) noexcept
+  {
+    size_type __i = _M_index(__pos);
+    tinySTL::destroy(__pos.operator->());
+    --_M_size;
+    unsigned __after = _Swiss_group(_M_ctrl + __i)._M_match_empty();
+    unsigned __before = _Swiss_group(_M_ctrl + ((__i - _S_width) & _M_capacity))._M_match_empty();
+    bool __never_full = __after && __before
+        && __swiss_ctz(__after) + __swiss_clz16(__before) < _S_width;
+    _S_set_ctrl(_M_ctrl, _M_capacity, __i,
+                __never_full ? _Swiss_ctrl::_S_empty : _Swiss_ctrl::_S_deleted);
+    _M_growth_left += __never_full;
+  }
+
+  iterator erase(iterator __pos) noexcept
+  {
+    iterator __next = __pos;
+    ++__next;
+    _M_erase(__pos);
+    return __next;
+  }
+
+  template <class _Kt>
+  size_type erase(const _Kt& __k)
+  {
+    size_type __i = _M_find_index(__k, _M_hash_of(__k));
+    if (__i == _M_capacity)
+      return 0;
+    _M_erase(_M_iter(__i));
+    return 1;
+  }
+
+  // room for __n elements without growing.
+  void reserve(size_type __n)
+  {
+    if (__n > _M_size + _M_growth_left)
+      _M_resize(_S_capacity_for(__n));
+  }
+
+  // at least __n slots, and enough for the elements; drops tombstones.
+  void rehash(size_type __n)
+  {
+    size_type __cap = _S_capacity_for(_M_size);
+    while (__cap < __n)
+      __cap = __cap * 2 + 1;
+    if (_M_size == 0 && __n == 0) {
+      _M_deallocate(_M_ctrl, _M_slots, _M_capacity);
+      _M_reset_empty();
+    } else {
+      _M_resize(__cap);
+    }
+  }
+
+  /**
+   * @brief  check the table: every element is found from its hash, the
+   *  copies of the control bytes agree, and the counts add up.
+   */
+  bool _M_verify() const
+  {
+    if (_M_capacity == 0)
+      return _M_size == 0 && _M_ctrl == __swiss_empty_group;
+    if (_M_ctrl[_M_capacity] != _Swiss_ctrl::_S_sentinel)
+      return false;
+    for (size_type __i = 0; __i + 1 < _S_width; ++__i)
+      if (_M_ctrl[_M_capacity + 1 + __i] != _M_ctrl[__i & _M_capacity])
+        return false;
+    size_type __full = 0, __empty = 0;
+    for (size_type __i = 0; __i < _M_capacity; ++__i) {
+      if (_M_ctrl[__i] >= 0) {
+        ++__full;
+        const _Key& __k = _M_get_key(*_M_slots[__i].ptr());
+        size_t __h = _M_hash_of(__k);
+        if (_M_ctrl[__i] != _S_h2(__h) || _M_find_index(__k, __h) != __i)
+          return false;
+      } else if (_M_ctrl[__i] == _Swiss_ctrl::_S_empty) {
+        ++__empty;
+      }
+    }
+    return __full == _M_size && _M_size + _M_growth_left <= _S_growth(_M_capacity)
+        && __empty > 0;
+  }
+};
+
+}
@@ -292,6 +292,24 @@ template <class _Base, class _Derived>
 struct is_base_of : bool_constant<__is_base_of(_Base, _Derived)> {};
 
 
+// is_constructible
+template <class _Ty, class... _Args>
+inline constexpr bool is_constructible_v = __is_constructible(_Ty, _Args...);
+
+template <class _Ty, class... _Args>
+struct is_constructible : bool_constant<__is_constructible(_Ty, _Args...)> {};
+
+
+// is_convertible: a _From converts implicitly to a _To, passed as an
+// argument of type _To.
+template <class _From, class _To>
+inline constexpr bool is_convertible_v =
+  requires (void (*__f)(_To), _From (*__g)()) { __f(__g()); };
+
+template <class _From, class _To>
+struct is_convertible : bool_constant<is_convertible_v<_From, _To>> {};
+
+
 // is_const
 template <class>
 inline constexpr bool is_const_v = false;
@@ -356,6 +374,14 @@ template <class _Ty>
 using remove_cv_t = typename remove_cv<_Ty>::type;
 
 
+// remove const, volatile & reference.
+template <class _Ty>
+struct remove_cvref { using type = remove_cv_t<remove_reference_t<_Ty>>; };
+
+template <class _Ty>
+using remove_cvref_t = typename remove_cvref<_Ty>::type;
+
+
 // move.
 template <typename _Ty>
 typename remove_reference<_Ty>::type&& move(_Ty&& t) 
@@ -363,6 +389,19 @@ typename remove_reference<_Ty>::type&& move(_Ty&& t)
   return static_cast<typename remove_reference<_Ty>::type&&>(t);
 }
 
+// an rvalue when moving cannot throw, or copying is not possible, so an
+// element moved by an operation that fails half way is never lost.
+template <typename _Ty>
+inline constexpr bool __move_if_noexcept_v =
+  __is_nothrow_constructible(_Ty, _Ty&&) || !__is_constructible(_Ty, const _Ty&);
+
+template <typename _Ty>
+conditional_t<__move_if_noexcept_v<_Ty>, _Ty&&, const _Ty&>
+move_if_noexcept(_Ty& t) noexcept
+{
+  return tinySTL::move(t);
+}
+
 
 // forward.
 template <typename _Ty>
@@ -1,27 +1,140 @@
 #pragma once
 
+#include <cstdint>
+#if __TINY_RB_TREE_PARALLEL_COPY
+#include <atomic>
+#include <thread>
+#include <exception>
+#include <system_error>
+#endif
+
 #include "tiny_pair.h"
 #include "tiny_alloc.h"
 #include "tiny_errors.h"
 #include "tiny_algobase.h"
 #include "tiny_iterator.h"
+#include "tiny_function.h"
 #include "tiny_construct.h"
+#include "tiny_node_handle.h"
 
 namespace tinySTL
 {
 
 enum class _Rb_tree_color { _S_red = false, _S_black = true };
 
+// set to 0 for the plain node layout, with the color in a field of its own.
+#ifndef __TINY_RB_TREE_COMPACT
+#define __TINY_RB_TREE_COMPACT 1
+#endif
+
+// copies of trees with at least this many nodes clone their subtrees on
+// several threads, __TINY_RB_TREE_COPY_THREADS of them or one per core
+// when that is 0. Off when 0. The values are then copied concurrently, so
+// their copy constructors must not share unsynchronized state.
+#ifndef __TINY_RB_TREE_PARALLEL_COPY
+#define __TINY_RB_TREE_PARALLEL_COPY 0
+#endif
+
+#ifndef __TINY_RB_TREE_COPY_THREADS
+#define __TINY_RB_TREE_COPY_THREADS 0
+#endif
+
+struct _Rb_tree_node_base;
+
+/**
+ * @brief  parent pointer and color of a red-black tree node. In the
+ *  compact layout the color is the low bit of the pointer, which is free
+ *  as nodes are pointer aligned, so a node base is three pointers rather
+ *  than four. It reads and assigns like a _Rb_tree_node_base*; an
+ *  assignment keeps the color, so the link of freshly allocated memory
+ *  is set with _M_init first.
+ */
+class _Rb_tree_parent_link
+{
+  typedef _Rb_tree_node_base* _Base_ptr;
+
+#if __TINY_RB_TREE_COMPACT
+  uintptr_t _M_bits;
+
+ public:
+  operator _Base_ptr() const noexcept
+  { return reinterpret_cast<_Base_ptr>(_M_bits & ~uintptr_t(1)); }
+
+  _Rb_tree_parent_link& operator=(_Base_ptr __p) noexcept
+  {
+    _M_bits = reinterpret_cast<uintptr_t>(__p) | (_M_bits & 1);
+    return *this;
+  }
+
+  _Rb_tree_color _M_get_color() const noexcept
+  { return _Rb_tree_color(_M_bits & 1); }
+
+  void _M_set_color(_Rb_tree_color __c) noexcept
+  { _M_bits = (_M_bits & ~uintptr_t(1)) | uintptr_t(__c); }
+
+  void _M_init(_Base_ptr __p, _Rb_tree_color __c) noexcept
+  { _M_bits = reinterpret_cast<uintptr_t>(__p) | uintptr_t(__c); }
+#else
+  _Base_ptr _M_ptr;
+  _Rb_tree_color _M_color;
+
+ public:
+  operator _Base_ptr() const noexcept { return _M_ptr; }
+
+  _Rb_tree_parent_link& operator=(_Base_ptr __p) noexcept
+  {
+    _M_ptr = __p;
+    return *this;
+  }
+
+  _Rb_tree_color _M_get_color() const noexcept { return _M_color; }
+
+  void _M_set_color(_Rb_tree_color __c) noexcept { _M_color = __c; }
+
+  void _M_init(_Base_ptr __p, _Rb_tree_color __c) noexcept
+  {
+    _M_ptr = __p;
+    _M_color = __c;
+  }
+#endif
+
+  _Rb_tree_parent_link& operator=(const _Rb_tree_parent_link& __x) noexcept
+  { return *this = _Base_ptr(__x); }
+
+  _Base_ptr operator->() const noexcept { return *this; }
+
+  template <class _Node>
+  explicit operator _Node*() const noexcept
+  { return static_cast<_Node*>(_Base_ptr(*this)); }
+};
+
 struct _Rb_tree_node_base 
 {
   typedef _Rb_tree_node_base* _Base_ptr;
   typedef _Rb_tree_node_base const* _Const_Base_ptr;
 
-  _Rb_tree_color _M_color;
-  _Base_ptr _M_parent;
+  _Rb_tree_parent_link _M_parent;
   _Base_ptr _M_left;
   _Base_ptr _M_right;
 
+  _Rb_tree_color _M_get_color() const 
+  { return _M_parent._M_get_color(); }
+
+  void _M_set_color(_Rb_tree_color __c) 
+  { _M_parent._M_set_color(__c); }
+
+  bool _M_isRed() const 
+  { return _M_get_color() == _Rb_tree_color::_S_red; }
+
+  bool _M_isBlk() const 
+  { return _M_get_color() == _Rb_tree_color::_S_black; }
+
+  void _M_setRed() 
+  { _M_set_color(_Rb_tree_color::_S_red); }
+
+  void _M_setBlk()
+  { _M_set_color(_Rb_tree_color::_S_black); }
+
   static _Base_ptr
   _S_minimum(_Base_ptr __x) noexcept
   {
@@ -55,7 +168,7 @@ struct _Rb_tree_node_base
     if (__x == nullptr) {
       return nullptr;
     }
-    if (__x->_M_color == _Rb_tree_color::_S_red
+    if (__x->_M_isRed()
      && __x->_M_parent->_M_parent == __x)
     {
       /**
@@ -102,7 +215,7 @@ struct _Rb_tree_node_base
     if (__x == nullptr) {
       return nullptr;
     }
-    if (__x->_M_color == _Rb_tree_color::_S_red
+    if (__x->_M_isRed()
      && __x->_M_parent->_M_parent == __x)
     {
       __x = __x->_M_right;
@@ -163,14 +276,9 @@ struct _Rb_tree_node : public _Rb_tree_node_base
       return _Link_type(_M_parent->_M_left);    
   }
 
-  _Link_type& _M_gparent() 
-  { 
-    return (_Link_type&)_M_parent->_M_parent; 
-  }
-  
   _Link_type _M_gparent() const 
   {
-    return _Link_type(_M_parent->_M_parent);
+    return _Link_type(_Base_ptr(_M_parent->_M_parent));
   }
 
   _Link_type& _M_uncle() 
@@ -191,21 +299,9 @@ struct _Rb_tree_node : public _Rb_tree_node_base
       return _Link_type(__gparent->_M_left);
   }
 
-  bool _M_isRed() const 
-  { return _M_color == _Rb_tree_color::_S_red; }
-
-  bool _M_isBlk() const 
-  { return _M_color == _Rb_tree_color::_S_black; }
-
-  void _M_setRed() 
-  { _M_color = _Rb_tree_color::_S_red; }
-
-  void _M_setBlk()
-  { _M_color = _Rb_tree_color::_S_black; }
-
 };
 
-template <class _Tp>
+template <class _Tp, bool _Ranked = false>
 struct _Rb_tree_iterator
 {
   typedef _Tp  value_type;
@@ -215,7 +311,7 @@ struct _Rb_tree_iterator
   typedef bidirectional_iterator_tag iterator_category;
   typedef ptrdiff_t       difference_type;
 
-  typedef _Rb_tree_iterator<_Tp>    _Self;
+  typedef _Rb_tree_iterator<_Tp, _Ranked> _Self;
   typedef _Rb_tree_node_base::_Base_ptr  _Base_ptr;
   typedef _Rb_tree_node<_Tp>*    _Link_type;
 
@@ -271,19 +367,121 @@ struct _Rb_tree_iterator
   _Base_ptr _M_node;
 };
 
+/**
+ * @brief  node of a tree with order statistics. The size of the subtree
+ *  follows the value, so iterators read the value at the same offset as
+ *  in _Rb_tree_node.
+ */
+template <class _Val>
+struct _Rb_tree_rank_node : public _Rb_tree_node<_Val>
+{
+  typedef _Rb_tree_node_base::_Const_Base_ptr _Const_Base_ptr;
+
+  size_t _M_size;
+
+  static size_t _S_size(_Const_Base_ptr __x) noexcept
+  { return __x ? static_cast<const _Rb_tree_rank_node*>(__x)->_M_size : 0; }
+
+  // in-order index of __x, the header is at index size().
+  static size_t _S_index(_Const_Base_ptr __x) noexcept
+  {
+    if (__x->_M_isRed()
+     && __x->_M_parent->_M_parent == __x)
+      return _S_size(__x->_M_parent);
+    size_t __i = _S_size(__x->_M_left);
+    // the root is the black one of the two nodes that are their own
+    // grandparent, see _Rb_tree_increment.
+    while (__x->_M_parent->_M_parent != __x
+        || __x->_M_isRed()) {
+      _Const_Base_ptr __p = __x->_M_parent;
+      if (__x == __p->_M_right)
+        __i += _S_size(__p->_M_left) + 1;
+      __x = __p;
+    }
+    return __i;
+  }
+};
+
+// iterators of a ranked tree measure distance from subtree sizes in
+// O(log n) instead of walking.
+template <class _Tp>
+inline ptrdiff_t
+distance(_Rb_tree_iterator<_Tp, true> __first, _Rb_tree_iterator<_Tp, true> __last)
+{
+  if (__first == __last)
+    return 0;
+  return ptrdiff_t(_Rb_tree_rank_node<_Tp>::_S_index(__last._M_node))
+       - ptrdiff_t(_Rb_tree_rank_node<_Tp>::_S_index(__first._M_node));
+}
+
+template <class _Tp>
+inline ptrdiff_t
+distance(__const_iterator<_Rb_tree_iterator<_Tp, true>, bidirectional_iterator_tag> __first,
+         __const_iterator<_Rb_tree_iterator<_Tp, true>, bidirectional_iterator_tag> __last)
+{ return tinySTL::distance(__first.base(), __last.base()); }
+
+/**
+ * @brief  node of an augmented tree. _M_aug holds the fold of the values
+ *  of the subtree, after the rank, so the value keeps its offset.
+ */
+template <class _Base, class _Augment>
+struct _Rb_tree_augmented_node : public _Base
+{
+  typename _Augment::value_type _M_aug;
+};
+
+/**
+ * @brief  augmentation policy summing _Proj of the values, for range sums.
+ *
+ *  An augmentation policy has a trivially copyable value_type and two
+ *  calls: one value to its fold, and the folds of two runs of values,
+ *  the first before the second in key order, to the fold of both. The
+ *  second call must be associative. The tree keeps the fold of every
+ *  subtree in its root as nodes are linked, unlinked and rotated.
+ */
+template <class _Val, class _Tp = _Val, class _Proj = _Identity<_Val>>
+struct range_sum
+{
+  typedef _Tp value_type;
+
+  value_type operator()(const _Val& __x) const { return _Proj()(__x); }
+
+  value_type operator()(const value_type& __a, const value_type& __b) const
+  { return __a + __b; }
+};
+
+// range sums of the mapped values of a map.
+template <class _Key, class _Tp>
+using mapped_sum = range_sum<pair<const _Key, _Tp>, _Tp, _Select2nd<pair<const _Key, _Tp>>>;
+
+/**
+ * @brief  red-black tree under set, multiset, map and multimap.
+ * @param  _Ranked  keep the size of every subtree in the nodes, for
+ *  nth() and rank() and an O(log n) distance between iterators.
+ * @param  _Augment  void, or a policy such as range_sum whose fold of
+ *  every subtree is kept in the nodes, for fold() over a key range in
+ *  O(log n).
+ */
 template<typename _Key, typename _Val, typename _KeyOfValue,
-     typename _Compare, typename _Alloc = tinySTL::allocator<_Val> >
+     typename _Compare, typename _Alloc = tinySTL::allocator<_Val>,
+     bool _Ranked = false, class _Augment = void>
 class _Rb_tree 
 {
 
-template<class, class, class> friend class set;
-template<class, class, class> friend class multiset;
-template<class, class, class, class> friend class map;
-template<class, class, class, class> friend class multimap;
-template<class, class, class, class, class> friend class _Rb_tree;
+template<class, class, class, bool, class> friend class set;
+template<class, class, class, bool, class> friend class multiset;
+template<class, class, class, class, bool, class> friend class map;
+template<class, class, class, class, bool, class> friend class multimap;
+template<class, class, class, class, class, bool, class> friend class _Rb_tree;
+template<class, class, class, class> friend class interval_map;
 
  protected: 
-  typedef typename _Alloc_rebind<_Alloc, _Rb_tree_node<_Val>>
+  static constexpr bool _Augmented = !is_same_v<_Augment, void>;
+  typedef conditional_t<_Ranked, _Rb_tree_rank_node<_Val>, _Rb_tree_node<_Val>>
+            _Plain_node;
+  typedef conditional_t<_Augmented, _Rb_tree_augmented_node<_Plain_node, _Augment>, _Plain_node>
+            _Node;
+  typedef typename _Alloc_rebind<_Alloc, _Node>
             ::type _Node_allocator;
   typedef typename _Alloc_rebind<_Alloc, _Rb_tree_node_base>
             ::type _Head_allocator;
@@ -302,7 +500,7 @@ template<class, class, class, class, class> friend class _Rb_tree;
   typedef size_t size_type;
   typedef ptrdiff_t difference_type;
   typedef _Alloc allocator_type;
-  typedef _Rb_tree_iterator<value_type> iterator;
+  typedef _Rb_tree_iterator<value_type, _Ranked> iterator;
   typedef tinySTL::const_iterator<iterator> const_iterator;
   typedef tinySTL::reverse_iterator<const_iterator> const_reverse_iterator;
   typedef tinySTL::reverse_iterator<iterator> reverse_iterator;
@@ -318,7 +516,46 @@ template<class, class, class, class, class> friend class _Rb_tree;
   { return _M_node_allocator.allocate(1); }
 
   void _M_put_node(_Link_type __p)
-  { return _M_node_allocator.deallocate(__p, 1); }
+  { return _M_node_allocator.deallocate(static_cast<_Node*>(__p), 1); }
+
+  static size_type _S_size(_Const_Base_ptr __x) noexcept
+  { return _Rb_tree_rank_node<_Val>::_S_size(__x); }
+
+  static const auto& _S_aug(_Const_Base_ptr __x) noexcept
+  { return static_cast<const _Node*>(__x)->_M_aug; }
+
+  // the fold of the subtree __x from its value and its children's folds.
+  static auto _S_fold_subtree(_Const_Base_ptr __x)
+  {
+    _Augment __f;
+    auto __a = __f(*static_cast<_Const_Link_type>(__x)->_M_valptr());
+    static_assert(__is_trivially_copyable(decltype(__a)),
+                  "the value_type of an augmentation policy must be trivially copyable");
+    if (__x->_M_left != nullptr)
+      __a = __f(_S_aug(__x->_M_left), __a);
+    if (__x->_M_right != nullptr)
+      __a = __f(__a, _S_aug(__x->_M_right));
+    return __a;
+  }
+
+  // recompute the subtree size and fold of __x from its children.
+  static void _S_update(_Base_ptr __x) noexcept
+  {
+    if constexpr (_Ranked)
+      static_cast<_Node*>(__x)->_M_size =
+        1 + _S_size(__x->_M_left) + _S_size(__x->_M_right);
+    if constexpr (_Augmented)
+      static_cast<_Node*>(__x)->_M_aug = _S_fold_subtree(__x);
+  }
+
+  // a node was linked or unlinked below __x, fix the sizes up to the root.
+  void _M_update_to_root(_Base_ptr __x) noexcept
+  {
+    if constexpr (_Ranked || _Augmented) {
+      for (; __x != _M_head(); __x = __x->_M_parent)
+        _S_update(__x);
+    }
+  }
 
   /**
    *  If the red-black tree is empty, we set the parent node
@@ -329,10 +566,9 @@ template<class, class, class, class, class> friend class _Rb_tree;
   void _M_reset()
   {
     if (_M_header != nullptr) {
-      _M_header->_M_parent = 0;
+      _M_header->_M_parent._M_init(0, _Rb_tree_color::_S_red);
       _M_header->_M_left = _M_header;
       _M_header->_M_right = _M_header;
-      _M_header->_M_color = _Rb_tree_color::_S_red;
     }
     _M_node_count = 0;
   }
@@ -340,10 +576,24 @@ template<class, class, class, class, class> friend class _Rb_tree;
   void _M_copy(const _Rb_tree& __x)
   {
     if (__x._M_header->_M_parent != nullptr) {
+      _Const_Link_type __root = static_cast<_Const_Link_type>(__x._M_root());
+      _Link_type __tmp;
+#if __TINY_RB_TREE_PARALLEL_COPY
+      if (__x._M_node_count >= __TINY_RB_TREE_PARALLEL_COPY)
+        __tmp = _M_copy_parallel(__root, __x._M_node_count);
+      else
+#endif
+      __tmp = _M_copy(__root, __x._M_node_count);
       if (_M_header == nullptr) {
-        _M_header = _M_head_allocator.allocate(1);
+        try {
+          _M_header = _M_head_allocator.allocate(1);
+        } catch (...) {
+          _M_erase(__tmp);
+          throw;
+        }
+        _M_reset();
       }
-      _Link_type __tmp = _M_copy((_Link_type)__x._M_header->_M_parent, (_Link_type)_M_header);
+      __tmp->_M_parent = _M_header;
       _M_header->_M_parent = __tmp;
       _M_header->_M_left = _Rb_tree::_S_minimum(__tmp);
       _M_header->_M_right = _Rb_tree::_S_maximum(__tmp);
@@ -351,43 +601,251 @@ template<class, class, class, class, class> friend class _Rb_tree;
     }
   }
 
-  _Link_type _M_copy(_Link_type __x, _Link_type __p)
+  /**
+   * @brief  a copy of the subtree __x of __n nodes, made without recursion.
+   *  The nodes are allocated in as few contiguous runs as the allocator
+   *  can manage and cloned in key order, so walking the copy in order
+   *  walks its memory in order too.
+   * @attention  if copying a value throws, what was copied is freed and
+   *  the exception propagates.
+   */
+  _Link_type _M_copy(_Const_Link_type __x, size_type __n)
   {
-    _Link_type __top = _M_clone_node(__x);
-    __top->_M_parent = __p;
+    // the path from the subtree root to the node being copied, with the
+    // copies made so far. A red-black tree is at most 2 log2(n + 1) deep.
+    struct _Frame { _Const_Link_type _M_src; _Link_type _M_copy; } __path[128];
+    int __depth = 0;
+    // the copy of the subtree finished last, not yet linked to its parent.
+    _Link_type __done = nullptr;
+    _Node_run<_Node_allocator> __run(_M_node_allocator, __n);
 
     try {
-      if (__x->_M_right)
-        __top->_M_right = _M_copy(_S_right(__x), __top);
-      __p = __top;
-      __x = _S_left(__x);
-      while (__x != 0) {
-        _Link_type __y = _M_clone_node(__x);
-        __p->_M_left = __y;
-        __y->_M_parent = __p;
-        if (__x->_M_right)
-          __y->_M_right = _M_copy(_S_right(__x), __y);
-        __p = __y;
-        __x = _S_left(__x);
+      for (;;) {
+        for (; __x != nullptr; __x = _S_left(__x))
+          __path[__depth++] = { __x, nullptr };
+        _Frame& __f = __path[__depth - 1];
+        if (__f._M_copy == nullptr) {
+          // the left subtree is copied: the node, then its right subtree.
+          __f._M_copy = _M_clone_node(__f._M_src, __run._M_take());
+          __f._M_copy->_M_left = __done;
+          if (__done != nullptr)
+            __done->_M_parent = __f._M_copy;
+          __done = nullptr;
+          __x = _S_right(__f._M_src);
+        } else {
+          __f._M_copy->_M_right = __done;
+          if (__done != nullptr)
+            __done->_M_parent = __f._M_copy;
+          // a fold may point into its own tree, so it is rebuilt, not copied.
+          if constexpr (_Augmented)
+            _S_update(__f._M_copy);
+          __done = __f._M_copy;
+          if (--__depth == 0)
+            break;
+        }
+      }
+    } catch (...) {
+      for (int __i = 0; __i < __depth; ++__i)
+        _M_erase(__path[__i]._M_copy);
+      _M_erase(__done);
+      __run._M_release();
+      throw;
+    }
+    return __done;
+  }
+
+  // put __y where __x is in the tree, with __x's color and children.
+  void _M_transplant(_Base_ptr __x, _Base_ptr __y) noexcept
+  {
+    _Base_ptr __p = __x->_M_parent;
+    __y->_M_parent = __p;
+    __y->_M_set_color(__x->_M_get_color());
+    __y->_M_left = __x->_M_left;
+    __y->_M_right = __x->_M_right;
+    if (__y->_M_left != nullptr)
+      __y->_M_left->_M_parent = __y;
+    if (__y->_M_right != nullptr)
+      __y->_M_right->_M_parent = __y;
+    if (__p == _M_head())
+      _M_root() = __y;
+    else if (__p->_M_left == __x)
+      __p->_M_left = __y;
+    else
+      __p->_M_right = __y;
+    if (_M_leftmost() == __x)
+      _M_leftmost() = __y;
+    if (_M_rightmost() == __x)
+      _M_rightmost() = __y;
+  }
+
+  // rebuild every fold, children before their parent, without recursion.
+  void _M_refold() noexcept
+  {
+    auto __first = [](_Base_ptr __x) {
+      for (;;) {
+        if (__x->_M_left != nullptr)
+          __x = __x->_M_left;
+        else if (__x->_M_right != nullptr)
+          __x = __x->_M_right;
+        else
+          return __x;
+      }
+    };
+    if (_M_header == nullptr || _M_root() == nullptr)
+      return;
+    for (_Base_ptr __x = __first(_M_root()); ; ) {
+      _S_update(__x);
+      _Base_ptr __p = __x->_M_parent;
+      if (__p == _M_head())
+        return;
+      __x = (__x == __p->_M_left && __p->_M_right != nullptr) ? __first(__p->_M_right) : __p;
+    }
+  }
+
+  // __x's value, color and size in __node, which has no children yet.
+  _Link_type _M_clone_node(_Const_Link_type __x, _Link_type __node)
+  {
+    _M_construct_node(__node, *__x->_M_valptr());
+    __node->_M_set_color(__x->_M_get_color());
+    __node->_M_left = 0;
+    __node->_M_right = 0;
+    if constexpr (_Ranked)
+      static_cast<_Node*>(__node)->_M_size = static_cast<const _Node*>(__x)->_M_size;
+    return __node;
+  }
+
+#if __TINY_RB_TREE_PARALLEL_COPY
+  struct _Copy_task
+  {
+    _Const_Link_type _M_src;
+    _Link_type _M_copy = nullptr;
+    std::exception_ptr _M_error;
+  };
+
+  // the number of nodes in the subtree __x.
+  static size_type _S_count(_Const_Base_ptr __x) noexcept
+  {
+    _Const_Base_ptr __top = __x;
+    size_type __n = 0;
+    for (__x = _S_minimum(__x); ; ++__n) {
+      if (__x->_M_right != nullptr) {
+        __x = _S_minimum(__x->_M_right);
+        continue;
+      }
+      while (__x != __top && __x == __x->_M_parent->_M_right)
+        __x = __x->_M_parent;
+      if (__x == __top)
+        return __n + 1;
+      __x = __x->_M_parent;
+    }
+  }
+
+  // the subtrees __depth levels below __x, left to right.
+  static void _S_split(_Const_Link_type __x, int __depth, _Copy_task* __tasks, unsigned& __n)
+  {
+    if (__depth == 0) {
+      __tasks[__n++]._M_src = __x;
+      return;
+    }
+    if (__x->_M_left != nullptr)
+      _S_split(_S_left(__x), __depth - 1, __tasks, __n);
+    if (__x->_M_right != nullptr)
+      _S_split(_S_right(__x), __depth - 1, __tasks, __n);
+  }
+
+  // copy the top __depth levels of __x onto the subtrees the tasks copied.
+  _Link_type _M_copy_top(_Const_Link_type __x, int __depth, _Copy_task* __tasks, unsigned& __n)
+  {
+    if (__depth == 0) {
+      _Link_type __copy = __tasks[__n]._M_copy;
+      __tasks[__n++]._M_copy = nullptr;
+      return __copy;
+    }
+    _Link_type __top = _M_clone_node(__x, _M_get_node());
+    try {
+      if (__x->_M_left != nullptr) {
+        __top->_M_left = _M_copy_top(_S_left(__x), __depth - 1, __tasks, __n);
+        __top->_M_left->_M_parent = __top;
+      }
+      if (__x->_M_right != nullptr) {
+        __top->_M_right = _M_copy_top(_S_right(__x), __depth - 1, __tasks, __n);
+        __top->_M_right->_M_parent = __top;
       }
     } catch (...) {
       _M_erase(__top);
+      throw;
     }
+    if constexpr (_Augmented)
+      _S_update(__top);
     return __top;
   }
 
-  _Link_type _M_clone_node(_Link_type __x)
-  {
-    _Link_type __tmp = _M_create_node(*__x->_M_valptr());
-    __tmp->_M_color = __x->_M_color;
-    __tmp->_M_left = 0;
-    __tmp->_M_right = 0;
-    return __tmp;
+  /**
+   * @brief  _M_copy(__x, __n) with the subtrees a few levels down cloned
+   *  on several threads, about two for each. The calling thread works too
+   *  and then copies the levels above them.
+   */
+  _Link_type _M_copy_parallel(_Const_Link_type __x, size_type __n)
+  {
+    unsigned __threads = __TINY_RB_TREE_COPY_THREADS;
+    if (__threads == 0)
+      __threads = std::thread::hardware_concurrency();
+    if (__threads > 16)
+      __threads = 16;
+    if (__threads < 2)
+      return _M_copy(__x, __n);
+
+    int __depth = 1;
+    while ((1u << __depth) < 2 * __threads)
+      ++__depth;
+    _Copy_task __tasks[32];
+    unsigned __ntasks = 0;
+    _S_split(__x, __depth, __tasks, __ntasks);
+
+    std::atomic<unsigned> __next = 0;
+    auto __work = [&]() {
+      for (unsigned __i; (__i = __next++) < __ntasks; ) {
+        try {
+          __tasks[__i]._M_copy = _M_copy(__tasks[__i]._M_src, _S_count(__tasks[__i]._M_src));
+        } catch (...) {
+          __tasks[__i]._M_error = std::current_exception();
+        }
+      }
+    };
+    std::thread __pool[15];
+    unsigned __started = 0;
+    try {
+      for (; __started + 1 < __threads; ++__started)
+        __pool[__started] = std::thread(__work);
+    } catch (const std::system_error&) {
+      // fewer threads, the rest of the tasks fall to this one.
+    }
+    __work();
+    for (unsigned __i = 0; __i < __started; ++__i)
+      __pool[__i].join();
+
+    std::exception_ptr __error;
+    for (unsigned __i = 0; __i < __ntasks && !__error; ++__i)
+      __error = __tasks[__i]._M_error;
+    if (!__error) {
+      try {
+        unsigned __i = 0;
+        return _M_copy_top(__x, __depth, __tasks, __i);
+      } catch (...) {
+        __error = std::current_exception();
+      }
+    }
+    for (unsigned __i = 0; __i < __ntasks; ++__i)
+      _M_erase(__tasks[__i]._M_copy);
+    std::rethrow_exception(__error);
   }
+#endif
 
   template <class... _Args>
   void _M_construct_node(_Link_type __node, _Args&&... __args)
   {
+    // the memory is fresh from the allocator.
+    __node->_M_parent._M_init(0, _Rb_tree_color::_S_red);
     try {
       tinySTL::construct(__node->_M_valptr(),
         tinySTL::forward<_Args>(__args)...);
@@ -416,7 +874,7 @@ template<class, class, class, class, class> friend class _Rb_tree;
     _M_put_node(__p);
   }
 
-  _Base_ptr& _M_root() noexcept
+  _Rb_tree_parent_link& _M_root() noexcept
   { return _M_header->_M_parent; }
 
   _Const_Base_ptr _M_root() const noexcept
@@ -626,6 +1084,43 @@ template<class, class, class, class, class> friend class _Rb_tree;
     _M_reset();
   }
 
+  /**
+   * @brief  move every element into a node of a contiguous run, in key
+   *  order, and relink each new node where the old one was. The shape of
+   *  the tree does not change.
+   * @attention  invalidates every iterator. An element is moved if that
+   *  cannot throw and copied otherwise; if a copy throws, the elements
+   *  already moved stay moved and the tree holds what it held.
+   */
+  void compact()
+  {
+    if (_M_node_count == 0)
+      return;
+    _Node_run<_Node_allocator> __run(_M_node_allocator, _M_node_count);
+    _Base_ptr __x = _M_leftmost();
+    try {
+      while (__x != _M_head()) {
+        _Link_type __y = __run._M_take();
+        _M_construct_node(__y, tinySTL::move_if_noexcept(*static_cast<_Link_type>(__x)->_M_valptr()));
+        if constexpr (_Ranked)
+          static_cast<_Node*>(__y)->_M_size = static_cast<_Node*>(__x)->_M_size;
+        if constexpr (_Augmented)
+          static_cast<_Node*>(__y)->_M_aug = static_cast<_Node*>(__x)->_M_aug;
+        _M_transplant(__x, __y);
+        _M_drop_node(static_cast<_Link_type>(__x));
+        __x = _Rb_tree_node_base::_Rb_tree_increment(__y);
+      }
+    } catch (...) {
+      __run._M_release();
+      if constexpr (_Augmented)
+        _M_refold();
+      throw;
+    }
+    // a fold may point into the tree, at values that have moved.
+    if constexpr (_Augmented)
+      _M_refold();
+  }
+
   template <class _Arg>
   tinySTL::pair<iterator, bool>
   _M_insert_unique(_Arg&& __x) 
@@ -954,7 +1449,13 @@ template<class, class, class, class, class> friend class _Rb_tree;
   _M_insert(_Base_ptr __hint, _Base_ptr __pos_parent, _Args&&... __args)
   {
     _Link_type new_node = _M_create_node(tinySTL::forward<_Args>(__args)...);
-    return _M_insert_node(__hint, __pos_parent, new_node);
+    // the comparison in _M_insert_node may throw, before the node is linked.
+    try {
+      return _M_insert_node(__hint, __pos_parent, new_node);
+    } catch (...) {
+      _M_drop_node(new_node);
+      throw;
+    }
   }
 
   /// @p __hint
@@ -968,6 +1469,7 @@ template<class, class, class, class, class> friend class _Rb_tree;
       new_node->_M_setBlk();
       new_node->_M_parent = __pos_parent;
       new_node->_M_left = new_node->_M_right = 0;
+      _S_update(new_node);
       ++_M_node_count;
       return iterator(new_node);
     } 
@@ -985,6 +1487,7 @@ template<class, class, class, class, class> friend class _Rb_tree;
     }
     new_node->_M_parent = __pos_parent;
     new_node->_M_left = new_node->_M_right = 0;
+    _M_update_to_root(new_node);
     _M_pre_fix_insert(new_node);
     ++_M_node_count;
     return iterator(new_node);
@@ -1078,6 +1581,8 @@ template<class, class, class, class, class> friend class _Rb_tree;
     rchild->_M_parent = x->_M_parent;
     rchild->_M_left = x;
     x->_M_parent = rchild;
+    _S_update(x);
+    _S_update(rchild);
   }
 
   void _M_right_rotate(_Base_ptr x) 
@@ -1097,13 +1602,285 @@ template<class, class, class, class, class> friend class _Rb_tree;
     lchild->_M_parent = x->_M_parent;
     lchild->_M_right = x;
     x->_M_parent = lchild;
+    _S_update(x);
+    _S_update(lchild);
+  }
+
+  /**
+   * @brief insert [first, last). Into an empty tree, the sorted prefix of
+   *  the input is linked into a balanced tree in O(n) with no
+   *  rebalancing, the rest goes through hinted insertion.
+   */
+  template <class _InputIterator>
+  void _M_insert_range_unique(_InputIterator __first, _InputIterator __last)
+  {
+    if (empty())
+      __first = _M_build_sorted_prefix<true>(__first, __last);
+    iterator __it = end();
+    for (; __first != __last; ++__first)
+      __it = _M_insert_unique(__it, *__first);
+  }
+
+  template <class _InputIterator>
+  void _M_insert_range_equal(_InputIterator __first, _InputIterator __last)
+  {
+    if (empty())
+      __first = _M_build_sorted_prefix<false>(__first, __last);
+    // hinting at end() keeps equal keys in input order.
+    for (; __first != __last; ++__first)
+      _M_insert_equal(end(), *__first);
+  }
+
+  /**
+   * @brief build the tree from the input while it is sorted. Nodes are
+   *  chained through _M_right until the first value out of order, which
+   *  is inserted normally once the chain is linked into a tree.
+   * @return the position after the consumed input.
+   * @attention the tree must be empty.
+   */
+  template <bool _Unique, class _InputIterator>
+  _InputIterator
+  _M_build_sorted_prefix(_InputIterator __first, _InputIterator __last)
+  {
+    // __x is a node not yet in the chain, __pending the first node out
+    // of order; both are dropped if anything throws before they are linked.
+    _Link_type __head = 0, __tail = 0, __x = 0, __pending = 0;
+    size_type __n = 0;
+    try {
+      for (; __first != __last; ++__first) {
+        __x = _M_create_node(*__first);
+        if (__tail != 0) {
+          if (key_comp()(_S_key(__x), _S_key(__tail))) {
+            __pending = __x;
+            __x = 0;
+            ++__first;
+            break;
+          }
+          if (_Unique && !key_comp()(_S_key(__tail), _S_key(__x))) {
+            _M_drop_node(__x);
+            __x = 0;
+            continue;
+          }
+          __tail->_M_right = __x;
+        } else {
+          __head = __x;
+        }
+        __x->_M_right = 0;
+        __tail = __x;
+        __x = 0;
+        ++__n;
+      }
+    } catch (...) {
+      if (__x != 0)
+        _M_drop_node(__x);
+      if (__pending != 0)
+        _M_drop_node(__pending);
+      while (__head != 0) {
+        _Link_type __next = _S_right(__head);
+        _M_drop_node(__head);
+        __head = __next;
+      }
+      throw;
+    }
+
+    if (__n != 0)
+      _M_attach(_M_link_chain(__head, __n), __n);
+    if (__pending != 0) {
+      try {
+        if (_Unique) {
+          if (!_M_insert_node_unique(__pending).second)
+            _M_drop_node(__pending);
+        } else {
+          _M_insert_node_equal(__pending);
+        }
+      } catch (...) {
+        _M_drop_node(__pending);
+        throw;
+      }
+    }
+    return __first;
+  }
+
+  // link the sorted chain __list of __n nodes into a balanced subtree.
+  _Link_type _M_link_chain(_Link_type __list, size_type __n)
+  {
+    // nodes at the deepest level of an incomplete tree are red.
+    size_type __red_depth = 0;
+    for (size_type __m = __n + 1; __m > 1; __m >>= 1)
+      ++__red_depth;
+    return _M_link_balanced(__list, __n, 0, __red_depth);
+  }
+
+  // link the first __n nodes of the chain __list into a balanced subtree,
+  // __list moves past them.
+  _Link_type _M_link_balanced(_Link_type& __list, size_type __n,
+                              size_type __depth, size_type __red_depth)
+  {
+    if (__n == 0)
+      return 0;
+    size_type __left_n = (__n - 1) / 2;
+    _Link_type __left = _M_link_balanced(__list, __left_n, __depth + 1, __red_depth);
+    _Link_type __x = __list;
+    __list = _S_right(__list);
+    _Link_type __right = _M_link_balanced(__list, __n - 1 - __left_n, __depth + 1, __red_depth);
+    __x->_M_left = __left;
+    __x->_M_right = __right;
+    if (__left != 0)
+      __left->_M_parent = __x;
+    if (__right != 0)
+      __right->_M_parent = __x;
+    _S_update(__x);
+    if (__depth == __red_depth)
+      __x->_M_setRed();
+    else
+      __x->_M_setBlk();
+    return __x;
+  }
+
+  // where a value with key __k goes, as the (__hint, __pos_parent)
+  // arguments of _M_insert. When __k is present the parent is null and
+  // the first member is the node holding it.
+  template <class _Kt>
+  tinySTL::pair<_Base_ptr, _Base_ptr>
+  _M_get_insert_unique_pos(const _Kt& __k)
+  {
+    if (_M_header == nullptr) {
+      _M_header = _M_head_allocator.allocate(1);
+      _M_reset();
+    }
+    _Base_ptr pos = _M_root();
+    _Base_ptr pos_parent = _M_head();
+    bool __comp = true;
+    while (pos != nullptr) {
+      pos_parent = pos;
+      __comp = key_comp()(__k, _S_key(pos));
+      pos = __comp ? pos->_M_left : pos->_M_right;
+    }
+    iterator j = iterator(pos_parent);
+    if (__comp) {
+      if (j == begin()) {
+        return {nullptr, pos_parent};
+      }
+      --j;
+    }
+    if (key_comp()(_S_key(j._M_node), __k)) {
+      return {nullptr, pos_parent};
+    }
+    return {j._M_node, nullptr};
+  }
+
+  // as above, trying the neighbours of __position first.
+  template <class _Kt>
+  tinySTL::pair<_Base_ptr, _Base_ptr>
+  _M_get_insert_hint_unique_pos(iterator __position, const _Kt& __k)
+  {
+    if (_M_header == nullptr || size() == 0) {
+      return _M_get_insert_unique_pos(__k);
+    }
+    if (__position._M_node == _M_header) {
+      if (key_comp()(_S_key(_M_rightmost()), __k)) {
+        return {nullptr, _M_rightmost()};
+      }
+      return _M_get_insert_unique_pos(__k);
+    }
+    if (key_comp()(__k, _S_key(__position._M_node))) {
+      if (__position._M_node == _M_leftmost()) {
+        return {__position._M_node, __position._M_node};
+      }
+      iterator __before = __position;
+      --__before;
+      if (key_comp()(_S_key(__before._M_node), __k)) {
+        if (__before._M_node->_M_right == nullptr) {
+          return {nullptr, __before._M_node};
+        }
+        return {__position._M_node, __position._M_node};
+      }
+      return _M_get_insert_unique_pos(__k);
+    }
+    if (!key_comp()(_S_key(__position._M_node), __k)) {
+      return {__position._M_node, nullptr};
+    }
+    return _M_get_insert_unique_pos(__k);
+  }
+
+  /**
+   * @brief  insert a value built from __args unless the key __k is
+   *  present. The node is only created once __k is known to be absent.
+   */
+  template <class _Kt, class... _Args>
+  tinySTL::pair<iterator, bool>
+  _M_emplace_unique_key(const _Kt& __k, _Args&&... __args)
+  {
+    tinySTL::pair<_Base_ptr, _Base_ptr> __res = _M_get_insert_unique_pos(__k);
+    if (__res.second == nullptr) {
+      return {iterator(__res.first), false};
+    }
+    return {_M_insert(__res.first, __res.second, tinySTL::forward<_Args>(__args)...), true};
   }
 
+  template <class _Kt, class... _Args>
+  tinySTL::pair<iterator, bool>
+  _M_emplace_hint_unique_key(iterator __position, const _Kt& __k, _Args&&... __args)
+  {
+    tinySTL::pair<_Base_ptr, _Base_ptr> __res = _M_get_insert_hint_unique_pos(__position, __k);
+    if (__res.second == nullptr) {
+      return {iterator(__res.first), false};
+    }
+    return {_M_insert(__res.first, __res.second, tinySTL::forward<_Args>(__args)...), true};
+  }
+
+  template <class... _Args>
+  struct _First_arg;
+
+  template <class _Arg, class... _Args>
+  struct _First_arg<_Arg, _Args...> { typedef _Arg type; };
+
+  // a key is at hand without building the value: a value_type itself,
+  // or (key, mapped) arguments of a map.
+  template <class... _Args>
+  static constexpr bool _S_key_in_args()
+  {
+    if constexpr (sizeof...(_Args) == 1) {
+      return (is_same_v<remove_cvref_t<_Args>, value_type> && ...);
+    } else if constexpr (sizeof...(_Args) == 2 && !is_same_v<key_type, value_type>) {
+      return is_same_v<remove_cvref_t<typename _First_arg<_Args...>::type>, key_type>;
+    } else {
+      return false;
+    }
+  }
+
+  template <class _Arg, class... _Args>
+  static const _Arg& _S_first_arg(const _Arg& __x, const _Args&...)
+  { return __x; }
+
   template <class... _Args>
   tinySTL::pair<iterator, bool>
   _M_emplace_unique(_Args&&... __args) 
   {
-    return _M_insert_unique(value_type(tinySTL::forward<_Args>(__args)...));
+    if constexpr (_S_key_in_args<_Args...>()) {
+      const auto& __x = _S_first_arg(__args...);
+      if constexpr (sizeof...(_Args) == 1) {
+        return _M_emplace_unique_key(_KeyOfValue()(__x), tinySTL::forward<_Args>(__args)...);
+      } else {
+        return _M_emplace_unique_key(__x, tinySTL::forward<_Args>(__args)...);
+      }
+    } else {
+      // the key is only known once the value is built, so build it in
+      // the node and drop that if the key is taken.
+      _Link_type __z = _M_create_node(tinySTL::forward<_Args>(__args)...);
+      tinySTL::pair<_Base_ptr, _Base_ptr> __res;
+      try {
+        __res = _M_get_insert_unique_pos(_S_key(__z));
+      } catch (...) {
+        _M_drop_node(__z);
+        throw;
+      }
+      if (__res.second == nullptr) {
+        _M_drop_node(__z);
+        return {iterator(__res.first), false};
+      }
+      return {_M_insert_node(__res.first, __res.second, __z), true};
+    }
   }
 
   template <class... _Args> iterator
@@ -1115,7 +1892,29 @@ template<class, class, class, class, class> friend class _Rb_tree;
   template <class... _Args> iterator
   _M_emplace_hint_unique(iterator __position, _Args&&... __args) 
   {
-    return _M_insert_unique(__position, value_type(tinySTL::forward<_Args>(__args)...));
+    if constexpr (_S_key_in_args<_Args...>()) {
+      const auto& __x = _S_first_arg(__args...);
+      if constexpr (sizeof...(_Args) == 1) {
+        return _M_emplace_hint_unique_key(__position, _KeyOfValue()(__x),
+                                          tinySTL::forward<_Args>(__args)...).first;
+      } else {
+        return _M_emplace_hint_unique_key(__position, __x, tinySTL::forward<_Args>(__args)...).first;
+      }
+    } else {
+      _Link_type __z = _M_create_node(tinySTL::forward<_Args>(__args)...);
+      tinySTL::pair<_Base_ptr, _Base_ptr> __res;
+      try {
+        __res = _M_get_insert_hint_unique_pos(__position, _S_key(__z));
+      } catch (...) {
+        _M_drop_node(__z);
+        throw;
+      }
+      if (__res.second == nullptr) {
+        _M_drop_node(__z);
+        return iterator(__res.first);
+      }
+      return _M_insert_node(__res.first, __res.second, __z);
+    }
   }
 
   template <class... _Args> iterator
@@ -1130,9 +1929,16 @@ template<class, class, class, class, class> friend class _Rb_tree;
     if (empty() || __pos == end()) {
       __tiny_throw_range_error("erase");
     }
-    _Base_ptr pos = __pos._M_node;
-    iterator it(pos);
+    iterator it = __pos;
     ++it;
+    _M_drop_node(static_cast<_Link_type>(_M_unlink(__pos._M_node)));
+    return it;
+  }
+
+  // take pos out of the tree and rebalance, the node is left to the caller.
+  _Base_ptr
+  _M_unlink(_Base_ptr pos)
+  {
     _Base_ptr y = pos, x = nullptr, x_parent = nullptr;
     if (y->_M_left == nullptr) {
       x = y->_M_right;
@@ -1169,9 +1975,9 @@ template<class, class, class, class, class> friend class _Rb_tree;
       }
 
       y->_M_parent = pos->_M_parent;
-      _Rb_tree_color tmp = y->_M_color;
-      y->_M_color = pos->_M_color;
-      pos->_M_color = tmp;
+      _Rb_tree_color tmp = y->_M_get_color();
+      y->_M_set_color(pos->_M_get_color());
+      pos->_M_set_color(tmp);
       y = pos;
     } else {
       x_parent = y->_M_parent;
@@ -1204,17 +2010,87 @@ template<class, class, class, class, class> friend class _Rb_tree;
       }
     }
 
+    _M_update_to_root(x_parent);
     if (x == _M_root()) {
       if (x != nullptr) {
-        x->_M_color = _Rb_tree_color::_S_black;
+        x->_M_setBlk();
       }
-    } else if (y->_M_color == _Rb_tree_color::_S_black) {
+    } else if (y->_M_isBlk()) {
       _M_pre_fix_erase((_Link_type)x, (_Link_type)x_parent);
     }
 
-    _M_put_node((_Link_type)y);
     --_M_node_count;
-    return it;
+    return y;
+  }
+
+  // node handles, see tiny_node_handle.h.
+  template <class _NodeHandle>
+  _NodeHandle _M_extract(iterator __pos)
+  {
+    if (empty() || __pos == end()) {
+      __tiny_throw_range_error("extract");
+    }
+    _Base_ptr __p = _M_unlink(__pos._M_node);
+    return _NodeHandle(static_cast<_Node*>(__p), _M_node_allocator);
+  }
+
+  template <class _NodeHandle, class _Kt>
+  _NodeHandle _M_extract_key(const _Kt& __k)
+  {
+    iterator __pos = find(__k);
+    if (__pos == end()) {
+      return _NodeHandle();
+    }
+    return _M_extract<_NodeHandle>(__pos);
+  }
+
+  // the node stays in __nh if its key is taken.
+  template <class _NodeHandle>
+  tinySTL::pair<iterator, bool>
+  _M_reinsert_node_unique(_NodeHandle& __nh)
+  {
+    if (__nh.empty()) {
+      return {end(), false};
+    }
+    tinySTL::pair<iterator, bool> __r = _M_insert_node_unique(__nh._M_ptr);
+    if (__r.second) {
+      __nh._M_release();
+    }
+    return __r;
+  }
+
+  template <class _NodeHandle>
+  iterator
+  _M_reinsert_node_hint_unique(iterator __position, _NodeHandle& __nh)
+  {
+    if (__nh.empty()) {
+      return end();
+    }
+    tinySTL::pair<iterator, bool> __r = _M_insert_unique(__position, static_cast<_Link_type>(__nh._M_ptr));
+    if (__r.second) {
+      __nh._M_release();
+    }
+    return __r.first;
+  }
+
+  template <class _NodeHandle>
+  iterator
+  _M_reinsert_node_equal(_NodeHandle& __nh)
+  {
+    if (__nh.empty()) {
+      return end();
+    }
+    return _M_insert_node_equal(__nh._M_release());
+  }
+
+  template <class _NodeHandle>
+  iterator
+  _M_reinsert_node_hint_equal(iterator __position, _NodeHandle& __nh)
+  {
+    if (__nh.empty()) {
+      return end();
+    }
+    return _M_insert_equal(__position, static_cast<_Link_type>(__nh._M_release()));
   }
 
   size_type 
@@ -1226,17 +2102,46 @@ template<class, class, class, class, class> friend class _Rb_tree;
     return __n;
   }
 
+  /**
+   * @brief erase [first, last). Short ranges are unlinked node by node,
+   *  longer ones whose ends fall between distinct keys are cut out with
+   *  two splits and a join, O(log n) besides freeing the nodes.
+   */
   iterator
   erase(iterator __first, iterator __last) 
   {
     if (__first == begin() && __last == end()) {
       clear();
-    } else {
-      while (__first != __last) erase(__first++);
+      return __last;
     }
+    size_type __n = 0;
+    iterator __it = __first;
+    for (; __it != __last && __n < 16; ++__it)
+      ++__n;
+    if (__it == __last || !_M_key_boundary(__first) || !_M_key_boundary(__last)) {
+      while (__first != __last) erase(__first++);
+      return __last;
+    }
+    size_type __total = size();
+    _Subtree __lo, __mid, __hi{nullptr, 0};
+    _M_split(_M_detach(), _S_key(__first._M_node), false, __lo, __mid);
+    if (__last != end())
+      _M_split(__mid, _S_key(__last._M_node), false, __mid, __hi);
+    __n = _M_erase(static_cast<_Link_type>(__mid._M_node));
+    _M_attach(_S_join2(__lo, __hi)._M_node, __total - __n);
     return __last;
   }
 
+  // no value before __pos has the key of __pos.
+  bool _M_key_boundary(iterator __pos)
+  {
+    if (__pos == begin() || __pos == end())
+      return true;
+    iterator __prev = __pos;
+    --__prev;
+    return key_comp()(_S_key(__prev._M_node), _S_key(__pos._M_node));
+  }
+
   void 
   erase(const key_type* __first, const key_type* __last) 
   {
@@ -1285,7 +2190,7 @@ template<class, class, class, class, class> friend class _Rb_tree;
             _M_right_rotate(brother);
             brother = _S_right(parent);
           }
-          brother->_M_color = parent->_M_color;
+          brother->_M_set_color(parent->_M_get_color());
           parent->_M_setBlk();
           _S_right(brother)->_M_setBlk();
           _M_left_rotate(parent);
@@ -1320,7 +2225,7 @@ template<class, class, class, class, class> friend class _Rb_tree;
             _M_left_rotate(brother);
             brother = _S_left(parent);
           }
-          brother->_M_color = parent->_M_color;
+          brother->_M_set_color(parent->_M_get_color());
           parent->_M_setBlk();
           _S_left(brother)->_M_setBlk();
           _M_right_rotate(parent);
@@ -1372,7 +2277,7 @@ template<class, class, class, class, class> friend class _Rb_tree;
   }
 
   template <class _Compare2>
-  void _M_merge_unique(_Rb_tree<_Key, _Val, _KeyOfValue, _Compare2, _Alloc>&& __tree) 
+  void _M_merge_unique(_Rb_tree<_Key, _Val, _KeyOfValue, _Compare2, _Alloc, _Ranked, _Augment>&& __tree) 
   {
     if (__tree.empty()) {
       return;
@@ -1382,14 +2287,14 @@ template<class, class, class, class, class> friend class _Rb_tree;
       _M_reset();
     }
     iterator pos = end();
-    _Rb_tree<_Key, _Val, _KeyOfValue, _Compare2, _Alloc> tmp;
+    _Rb_tree<_Key, _Val, _KeyOfValue, _Compare2, _Alloc, _Ranked, _Augment> tmp;
     _M_merge_unique_aux((_Link_type)__tree._M_root(), pos, tmp);
     __tree._M_reset();
     __tree = tinySTL::move(tmp);
   }
 
   template <class _Compare2>
-  void _M_merge_equal(_Rb_tree<_Key, _Val, _KeyOfValue, _Compare2, _Alloc>&& __tree) 
+  void _M_merge_equal(_Rb_tree<_Key, _Val, _KeyOfValue, _Compare2, _Alloc, _Ranked, _Augment>&& __tree) 
   {
     if (__tree.empty()) {
       return;
@@ -1405,7 +2310,7 @@ template<class, class, class, class, class> friend class _Rb_tree;
 
   template <class _Compare2>
   void _M_merge_unique_aux(_Link_type __x, iterator& pos, 
-      _Rb_tree<_Key, _Val, _KeyOfValue, _Compare2, _Alloc>& tmp) 
+      _Rb_tree<_Key, _Val, _KeyOfValue, _Compare2, _Alloc, _Ranked, _Augment>& tmp) 
   {
     while (__x != 0) {
       _M_merge_unique_aux(_S_right(__x), pos, tmp);
@@ -1429,22 +2334,551 @@ template<class, class, class, class, class> friend class _Rb_tree;
     }
   }
 
+  /**
+   * Join-based bulk operations. Subtrees are taken off the header and
+   * recombined with join(l, k, r), which links l < k < r in time
+   * proportional to the difference of their black heights. Split, union,
+   * intersection and difference build on it and cost O(m log(n/m + 1))
+   * for trees of sizes m <= n, instead of one insertion per value.
+   */
+
+  // a subtree taken off the header, with its black height.
+  struct _Subtree
+  {
+    _Base_ptr _M_node;
+    int _M_height;
+  };
+
+  // nodes chained through _M_right, in key order.
+  struct _Chain
+  {
+    _Base_ptr _M_head = nullptr;
+    _Base_ptr _M_tail = nullptr;
+    size_type _M_count = 0;
+
+    void _M_push(_Base_ptr __x) noexcept
+    {
+      __x->_M_right = nullptr;
+      if (_M_tail != nullptr)
+        _M_tail->_M_right = __x;
+      else
+        _M_head = __x;
+      _M_tail = __x;
+      ++_M_count;
+    }
+  };
+
+  static bool _S_is_red(_Const_Base_ptr __x) noexcept
+  { return __x != nullptr && __x->_M_isRed(); }
+
+  static int _S_black_height(_Const_Base_ptr __x) noexcept
+  {
+    int __h = 0;
+    for (; __x != nullptr; __x = __x->_M_left)
+      __h += !_S_is_red(__x);
+    return __h;
+  }
+
+  // take all nodes off the header, the tree is left empty.
+  _Subtree _M_detach() noexcept
+  {
+    if (_M_header == nullptr || _M_root() == nullptr)
+      return {nullptr, 0};
+    _Subtree __t{_M_root(), _S_black_height(_M_root())};
+    _M_reset();
+    return __t;
+  }
+
+  // hang the subtree __root of __n nodes under the header.
+  void _M_attach(_Base_ptr __root, size_type __n)
+  {
+    if (__root == nullptr) {
+      _M_reset();
+      return;
+    }
+    if (_M_header == nullptr)
+      _M_header = _M_head_allocator.allocate(1);
+    _M_reset();
+    __root->_M_parent = _M_head();
+    __root->_M_setBlk();
+    _M_root() = __root;
+    _M_leftmost() = _S_minimum(__root);
+    _M_rightmost() = _S_maximum(__root);
+    _M_node_count = __n;
+  }
+
+  static void _S_link(_Base_ptr __l, _Base_ptr __k, _Base_ptr __r,
+                      _Rb_tree_color __c) noexcept
+  {
+    __k->_M_left = __l;
+    __k->_M_right = __r;
+    if (__l != nullptr)
+      __l->_M_parent = __k;
+    if (__r != nullptr)
+      __r->_M_parent = __k;
+    __k->_M_set_color(__c);
+    _S_update(__k);
+  }
+
+  // rotations inside a detached subtree, the caller links the new top.
+  static _Base_ptr _S_rotate_left(_Base_ptr __x) noexcept
+  {
+    _Base_ptr __y = __x->_M_right;
+    __x->_M_right = __y->_M_left;
+    if (__y->_M_left != nullptr)
+      __y->_M_left->_M_parent = __x;
+    __y->_M_left = __x;
+    __x->_M_parent = __y;
+    _S_update(__x);
+    _S_update(__y);
+    return __y;
+  }
+
+  static _Base_ptr _S_rotate_right(_Base_ptr __x) noexcept
+  {
+    _Base_ptr __y = __x->_M_left;
+    __x->_M_left = __y->_M_right;
+    if (__y->_M_right != nullptr)
+      __y->_M_right->_M_parent = __x;
+    __y->_M_right = __x;
+    __x->_M_parent = __y;
+    _S_update(__x);
+    _S_update(__y);
+    return __y;
+  }
+
+  // hang __k and the shorter __r off the right spine of __l, fixing a red
+  // child of a red node on the way back up.
+  static _Base_ptr _S_join_right(_Base_ptr __l, int __hl, _Base_ptr __k,
+                                 _Base_ptr __r, int __hr) noexcept
+  {
+    if (!_S_is_red(__l) && __hl == __hr) {
+      _S_link(__l, __k, __r, _Rb_tree_color::_S_red);
+      return __k;
+    }
+    _Base_ptr __t = _S_join_right(__l->_M_right, __hl - !_S_is_red(__l),
+                                  __k, __r, __hr);
+    __l->_M_right = __t;
+    __t->_M_parent = __l;
+    _S_update(__l);
+    if (!_S_is_red(__l) && _S_is_red(__t) && _S_is_red(__t->_M_right)) {
+      __t->_M_right->_M_setBlk();
+      return _S_rotate_left(__l);
+    }
+    return __l;
+  }
+
+  static _Base_ptr _S_join_left(_Base_ptr __l, int __hl, _Base_ptr __k,
+                                _Base_ptr __r, int __hr) noexcept
+  {
+    if (!_S_is_red(__r) && __hl == __hr) {
+      _S_link(__l, __k, __r, _Rb_tree_color::_S_red);
+      return __k;
+    }
+    _Base_ptr __t = _S_join_left(__l, __hl, __k, __r->_M_left,
+                                 __hr - !_S_is_red(__r));
+    __r->_M_left = __t;
+    __t->_M_parent = __r;
+    _S_update(__r);
+    if (!_S_is_red(__r) && _S_is_red(__t) && _S_is_red(__t->_M_left)) {
+      __t->_M_left->_M_setBlk();
+      return _S_rotate_right(__r);
+    }
+    return __r;
+  }
+
+  static void _S_blacken(_Subtree& __t) noexcept
+  {
+    if (_S_is_red(__t._M_node)) {
+      __t._M_node->_M_setBlk();
+      ++__t._M_height;
+    }
+  }
+
+  // link __l < __k < __r into one subtree.
+  static _Subtree _S_join(_Subtree __l, _Base_ptr __k, _Subtree __r) noexcept
+  {
+    // with black roots no red node gets a red child from outside.
+    _S_blacken(__l);
+    _S_blacken(__r);
+    if (__l._M_height > __r._M_height) {
+      _Base_ptr __t = _S_join_right(__l._M_node, __l._M_height, __k,
+                                    __r._M_node, __r._M_height);
+      return {__t, __l._M_height};
+    }
+    if (__r._M_height > __l._M_height) {
+      _Base_ptr __t = _S_join_left(__l._M_node, __l._M_height, __k,
+                                   __r._M_node, __r._M_height);
+      return {__t, __r._M_height};
+    }
+    _S_link(__l._M_node, __k, __r._M_node, _Rb_tree_color::_S_red);
+    return {__k, __l._M_height};
+  }
+
+  // take the last node out of the non-empty __t, __rest gets the others.
+  static _Base_ptr _S_split_last(_Subtree __t, _Subtree& __rest) noexcept
+  {
+    _Base_ptr __x = __t._M_node;
+    int __h = __t._M_height - !_S_is_red(__x);
+    if (__x->_M_right == nullptr) {
+      __rest = {__x->_M_left, __h};
+      return __x;
+    }
+    _Subtree __r;
+    _Base_ptr __last = _S_split_last({__x->_M_right, __h}, __r);
+    __rest = _S_join({__x->_M_left, __h}, __x, __r);
+    return __last;
+  }
+
+  // link __l < __r into one subtree.
+  static _Subtree _S_join2(_Subtree __l, _Subtree __r) noexcept
+  {
+    if (__l._M_node == nullptr)
+      return __r;
+    _Subtree __rest;
+    _Base_ptr __k = _S_split_last(__l, __rest);
+    return _S_join(__rest, __k, __r);
+  }
+
+  // values less than __k go to __l, the others to __r. With __take_equal
+  // a value equal to __k is returned instead, for trees of unique keys.
+  _Base_ptr _M_split(_Subtree __t, const key_type& __k, bool __take_equal,
+                     _Subtree& __l, _Subtree& __r)
+  {
+    _Base_ptr __x = __t._M_node;
+    if (__x == nullptr) {
+      __l = __r = {nullptr, 0};
+      return nullptr;
+    }
+    int __h = __t._M_height - !_S_is_red(__x);
+    _Subtree __xl{__x->_M_left, __h}, __xr{__x->_M_right, __h};
+    if (key_comp()(_S_key(__x), __k)) {
+      _Subtree __rl;
+      _Base_ptr __m = _M_split(__xr, __k, __take_equal, __rl, __r);
+      __l = _S_join(__xl, __x, __rl);
+      return __m;
+    }
+    if (__take_equal && !key_comp()(__k, _S_key(__x))) {
+      __l = __xl;
+      __r = __xr;
+      return __x;
+    }
+    _Subtree __lr;
+    _Base_ptr __m = _M_split(__xl, __k, __take_equal, __l, __lr);
+    __r = _S_join(__lr, __x, __xr);
+    return __m;
+  }
+
+  // __a and __b of unique keys, for a key in both the node of __a stays
+  // if __keep_a and the other one goes to __dups.
+  _Subtree _M_union(_Subtree __a, _Subtree __b, bool __keep_a, _Chain& __dups)
+  {
+    if (__a._M_node == nullptr)
+      return __b;
+    if (__b._M_node == nullptr)
+      return __a;
+    _Base_ptr __k = __a._M_node;
+    int __h = __a._M_height - !_S_is_red(__k);
+    _Subtree __al{__k->_M_left, __h}, __ar{__k->_M_right, __h}, __bl, __br;
+    _Base_ptr __m = _M_split(__b, _S_key(__k), true, __bl, __br);
+    _Subtree __l = _M_union(__al, __bl, __keep_a, __dups);
+    if (__m != nullptr) {
+      if (!__keep_a)
+        tinySTL::swap(__k, __m);
+      __dups._M_push(__m);
+    }
+    _Subtree __r = _M_union(__ar, __br, __keep_a, __dups);
+    return _S_join(__l, __k, __r);
+  }
+
+  // the keys in both, the other nodes are freed. __n counts the result.
+  _Subtree _M_intersect(_Subtree __a, _Subtree __b, bool __keep_a, size_type& __n)
+  {
+    if (__a._M_node == nullptr || __b._M_node == nullptr) {
+      _M_erase(static_cast<_Link_type>(__a._M_node));
+      _M_erase(static_cast<_Link_type>(__b._M_node));
+      return {nullptr, 0};
+    }
+    _Base_ptr __k = __a._M_node;
+    int __h = __a._M_height - !_S_is_red(__k);
+    _Subtree __al{__k->_M_left, __h}, __ar{__k->_M_right, __h}, __bl, __br;
+    _Base_ptr __m = _M_split(__b, _S_key(__k), true, __bl, __br);
+    _Subtree __l = _M_intersect(__al, __bl, __keep_a, __n);
+    _Subtree __r = _M_intersect(__ar, __br, __keep_a, __n);
+    if (__m == nullptr) {
+      _M_drop_node(static_cast<_Link_type>(__k));
+      return _S_join2(__l, __r);
+    }
+    if (!__keep_a)
+      tinySTL::swap(__k, __m);
+    _M_drop_node(static_cast<_Link_type>(__m));
+    ++__n;
+    return _S_join(__l, __k, __r);
+  }
+
+  // the keys of __a not in __b, the other nodes are freed. __n counts
+  // the nodes dropped from __a.
+  _Subtree _M_subtract(_Subtree __a, _Subtree __b, size_type& __n)
+  {
+    if (__a._M_node == nullptr) {
+      _M_erase(static_cast<_Link_type>(__b._M_node));
+      return {nullptr, 0};
+    }
+    if (__b._M_node == nullptr)
+      return __a;
+    _Base_ptr __k = __b._M_node;
+    int __h = __b._M_height - !_S_is_red(__k);
+    _Subtree __bl{__k->_M_left, __h}, __br{__k->_M_right, __h}, __al, __ar;
+    _Base_ptr __m = _M_split(__a, _S_key(__k), true, __al, __ar);
+    _Subtree __l = _M_subtract(__al, __bl, __n);
+    _Subtree __r = _M_subtract(__ar, __br, __n);
+    _M_drop_node(static_cast<_Link_type>(__k));
+    if (__m != nullptr) {
+      _M_drop_node(static_cast<_Link_type>(__m));
+      ++__n;
+    }
+    return _S_join2(__l, __r);
+  }
+
+  // the number of values less than __k, counted from the nearer end when
+  // the tree is not ranked.
+  size_type _M_count_less(const key_type& __k) const
+  {
+    if constexpr (_Ranked) {
+      return rank(__k);
+    } else {
+      const_iterator __pos = lower_bound(__k), __f = begin(), __b = end();
+      for (size_type __n = 0;; ++__n, ++__f, --__b) {
+        if (__f == __pos)
+          return __n;
+        if (__b == __pos)
+          return size() - __n;
+      }
+    }
+  }
+
+  /**
+   * @brief move the values not less than __k into a new tree.
+   * @attention O(log n) for ranked trees, otherwise the sizes of the two
+   *  halves are counted from the nearer end, O(log n + min(l, r)).
+   */
+  _Rb_tree _M_split_off(const key_type& __k)
+  {
+    _Rb_tree __r(_M_compare);
+    if (empty())
+      return __r;
+    size_type __total = size();
+    size_type __n = _M_count_less(__k);
+    _Subtree __lo, __hi;
+    _M_split(_M_detach(), __k, false, __lo, __hi);
+    _M_attach(__lo._M_node, __n);
+    __r._M_attach(__hi._M_node, __total - __n);
+    return __r;
+  }
+
+  /**
+   * @brief append the values of __right, which must all follow ours, or
+   *  all be greater with __unique. O(log n).
+   */
+  void _M_join(_Rb_tree&& __right, bool __unique)
+  {
+    if (__right.empty())
+      return;
+    if (!empty()) {
+      const key_type& __lmax = _S_key(_M_rightmost());
+      const key_type& __rmin = _S_key(__right._M_leftmost());
+      if (key_comp()(__rmin, __lmax) || (__unique && !key_comp()(__lmax, __rmin)))
+        __tiny_throw_range_error("join");
+    }
+    size_type __n = size() + __right.size();
+    _Subtree __l = _M_detach();
+    _M_attach(_S_join2(__l, __right._M_detach())._M_node, __n);
+  }
+
+  /**
+   * @brief merge for trees of unique keys: a key both trees hold stays
+   *  in __src. With the same comparator and sizes within a factor of 16
+   *  the trees are unioned by splitting the larger at the keys of the
+   *  smaller, O(m log(n/m + 1)).
+   */
+  template <class _Compare2>
+  void _M_union_unique(_Rb_tree<_Key, _Val, _KeyOfValue, _Compare2, _Alloc, _Ranked, _Augment>&& __src)
+  {
+    if constexpr (!is_same_v<_Compare, _Compare2>) {
+      _M_merge_unique(tinySTL::move(__src));
+    } else {
+      if (__src.empty())
+        return;
+      // a delta much smaller than the tree is cheaper to insert node by
+      // node than to split the tree at each of its keys.
+      if (__src.size() * 16 < size()) {
+        _M_merge_unique(tinySTL::move(__src));
+        return;
+      }
+      size_type __n = size() + __src.size();
+      bool __smaller = size() <= __src.size();
+      _Subtree __a = _M_detach(), __b = __src._M_detach();
+      _Chain __dups;
+      _Subtree __u = __smaller ? _M_union(__a, __b, true, __dups)
+                               : _M_union(__b, __a, false, __dups);
+      _M_attach(__u._M_node, __n - __dups._M_count);
+      _Link_type __list = static_cast<_Link_type>(__dups._M_head);
+      __src._M_attach(__src._M_link_chain(__list, __dups._M_count), __dups._M_count);
+    }
+  }
+
+  // keep the keys __x also holds, with our values. __x is left empty.
+  void _M_intersect_unique(_Rb_tree&& __x)
+  {
+    size_type __n = 0;
+    bool __smaller = size() <= __x.size();
+    _Subtree __a = _M_detach(), __b = __x._M_detach();
+    _Subtree __r = __smaller ? _M_intersect(__a, __b, true, __n)
+                             : _M_intersect(__b, __a, false, __n);
+    _M_attach(__r._M_node, __n);
+  }
+
+  // drop the keys __x holds. __x is left empty.
+  void _M_subtract_unique(_Rb_tree&& __x)
+  {
+    size_type __n = 0, __total = size();
+    _Subtree __a = _M_detach();
+    _Subtree __r = _M_subtract(__a, __x._M_detach(), __n);
+    _M_attach(__r._M_node, __total - __n);
+  }
+
+  /**
+   * @brief the value at index __k in key order, end() when __k >= size().
+   * @attention ranked trees only, O(log n).
+   */
+  iterator
+  nth(size_type __k) const
+  {
+    static_assert(_Ranked, "nth() needs a ranked tree");
+    if (__k >= size())
+      return iterator(_M_header);
+    _Base_ptr __x = _M_header->_M_parent;
+    for (;;) {
+      size_type __left = _S_size(__x->_M_left);
+      if (__k < __left) {
+        __x = __x->_M_left;
+      } else if (__k == __left) {
+        return iterator(__x);
+      } else {
+        __k -= __left + 1;
+        __x = __x->_M_right;
+      }
+    }
+  }
+
+  /**
+   * @brief the number of values whose keys are less than __k.
+   * @attention ranked trees only, O(log n).
+   */
+  size_type
+  rank(const key_type& __k) const
+  {
+    static_assert(_Ranked, "rank() needs a ranked tree");
+    size_type __n = 0;
+    _Const_Base_ptr __x = _M_header ? _M_root() : nullptr;
+    while (__x != nullptr) {
+      if (!key_comp()(_S_key(__x), __k)) {
+        __x = __x->_M_left;
+      } else {
+        __n += _S_size(__x->_M_left) + 1;
+        __x = __x->_M_right;
+      }
+    }
+    return __n;
+  }
+
+  /**
+   * @brief the fold of the values whose keys are in [__lo, __hi), a
+   *  value-initialized one when there are none. The range is half-open
+   *  as for for_each_in_range.
+   * @attention augmented trees only, O(log n).
+   */
+  auto
+  _M_fold(const key_type& __lo, const key_type& __hi) const
+  {
+    static_assert(_Augmented, "fold() needs an augmented tree");
+    typedef typename _Augment::value_type _Aug;
+    _Augment __f;
+    // the top node in the range, its subtrees hold the two ends.
+    _Const_Base_ptr __s = _M_header ? _M_root() : nullptr;
+    while (__s != nullptr) {
+      if (key_comp()(_S_key(__s), __lo))
+        __s = __s->_M_right;
+      else if (!key_comp()(_S_key(__s), __hi))
+        __s = __s->_M_left;
+      else
+        break;
+    }
+    if (__s == nullptr)
+      return _Aug();
+    _Aug __acc = __f(*static_cast<_Const_Link_type>(__s)->_M_valptr());
+    for (_Const_Base_ptr __x = __s->_M_left; __x != nullptr; ) {
+      if (key_comp()(_S_key(__x), __lo)) {
+        __x = __x->_M_right;
+      } else {
+        if (__x->_M_right != nullptr)
+          __acc = __f(_S_aug(__x->_M_right), __acc);
+        __acc = __f(__f(*static_cast<_Const_Link_type>(__x)->_M_valptr()), __acc);
+        __x = __x->_M_left;
+      }
+    }
+    for (_Const_Base_ptr __x = __s->_M_right; __x != nullptr; ) {
+      if (!key_comp()(_S_key(__x), __hi)) {
+        __x = __x->_M_left;
+      } else {
+        if (__x->_M_left != nullptr)
+          __acc = __f(__acc, _S_aug(__x->_M_left));
+        __acc = __f(__acc, __f(*static_cast<_Const_Link_type>(__x)->_M_valptr()));
+        __x = __x->_M_right;
+      }
+    }
+    return __acc;
+  }
+
+  // the fold of every value, O(1).
+  auto
+  _M_fold() const
+  {
+    static_assert(_Augmented, "fold() needs an augmented tree");
+    typedef typename _Augment::value_type _Aug;
+    if (_M_header == nullptr || _M_root() == nullptr)
+      return _Aug();
+    return _S_aug(_M_root());
+  }
+
+  // the value of __x was changed in place, fix the folds up to the root.
+  void _M_refresh(_Base_ptr __x) noexcept
+  {
+    if constexpr (_Augmented)
+      _M_update_to_root(__x);
+  }
+
+  // the lookups below take any key the comparator accepts, the
+  // containers only pass other types when it is transparent.
+  template <class _Kt>
   iterator
-  find(const key_type& __k) 
+  find(const _Kt& __k) 
   {
     iterator j = lower_bound(__k);
     return (j == end() || key_comp()(__k, _S_key(j._M_node))) ? end() : j;
   }
 
+  template <class _Kt>
   const_iterator
-  find(const key_type& __k) const 
+  find(const _Kt& __k) const 
   {
     const_iterator j = lower_bound(__k);
     return (j == end() || key_comp()(__k, _S_key(j.base()._M_node))) ? end() : j;
   }
 
+  template <class _Kt>
   size_type
-  count_unique(const key_type& __k) const 
+  count_unique(const _Kt& __k) const 
   {
     if (_M_header == nullptr) {
       return 0;
@@ -1462,8 +2896,9 @@ template<class, class, class, class, class> friend class _Rb_tree;
     return 0;
   }
 
+  template <class _Kt>
   size_type
-  count_multi(const key_type& __k) const 
+  count_multi(const _Kt& __k) const 
   {
     if (_M_header == nullptr) {
       return 0;
@@ -1486,8 +2921,9 @@ template<class, class, class, class, class> friend class _Rb_tree;
     return 0;
   }
 
+  template <class _Kt>
   iterator
-  lower_bound(const key_type& __k) 
+  lower_bound(const _Kt& __k) 
   {
     if (_M_header == nullptr) {
       return end();
@@ -1497,8 +2933,9 @@ template<class, class, class, class, class> friend class _Rb_tree;
     return __lower_bound(__k, x, y);
   }
 
+  template <class _Kt>
   iterator
-  __lower_bound(const key_type& __k, _Base_ptr x, _Base_ptr y) 
+  __lower_bound(const _Kt& __k, _Base_ptr x, _Base_ptr y) 
   {
     while (x != nullptr) {
       if (!key_comp()(_S_key(x), __k)) {
@@ -1511,8 +2948,9 @@ template<class, class, class, class, class> friend class _Rb_tree;
     return iterator(y);
   }
 
+  template <class _Kt>
   const_iterator
-  lower_bound(const key_type& __k) const 
+  lower_bound(const _Kt& __k) const 
   {
     if (_M_header == nullptr) {
       return end();
@@ -1522,8 +2960,9 @@ template<class, class, class, class, class> friend class _Rb_tree;
     return __lower_bound(__k, x, y);
   }
 
+  template <class _Kt>
   const_iterator
-  __lower_bound(const key_type& __k, _Const_Base_ptr x, _Const_Base_ptr y) const 
+  __lower_bound(const _Kt& __k, _Const_Base_ptr x, _Const_Base_ptr y) const 
   {
     while (x != nullptr) {
       if (!key_comp()(_S_key(x), __k)) {
@@ -1536,8 +2975,9 @@ template<class, class, class, class, class> friend class _Rb_tree;
     return const_iterator((_Base_ptr)y);
   }
 
+  template <class _Kt>
   iterator
-  upper_bound(const key_type& __k) 
+  upper_bound(const _Kt& __k) 
   {
     if (_M_header == nullptr) {
       return end();
@@ -1547,8 +2987,9 @@ template<class, class, class, class, class> friend class _Rb_tree;
     return __upper_bound(__k, x, y);
   }
 
+  template <class _Kt>
   iterator
-  __upper_bound(const key_type& __k, _Base_ptr x, _Base_ptr y) 
+  __upper_bound(const _Kt& __k, _Base_ptr x, _Base_ptr y) 
   {
     while (x != nullptr) {
       if (key_comp()(__k, _S_key(x))) {
@@ -1561,8 +3002,9 @@ template<class, class, class, class, class> friend class _Rb_tree;
     return iterator(y);
   }
 
+  template <class _Kt>
   const_iterator
-  upper_bound(const key_type& __k) const 
+  upper_bound(const _Kt& __k) const 
   {
     if (_M_header == nullptr) {
       return end();
@@ -1572,8 +3014,9 @@ template<class, class, class, class, class> friend class _Rb_tree;
     return __upper_bound(__k, x, y);
   }
 
+  template <class _Kt>
   const_iterator
-  __upper_bound(const key_type& __k, _Const_Base_ptr x, _Const_Base_ptr y) const 
+  __upper_bound(const _Kt& __k, _Const_Base_ptr x, _Const_Base_ptr y) const 
   {
     while (x != nullptr) {
       if (key_comp()(__k, _S_key(x))) {
@@ -1586,22 +3029,119 @@ template<class, class, class, class, class> friend class _Rb_tree;
     return const_iterator((_Base_ptr)y);
   }
 
+  template <class _Kt>
   tinySTL::pair<iterator, iterator>
-  equal_range(const key_type& __k) 
+  equal_range(const _Kt& __k) 
   { return {lower_bound(__k), upper_bound(__k)}; }
 
+  template <class _Kt>
   tinySTL::pair<const_iterator, const_iterator>
-  equal_range(const key_type& __k) const
+  equal_range(const _Kt& __k) const
   { return {lower_bound(__k), upper_bound(__k)}; }
 
-  void _M_erase(_Link_type __x)
+  /**
+   * @brief  call __f on every element with a key in [__lo, __hi), in key
+   *  order, like a loop from lower_bound(__lo) to lower_bound(__hi). The
+   *  range is half-open as for _M_fold.
+   *  The walk keeps the ancestors still to visit on its own stack and
+   *  prefetches the right child of each one as it is pushed, so that
+   *  node is usually in cache when the walk gets to it. Stepping with
+   *  _Rb_tree_increment cannot start a load that early.
+   * @attention  __f must not insert or erase.
+   */
+  template <class _Kt1, class _Kt2, class _Function>
+  void for_each_in_range(const _Kt1& __lo, const _Kt2& __hi, _Function& __f)
+  { _M_scan_range(__lo, __hi, [&__f](_Const_Base_ptr __x) { __f(*_Link_type(const_cast<_Base_ptr>(__x))->_M_valptr()); }); }
+
+  template <class _Kt1, class _Kt2, class _Function>
+  void for_each_in_range(const _Kt1& __lo, const _Kt2& __hi, _Function& __f) const
+  { _M_scan_range(__lo, __hi, [&__f](_Const_Base_ptr __x) { __f(_S_value(__x)); }); }
+
+  template <class _Kt1, class _Kt2, class _Visit>
+  void _M_scan_range(const _Kt1& __lo, const _Kt2& __hi, _Visit __visit) const
+  {
+    if (_M_header == nullptr)
+      return;
+    // the height is below 2 log2(n + 1), well under 128 for any n.
+    _Const_Base_ptr __stack[128];
+    int __top = 0;
+    for (_Const_Base_ptr __x = _M_root(); __x != nullptr; ) {
+      if (!key_comp()(_S_key(__x), __lo)) {
+        tinySTL::__tiny_prefetch(__x->_M_right);
+        __stack[__top++] = __x;
+        __x = __x->_M_left;
+      } else {
+        __x = __x->_M_right;
+      }
+    }
+    while (__top != 0) {
+      _Const_Base_ptr __x = __stack[--__top];
+      if (!key_comp()(_S_key(__x), __hi))
+        return;
+      __visit(__x);
+      for (__x = __x->_M_right; __x != nullptr; __x = __x->_M_left) {
+        tinySTL::__tiny_prefetch(__x->_M_right);
+        __stack[__top++] = __x;
+      }
+    }
+  }
+
+  // check the red-black invariants, for tests.
+ public:
+  bool _M_verify() const
+  {
+    if (_M_header == nullptr || _M_root() == nullptr)
+      return _M_node_count == 0;
+    size_type __count = 0;
+    return _S_color(_M_root()) == _Rb_tree_color::_S_black
+        && _M_black_height(_M_root(), __count) >= 0
+        && __count == _M_node_count
+        && _M_leftmost() == _S_minimum(_M_root())
+        && _M_rightmost() == _S_maximum(_M_root());
+  }
+
+ protected:
+  static _Rb_tree_color _S_color(_Const_Base_ptr __x) noexcept
+  { return __x == nullptr ? _Rb_tree_color::_S_black : __x->_M_get_color(); }
+
+  // black height of __x, -1 when a rule is broken below it.
+  int _M_black_height(_Const_Base_ptr __x, size_type& __count) const
   {
+    if (__x == nullptr)
+      return 0;
+    ++__count;
+    _Const_Base_ptr __l = __x->_M_left, __r = __x->_M_right;
+    if ((__l && (__l->_M_parent != __x || key_comp()(_S_key(__x), _S_key(__l))))
+     || (__r && (__r->_M_parent != __x || key_comp()(_S_key(__r), _S_key(__x)))))
+      return -1;
+    if (__x->_M_isRed()
+     && (_S_color(__l) == _Rb_tree_color::_S_red || _S_color(__r) == _Rb_tree_color::_S_red))
+      return -1;
+    if (_Ranked && _S_size(__x) != 1 + _S_size(__l) + _S_size(__r))
+      return -1;
+    if constexpr (_Augmented) {
+      if (!(_S_aug(__x) == _S_fold_subtree(__x)))
+        return -1;
+    }
+    int __lh = _M_black_height(__l, __count);
+    int __rh = _M_black_height(__r, __count);
+    if (__lh < 0 || __lh != __rh)
+      return -1;
+    return __lh + (__x->_M_isBlk());
+  }
+
+  // free the subtree __x, returns the number of nodes freed.
+  size_type _M_erase(_Link_type __x)
+  {
+    size_type __n = 0;
     while (__x != 0) {
-      _M_erase(_S_right(__x));
+      __n += _M_erase(_S_right(__x));
       _Link_type __y = _S_left(__x);
       _M_drop_node(__x);
       __x = __y;
+      ++__n;
     }
+    return __n;
   }
 
 };
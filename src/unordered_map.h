@@ -6,13 +6,13 @@
 namespace tinySTL
 {
 
-template<class, class, class, class, class> class unordered_multimap;
+template<class, class, class, class, class, class> class unordered_multimap;
 
-template<class _Key, class _Val, class _Hash = tinySTL::hash<_Key>, class _Pred = tinySTL::equal_to<_Key>, class _Alloc = tinySTL::allocator<tinySTL::pair<_Key, _Val>>>
+template<class _Key, class _Val, class _Hash = tinySTL::hash<_Key>, class _Pred = tinySTL::equal_to<_Key>, class _Alloc = tinySTL::allocator<tinySTL::pair<_Key, _Val>>, class _Buckets = prime_buckets>
 class unordered_map {
 
-template<class, class, class, class, class> friend class unordered_map;
-template<class, class, class, class, class> friend class unordered_multimap;
+template<class, class, class, class, class, class> friend class unordered_map;
+template<class, class, class, class, class, class> friend class unordered_multimap;
 
 public:
   typedef _Key    key_type;
@@ -21,7 +21,7 @@ public:
   typedef _Alloc  allocator_type;
 
 protected:
-  typedef tinySTL::hashtable<key_type, value_type, _Hash, _Select1st<value_type>, _Pred, _Alloc> _Ht;
+  typedef tinySTL::hashtable<key_type, value_type, _Hash, _Select1st<value_type>, _Pred, _Alloc, _Buckets> _Ht;
   _Ht _M_ht;
 
 public:
@@ -34,6 +34,8 @@ public:
   typedef typename _Ht::const_iterator const_iterator;
   typedef typename _Ht::size_type size_type;
   typedef typename _Ht::difference_type difference_type;
+  typedef _Map_node_handle<key_type, _Val, typename _Ht::_Node, typename _Ht::_Node_allocator> node_type;
+  typedef _Node_insert_return<iterator, node_type> insert_return_type;
 
 public:
   unordered_map() 
@@ -88,6 +90,25 @@ public:
   
   void clear() { _M_ht.clear(); }
 
+  // lay the nodes out in bucket order; see hashtable::compact.
+  void compact() { _M_ht.compact(); }
+
+  // call __f on every element, in iteration order but with the node
+  // loads overlapped; see hashtable::for_each.
+  template <class _Function>
+  _Function for_each(_Function __f)
+  {
+    _M_ht.for_each(__f);
+    return __f;
+  }
+
+  template <class _Function>
+  _Function for_each(_Function __f) const
+  {
+    _M_ht.for_each(__f);
+    return __f;
+  }
+
   bool contains(const key_type& __x) const 
   { return find(__x) != end(); }
 
@@ -113,6 +134,25 @@ public:
   equal_range(const key_type& __x) const 
   { return _M_ht.equal_range(__x); }
 
+  /**
+   * @brief  unlink the element at __position and hand its node out.
+   */
+  node_type extract(const_iterator __position)
+  { return _M_ht.template _M_extract<node_type>(__position.constCast()); }
+
+  // an empty handle if __k is absent.
+  node_type extract(const key_type& __k)
+  { return _M_ht.template _M_extract_key<node_type>(__k); }
+
+  insert_return_type insert(node_type&& __nh)
+  {
+    tinySTL::pair<iterator, bool> __r = _M_ht._M_reinsert_node_unique(__nh);
+    return {__r.first, __r.second, tinySTL::move(__nh)};
+  }
+
+  iterator insert(const_iterator, node_type&& __nh)
+  { return _M_ht._M_reinsert_node_unique(__nh).first; }
+
   size_type erase(const key_type& __k) 
   { return _M_ht.erase(__k); }
 
@@ -174,19 +214,19 @@ public:
   size_type max_size() const { return _M_ht.max_size(); }
 
   template <class _Pred2>
-  void merge(unordered_map<_Key, _Val, _Hash, _Pred2, _Alloc>& __source) 
+  void merge(unordered_map<_Key, _Val, _Hash, _Pred2, _Alloc, _Buckets>& __source) 
   { return merge(tinySTL::move(__source)); }
 
   template <class _Pred2>
-  void merge(unordered_map<_Key, _Val, _Hash, _Pred2, _Alloc>&& __source) 
+  void merge(unordered_map<_Key, _Val, _Hash, _Pred2, _Alloc, _Buckets>&& __source) 
   { _M_ht._M_merge_unique(tinySTL::move(__source._M_ht)); }
 
   template <class _Pred2>
-  void merge(unordered_multimap<_Key, _Val, _Hash, _Pred2, _Alloc>& __source) 
+  void merge(unordered_multimap<_Key, _Val, _Hash, _Pred2, _Alloc, _Buckets>& __source) 
   { return merge(tinySTL::move(__source)); }
 
   template <class _Pred2>
-  void merge(unordered_multimap<_Key, _Val, _Hash, _Pred2, _Alloc>&& __source)
+  void merge(unordered_multimap<_Key, _Val, _Hash, _Pred2, _Alloc, _Buckets>&& __source)
   { _M_ht._M_merge_unique(tinySTL::move(__source._M_ht)); }
 
   void rehash(size_t __n) { _M_ht._M_rehash(__n); }
@@ -243,11 +283,11 @@ public:
   }
 };
 
-template<class _Key, class _Val, class _Hash = tinySTL::hash<_Key>, class _Pred = tinySTL::equal_to<_Key>, class _Alloc = tinySTL::allocator<tinySTL::pair<_Key, _Val>>>
+template<class _Key, class _Val, class _Hash = tinySTL::hash<_Key>, class _Pred = tinySTL::equal_to<_Key>, class _Alloc = tinySTL::allocator<tinySTL::pair<_Key, _Val>>, class _Buckets = prime_buckets>
 class unordered_multimap {
 
-template<class, class, class, class, class> friend class unordered_map;
-template<class, class, class, class, class> friend class unordered_multimap;
+template<class, class, class, class, class, class> friend class unordered_map;
+template<class, class, class, class, class, class> friend class unordered_multimap;
 
 public:
   typedef _Key    key_type;
@@ -256,7 +296,7 @@ public:
   typedef _Alloc  allocator_type;
 
 protected:
-  typedef tinySTL::hashtable<key_type, value_type, _Hash, _Select1st<value_type>, _Pred, _Alloc> _Ht;
+  typedef tinySTL::hashtable<key_type, value_type, _Hash, _Select1st<value_type>, _Pred, _Alloc, _Buckets> _Ht;
   _Ht _M_ht;
 
 public:
@@ -269,6 +309,7 @@ public:
   typedef typename _Ht::const_iterator const_iterator;
   typedef typename _Ht::size_type size_type;
   typedef typename _Ht::difference_type difference_type;
+  typedef _Map_node_handle<key_type, _Val, typename _Ht::_Node, typename _Ht::_Node_allocator> node_type;
 
 public:
   unordered_multimap() 
@@ -323,6 +364,25 @@ public:
   
   void clear() { _M_ht.clear(); }
 
+  // lay the nodes out in bucket order; see hashtable::compact.
+  void compact() { _M_ht.compact(); }
+
+  // call __f on every element, in iteration order but with the node
+  // loads overlapped; see hashtable::for_each.
+  template <class _Function>
+  _Function for_each(_Function __f)
+  {
+    _M_ht.for_each(__f);
+    return __f;
+  }
+
+  template <class _Function>
+  _Function for_each(_Function __f) const
+  {
+    _M_ht.for_each(__f);
+    return __f;
+  }
+
   bool contains(const key_type& __x) const 
   { return find(__x) != end(); }
 
@@ -348,6 +408,22 @@ public:
   equal_range(const key_type& __x) const 
   { return _M_ht.equal_range(__x); }
 
+  /**
+   * @brief  unlink the element at __position and hand its node out.
+   */
+  node_type extract(const_iterator __position)
+  { return _M_ht.template _M_extract<node_type>(__position.constCast()); }
+
+  // an empty handle if __k is absent; with several, the first one.
+  node_type extract(const key_type& __k)
+  { return _M_ht.template _M_extract_key<node_type>(__k); }
+
+  iterator insert(node_type&& __nh)
+  { return _M_ht._M_reinsert_node_equal(__nh); }
+
+  iterator insert(const_iterator, node_type&& __nh)
+  { return _M_ht._M_reinsert_node_equal(__nh); }
+
   size_type erase(const key_type& __k) 
   { return _M_ht.erase(__k); }
 
@@ -408,19 +484,19 @@ public:
 
 
   template <class _Pred2>
-  void merge(unordered_map<_Key, _Val, _Hash, _Pred2, _Alloc>& __source) 
+  void merge(unordered_map<_Key, _Val, _Hash, _Pred2, _Alloc, _Buckets>& __source) 
   { return merge(tinySTL::move(__source)); }
 
   template <class _Pred2>
-  void merge(unordered_map<_Key, _Val, _Hash, _Pred2, _Alloc>&& __source) 
+  void merge(unordered_map<_Key, _Val, _Hash, _Pred2, _Alloc, _Buckets>&& __source) 
   { _M_ht._M_merge_equal(tinySTL::move(__source._M_ht)); }
 
   template <class _Pred2>
-  void merge(unordered_multimap<_Key, _Val, _Hash, _Pred2, _Alloc>& __source) 
+  void merge(unordered_multimap<_Key, _Val, _Hash, _Pred2, _Alloc, _Buckets>& __source) 
   { return merge(tinySTL::move(__source)); }
 
   template <class _Pred2>
-  void merge(unordered_multimap<_Key, _Val, _Hash, _Pred2, _Alloc>&& __source)
+  void merge(unordered_multimap<_Key, _Val, _Hash, _Pred2, _Alloc, _Buckets>&& __source)
   { _M_ht._M_merge_equal(tinySTL::move(__source._M_ht)); }
 
   void rehash(size_t __n) { _M_ht._M_rehash(__n); }
@@ -6,16 +6,16 @@
 namespace tinySTL
 {
 
-template<class, class, class, class> class unordered_multiset;
+template<class, class, class, class, class> class unordered_multiset;
 
-template<class _Key, class _Hash = tinySTL::hash<_Key>, class _Pred = tinySTL::equal_to<_Key>, class _Alloc = tinySTL::allocator<_Key>>
+template<class _Key, class _Hash = tinySTL::hash<_Key>, class _Pred = tinySTL::equal_to<_Key>, class _Alloc = tinySTL::allocator<_Key>, class _Buckets = prime_buckets>
 class unordered_set {
 
-template<class, class, class, class> friend class unordered_set;
-template<class, class, class, class> friend class unordered_multiset;
+template<class, class, class, class, class> friend class unordered_set;
+template<class, class, class, class, class> friend class unordered_multiset;
 
  protected:
-  typedef tinySTL::hashtable<_Key, _Key, _Hash, _Identity<_Key>, _Pred, _Alloc>
+  typedef tinySTL::hashtable<_Key, _Key, _Hash, _Identity<_Key>, _Pred, _Alloc, _Buckets>
           _Ht;
 
   _Ht _M_ht;
@@ -34,6 +34,8 @@ template<class, class, class, class> friend class unordered_multiset;
 
   typedef typename _Ht::const_iterator iterator;
   typedef typename _Ht::const_iterator const_iterator;
+  typedef _Set_node_handle<value_type, typename _Ht::_Node, typename _Ht::_Node_allocator> node_type;
+  typedef _Node_insert_return<iterator, node_type> insert_return_type;
 
   typedef typename _Ht::allocator_type allocator_type;
 
@@ -90,6 +92,18 @@ template<class, class, class, class> friend class unordered_multiset;
   
   void clear() { _M_ht.clear(); }
 
+  // lay the nodes out in bucket order; see hashtable::compact.
+  void compact() { _M_ht.compact(); }
+
+  // call __f on every element, in iteration order but with the node
+  // loads overlapped; see hashtable::for_each.
+  template <class _Function>
+  _Function for_each(_Function __f) const
+  {
+    _M_ht.for_each(__f);
+    return __f;
+  }
+
   bool contains(const key_type& __x) const 
   { return find(__x) != end(); }
 
@@ -115,6 +129,25 @@ template<class, class, class, class> friend class unordered_multiset;
   equal_range(const key_type& __x) const 
   { return _M_ht.equal_range(__x); }
 
+  /**
+   * @brief  unlink the element at __position and hand its node out.
+   */
+  node_type extract(const_iterator __position)
+  { return _M_ht.template _M_extract<node_type>(__position.constCast()); }
+
+  // an empty handle if __k is absent.
+  node_type extract(const key_type& __k)
+  { return _M_ht.template _M_extract_key<node_type>(__k); }
+
+  insert_return_type insert(node_type&& __nh)
+  {
+    tinySTL::pair<iterator, bool> __r = _M_ht._M_reinsert_node_unique(__nh);
+    return {__r.first, __r.second, tinySTL::move(__nh)};
+  }
+
+  iterator insert(const_iterator, node_type&& __nh)
+  { return _M_ht._M_reinsert_node_unique(__nh).first; }
+
   size_type erase(const key_type& __k) 
   { return _M_ht.erase(__k); }
 
@@ -176,19 +209,19 @@ template<class, class, class, class> friend class unordered_multiset;
   size_type max_size() const { return _M_ht.max_size(); }
 
   template <class _Pred2>
-  void merge(unordered_set<_Key, _Hash, _Pred2, _Alloc>& __source) 
+  void merge(unordered_set<_Key, _Hash, _Pred2, _Alloc, _Buckets>& __source) 
   { return merge(tinySTL::move(__source)); }
 
   template <class _Pred2>
-  void merge(unordered_set<_Key, _Hash, _Pred2, _Alloc>&& __source) 
+  void merge(unordered_set<_Key, _Hash, _Pred2, _Alloc, _Buckets>&& __source) 
   { _M_ht._M_merge_unique(tinySTL::move(__source._M_ht)); }
 
   template <class _Pred2>
-  void merge(unordered_multiset<_Key, _Hash, _Pred2, _Alloc>& __source) 
+  void merge(unordered_multiset<_Key, _Hash, _Pred2, _Alloc, _Buckets>& __source) 
   { return merge(tinySTL::move(__source)); }
 
   template <class _Pred2>
-  void merge(unordered_multiset<_Key, _Hash, _Pred2, _Alloc>&& __source)
+  void merge(unordered_multiset<_Key, _Hash, _Pred2, _Alloc, _Buckets>&& __source)
   { _M_ht._M_merge_unique(tinySTL::move(__source._M_ht)); }
 
   void rehash(size_t __n) { _M_ht._M_rehash(__n); }
@@ -212,14 +245,14 @@ template<class, class, class, class> friend class unordered_multiset;
 };
 
 
-template<class _Key, class _Hash = tinySTL::hash<_Key>, class _Pred = tinySTL::equal_to<_Key>, class _Alloc = tinySTL::allocator<_Key>>
+template<class _Key, class _Hash = tinySTL::hash<_Key>, class _Pred = tinySTL::equal_to<_Key>, class _Alloc = tinySTL::allocator<_Key>, class _Buckets = prime_buckets>
 class unordered_multiset {
 
-template<class, class, class, class> friend class unordered_set;
-template<class, class, class, class> friend class unordered_multiset;
+template<class, class, class, class, class> friend class unordered_set;
+template<class, class, class, class, class> friend class unordered_multiset;
 
  protected:
-  typedef tinySTL::hashtable<_Key, _Key, _Hash, _Identity<_Key>, _Pred, _Alloc>
+  typedef tinySTL::hashtable<_Key, _Key, _Hash, _Identity<_Key>, _Pred, _Alloc, _Buckets>
           _Ht;
 
   _Ht _M_ht;
@@ -238,6 +271,7 @@ template<class, class, class, class> friend class unordered_multiset;
 
   typedef typename _Ht::const_iterator iterator;
   typedef typename _Ht::const_iterator const_iterator;
+  typedef _Set_node_handle<value_type, typename _Ht::_Node, typename _Ht::_Node_allocator> node_type;
 
   typedef typename _Ht::allocator_type allocator_type;
 
@@ -294,6 +328,18 @@ template<class, class, class, class> friend class unordered_multiset;
   
   void clear() { _M_ht.clear(); }
 
+  // lay the nodes out in bucket order; see hashtable::compact.
+  void compact() { _M_ht.compact(); }
+
+  // call __f on every element, in iteration order but with the node
+  // loads overlapped; see hashtable::for_each.
+  template <class _Function>
+  _Function for_each(_Function __f) const
+  {
+    _M_ht.for_each(__f);
+    return __f;
+  }
+
   bool contains(const key_type& __x) const 
   { return find(__x) != end(); }
 
@@ -319,6 +365,22 @@ template<class, class, class, class> friend class unordered_multiset;
   equal_range(const key_type& __x) const 
   { return _M_ht.equal_range(__x); }
 
+  /**
+   * @brief  unlink the element at __position and hand its node out.
+   */
+  node_type extract(const_iterator __position)
+  { return _M_ht.template _M_extract<node_type>(__position.constCast()); }
+
+  // an empty handle if __k is absent; with several, the first one.
+  node_type extract(const key_type& __k)
+  { return _M_ht.template _M_extract_key<node_type>(__k); }
+
+  iterator insert(node_type&& __nh)
+  { return _M_ht._M_reinsert_node_equal(__nh); }
+
+  iterator insert(const_iterator, node_type&& __nh)
+  { return _M_ht._M_reinsert_node_equal(__nh); }
+
   size_type erase(const key_type& __k) 
   { return _M_ht.erase(__k); }
 
@@ -379,19 +441,19 @@ template<class, class, class, class> friend class unordered_multiset;
 
 
   template <class _Pred2>
-  void merge(unordered_set<_Key, _Hash, _Pred2, _Alloc>& __source) 
+  void merge(unordered_set<_Key, _Hash, _Pred2, _Alloc, _Buckets>& __source) 
   { return merge(tinySTL::move(__source)); }
 
   template <class _Pred2>
-  void merge(unordered_set<_Key, _Hash, _Pred2, _Alloc>&& __source) 
+  void merge(unordered_set<_Key, _Hash, _Pred2, _Alloc, _Buckets>&& __source) 
   { _M_ht._M_merge_equal(tinySTL::move(__source._M_ht)); }
 
   template <class _Pred2>
-  void merge(unordered_multiset<_Key, _Hash, _Pred2, _Alloc>& __source) 
+  void merge(unordered_multiset<_Key, _Hash, _Pred2, _Alloc, _Buckets>& __source) 
   { return merge(tinySTL::move(__source)); }
 
   template <class _Pred2>
-  void merge(unordered_multiset<_Key, _Hash, _Pred2, _Alloc>&& __source)
+  void merge(unordered_multiset<_Key, _Hash, _Pred2, _Alloc, _Buckets>&& __source)
   { _M_ht._M_merge_equal(tinySTL::move(__source._M_ht)); }
 
   void rehash(size_t __n) { _M_ht._M_rehash(__n); }
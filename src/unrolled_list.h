@@ -0,0 +1,703 @@
+// tinySTL: unrolled_list.
+#pragma once
+
+#include "tiny_alloc.h"
+#include "tiny_errors.h"
+#include "tiny_iterator.h"
+#include "tiny_algobase.h"
+#include "tiny_construct.h"
+#include "tiny_uninitialized.h"
+
+namespace tinySTL
+{
+
+// bytes of elements held by one node: small enough that shifting a node
+// on a middle insert stays cheap, large enough to amortize the links and
+// the cache miss of reaching the node. See bench/unrolled_list.cpp.
+constexpr size_t _S_unrolled_node_bytes = 512;
+
+constexpr inline size_t
+__unrolled_node_capacity(size_t __size)
+{
+  return __size < _S_unrolled_node_bytes / 8
+       ? _S_unrolled_node_bytes / __size : 8;
+}
+
+struct _Unrolled_node_base {
+  _Unrolled_node_base* _M_prev;
+  _Unrolled_node_base* _M_next;
+  size_t _M_count = 0;
+
+  // link this node before @p __pos .
+  void _M_hook(_Unrolled_node_base* __pos) noexcept
+  {
+    _M_next = __pos;
+    _M_prev = __pos->_M_prev;
+    __pos->_M_prev->_M_next = this;
+    __pos->_M_prev = this;
+  }
+
+  void _M_unhook() noexcept
+  {
+    _M_prev->_M_next = _M_next;
+    _M_next->_M_prev = _M_prev;
+  }
+};
+
+// the sentinel node, it never holds elements so its _M_count stays 0.
+struct _Unrolled_node_header : public _Unrolled_node_base
+{
+  size_t _M_size = 0;
+
+  _Unrolled_node_header()
+    { _M_prev = _M_next = this; }
+
+ ~_Unrolled_node_header()
+    {
+      _M_prev = _M_next = this;
+      _M_size = 0;
+    }
+
+  _Unrolled_node_header(const _Unrolled_node_header&) = delete;
+
+  _Unrolled_node_header& operator=(const _Unrolled_node_header&) = delete;
+
+  _Unrolled_node_header(_Unrolled_node_header&& __x)
+    {
+      if (__x._M_next == &__x) {
+        _M_prev = _M_next = this;
+        _M_size = 0;
+        return;
+      }
+      _M_size = __x._M_size;
+      _M_prev = __x._M_prev;
+      _M_next = __x._M_next;
+      __x._M_prev->_M_next = this;
+      __x._M_next->_M_prev = this;
+      __x._M_prev = __x._M_next = &__x;
+      __x._M_size = 0;
+    }
+
+  _Unrolled_node_header& operator=(_Unrolled_node_header&& __x)
+    {
+      if (this != &__x) {
+        this->~_Unrolled_node_header();
+        tinySTL::construct(this, tinySTL::move(__x));
+      }
+      return *this;
+    }
+};
+
+template <class _Tp, size_t _Cap>
+struct _Unrolled_node : public _Unrolled_node_base
+{
+  alignas(_Tp) unsigned char _M_data[sizeof(_Tp) * _Cap];
+
+  _Tp* _M_elems() noexcept { return (_Tp*)_M_data; }
+};
+
+/**
+ * @brief  a doubly linked list of nodes, each node holds up to
+ *  _S_capacity elements contiguously. A scan touches one node per
+ *  _S_capacity elements instead of one per element, and an insert or
+ *  erase in the middle shifts at most one node.
+ *
+ *  A full node splits in halves on insert, a node that drops under a
+ *  quarter full on erase merges with a neighbour when the result fits
+ *  in three quarters of a node, and an empty node is freed.
+ *
+ * @attention insert and erase invalidate every iterator into the nodes
+ *  they touch, which may include the neighbours of the position.
+ */
+template <class _Tp, class _Alloc = tinySTL::allocator<_Tp>>
+class unrolled_list
+{
+ protected:
+  static constexpr size_t _S_capacity = __unrolled_node_capacity(sizeof(_Tp));
+
+  typedef _Unrolled_node<_Tp, _S_capacity> _Node;
+
+  // elements of @p __n , null for the header so end() has a unique position.
+  static _Tp* _S_elems(_Unrolled_node_base* __n) noexcept
+    { return __n->_M_count ? ((_Node*)__n)->_M_elems() : nullptr; }
+
+  class _Unrolled_list_iterator
+  {
+    template <class, class> friend class unrolled_list;
+   public:
+    using iterator_category = tinySTL::bidirectional_iterator_tag;
+    using value_type = _Tp;
+    using difference_type = ptrdiff_t;
+    using pointer = _Tp*;
+    using reference = _Tp&;
+
+   protected:
+    _Unrolled_node_base* _M_node;
+    pointer              _M_cur;
+
+    constexpr _Unrolled_list_iterator(const _Unrolled_node_base* __node, pointer __cur)
+      : _M_node((_Unrolled_node_base*)__node), _M_cur(__cur) {}
+
+    // one node, the segment of the iterator.
+    struct _Node_segment {
+      _Unrolled_node_base* _M_node;
+
+      _Node_segment& operator++() { _M_node = _M_node->_M_next; return *this; }
+      friend bool operator==(const _Node_segment& __x, const _Node_segment& __y) { return __x._M_node == __y._M_node; }
+      friend bool operator!=(const _Node_segment& __x, const _Node_segment& __y) { return __x._M_node != __y._M_node; }
+    };
+
+   public:
+    // segmented iterator protocol, see __segmented_iterator_traits.
+    struct _Segmented_traits {
+      typedef _Node_segment __segment_iterator;
+      typedef pointer       __local_iterator;
+
+      static __segment_iterator __segment(const _Unrolled_list_iterator& __it)
+        { return _Node_segment{__it._M_node}; }
+
+      static __local_iterator __local(const _Unrolled_list_iterator& __it)
+        { return __it._M_cur; }
+
+      static __local_iterator __begin(const __segment_iterator& __s)
+        { return _S_elems(__s._M_node); }
+
+      static __local_iterator __end(const __segment_iterator& __s)
+        { return _S_elems(__s._M_node) + __s._M_node->_M_count; }
+
+      static _Unrolled_list_iterator
+      __compose(const __segment_iterator& __s, __local_iterator __l)
+        {
+          if (__s._M_node->_M_count != 0 && __l == __end(__s))
+            return _Unrolled_list_iterator(__s._M_node->_M_next, _S_elems(__s._M_node->_M_next));
+          return _Unrolled_list_iterator(__s._M_node, __l);
+        }
+    };
+
+    constexpr _Unrolled_list_iterator() : _M_node(0), _M_cur(0) {}
+
+    constexpr reference operator*() const { return *_M_cur; }
+
+    constexpr pointer operator->() const { return _M_cur; }
+
+    constexpr _Unrolled_list_iterator& operator++()
+      {
+        if (++_M_cur == ((_Node*)_M_node)->_M_elems() + _M_node->_M_count) {
+          _M_node = _M_node->_M_next;
+          _M_cur = _S_elems(_M_node);
+        }
+        return *this;
+      }
+
+    constexpr _Unrolled_list_iterator operator++(int)
+      {
+        _Unrolled_list_iterator __tmp = *this;
+        ++(*this);
+        return __tmp;
+      }
+
+    constexpr _Unrolled_list_iterator& operator--()
+      {
+        if (_M_cur == _S_elems(_M_node)) {
+          _M_node = _M_node->_M_prev;
+          _M_cur = _S_elems(_M_node) + _M_node->_M_count;
+        }
+        --_M_cur;
+        return *this;
+      }
+
+    constexpr _Unrolled_list_iterator operator--(int)
+      {
+        _Unrolled_list_iterator __tmp = *this;
+        --(*this);
+        return __tmp;
+      }
+
+    friend constexpr bool operator==(
+      const _Unrolled_list_iterator& __x,
+      const _Unrolled_list_iterator& __y)
+      {
+        return __x._M_cur == __y._M_cur;
+      }
+  };
+
+ public:
+  typedef _Tp value_type;
+  typedef value_type* pointer;
+  typedef const value_type* const_pointer;
+  typedef _Unrolled_list_iterator iterator;
+  typedef tinySTL::const_iterator<iterator> const_iterator;
+  typedef value_type& reference;
+  typedef const value_type& const_reference;
+  typedef size_t size_type;
+  typedef ptrdiff_t difference_type;
+  typedef _Alloc allocator_type;
+  typedef tinySTL::reverse_iterator<const_iterator> const_reverse_iterator;
+  typedef tinySTL::reverse_iterator<iterator> reverse_iterator;
+
+ protected:
+  typedef typename _Alloc_rebind<_Alloc, _Node>::type _Node_alloc_type;
+
+  struct _Unrolled_list_impl
+  : public _Node_alloc_type
+  {
+    _Unrolled_list_impl(const _Node_alloc_type& __a)
+    : _Node_alloc_type(__a), _M_header()
+      { }
+
+    _Unrolled_list_impl(_Unrolled_list_impl&& __x) = default;
+
+    _Unrolled_node_header _M_header;
+  };
+
+  _Unrolled_list_impl _M_impl;
+
+  _Node* _M_create_node()
+    {
+      _Node* __p = _M_impl.allocate(1);
+      tinySTL::construct(__p);
+      return __p;
+    }
+
+  void _M_destroy_node(_Unrolled_node_base* __p)
+    {
+      tinySTL::destroy((_Node*)__p);
+      _M_impl.deallocate((_Node*)__p, 1);
+    }
+
+  void _M_range_check(size_type __n) const {
+    if (__n >= this->size())
+      __tiny_throw_range_error("unrolled_list");
+  }
+
+ public:
+  explicit unrolled_list(const allocator_type& __a = allocator_type())
+    : _M_impl(_Node_alloc_type(__a)) { }
+
+  explicit unrolled_list(size_type __n, const allocator_type& __a = allocator_type())
+    : unrolled_list(__n, _Tp(), __a) { }
+
+  unrolled_list(size_type __n, const _Tp& __value,
+                const allocator_type& __a = allocator_type())
+    : _M_impl(_Node_alloc_type(__a))
+    {
+      for (; __n > 0; --__n)
+        emplace_back(__value);
+    }
+
+  unrolled_list(const unrolled_list& __x)
+    : _M_impl(_Node_alloc_type(__x._M_impl))
+    { _M_iter_construct(__x.begin(), __x.end()); }
+
+  unrolled_list(unrolled_list&& __x) = default;
+
+  unrolled_list(std::initializer_list<_Tp> __l,
+                const allocator_type& __a = allocator_type())
+    : _M_impl(_Node_alloc_type(__a))
+    { _M_iter_construct(__l.begin(), __l.end()); }
+
+  template <InputIterator Iterator>
+  unrolled_list(Iterator __first, Iterator __last,
+                const allocator_type& __a = allocator_type())
+    : _M_impl(_Node_alloc_type(__a))
+    { _M_iter_construct(__first, __last); }
+
+  ~unrolled_list() { clear(); }
+
+  unrolled_list& operator=(std::initializer_list<_Tp> __l)
+  {
+    assign(__l);
+    return *this;
+  }
+
+  unrolled_list& operator=(const unrolled_list& __x)
+  {
+    if (this != &__x)
+      assign(__x.begin(), __x.end());
+    return *this;
+  }
+
+  unrolled_list& operator=(unrolled_list&& __x)
+  {
+    if (this != &__x)
+    {
+      this->~unrolled_list();
+      tinySTL::construct(this, tinySTL::move(__x));
+    }
+    return *this;
+  }
+
+  void assign(std::initializer_list<_Tp> __l)
+    { assign(__l.begin(), __l.end()); }
+
+  void assign(size_type __n, const _Tp& __val)
+  {
+    iterator __i = begin();
+    for ( ; __i != end() && __n > 0; ++__i, --__n)
+      *__i = __val;
+    if (__n > 0)
+      insert(end(), __n, __val);
+    else
+      erase(__i, end());
+  }
+
+  template <InputIterator Iterator>
+  void assign(Iterator __first, Iterator __last)
+  {
+    iterator __first1 = begin();
+    iterator __last1 = end();
+    for ( ; __first1 != __last1 && __first != __last; ++__first1, ++__first)
+      *__first1 = *__first;
+    if (__first == __last)
+      erase(__first1, __last1);
+    else
+      insert(__last1, __first, __last);
+  }
+
+  allocator_type get_allocator() const
+  { return allocator_type(_M_impl); }
+
+  iterator begin()
+    { return iterator(_M_impl._M_header._M_next, _S_elems(_M_impl._M_header._M_next)); }
+
+  const_iterator begin() const
+    { return const_cast<unrolled_list*>(this)->begin(); }
+
+  const_iterator cbegin() const
+    { return begin(); }
+
+  iterator end()
+    { return iterator(&_M_impl._M_header, nullptr); }
+
+  const_iterator end() const
+    { return const_cast<unrolled_list*>(this)->end(); }
+
+  const_iterator cend() const
+    { return end(); }
+
+  reverse_iterator rbegin()
+    { return reverse_iterator(end()); }
+
+  const_reverse_iterator rbegin() const
+    { return const_reverse_iterator(end()); }
+
+  const_reverse_iterator crbegin() const
+    { return const_reverse_iterator(end()); }
+
+  reverse_iterator rend()
+    { return reverse_iterator(begin()); }
+
+  const_reverse_iterator rend() const
+    { return const_reverse_iterator(begin()); }
+
+  const_reverse_iterator crend() const
+    { return const_reverse_iterator(begin()); }
+
+  bool empty() const { return _M_impl._M_header._M_size == 0; }
+
+  size_type size() const { return _M_impl._M_header._M_size; }
+
+  size_type max_size() const { return size_type(-1); }
+
+  /**
+   * @brief elements held by one node.
+   */
+  static constexpr size_type node_capacity() { return _S_capacity; }
+
+  reference front()
+    { _M_range_check(0); return *begin(); }
+
+  const_reference front() const
+    { _M_range_check(0); return *begin(); }
+
+  reference back()
+    { _M_range_check(0); return *(--end()); }
+
+  const_reference back() const
+    { _M_range_check(0); return *(--end()); }
+
+  template <class... _Args>
+  iterator emplace(const_iterator __pos, _Args&&... __args)
+  {
+    iterator __position = __pos.base();
+    return _M_emplace(__position._M_node,
+                      __position._M_cur - _S_elems(__position._M_node),
+                      tinySTL::forward<_Args>(__args)...);
+  }
+
+  iterator insert(const_iterator __pos, const _Tp& __val)
+    { return emplace(__pos, __val); }
+
+  iterator insert(const_iterator __pos, _Tp&& __val)
+    { return emplace(__pos, tinySTL::move(__val)); }
+
+  iterator insert(const_iterator __pos, size_type __n, const _Tp& __val)
+  {
+    if (__n == 0) return __pos.base();
+    _Tp __copy(__val);
+    iterator __it = emplace(__pos, __copy);
+    for (size_type __i = 1; __i < __n; ++__i)
+      __it = emplace(++__it, __copy);
+    return _M_walk_back(__it, __n - 1);
+  }
+
+  template <InputIterator Iterator>
+  iterator insert(const_iterator __pos, Iterator __first, Iterator __last)
+  {
+    if (__first == __last) return __pos.base();
+    iterator __it = emplace(__pos, *__first);
+    size_type __n = 0;
+    for (++__first; __first != __last; ++__first, ++__n)
+      __it = emplace(++__it, *__first);
+    return _M_walk_back(__it, __n);
+  }
+
+  iterator insert(const_iterator __pos, std::initializer_list<_Tp> __l)
+    { return insert(__pos, __l.begin(), __l.end()); }
+
+  template <class... _Args>
+  reference emplace_back(_Args&&... __args)
+  {
+    _Unrolled_node_base* __last = _M_impl._M_header._M_prev;
+    if (__last != &_M_impl._M_header && __last->_M_count < _S_capacity) {
+      _Tp* __p = ((_Node*)__last)->_M_elems() + __last->_M_count;
+      tinySTL::construct(__p, tinySTL::forward<_Args>(__args)...);
+      ++__last->_M_count;
+      ++_M_impl._M_header._M_size;
+      return *__p;
+    }
+    return *_M_emplace(&_M_impl._M_header, 0, tinySTL::forward<_Args>(__args)...);
+  }
+
+  template <class... _Args>
+  reference emplace_front(_Args&&... __args)
+    { return *emplace(begin(), tinySTL::forward<_Args>(__args)...); }
+
+  void push_back(const _Tp& __val) { emplace_back(__val); }
+
+  void push_back(_Tp&& __val) { emplace_back(tinySTL::move(__val)); }
+
+  void push_front(const _Tp& __val) { emplace_front(__val); }
+
+  void push_front(_Tp&& __val) { emplace_front(tinySTL::move(__val)); }
+
+  void pop_back()
+  {
+    if (empty()) return;
+    _Unrolled_node_base* __last = _M_impl._M_header._M_prev;
+    tinySTL::destroy(((_Node*)__last)->_M_elems() + --__last->_M_count);
+    --_M_impl._M_header._M_size;
+    if (__last->_M_count == 0) {
+      __last->_M_unhook();
+      _M_destroy_node(__last);
+    }
+  }
+
+  void pop_front()
+  {
+    if (!empty())
+      erase(begin());
+  }
+
+  iterator erase(const_iterator __pos)
+  {
+    iterator __position = __pos.base();
+    return _M_erase(__position._M_node,
+                    __position._M_cur - ((_Node*)__position._M_node)->_M_elems());
+  }
+
+  iterator erase(const_iterator __first, const_iterator __last)
+  {
+    // merges on the way move the elements of __last, count them instead.
+    size_type __n = tinySTL::distance(__first, __last);
+    iterator __it = __first.base();
+    for (; __n > 0; --__n)
+      __it = erase(__it);
+    return __it;
+  }
+
+  void clear()
+  {
+    _Unrolled_node_base* __head = &_M_impl._M_header;
+    _Unrolled_node_base* __cur = __head->_M_next;
+    while (__cur != __head) {
+      _Unrolled_node_base* __next = __cur->_M_next;
+      _Tp* __elems = ((_Node*)__cur)->_M_elems();
+      tinySTL::destroy(__elems, __elems + __cur->_M_count);
+      _M_destroy_node(__cur);
+      __cur = __next;
+    }
+    __head->_M_prev = __head->_M_next = __head;
+    _M_impl._M_header._M_size = 0;
+  }
+
+  void resize(size_type __n) { resize(__n, _Tp()); }
+
+  void resize(size_type __n, const _Tp& __val)
+  {
+    while (size() > __n)
+      pop_back();
+    while (size() < __n)
+      emplace_back(__val);
+  }
+
+  void swap(unrolled_list& __x)
+    { tinySTL::swap(_M_impl._M_header, __x._M_impl._M_header); }
+
+ protected:
+  // a split by a later insert may move the first inserted element,
+  // walk back from the last inserted element to find it.
+  iterator _M_walk_back(iterator __last, size_type __n)
+  {
+    for (; __n > 0; --__n)
+      --__last;
+    return __last;
+  }
+
+  template <InputIterator Iterator>
+  void _M_iter_construct(Iterator __first, Iterator __last)
+  {
+    for (; __first != __last; ++__first)
+      emplace_back(*__first);
+  }
+
+  // move the upper half of the full node @p __node into a new node after it.
+  _Unrolled_node_base* _M_split(_Unrolled_node_base* __node)
+  {
+    _Node* __right = _M_create_node();
+    __right->_M_hook(__node->_M_next);
+    const size_type __half = _S_capacity / 2;
+    _Tp* __elems = ((_Node*)__node)->_M_elems();
+    try {
+      tinySTL::uninitialized_move(__elems + __half, __elems + _S_capacity,
+                                  __right->_M_elems());
+    } catch (...) {
+      __right->_M_unhook();
+      _M_destroy_node(__right);
+      throw;
+    }
+    tinySTL::destroy(__elems + __half, __elems + _S_capacity);
+    __right->_M_count = _S_capacity - __half;
+    __node->_M_count = __half;
+    return __right;
+  }
+
+  // append the elements of the node after @p __node to @p __node .
+  void _M_merge_next(_Unrolled_node_base* __node)
+  {
+    _Unrolled_node_base* __next = __node->_M_next;
+    _Tp* __src = ((_Node*)__next)->_M_elems();
+    tinySTL::uninitialized_move(__src, __src + __next->_M_count,
+                                ((_Node*)__node)->_M_elems() + __node->_M_count);
+    tinySTL::destroy(__src, __src + __next->_M_count);
+    __node->_M_count += __next->_M_count;
+    __next->_M_unhook();
+    _M_destroy_node(__next);
+  }
+
+  template <class... _Args>
+  iterator _M_emplace(_Unrolled_node_base* __node, size_type __idx, _Args&&... __args)
+  {
+    _Unrolled_node_base* __head = &_M_impl._M_header;
+    _Unrolled_node_base* __prev = __node->_M_prev;
+    if (__idx == 0 && __prev != __head && __prev->_M_count < _S_capacity) {
+      // before the first element of a node, append to the previous one.
+      __node = __prev;
+      __idx = __prev->_M_count;
+    } else if (__node == __head) {
+      __node = _M_create_node();
+      __node->_M_hook(__head);
+    }
+
+    _Tp* __elems = ((_Node*)__node)->_M_elems();
+    if (__idx == __node->_M_count && __idx < _S_capacity) {
+      try {
+        tinySTL::construct(__elems + __idx, tinySTL::forward<_Args>(__args)...);
+      } catch (...) {
+        if (__node->_M_count == 0) {
+          __node->_M_unhook();
+          _M_destroy_node(__node);
+        }
+        throw;
+      }
+    } else {
+      // the arguments may refer to an element that the split or the
+      // shift below moves, build the value first.
+      _Tp __tmp(tinySTL::forward<_Args>(__args)...);
+      if (__node->_M_count == _S_capacity) {
+        _Unrolled_node_base* __right = _M_split(__node);
+        if (__idx > __node->_M_count) {
+          __idx -= __node->_M_count;
+          __node = __right;
+          __elems = ((_Node*)__node)->_M_elems();
+        }
+      }
+      size_type __count = __node->_M_count;
+      if (__idx == __count)
+        tinySTL::construct(__elems + __count, tinySTL::move(__tmp));
+      else {
+        tinySTL::construct(__elems + __count, tinySTL::move(__elems[__count - 1]));
+        tinySTL::move_backward(__elems + __idx, __elems + __count - 1,
+                               __elems + __count);
+        __elems[__idx] = tinySTL::move(__tmp);
+      }
+    }
+    ++__node->_M_count;
+    ++_M_impl._M_header._M_size;
+    return iterator(__node, __elems + __idx);
+  }
+
+  iterator _M_erase(_Unrolled_node_base* __node, size_type __idx)
+  {
+    _Unrolled_node_base* __head = &_M_impl._M_header;
+    _Tp* __elems = ((_Node*)__node)->_M_elems();
+    tinySTL::move(__elems + __idx + 1, __elems + __node->_M_count, __elems + __idx);
+    tinySTL::destroy(__elems + --__node->_M_count);
+    --_M_impl._M_header._M_size;
+
+    if (__node->_M_count == 0) {
+      _Unrolled_node_base* __next = __node->_M_next;
+      __node->_M_unhook();
+      _M_destroy_node(__node);
+      return iterator(__next, _S_elems(__next));
+    }
+
+    if (__node->_M_count < _S_capacity / 4) {
+      _Unrolled_node_base* __next = __node->_M_next;
+      _Unrolled_node_base* __prev = __node->_M_prev;
+      if (__next != __head
+       && __node->_M_count + __next->_M_count <= _S_capacity * 3 / 4)
+        _M_merge_next(__node);
+      else if (__prev != __head
+       && __prev->_M_count + __node->_M_count <= _S_capacity * 3 / 4) {
+        __idx += __prev->_M_count;
+        _M_merge_next(__prev);
+        __node = __prev;
+      }
+    }
+
+    if (__idx == __node->_M_count)
+      return iterator(__node->_M_next, _S_elems(__node->_M_next));
+    return iterator(__node, ((_Node*)__node)->_M_elems() + __idx);
+  }
+};
+
+template <class _Tp, class _Alloc> inline bool
+operator==(const unrolled_list<_Tp, _Alloc>& __x, const unrolled_list<_Tp, _Alloc>& __y)
+  { return __x.size() == __y.size()
+    && equal(__x.begin(), __x.end(), __y.begin());
+  }
+
+template <class _Tp, class _Alloc> inline bool
+operator!=(const unrolled_list<_Tp, _Alloc>& __x, const unrolled_list<_Tp, _Alloc>& __y)
+  { return !(__x == __y); }
+
+template <class _Tp, class _Alloc> inline bool
+operator<(const unrolled_list<_Tp, _Alloc>& __x, const unrolled_list<_Tp, _Alloc>& __y)
+  { return lexicographical_compare(__x.begin(), __x.end(), __y.begin(), __y.end()); }
+
+template <class _Tp, class _Alloc> inline void
+swap(unrolled_list<_Tp, _Alloc>& __x, unrolled_list<_Tp, _Alloc>& __y)
+  { __x.swap(__y); }
+
+}
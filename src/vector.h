@@ -256,13 +256,13 @@ class vector : protected _Vector_base<_Tp, _Alloc> {
   
   const_iterator begin() const { return iterator(_M_impl._M_start); }
 
-  const_iterator cbegin() const { return _M_impl._M_start; }
+  const_iterator cbegin() const { return iterator(_M_impl._M_start); }
   
   iterator end() { return _M_impl._M_finish; }
   
   const_iterator end() const { return iterator(_M_impl._M_finish); }
 
-  const_iterator cend() const { return _M_impl._M_finish; }
+  const_iterator cend() const { return iterator(_M_impl._M_finish); }
 
   reverse_iterator rbegin() 
     { return reverse_iterator(end()); }
@@ -481,17 +481,17 @@ class vector : protected _Vector_base<_Tp, _Alloc> {
   {
     size_type __n = __pos - begin();
     if (_M_impl._M_finish != _M_impl._M_end_of_storage && __pos == end()) {
-      tinySTL::construct(_M_impl._M_finish, forward<_Args>(__args)...);
+      tinySTL::construct(_M_impl._M_finish, tinySTL::forward<_Args>(__args)...);
       ++_M_impl._M_finish;
     }
     else
-      _M_emplace_aux(__pos, forward<_Args>(__args)...);
+      _M_emplace_aux(__pos, tinySTL::forward<_Args>(__args)...);
     return begin() + __n;
   }
 
   template <typename... _Args>
   reference emplace_back(_Args&& ...__args)
-    { return *emplace(end(), forward<_Args>(__args)...); }
+    { return *emplace(end(), tinySTL::forward<_Args>(__args)...); }
 
  protected:
   void _M_range_check(size_type __n) const {
@@ -363,3 +363,66 @@ TEST(algorithm, set_symmetric_difference) {
   EXPECT_STRING_EQ(result, [0, 2, 5]);
   EXPECT_EQ(it - result.begin(), 3);
 }
+
+TEST(algorithm, segmented) {
+  /**
+   * @test  copy / move between deque and vector
+   * @brief ranges span several deque blocks and start mid-block.
+   */
+  SUBTEST(copy) {
+    deque<int> dq;
+    for (int i = 0; i < 1000; i++) dq.push_back(i);
+    vector<int> vc(990);
+    auto it = tinySTL::copy(dq.cbegin() + 5, dq.cend() - 5, vc.begin());
+    EXPECT_EQ(it, vc.end());
+    for (int i = 0; i < 990; i++) EXPECT_EQ(vc[i], i + 5);
+
+    deque<int> dq2(1000, -1);
+    auto it2 = tinySTL::copy(vc.begin(), vc.end(), dq2.begin() + 3);
+    EXPECT_EQ(it2 - dq2.begin(), 993);
+    for (int i = 0; i < 3; i++) EXPECT_EQ(dq2[i], -1);
+    for (int i = 3; i < 993; i++) EXPECT_EQ(dq2[i], i + 2);
+    for (int i = 993; i < 1000; i++) EXPECT_EQ(dq2[i], -1);
+
+    deque<int> dq3(1000, 0);
+    auto it3 = tinySTL::move(dq.begin(), dq.end(), dq3.begin());
+    EXPECT_EQ(it3, dq3.end());
+    EXPECT_TRUE(tinySTL::equal(dq.begin(), dq.end(), dq3.begin()));
+  }
+
+  /**
+   * @test  copy ending on a block boundary
+   * @brief the returned iterator refers to the first slot of the next block.
+   */
+  SUBTEST(copy) {
+    deque<int> dq(300, 0);
+    size_t __n = dq.begin()._S_buffer_size();
+    vector<int> vc(__n, 7);
+    auto it = tinySTL::copy(vc.begin(), vc.end(), dq.begin());
+    EXPECT_EQ(it, dq.begin() + __n);
+    *it = 8;
+    EXPECT_EQ(dq[__n], 8);
+    EXPECT_EQ(dq[__n - 1], 7);
+  }
+
+  /**
+   * @test  fill / for_each / find / count on deque
+   */
+  SUBTEST(fill) {
+    deque<char> dc(2000, 'a');
+    tinySTL::fill(dc.begin() + 100, dc.end() - 100, 'b');
+    EXPECT_EQ(tinySTL::count(dc.begin(), dc.end(), 'b'), 1800);
+    EXPECT_EQ(tinySTL::count(dc.cbegin(), dc.cend(), 'a'), 200);
+    EXPECT_EQ(tinySTL::find(dc.begin(), dc.end(), 'b') - dc.begin(), 100);
+    EXPECT_EQ(tinySTL::find(dc.begin() + 100, dc.end(), 'a') - dc.begin(), 1900);
+    EXPECT_EQ(tinySTL::find(dc.begin(), dc.end(), 'c'), dc.end());
+
+    deque<int> dq;
+    for (int i = 0; i < 1000; i++) dq.push_front(i);
+    long long sum = 0;
+    tinySTL::for_each(dq.cbegin(), dq.cend(), [&sum](const int& x) { sum += x; });
+    EXPECT_EQ(sum, 999 * 1000 / 2);
+    EXPECT_EQ(*tinySTL::find(dq.cbegin(), dq.cend(), 500), 500);
+    EXPECT_EQ(tinySTL::find(dq.cbegin() + 2, dq.cbegin() + 2, 997), dq.cbegin() + 2);
+  }
+}
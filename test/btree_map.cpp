@@ -0,0 +1,142 @@
+#include <map>
+#include <string>
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+#include "btree_map.h"
+#include "algorithm.h"
+#include "test_util.h"
+
+using namespace tinySTL;
+
+TEST(btree_map, constructor) {
+  /**
+   * @test  btree_map() / btree_map(std::initializer_list) / copy / move
+   */
+  SUBTEST(constructor) {
+    btree_map<int, std::string> m;
+    EXPECT_STRING_EQ(m, []);
+    btree_map<int, std::string> m1 {{2, "world"}, {1, "hello"}};
+    EXPECT_STRING_EQ(m1, [{1, hello}, {2, world}]);
+    btree_map<int, std::string> m2(m1);
+    EXPECT_STRING_EQ(m2, [{1, hello}, {2, world}]);
+    btree_map<int, std::string> m3(tinySTL::move(m1));
+    EXPECT_STRING_EQ(m1, []);
+    EXPECT_STRING_EQ(m3, [{1, hello}, {2, world}]);
+    EXPECT_TRUE(m2 == m3);
+  }
+}
+
+TEST(btree_map, element_access) {
+  /**
+   * @test  operator[] / at
+   */
+  SUBTEST(element_access) {
+    btree_map<std::string, int> m;
+    m["b"] = 2;
+    m["a"] = 1;
+    ++m["b"];
+    EXPECT_STRING_EQ(m, [{a, 1}, {b, 3}]);
+    EXPECT_EQ(m.at("a"), 1);
+    const btree_map<std::string, int>& cm = m;
+    EXPECT_EQ(cm.at("b"), 3);
+    EXPECT_THROW(cm.at("c"), std::range_error);
+  }
+
+  /**
+   * @test  iterator writes through to the value
+   */
+  SUBTEST(element_access) {
+    btree_map<int, int> m {{5, 5}, {4, 4}, {0, 0}};
+    m.begin()->second = 111;
+    (--m.end())->second = 55;
+    EXPECT_STRING_EQ(m, [{0, 111}, {4, 4}, {5, 55}]);
+  }
+}
+
+TEST(btree_map, modifiers) {
+  /**
+   * @test  insert / erase with string values
+   * @brief random operations checked against std::map, values move
+   *  between nodes on every split and merge.
+   */
+  SUBTEST(modifiers) {
+    checked<btree_map<int, std::string>> m;
+    std::map<int, std::string> model;
+    unsigned seed = 3;
+    for (int i = 0; i < 30000; ++i) {
+      int k = next_rand(seed) % 3000;
+      if (next_rand(seed) % 3 != 0) {
+        std::string v = std::to_string(i);
+        auto r = m.insert({k, v});
+        EXPECT_EQ(r.second, model.insert({k, v}).second);
+        EXPECT_EQ(r.first->first, k);
+      } else {
+        EXPECT_EQ(m.erase(k), model.erase(k));
+      }
+      if (i % 5000 == 0) {
+        ASSERT_TRUE(m.verify());
+      }
+    }
+    ASSERT_TRUE(m.verify());
+    ASSERT_EQ(m.size(), model.size());
+    auto mit = model.begin();
+    for (auto& x : m) {
+      EXPECT_EQ(x.first, mit->first);
+      EXPECT_EQ(x.second, mit->second);
+      ++mit;
+    }
+  }
+
+  /**
+   * @test  emplace / emplace_hint / merge
+   */
+  SUBTEST(modifiers) {
+    btree_map<int, std::string> m1;
+    EXPECT_TRUE(m1.emplace(1, "one").second);
+    EXPECT_FALSE(m1.emplace(1, "uno").second);
+    m1.emplace_hint(m1.end(), 3, "three");
+    btree_map<int, std::string> m2 {{2, "two"}, {3, "drei"}};
+    m1.merge(m2);
+    EXPECT_STRING_EQ(m1, [{1, one}, {2, two}, {3, three}]);
+    EXPECT_STRING_EQ(m2, [{3, drei}]);
+  }
+}
+
+TEST(btree_multimap, modifiers) {
+  /**
+   * @test  insert with equal keys
+   * @brief equal keys keep their insertion order across node splits.
+   */
+  SUBTEST(modifiers) {
+    checked<btree_multimap<int, int>> m;
+    for (int i = 0; i < 3000; ++i)
+      m.insert({i % 7, i});
+    ASSERT_TRUE(m.verify());
+    EXPECT_EQ(m.count(3), 429);
+    int pre = -1;
+    auto r = m.equal_range(3);
+    for (auto it = r.first; it != r.second; ++it) {
+      EXPECT_EQ(it->first, 3);
+      EXPECT_LT(pre, it->second);
+      pre = it->second;
+    }
+    EXPECT_EQ(m.erase(3), 429);
+    EXPECT_EQ(m.size(), 3000 - 429);
+    EXPECT_TRUE(m.find(3) == m.end());
+    EXPECT_TRUE(m.verify());
+  }
+
+  /**
+   * @test  insert(hint, x)
+   * @brief a hint at the right place inserts there, a wrong one is ignored.
+   */
+  SUBTEST(modifiers) {
+    btree_multimap<int, int> m {{1, 1}, {3, 3}};
+    auto it = m.insert(m.find(3), {3, 0});
+    EXPECT_EQ(it->second, 0);
+    m.insert(m.begin(), {5, 5});
+    EXPECT_STRING_EQ(m, [{1, 1}, {3, 0}, {3, 3}, {5, 5}]);
+  }
+}
@@ -0,0 +1,244 @@
+#include <set>
+#include <string>
+#include <vector>
+#include <stdexcept>
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+#include "btree_set.h"
+#include "algorithm.h"
+#include "test_util.h"
+
+using namespace tinySTL;
+
+namespace {
+
+// a fragile whose copies may throw but whose moves never do, the values
+// of a btree shift between slots by moves.
+struct sturdy : fragile {
+  sturdy(int x) : fragile(x) { }
+  sturdy(const sturdy&) = default;
+  sturdy(sturdy&& x) noexcept : fragile(x.v) { }
+  sturdy& operator=(const sturdy&) = default;
+};
+
+}
+
+TEST(btree_set, constructor) {
+  /**
+   * @test  btree_set() / btree_set(std::initializer_list)
+   */
+  SUBTEST(constructor) {
+    btree_set<int> s;
+    EXPECT_STRING_EQ(s, []);
+    EXPECT_TRUE(s.empty());
+    btree_set<int> s2{3, 1, 2, 3};
+    EXPECT_STRING_EQ(s2, [1, 2, 3]);
+  }
+
+  /**
+   * @test  copy / move
+   * @brief more values than one node holds.
+   */
+  SUBTEST(constructor) {
+    std::vector<int> v;
+    for (int i = 0; i < 1000; ++i) v.push_back(999 - i);
+    checked<btree_set<int>> s1(v.begin(), v.end());
+    EXPECT_EQ(s1.size(), 1000);
+    EXPECT_TRUE(s1.verify());
+    checked<btree_set<int>> s2(s1);
+    EXPECT_TRUE(s2.verify());
+    EXPECT_TRUE(s1 == s2);
+    checked<btree_set<int>> s3(tinySTL::move(s1));
+    EXPECT_TRUE(s1.empty());
+    EXPECT_TRUE(s3 == s2);
+    s1 = s3;
+    EXPECT_TRUE(s1 == s3);
+    s1 = {1, 2};
+    EXPECT_STRING_EQ(s1, [1, 2]);
+    EXPECT_TRUE(s3 < s1);
+  }
+}
+
+TEST(btree_set, modifiers) {
+  /**
+   * @test  insert / erase
+   * @brief random operations checked against std::set, including the
+   *  iterator erase returns.
+   */
+  SUBTEST(modifiers) {
+    checked<btree_set<int>> s;
+    std::set<int> model;
+    unsigned seed = 7;
+    for (int i = 0; i < 20000; ++i) {
+      int k = next_rand(seed) % 5000;
+      auto r = s.insert(k);
+      EXPECT_EQ(r.second, model.insert(k).second);
+      EXPECT_EQ(*r.first, k);
+    }
+    ASSERT_TRUE(s.verify());
+    ASSERT_EQ(s.size(), model.size());
+    EXPECT_TRUE(tinySTL::equal(s.begin(), s.end(), model.begin()));
+
+    for (int i = 0; i < 20000; ++i) {
+      int k = next_rand(seed) % 5000;
+      auto it = s.find(k);
+      auto mit = model.find(k);
+      ASSERT_EQ(it == s.end(), mit == model.end());
+      if (mit != model.end()) {
+        it = s.erase(it);
+        mit = model.erase(mit);
+        if (mit == model.end())
+          EXPECT_TRUE(it == s.end());
+        else
+          EXPECT_EQ(*it, *mit);
+      }
+      if (i % 1000 == 0) {
+        ASSERT_TRUE(s.verify());
+      }
+    }
+    ASSERT_TRUE(s.verify());
+    EXPECT_TRUE(tinySTL::equal(s.begin(), s.end(), model.begin()));
+  }
+
+  /**
+   * @test  erase(key) / erase(first, last) / clear
+   */
+  SUBTEST(modifiers) {
+    checked<btree_set<int>> s;
+    for (int i = 0; i < 500; ++i) s.insert(i);
+    EXPECT_EQ(s.erase(250), 1);
+    EXPECT_EQ(s.erase(250), 0);
+    auto it = s.erase(s.find(10), s.find(490));
+    EXPECT_EQ(*it, 490);
+    EXPECT_TRUE(s.verify());
+    EXPECT_STRING_EQ(s, [0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 490, 491, 492, 493, 494, 495, 496, 497, 498, 499]);
+    while (!s.empty())
+      s.erase(s.begin());
+    EXPECT_TRUE(s.verify());
+    s.insert(1);
+    s.clear();
+    EXPECT_STRING_EQ(s, []);
+  }
+
+  /**
+   * @test  insert(hint, x) / emplace
+   * @brief sorted input fills nodes completely.
+   */
+  SUBTEST(modifiers) {
+    checked<btree_set<std::string>> s;
+    auto it = s.end();
+    for (int i = 0; i < 1000; ++i)
+      it = s.insert(s.end(), std::to_string(100000 + i));
+    EXPECT_EQ(*it, "100999");
+    EXPECT_EQ(s.size(), 1000);
+    EXPECT_FALSE(s.emplace("100500").second);
+    EXPECT_TRUE(s.emplace(3, 'x').second);
+    EXPECT_EQ(*--s.end(), "xxx");
+    EXPECT_TRUE(s.verify());
+  }
+
+  /**
+   * @test  merge
+   */
+  SUBTEST(modifiers) {
+    btree_set<int> s1{1, 3, 5};
+    btree_set<int> s2{2, 3, 4};
+    s1.merge(s2);
+    EXPECT_STRING_EQ(s1, [1, 2, 3, 4, 5]);
+    EXPECT_STRING_EQ(s2, [3]);
+  }
+
+  /**
+   * @test  insert / btree_set(const btree_set&) when copying a value throws
+   * @brief the set is left as it was and no value leaks.
+   */
+  SUBTEST(modifiers) {
+    {
+      checked<btree_set<sturdy>> s;
+      for (int i = 0; i < 2000; ++i) s.insert(sturdy(i * 2));
+      EXPECT_EQ(fragile::alive, 2000);
+      sturdy x(101);
+      for (int budget : {0, 1, 500, 1999}) {
+        fragile::budget = 0;
+        EXPECT_THROW(s.insert(x), std::runtime_error);
+        EXPECT_EQ(s.size(), 2000);
+        EXPECT_TRUE(s.verify());
+        fragile::budget = budget;
+        EXPECT_THROW(btree_set<sturdy> c(s), std::runtime_error);
+        EXPECT_EQ(fragile::alive, 2001);
+      }
+      fragile::budget = -1;
+      EXPECT_TRUE(s.insert(x).second);
+      EXPECT_TRUE(s.verify());
+      EXPECT_EQ(fragile::alive, 2002);
+    }
+    EXPECT_EQ(fragile::alive, 0);
+  }
+}
+
+TEST(btree_set, lookup) {
+  /**
+   * @test  lower_bound / upper_bound / equal_range / count / contains
+   */
+  SUBTEST(lookup) {
+    btree_set<int> s;
+    for (int i = 0; i < 2000; i += 2) s.insert(i);
+    EXPECT_EQ(*s.lower_bound(101), 102);
+    EXPECT_EQ(*s.lower_bound(102), 102);
+    EXPECT_EQ(*s.upper_bound(102), 104);
+    EXPECT_TRUE(s.lower_bound(1999) == s.end());
+    EXPECT_EQ(s.count(100), 1);
+    EXPECT_EQ(s.count(101), 0);
+    EXPECT_TRUE(s.contains(1998));
+    EXPECT_FALSE(s.contains(2000));
+    auto r = s.equal_range(500);
+    EXPECT_EQ(tinySTL::distance(r.first, r.second), 1);
+  }
+
+  /**
+   * @test  reverse iteration
+   */
+  SUBTEST(lookup) {
+    btree_set<int> s;
+    for (int i = 0; i < 3000; ++i) s.insert((i * 7919) % 3000);
+    int expect = 2999;
+    for (auto it = s.rbegin(); it != s.rend(); ++it)
+      EXPECT_EQ(*it, expect--);
+    EXPECT_EQ(expect, -1);
+  }
+}
+
+TEST(btree_multiset, modifiers) {
+  /**
+   * @test  insert / erase / count with equal keys
+   */
+  SUBTEST(modifiers) {
+    checked<btree_multiset<int>> s;
+    std::multiset<int> model;
+    unsigned seed = 99;
+    for (int i = 0; i < 10000; ++i) {
+      int k = next_rand(seed) % 100;
+      s.insert(k);
+      model.insert(k);
+    }
+    ASSERT_TRUE(s.verify());
+    EXPECT_TRUE(tinySTL::equal(s.begin(), s.end(), model.begin()));
+    for (int k = 0; k < 100; ++k)
+      EXPECT_EQ(s.count(k), model.count(k));
+    EXPECT_EQ(s.erase(42), model.erase(42));
+    EXPECT_EQ(s.count(42), 0);
+    ASSERT_TRUE(s.verify());
+    EXPECT_EQ(s.size(), model.size());
+    EXPECT_TRUE(tinySTL::equal(s.begin(), s.end(), model.begin()));
+  }
+
+  SUBTEST(modifiers) {
+    btree_multiset<int> s{1, 2, 2, 3};
+    btree_set<int> s2{2, 4};
+    s.merge(s2);
+    EXPECT_STRING_EQ(s, [1, 2, 2, 2, 3, 4]);
+    EXPECT_STRING_EQ(s2, []);
+  }
+}
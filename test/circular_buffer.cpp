@@ -0,0 +1,172 @@
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+#include "circular_buffer.h"
+#include "algorithm.h"
+#include "vector.h"
+
+using namespace tinySTL;
+
+TEST(circular_buffer, constructor) {
+  /**
+   * @test  circular_buffer()
+   * @brief default constructor, no storage.
+   */
+  SUBTEST(constructor) {
+    circular_buffer<int> cb;
+    EXPECT_EQ(cb.size(), 0);
+    EXPECT_EQ(cb.capacity(), 0);
+    EXPECT_TRUE(cb.empty());
+    EXPECT_TRUE(cb.full());
+  }
+
+  /**
+   * @test  explicit circular_buffer(size_type capacity)
+   * @brief capacity is rounded up to a power of two.
+   */
+  SUBTEST(constructor) {
+    circular_buffer<int> cb(5);
+    EXPECT_EQ(cb.size(), 0);
+    EXPECT_EQ(cb.capacity(), 8);
+    EXPECT_EQ(cb.reserve(), 8);
+  }
+
+  /**
+   * @test  circular_buffer(size_type capacity, Iterator first, Iterator last)
+   * @brief only the newest elements are kept.
+   */
+  SUBTEST(constructor) {
+    vector<int> vc {1, 2, 3, 4, 5, 6};
+    circular_buffer<int> cb(4, vc.begin(), vc.end());
+    EXPECT_STRING_EQ(cb, [3, 4, 5, 6]);
+  }
+
+  /**
+   * @test  circular_buffer(const circular_buffer&), circular_buffer(circular_buffer&&)
+   */
+  SUBTEST(constructor) {
+    circular_buffer<int> cb1 = {1, 2, 3, 4};
+    cb1.push_back(5);
+    circular_buffer<int> cb2(cb1);
+    EXPECT_STRING_EQ(cb2, [2, 3, 4, 5]);
+    EXPECT_TRUE(cb1 == cb2);
+    circular_buffer<int> cb3(tinySTL::move(cb1));
+    EXPECT_STRING_EQ(cb3, [2, 3, 4, 5]);
+    EXPECT_EQ(cb1.capacity(), 0);
+  }
+}
+
+TEST(circular_buffer, push_back) {
+  /**
+   * @test  void push_back(const T& x)
+   * @brief overwrite the oldest element when full.
+   */
+  SUBTEST(push_back) {
+    circular_buffer<int> cb(4);
+    for (int i = 0; i < 10; i++)
+      cb.push_back(i);
+    EXPECT_STRING_EQ(cb, [6, 7, 8, 9]);
+    EXPECT_EQ(cb.front(), 6);
+    EXPECT_EQ(cb.back(), 9);
+    EXPECT_EQ(cb[1], 7);
+  }
+
+  /**
+   * @test  bool try_push_back(const T& x)
+   * @brief reject the new element when full.
+   */
+  SUBTEST(try_push_back) {
+    circular_buffer<std::string> cb(2);
+    EXPECT_TRUE(cb.try_push_back("a"));
+    EXPECT_TRUE(cb.try_push_back("b"));
+    EXPECT_FALSE(cb.try_push_back("c"));
+    EXPECT_STRING_EQ(cb, [a, b]);
+  }
+}
+
+TEST(circular_buffer, push_front) {
+  circular_buffer<int> cb(4);
+  for (int i = 0; i < 6; i++)
+    cb.push_front(i);
+  EXPECT_STRING_EQ(cb, [5, 4, 3, 2]);
+  EXPECT_FALSE(cb.try_push_front(6));
+  cb.pop_back();
+  EXPECT_TRUE(cb.try_push_front(6));
+  EXPECT_STRING_EQ(cb, [6, 5, 4, 3]);
+}
+
+TEST(circular_buffer, pop) {
+  circular_buffer<int> cb = {1, 2, 3, 4};
+  cb.pop_front();
+  cb.pop_back();
+  EXPECT_STRING_EQ(cb, [2, 3]);
+  cb.clear();
+  EXPECT_TRUE(cb.empty());
+  EXPECT_ANY_THROW(cb.front());
+  EXPECT_ANY_THROW(cb.at(0));
+}
+
+TEST(circular_buffer, array_range) {
+  /**
+   * @test  array_one(), array_two()
+   * @brief the content wraps around the end of the storage.
+   */
+  SUBTEST(array_range) {
+    circular_buffer<int> cb(8);
+    for (int i = 0; i < 11; i++)
+      cb.push_back(i);
+    auto __one = cb.array_one();
+    auto __two = cb.array_two();
+    EXPECT_EQ(__one.second, 5);
+    EXPECT_EQ(__two.second, 3);
+    EXPECT_EQ(__one.first[0], 3);
+    EXPECT_EQ(__two.first[0], 8);
+    EXPECT_EQ(__one.second + __two.second, cb.size());
+  }
+
+  /**
+   * @test  array_one(), array_two()
+   * @brief the content is contiguous.
+   */
+  SUBTEST(array_range) {
+    circular_buffer<int> cb(8);
+    cb.push_back(1);
+    cb.push_back(2);
+    EXPECT_EQ(cb.array_one().second, 2);
+    EXPECT_EQ(cb.array_two().second, 0);
+  }
+}
+
+TEST(circular_buffer, iterator) {
+  circular_buffer<int> cb(8);
+  for (int i = 0; i < 13; i++)
+    cb.push_back(i);
+  EXPECT_EQ(cb.end() - cb.begin(), 8);
+  EXPECT_EQ(*(cb.begin() + 3), 8);
+  EXPECT_EQ(cb.cbegin()[7], 12);
+  EXPECT_EQ(*cb.rbegin(), 12);
+
+  vector<int> vc(8);
+  tinySTL::copy(cb.cbegin(), cb.cend(), vc.begin());
+  EXPECT_STRING_EQ(vc, [5, 6, 7, 8, 9, 10, 11, 12]);
+
+  tinySTL::fill(cb.begin() + 2, cb.end(), 0);
+  EXPECT_STRING_EQ(cb, [5, 6, 0, 0, 0, 0, 0, 0]);
+  EXPECT_EQ(tinySTL::count(cb.begin(), cb.end(), 0), 6);
+  EXPECT_EQ(tinySTL::find(cb.begin(), cb.end(), 6) - cb.begin(), 1);
+
+  tinySTL::copy(vc.begin(), vc.end(), cb.begin());
+  EXPECT_STRING_EQ(cb, [5, 6, 7, 8, 9, 10, 11, 12]);
+}
+
+TEST(circular_buffer, set_capacity) {
+  circular_buffer<int> cb(4);
+  for (int i = 0; i < 6; i++)
+    cb.push_back(i);
+  cb.set_capacity(8);
+  EXPECT_EQ(cb.capacity(), 8);
+  EXPECT_STRING_EQ(cb, [2, 3, 4, 5]);
+  EXPECT_EQ(cb.array_two().second, 0);
+  cb.set_capacity(2);
+  EXPECT_STRING_EQ(cb, [4, 5]);
+}
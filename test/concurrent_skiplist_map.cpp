@@ -0,0 +1,199 @@
+#include <map>
+#include <atomic>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+#include "concurrent_skiplist_map.h"
+#include "test_util.h"
+
+using namespace tinySTL;
+
+namespace {
+
+const int threads = 4;
+
+}
+
+TEST(concurrent_skiplist_map, constructor) {
+  /**
+   * @test  concurrent_skiplist_map() / concurrent_skiplist_map(std::initializer_list)
+   */
+  SUBTEST(constructor) {
+    concurrent_skiplist_map<int, std::string> m;
+    EXPECT_TRUE(m.empty());
+    EXPECT_STRING_EQ(m, []);
+    concurrent_skiplist_map<int, std::string> m1 {{2, "world"}, {1, "hello"}, {2, "again"}};
+    EXPECT_STRING_EQ(m1, [{1, hello}, {2, world}]);
+    EXPECT_EQ(m1.size(), 2);
+    EXPECT_EQ(m1.at(1), "hello");
+    EXPECT_THROW(m1.at(3), std::range_error);
+  }
+}
+
+TEST(concurrent_skiplist_map, modifiers) {
+  /**
+   * @test  insert / emplace / erase
+   * @brief random operations on one thread checked against std::map.
+   */
+  SUBTEST(modifiers) {
+    concurrent_skiplist_map<int, std::string> m;
+    std::map<int, std::string> model;
+    unsigned seed = 3;
+    for (int i = 0; i < 5000; ++i) {
+      int k = next_rand(seed) % 500;
+      std::string v = std::to_string(i);
+      switch (next_rand(seed) % 3) {
+        case 0:
+          EXPECT_EQ(m.insert({k, v}).second, model.insert({k, v}).second);
+          break;
+        case 1:
+          EXPECT_EQ(m.emplace(k, v).second, model.emplace(k, v).second);
+          break;
+        default:
+          EXPECT_EQ(m.erase(k), model.erase(k));
+      }
+    }
+    EXPECT_EQ(m.size(), model.size());
+    auto it = model.begin();
+    for (auto& p : m) {
+      EXPECT_EQ(p.first, it->first);
+      EXPECT_EQ(p.second, it->second);
+      ++it;
+    }
+    EXPECT_TRUE(it == model.end());
+  }
+
+  /**
+   * @test  erase(const_iterator) / clear
+   * @brief an erased element stays readable through the iterator.
+   */
+  SUBTEST(modifiers) {
+    concurrent_skiplist_map<int, int> m {{1, 1}, {2, 2}, {3, 3}};
+    auto it = m.find(2);
+    m.erase(it);
+    EXPECT_EQ(it->second, 2);
+    EXPECT_STRING_EQ(m, [{1, 1}, {3, 3}]);
+    m.erase(it);
+    EXPECT_EQ(m.size(), 2);
+    m.clear();
+    EXPECT_TRUE(m.empty());
+    EXPECT_EQ(m.size(), 0);
+  }
+}
+
+TEST(concurrent_skiplist_map, lookup) {
+  /**
+   * @test  find / contains / count / lower_bound / upper_bound
+   */
+  SUBTEST(lookup) {
+    concurrent_skiplist_map<int, int> m {{10, 1}, {20, 2}, {30, 3}};
+    EXPECT_EQ(m.find(20)->second, 2);
+    EXPECT_TRUE(m.find(25) == m.end());
+    EXPECT_TRUE(m.contains(30));
+    EXPECT_EQ(m.count(5), 0);
+    EXPECT_EQ(m.lower_bound(15)->first, 20);
+    EXPECT_EQ(m.lower_bound(20)->first, 20);
+    EXPECT_EQ(m.upper_bound(20)->first, 30);
+    EXPECT_TRUE(m.upper_bound(30) == m.end());
+    const concurrent_skiplist_map<int, int>& cm = m;
+    concurrent_skiplist_map<int, int>::const_iterator it = cm.lower_bound(11);
+    EXPECT_EQ(it->second, 2);
+  }
+}
+
+TEST(concurrent_skiplist_map, threads) {
+  /**
+   * @test  insert / erase from several threads
+   * @brief every thread inserts its own keys and erases the odd ones.
+   */
+  SUBTEST(threads) {
+    concurrent_skiplist_map<int, int> m;
+    const int n = 4000;
+    std::vector<std::thread> pool;
+    for (int t = 0; t < threads; ++t) {
+      pool.emplace_back([&m, t] {
+        for (int i = t; i < n; i += threads)
+          m.insert({i, i * 2});
+        for (int i = t; i < n; i += threads)
+          if (i % 2) {
+            EXPECT_EQ(m.erase(i), 1);
+          }
+      });
+    }
+    for (auto& th : pool) th.join();
+    EXPECT_EQ(m.size(), n / 2);
+    int expect = 0;
+    for (auto& p : m) {
+      EXPECT_EQ(p.first, expect);
+      EXPECT_EQ(p.second, expect * 2);
+      expect += 2;
+    }
+    EXPECT_EQ(expect, n);
+  }
+
+  /**
+   * @test  insert / erase racing on the same keys
+   * @brief a key is held by one insert at a time, so the inserts that
+   *  took a key match the erases that removed one.
+   */
+  SUBTEST(threads) {
+    concurrent_skiplist_map<int, int> m;
+    const int n = 2000;
+    std::atomic<int> inserted(0), erased(0);
+    std::vector<std::thread> pool;
+    for (int t = 0; t < threads; ++t) {
+      pool.emplace_back([&, t] {
+        for (int i = 0; i < n; ++i)
+          if (m.insert({i, t}).second) ++inserted;
+        for (int i = 0; i < n; ++i)
+          erased += m.erase(i);
+      });
+    }
+    for (auto& th : pool) th.join();
+    EXPECT_GE(inserted.load(), n);
+    EXPECT_EQ(erased.load(), inserted.load());
+    EXPECT_TRUE(m.empty());
+    EXPECT_EQ(m.size(), 0);
+  }
+
+  /**
+   * @test  find / lower_bound / iteration while other threads write
+   * @brief readers only ever see keys in order, and keys nobody erases
+   *  are always found.
+   */
+  SUBTEST(threads) {
+    concurrent_skiplist_map<int, int> m;
+    for (int i = 0; i < 1000; i += 10) m.insert({i, i});
+    std::atomic<bool> stop(false);
+    std::vector<std::thread> pool;
+    for (int t = 0; t < 2; ++t) {
+      pool.emplace_back([&, t] {
+        unsigned seed = t + 1;
+        while (!stop) {
+          int k = next_rand(seed) % 1000;
+          if (k % 10 == 0) continue;
+          if (next_rand(seed) % 2) m.insert({k, k});
+          else m.erase(k);
+        }
+      });
+    }
+    for (int round = 0; round < 200; ++round) {
+      int last = -1, fixed = 0;
+      for (auto it = m.begin(); it != m.end(); ++it) {
+        EXPECT_LT(last, it->first);
+        EXPECT_EQ(it->first, it->second);
+        last = it->first;
+        if (it->first % 10 == 0) ++fixed;
+      }
+      EXPECT_EQ(fixed, 100);
+      EXPECT_TRUE(m.contains(round % 100 * 10));
+      EXPECT_EQ(m.lower_bound(round * 5 % 1000 / 10 * 10)->first % 10, 0);
+    }
+    stop = true;
+    for (auto& th : pool) th.join();
+  }
+}
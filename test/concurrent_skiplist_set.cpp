@@ -0,0 +1,84 @@
+#include <set>
+#include <atomic>
+#include <thread>
+#include <vector>
+#include <string>
+#include <string_view>
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+#include "concurrent_skiplist_set.h"
+#include "test_util.h"
+
+using namespace tinySTL;
+
+TEST(concurrent_skiplist_set, modifiers) {
+  /**
+   * @test  insert / erase
+   * @brief random operations on one thread checked against std::set.
+   */
+  SUBTEST(modifiers) {
+    concurrent_skiplist_set<int> s;
+    std::set<int> model;
+    unsigned seed = 7;
+    for (int i = 0; i < 5000; ++i) {
+      int v = next_rand(seed) % 300;
+      if (next_rand(seed) % 3) {
+        EXPECT_EQ(s.insert(v).second, model.insert(v).second);
+      } else {
+        EXPECT_EQ(s.erase(v), model.erase(v));
+      }
+    }
+    EXPECT_EQ(s.size(), model.size());
+    EXPECT_TRUE(std::equal(s.begin(), s.end(), model.begin(), model.end()));
+  }
+
+  /**
+   * @test  concurrent_skiplist_set(std::initializer_list) / greater
+   */
+  SUBTEST(modifiers) {
+    concurrent_skiplist_set<int, greater<int>> s {3, 1, 4, 1, 5};
+    EXPECT_STRING_EQ(s, [5, 4, 3, 1]);
+    EXPECT_EQ(*s.lower_bound(2), 1);
+  }
+}
+
+TEST(concurrent_skiplist_set, lookup) {
+  /**
+   * @test  find / lower_bound with a transparent comparator
+   */
+  SUBTEST(lookup) {
+    concurrent_skiplist_set<std::string, less<>> s {"apple", "banana", "cherry"};
+    std::string_view key = "banana";
+    EXPECT_EQ(*s.find(key), "banana");
+    EXPECT_EQ(*s.lower_bound(std::string_view("c")), "cherry");
+    EXPECT_TRUE(s.find(std::string_view("date")) == s.end());
+  }
+}
+
+TEST(concurrent_skiplist_set, threads) {
+  /**
+   * @test  insert / erase from several threads
+   * @brief a thread owns the values its insert took and is the only one
+   *  to erase them, so every erase hits and the set ends up empty.
+   */
+  SUBTEST(threads) {
+    concurrent_skiplist_set<int> s;
+    const int n = 3000;
+    std::vector<std::thread> pool;
+    for (int t = 0; t < 4; ++t) {
+      pool.emplace_back([&, t] {
+        unsigned seed = t + 11;
+        std::vector<int> mine;
+        for (int i = 0; i < n; ++i) {
+          int v = next_rand(seed) % n;
+          if (s.insert(v).second) mine.push_back(v);
+        }
+        for (int v : mine) EXPECT_EQ(s.erase(v), 1);
+      });
+    }
+    for (auto& th : pool) th.join();
+    EXPECT_TRUE(s.empty());
+  }
+}
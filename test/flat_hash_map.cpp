@@ -0,0 +1,289 @@
+#include <string>
+#include <vector>
+#include <utility>
+#include <stdexcept>
+#include <unordered_map>
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+#include "flat_hash_map.h"
+#include "test_util.h"
+
+using namespace tinySTL;
+
+namespace {
+
+// every key hashes to the same value: all probes run through one chain.
+struct collide {
+  size_t operator()(int) const { return 42; }
+};
+
+}
+
+TEST(flat_hash_map, constructor) {
+  /**
+   * @test  flat_hash_map() / flat_hash_map(size_type)
+   * @brief an empty table holds no slots until the first insert.
+   */
+  SUBTEST(constructor) {
+    flat_hash_map<int, std::string> m;
+    EXPECT_TRUE(m.empty());
+    EXPECT_EQ(m.bucket_count(), 0);
+    EXPECT_EQ(m.find(1), m.end());
+    EXPECT_TRUE(m.begin() == m.end());
+    EXPECT_STRING_EQ(m, []);
+    flat_hash_map<int, std::string> m2(100);
+    EXPECT_GE(m2.bucket_count() * m2.max_load_factor(), 100);
+    EXPECT_TRUE(m2.empty());
+  }
+
+  /**
+   * @test  flat_hash_map(std::initializer_list) / flat_hash_map(Iterator, Iterator)
+   */
+  SUBTEST(constructor) {
+    flat_hash_map<int, std::string> m {{1, "hello"}, {2, "world"}, {1, "again"}};
+    EXPECT_EQ(m.size(), 2);
+    EXPECT_EQ(m.at(1), "hello");
+    EXPECT_EQ(m.at(2), "world");
+    std::vector<tinySTL::pair<int, std::string>> v {{3, "c"}, {4, "d"}};
+    flat_hash_map<int, std::string> m2(v.begin(), v.end());
+    EXPECT_EQ(m2.size(), 2);
+    EXPECT_EQ(m2[4], "d");
+    flat_hash_map<int, std::string> m3 {{7, "seven"}};
+    EXPECT_STRING_EQ(m3, [{7, seven}]);
+  }
+
+  /**
+   * @test  flat_hash_map(const flat_hash_map&) / flat_hash_map(flat_hash_map&&)
+   */
+  SUBTEST(constructor) {
+    checked<flat_hash_map<int, std::string>> m1;
+    for (int i = 0; i < 100; ++i) m1[i] = std::to_string(i);
+    checked<flat_hash_map<int, std::string>> m2(m1);
+    EXPECT_TRUE(m2.verify());
+    EXPECT_TRUE(m1 == m2);
+    checked<flat_hash_map<int, std::string>> m3(tinySTL::move(m1));
+    EXPECT_TRUE(m1.empty());
+    EXPECT_TRUE(m1.verify());
+    EXPECT_TRUE(m3 == m2);
+    m1 = m3;
+    EXPECT_TRUE(m1 == m3);
+    m3[1000] = "x";
+    EXPECT_TRUE(m1 != m3);
+    m2 = tinySTL::move(m3);
+    EXPECT_EQ(m2.size(), 101);
+    EXPECT_TRUE(m2.verify());
+  }
+}
+
+TEST(flat_hash_map, lookup) {
+  /**
+   * @test  find / contains / count / equal_range / at
+   */
+  SUBTEST(lookup) {
+    flat_hash_map<std::string, int> m {{"one", 1}, {"two", 2}, {"three", 3}};
+    EXPECT_EQ(m.find("two")->second, 2);
+    EXPECT_EQ(m.find("four"), m.end());
+    EXPECT_TRUE(m.contains("three"));
+    EXPECT_FALSE(m.contains(""));
+    EXPECT_EQ(m.count("one"), 1);
+    EXPECT_EQ(m.count("zero"), 0);
+    auto r = m.equal_range("one");
+    EXPECT_EQ(r.first->second, 1);
+    EXPECT_EQ(tinySTL::distance(r.first, r.second), 1);
+    auto r2 = m.equal_range("none");
+    EXPECT_TRUE(r2.first == m.end() && r2.second == m.end());
+    EXPECT_EQ(m.at("three"), 3);
+    EXPECT_THROW(m.at("four"), std::range_error);
+    const auto& c = m;
+    EXPECT_EQ(c.at("one"), 1);
+    EXPECT_THROW(c.at("four"), std::range_error);
+    EXPECT_EQ(m.size(), 3);
+  }
+
+  /**
+   * @test  lookups through a hash that sends every key to the same group
+   * @brief probing runs on past full groups and stops at an empty slot.
+   */
+  SUBTEST(lookup) {
+    flat_hash_map<int, int, collide> m;
+    for (int i = 0; i < 200; ++i) m[i] = i * 2;
+    for (int i = 0; i < 200; ++i) EXPECT_EQ(m.at(i), i * 2);
+    EXPECT_FALSE(m.contains(200));
+    for (int i = 0; i < 200; i += 2) EXPECT_EQ(m.erase(i), 1);
+    for (int i = 0; i < 200; ++i) EXPECT_EQ(m.contains(i), i % 2 == 1);
+  }
+}
+
+TEST(flat_hash_map, modifiers) {
+  /**
+   * @test  insert / emplace / try_emplace / insert_or_assign / operator[]
+   */
+  SUBTEST(modifiers) {
+    flat_hash_map<int, std::string> m;
+    auto r = m.insert({1, "a"});
+    EXPECT_TRUE(r.second);
+    EXPECT_EQ(r.first->second, "a");
+    r = m.insert({1, "b"});
+    EXPECT_FALSE(r.second);
+    EXPECT_EQ(r.first->second, "a");
+    r = m.emplace(2, "b");
+    EXPECT_TRUE(r.second);
+    r = m.try_emplace(2, "c");
+    EXPECT_FALSE(r.second);
+    EXPECT_EQ(m[2], "b");
+    r = m.try_emplace(3, 3, 'c');
+    EXPECT_TRUE(r.second);
+    EXPECT_EQ(m[3], "ccc");
+    r = m.insert_or_assign(3, "d");
+    EXPECT_FALSE(r.second);
+    EXPECT_EQ(m[3], "d");
+    r = m.insert_or_assign(4, "e");
+    EXPECT_TRUE(r.second);
+    EXPECT_EQ(m[5], "");
+    EXPECT_EQ(m.size(), 5);
+    m.emplace_hint(m.begin(), 6, "f");
+    m.insert(m.end(), {7, "g"});
+    m.insert({{8, "h"}, {1, "z"}});
+    EXPECT_EQ(m.size(), 8);
+    EXPECT_EQ(m[1], "a");
+  }
+
+  /**
+   * @test  erase(key) / erase(iterator) / erase(first, last) / clear
+   */
+  SUBTEST(modifiers) {
+    checked<flat_hash_map<int, int>> m;
+    for (int i = 0; i < 100; ++i) m[i] = i;
+    EXPECT_EQ(m.erase(5), 1);
+    EXPECT_EQ(m.erase(5), 0);
+    size_t n = m.size();
+    for (auto it = m.begin(); it != m.end(); ) {
+      if (it->first % 3 == 0) it = m.erase(it), --n;
+      else ++it;
+      EXPECT_EQ(m.size(), n);
+    }
+    for (auto& p : m) EXPECT_NE(p.first % 3, 0);
+    EXPECT_TRUE(m.verify());
+    const auto& c = m;
+    auto it = m.erase(c.begin(), c.end());
+    EXPECT_TRUE(it == m.end());
+    EXPECT_TRUE(m.empty());
+    EXPECT_TRUE(m.verify());
+    m[1] = 1;
+    size_t cap = m.bucket_count();
+    m.clear();
+    EXPECT_TRUE(m.empty());
+    EXPECT_EQ(m.bucket_count(), cap);
+    EXPECT_TRUE(m.verify());
+  }
+
+  /**
+   * @test  random inserts and erases against std::unordered_map
+   * @brief tombstones are reused and the table rebuilds in place when
+   *  they pile up, without growing.
+   */
+  SUBTEST(modifiers) {
+    checked<flat_hash_map<int, int>> m;
+    std::unordered_map<int, int> model;
+    unsigned seed = 7;
+    for (int i = 0; i < 40000; ++i) {
+      int k = next_rand(seed) % 2000;
+      switch (next_rand(seed) % 4) {
+        case 0: case 1:
+          m[k] = i;
+          model[k] = i;
+          break;
+        case 2:
+          EXPECT_EQ(m.erase(k), model.erase(k));
+          break;
+        default:
+          EXPECT_EQ(m.contains(k), model.count(k) == 1);
+      }
+      if (i % 5000 == 0) {
+        EXPECT_TRUE(m.verify());
+      }
+    }
+    EXPECT_TRUE(same_elements(m, model));
+    EXPECT_TRUE(m.verify());
+    EXPECT_LE(m.bucket_count(), 4095);
+  }
+
+  /**
+   * @test  churn at a steady size
+   * @brief a steady stream of new keys leaves tombstones everywhere;
+   *  they are cleared by rebuilds in place and the table stops growing.
+   */
+  SUBTEST(modifiers) {
+    checked<flat_hash_map<int, int>> m;
+    size_t cap = 0;
+    for (int i = 0; i < 100000; ++i) {
+      m[i] = i;
+      if (i >= 100) {
+        EXPECT_EQ(m.erase(i - 100), 1);
+      }
+      if (i == 10000) cap = m.bucket_count();
+    }
+    EXPECT_LE(cap, 255);
+    EXPECT_EQ(m.size(), 100);
+    EXPECT_EQ(m.bucket_count(), cap);
+    EXPECT_TRUE(m.verify());
+  }
+
+  /**
+   * @test  swap
+   */
+  SUBTEST(modifiers) {
+    flat_hash_map<int, int> a {{1, 1}}, b {{2, 2}, {3, 3}};
+    a.swap(b);
+    EXPECT_EQ(a.size(), 2);
+    EXPECT_EQ(b.size(), 1);
+    EXPECT_TRUE(b.contains(1));
+  }
+
+  /**
+   * @test  a copy that throws while the table grows
+   * @brief the table is left as it was.
+   */
+  SUBTEST(modifiers) {
+    checked<flat_hash_map<int, fragile>> m;
+    for (int i = 0; i < 14; ++i) m.emplace(i, fragile(i));
+    size_t cap = m.bucket_count();
+    EXPECT_EQ(m.size(), 14);
+    fragile::budget = 5;
+    EXPECT_THROW(m.insert({100, fragile(100)}), std::runtime_error);
+    fragile::budget = -1;
+    EXPECT_EQ(m.size(), 14);
+    EXPECT_EQ(m.bucket_count(), cap);
+    EXPECT_TRUE(m.verify());
+    for (int i = 0; i < 14; ++i) EXPECT_EQ(m.at(i).v, i);
+    EXPECT_FALSE(m.contains(100));
+  }
+}
+
+TEST(flat_hash_map, capacity) {
+  /**
+   * @test  reserve / rehash / load_factor
+   */
+  SUBTEST(capacity) {
+    checked<flat_hash_map<int, int>> m;
+    m.reserve(1000);
+    size_t cap = m.bucket_count();
+    EXPECT_GE(cap * m.max_load_factor(), 1000);
+    for (int i = 0; i < 1000; ++i) m[i] = i;
+    EXPECT_EQ(m.bucket_count(), cap);
+    EXPECT_LE(m.load_factor(), m.max_load_factor());
+    for (int i = 0; i < 990; ++i) m.erase(i);
+    m.rehash(0);
+    EXPECT_LT(m.bucket_count(), cap);
+    EXPECT_TRUE(m.verify());
+    EXPECT_EQ(m.size(), 10);
+    m.clear();
+    m.rehash(0);
+    EXPECT_EQ(m.bucket_count(), 0);
+    EXPECT_TRUE(m.verify());
+    m[1] = 1;
+    EXPECT_EQ(m.at(1), 1);
+  }
+}
@@ -0,0 +1,88 @@
+#include <string>
+#include <vector>
+#include <unordered_set>
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+#include "flat_hash_set.h"
+#include "test_util.h"
+
+using namespace tinySTL;
+
+TEST(flat_hash_set, constructor) {
+  /**
+   * @test  flat_hash_set() / flat_hash_set(std::initializer_list) / flat_hash_set(Iterator, Iterator)
+   */
+  SUBTEST(constructor) {
+    flat_hash_set<int> s;
+    EXPECT_TRUE(s.empty());
+    EXPECT_STRING_EQ(s, []);
+    flat_hash_set<int> s1 {3, 1, 4, 1, 5};
+    EXPECT_EQ(s1.size(), 4);
+    std::vector<int> v {9, 2, 6};
+    flat_hash_set<int> s2(v.begin(), v.end());
+    EXPECT_EQ(s2.size(), 3);
+    EXPECT_TRUE(s2.contains(6));
+    flat_hash_set<std::string> s3 {"one"};
+    EXPECT_STRING_EQ(s3, [one]);
+  }
+
+  /**
+   * @test  flat_hash_set(const flat_hash_set&) / flat_hash_set(flat_hash_set&&)
+   */
+  SUBTEST(constructor) {
+    checked<flat_hash_set<std::string>> s1;
+    for (int i = 0; i < 100; ++i) s1.insert(std::to_string(i));
+    checked<flat_hash_set<std::string>> s2(s1);
+    EXPECT_TRUE(s2.verify());
+    EXPECT_TRUE(s1 == s2);
+    checked<flat_hash_set<std::string>> s3(tinySTL::move(s1));
+    EXPECT_TRUE(s1.empty());
+    EXPECT_TRUE(s3 == s2);
+    s3.erase("7");
+    EXPECT_TRUE(s3 != s2);
+  }
+}
+
+TEST(flat_hash_set, modifiers) {
+  /**
+   * @test  insert / emplace / erase / find / count
+   */
+  SUBTEST(modifiers) {
+    flat_hash_set<std::string> s;
+    EXPECT_TRUE(s.insert("a").second);
+    EXPECT_FALSE(s.insert("a").second);
+    auto r = s.emplace(3, 'b');
+    EXPECT_TRUE(r.second);
+    EXPECT_EQ(*r.first, "bbb");
+    EXPECT_EQ(*s.find("a"), "a");
+    EXPECT_EQ(s.find("b"), s.end());
+    EXPECT_EQ(s.count("bbb"), 1);
+    EXPECT_EQ(s.erase("a"), 1);
+    EXPECT_EQ(s.erase("a"), 0);
+    auto it = s.erase(s.find("bbb"));
+    EXPECT_TRUE(it == s.end());
+    EXPECT_TRUE(s.empty());
+  }
+
+  /**
+   * @test  random inserts and erases against std::unordered_set
+   */
+  SUBTEST(modifiers) {
+    checked<flat_hash_set<unsigned>> s;
+    std::unordered_set<unsigned> model;
+    unsigned seed = 11;
+    for (int i = 0; i < 40000; ++i) {
+      unsigned k = next_rand(seed) % 3000;
+      if (next_rand(seed) % 2) EXPECT_EQ(s.insert(k).second, model.insert(k).second);
+      else EXPECT_EQ(s.erase(k), model.erase(k));
+    }
+    EXPECT_TRUE(s.verify());
+    EXPECT_EQ(s.size(), model.size());
+    for (unsigned k : s) EXPECT_EQ(model.count(k), 1);
+    s.erase(s.begin(), s.end());
+    EXPECT_TRUE(s.empty());
+    EXPECT_TRUE(s.verify());
+  }
+}
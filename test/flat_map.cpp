@@ -0,0 +1,223 @@
+#include <map>
+#include <string>
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+#include "flat_map.h"
+#include "algorithm.h"
+#include "test_util.h"
+
+using namespace tinySTL;
+
+TEST(flat_map, constructor) {
+  /**
+   * @test  flat_map() / flat_map(std::initializer_list) / copy / move
+   */
+  SUBTEST(constructor) {
+    flat_map<int, std::string> m;
+    EXPECT_STRING_EQ(m, []);
+    flat_map<int, std::string> m1 {{2, "world"}, {1, "hello"}, {2, "again"}};
+    EXPECT_STRING_EQ(m1, [{1, hello}, {2, world}]);
+    flat_map<int, std::string> m2(m1);
+    EXPECT_STRING_EQ(m2, [{1, hello}, {2, world}]);
+    flat_map<int, std::string> m3(tinySTL::move(m1));
+    EXPECT_STRING_EQ(m1, []);
+    EXPECT_STRING_EQ(m3, [{1, hello}, {2, world}]);
+    EXPECT_TRUE(m2 == m3);
+  }
+
+  /**
+   * @test  flat_map(keys, values) / flat_map(sorted_unique, keys, values) / extract
+   */
+  SUBTEST(constructor) {
+    flat_map<int, int> m(vector<int>{3, 1, 2}, vector<int>{30, 10, 20});
+    EXPECT_STRING_EQ(m, [{1, 10}, {2, 20}, {3, 30}]);
+    EXPECT_STRING_EQ(m.keys(), [1, 2, 3]);
+    EXPECT_STRING_EQ(m.values(), [10, 20, 30]);
+    flat_map<int, int> m1(sorted_unique, vector<int>{1, 5}, vector<int>{0, 1});
+    EXPECT_STRING_EQ(m1, [{1, 0}, {5, 1}]);
+    auto c = tinySTL::move(m1).extract();
+    EXPECT_STRING_EQ(c.keys, [1, 5]);
+    EXPECT_STRING_EQ(c.values, [0, 1]);
+    EXPECT_TRUE(m1.empty());
+  }
+}
+
+TEST(flat_map, element_access) {
+  /**
+   * @test  operator[] / at
+   */
+  SUBTEST(element_access) {
+    flat_map<std::string, int> m;
+    m["b"] = 2;
+    m["a"] = 1;
+    ++m["b"];
+    EXPECT_STRING_EQ(m, [{a, 1}, {b, 3}]);
+    EXPECT_EQ(m.at("a"), 1);
+    const flat_map<std::string, int>& cm = m;
+    EXPECT_EQ(cm.at("b"), 3);
+    EXPECT_THROW(cm.at("c"), std::range_error);
+  }
+
+  /**
+   * @test  iterator writes through to the value
+   */
+  SUBTEST(element_access) {
+    flat_map<int, int> m {{5, 5}, {4, 4}, {0, 0}};
+    m.begin()->second = 111;
+    (*(m.end() - 1)).second = 55;
+    m.begin()[1].second += 1;
+    EXPECT_STRING_EQ(m, [{0, 111}, {4, 5}, {5, 55}]);
+    flat_map<int, int>::const_iterator it = m.begin();
+    EXPECT_EQ(it->first, 0);
+    EXPECT_TRUE(it == m.cbegin());
+    EXPECT_EQ(m.end() - it, 3);
+    EXPECT_EQ(m.rbegin()->first, 5);
+  }
+}
+
+TEST(flat_map, modifiers) {
+  /**
+   * @test  insert / try_emplace / insert_or_assign / erase
+   * @brief random operations checked against std::map.
+   */
+  SUBTEST(modifiers) {
+    flat_map<int, std::string> m;
+    std::map<int, std::string> model;
+    unsigned seed = 3;
+    for (int i = 0; i < 3000; ++i) {
+      int k = next_rand(seed) % 400;
+      std::string v = std::to_string(i);
+      switch (next_rand(seed) % 4) {
+        case 0:
+          EXPECT_EQ(m.insert({k, v}).second, model.insert({k, v}).second);
+          break;
+        case 1:
+          EXPECT_EQ(m.try_emplace(k, v).second, model.try_emplace(k, v).second);
+          break;
+        case 2:
+          EXPECT_EQ(m.insert_or_assign(k, v).second, model.insert_or_assign(k, v).second);
+          break;
+        default:
+          EXPECT_EQ(m.erase(k), model.erase(k));
+      }
+    }
+    EXPECT_EQ(m.size(), model.size());
+    auto it = model.begin();
+    for (auto p : m) {
+      EXPECT_EQ(p.first, it->first);
+      EXPECT_EQ(p.second, it->second);
+      ++it;
+    }
+  }
+
+  /**
+   * @test  insert(first, last)
+   * @brief new elements are sorted and merged, a key already present or
+   *  repeated in the range keeps its first value.
+   */
+  SUBTEST(modifiers) {
+    flat_map<int, int> m {{2, 0}, {4, 0}};
+    vector<pair<int, int>> v {{5, 1}, {4, 1}, {1, 1}, {5, 2}, {3, 1}};
+    m.insert(v.begin(), v.end());
+    EXPECT_STRING_EQ(m, [{1, 1}, {2, 0}, {3, 1}, {4, 0}, {5, 1}]);
+    vector<pair<int, int>> tail {{6, 1}, {7, 1}};
+    m.insert(tail.begin(), tail.end());
+    vector<pair<int, int>> sorted {{0, 2}, {4, 2}, {8, 2}};
+    m.insert(sorted_unique, sorted.begin(), sorted.end());
+    EXPECT_STRING_EQ(m, [{0, 2}, {1, 1}, {2, 0}, {3, 1}, {4, 0}, {5, 1}, {6, 1}, {7, 1}, {8, 2}]);
+  }
+
+  /**
+   * @test  try_emplace
+   * @brief the value is not touched when the key is present.
+   */
+  SUBTEST(modifiers) {
+    flat_map<int, std::string> m {{1, "a"}};
+    std::string s = "b";
+    EXPECT_FALSE(m.try_emplace(1, tinySTL::move(s)).second);
+    EXPECT_EQ(s, "b");
+    EXPECT_TRUE(m.try_emplace(2, 3, 'c').second);
+    EXPECT_STRING_EQ(m, [{1, a}, {2, ccc}]);
+  }
+
+  /**
+   * @test  erase(first, last) / clear
+   */
+  SUBTEST(modifiers) {
+    flat_map<int, int> m {{1, 1}, {2, 2}, {3, 3}, {4, 4}};
+    auto it = m.erase(m.find(2), m.find(4));
+    EXPECT_EQ(it->first, 4);
+    EXPECT_STRING_EQ(m, [{1, 1}, {4, 4}]);
+    m.clear();
+    EXPECT_TRUE(m.empty());
+  }
+}
+
+TEST(flat_map, lookup) {
+  /**
+   * @test  find / count / contains / lower_bound / upper_bound / equal_range
+   */
+  SUBTEST(lookup) {
+    flat_map<int, int> m {{10, 1}, {20, 2}, {30, 3}};
+    EXPECT_EQ(m.find(20)->second, 2);
+    EXPECT_TRUE(m.find(25) == m.end());
+    EXPECT_EQ(m.count(30), 1);
+    EXPECT_FALSE(m.contains(5));
+    EXPECT_EQ(m.lower_bound(15)->first, 20);
+    EXPECT_EQ(m.upper_bound(20)->first, 30);
+    auto r = m.equal_range(20);
+    EXPECT_EQ(r.second - r.first, 1);
+    r = m.equal_range(21);
+    EXPECT_TRUE(r.first == r.second);
+  }
+}
+
+TEST(flat_multimap, modifiers) {
+  /**
+   * @test  insert / insert(first, last) / erase
+   * @brief equal keys keep their insertion order, old ones first.
+   */
+  SUBTEST(modifiers) {
+    flat_multimap<int, int> m {{1, 0}, {2, 0}};
+    vector<pair<int, int>> v {{2, 1}, {1, 1}, {2, 2}, {0, 1}, {1, 2}};
+    m.insert(v.begin(), v.end());
+    EXPECT_STRING_EQ(m, [{0, 1}, {1, 0}, {1, 1}, {1, 2}, {2, 0}, {2, 1}, {2, 2}]);
+    m.insert({1, 3});
+    m.emplace(2, 3);
+    EXPECT_EQ(m.count(1), 4);
+    EXPECT_EQ(m.erase(2), 4);
+    EXPECT_STRING_EQ(m, [{0, 1}, {1, 0}, {1, 1}, {1, 2}, {1, 3}]);
+    auto r = m.equal_range(1);
+    r.first->second = 9;
+    EXPECT_EQ(r.second - r.first, 4);
+    EXPECT_EQ(m.find(1)->second, 9);
+  }
+
+  /**
+   * @test  insert / erase
+   * @brief random operations checked against std::multimap.
+   */
+  SUBTEST(modifiers) {
+    flat_multimap<int, int> m;
+    std::multimap<int, int> model;
+    unsigned seed = 5;
+    for (int i = 0; i < 2000; ++i) {
+      int k = next_rand(seed) % 100;
+      if (next_rand(seed) % 3) {
+        m.insert({k, i});
+        model.insert({k, i});
+      } else {
+        EXPECT_EQ(m.erase(k), model.erase(k));
+      }
+    }
+    EXPECT_EQ(m.size(), model.size());
+    auto it = model.begin();
+    for (auto p : m) {
+      EXPECT_EQ(p.first, it->first);
+      EXPECT_EQ(p.second, it->second);
+      ++it;
+    }
+  }
+}
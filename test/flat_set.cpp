@@ -0,0 +1,185 @@
+#include <set>
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+#include "flat_set.h"
+#include "algorithm.h"
+#include "test_util.h"
+
+using namespace tinySTL;
+
+namespace {
+
+struct by_first {
+  bool operator()(const pair<int, int>& a, const pair<int, int>& b) const
+  { return a.first < b.first; }
+};
+
+}
+
+TEST(flat_set, constructor) {
+  /**
+   * @test  flat_set() / flat_set(std::initializer_list) / copy / move
+   */
+  SUBTEST(constructor) {
+    flat_set<int> s;
+    EXPECT_STRING_EQ(s, []);
+    flat_set<int> s1 {3, 1, 2, 3, 1};
+    EXPECT_STRING_EQ(s1, [1, 2, 3]);
+    flat_set<int> s2(s1);
+    EXPECT_STRING_EQ(s2, [1, 2, 3]);
+    flat_set<int> s3(tinySTL::move(s1));
+    EXPECT_STRING_EQ(s1, []);
+    EXPECT_STRING_EQ(s3, [1, 2, 3]);
+    EXPECT_TRUE(s2 == s3);
+  }
+
+  /**
+   * @test  flat_set(container) / flat_set(sorted_unique, container)
+   */
+  SUBTEST(constructor) {
+    flat_set<int> s(vector<int>{5, 4, 5, 1});
+    EXPECT_STRING_EQ(s, [1, 4, 5]);
+    flat_set<int> s1(sorted_unique, vector<int>{1, 2, 7});
+    EXPECT_STRING_EQ(s1, [1, 2, 7]);
+    vector<int> c = tinySTL::move(s1).extract();
+    EXPECT_STRING_EQ(c, [1, 2, 7]);
+    EXPECT_TRUE(s1.empty());
+    c.push_back(9);
+    s1.replace(tinySTL::move(c));
+    EXPECT_STRING_EQ(s1, [1, 2, 7, 9]);
+  }
+}
+
+TEST(flat_set, modifiers) {
+  /**
+   * @test  insert / erase
+   * @brief random operations checked against std::set.
+   */
+  SUBTEST(modifiers) {
+    flat_set<int> s;
+    std::set<int> model;
+    unsigned seed = 7;
+    for (int i = 0; i < 3000; ++i) {
+      int v = next_rand(seed) % 500;
+      if (next_rand(seed) % 3) {
+        EXPECT_EQ(s.insert(v).second, model.insert(v).second);
+      } else {
+        EXPECT_EQ(s.erase(v), model.erase(v));
+      }
+    }
+    EXPECT_TRUE(tinySTL::equal(s.begin(), s.end(), model.begin()));
+    EXPECT_EQ(s.size(), model.size());
+  }
+
+  /**
+   * @test  insert(hint, value)
+   * @brief a wrong hint still lands the value in order.
+   */
+  SUBTEST(modifiers) {
+    flat_set<int> s {1, 5, 9};
+    s.insert(s.end(), 10);
+    s.insert(s.begin(), 4);
+    s.insert(s.find(5), 5);
+    EXPECT_STRING_EQ(s, [1, 4, 5, 9, 10]);
+  }
+
+  /**
+   * @test  insert(first, last)
+   * @brief the new values are sorted and merged, duplicates inside the
+   *  range and against the old values are dropped.
+   */
+  SUBTEST(modifiers) {
+    flat_set<int> s {2, 4, 6};
+    vector<int> v {9, 1, 4, 8, 1, 3};
+    s.insert(v.begin(), v.end());
+    EXPECT_STRING_EQ(s, [1, 2, 3, 4, 6, 8, 9]);
+    vector<int> tail {10, 11, 11, 12};
+    s.insert(tail.begin(), tail.end());
+    EXPECT_STRING_EQ(s, [1, 2, 3, 4, 6, 8, 9, 10, 11, 12]);
+    vector<int> sorted {0, 5, 13};
+    s.insert(sorted_unique, sorted.begin(), sorted.end());
+    EXPECT_STRING_EQ(s, [0, 1, 2, 3, 4, 5, 6, 8, 9, 10, 11, 12, 13]);
+  }
+
+  /**
+   * @test  insert(first, last)
+   * @brief of equal values the first one stays.
+   */
+  SUBTEST(modifiers) {
+    flat_set<pair<int, int>, by_first> s {{1, 0}, {3, 0}};
+    vector<pair<int, int>> v {{3, 1}, {2, 1}, {2, 2}, {1, 1}};
+    s.insert(v.begin(), v.end());
+    EXPECT_STRING_EQ(s, [{1, 0}, {2, 1}, {3, 0}]);
+  }
+
+  /**
+   * @test  erase(first, last) / clear
+   */
+  SUBTEST(modifiers) {
+    flat_set<int> s {1, 2, 3, 4, 5};
+    auto it = s.erase(s.find(2), s.find(4));
+    EXPECT_EQ(*it, 4);
+    EXPECT_STRING_EQ(s, [1, 4, 5]);
+    s.clear();
+    EXPECT_TRUE(s.empty());
+  }
+}
+
+TEST(flat_set, lookup) {
+  /**
+   * @test  find / count / contains / lower_bound / upper_bound / equal_range
+   */
+  SUBTEST(lookup) {
+    flat_set<int> s {10, 20, 30};
+    EXPECT_EQ(*s.find(20), 20);
+    EXPECT_TRUE(s.find(25) == s.end());
+    EXPECT_EQ(s.count(30), 1);
+    EXPECT_FALSE(s.contains(5));
+    EXPECT_EQ(*s.lower_bound(15), 20);
+    EXPECT_EQ(*s.upper_bound(20), 30);
+    auto r = s.equal_range(20);
+    EXPECT_EQ(r.second - r.first, 1);
+    r = s.equal_range(21);
+    EXPECT_TRUE(r.first == r.second);
+  }
+}
+
+TEST(flat_multiset, modifiers) {
+  /**
+   * @test  insert / erase / count
+   * @brief random operations checked against std::multiset.
+   */
+  SUBTEST(modifiers) {
+    flat_multiset<int> s;
+    std::multiset<int> model;
+    unsigned seed = 11;
+    for (int i = 0; i < 3000; ++i) {
+      int v = next_rand(seed) % 200;
+      if (next_rand(seed) % 3) {
+        s.insert(v);
+        model.insert(v);
+      } else {
+        EXPECT_EQ(s.erase(v), model.erase(v));
+      }
+    }
+    EXPECT_TRUE(tinySTL::equal(s.begin(), s.end(), model.begin()));
+    EXPECT_EQ(s.size(), model.size());
+    EXPECT_EQ(s.count(7), model.count(7));
+  }
+
+  /**
+   * @test  insert(first, last)
+   * @brief equal values keep their insertion order, old ones first.
+   */
+  SUBTEST(modifiers) {
+    flat_multiset<pair<int, int>, by_first> s {{1, 0}, {2, 0}};
+    vector<pair<int, int>> v {{2, 1}, {1, 1}, {2, 2}, {0, 1}, {1, 2}};
+    s.insert(v.begin(), v.end());
+    EXPECT_STRING_EQ(s, [{0, 1}, {1, 0}, {1, 1}, {1, 2}, {2, 0}, {2, 1}, {2, 2}]);
+    s.insert({2, 3});
+    s.insert(s.begin(), {1, 3});
+    EXPECT_STRING_EQ(s, [{0, 1}, {1, 0}, {1, 1}, {1, 2}, {1, 3}, {2, 0}, {2, 1}, {2, 2}, {2, 3}]);
+  }
+}
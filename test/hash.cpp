@@ -0,0 +1,117 @@
+#include <set>
+#include <string>
+#include <vector>
+#include <string_view>
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+#include "tiny_hash_fun.h"
+
+using namespace tinySTL;
+
+TEST(hash, string) {
+  /**
+   * @test  hash<std::string> / hash<std::string_view> / hash<const char*>
+   * @brief the same characters hash the same whatever holds them.
+   */
+  SUBTEST(string) {
+    const char* c = "Standard Template Library";
+    std::string s(c);
+    EXPECT_EQ(hash<std::string>()(s), hash<std::string_view>()(s));
+    EXPECT_EQ(hash<std::string>()(s), hash<const char*>()(c));
+    EXPECT_EQ(hash<std::string>()(s), hash<char*>()(s.data()));
+    EXPECT_NE(hash<std::string>()(s), hash<std::string>()("Standard Template Librarz"));
+  }
+
+  /**
+   * @test  hash<std::string> of strings with embedded zeros
+   * @brief the length is part of the hash, the bytes are not read up
+   *  to a terminator.
+   */
+  SUBTEST(string) {
+    hash<std::string> h;
+    EXPECT_NE(h(std::string()), h(std::string(1, '\0')));
+    EXPECT_NE(h(std::string(1, '\0')), h(std::string(2, '\0')));
+    EXPECT_NE(h(std::string("a\0b", 3)), h(std::string("a\0c", 3)));
+    EXPECT_NE(h(std::string(600, '\0')), h(std::string(601, '\0')));
+  }
+}
+
+TEST(hash, bytes) {
+  /**
+   * @test  __tiny_hash_bytes over every length up to 2100
+   * @brief the prefixes of one buffer all hash apart, and flipping any
+   *  one bit of a key changes its hash, on each of the paths.
+   */
+  SUBTEST(bytes) {
+    std::vector<unsigned char> buf(2100);
+    unsigned seed = 1;
+    for (auto& c : buf) c = (unsigned char)((seed = seed * 1103515245 + 12345) >> 16);
+    std::set<size_t> seen;
+    for (size_t n = 0; n <= buf.size(); ++n)
+      seen.insert(__tiny_hash_bytes(buf.data(), n));
+    EXPECT_EQ(seen.size(), buf.size() + 1);
+    for (size_t n : {1, 3, 4, 7, 8, 15, 16, 17, 31, 48, 49, 100, 511, 512, 513, 1024, 1025, 2100}) {
+      size_t h = __tiny_hash_bytes(buf.data(), n);
+      for (size_t i = 0; i < n; ++i)
+        for (int b = 0; b < 8; b += 3) {
+          buf[i] ^= 1 << b;
+          EXPECT_NE(__tiny_hash_bytes(buf.data(), n), h);
+          buf[i] ^= 1 << b;
+        }
+      EXPECT_EQ(__tiny_hash_bytes(buf.data(), n), h);
+      EXPECT_NE(__tiny_hash_bytes(buf.data(), n, 1), h);
+    }
+  }
+
+  /**
+   * @test  __tiny_hash_long<true> / __tiny_hash_long<false>
+   * @brief the AVX2 sums and the scalar ones agree, and the long path
+   *  is as sensitive to every bit as the short one.
+   */
+  SUBTEST(bytes) {
+    std::vector<unsigned char> buf(5000);
+    for (size_t i = 0; i < buf.size(); ++i) buf[i] = (unsigned char)(i * 131 + (i >> 8));
+    std::set<uint64_t> seen;
+    for (size_t n = 64; n <= buf.size(); n += 37) {
+      uint64_t h = __tiny_hash_long<false>(buf.data(), n, 7);
+      seen.insert(h);
+#if __TINY_HASH_AVX2
+      if (__tiny_cpu_has_avx2()) {
+        EXPECT_EQ(__tiny_hash_long<true>(buf.data(), n, 7), h);
+      }
+#endif
+    }
+    EXPECT_EQ(seen.size(), (buf.size() - 64) / 37 + 1);
+    for (size_t n : {64, 65, 1024, 1025, 3000}) {
+      uint64_t h = __tiny_hash_long<false>(buf.data(), n, 0);
+      for (size_t i = 0; i < n; ++i) {
+        buf[i] ^= 0x10;
+        EXPECT_NE(__tiny_hash_long<false>(buf.data(), n, 0), h);
+        buf[i] ^= 0x10;
+      }
+    }
+  }
+
+  /**
+   * @test  hash<std::string> of keys that differ in a few characters
+   * @brief no collisions, and the low bits, which a power of two table
+   *  uses, spread evenly.
+   */
+  SUBTEST(bytes) {
+    hash<std::string> h;
+    std::set<size_t> seen;
+    std::vector<int> buckets(4096);
+    for (int i = 0; i < 200000; ++i) {
+      size_t v = h("key" + std::to_string(i));
+      seen.insert(v);
+      ++buckets[v & 4095];
+    }
+    EXPECT_EQ(seen.size(), 200000);
+    for (int b : buckets) {
+      EXPECT_GT(b, 20);
+      EXPECT_LT(b, 80);
+    }
+  }
+}
@@ -0,0 +1,102 @@
+#include <string>
+#include <vector>
+#include <utility>
+#include <algorithm>
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+#include "interval_map.h"
+#include "test_util.h"
+
+using namespace tinySTL;
+
+TEST(interval_map, constructor) {
+  /**
+   * @test  interval_map() / interval_map(std::initializer_list)
+   */
+  SUBTEST(constructor) {
+    interval_map<int, std::string> m;
+    EXPECT_TRUE(m.empty());
+    EXPECT_TRUE(m.find_overlap(0) == m.end());
+    EXPECT_EQ(m.count_overlaps(0, 10), 0);
+    interval_map<int, std::string> m1 {{{3, 9}, "b"}, {{1, 5}, "a"}, {{1, 5}, "c"}};
+    EXPECT_STRING_EQ(m1, [{{1, 5}, a}, {{1, 5}, c}, {{3, 9}, b}]);
+    EXPECT_EQ(m1.size(), 3);
+    EXPECT_EQ(m1.count({1, 5}), 2);
+    EXPECT_THROW(m1.insert({{4, 2}, "bad"}), std::range_error);
+    EXPECT_THROW(m1.emplace(4, 2, "bad"), std::range_error);
+  }
+}
+
+TEST(interval_map, overlap) {
+  /**
+   * @test  find_overlap / for_each_overlap / count_overlaps
+   */
+  SUBTEST(overlap) {
+    interval_map<int, int> m {{{1, 5}, 1}, {{3, 9}, 2}, {{10, 12}, 3}, {{2, 2}, 4}};
+    EXPECT_EQ(m.find_overlap(6, 7)->second, 2);
+    EXPECT_EQ(m.find_overlap(9)->second, 2);
+    EXPECT_EQ(m.find_overlap(0, 1)->second, 1);
+    EXPECT_EQ(m.find_overlap(12, 20)->second, 3);
+    EXPECT_TRUE(m.find_overlap(13) == m.end());
+    EXPECT_TRUE(m.find_overlap(-5, 0) == m.end());
+    std::vector<int> seen;
+    m.for_each_overlap(2, 3, [&seen](auto& v) { seen.push_back(v.second); });
+    EXPECT_EQ(seen, (std::vector<int>{1, 4, 2}));
+    m.for_each_overlap(10, 10, [](auto& v) { v.second = 30; });
+    EXPECT_EQ(m.find_overlap(11)->second, 30);
+    EXPECT_EQ(m.count_overlaps(0, 100), 4);
+    const interval_map<int, int>& cm = m;
+    EXPECT_EQ(cm.find_overlap(4)->second, 1);
+  }
+
+  /**
+   * @test  find_overlap / count_overlaps after random inserts, erases and
+   *  compactions
+   * @brief checked against a scan, and the tree against its invariants.
+   */
+  SUBTEST(overlap) {
+    checked<interval_map<int, int>> m;
+    std::vector<std::pair<int, int>> model;
+    unsigned seed = 17;
+    for (int i = 0; i < 3000; ++i) {
+      int lo = next_rand(seed) % 1000, hi = lo + next_rand(seed) % 50;
+      if (next_rand(seed) % 3) {
+        m.emplace(lo, hi, i);
+        model.push_back({lo, hi});
+      } else if (!model.empty()) {
+        auto victim = model[next_rand(seed) % model.size()];
+        auto it = m.find({victim.first, victim.second});
+        ASSERT_TRUE(it != m.end());
+        m.erase(it);
+        model.erase(std::find(model.begin(), model.end(), victim));
+      }
+      // the folds point at elements, which compact moves.
+      if (i % 500 == 250) {
+        m.compact();
+        ASSERT_TRUE(m.verify());
+      }
+      int qlo = next_rand(seed) % 1100 - 50, qhi = qlo + next_rand(seed) % 20;
+      size_t n = 0;
+      std::pair<int, int> first(1 << 30, 1 << 30);
+      for (auto& iv : model) {
+        if (iv.second >= qlo && iv.first <= qhi) {
+          ++n;
+          first = std::min(first, iv);
+        }
+      }
+      ASSERT_EQ(m.count_overlaps(qlo, qhi), n);
+      auto it = m.find_overlap(qlo, qhi);
+      if (n == 0) {
+        EXPECT_TRUE(it == m.end());
+      } else {
+        ASSERT_TRUE(it != m.end());
+        EXPECT_EQ(it->first.first, first.first);
+        EXPECT_EQ(it->first.second, first.second);
+      }
+    }
+    EXPECT_TRUE(m.verify());
+    EXPECT_EQ(m.size(), model.size());
+  }
+}
@@ -0,0 +1,142 @@
+#include <ostream>
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+#include "intrusive_forward_list.h"
+
+using namespace tinySTL;
+
+namespace {
+
+struct item {
+  int value;
+  int id;
+  slist_hook hook;
+  slist_hook free_hook;
+
+  item(int v = 0, int i = 0) : value(v), id(i) {}
+
+  friend bool operator<(const item& a, const item& b)
+    { return a.value < b.value; }
+
+  friend bool operator==(const item& a, const item& b)
+    { return a.value == b.value; }
+
+  friend std::ostream& operator<<(std::ostream& os, const item& x)
+    { return os << x.value; }
+};
+
+typedef intrusive_forward_list<item, &item::hook> item_list;
+typedef intrusive_forward_list<item, &item::free_hook> free_list;
+
+}
+
+TEST(intrusive_forward_list, modifiers) {
+  /**
+   * @test  push_front / pop_front / insert_after / erase_after
+   * @brief values are linked, not copied.
+   */
+  SUBTEST(modifiers) {
+    item v[4] = {0, 1, 2, 3};
+    item_list l;
+    EXPECT_STRING_EQ(l, []);
+    l.push_front(v[2]);
+    l.push_front(v[0]);
+    l.insert_after(l.begin(), v[1]);
+    l.insert_after(l.iterator_to(v[2]), v[3]);
+    EXPECT_STRING_EQ(l, [0, 1, 2, 3]);
+    EXPECT_EQ(&l.front(), &v[0]);
+    v[1].value = 10;
+    EXPECT_STRING_EQ(l, [0, 10, 2, 3]);
+    l.erase_after(l.begin());
+    EXPECT_STRING_EQ(l, [0, 2, 3]);
+    l.pop_front();
+    EXPECT_STRING_EQ(l, [2, 3]);
+    l.erase_after(l.before_begin(), l.end());
+    EXPECT_TRUE(l.empty());
+  }
+
+  /**
+   * @test  one value in two lists
+   * @brief every hook links the value into a different list.
+   */
+  SUBTEST(modifiers) {
+    item v[4] = {0, 1, 2, 3};
+    item_list all(v, v + 4);
+    free_list odd;
+    for (auto& x : all)
+      if (x.value % 2) odd.push_front(x);
+    EXPECT_STRING_EQ(all, [0, 1, 2, 3]);
+    EXPECT_STRING_EQ(odd, [3, 1]);
+    odd.clear();
+    EXPECT_STRING_EQ(all, [0, 1, 2, 3]);
+  }
+
+  /**
+   * @test  swap / move
+   */
+  SUBTEST(modifiers) {
+    item v[3] = {0, 1, 2};
+    item_list l1(v, v + 2), l2(v + 2, v + 3);
+    l1.swap(l2);
+    EXPECT_STRING_EQ(l1, [2]);
+    EXPECT_STRING_EQ(l2, [0, 1]);
+    item_list l3(tinySTL::move(l2));
+    EXPECT_STRING_EQ(l2, []);
+    EXPECT_STRING_EQ(l3, [0, 1]);
+  }
+}
+
+TEST(intrusive_forward_list, operations) {
+  /**
+   * @test  splice_after
+   * @brief move whole list, one node, and a range.
+   */
+  SUBTEST(operations) {
+    item v[6] = {0, 1, 2, 3, 4, 5};
+    item_list l1(v, v + 3), l2(v + 3, v + 6);
+    l1.splice_after(l1.iterator_to(v[2]), l2);
+    EXPECT_STRING_EQ(l1, [0, 1, 2, 3, 4, 5]);
+    EXPECT_TRUE(l2.empty());
+    l2.splice_after(l2.before_begin(), l1, l1.iterator_to(v[3]));
+    EXPECT_STRING_EQ(l1, [0, 1, 2, 3, 5]);
+    EXPECT_STRING_EQ(l2, [4]);
+    l2.splice_after(l2.begin(), l1, l1.before_begin(), l1.iterator_to(v[3]));
+    EXPECT_STRING_EQ(l1, [3, 5]);
+    EXPECT_STRING_EQ(l2, [4, 0, 1, 2]);
+  }
+
+  /**
+   * @test  merge / reverse / unique / remove_if / sort
+   */
+  SUBTEST(operations) {
+    item v[7] = {1, 3, 5, 2, 3, 4, 6};
+    item_list l1(v, v + 3), l2(v + 3, v + 7);
+    l1.merge(l2);
+    EXPECT_STRING_EQ(l1, [1, 2, 3, 3, 4, 5, 6]);
+    EXPECT_TRUE(l2.empty());
+    EXPECT_EQ(l1.unique(), 1);
+    l1.reverse();
+    EXPECT_STRING_EQ(l1, [6, 5, 4, 3, 2, 1]);
+    EXPECT_EQ(l1.remove_if([](const item& x) { return x.value % 2 == 0; }), 3);
+    EXPECT_STRING_EQ(l1, [5, 3, 1]);
+    l1.sort();
+    EXPECT_STRING_EQ(l1, [1, 3, 5]);
+  }
+
+  SUBTEST(operations) {
+    item v[6] = {{2, 0}, {1, 1}, {2, 2}, {0, 3}, {1, 4}, {0, 5}};
+    item_list l(v, v + 6);
+    l.sort();
+    EXPECT_STRING_EQ(l, [0, 0, 1, 1, 2, 2]);
+    int ids[6], i = 0;
+    for (auto& x : l) ids[i++] = x.id;
+    EXPECT_EQ(ids[0], 3);
+    EXPECT_EQ(ids[1], 5);
+    EXPECT_EQ(ids[2], 1);
+    EXPECT_EQ(ids[3], 4);
+    EXPECT_EQ(ids[4], 0);
+    EXPECT_EQ(ids[5], 2);
+  }
+}
@@ -0,0 +1,210 @@
+#include <ostream>
+#include <vector>
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+#include "intrusive_list.h"
+
+using namespace tinySTL;
+
+namespace {
+
+struct item {
+  int value;
+  int id;
+  list_hook by_order;
+  list_hook by_group;
+
+  item(int v = 0, int i = 0) : value(v), id(i) {}
+
+  friend bool operator<(const item& a, const item& b)
+    { return a.value < b.value; }
+
+  friend bool operator==(const item& a, const item& b)
+    { return a.value == b.value; }
+
+  friend std::ostream& operator<<(std::ostream& os, const item& x)
+    { return os << x.value; }
+};
+
+typedef intrusive_list<item, &item::by_order> order_list;
+typedef intrusive_list<item, &item::by_group> group_list;
+
+}
+
+TEST(intrusive_list, modifiers) {
+  /**
+   * @test  push_back / push_front / pop_back / pop_front
+   * @brief values are linked, not copied.
+   */
+  SUBTEST(modifiers) {
+    item a(1), b(2), c(3);
+    order_list l;
+    EXPECT_STRING_EQ(l, []);
+    l.push_back(b);
+    l.push_back(c);
+    l.push_front(a);
+    EXPECT_STRING_EQ(l, [1, 2, 3]);
+    EXPECT_EQ(l.size(), 3);
+    EXPECT_EQ(&l.front(), &a);
+    EXPECT_EQ(&l.back(), &c);
+    EXPECT_TRUE(a.by_order.is_linked());
+    EXPECT_FALSE(a.by_group.is_linked());
+    b.value = 20;
+    EXPECT_STRING_EQ(l, [1, 20, 3]);
+    l.pop_front();
+    l.pop_back();
+    EXPECT_STRING_EQ(l, [20]);
+    EXPECT_FALSE(a.by_order.is_linked());
+    EXPECT_FALSE(c.by_order.is_linked());
+  }
+
+  /**
+   * @test  insert / erase / iterator_to
+   * @brief a value is found from its reference in O(1).
+   */
+  SUBTEST(modifiers) {
+    item v[5] = {0, 1, 2, 3, 4};
+    order_list l(v, v + 5);
+    EXPECT_STRING_EQ(l, [0, 1, 2, 3, 4]);
+    auto it = l.erase(l.iterator_to(v[2]));
+    EXPECT_EQ(&*it, &v[3]);
+    EXPECT_FALSE(v[2].by_order.is_linked());
+    l.insert(l.begin(), v[2]);
+    EXPECT_STRING_EQ(l, [2, 0, 1, 3, 4]);
+    l.erase(++l.begin(), --l.end());
+    EXPECT_STRING_EQ(l, [2, 4]);
+    l.clear();
+    EXPECT_TRUE(l.empty());
+    for (auto& x : v)
+      EXPECT_FALSE(x.by_order.is_linked());
+  }
+
+  /**
+   * @test  one value in two lists
+   * @brief every hook links the value into a different list.
+   */
+  SUBTEST(modifiers) {
+    item v[6] = {{0, 0}, {1, 1}, {2, 0}, {3, 1}, {4, 0}, {5, 1}};
+    order_list all(v, v + 6);
+    group_list even, odd;
+    for (auto& x : all)
+      (x.id == 0 ? even : odd).push_front(x);
+    EXPECT_STRING_EQ(all, [0, 1, 2, 3, 4, 5]);
+    EXPECT_STRING_EQ(even, [4, 2, 0]);
+    EXPECT_STRING_EQ(odd, [5, 3, 1]);
+    all.erase(all.iterator_to(v[3]));
+    EXPECT_STRING_EQ(all, [0, 1, 2, 4, 5]);
+    EXPECT_STRING_EQ(odd, [5, 3, 1]);
+  }
+
+  /**
+   * @test  copy of a linked value
+   * @brief the copy is not linked.
+   */
+  SUBTEST(modifiers) {
+    item a(1);
+    order_list l;
+    l.push_back(a);
+    item b(a);
+    EXPECT_FALSE(b.by_order.is_linked());
+    b = a;
+    EXPECT_FALSE(b.by_order.is_linked());
+    EXPECT_STRING_EQ(l, [1]);
+  }
+
+  /**
+   * @test  swap / move
+   * @brief the headers exchange their nodes.
+   */
+  SUBTEST(modifiers) {
+    item v[4] = {0, 1, 2, 3};
+    order_list l1(v, v + 3), l2(v + 3, v + 4);
+    l1.swap(l2);
+    EXPECT_STRING_EQ(l1, [3]);
+    EXPECT_STRING_EQ(l2, [0, 1, 2]);
+    order_list l3(tinySTL::move(l2));
+    EXPECT_STRING_EQ(l2, []);
+    EXPECT_STRING_EQ(l3, [0, 1, 2]);
+    l1 = tinySTL::move(l3);
+    EXPECT_STRING_EQ(l1, [0, 1, 2]);
+    EXPECT_FALSE(v[3].by_order.is_linked());
+  }
+}
+
+TEST(intrusive_list, operations) {
+  /**
+   * @test  splice
+   * @brief move whole list, one node, and a range.
+   */
+  SUBTEST(operations) {
+    item v[6] = {0, 1, 2, 3, 4, 5};
+    order_list l1(v, v + 3), l2(v + 3, v + 6);
+    l1.splice(l1.end(), l2);
+    EXPECT_STRING_EQ(l1, [0, 1, 2, 3, 4, 5]);
+    EXPECT_TRUE(l2.empty());
+    l2.splice(l2.begin(), l1, l1.iterator_to(v[4]));
+    EXPECT_STRING_EQ(l1, [0, 1, 2, 3, 5]);
+    EXPECT_STRING_EQ(l2, [4]);
+    l2.splice(l2.end(), l1, l1.begin(), l1.iterator_to(v[3]));
+    EXPECT_STRING_EQ(l1, [3, 5]);
+    EXPECT_STRING_EQ(l2, [4, 0, 1, 2]);
+    EXPECT_EQ(l1.size(), 2);
+    EXPECT_EQ(l2.size(), 4);
+  }
+
+  /**
+   * @test  merge / reverse / unique / remove_if
+   */
+  SUBTEST(operations) {
+    item v[7] = {1, 3, 5, 2, 3, 4, 6};
+    order_list l1(v, v + 3), l2(v + 3, v + 7);
+    l1.merge(l2);
+    EXPECT_STRING_EQ(l1, [1, 2, 3, 3, 4, 5, 6]);
+    EXPECT_EQ(l1.size(), 7);
+    EXPECT_TRUE(l2.empty());
+    EXPECT_EQ(l1.unique(), 1);
+    EXPECT_FALSE(v[4].by_order.is_linked());
+    l1.reverse();
+    EXPECT_STRING_EQ(l1, [6, 5, 4, 3, 2, 1]);
+    l1.remove_if([](const item& x) { return x.value % 2 == 0; });
+    EXPECT_STRING_EQ(l1, [5, 3, 1]);
+  }
+
+  /**
+   * @test  sort
+   * @brief a short list is gathered too, and the sort stays stable.
+   */
+  SUBTEST(operations) {
+    item v[5] = {{3, 0}, {1, 1}, {2, 2}, {1, 3}, {0, 4}};
+    order_list l(v, v + 5);
+    l.sort();
+    EXPECT_STRING_EQ(l, [0, 1, 1, 2, 3]);
+    EXPECT_EQ(&*++l.begin(), &v[1]);
+  }
+
+  SUBTEST(operations) {
+    const int n = 5000;
+    std::vector<item> v;
+    v.reserve(n);
+    for (int i = 0; i < n; ++i)
+      v.emplace_back((i * 7919) % 100, i);
+    order_list l(v.begin(), v.end());
+    l.sort();
+    EXPECT_EQ(l.size(), n);
+    const item* pre = 0;
+    for (auto& x : l) {
+      if (pre) {
+        EXPECT_LE(pre->value, x.value);
+        if (pre->value == x.value) {
+          EXPECT_LT(pre->id, x.id);
+        }
+      }
+      pre = &x;
+    }
+    l.sort([](const item& a, const item& b) { return b < a; });
+    EXPECT_EQ(l.front().value, 99);
+    EXPECT_EQ(l.back().value, 0);
+  }
+}
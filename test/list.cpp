@@ -1,12 +1,32 @@
+#include <string>
 #include <vector>
+#include <algorithm>
+#include <stdexcept>
 
 #include <gmock/gmock.h>
 #include <gtest/gtest.h>
 
 #include "list.h"
+#include "test_util.h"
 
 using namespace tinySTL;
 
+namespace {
+
+// how many neighbours in the list are not neighbours in memory.
+template <class _List>
+int scattered(const _List& li) {
+  std::vector<long> steps;
+  for (auto it = li.begin(), next = it; it != li.end() && ++next != li.end(); ++it)
+    steps.push_back((const char*)&*next - (const char*)&*it);
+  if (steps.empty()) return 0;
+  std::sort(steps.begin(), steps.end());
+  long common = steps[steps.size() / 2];
+  return (int)std::count_if(steps.begin(), steps.end(), [common](long d) { return d != common; });
+}
+
+}
+
 TEST(list, constructor) {
   /**
    * @test  list()
@@ -620,6 +640,27 @@ TEST(list, sort) {
     });
     EXPECT_STRING_EQ(li, [9, 8, 7, 6, 5, 4, 3, 2, 1, 0]);
   }
+
+  /**
+   * @test  void sort(_StrictWeakOrdering __comp)
+   * @brief the gather sort is stable.
+   */
+  SUBTEST(sort) {
+    list<std::pair<int, int>> li;
+    for (int i = 0; i < 5000; i++)
+      li.push_back({(i * 7919) % 100, i});
+    li.sort([](const std::pair<int, int>& x, const std::pair<int, int>& y) {
+      return x.first < y.first;
+    });
+    EXPECT_EQ(li.size(), 5000);
+    auto pre = li.begin();
+    for (auto it = ++li.begin(); it != li.end(); ++pre, ++it) {
+      EXPECT_TRUE(pre->first < it->first 
+        || (pre->first == it->first && pre->second < it->second));
+    }
+    EXPECT_EQ(&*(--li.end()), &li.back());
+    EXPECT_EQ((--li.end())->first, 99);
+  }
 }
 
 TEST(list, emplace_front) {
@@ -628,4 +669,51 @@ TEST(list, emplace_front) {
   EXPECT_STRING_EQ(li, [1]);
   li.emplace_front(11);
   EXPECT_STRING_EQ(li, [11, 1]);
-}
\ No newline at end of file
+}
+
+TEST(list, compact) {
+  /**
+   * @test  void compact()
+   * @brief the elements keep their order and end up in consecutive nodes.
+   */
+  SUBTEST(compact) {
+    list<std::string> li;
+    list<int> other;
+    for (int i = 0; i < 1000; i++) {
+      li.push_back(std::to_string(i));
+      other.push_back(i);
+      if (i % 3 == 0) li.push_front(std::to_string(-i));
+    }
+    std::vector<std::string> before(li.begin(), li.end());
+    EXPECT_GT(scattered(li), 100);
+    li.compact();
+    EXPECT_EQ(li.size(), before.size());
+    EXPECT_TRUE(std::equal(li.begin(), li.end(), before.begin(), before.end()));
+    EXPECT_LE(scattered(li), 1);
+    EXPECT_EQ(li.back(), "999");
+    li.pop_front();
+    li.push_back("x");
+    EXPECT_EQ(li.back(), "x");
+    list<int> empty;
+    empty.compact();
+    EXPECT_TRUE(empty.empty());
+  }
+
+  /**
+   * @test  void compact()
+   * @brief elements that cannot be moved without throwing are copied, and
+   *  a copy that throws leaves the list as it was.
+   */
+  SUBTEST(compact) {
+    list<fragile> li;
+    for (int i = 0; i < 100; i++) li.emplace_back(i);
+    std::vector<fragile> before(li.begin(), li.end());
+    fragile::budget = 50;
+    EXPECT_THROW(li.compact(), std::runtime_error);
+    fragile::budget = -1;
+    EXPECT_EQ(li.size(), 100);
+    EXPECT_TRUE(std::equal(li.begin(), li.end(), before.begin(), before.end()));
+    li.compact();
+    EXPECT_TRUE(std::equal(li.begin(), li.end(), before.begin(), before.end()));
+  }
+}
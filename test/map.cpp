@@ -1,3 +1,6 @@
+#include <memory>
+#include <string>
+#include <string_view>
 #include <vector>
 
 #include <gmock/gmock.h>
@@ -5,9 +8,44 @@
 
 #include "map.h"
 #include "list.h"
+#include "test_util.h"
 
 using namespace tinySTL;
 
+namespace {
+
+// a value that counts how often one is built.
+struct counted_value {
+  static int made;
+  int v;
+  counted_value(int x = 0) : v(x) { ++made; }
+  counted_value(const counted_value& x) : v(x.v) { ++made; }
+  counted_value(counted_value&& x) : v(x.v) { ++made; }
+  counted_value& operator=(const counted_value&) = default;
+};
+
+int counted_value::made = 0;
+
+// whether a value can be written through operator[] or an iterator.
+template <class _Map>
+concept writable_by_index = requires(_Map& m) { m[0] = 1; };
+
+template <class _Map>
+concept writable_by_iterator = requires(_Map& m) { m.begin()->second = 1; };
+
+// whether a pair is built implicitly from two ints, as in return {1, 2}.
+template <class _Pair>
+concept implicit_from_ints = requires(void (*f)(_Pair)) { f({1, 2}); };
+
+// a key that can only be moved.
+struct move_only_key {
+  std::unique_ptr<int> p;
+  explicit move_only_key(int x) : p(new int(x)) {}
+  friend bool operator<(const move_only_key& a, const move_only_key& b) { return *a.p < *b.p; }
+};
+
+}
+
 TEST(map, constructor) {
   /**
    * @test  map()
@@ -227,6 +265,129 @@ TEST(map, emplace_hint) {
   EXPECT_STRING_EQ(m, [{1, Hello}, {2, World}]);
 }
 
+TEST(map, try_emplace) {
+  /**
+   * @test  try_emplace(key, args...)
+   * @brief the value is built once in the node, and not at all when the
+   *  key is present; a moved key is left alone then.
+   */
+  SUBTEST(try_emplace) {
+    map<std::string, counted_value> m;
+    counted_value::made = 0;
+    auto [it, ok] = m.try_emplace("a", 1);
+    EXPECT_TRUE(ok);
+    EXPECT_EQ(it->second.v, 1);
+    EXPECT_EQ(counted_value::made, 1);
+    std::string k = "a";
+    auto r = m.try_emplace(tinySTL::move(k), 2);
+    EXPECT_FALSE(r.second);
+    EXPECT_EQ(r.first->second.v, 1);
+    EXPECT_EQ(k, "a");
+    EXPECT_EQ(counted_value::made, 1);
+    m.try_emplace(tinySTL::move(k), 3);
+    EXPECT_EQ(m.size(), 1);
+  }
+
+  /**
+   * @test  try_emplace(hint, key, args...)
+   */
+  SUBTEST(try_emplace) {
+    map<int, std::string> m;
+    auto it = m.try_emplace(m.end(), 5, 3, 'x');
+    it = m.try_emplace(it, 1, "one");
+    it = m.try_emplace(m.end(), 9, "nine");
+    it = m.try_emplace(m.begin(), 5, "five");
+    EXPECT_EQ(it->second, "xxx");
+    m.try_emplace(m.find(9), 7, "seven");
+    EXPECT_STRING_EQ(m, [{1, one}, {5, xxx}, {7, seven}, {9, nine}]);
+  }
+
+  /**
+   * @test  move-only keys and values
+   */
+  SUBTEST(try_emplace) {
+    map<move_only_key, std::unique_ptr<int>> m;
+    m.try_emplace(move_only_key(2), new int(20));
+    m.try_emplace(move_only_key(1), new int(10));
+    m.emplace(move_only_key(3), std::make_unique<int>(30));
+    m[move_only_key(4)] = std::make_unique<int>(40);
+    EXPECT_EQ(m.size(), 4);
+    int expect = 1;
+    for (auto& p : m) {
+      EXPECT_EQ(*p.first.p, expect);
+      EXPECT_EQ(*p.second, expect * 10);
+      ++expect;
+    }
+  }
+
+  /**
+   * @test  pair(U1&&, U2&&)
+   * @brief offered only when both members can be built from the
+   *  arguments, and explicit when one of them converts only explicitly.
+   */
+  SUBTEST(try_emplace) {
+    static_assert(is_constructible_v<pair<move_only_key, int>, int, int>);
+    static_assert(!implicit_from_ints<pair<move_only_key, int>>);
+    static_assert(!implicit_from_ints<pair<long, std::unique_ptr<int>>>);
+    static_assert(implicit_from_ints<pair<long, double>>);
+    static_assert(!is_constructible_v<pair<int, int>, std::string, int>);
+    pair<move_only_key, int> p(7, 1);
+    EXPECT_EQ(*p.first.p, 7);
+  }
+}
+
+TEST(map, insert_or_assign) {
+  /**
+   * @test  insert_or_assign(key, obj) / insert_or_assign(hint, key, obj)
+   */
+  SUBTEST(insert_or_assign) {
+    map<std::string, counted_value> m;
+    counted_value::made = 0;
+    EXPECT_TRUE(m.insert_or_assign("a", counted_value(1)).second);
+    EXPECT_EQ(counted_value::made, 2);
+    auto r = m.insert_or_assign("a", counted_value(2));
+    EXPECT_FALSE(r.second);
+    EXPECT_EQ(r.first->second.v, 2);
+    EXPECT_EQ(counted_value::made, 3);
+    auto it = m.insert_or_assign(m.end(), "b", 3);
+    EXPECT_EQ(it->second.v, 3);
+    it = m.insert_or_assign(m.begin(), "b", 4);
+    EXPECT_EQ(it->second.v, 4);
+    EXPECT_EQ(m.size(), 2);
+  }
+}
+
+TEST(map, emplace_unique) {
+  /**
+   * @test  emplace(key, mapped) / emplace(value_type)
+   * @brief with the key at hand nothing is built for a present key.
+   */
+  SUBTEST(emplace_unique) {
+    map<int, counted_value> m;
+    m.emplace(1, 1);
+    counted_value::made = 0;
+    EXPECT_FALSE(m.emplace(1, 2).second);
+    EXPECT_FALSE(m.emplace(pair<const int, counted_value>(1, 2)).second);
+    EXPECT_EQ(counted_value::made, 1);
+    EXPECT_EQ(m.at(1).v, 1);
+    EXPECT_TRUE(m.emplace_hint(m.end(), 2, 2)->second.v == 2);
+    EXPECT_EQ(m.emplace_hint(m.end(), 2, 3)->second.v, 2);
+  }
+
+  /**
+   * @test  emplace(args...)
+   * @brief other arguments build the node first, dropped for a present key.
+   */
+  SUBTEST(emplace_unique) {
+    map<std::string, int> m;
+    EXPECT_TRUE(m.emplace(std::piecewise_construct, std::forward_as_tuple(3, 'a'),
+                          std::forward_as_tuple(1)).second);
+    EXPECT_FALSE(m.emplace("aaa", 2).second);
+    EXPECT_TRUE(m.emplace(pair<std::string, int>("b", 2)).second);
+    EXPECT_STRING_EQ(m, [{aaa, 1}, {b, 2}]);
+  }
+}
+
 TEST(map, insert) {
   /**
    * @test  tinySTL::pair<iterator, bool> insert(const value_type& __x)
@@ -418,6 +579,230 @@ TEST(map, equal_range) {
   EXPECT_EQ(++l2, r2);
 }
 
+TEST(map, transparent_lookup) {
+  /**
+   * @test  find / count / contains / lower_bound / upper_bound / equal_range
+   * @brief with less<> a string_view looks up std::string keys directly.
+   */
+  SUBTEST(transparent_lookup) {
+    map<std::string, int, less<>> m {{"apple", 1}, {"banana", 2}, {"cherry", 3}};
+    std::string_view k = "banana";
+    EXPECT_EQ(m.find(k)->second, 2);
+    EXPECT_EQ(m.find(std::string_view("kiwi")), m.end());
+    EXPECT_EQ(m.count(k), 1);
+    EXPECT_TRUE(m.contains("cherry"));
+    EXPECT_EQ(m.lower_bound(std::string_view("b"))->first, "banana");
+    EXPECT_EQ(m.upper_bound(k)->first, "cherry");
+    auto [l, r] = m.equal_range(k);
+    EXPECT_EQ(l->first, "banana");
+    EXPECT_EQ(++l, r);
+    const auto& cm = m;
+    EXPECT_EQ(cm.find(k)->second, 2);
+  }
+
+  /**
+   * @test  multimap count / equal_range
+   */
+  SUBTEST(transparent_lookup) {
+    multimap<std::string, int, less<>> m {{"a", 1}, {"b", 2}, {"b", 3}, {"c", 4}};
+    EXPECT_EQ(m.count(std::string_view("b")), 2);
+    auto [l, r] = m.equal_range(std::string_view("b"));
+    EXPECT_EQ(tinySTL::distance(l, r), 2);
+    EXPECT_EQ(m.find(std::string_view("c"))->second, 4);
+  }
+}
+
+TEST(map, augmented) {
+  /**
+   * @test  fold on augmented_map with mapped_sum
+   * @brief insert_or_assign and node handles keep the range sums.
+   */
+  SUBTEST(augmented) {
+    checked<augmented_map<int, int, mapped_sum<int, int>>> m;
+    for (int i = 0; i < 100; ++i) m.insert({i, 1});
+    EXPECT_EQ(m.fold(), 100);
+    EXPECT_EQ(m.fold(10, 20), 10);
+    m.insert_or_assign(15, 100);
+    m.insert_or_assign(m.end(), 16, 100);
+    EXPECT_EQ(m.fold(10, 20), 208);
+    EXPECT_TRUE(m.verify());
+    auto nh = m.extract(15);
+    EXPECT_EQ(m.fold(10, 20), 108);
+    nh.key() = 500;
+    m.insert(tinySTL::move(nh));
+    EXPECT_EQ(m.fold(100, 1000), 100);
+    EXPECT_EQ(m.fold(), 298);
+    m.erase(m.find(16));
+    EXPECT_EQ(m.fold(), 198);
+    EXPECT_TRUE(m.verify());
+  }
+
+  /**
+   * @test  augmented_map(const augmented_map&)
+   * @brief the copy's folds are rebuilt as it is made.
+   */
+  SUBTEST(augmented) {
+    checked<augmented_map<int, int, mapped_sum<int, int>>> m;
+    for (int i = 0; i < 5000; ++i) m.insert({i * 3 % 5000, i % 7});
+    checked<augmented_map<int, int, mapped_sum<int, int>>> c(m);
+    EXPECT_TRUE(c.verify());
+    EXPECT_EQ(c.fold(), m.fold());
+    EXPECT_EQ(c.fold(1000, 2500), m.fold(1000, 2500));
+  }
+
+  /**
+   * @test  fold after every way of writing a value
+   * @brief operator[] and writes through iterators are not offered, the
+   *  folds agree with a scan after insert_or_assign and update.
+   */
+  SUBTEST(augmented) {
+    static_assert(writable_by_index<map<int, int>> && writable_by_iterator<map<int, int>>);
+    typedef checked<augmented_map<int, int, mapped_sum<int, int>>> sum_map;
+    static_assert(!writable_by_index<sum_map> && !writable_by_iterator<sum_map>);
+    sum_map m;
+    auto scan = [&m](int lo, int hi) {
+      int sum = 0;
+      for (auto& p : m) {
+        if (lo <= p.first && p.first < hi) sum += p.second;
+      }
+      return sum;
+    };
+    for (int i = 0; i < 10; ++i) m.insert_or_assign(i, i);
+    EXPECT_EQ(m.fold(), scan(0, 10));
+    EXPECT_EQ(m.fold(), 45);
+    for (int i = 0; i < 200; ++i) m.insert_or_assign(i * 7 % 100, i);
+    EXPECT_EQ(m.fold(), scan(0, 100));
+    EXPECT_TRUE(m.update(3, [](int& v) { v = 100; }));
+    EXPECT_FALSE(m.update(1000, [](int& v) { v = 100; }));
+    EXPECT_EQ(m.at(3), 100);
+    EXPECT_EQ(m.fold(0, 10), scan(0, 10));
+    EXPECT_EQ(m.fold(), scan(0, 100));
+    for (int i = 0; i < 100; i += 3) m.update(i, [](int& v) { v *= 2; });
+    EXPECT_EQ(m.fold(20, 60), scan(20, 60));
+    EXPECT_EQ(m.fold(), scan(0, 100));
+    EXPECT_TRUE(m.verify());
+  }
+}
+
+TEST(map, compact) {
+  /**
+   * @test  void compact()
+   * @brief the tree keeps its shape and contents, folds included, and
+   *  its nodes end up in key order in memory.
+   */
+  SUBTEST(compact) {
+    typedef pair<const int, std::string> value;
+    // sums the keys.
+    checked<augmented_map<int, std::string, range_sum<value, long, _Select1st<value>>>> m;
+    map<int, int> other;
+    for (int i = 0; i < 3000; ++i) {
+      m.emplace(i * 7 % 3000, std::to_string(i));
+      other.emplace(i, i);
+    }
+    for (int i = 0; i < 3000; i += 4) m.erase(i);
+    std::vector<std::pair<int, std::string>> before;
+    for (auto& p : m) before.emplace_back(p.first, p.second);
+    long sum = m.fold(100, 2000);
+    m.compact();
+    EXPECT_TRUE(m.verify());
+    EXPECT_EQ(m.fold(100, 2000), sum);
+    ASSERT_EQ(m.size(), before.size());
+    size_t i = 0, scattered = 0;
+    const void* prev = nullptr;
+    long step = 0;
+    for (auto& p : m) {
+      EXPECT_EQ(p.first, before[i].first);
+      EXPECT_EQ(p.second, before[i].second);
+      if (prev != nullptr) {
+        long d = (const char*)&p - (const char*)prev;
+        if (step == 0) step = d;
+        else if (d != step) ++scattered;
+      }
+      prev = &p;
+      ++i;
+    }
+    EXPECT_LE(scattered, 1);
+    m.emplace(-1, "x");
+    EXPECT_TRUE(m.verify());
+  }
+}
+
+TEST(map, for_each_in_range) {
+  /**
+   * @test  for_each_in_range(lo, hi, f)
+   * @brief the same elements, in the same order, as a loop from
+   *  lower_bound(lo) to lower_bound(hi), including bounds that are not
+   *  keys and empty ranges; values can be changed through it.
+   */
+  SUBTEST(for_each_in_range) {
+    map<int, int> m;
+    multimap<int, int> mm;
+    for (int i = 0; i < 5000; ++i) {
+      m.emplace(i * 37 % 5000 * 2, i);
+      mm.emplace(i % 300, i);
+    }
+    for (auto [lo, hi] : {std::pair{-5, 20000}, std::pair{101, 101}, std::pair{100, 100},
+                          std::pair{3, 4001}, std::pair{9998, 9998}, std::pair{9999, 20000}}) {
+      std::vector<int> got, want;
+      m.for_each_in_range(lo, hi, [&](const pair<const int, int>& p) { got.push_back(p.first); });
+      for (auto it = m.lower_bound(lo); it != m.lower_bound(hi); ++it) want.push_back(it->first);
+      EXPECT_EQ(got, want);
+    }
+    size_t n = 0;
+    mm.for_each_in_range(10, 12, [&](auto&) { ++n; });
+    EXPECT_EQ(n, mm.count(10) + mm.count(11));
+    m.for_each_in_range(0, 100, [](pair<const int, int>& p) { p.second = -1; });
+    EXPECT_EQ(m.at(98), -1);
+    EXPECT_NE(m.at(100), -1);
+    const map<int, int>& c = m;
+    int count = 0;
+    c.for_each_in_range(0, 100, [&](auto& p) { count += p.second; });
+    EXPECT_EQ(count, -50);
+    m.for_each_in_range(50, 10, [](auto&) { FAIL(); });
+    map<int, int> empty;
+    empty.for_each_in_range(0, 1, [](auto&) { FAIL(); });
+  }
+}
+
+TEST(map, node_handle) {
+  /**
+   * @test  extract / key() / mapped() / insert(node_type&&)
+   * @brief a node is re-keyed in place and moved between maps.
+   */
+  SUBTEST(node_handle) {
+    map<int, std::string> a {{1, "one"}, {2, "two"}}, b;
+    const std::string* p = &a.find(1)->second;
+    auto nh = a.extract(1);
+    nh.key() = 10;
+    nh.mapped() += "!";
+    auto r = b.insert(tinySTL::move(nh));
+    EXPECT_TRUE(r.inserted);
+    EXPECT_EQ(&r.position->second, p);
+    EXPECT_STRING_EQ(b, [{10, one!}]);
+    auto nh2 = a.extract(a.begin());
+    nh2.key() = 10;
+    r = b.insert(tinySTL::move(nh2));
+    EXPECT_FALSE(r.inserted);
+    EXPECT_EQ(r.node.mapped(), "two");
+    EXPECT_TRUE(a.empty());
+  }
+
+  /**
+   * @test  multimap extract / insert(hint, node_type&&)
+   */
+  SUBTEST(node_handle) {
+    multimap<int, int> m {{1, 1}, {1, 2}, {2, 3}};
+    auto nh = m.extract(1);
+    EXPECT_EQ(nh.mapped(), 1);
+    m.insert(m.end(), tinySTL::move(nh));
+    EXPECT_STRING_EQ(m, [{1, 2}, {1, 1}, {2, 3}]);
+    nh = m.extract(m.find(2));
+    nh.key() = 0;
+    m.insert(tinySTL::move(nh));
+    EXPECT_STRING_EQ(m, [{0, 3}, {1, 2}, {1, 1}]);
+  }
+}
+
 TEST(map, disp) {
   map<int, int> m;
   m.disp(std::cout);
@@ -538,6 +923,37 @@ TEST(map, merge) {
   }
 }
 
+TEST(map, set_operations) {
+  /**
+   * @test  merge / intersect / subtract / split / join
+   * @brief the elements of *this keep their values.
+   */
+  SUBTEST(set_operations) {
+    map<int, std::string> m = {{1, "a"}, {2, "b"}, {3, "c"}, {4, "d"}};
+    map<int, std::string> other = {{0, "x"}, {2, "y"}, {4, "z"}};
+    m.merge(other);
+    EXPECT_STRING_EQ(m, [{0, x}, {1, a}, {2, b}, {3, c}, {4, d}]);
+    EXPECT_STRING_EQ(other, [{2, y}, {4, z}]);
+    m.intersect(tinySTL::move(other));
+    EXPECT_STRING_EQ(m, [{2, b}, {4, d}]);
+    EXPECT_TRUE(other.empty());
+    m.subtract(map<int, std::string>{{4, "w"}});
+    EXPECT_STRING_EQ(m, [{2, b}]);
+
+    map<int, std::string> big;
+    for (int i = 0; i < 1000; ++i) big.emplace(i, std::to_string(i));
+    map<int, std::string> hi = big.split(600);
+    EXPECT_EQ(big.size(), 600);
+    EXPECT_EQ(hi.size(), 400);
+    EXPECT_EQ(hi.begin()->second, "600");
+    hi.erase(hi.find(650), hi.find(950));
+    big.join(tinySTL::move(hi));
+    EXPECT_EQ(big.size(), 700);
+    EXPECT_EQ(big.at(999), "999");
+    EXPECT_TRUE(big.find(700) == big.end());
+  }
+}
+
 TEST(map, compare_operator) {
   map<int, int> m1 = {{1,1}, {4,4}, {2,2}, {5,5}, {0,0}};
   map<int, int> m2 = {{1,1}, {4,4}, {2,2}, {0,0}};
@@ -5,6 +5,7 @@
 
 #include "map.h"
 #include "list.h"
+#include "test_util.h"
 
 using namespace tinySTL;
 
@@ -49,7 +50,7 @@ TEST(multimap, constructor) {
    */
   SUBTEST(constructor) {
     multimap<int, std::string> m {{1, "Hello"}, {1, "World"}, {2, "STL"}};
-    EXPECT_STRING_EQ(m, [{1, World}, {1, Hello}, {2, STL}]);
+    EXPECT_STRING_EQ(m, [{1, Hello}, {1, World}, {2, STL}]);
   }
 
   /**
@@ -537,6 +538,37 @@ TEST(multimap, merge) {
   }
 }
 
+TEST(multimap, split_join) {
+  /**
+   * @test  multimap split(const key_type& __x) / void join(multimap&& __x)
+   * @brief equal keys stay together on the right and keep their order.
+   */
+  SUBTEST(split_join) {
+    multimap<int, int> m;
+    for (int i = 0; i < 400; ++i) m.insert({i % 10, i});
+    multimap<int, int> hi = m.split(5);
+    EXPECT_EQ(m.size(), 200);
+    EXPECT_EQ(hi.size(), 200);
+    EXPECT_EQ(hi.count(5), 40);
+    EXPECT_EQ(hi.begin()->second, 5);
+    multimap<int, int> bad = {{4, 0}};
+    EXPECT_THROW(hi.join(tinySTL::move(bad)), std::range_error);
+    multimap<int, int> same = {{9, -1}};
+    hi.join(tinySTL::move(same));
+    EXPECT_EQ((--hi.end())->second, -1);
+    m.join(tinySTL::move(hi));
+    EXPECT_EQ(m.size(), 401);
+    int pre = -1;
+    for (auto it = m.lower_bound(7); it != m.upper_bound(7); ++it) {
+      EXPECT_LT(pre, it->second);
+      pre = it->second;
+    }
+    m.erase(m.lower_bound(2), m.lower_bound(8));
+    EXPECT_EQ(m.size(), 401 - 240);
+    EXPECT_EQ(m.count(8), 40);
+  }
+}
+
 TEST(multimap, compare_operator) {
   multimap<int, int> m1 {{1,1}, {2,2}, {2,2}, {5,5}, {0,0}};
   multimap<int, int> m2 {{1,1}, {2,2}, {2,2}, {0,0}};
@@ -550,4 +582,60 @@ TEST(multimap, compare_operator) {
 TEST(multimap, cout_operator) {
   multimap<int, int> m {{1,1}, {4,4}, {2,2}, {5,5}, {2,2}};
   std::cout << m << std::endl;
-}
\ No newline at end of file
+}
+
+TEST(multimap, ranked) {
+  /**
+   * @test  nth / rank / count / distance on ranked_multimap
+   * @brief subtree sizes stay right through inserts, erases and
+   *  rotations, checked against positions found by walking.
+   */
+  SUBTEST(ranked) {
+    checked<ranked_multimap<int, int>> m;
+    unsigned seed = 1;
+    for (int i = 0; i < 3000; ++i)
+      m.insert({int(next_rand(seed)) % 500, i});
+    for (int i = 0; i < 1000; ++i) {
+      auto it = m.find(int(next_rand(seed)) % 500);
+      if (it != m.end())
+        m.erase(it);
+    }
+    ASSERT_TRUE(m.verify());
+    size_t index = 0;
+    for (auto it = m.begin(); it != m.end(); ++it, ++index) {
+      EXPECT_TRUE(m.nth(index) == it);
+      EXPECT_EQ(tinySTL::distance(m.begin(), it), index);
+    }
+    EXPECT_TRUE(m.nth(m.size()) == m.end());
+    EXPECT_EQ(tinySTL::distance(m.begin(), m.end()), m.size());
+    for (int k = 0; k < 500; k += 7) {
+      EXPECT_EQ(m.rank(k), tinySTL::distance(m.begin(), m.lower_bound(k)));
+      size_t walked = 0;
+      for (auto it = m.lower_bound(k); it != m.upper_bound(k); ++it) ++walked;
+      EXPECT_EQ(m.count(k), walked);
+    }
+  }
+
+  /**
+   * @test  ranked_multimap built from sorted input / copied / merged
+   */
+  SUBTEST(ranked) {
+    std::vector<tinySTL::pair<int, int>> v;
+    for (int i = 0; i < 100; ++i) v.push_back({i / 2, i});
+    checked<ranked_multimap<int, int>> m1;
+    m1.insert(v.begin(), v.end());
+    EXPECT_TRUE(m1.verify());
+    EXPECT_EQ(m1.nth(41)->second, 41);
+    EXPECT_EQ(m1.rank(10), 20);
+    checked<ranked_multimap<int, int>> m2;
+    m2.insert(v.begin(), v.begin() + 10);
+    m1.merge(m2);
+    EXPECT_TRUE(m1.verify());
+    EXPECT_EQ(m1.size(), 110);
+    EXPECT_EQ(m1.count(3), 4);
+    EXPECT_EQ(m1.rank(5), 20);
+    checked<ranked_multimap<int, int>> m3 = m1;
+    EXPECT_TRUE(m3.verify());
+    EXPECT_EQ(m3.nth(109)->first, 49);
+  }
+}
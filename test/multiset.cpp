@@ -6,6 +6,7 @@
 #include "set.h"
 #include "list.h"
 #include "vector.h"
+#include "test_util.h"
 
 using namespace tinySTL;
 
@@ -303,6 +304,30 @@ TEST(multiset, insert) {
   }
 }
 
+TEST(multiset, insert_sorted) {
+  /**
+   * @test  void insert(_InputIterator __first, _InputIterator __last)
+   * @brief sorted input with equal keys is linked in O(n), equal keys
+   *  keep their order.
+   */
+  SUBTEST(insert) {
+    struct by_first {
+      bool operator()(const std::pair<int, int>& a, const std::pair<int, int>& b) const
+      { return a.first < b.first; }
+    };
+    std::vector<std::pair<int, int>> vc;
+    for (int i = 0; i < 1000; ++i)
+      vc.push_back({i / 3, i});
+    checked<multiset<std::pair<int, int>, by_first>> s;
+    s.insert(vc.begin(), vc.end());
+    EXPECT_TRUE(s.verify());
+    EXPECT_TRUE(tinySTL::equal(s.begin(), s.end(), vc.begin()));
+    s.insert(vc.begin(), vc.begin() + 10);
+    EXPECT_EQ(s.size(), 1010);
+    EXPECT_TRUE(s.verify());
+  }
+}
+
 TEST(multiset, erase) {
   /**
    * @test  size_type erase(const key_type& __k) 
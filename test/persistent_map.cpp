@@ -0,0 +1,242 @@
+#include <map>
+#include <string>
+#include <thread>
+#include <vector>
+#include <utility>
+#include <stdexcept>
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+#include "persistent_map.h"
+#include "test_util.h"
+
+using namespace tinySTL;
+
+namespace {
+
+// counts the values alive.
+struct counted {
+  static int alive;
+  int v;
+  counted(int x) : v(x) { ++alive; }
+  counted(const counted& x) : v(x.v) { ++alive; }
+  ~counted() { --alive; }
+};
+
+int counted::alive = 0;
+
+}
+
+TEST(persistent_map, constructor) {
+  /**
+   * @test  persistent_map() / persistent_map(std::initializer_list)
+   */
+  SUBTEST(constructor) {
+    persistent_map<int, std::string> m;
+    EXPECT_TRUE(m.empty());
+    EXPECT_STRING_EQ(m, []);
+    persistent_map<int, std::string> m1 {{2, "world"}, {1, "hello"}, {2, "again"}};
+    EXPECT_STRING_EQ(m1, [{1, hello}, {2, world}]);
+    EXPECT_EQ(m1.size(), 2);
+    EXPECT_EQ(m1.at(1), "hello");
+    EXPECT_EQ(m1[2], "world");
+    EXPECT_THROW(m1.at(3), std::range_error);
+  }
+
+  /**
+   * @test  persistent_map(const persistent_map&) / snapshot
+   * @brief a copy keeps its contents while the original changes.
+   */
+  SUBTEST(constructor) {
+    persistent_map<int, int> m {{1, 1}, {2, 2}, {3, 3}};
+    persistent_map<int, int> s = m.snapshot();
+    persistent_map<int, int> s1(m);
+    m.insert({4, 4});
+    m.erase(1);
+    m.insert_or_assign(2, 20);
+    EXPECT_STRING_EQ(m, [{2, 20}, {3, 3}, {4, 4}]);
+    EXPECT_STRING_EQ(s, [{1, 1}, {2, 2}, {3, 3}]);
+    EXPECT_STRING_EQ(s1, [{1, 1}, {2, 2}, {3, 3}]);
+    s1.erase(3);
+    EXPECT_STRING_EQ(s, [{1, 1}, {2, 2}, {3, 3}]);
+    s = m;
+    EXPECT_STRING_EQ(s, [{2, 20}, {3, 3}, {4, 4}]);
+    persistent_map<int, int> moved(std::move(s));
+    EXPECT_EQ(moved.size(), 3);
+  }
+
+  /**
+   * @test  ~persistent_map
+   * @brief a version is freed with the last map holding it, and nodes
+   *  shared with a live version are not.
+   */
+  SUBTEST(constructor) {
+    {
+      persistent_map<int, counted> m;
+      for (int i = 0; i < 100; ++i) m.emplace(i, i);
+      EXPECT_EQ(counted::alive, 100);
+      {
+        persistent_map<int, counted> s = m;
+        EXPECT_EQ(counted::alive, 100);
+        for (int i = 0; i < 100; i += 2) m.erase(i);
+        EXPECT_GE(counted::alive, 100);
+      }
+      EXPECT_EQ(counted::alive, 50);
+      persistent_map<int, counted> s = m;
+      m.clear();
+      EXPECT_EQ(counted::alive, 50);
+    }
+    EXPECT_EQ(counted::alive, 0);
+  }
+}
+
+TEST(persistent_map, modifiers) {
+  /**
+   * @test  insert / emplace / try_emplace / insert_or_assign / erase
+   * @brief random updates checked against std::map, keeping snapshots
+   *  along the way that must never change afterwards.
+   */
+  SUBTEST(modifiers) {
+    checked<persistent_map<int, int>> m;
+    std::map<int, int> model;
+    std::vector<std::pair<checked<persistent_map<int, int>>, std::map<int, int>>> versions;
+    unsigned seed = 5;
+    for (int i = 0; i < 6000; ++i) {
+      int k = next_rand(seed) % 400;
+      switch (next_rand(seed) % 5) {
+        case 0:
+          EXPECT_EQ(m.insert({k, i}).second, model.insert({k, i}).second);
+          break;
+        case 1:
+          EXPECT_EQ(m.emplace(k, i).second, model.emplace(k, i).second);
+          break;
+        case 2:
+          EXPECT_EQ(m.try_emplace(k, i).second, model.try_emplace(k, i).second);
+          break;
+        case 3:
+          EXPECT_EQ(m.insert_or_assign(k, i).second, model.insert_or_assign(k, i).second);
+          break;
+        default:
+          EXPECT_EQ(m.erase(k), model.erase(k));
+      }
+      if (i % 500 == 0) {
+        EXPECT_TRUE(m.verify());
+        versions.emplace_back(m, model);
+      }
+    }
+    EXPECT_TRUE(m.verify());
+    EXPECT_TRUE(same(m, model));
+    for (auto& v : versions) {
+      EXPECT_TRUE(v.first.verify());
+      EXPECT_TRUE(same(v.first, v.second));
+    }
+  }
+
+  /**
+   * @test  insert / erase of sorted keys down to empty
+   */
+  SUBTEST(modifiers) {
+    checked<persistent_map<int, int>> m;
+    for (int i = 0; i < 1000; ++i) m.insert({i, i});
+    checked<persistent_map<int, int>> full = m;
+    for (int i = 0; i < 1000; i += 2) EXPECT_EQ(m.erase(i), 1);
+    EXPECT_TRUE(m.verify());
+    for (int i = 999; i > 0; i -= 2) EXPECT_EQ(m.erase(i), 1);
+    EXPECT_TRUE(m.empty());
+    EXPECT_TRUE(full.verify());
+    EXPECT_EQ(full.size(), 1000);
+    m.insert({1, 1});
+    m.clear();
+    EXPECT_TRUE(m.empty());
+  }
+
+  /**
+   * @test  insert / erase when copying a value throws
+   * @brief the map is left as it was.
+   */
+  SUBTEST(modifiers) {
+    persistent_map<int, fragile> m;
+    for (int i = 0; i < 200; ++i) m.emplace(i, i);
+    persistent_map<int, fragile> s = m;
+    int thrown = 0;
+    for (int budget = 0; budget < 40; ++budget) {
+      fragile::budget = budget;
+      try {
+        if (budget % 2) m.erase(budget * 3);
+        else m.insert_or_assign(budget * 3, fragile(-1));
+      } catch (const std::runtime_error&) {
+        ++thrown;
+        EXPECT_EQ(m.size(), 200);
+        EXPECT_TRUE(std::equal(m.begin(), m.end(), s.begin(), s.end()));
+      }
+      fragile::budget = -1;
+      m = s;
+    }
+    EXPECT_GT(thrown, 0);
+  }
+}
+
+TEST(persistent_map, lookup) {
+  /**
+   * @test  find / contains / count / lower_bound / upper_bound / iteration
+   */
+  SUBTEST(lookup) {
+    persistent_map<int, int> m {{10, 1}, {20, 2}, {30, 3}};
+    EXPECT_EQ(m.find(20)->second, 2);
+    EXPECT_TRUE(m.find(25) == m.end());
+    EXPECT_TRUE(m.contains(30));
+    EXPECT_EQ(m.count(5), 0);
+    EXPECT_EQ(m.lower_bound(15)->first, 20);
+    EXPECT_EQ(m.lower_bound(20)->first, 20);
+    EXPECT_EQ(m.upper_bound(20)->first, 30);
+    EXPECT_TRUE(m.upper_bound(30) == m.end());
+    auto it = m.end();
+    EXPECT_EQ((--it)->first, 30);
+    EXPECT_EQ((--it)->first, 20);
+    EXPECT_EQ((++it)->first, 30);
+    std::vector<int> back;
+    for (auto r = m.rbegin(); r != m.rend(); ++r) back.push_back(r->first);
+    EXPECT_EQ(back, (std::vector<int>{30, 20, 10}));
+  }
+
+  /**
+   * @test  find / lower_bound / erase with a transparent comparator
+   */
+  SUBTEST(lookup) {
+    persistent_map<std::string, int, less<>> m {{"apple", 1}, {"banana", 2}, {"cherry", 3}};
+    EXPECT_EQ(m.find(std::string_view("banana"))->second, 2);
+    EXPECT_EQ(m.lower_bound(std::string_view("c"))->first, "cherry");
+    EXPECT_EQ(m.erase(std::string_view("apple")), 1);
+    EXPECT_FALSE(m.contains(std::string_view("apple")));
+  }
+}
+
+TEST(persistent_map, threads) {
+  /**
+   * @test  snapshots read on other threads while the writer updates
+   * @brief every reader sees the version it was handed, unchanged.
+   */
+  SUBTEST(threads) {
+    persistent_map<int, int> m;
+    for (int i = 0; i < 2000; ++i) m.insert({i, i});
+    std::vector<std::thread> pool;
+    for (int round = 0; round < 4; ++round) {
+      persistent_map<int, int> s = m;
+      pool.emplace_back([s, round] {
+        for (int pass = 0; pass < 20; ++pass) {
+          long sum = 0;
+          int n = 0;
+          for (auto& p : s) {
+            sum += p.second - p.first;
+            ++n;
+          }
+          EXPECT_EQ(sum, (long)round * n);
+          EXPECT_EQ(n, 2000);
+        }
+      });
+      for (int i = 0; i < 2000; ++i) m.insert_or_assign(i, i + round + 1);
+    }
+    for (auto& th : pool) th.join();
+  }
+}
@@ -0,0 +1,206 @@
+#include <map>
+#include <string>
+#include <vector>
+#include <utility>
+#include <stdexcept>
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+#include "radix_map.h"
+#include "test_util.h"
+
+using namespace tinySTL;
+
+namespace {
+
+// keys over a small alphabet, so that they share prefixes and are often
+// prefixes of one another; some share a run longer than a node keeps.
+std::string random_key(unsigned& seed) {
+  std::string k;
+  if (next_rand(seed) % 4 == 0) k = "shared/prefix/longer/than/eight/";
+  unsigned n = next_rand(seed) % 6;
+  for (unsigned i = 0; i < n; ++i) k += "ab\xff"[next_rand(seed) % 3];
+  if (next_rand(seed) % 8 == 0) k += (char)(next_rand(seed) % 256);
+  return k;
+}
+
+}
+
+TEST(radix_map, constructor) {
+  /**
+   * @test  radix_map() / radix_map(std::initializer_list) / radix_map(const radix_map&)
+   */
+  SUBTEST(constructor) {
+    radix_map<int> m;
+    EXPECT_TRUE(m.empty());
+    EXPECT_STRING_EQ(m, []);
+    radix_map<int> m1 {{"romane", 1}, {"romanus", 2}, {"romulus", 3}, {"rubens", 4},
+                       {"ruber", 5}, {"rubicon", 6}, {"rubicundus", 7}, {"romane", 8}};
+    EXPECT_STRING_EQ(m1, [{romane, 1}, {romanus, 2}, {romulus, 3}, {rubens, 4}, {ruber, 5},
+                          {rubicon, 6}, {rubicundus, 7}]);
+    EXPECT_EQ(m1.size(), 7);
+    radix_map<int> m2(m1);
+    m1.clear();
+    EXPECT_EQ(m2.size(), 7);
+    EXPECT_EQ(m2.at("ruber"), 5);
+    radix_map<int> m3(std::move(m2));
+    EXPECT_EQ(m3.size(), 7);
+    EXPECT_TRUE(m2.empty());
+    m2 = m3;
+    m3.insert({"a", 0});
+    EXPECT_EQ(m3.prefix_range("a").first->second, 0);
+    EXPECT_EQ(m2.size(), 7);
+    m2.swap(m3);
+    EXPECT_EQ(m2.size(), 8);
+    EXPECT_EQ(m2.begin()->first, "a");
+    EXPECT_EQ((--m2.end())->first, "rubicundus");
+  }
+}
+
+TEST(radix_map, lookup) {
+  /**
+   * @test  find / contains / count / at / operator[]
+   * @brief keys that are prefixes of others, the empty key, and bytes
+   *  above 0x7f, which sort after the ASCII ones.
+   */
+  SUBTEST(lookup) {
+    radix_map<int> m {{"", 0}, {"a", 1}, {"ab", 2}, {"abc", 3}, {"b\xff", 4}, {"ba", 5}};
+    EXPECT_EQ(m.find("")->second, 0);
+    EXPECT_EQ(m.find("ab")->second, 2);
+    EXPECT_TRUE(m.find("abcd") == m.end());
+    EXPECT_TRUE(m.find("b") == m.end());
+    EXPECT_TRUE(m.contains(std::string("abc")));
+    EXPECT_EQ(m.count("ba"), 1);
+    EXPECT_EQ(m.count("bb"), 0);
+    EXPECT_EQ(m.at("a"), 1);
+    EXPECT_THROW(m.at("c"), std::range_error);
+    m["c"] = 6;
+    EXPECT_EQ(m["c"], 6);
+    std::vector<std::string> keys;
+    for (auto& p : m) keys.push_back(p.first);
+    EXPECT_EQ(keys, (std::vector<std::string>{"", "a", "ab", "abc", "ba", "b\xff", "c"}));
+    keys.clear();
+    for (auto r = m.rbegin(); r != m.rend(); ++r) keys.push_back(r->first);
+    EXPECT_EQ(keys, (std::vector<std::string>{"c", "b\xff", "ba", "abc", "ab", "a", ""}));
+  }
+
+  /**
+   * @test  prefix_range
+   */
+  SUBTEST(lookup) {
+    radix_map<int> m {{"apple", 1}, {"applet", 2}, {"application", 3}, {"apply", 4},
+                      {"banana", 5}, {"band", 6}, {"bandana", 7}};
+    auto keys = [&](std::string_view p) {
+      std::vector<std::string> r;
+      for (auto [i, e] = m.prefix_range(p); i != e; ++i) r.push_back(i->first);
+      return r;
+    };
+    EXPECT_EQ(keys("appl"), (std::vector<std::string>{"apple", "applet", "application", "apply"}));
+    EXPECT_EQ(keys("apple"), (std::vector<std::string>{"apple", "applet"}));
+    EXPECT_EQ(keys("applic"), (std::vector<std::string>{"application"}));
+    EXPECT_EQ(keys("ban"), (std::vector<std::string>{"banana", "band", "bandana"}));
+    EXPECT_EQ(keys("bandanas"), (std::vector<std::string>{}));
+    EXPECT_EQ(keys("c"), (std::vector<std::string>{}));
+    EXPECT_EQ(keys("appx"), (std::vector<std::string>{}));
+    EXPECT_EQ(keys("").size(), 7);
+    const radix_map<int>& c = m;
+    EXPECT_EQ(c.prefix_range("b").first->first, "banana");
+  }
+
+  /**
+   * @test  prefix_range / find below paths longer than a node keeps
+   */
+  SUBTEST(lookup) {
+    checked<radix_map<int>> m;
+    std::string base = "0123456789abcdefghij";
+    for (int i = 0; i < 20; ++i) m.insert({base + char('A' + i), i});
+    m.insert({base.substr(0, 12) + "X", 20});
+    EXPECT_TRUE(m.verify());
+    EXPECT_TRUE(m.find(base.substr(0, 12) + "X") != m.end());
+    EXPECT_TRUE(m.find(base.substr(0, 11) + "XX") == m.end());
+    EXPECT_TRUE(m.find(base.substr(0, 12) + "Xbcdefghij" + "A") == m.end());
+    int n = 0;
+    for (auto [i, e] = m.prefix_range(base.substr(0, 15)); i != e; ++i) ++n;
+    EXPECT_EQ(n, 20);
+    n = 0;
+    for (auto [i, e] = m.prefix_range(base.substr(0, 10) + "ac"); i != e; ++i) ++n;
+    EXPECT_EQ(n, 0);
+  }
+}
+
+TEST(radix_map, modifiers) {
+  /**
+   * @test  insert / emplace / try_emplace / insert_or_assign / erase
+   * @brief random updates checked against std::map, sized to grow nodes
+   *  to every size and shrink them back.
+   */
+  SUBTEST(modifiers) {
+    checked<radix_map<int>> m;
+    std::map<std::string, int> model;
+    unsigned seed = 11;
+    for (int i = 0; i < 20000; ++i) {
+      std::string k = random_key(seed);
+      switch (next_rand(seed) % 6) {
+        case 0:
+          EXPECT_EQ(m.insert({k, i}).second, model.insert({k, i}).second);
+          break;
+        case 1:
+          EXPECT_EQ(m.emplace(k, i).second, model.emplace(k, i).second);
+          break;
+        case 2:
+          EXPECT_EQ(m.try_emplace(k, i).second, model.try_emplace(k, i).second);
+          break;
+        case 3:
+          EXPECT_EQ(m.insert_or_assign(k, i).second, model.insert_or_assign(k, i).second);
+          break;
+        default:
+          EXPECT_EQ(m.erase(k), model.erase(k));
+      }
+      if (i % 1000 == 0) {
+        EXPECT_TRUE(m.verify());
+      }
+    }
+    EXPECT_TRUE(m.verify());
+    EXPECT_TRUE(same(m, model));
+    for (int i = 0; i < 50; ++i) {
+      std::string p = random_key(seed).substr(0, 3);
+      std::vector<std::string> got, want;
+      for (auto [a, e] = m.prefix_range(p); a != e; ++a) got.push_back(a->first);
+      for (auto it = model.lower_bound(p); it != model.end() && it->first.starts_with(p); ++it)
+        want.push_back(it->first);
+      EXPECT_EQ(got, want);
+    }
+    while (!model.empty()) {
+      auto it = m.find(model.begin()->first);
+      it = m.erase(it);
+      model.erase(model.begin());
+      EXPECT_TRUE(model.empty() ? it == m.end() : it->first == model.begin()->first);
+    }
+    EXPECT_TRUE(m.empty());
+    EXPECT_TRUE(m.verify());
+  }
+
+  /**
+   * @test  insert / erase of every two-byte key
+   * @brief nodes of 256 children, shrinking to nothing.
+   */
+  SUBTEST(modifiers) {
+    checked<radix_map<int>> m;
+    for (int a = 0; a < 256; ++a)
+      for (int b = 0; b < 256; b += 3)
+        m.insert({std::string{(char)a, (char)b}, a * 256 + b});
+    EXPECT_TRUE(m.verify());
+    EXPECT_EQ(m.size(), 256 * 86);
+    for (int a = 0; a < 256; ++a)
+      for (int b = 0; b < 256; b += 3)
+        if ((a + b) % 5) {
+          EXPECT_EQ(m.erase(std::string{(char)a, (char)b}), 1);
+        }
+    EXPECT_TRUE(m.verify());
+    for (auto& p : m) EXPECT_EQ((p.second / 256 + p.second % 256) % 5, 0);
+    m.clear();
+    EXPECT_TRUE(m.empty());
+    EXPECT_TRUE(m.verify());
+  }
+}
@@ -1,12 +1,47 @@
+#include <algorithm>
+#include <numeric>
+#include <iterator>
+#include <set>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
 #include <gmock/gmock.h>
 #include <gtest/gtest.h>
 
 #include "set.h"
 #include "list.h"
 #include "vector.h"
+#include "test_util.h"
 
 using namespace tinySTL;
 
+namespace {
+
+// a key that counts how often one is built.
+struct counted_key {
+  static int made;
+  std::string s;
+  counted_key(const char* p) : s(p) { ++made; }
+  counted_key(const counted_key& x) : s(x.s) { ++made; }
+  friend bool operator<(const counted_key& a, const counted_key& b) { return a.s < b.s; }
+  friend bool operator<(const counted_key& a, const char* b) { return a.s < b; }
+  friend bool operator<(const char* a, const counted_key& b) { return a < b.s; }
+};
+
+int counted_key::made = 0;
+
+// throws once the comparison budget runs out; a negative budget never does.
+struct touchy_less {
+  static inline int budget = -1;
+  bool operator()(const fragile& a, const fragile& b) const {
+    if (budget-- == 0) throw std::runtime_error("compare");
+    return a < b;
+  }
+};
+
+}
+
 TEST(set, constructor) {
   /**
    * @test  set()
@@ -28,6 +63,61 @@ TEST(set, constructor) {
     EXPECT_STRING_EQ(s2, [1, 2, 3, 4, 7]);
   }
 
+  /**
+   * @test  set(const set&)
+   * @brief copies of every shape up to 300 nodes, and of large trees, are
+   *  valid trees equal to the original; see tree_copy.cpp for the copies
+   *  made on several threads.
+   */
+  SUBTEST(constructor) {
+    checked<set<int>> s;
+    for (int n = 0; n < 300; ++n) {
+      checked<set<int>> c(s);
+      EXPECT_TRUE(c.verify());
+      EXPECT_TRUE(std::equal(c.begin(), c.end(), s.begin(), s.end()));
+      s.insert(n * 7 % 300);
+    }
+    for (int n = 300; n < 20000; ++n) s.insert(n);
+    for (int n = 0; n < 20000; n += 3) s.erase(n);
+    checked<set<int>> c(s);
+    EXPECT_TRUE(c.verify());
+    EXPECT_EQ(c.size(), s.size());
+    EXPECT_TRUE(std::equal(c.begin(), c.end(), s.begin(), s.end()));
+    c = s;
+    EXPECT_TRUE(c.verify());
+    ranked_set<int> r(s.begin(), s.end());
+    ranked_set<int> rc(r);
+    EXPECT_EQ(*rc.nth(5000), *r.nth(5000));
+    EXPECT_EQ(rc.rank(9001), r.rank(9001));
+  }
+
+  /**
+   * @test  set(const set&) when copying a value throws
+   * @brief the exception reaches the caller and nothing is leaked.
+   */
+  SUBTEST(constructor) {
+    for (int n : {100, 5000}) {
+      {
+        set<fragile> s;
+        for (int i = 0; i < n; ++i) s.emplace(i);
+        for (int budget : {0, 1, n / 3, n - 1}) {
+          fragile::budget = budget;
+          EXPECT_THROW(set<fragile> c(s), std::runtime_error);
+          EXPECT_EQ(fragile::alive, n);
+          set<fragile> c;
+          fragile::budget = budget;
+          EXPECT_THROW(c = s, std::runtime_error);
+          EXPECT_TRUE(c.empty());
+          EXPECT_EQ(fragile::alive, n);
+        }
+        fragile::budget = -1;
+        set<fragile> c(s);
+        EXPECT_EQ(fragile::alive, 2 * n);
+      }
+      EXPECT_EQ(fragile::alive, 0);
+    }
+  }
+
   /**
    * @test  set(set&&)
    * @brief move constructor.
@@ -272,6 +362,59 @@ TEST(set, insert) {
     EXPECT_STRING_EQ(s, [1, 2, 4, 5]);
   }
 
+  /**
+   * @test  void insert(_InputIterator __first, _InputIterator __last)
+   * @brief sorted input into an empty set is linked in O(n), the tree
+   *  must still be a valid red-black tree of every size.
+   */
+  SUBTEST(insert) {
+    vector<int> vc;
+    for (int n = 0; n < 300; ++n) {
+      checked<set<int>> s;
+      s.insert(vc.begin(), vc.end());
+      EXPECT_TRUE(s.verify());
+      EXPECT_EQ(s.size(), vc.size());
+      EXPECT_TRUE(tinySTL::equal(s.begin(), s.end(), vc.begin()));
+      vc.push_back(n);
+    }
+    checked<set<int>> s;
+    s.insert({1, 2, 2, 3, 3, 3, 7, 5, 4, 8, 1});
+    EXPECT_STRING_EQ(s, [1, 2, 3, 4, 5, 7, 8]);
+    EXPECT_TRUE(s.verify());
+    s.insert(vc.begin(), vc.end());
+    EXPECT_EQ(s.size(), 300);
+    EXPECT_TRUE(s.verify());
+  }
+
+  /**
+   * @test  void insert(_InputIterator __first, _InputIterator __last)
+   * @brief a comparison that throws while the sorted prefix is built, or
+   *  while the first value out of order is inserted, leaks no node.
+   */
+  SUBTEST(insert) {
+    std::vector<fragile> in;
+    for (int i = 0; i < 20; ++i) in.push_back(i / 2 * 2);
+    in.push_back(7);
+    in.push_back(8);
+    for (int i = 20; i < 30; ++i) in.push_back(i);
+    int thrown = 0;
+    for (int budget = 0; budget < 80; ++budget) {
+      {
+        checked<set<fragile, touchy_less>> s;
+        touchy_less::budget = budget;
+        try {
+          s.insert(in.begin(), in.end());
+        } catch (const std::runtime_error&) {
+          ++thrown;
+        }
+        touchy_less::budget = -1;
+        EXPECT_TRUE(s.verify());
+      }
+      EXPECT_EQ(fragile::alive, (int)in.size());
+    }
+    EXPECT_GT(thrown, 40);
+  }
+
   /**
    * @test  void insert(std::initializer_list<value_type> __l)
    * @brief insert initializer_list.
@@ -283,6 +426,116 @@ TEST(set, insert) {
   }
 }
 
+TEST(set, ranked) {
+  /**
+   * @test  nth / rank on ranked_set
+   */
+  SUBTEST(ranked) {
+    ranked_set<int> s;
+    for (int i = 0; i < 100; ++i) s.insert(i * 2);
+    EXPECT_EQ(*s.nth(0), 0);
+    EXPECT_EQ(*s.nth(50), 100);
+    EXPECT_TRUE(s.nth(100) == s.end());
+    EXPECT_EQ(s.rank(100), 50);
+    EXPECT_EQ(s.rank(101), 51);
+    EXPECT_EQ(s.rank(1000), 100);
+    s.erase(s.begin(), s.nth(10));
+    EXPECT_EQ(*s.nth(0), 20);
+    EXPECT_EQ(tinySTL::distance(s.find(40), s.find(60)), 10);
+    EXPECT_EQ(s.rank(20), 0);
+  }
+}
+
+TEST(set, augmented) {
+  /**
+   * @test  fold on augmented_multiset with range_sum
+   * @brief random inserts, erases, splits, joins and copies, every range
+   *  sum checked against a scan.
+   */
+  SUBTEST(augmented) {
+    typedef augmented_multiset<int, range_sum<int, long>> sum_set;
+    checked<sum_set> s;
+    std::multiset<int> model;
+    unsigned seed = 9;
+    auto next = [&seed] { return int(next_rand(seed)); };
+    for (int i = 0; i < 3000; ++i) {
+      int k = next() % 200;
+      switch (next() % 4) {
+        case 0:
+        case 1:
+          s.insert(k);
+          model.insert(k);
+          break;
+        case 2:
+          EXPECT_EQ(s.erase(k), model.erase(k));
+          break;
+        default:
+          if (i % 50 == 3) {
+            checked<sum_set> hi;
+            static_cast<sum_set&>(hi) = s.split(k);
+            EXPECT_TRUE(s.verify());
+            EXPECT_TRUE(hi.verify());
+            EXPECT_EQ(hi.fold(), std::accumulate(model.lower_bound(k), model.end(), 0L));
+            s.join(tinySTL::move(hi));
+          }
+      }
+      int lo = next() % 220 - 10, hi = lo + next() % 60;
+      long expect = 0;
+      for (int x : model)
+        if (lo <= x && x < hi) expect += x;
+      ASSERT_EQ(s.fold(lo, hi), expect);
+    }
+    EXPECT_TRUE(s.verify());
+    EXPECT_EQ(s.fold(), std::accumulate(model.begin(), model.end(), 0L));
+    checked<sum_set> copy;
+    static_cast<sum_set&>(copy) = s;
+    EXPECT_TRUE(copy.verify());
+    EXPECT_EQ(copy.fold(50, 150), s.fold(50, 150));
+    s.clear();
+    EXPECT_EQ(s.fold(), 0);
+    EXPECT_EQ(s.fold(0, 10), 0);
+  }
+
+  /**
+   * @test  fold and nth on a tree both ranked and augmented
+   */
+  SUBTEST(augmented) {
+    set<int, less<int>, allocator<int>, true, range_sum<int, long>> s;
+    for (int i = 1; i <= 1000; ++i) s.insert(i);
+    s.erase(s.nth(0), s.nth(100));
+    EXPECT_EQ(*s.nth(0), 101);
+    EXPECT_EQ(s.rank(500), 399);
+    EXPECT_EQ(s.fold(), 500500 - 5050);
+    EXPECT_EQ(s.fold(101, 111), 1055);
+    EXPECT_EQ(s.fold(200, 100), 0);
+  }
+}
+
+TEST(set, node_layout) {
+  /**
+   * @test  _Rb_tree_node_base
+   * @brief with the color in the parent pointer a node base is three
+   *  pointers, and the tree stays valid through inserts and erases.
+   */
+  SUBTEST(node_layout) {
+#if __TINY_RB_TREE_COMPACT
+    EXPECT_EQ(sizeof(_Rb_tree_node_base), 3 * sizeof(void*));
+#endif
+    checked<set<int>> s;
+    unsigned seed = 1;
+    for (int i = 0; i < 2000; ++i) {
+      int v = next_rand(seed) % 300;
+      if (i % 3 == 2) {
+        s.erase(v);
+      } else {
+        s.insert(v);
+      }
+    }
+    EXPECT_TRUE(s.verify());
+    EXPECT_TRUE(std::is_sorted(s.begin(), s.end()));
+  }
+}
+
 TEST(set, erase) {
   /**
    * @test  size_type erase(const key_type& __k) 
@@ -317,6 +570,136 @@ TEST(set, erase) {
     EXPECT_EQ(*it, 4);
     EXPECT_STRING_EQ(s, [4, 5]);
   }
+
+  /**
+   * @test  iterator erase(const_iterator __first, const_iterator __last) 
+   * @brief long ranges are cut out of the tree in one piece.
+   */
+  SUBTEST(erase) {
+    for (int lo = 0; lo < 300; lo += 37) {
+      for (int hi = lo; hi <= 300; hi += 29) {
+        checked<set<int>> s;
+        for (int i = 0; i < 300; ++i) s.insert(i);
+        auto it = s.erase(s.find(lo), hi == 300 ? s.end() : s.find(hi));
+        EXPECT_TRUE(hi == 300 ? it == s.end() : *it == hi);
+        EXPECT_TRUE(s.verify());
+        EXPECT_EQ(s.size(), size_t(300 - (hi - lo)));
+        EXPECT_EQ(s.count(lo), lo == hi);
+      }
+    }
+  }
+}
+
+TEST(set, split_join) {
+  /**
+   * @test  set split(const key_type& __x) / void join(set&& __x)
+   * @brief split at every position of trees of all small sizes, then
+   *  join the halves back.
+   */
+  SUBTEST(split_join) {
+    for (int n = 0; n < 70; ++n) {
+      for (int k = -1; k <= 2 * n + 1; ++k) {
+        checked<set<int>> s;
+        for (int i = 0; i < n; ++i) s.insert(2 * i);
+        set<int> hi = s.split(k);
+        checked<set<int>>& lo = s;
+        EXPECT_TRUE(lo.verify());
+        EXPECT_EQ(lo.size() + hi.size(), size_t(n));
+        EXPECT_TRUE(lo.empty() || *--lo.end() < k);
+        EXPECT_TRUE(hi.empty() || *hi.begin() >= k);
+        lo.join(tinySTL::move(hi));
+        EXPECT_TRUE(lo.verify());
+        EXPECT_TRUE(hi.empty());
+        ASSERT_EQ(lo.size(), size_t(n));
+        int i = 0;
+        for (int x : lo) EXPECT_EQ(x, 2 * i++);
+      }
+    }
+  }
+
+  /**
+   * @test  join of trees with very different heights
+   */
+  SUBTEST(split_join) {
+    checked<ranked_set<int>> big, small;
+    for (int i = 0; i < 5000; ++i) big.insert(i);
+    small.insert(-1);
+    small.join(tinySTL::move(big));
+    EXPECT_TRUE(small.verify());
+    EXPECT_EQ(small.size(), 5001);
+    EXPECT_EQ(*small.nth(1000), 999);
+    checked<ranked_set<int>> tail;
+    tail.insert(10000);
+    small.join(tinySTL::move(tail));
+    EXPECT_TRUE(small.verify());
+    EXPECT_EQ(*--small.end(), 10000);
+    ranked_set<int> bad = {5};
+    EXPECT_THROW(small.join(tinySTL::move(bad)), std::range_error);
+  }
+}
+
+TEST(set, set_operations) {
+  /**
+   * @test  merge / intersect / subtract
+   * @brief random sets of very different sizes checked against std::set,
+   *  on plain and ranked trees.
+   */
+  SUBTEST(set_operations) {
+    unsigned seed = 5;
+    auto next = [&seed] { return next_rand(seed); };
+    for (int round = 0; round < 60; ++round) {
+      size_t na = next() % 2000, nb = round % 3 == 0 ? next() % 20 : next() % 2000;
+      int range = 1 + next() % 4000;
+      checked<ranked_set<int>> a, b;
+      std::set<int> ma, mb;
+      for (size_t i = 0; i < na; ++i) { int x = next() % range; a.insert(x); ma.insert(x); }
+      for (size_t i = 0; i < nb; ++i) { int x = next() % range; b.insert(x); mb.insert(x); }
+      if (round % 2) { tinySTL::swap(a, b); tinySTL::swap(ma, mb); }
+
+      checked<ranked_set<int>> u = a, bu = b;
+      u.merge(bu);
+      std::set<int> mu = ma, mbu = mb;
+      mu.merge(mbu);
+      EXPECT_TRUE(u.verify());
+      EXPECT_TRUE(bu.verify());
+      ASSERT_EQ(u.size(), mu.size());
+      ASSERT_EQ(bu.size(), mbu.size());
+      EXPECT_TRUE(tinySTL::equal(u.begin(), u.end(), mu.begin()));
+      EXPECT_TRUE(tinySTL::equal(bu.begin(), bu.end(), mbu.begin()));
+
+      checked<ranked_set<int>> in = a, bi = b;
+      in.intersect(tinySTL::move(bi));
+      EXPECT_TRUE(in.verify());
+      EXPECT_TRUE(bi.empty());
+      std::vector<int> mi;
+      std::set_intersection(ma.begin(), ma.end(), mb.begin(), mb.end(), std::back_inserter(mi));
+      ASSERT_EQ(in.size(), mi.size());
+      EXPECT_TRUE(tinySTL::equal(in.begin(), in.end(), mi.begin()));
+
+      checked<ranked_set<int>> d = a, bd = b;
+      d.subtract(tinySTL::move(bd));
+      EXPECT_TRUE(d.verify());
+      std::vector<int> md;
+      std::set_difference(ma.begin(), ma.end(), mb.begin(), mb.end(), std::back_inserter(md));
+      ASSERT_EQ(d.size(), md.size());
+      EXPECT_TRUE(tinySTL::equal(d.begin(), d.end(), md.begin()));
+    }
+  }
+
+  /**
+   * @test  intersect / subtract with empty sets
+   */
+  SUBTEST(set_operations) {
+    set<int> s = {1, 2, 3};
+    s.subtract(set<int>());
+    EXPECT_STRING_EQ(s, [1, 2, 3]);
+    s.intersect(set<int>{2, 3, 4});
+    EXPECT_STRING_EQ(s, [2, 3]);
+    s.intersect(set<int>());
+    EXPECT_STRING_EQ(s, []);
+    s.merge(set<int>{7});
+    EXPECT_STRING_EQ(s, [7]);
+  }
 }
 
 TEST(set, clear) {
@@ -381,6 +764,113 @@ TEST(set, equal_range) {
   EXPECT_EQ(++l2, r2);
 }
 
+TEST(set, transparent_lookup) {
+  /**
+   * @test  find / count / contains / lower_bound / upper_bound / equal_range
+   * @brief with less<> a const char* is compared against the keys as is,
+   *  no key is built for the lookup.
+   */
+  SUBTEST(transparent_lookup) {
+    set<counted_key, less<>> s;
+    s.emplace("b");
+    s.emplace("d");
+    s.emplace("f");
+    counted_key::made = 0;
+    EXPECT_EQ(s.find("d")->s, "d");
+    EXPECT_EQ(s.find("e"), s.end());
+    EXPECT_EQ(s.count("f"), 1);
+    EXPECT_FALSE(s.contains("a"));
+    EXPECT_EQ(s.lower_bound("c")->s, "d");
+    EXPECT_EQ(s.upper_bound("d")->s, "f");
+    auto [l, r] = s.equal_range("b");
+    EXPECT_EQ(l, s.begin());
+    EXPECT_EQ(r->s, "d");
+    EXPECT_EQ(counted_key::made, 0);
+    multiset<counted_key, less<>> ms;
+    ms.emplace("x");
+    ms.emplace("x");
+    counted_key::made = 0;
+    EXPECT_EQ(ms.count("x"), 2);
+    EXPECT_EQ(ms.find("y"), ms.end());
+    EXPECT_EQ(counted_key::made, 0);
+  }
+}
+
+TEST(set, node_handle) {
+  /**
+   * @test  extract(position) / extract(key) / insert(node_type&&)
+   * @brief a node moves between sets without being reallocated.
+   */
+  SUBTEST(node_handle) {
+    set<int> a {1, 2, 3}, b {3, 4};
+    const int* p = &*a.find(2);
+    auto nh = a.extract(2);
+    EXPECT_FALSE(nh.empty());
+    EXPECT_EQ(nh.value(), 2);
+    EXPECT_STRING_EQ(a, [1, 3]);
+    auto r = b.insert(tinySTL::move(nh));
+    EXPECT_TRUE(r.inserted);
+    EXPECT_TRUE(nh.empty());
+    EXPECT_EQ(&*r.position, p);
+    EXPECT_STRING_EQ(b, [2, 3, 4]);
+    r = b.insert(a.extract(a.find(3)));
+    EXPECT_FALSE(r.inserted);
+    EXPECT_EQ(r.node.value(), 3);
+    EXPECT_EQ(*r.position, 3);
+    EXPECT_TRUE(a.extract(7).empty());
+    EXPECT_EQ(b.insert(set<int>::node_type()).position, b.end());
+  }
+
+  /**
+   * @test  insert(hint, node_type&&) / node value changed before reinsertion
+   */
+  SUBTEST(node_handle) {
+    set<int> s {1, 5, 9};
+    auto nh = s.extract(s.begin());
+    nh.value() = 7;
+    auto it = s.insert(s.find(9), tinySTL::move(nh));
+    EXPECT_EQ(*it, 7);
+    EXPECT_STRING_EQ(s, [5, 7, 9]);
+    nh = s.extract(9);
+    nh.value() = 5;
+    it = s.insert(s.end(), tinySTL::move(nh));
+    EXPECT_EQ(it, s.find(5));
+    EXPECT_FALSE(nh.empty());
+  }
+
+  /**
+   * @test  multiset extract / insert(node_type&&)
+   */
+  SUBTEST(node_handle) {
+    multiset<int> a {1, 2, 2, 3}, b {2};
+    b.insert(a.extract(2));
+    b.insert(b.begin(), a.extract(a.find(2)));
+    EXPECT_STRING_EQ(a, [1, 3]);
+    EXPECT_STRING_EQ(b, [2, 2, 2]);
+    EXPECT_EQ(b.insert(multiset<int>::node_type()), b.end());
+  }
+}
+
+TEST(set, for_each_in_range) {
+  /**
+   * @test  for_each_in_range(lo, hi, f)
+   */
+  SUBTEST(for_each_in_range) {
+    set<int> s;
+    for (int i = 0; i < 3000; ++i) s.insert(i * 13 % 3000);
+    std::vector<int> got;
+    s.for_each_in_range(1000, 1004, [&](int x) { got.push_back(x); });
+    EXPECT_EQ(got, (std::vector<int>{1000, 1001, 1002, 1003}));
+    multiset<int> ms {5, 1, 3, 3, 3, 9};
+    got.clear();
+    ms.for_each_in_range(2, 9, [&](int x) { got.push_back(x); });
+    EXPECT_EQ(got, (std::vector<int>{3, 3, 3, 5}));
+    got.clear();
+    ms.for_each_in_range(10, 20, [&](int x) { got.push_back(x); });
+    EXPECT_TRUE(got.empty());
+  }
+}
+
 TEST(set, disp) {
   set<int> s;
   s.disp(std::cout);
@@ -0,0 +1,67 @@
+// tinySTL tests: the fixtures shared by the randomized container tests.
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <stdexcept>
+
+// a small LCG, so that every run draws the same sequence.
+inline unsigned next_rand(unsigned& seed) {
+  seed = seed * 1103515245 + 12345;
+  return seed >> 8;
+}
+
+// counts the values alive, and throws when copied once the budget runs
+// out; a negative budget never does. Copied, never moved. The counters
+// are atomic, copies may be made on several threads.
+struct fragile {
+  static inline std::atomic<int> alive = 0;
+  static inline std::atomic<int> budget = -1;
+  int v;
+  fragile(int x) : v(x) { ++alive; }
+  fragile(const fragile& x) : v(x.v) {
+    if (budget-- == 0) throw std::runtime_error("copy");
+    ++alive;
+  }
+  ~fragile() { --alive; }
+  fragile& operator=(const fragile&) = default;
+  bool operator==(const fragile& x) const { return v == x.v; }
+  friend bool operator<(const fragile& a, const fragile& b) { return a.v < b.v; }
+};
+
+// exposes the invariant check of the structure under a container.
+template <class _Container>
+struct checked : _Container {
+  using _Container::_Container;
+  bool verify() const {
+    if constexpr (requires (const checked& c) { c._M_t; })
+      return this->_M_t._M_verify();
+    else
+      return this->_M_ht._M_verify();
+  }
+};
+
+// m holds the pairs of model, in the same order.
+template <class _Map, class _Model>
+bool same(const _Map& m, const _Model& model) {
+  if (m.size() != model.size()) return false;
+  auto it = model.begin();
+  for (auto& p : m) {
+    if (p.first != it->first || p.second != it->second) return false;
+    ++it;
+  }
+  return true;
+}
+
+// m holds the pairs of model, in any order.
+template <class _Map, class _Model>
+bool same_elements(const _Map& m, const _Model& model) {
+  if (m.size() != model.size()) return false;
+  size_t n = 0;
+  for (auto& p : m) {
+    auto it = model.find(p.first);
+    if (it == model.end() || it->second != p.second) return false;
+    ++n;
+  }
+  return n == model.size();
+}
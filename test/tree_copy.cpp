@@ -0,0 +1,138 @@
+// copies of red-black trees, built with __TINY_RB_TREE_PARALLEL_COPY=64
+// and __TINY_RB_TREE_COPY_THREADS=4: trees of 64 nodes or more are cloned
+// on 4 threads.
+#include <algorithm>
+#include <stdexcept>
+#include <string>
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+#include "set.h"
+#include "map.h"
+#include "interval_map.h"
+#include "test_util.h"
+
+using namespace tinySTL;
+
+TEST(tree_copy, set) {
+  /**
+   * @test  set(const set&) / operator=(const set&)
+   * @brief copies of every shape up to 300 nodes, on one thread below 64
+   *  and on several above, and of a large tree, are valid trees equal to
+   *  the original.
+   */
+  SUBTEST(set) {
+    checked<set<int>> s;
+    for (int n = 0; n < 300; ++n) {
+      checked<set<int>> c(s);
+      EXPECT_TRUE(c.verify());
+      EXPECT_TRUE(std::equal(c.begin(), c.end(), s.begin(), s.end()));
+      s.insert(n * 7 % 300);
+    }
+    for (int n = 300; n < 20000; ++n) s.insert(n);
+    for (int n = 0; n < 20000; n += 3) s.erase(n);
+    checked<set<int>> c(s);
+    EXPECT_TRUE(c.verify());
+    EXPECT_EQ(c.size(), s.size());
+    EXPECT_TRUE(std::equal(c.begin(), c.end(), s.begin(), s.end()));
+    c.clear();
+    c.insert(-1);
+    c = s;
+    EXPECT_TRUE(c.verify());
+    EXPECT_TRUE(std::equal(c.begin(), c.end(), s.begin(), s.end()));
+  }
+
+  /**
+   * @test  multiset(const multiset&) / ranked_set(const ranked_set&)
+   * @brief duplicates keep their order, subtree sizes are copied.
+   */
+  SUBTEST(set) {
+    checked<multiset<int>> s;
+    for (int i = 0; i < 5000; ++i) s.insert(i * 13 % 97);
+    checked<multiset<int>> c(s);
+    EXPECT_TRUE(c.verify());
+    EXPECT_EQ(c.size(), s.size());
+    EXPECT_TRUE(std::equal(c.begin(), c.end(), s.begin(), s.end()));
+    EXPECT_EQ(c.count(42), s.count(42));
+    checked<ranked_set<int>> r;
+    for (int i = 0; i < 10000; ++i) r.insert(i * 7919 % 10000);
+    checked<ranked_set<int>> rc(r);
+    EXPECT_TRUE(rc.verify());
+    for (int k = 0; k < 10000; k += 999) {
+      EXPECT_EQ(*rc.nth(k), *r.nth(k));
+      EXPECT_EQ(rc.rank(k), r.rank(k));
+    }
+  }
+
+  /**
+   * @test  set(const set&) when copying a value throws
+   * @brief the exception reaches the caller and nothing is leaked, on
+   *  whichever thread it is thrown.
+   */
+  SUBTEST(set) {
+    for (int n : {50, 100, 5000}) {
+      {
+        set<fragile> s;
+        for (int i = 0; i < n; ++i) s.emplace(i);
+        for (int budget : {0, 1, n / 3, n / 2, n - 1}) {
+          fragile::budget = budget;
+          EXPECT_THROW(set<fragile> c(s), std::runtime_error);
+          EXPECT_EQ(fragile::alive, n);
+          set<fragile> c;
+          fragile::budget = budget;
+          EXPECT_THROW(c = s, std::runtime_error);
+          EXPECT_TRUE(c.empty());
+          EXPECT_EQ(fragile::alive, n);
+        }
+        fragile::budget = -1;
+        set<fragile> c(s);
+        EXPECT_EQ(fragile::alive, 2 * n);
+      }
+      EXPECT_EQ(fragile::alive, 0);
+    }
+  }
+}
+
+TEST(tree_copy, map) {
+  /**
+   * @test  map(const map&)
+   * @brief keys and values are copied, the copy is a valid tree.
+   */
+  SUBTEST(map) {
+    checked<map<int, std::string>> m;
+    for (int i = 0; i < 20000; ++i) m.emplace(i * 7 % 20000, std::to_string(i));
+    checked<map<int, std::string>> c(m);
+    EXPECT_TRUE(c.verify());
+    EXPECT_TRUE(same(c, m));
+    c.emplace(-1, "x");
+    EXPECT_TRUE(c.verify());
+    EXPECT_EQ(c.size(), m.size() + 1);
+  }
+
+  /**
+   * @test  augmented_map(const augmented_map&) / interval_map copies
+   * @brief the folds above the subtrees cloned on other threads are
+   *  rebuilt, range sums and overlap queries agree with the original.
+   */
+  SUBTEST(map) {
+    checked<augmented_map<int, int, mapped_sum<int, int>>> m;
+    for (int i = 0; i < 20000; ++i) m.insert({i * 3 % 20000, i % 11});
+    checked<augmented_map<int, int, mapped_sum<int, int>>> c(m);
+    EXPECT_TRUE(c.verify());
+    EXPECT_TRUE(same(c, m));
+    EXPECT_EQ(c.fold(), m.fold());
+    for (int lo = 0; lo < 20000; lo += 1999)
+      EXPECT_EQ(c.fold(lo, lo + 3000), m.fold(lo, lo + 3000));
+    checked<interval_map<int, int>> im;
+    unsigned seed = 3;
+    for (int i = 0; i < 5000; ++i) {
+      int lo = next_rand(seed) % 100000;
+      im.insert({{lo, lo + (int)(next_rand(seed) % 500)}, i});
+    }
+    checked<interval_map<int, int>> ic(im);
+    EXPECT_TRUE(ic.verify());
+    for (int x = 0; x < 100000; x += 977)
+      EXPECT_EQ(ic.count_overlaps(x, x + 100), im.count_overlaps(x, x + 100));
+  }
+}
@@ -1,3 +1,4 @@
+#include <string>
 #include <vector>
 
 #include <gmock/gmock.h>
@@ -7,6 +8,26 @@
 
 using namespace tinySTL;
 
+namespace {
+
+// hash<std::string> that counts its calls.
+size_t hash_calls = 0;
+struct counted_hash {
+  size_t operator()(const std::string& s) const { ++hash_calls; return hash<std::string>()(s); }
+};
+
+// every key hashes alike, only the keys tell them apart.
+struct same_hash {
+  size_t operator()(const std::string&) const { return 7; }
+};
+
+}
+
+namespace tinySTL {
+template <> struct is_fast_hash<counted_hash> : false_type {};
+template <> struct is_fast_hash<same_hash> : false_type {};
+}
+
 TEST(unordered_map, constructor) {
   /**
    * @test  unordered_map()
@@ -503,3 +524,227 @@ TEST(unordered_map, at_operator) {
   m1[2] = "World";
   EXPECT_EQ(m1[2], "World");
 }
+
+TEST(unordered_map, node_handle) {
+  /**
+   * @test  extract / insert(node_type&&)
+   * @brief a node moves between tables and is re-keyed without reallocation.
+   */
+  SUBTEST(node_handle) {
+    unordered_map<int, std::string> a, b;
+    for (int i = 0; i < 100; ++i)
+      a.emplace(i, std::to_string(i));
+    const std::string* p = &a.find(42)->second;
+    auto nh = a.extract(42);
+    EXPECT_EQ(a.size(), 99);
+    EXPECT_TRUE(a.find(42) == a.end());
+    nh.key() = 1042;
+    auto r = b.insert(tinySTL::move(nh));
+    EXPECT_TRUE(r.inserted);
+    EXPECT_EQ(&r.position->second, p);
+    EXPECT_EQ(b.at(1042), "42");
+    for (int i = 0; i < 100; i += 2)
+      if (a.find(i) != a.end())
+        b.insert(b.end(), a.extract(a.find(i)));
+    EXPECT_EQ(a.size(), 50);
+    EXPECT_EQ(b.size(), 50);
+    auto nh2 = b.extract(0);
+    nh2.key() = 1042;
+    r = b.insert(tinySTL::move(nh2));
+    EXPECT_FALSE(r.inserted);
+    EXPECT_EQ(r.node.mapped(), "0");
+    EXPECT_TRUE(a.extract(1000).empty());
+  }
+
+  /**
+   * @test  unordered_multimap extract / insert(node_type&&)
+   */
+  SUBTEST(node_handle) {
+    unordered_multimap<int, int> m;
+    m.insert({1, 1});
+    m.insert({1, 2});
+    m.insert({2, 3});
+    auto nh = m.extract(2);
+    nh.key() = 1;
+    m.insert(tinySTL::move(nh));
+    EXPECT_EQ(m.count(1), 3);
+    EXPECT_EQ(m.count(2), 0);
+  }
+}
+
+TEST(unordered_map, compact) {
+  /**
+   * @test  void compact()
+   * @brief every element is kept and found after its node moved, and
+   *  iteration order does not change.
+   */
+  SUBTEST(compact) {
+    unordered_map<std::string, int> m;
+    unordered_multimap<int, int> mm;
+    for (int i = 0; i < 2000; ++i) {
+      m.emplace(std::to_string(i), i);
+      mm.emplace(i % 100, i);
+    }
+    for (int i = 0; i < 2000; i += 3) m.erase(std::to_string(i));
+    std::vector<std::pair<std::string, int>> before;
+    for (auto& p : m) before.emplace_back(p.first, p.second);
+    m.compact();
+    mm.compact();
+    EXPECT_EQ(m.size(), before.size());
+    size_t i = 0;
+    for (auto& p : m) {
+      EXPECT_EQ(p.first, before[i].first);
+      EXPECT_EQ(p.second, before[i].second);
+      ++i;
+    }
+    EXPECT_EQ(m.at("1"), 1);
+    EXPECT_TRUE(m.find("3") == m.end());
+    EXPECT_EQ(mm.size(), 2000);
+    EXPECT_EQ(mm.count(42), 20);
+    m.emplace("new", -1);
+    EXPECT_EQ(m.at("new"), -1);
+  }
+}
+
+TEST(unordered_map, for_each) {
+  /**
+   * @test  for_each(f)
+   * @brief every element once, in iteration order; values can be
+   *  changed through it.
+   */
+  SUBTEST(for_each) {
+    unordered_map<int, int> m;
+    unordered_multimap<int, int> mm;
+    for (int i = 0; i < 5000; ++i) {
+      m.emplace(i * 7919, i);
+      mm.emplace(i % 50, i);
+    }
+    std::vector<int> got, want;
+    m.for_each([&](const pair<const int, int>& p) { got.push_back(p.first); });
+    for (auto& p : m) want.push_back(p.first);
+    EXPECT_EQ(got, want);
+    m.for_each([](pair<const int, int>& p) { p.second *= 2; });
+    EXPECT_EQ(m.at(7919 * 3), 6);
+    long sum = 0;
+    mm.for_each([&](auto& p) { sum += p.second; });
+    EXPECT_EQ(sum, 4999L * 5000 / 2);
+    unordered_map<int, int> empty;
+    empty.for_each([](auto&) { FAIL(); });
+  }
+}
+
+TEST(unordered_map, bucket_policy) {
+  /**
+   * @test  unordered_map<..., pow2_buckets>
+   * @brief power of two bucket counts; keys that share their low bits
+   *  still spread over the buckets, the identity hash is mixed.
+   */
+  SUBTEST(bucket_policy) {
+    unordered_map<int, int, hash<int>, equal_to<int>, allocator<pair<int, int>>, pow2_buckets> m;
+    EXPECT_EQ(m.bucket_count(), 8);
+    for (int i = 0; i < 10000; ++i) m[i << 10] = i;
+    size_t n = m.bucket_count();
+    EXPECT_EQ(n & (n - 1), 0);
+    EXPECT_GE(n * 0.75, 10000);
+    size_t longest = 0;
+    for (size_t b = 0; b < n; ++b) longest = tinySTL::max(longest, m.bucket_size(b));
+    EXPECT_LE(longest, 10);
+    for (int i = 0; i < 10000; ++i) EXPECT_EQ(m.at(i << 10), i);
+    EXPECT_EQ(m.count(1), 0);
+    for (int i = 0; i < 10000; i += 2) EXPECT_EQ(m.erase(i << 10), 1);
+    EXPECT_EQ(m.size(), 5000);
+    size_t seen = 0;
+    for (auto& p : m) {
+      EXPECT_EQ(p.second % 2, 1);
+      ++seen;
+    }
+    EXPECT_EQ(seen, 5000);
+    m.rehash(100000);
+    EXPECT_EQ(m.bucket_count(), 131072);
+    EXPECT_EQ(m.at(1 << 10), 1);
+  }
+
+  /**
+   * @test  unordered_multimap<..., pow2_buckets>::merge
+   */
+  SUBTEST(bucket_policy) {
+    typedef allocator<pair<int, int>> alloc;
+    unordered_multimap<int, int, hash<int>, equal_to<int>, alloc, pow2_buckets> a {{1, 1}, {2, 2}};
+    unordered_multimap<int, int, hash<int>, equal_to<int>, alloc, pow2_buckets> b {{1, 3}, {4, 4}};
+    a.merge(b);
+    EXPECT_EQ(a.size(), 4);
+    EXPECT_EQ(a.count(1), 2);
+    EXPECT_TRUE(b.empty());
+  }
+}
+
+TEST(unordered_map, cached_hash) {
+  /**
+   * @test  unordered_map<std::string, int, counted_hash>
+   * @brief nodes keep their hash: each key is hashed once as it goes in,
+   *  and growing, iterating, copying, compacting and erasing by iterator
+   *  never hash again.
+   */
+  SUBTEST(cached_hash) {
+    unordered_map<std::string, int, counted_hash> m;
+    hash_calls = 0;
+    for (int i = 0; i < 1000; ++i) m.emplace("key" + std::to_string(i), i);
+    EXPECT_EQ(hash_calls, 1000);
+    hash_calls = 0;
+    m.rehash(5000);
+    long sum = 0;
+    for (auto& p : m) sum += p.second;
+    EXPECT_EQ(sum, 999 * 1000 / 2);
+    unordered_map<std::string, int, counted_hash> c(m);
+    m.compact();
+    for (auto it = m.begin(); it != m.end(); )
+      if (it->second % 2) it = m.erase(it);
+      else ++it;
+    EXPECT_EQ(hash_calls, 0);
+    EXPECT_EQ(m.size(), 500);
+    for (int i = 0; i < 1000; ++i) {
+      EXPECT_EQ(m.count("key" + std::to_string(i)), 1 - i % 2);
+      EXPECT_EQ(c.at("key" + std::to_string(i)), i);
+    }
+  }
+
+  /**
+   * @test  extract / insert(node_type&&) / merge with cached hashes
+   * @brief a node is hashed again by the table it goes into.
+   */
+  SUBTEST(cached_hash) {
+    unordered_map<std::string, int, counted_hash> a {{"one", 1}, {"two", 2}};
+    unordered_map<std::string, int, counted_hash> b {{"two", 20}, {"three", 3}};
+    auto nh = a.extract("one");
+    hash_calls = 0;
+    EXPECT_TRUE(b.insert(tinySTL::move(nh)).inserted);
+    EXPECT_EQ(hash_calls, 1);
+    a.merge(b);
+    EXPECT_EQ(a.size(), 3);
+    EXPECT_EQ(b.size(), 1);
+    EXPECT_EQ(a.at("one"), 1);
+    EXPECT_EQ(a.at("two"), 2);
+    EXPECT_EQ(a.at("three"), 3);
+    EXPECT_EQ(b.at("two"), 20);
+  }
+
+  /**
+   * @test  unordered_multimap<std::string, int, same_hash>
+   * @brief equal hashes are not taken for equal keys.
+   */
+  SUBTEST(cached_hash) {
+    unordered_multimap<std::string, int, same_hash> m;
+    for (int i = 0; i < 100; ++i) m.emplace(std::to_string(i % 10), i);
+    auto it = m.find("3");
+    m.insert(it, {"3", 1000});
+    EXPECT_EQ(m.count("3"), 11);
+    EXPECT_EQ(m.count("10"), 0);
+    auto r = m.equal_range("4");
+    EXPECT_EQ(tinySTL::distance(r.first, r.second), 10);
+    for (auto i = r.first; i != r.second; ++i) EXPECT_EQ(i->first, "4");
+    EXPECT_EQ(m.erase("3"), 11);
+    EXPECT_EQ(m.size(), 90);
+    m.rehash(1000);
+    EXPECT_EQ(m.count("5"), 10);
+  }
+}
@@ -49,7 +49,7 @@ TEST(unordered_set, constructor) {
    */
   SUBTEST(constructor) {
     unordered_set<std::string> s = { "Hello", "Standard", "Template", "Library" };
-    EXPECT_STRING_EQ(s, [Hello, Library, Template, Standard]);
+    EXPECT_STRING_EQ(s, [Template, Hello, Standard, Library]);
   }
 
   /**
@@ -470,3 +470,32 @@ TEST(unordered_set, compare_operator) {
   EXPECT_EQ(s1, s3);
   EXPECT_NE(s1, s2);
 }
+
+TEST(unordered_set, node_handle) {
+  /**
+   * @test  extract / insert(node_type&&)
+   */
+  SUBTEST(node_handle) {
+    unordered_set<int> a {1, 2, 3}, b {3};
+    auto nh = a.extract(a.find(1));
+    EXPECT_EQ(nh.value(), 1);
+    EXPECT_TRUE(b.insert(tinySTL::move(nh)).inserted);
+    auto r = b.insert(a.extract(3));
+    EXPECT_FALSE(r.inserted);
+    EXPECT_EQ(r.node.value(), 3);
+    EXPECT_EQ(a.size(), 1);
+    EXPECT_EQ(b.size(), 2);
+  }
+
+  /**
+   * @test  unordered_multiset extract / insert(hint, node_type&&)
+   */
+  SUBTEST(node_handle) {
+    unordered_multiset<int> m {4, 4, 5};
+    auto nh = m.extract(5);
+    nh.value() = 4;
+    m.insert(m.begin(), tinySTL::move(nh));
+    EXPECT_EQ(m.count(4), 3);
+    EXPECT_EQ(m.count(5), 0);
+  }
+}
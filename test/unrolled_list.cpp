@@ -0,0 +1,217 @@
+#include <string>
+#include <vector>
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+#include "unrolled_list.h"
+#include "algorithm.h"
+#include "test_util.h"
+
+using namespace tinySTL;
+
+TEST(unrolled_list, constructor) {
+  /**
+   * @test  unrolled_list()
+   * @brief default constructor.
+   */
+  SUBTEST(constructor) {
+    unrolled_list<int> ul;
+    EXPECT_STRING_EQ(ul, []);
+    EXPECT_TRUE(ul.empty());
+  }
+
+  /**
+   * @test  unrolled_list(size_type n, const T& val)
+   */
+  SUBTEST(constructor) {
+    unrolled_list<std::string> ul(3, "Hello");
+    EXPECT_STRING_EQ(ul, [Hello, Hello, Hello]);
+    EXPECT_EQ(ul.size(), 3);
+  }
+
+  /**
+   * @test  unrolled_list(std::initializer_list<T>) / copy / move
+   */
+  SUBTEST(constructor) {
+    unrolled_list<int> ul1{1, 2, 3, 4, 5};
+    unrolled_list<int> ul2(ul1);
+    EXPECT_STRING_EQ(ul2, [1, 2, 3, 4, 5]);
+    unrolled_list<int> ul3(tinySTL::move(ul1));
+    EXPECT_STRING_EQ(ul1, []);
+    EXPECT_STRING_EQ(ul3, [1, 2, 3, 4, 5]);
+    ul1 = ul3;
+    EXPECT_TRUE(ul1 == ul3);
+    ul1 = {7, 8};
+    EXPECT_STRING_EQ(ul1, [7, 8]);
+    EXPECT_TRUE(ul3 < ul1);
+  }
+
+  /**
+   * @test  unrolled_list(first, last)
+   * @brief more elements than one node holds.
+   */
+  SUBTEST(constructor) {
+    std::vector<int> v;
+    for (int i = 0; i < 1000; ++i) v.push_back(i);
+    unrolled_list<int> ul(v.begin(), v.end());
+    EXPECT_EQ(ul.size(), 1000);
+    EXPECT_TRUE(tinySTL::equal(ul.begin(), ul.end(), v.begin()));
+    EXPECT_EQ(ul.front(), 0);
+    EXPECT_EQ(ul.back(), 999);
+  }
+}
+
+TEST(unrolled_list, modifiers) {
+  /**
+   * @test  insert / erase in the middle
+   * @brief splits and merges keep the order, checked against a vector.
+   */
+  SUBTEST(modifiers) {
+    unrolled_list<int> ul;
+    std::vector<int> model;
+    unsigned seed = 12345;
+    for (int i = 0; i < 5000; ++i) {
+      size_t pos = model.empty() ? 0 : next_rand(seed) % (model.size() + 1);
+      auto it = ul.begin();
+      tinySTL::advance(it, pos);
+      auto ret = ul.insert(it, i);
+      EXPECT_EQ(*ret, i);
+      model.insert(model.begin() + pos, i);
+    }
+    ASSERT_EQ(ul.size(), model.size());
+    EXPECT_TRUE(tinySTL::equal(ul.begin(), ul.end(), model.begin()));
+
+    while (model.size() > 10) {
+      size_t pos = next_rand(seed) % model.size();
+      auto it = ul.begin();
+      tinySTL::advance(it, pos);
+      auto ret = ul.erase(it);
+      model.erase(model.begin() + pos);
+      if (pos < model.size())
+        EXPECT_EQ(*ret, model[pos]);
+      else
+        EXPECT_TRUE(ret == ul.end());
+    }
+    ASSERT_EQ(ul.size(), model.size());
+    EXPECT_TRUE(tinySTL::equal(ul.begin(), ul.end(), model.begin()));
+  }
+
+  /**
+   * @test  push_front / push_back / pop_front / pop_back
+   */
+  SUBTEST(modifiers) {
+    unrolled_list<int> ul;
+    for (int i = 0; i < 300; ++i) {
+      ul.push_back(i);
+      ul.push_front(-i);
+    }
+    EXPECT_EQ(ul.size(), 600);
+    EXPECT_EQ(ul.front(), -299);
+    EXPECT_EQ(ul.back(), 299);
+    for (int i = 0; i < 299; ++i) {
+      ul.pop_back();
+      ul.pop_front();
+    }
+    EXPECT_STRING_EQ(ul, [0, 0]);
+    ul.pop_back();
+    ul.pop_back();
+    EXPECT_TRUE(ul.empty());
+    EXPECT_TRUE(ul.begin() == ul.end());
+  }
+
+  /**
+   * @test  insert(pos, n, val) / insert(pos, first, last) / erase(first, last)
+   * @brief the returned iterator points to the first inserted element.
+   */
+  SUBTEST(modifiers) {
+    unrolled_list<int> ul{1, 2, 3};
+    auto it = ul.insert(++ul.begin(), 500, 7);
+    EXPECT_EQ(ul.size(), 503);
+    EXPECT_EQ(*--it, 1);
+    EXPECT_EQ(tinySTL::count(ul.begin(), ul.end(), 7), 500);
+    std::vector<int> v(400, 9);
+    it = ul.insert(--ul.end(), v.begin(), v.end());
+    EXPECT_EQ(*--it, 2);
+    EXPECT_EQ(ul.size(), 903);
+    auto first = ul.begin();
+    auto last = ul.end();
+    ++first;
+    --last;
+    it = ul.erase(first, last);
+    EXPECT_EQ(*it, 3);
+    EXPECT_STRING_EQ(ul, [1, 3]);
+  }
+
+  /**
+   * @test  emplace with an argument aliasing an element of the list
+   */
+  SUBTEST(modifiers) {
+    unrolled_list<std::string> ul;
+    for (size_t i = 0; i < ul.node_capacity(); ++i)
+      ul.push_back(std::to_string(i));
+    ul.insert(ul.begin(), ul.back());
+    EXPECT_EQ(ul.front(), std::to_string(ul.node_capacity() - 1));
+    EXPECT_EQ(ul.size(), ul.node_capacity() + 1);
+  }
+
+  /**
+   * @test  resize / assign / swap
+   */
+  SUBTEST(modifiers) {
+    unrolled_list<int> ul1{1, 2, 3};
+    ul1.resize(5);
+    EXPECT_STRING_EQ(ul1, [1, 2, 3, 0, 0]);
+    ul1.resize(2);
+    EXPECT_STRING_EQ(ul1, [1, 2]);
+    ul1.assign(3, 4);
+    EXPECT_STRING_EQ(ul1, [4, 4, 4]);
+    unrolled_list<int> ul2{9};
+    ul1.swap(ul2);
+    EXPECT_STRING_EQ(ul1, [9]);
+    EXPECT_STRING_EQ(ul2, [4, 4, 4]);
+    ul2.clear();
+    EXPECT_STRING_EQ(ul2, []);
+  }
+}
+
+TEST(unrolled_list, iterator) {
+  /**
+   * @test  reverse iteration across nodes
+   */
+  SUBTEST(iterator) {
+    unrolled_list<int> ul;
+    for (int i = 0; i < 1000; ++i) ul.push_back(i);
+    int expect = 999;
+    for (auto it = ul.rbegin(); it != ul.rend(); ++it)
+      EXPECT_EQ(*it, expect--);
+    EXPECT_EQ(expect, -1);
+  }
+
+  /**
+   * @test  segmented algorithms
+   * @brief fill, copy, find, count and for_each work node by node.
+   */
+  SUBTEST(iterator) {
+    unrolled_list<int> ul(1000, 0);
+    tinySTL::fill(++ul.begin(), --ul.end(), 5);
+    EXPECT_EQ(ul.front(), 0);
+    EXPECT_EQ(ul.back(), 0);
+    EXPECT_EQ(tinySTL::count(ul.begin(), ul.end(), 5), 998);
+
+    std::vector<int> v(1000);
+    for (int i = 0; i < 1000; ++i) v[i] = i;
+    auto out = tinySTL::copy(v.begin(), v.end(), ul.begin());
+    EXPECT_TRUE(out == ul.end());
+    EXPECT_EQ(*tinySTL::find(ul.cbegin(), ul.cend(), 777), 777);
+    EXPECT_TRUE(tinySTL::find(ul.begin(), ul.end(), 1000) == ul.end());
+
+    long sum = 0;
+    tinySTL::for_each(ul.begin(), ul.end(), [&sum](int x) { sum += x; });
+    EXPECT_EQ(sum, 999 * 1000 / 2);
+
+    std::vector<int> w(1000);
+    tinySTL::copy(ul.begin(), ul.end(), w.begin());
+    EXPECT_TRUE(w == v);
+  }
+}